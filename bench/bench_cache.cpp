@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include "utils/LRUCache.h"
+#include "utils/ShardedLRUCache.h"
+#include <string>
+#include <vector>
+
+using namespace hms_firetv;
+
+// Device-sized working set: the caches hold one entry per TV
+namespace {
+
+constexpr size_t KEYS = 64;
+
+const std::vector<std::string>& keys() {
+    static const std::vector<std::string> keys = [] {
+        std::vector<std::string> out;
+        for (size_t i = 0; i < KEYS; i++) {
+            out.push_back("device_" + std::to_string(i));
+        }
+        return out;
+    }();
+    return keys;
+}
+
+LRUCache<std::string, std::string> lru_cache(KEYS, 3600);
+ShardedLRUCache<std::string, std::string> sharded_cache(KEYS, 3600);
+
+} // namespace
+
+// Mostly reads with a put every 16th operation, threads sharing one cache
+template <typename Cache>
+static void runMixed(benchmark::State& state, Cache& cache) {
+    const auto& k = keys();
+    if (state.thread_index() == 0) {
+        for (const auto& key : k) {
+            cache.put(key, key);
+        }
+    }
+    size_t i = static_cast<size_t>(state.thread_index()) * 7;
+    for (auto _ : state) {
+        const auto& key = k[i % KEYS];
+        if (i % 16 == 0) {
+            cache.put(key, key);
+        } else {
+            benchmark::DoNotOptimize(cache.get(key));
+        }
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_LRUCacheMixed(benchmark::State& state) {
+    runMixed(state, lru_cache);
+}
+BENCHMARK(BM_LRUCacheMixed)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ShardedLRUCacheMixed(benchmark::State& state) {
+    runMixed(state, sharded_cache);
+}
+BENCHMARK(BM_ShardedLRUCacheMixed)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+#include "database/SQLiteDatabase.h"
+#include <sqlite3.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+using namespace hms_firetv;
+
+// ============================================================================
+// FIXTURE
+// ============================================================================
+
+// A WAL database on disk (as in production) with a fleet of devices
+class SQLiteFixture : public benchmark::Fixture {
+public:
+    static constexpr int DEVICES = 50;
+
+    void SetUp(const benchmark::State&) override {
+        path_ = "/tmp/hms_firetv_bench_" + std::to_string(::getpid()) + ".db";
+        removeFiles();
+        db_ = std::make_unique<SQLiteDatabase>(path_);
+        db_->connect();
+        for (int i = 0; i < DEVICES; i++) {
+            Device device;
+            device.device_id = "device_" + std::to_string(i);
+            device.name = "TV " + std::to_string(i);
+            device.ip_address = "192.168.1." + std::to_string(10 + i);
+            device.api_key = "0987654321";
+            device.status = "online";
+            device.tags = {"lobby"};
+            db_->createDevice(device);
+        }
+    }
+
+    void TearDown(const benchmark::State&) override {
+        db_.reset();
+        removeFiles();
+    }
+
+protected:
+    void removeFiles() {
+        std::remove(path_.c_str());
+        std::remove((path_ + "-wal").c_str());
+        std::remove((path_ + "-shm").c_str());
+    }
+
+    std::string path_;
+    std::unique_ptr<SQLiteDatabase> db_;
+};
+
+// ============================================================================
+// DEVICE LOOKUPS
+// ============================================================================
+
+BENCHMARK_F(SQLiteFixture, GetDeviceById)(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        auto device = db_->getDeviceById("device_" + std::to_string(i++ % DEVICES));
+        benchmark::DoNotOptimize(device);
+    }
+}
+
+BENCHMARK_F(SQLiteFixture, GetAllDevices)(benchmark::State& state) {
+    for (auto _ : state) {
+        auto devices = db_->getAllDevices();
+        benchmark::DoNotOptimize(devices);
+    }
+    state.SetItemsProcessed(state.iterations() * DEVICES);
+}
+
+BENCHMARK_F(SQLiteFixture, UpdateLastSeen)(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        db_->updateLastSeen("device_" + std::to_string(i++ % DEVICES), "online");
+    }
+}
+
+// ============================================================================
+// COMMAND HISTORY
+// ============================================================================
+
+// IDatabase has no history writer (only the PostgreSQL service records
+// commands), so this measures the equivalent INSERT on the same schema
+// through a second connection to the fixture's file
+BENCHMARK_F(SQLiteFixture, InsertCommandHistory)(benchmark::State& state) {
+    sqlite3* conn = nullptr;
+    sqlite3_open(path_.c_str(), &conn);
+    sqlite3_exec(conn, "PRAGMA synchronous=NORMAL", nullptr, nullptr, nullptr);
+
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(conn,
+        "INSERT INTO command_history (device_id, command_type, command_data, success, "
+        "response_time_ms, error_message) VALUES (?, ?, ?, ?, ?, ?)",
+        -1, &stmt, nullptr);
+
+    int i = 0;
+    for (auto _ : state) {
+        std::string device_id = "device_" + std::to_string(i % DEVICES);
+        sqlite3_bind_text(stmt, 1, device_id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, "navigate", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, R"({"action":"dpad_up"})", -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 4, 1);
+        sqlite3_bind_int(stmt, 5, 40 + i % 20);
+        sqlite3_bind_null(stmt, 6);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            state.SkipWithError(sqlite3_errmsg(conn));
+            break;
+        }
+        sqlite3_reset(stmt);
+        i++;
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(conn);
+}
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include "models/Device.h"
+#include <json/json.h>
+#include <memory>
+#include <string>
+
+using namespace hms_firetv;
+
+// ============================================================================
+// RESPONSE SERIALIZATION
+// ============================================================================
+
+namespace {
+
+// GET /api/devices body for a fleet of `count` devices
+Json::Value deviceList(int64_t count) {
+    Json::Value response;
+    response["success"] = true;
+    response["count"] = static_cast<Json::Int64>(count);
+    response["devices"] = Json::arrayValue;
+    for (int64_t i = 0; i < count; i++) {
+        Device device;
+        device.id = static_cast<int>(i + 1);
+        device.device_id = "device_" + std::to_string(i);
+        device.name = "TV " + std::to_string(i);
+        device.ip_address = "192.168.1." + std::to_string(10 + i % 200);
+        device.status = "online";
+        device.tags = {"lobby", "floor2"};
+        response["devices"].append(device.toJson());
+    }
+    return response;
+}
+
+} // namespace
+
+static void BM_DeviceToJson(benchmark::State& state) {
+    Device device;
+    device.device_id = "living_room";
+    device.name = "Living Room TV";
+    device.ip_address = "192.168.1.50";
+    device.status = "online";
+    device.tags = {"lobby"};
+    for (auto _ : state) {
+        auto json = device.toJson();
+        benchmark::DoNotOptimize(json);
+    }
+}
+BENCHMARK(BM_DeviceToJson);
+
+// Drogon's JSON responses are written without indentation
+static void BM_SerializeDeviceListCompact(benchmark::State& state) {
+    Json::Value response = deviceList(state.range(0));
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string body = Json::writeString(writer, response);
+        bytes += body.size();
+        benchmark::DoNotOptimize(body);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_SerializeDeviceListCompact)->Arg(1)->Arg(10)->Arg(100);
+
+// StreamWriterBuilder defaults (as used for MQTT state and discovery payloads)
+static void BM_SerializeDeviceListDefault(benchmark::State& state) {
+    Json::Value response = deviceList(state.range(0));
+    Json::StreamWriterBuilder writer;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string body = Json::writeString(writer, response);
+        bytes += body.size();
+        benchmark::DoNotOptimize(body);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_SerializeDeviceListDefault)->Arg(1)->Arg(10)->Arg(100);
+
+static void BM_ParseCommandBody(benchmark::State& state) {
+    const std::string body = R"({"command":"navigate","action":"dpad_up","trace_id":"4bf92f3577b34da6a3ce929d0e0e4736"})";
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    for (auto _ : state) {
+        Json::Value value;
+        std::string errors;
+        bool ok = reader->parse(body.data(), body.data() + body.size(), &value, &errors);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_ParseCommandBody);
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include "utils/BackgroundLogger.h"
+#include "utils/Logger.h"
+#include <atomic>
+
+using namespace hms_firetv;
+
+// ============================================================================
+// BACKGROUND LOGGER
+// ============================================================================
+
+namespace {
+
+std::atomic<uint64_t> sink{0};
+
+} // namespace
+
+// Enqueue cost seen by the caller; the queue is large enough that the
+// worker keeps up and nothing is dropped
+static void BM_BackgroundLoggerEnqueue(benchmark::State& state) {
+    static BackgroundLogger* logger = nullptr;
+    if (state.thread_index() == 0) {
+        logger = new BackgroundLogger(1 << 20);
+        logger->start();
+    }
+    for (auto _ : state) {
+        logger->enqueue([] { sink.fetch_add(1, std::memory_order_relaxed); });
+    }
+    if (state.thread_index() == 0) {
+        state.counters["dropped"] = static_cast<double>(logger->droppedCount());
+        logger->stop();
+        delete logger;
+        logger = nullptr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BackgroundLoggerEnqueue)->ThreadRange(1, 4)->UseRealTime();
+
+// ============================================================================
+// STRUCTURED LOGGER
+// ============================================================================
+
+// Formatting a line into the ring; the writer discards the output
+static void BM_LoggerLine(benchmark::State& state) {
+    static Logger* logger = nullptr;
+    if (state.thread_index() == 0) {
+        logger = new Logger(Logger::Options{}, [](bool, const std::string&) {});
+        logger->start();
+    }
+    for (auto _ : state) {
+        LogLine(*logger, LogLevel::Info, "Bench").field("device", "living_room")
+            << "Navigation command sent: " << 42;
+    }
+    if (state.thread_index() == 0) {
+        logger->stop();
+        state.counters["dropped"] = static_cast<double>(logger->droppedCount());
+        delete logger;
+        logger = nullptr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerLine)->ThreadRange(1, 4)->UseRealTime();
+
+// A level below LOG_LEVEL costs one relaxed load (debug is off by default)
+static void BM_LoggerDisabledLevel(benchmark::State& state) {
+    for (auto _ : state) {
+        LOG_DEBUG("Bench") << "never formatted " << state.iterations();
+    }
+}
+BENCHMARK(BM_LoggerDisabledLevel);
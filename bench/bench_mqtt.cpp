@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include "clients/LightningStep.h"
+#include "mqtt/CommandTopic.h"
+#include "mqtt/DiscoveryPublisher.h"
+
+using namespace hms_firetv;
+
+// ============================================================================
+// TOPIC PARSE AND ROUTE
+// ============================================================================
+
+static void BM_CommandTopicPress(benchmark::State& state) {
+    const std::string topic = "maestro_hub/colada/living_room/dpad_up";
+    const std::string payload = "PRESS";
+    std::string error;
+    for (auto _ : state) {
+        auto message = CommandTopic::parse(topic, payload, error);
+        benchmark::DoNotOptimize(message);
+    }
+}
+BENCHMARK(BM_CommandTopicPress);
+
+static void BM_CommandTopicJson(benchmark::State& state) {
+    const std::string topic = "maestro_hub/colada/living_room/cmd";
+    const std::string payload = R"({"command":"media","action":"play_pause"})";
+    std::string error;
+    for (auto _ : state) {
+        auto message = CommandTopic::parse(topic, payload, error);
+        benchmark::DoNotOptimize(message);
+    }
+}
+BENCHMARK(BM_CommandTopicJson);
+
+static void BM_CommandTopicSendText(benchmark::State& state) {
+    const std::string topic = "maestro_hub/colada/living_room/send_text";
+    const std::string payload = "the quick brown fox";
+    std::string error;
+    for (auto _ : state) {
+        auto message = CommandTopic::parse(topic, payload, error);
+        benchmark::DoNotOptimize(message);
+    }
+}
+BENCHMARK(BM_CommandTopicSendText);
+
+// ============================================================================
+// COMMAND DISPATCH
+// ============================================================================
+
+// Topic + payload to the Lightning request that would be sent (no network)
+static void BM_DispatchPressToStep(benchmark::State& state) {
+    const std::string topic = "maestro_hub/colada/living_room/dpad_up";
+    const std::string payload = "PRESS";
+    std::string error;
+    for (auto _ : state) {
+        auto message = CommandTopic::parse(topic, payload, error);
+        auto step = LightningStep::compile(message->payload, error);
+        if (!step) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(step);
+    }
+}
+BENCHMARK(BM_DispatchPressToStep);
+
+static void BM_CompileSequence(benchmark::State& state) {
+    Json::Value steps(Json::arrayValue);
+    const char* directions[] = {"up", "down", "left", "right", "select"};
+    for (int i = 0; i < state.range(0); i++) {
+        Json::Value step;
+        step["command"] = "navigate";
+        step["action"] = directions[i % 5];
+        steps.append(step);
+    }
+    std::string error;
+    for (auto _ : state) {
+        auto compiled = compileSequence(steps, error);
+        benchmark::DoNotOptimize(compiled);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CompileSequence)->Arg(1)->Arg(10)->Arg(50);
+
+// ============================================================================
+// DISCOVERY
+// ============================================================================
+
+static void BM_DiscoveryBuildMessages(benchmark::State& state) {
+    Device device;
+    device.device_id = "living_room";
+    device.name = "Living Room TV";
+    device.ip_address = "192.168.1.50";
+    for (auto _ : state) {
+        auto messages = DiscoveryPublisher::buildMessages(device);
+        benchmark::DoNotOptimize(messages);
+    }
+    state.SetItemsProcessed(state.iterations() * (DiscoveryPublisher::BUTTONS.size() + 1));
+}
+BENCHMARK(BM_DiscoveryBuildMessages);
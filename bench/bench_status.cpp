@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include "services/ServiceStatus.h"
+#include <string>
+#include <vector>
+
+using namespace hms_firetv;
+
+// ============================================================================
+// /status AND /health HANDLER WORK
+// ============================================================================
+
+namespace {
+
+// Set up like main: 50 devices and a details provider of /status's size
+ServiceStatus& warmStatus() {
+    static ServiceStatus status(std::chrono::milliseconds(60000));
+    static bool initialized = [] {
+        status.setInfo({"HMS FireTV", "1.0.6", "sqlite", "tcp://localhost:1883"});
+        status.setDatabaseConnected(true);
+        status.setMqttConnected(true);
+        status.setReady(true);
+
+        std::vector<Device> devices(50);
+        for (size_t i = 0; i < devices.size(); i++) {
+            devices[i].device_id = "device_" + std::to_string(i);
+            devices[i].status = i % 3 ? "online" : "offline";
+            devices[i].client_token = "token";
+        }
+        status.resetDevices(devices);
+
+        status.setDetailsProvider([](Json::Value& r) {
+            for (const char* section : {"deadlines", "text_input", "key_repeat", "remote", "tracing",
+                                        "slo", "stream", "static"}) {
+                for (int i = 0; i < 6; i++) {
+                    r[section]["counter_" + std::to_string(i)] = static_cast<Json::UInt64>(i * 1000);
+                }
+            }
+        });
+        return true;
+    }();
+    (void)initialized;
+    return status;
+}
+
+} // namespace
+
+// What the /status handler does per request when nothing changed
+static void BM_StatusBodyCached(benchmark::State& state) {
+    auto& status = warmStatus();
+    status.statusBody();
+    for (auto _ : state) {
+        auto body = status.statusBody();
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(BM_StatusBodyCached)->ThreadRange(1, 8);
+
+// What the /health, /health/live and /health/ready handlers do per request
+static void BM_ProbeCached(benchmark::State& state) {
+    auto& status = warmStatus();
+    auto probe = static_cast<ServiceStatus::Probe>(state.range(0));
+    status.probeBody(probe);
+    for (auto _ : state) {
+        bool ok = status.passes(probe);
+        auto body = status.probeBody(probe);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(BM_ProbeCached)
+    ->Arg(static_cast<int>(ServiceStatus::Probe::Live))
+    ->Arg(static_cast<int>(ServiceStatus::Probe::Ready))
+    ->Arg(static_cast<int>(ServiceStatus::Probe::Health))
+    ->ThreadRange(1, 8);
+
+// Worst case: something changed before every request, so the body is rendered again
+static void BM_StatusBodyAfterChange(benchmark::State& state) {
+    auto& status = warmStatus();
+    bool online = false;
+    for (auto _ : state) {
+        status.deviceChanged("device_0", std::nullopt, online = !online);
+        auto body = status.statusBody();
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(BM_StatusBodyAfterChange);
+
+// updateLastSeen's extra work on every command (status unchanged)
+static void BM_DeviceSeenUnchanged(benchmark::State& state) {
+    auto& status = warmStatus();
+    status.deviceChanged("device_1", std::nullopt, true);
+    for (auto _ : state) {
+        status.deviceChanged("device_1", std::nullopt, true);
+    }
+}
+BENCHMARK(BM_DeviceSeenUnchanged);
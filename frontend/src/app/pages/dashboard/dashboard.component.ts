@@ -1,6 +1,8 @@
 import { Component, inject, signal, OnInit, OnDestroy } from '@angular/core';
 import { RouterLink } from '@angular/router';
+import { Subscription } from 'rxjs';
 import { ApiService } from '../../services/api.service';
+import { StreamEvent, StreamService, applyDeviceEvent } from '../../services/stream.service';
 
 @Component({
   selector: 'app-dashboard',
@@ -54,7 +56,7 @@ import { ApiService } from '../../services/api.service';
             <tbody>
               @for (d of devices(); track d.device_id) {
                 <tr>
-                  <td><span class="dot" [class.dot-online]="d.status === 'online'" [class.dot-offline]="d.status === 'offline'" [class.dot-pairing]="d.status === 'pairing'"></span></td>
+                  <td><span class="dot" [class.dot-online]="d.status === 'online' && d.reachable !== false" [class.dot-offline]="d.status === 'offline' || d.reachable === false" [class.dot-pairing]="d.status === 'pairing'"></span></td>
                   <td>
                     <div class="device-name">{{ d.name }}</div>
                     <div class="device-id">{{ d.device_id }}</div>
@@ -123,7 +125,9 @@ import { ApiService } from '../../services/api.service';
 })
 export class DashboardComponent implements OnInit, OnDestroy {
   private api = inject(ApiService);
+  private stream = inject(StreamService);
   private timer: ReturnType<typeof setInterval> | null = null;
+  private events: Subscription | null = null;
 
   loading = signal(true);
   dbConnected = signal(false);
@@ -135,11 +139,34 @@ export class DashboardComponent implements OnInit, OnDestroy {
 
   ngOnInit() {
     this.load();
-    this.timer = setInterval(() => this.load(), 15000);
+    this.stream.start();
+    this.events = this.stream.events.subscribe((event) => this.onEvent(event));
+    // Polling only while the push channel is down
+    this.timer = setInterval(() => {
+      if (!this.stream.connected()) this.load();
+    }, 15000);
   }
 
   ngOnDestroy() {
     if (this.timer) clearInterval(this.timer);
+    this.events?.unsubscribe();
+  }
+
+  onEvent(event: StreamEvent) {
+    if (event.t === 'hello') {
+      if (event['resync']) this.load();
+    } else if (event.t === 'device') {
+      const devices = applyDeviceEvent(this.devices(), event);
+      if (!devices) {
+        this.load();
+        return;
+      }
+      this.devices.set(devices);
+      this.pairedDevices.set(devices.filter((d) => d.is_paired).length);
+      this.onlineDevices.set(devices.filter((d) => d.status === 'online').length);
+    } else if (event.t === 'service' && event['mqtt']) {
+      this.mqttConnected.set(event['mqtt'] === 'connected');
+    }
   }
 
   load() {
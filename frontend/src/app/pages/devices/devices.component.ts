@@ -1,6 +1,8 @@
 import { Component, inject, signal, OnInit, OnDestroy } from '@angular/core';
 import { FormsModule } from '@angular/forms';
+import { Subscription } from 'rxjs';
 import { ApiService } from '../../services/api.service';
+import { StreamEvent, StreamService, applyDeviceEvent } from '../../services/stream.service';
 
 @Component({
   selector: 'app-devices',
@@ -11,7 +13,9 @@ import { ApiService } from '../../services/api.service';
 })
 export class DevicesComponent implements OnInit, OnDestroy {
   private api = inject(ApiService);
+  private stream = inject(StreamService);
   private timer: ReturnType<typeof setInterval> | null = null;
+  private events: Subscription | null = null;
 
   devices = signal<any[]>([]);
   showForm = signal(false);
@@ -31,11 +35,27 @@ export class DevicesComponent implements OnInit, OnDestroy {
 
   ngOnInit() {
     this.loadDevices();
-    this.timer = setInterval(() => this.loadDevices(), 10000);
+    this.stream.start();
+    this.events = this.stream.events.subscribe((event) => this.onEvent(event));
+    // Polling only while the push channel is down
+    this.timer = setInterval(() => {
+      if (!this.stream.connected()) this.loadDevices();
+    }, 10000);
   }
 
   ngOnDestroy() {
     if (this.timer) clearInterval(this.timer);
+    this.events?.unsubscribe();
+  }
+
+  onEvent(event: StreamEvent) {
+    if (event.t === 'hello') {
+      if (event['resync']) this.loadDevices();
+    } else if (event.t === 'device') {
+      const devices = applyDeviceEvent(this.devices(), event);
+      if (devices) this.devices.set(devices);
+      else this.loadDevices();
+    }
   }
 
   loadDevices() {
@@ -129,14 +149,34 @@ export class DevicesComponent implements OnInit, OnDestroy {
     this.saving.set(true);
     this.error.set('');
     this.api.verifyPairing(d.device_id, this.pairPin).subscribe({
-      next: () => {
+      next: (r) => this.awaitPairing(d.device_id, r.session?.version ?? 0),
+      error: (e) => {
         this.saving.set(false);
-        this.pairStep.set('done');
-        this.loadDevices();
+        this.error.set(e.error?.error || e.error?.detail || 'PIN verification failed.');
       },
-      error: (e) => {
+    });
+  }
+
+  // The server polls the TV for the token; long-poll until the session settles
+  private awaitPairing(deviceId: string, since: number) {
+    if (this.pairDevice()?.device_id !== deviceId) return;
+    this.api.getPairingStatus(deviceId, since, 25000).subscribe({
+      next: (r) => {
+        const state = r.session?.state;
+        if (r.is_paired || state === 'paired') {
+          this.saving.set(false);
+          this.pairStep.set('done');
+          this.loadDevices();
+        } else if (!r.session || ['failed', 'expired', 'cancelled'].includes(state)) {
+          this.saving.set(false);
+          this.error.set(r.session?.error || 'PIN verification failed.');
+        } else {
+          this.awaitPairing(deviceId, r.session.version);
+        }
+      },
+      error: () => {
         this.saving.set(false);
-        this.error.set(e.error?.detail || 'PIN verification failed.');
+        this.error.set('Lost contact while verifying PIN.');
       },
     });
   }
@@ -1,6 +1,7 @@
-import { Component, inject, signal, OnInit } from '@angular/core';
+import { Component, inject, signal, OnInit, OnDestroy } from '@angular/core';
 import { FormsModule } from '@angular/forms';
 import { ApiService } from '../../services/api.service';
+import { RemoteService, RemoteAck } from '../../services/remote.service';
 
 const APP_COLORS: Record<string, string> = {
   'com.netflix.ninja': '#e50914',
@@ -145,8 +146,9 @@ const APP_COLORS: Record<string, string> = {
     .feedback.error { color: var(--error); }
   `],
 })
-export class RemoteComponent implements OnInit {
+export class RemoteComponent implements OnInit, OnDestroy {
   private api = inject(ApiService);
+  private remote = inject(RemoteService);
   devices = signal<any[]>([]);
   favoriteApps = signal<any[]>([]);
   selectedDevice = '';
@@ -160,8 +162,13 @@ export class RemoteComponent implements OnInit {
     });
   }
 
+  ngOnDestroy() {
+    this.remote.close();
+  }
+
   onDeviceChange() {
     this.favoriteApps.set([]);
+    this.remote.open(this.selectedDevice);
     if (!this.selectedDevice) return;
     this.api.getApps(this.selectedDevice).subscribe({
       next: (res) => {
@@ -184,6 +191,7 @@ export class RemoteComponent implements OnInit {
 
   nav(action: string) {
     if (!this.selectedDevice) return;
+    if (this.pressOverSocket(action)) return;
     this.api.sendNavigation(this.selectedDevice, action).subscribe({
       next: () => this.showFeedback('Command sent'),
       error: (e) => this.showFeedback(e.error?.detail || 'Command failed', true),
@@ -192,6 +200,7 @@ export class RemoteComponent implements OnInit {
 
   media(action: string) {
     if (!this.selectedDevice) return;
+    if (this.pressOverSocket(action)) return;
     this.api.sendMedia(this.selectedDevice, action).subscribe({
       next: () => this.showFeedback('Command sent'),
       error: (e) => this.showFeedback(e.error?.detail || 'Command failed', true),
@@ -206,6 +215,17 @@ export class RemoteComponent implements OnInit {
     });
   }
 
+  // Keys go over the control socket when it is open; REST otherwise
+  private pressOverSocket(key: string): boolean {
+    const ack = this.remote.press(key);
+    if (!ack) return false;
+    ack.then((a: RemoteAck) => {
+      if (a.ok) this.showFeedback(`Command sent (${a.ms} ms)`);
+      else this.showFeedback(a.error || 'Command failed', true);
+    });
+    return true;
+  }
+
   private showFeedback(msg: string, isError = false) {
     this.feedback.set(msg);
     this.feedbackError.set(isError);
@@ -17,6 +17,9 @@ export class ApiService {
   startPairing(id: string) { return this.http.post<any>(`/api/devices/${id}/pair/start`, {}); }
   verifyPairing(id: string, pin: string) { return this.http.post<any>(`/api/devices/${id}/pair/verify`, { pin }); }
   resetPairing(id: string) { return this.http.post<any>(`/api/devices/${id}/pair/reset`, {}); }
+  getPairingStatus(id: string, since = 0, waitMs = 0) {
+    return this.http.get<any>(`/api/devices/${id}/pair/status`, { params: { since, wait_ms: waitMs } });
+  }
   getDeviceStatus(id: string) { return this.http.get<any>(`/api/devices/${id}/status`); }
 
   sendNavigation(id: string, action: string) { return this.http.post<any>(`/api/devices/${id}/navigate`, { action }); }
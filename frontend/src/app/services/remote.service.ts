@@ -0,0 +1,84 @@
+import { Injectable } from '@angular/core';
+
+export interface RemoteAck {
+  n: number;
+  ok: boolean;
+  ms?: number;
+  timing?: Record<string, number>;
+  error?: string;
+}
+
+/**
+ * Control channel at /api/remote: one socket per remote session instead of
+ * a POST per button press. Presses are "<n> <key>" and answered with an
+ * ack carrying n; the server sends them to the TV in order.
+ *
+ * press() returns null while the socket is not open so callers can fall
+ * back to the REST endpoints.
+ */
+@Injectable({ providedIn: 'root' })
+export class RemoteService {
+  private socket: WebSocket | null = null;
+  private deviceId = '';
+  private keys = new Set<string>();
+  private next = 1;
+  private pending = new Map<number, (ack: RemoteAck) => void>();
+  private retry: ReturnType<typeof setTimeout> | null = null;
+
+  open(deviceId: string) {
+    this.close();
+    if (!deviceId || typeof WebSocket === 'undefined') return;
+    this.deviceId = deviceId;
+
+    const proto = location.protocol === 'https:' ? 'wss:' : 'ws:';
+    const socket = new WebSocket(`${proto}//${location.host}/api/remote?device=${encodeURIComponent(deviceId)}`);
+    socket.onmessage = (msg) => this.dispatch(msg.data);
+    socket.onclose = () => {
+      if (this.socket !== socket) return;
+      this.socket = null;
+      this.failPending('Connection closed');
+      this.retry = setTimeout(() => this.open(this.deviceId), 3000);
+    };
+    this.socket = socket;
+  }
+
+  close() {
+    if (this.retry) clearTimeout(this.retry);
+    this.retry = null;
+    const socket = this.socket;
+    this.socket = null;
+    socket?.close();
+    this.failPending('Connection closed');
+    this.keys.clear();
+  }
+
+  press(key: string): Promise<RemoteAck> | null {
+    if (this.socket?.readyState !== WebSocket.OPEN || !this.keys.has(key)) return null;
+    const n = this.next;
+    this.next = (this.next % 65535) + 1;
+    this.socket.send(`${n} ${key}`);
+    return new Promise((resolve) => this.pending.set(n, resolve));
+  }
+
+  private dispatch(data: string) {
+    let msg: any;
+    try {
+      msg = JSON.parse(data);
+    } catch {
+      return;
+    }
+
+    if (msg.t === 'hello') {
+      this.keys = new Set(msg.keys || []);
+    } else if (msg.t === 'ack') {
+      const resolve = this.pending.get(msg.n);
+      this.pending.delete(msg.n);
+      resolve?.(msg);
+    }
+  }
+
+  private failPending(error: string) {
+    for (const [n, resolve] of this.pending) resolve({ n, ok: false, error });
+    this.pending.clear();
+  }
+}
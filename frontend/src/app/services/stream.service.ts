@@ -0,0 +1,92 @@
+import { Injectable, signal } from '@angular/core';
+import { Subject } from 'rxjs';
+
+export interface StreamEvent {
+  seq: number;
+  t: 'hello' | 'device' | 'command' | 'discovery' | 'service' | string;
+  [field: string]: any;
+}
+
+/**
+ * Push channel at /api/stream: WebSocket, or Server-Sent Events when the
+ * WebSocket cannot be opened (e.g. a proxy that strips Upgrade).
+ *
+ * "hello" with resync: true means the events in between were lost, so
+ * subscribers reload over REST. Components keep polling only while
+ * `connected()` is false.
+ */
+@Injectable({ providedIn: 'root' })
+export class StreamService {
+  connected = signal(false);
+  events = new Subject<StreamEvent>();
+
+  private lastSeq: number | null = null;
+  private useSse = typeof WebSocket === 'undefined';
+  private retryMs = 1000;
+  private started = false;
+
+  start() {
+    if (this.started) return;
+    this.started = true;
+    this.connect();
+  }
+
+  private connect() {
+    const since = this.lastSeq !== null ? `?since=${this.lastSeq}` : '';
+
+    if (!this.useSse) {
+      const proto = location.protocol === 'https:' ? 'wss:' : 'ws:';
+      const socket = new WebSocket(`${proto}//${location.host}/api/stream${since}`);
+      let opened = false;
+      socket.onopen = () => (opened = true);
+      socket.onmessage = (msg) => this.dispatch(msg.data);
+      socket.onclose = () => {
+        this.connected.set(false);
+        if (!opened) this.useSse = true;
+        this.reconnect();
+      };
+      return;
+    }
+
+    // EventSource reconnects by itself, sending Last-Event-ID
+    const source = new EventSource(`/api/stream${since}`);
+    source.onmessage = (msg) => this.dispatch(msg.data);
+    source.onerror = () => {
+      this.connected.set(false);
+      if (source.readyState === EventSource.CLOSED) this.reconnect();
+    };
+  }
+
+  private reconnect() {
+    setTimeout(() => this.connect(), this.retryMs);
+    this.retryMs = Math.min(this.retryMs * 2, 30000);
+  }
+
+  private dispatch(data: string) {
+    let event: StreamEvent;
+    try {
+      event = JSON.parse(data);
+    } catch {
+      return;
+    }
+
+    if (event.t === 'hello') {
+      this.retryMs = 1000;
+      this.connected.set(true);
+    } else if (this.lastSeq !== null && event.seq <= this.lastSeq) {
+      return;
+    }
+    this.lastSeq = event.seq;
+    this.events.next(event);
+  }
+}
+
+/**
+ * Apply a "device" delta to a device list; null when the list has to be
+ * reloaded (device created or deleted, or not in the list yet)
+ */
+export function applyDeviceEvent(devices: any[], event: StreamEvent): any[] | null {
+  if (event['change'] || !devices.some((d) => d.device_id === event['id'])) return null;
+  const { seq, t, id, ...fields } = event;
+  return devices.map((d) => (d.device_id === id ? { ...d, ...fields } : d));
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include "services/BroadcastService.h"
+
+using namespace drogon;
+
+namespace hms_firetv {
+
+/**
+ * BroadcastController - REST API for fleet-wide commands
+ *
+ * Endpoints:
+ * - POST /api/broadcast - Send one command to all devices, a tag, or a list
+ *
+ * The same body is accepted on MQTT topic maestro_hub/firetv/broadcast/set.
+ */
+class BroadcastController : public drogon::HttpController<BroadcastController> {
+public:
+    METHOD_LIST_BEGIN
+
+    ADD_METHOD_TO(BroadcastController::broadcast, "/api/broadcast", Post);
+
+    METHOD_LIST_END
+
+    /**
+     * Broadcast a command
+     * POST /api/broadcast
+     * Body: {"command": {"command": "navigate", "action": "home"},
+     *        "tag": "lobby",          // or "devices": ["a", "b"]; neither = all
+     *        "wake": true,            // pre-wake sleeping TVs (default: true)
+     *        "concurrency": 8,        // optional, capped by BROADCAST_CONCURRENCY
+     *        "timeout_ms": 20000}     // optional; X-Request-Deadline-Ms header wins
+     *
+     * Responds once every device has completed, with per-device results
+     * and the total wall time.
+     */
+    void broadcast(const HttpRequestPtr& req,
+                   std::function<void(const HttpResponsePtr&)>&& callback);
+
+private:
+    /**
+     * Send error response
+     */
+    void sendError(std::function<void(const HttpResponsePtr&)>&& callback,
+                   HttpStatusCode status,
+                   const std::string& message);
+};
+
+} // namespace hms_firetv
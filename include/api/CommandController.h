@@ -3,8 +3,9 @@
 #include <drogon/HttpController.h>
 #include "clients/LightningClient.h"
 #include "repositories/DeviceRepository.h"
-#include "utils/LRUCache.h"
 #include "utils/BackgroundLogger.h"
+#include "utils/Deadline.h"
+#include "utils/Trace.h"
 
 using namespace drogon;
 
@@ -20,7 +21,20 @@ namespace hms_firetv {
  * - POST /api/devices/:id/volume       - Volume control
  * - POST /api/devices/:id/app          - Launch app
  * - POST /api/devices/:id/text         - Send text
+ * - POST /api/devices/:id/commands/batch - Run a step sequence or named macro
  * - GET  /api/devices/:id/history      - Command history
+ *
+ * All command endpoints are non-blocking: the Fire TV request is sent with
+ * Drogon's async HttpClient and the response is completed from its callback,
+ * so a sleeping TV never ties up an IO thread.
+ *
+ * Clients may send X-Request-Deadline-Ms (time budget in ms). The command is
+ * not sent once the budget has run out, the TV request timeout is capped to
+ * what is left, and an exceeded deadline is answered with 504.
+ *
+ * Single commands are traced (see Tracer): a W3C `traceparent` header is
+ * continued, and every response carries X-Trace-Id for lookup under
+ * /api/debug/traces.
  */
 class CommandController : public drogon::HttpController<CommandController> {
 public:
@@ -44,6 +58,9 @@ public:
     // Send text
     ADD_METHOD_TO(CommandController::sendText, "/api/devices/{1}/text", Post);
 
+    // Step sequence / named macro
+    ADD_METHOD_TO(CommandController::sendBatch, "/api/devices/{1}/commands/batch", Post);
+
     // Command history
     ADD_METHOD_TO(CommandController::getHistory, "/api/devices/{1}/history", Get);
 
@@ -62,6 +79,9 @@ public:
      * Navigation command
      * POST /api/devices/:id/navigate
      * Body: {"action": "up|down|left|right|select|home|back|menu"}
+     * Hold: add "hold": true to repeat the key server-side (202); resend it
+     * as a heartbeat within NAV_HOLD_WATCHDOG_MS and stop with
+     * {"release": true}
      */
     void navigate(const HttpRequestPtr& req,
                  std::function<void(const HttpResponsePtr&)>&& callback,
@@ -98,11 +118,28 @@ public:
      * Send text
      * POST /api/devices/:id/text
      * Body: {"text": "search query"}
+     * Optional: "stream": true - search-as-you-type; the whole field value is
+     * queued on TextInputService (debounced, one request in flight per
+     * device) and the response is 202 without waiting for the TV
      */
     void sendText(const HttpRequestPtr& req,
                  std::function<void(const HttpResponsePtr&)>&& callback,
                  std::string device_id);
 
+    /**
+     * Run a step sequence or named macro
+     * POST /api/devices/:id/commands/batch
+     * Body: {"steps": [{"command": "app", "package": "...", "delay_ms": 2000}, ...]}
+     *    or {"macro": "movie_night"}
+     * Optional: "stop_on_error" (default true)
+     *
+     * Steps run in order on one leased client; the response carries
+     * per-step status and timing.
+     */
+    void sendBatch(const HttpRequestPtr& req,
+                   std::function<void(const HttpResponsePtr&)>&& callback,
+                   std::string device_id);
+
     /**
      * Get command history
      * GET /api/devices/:id/history?limit=50&offset=0
@@ -112,11 +149,6 @@ public:
                    std::string device_id);
 
 public:
-    /**
-     * Invalidate cached client for a device (call when device is updated/deleted)
-     */
-    static void invalidateClient(const std::string& device_id);
-
     /**
      * Initialize background logger (call once at startup)
      */
@@ -127,16 +159,28 @@ public:
      */
     static void shutdownBackgroundLogger();
 
-private:
     /**
-     * Get or create Lightning client for device
+     * Command history logger (queue size and drop count for /metrics)
      */
-    std::shared_ptr<LightningClient> getClient(const std::string& device_id);
+    static const BackgroundLogger& backgroundLogger() { return background_logger_; }
+
+    /**
+     * Start the client pool expiry sweeper (call once at startup)
+     */
+    static void startClientCacheSweeper();
+
+    /**
+     * Stop the client pool expiry sweeper (call at shutdown)
+     */
+    static void stopClientCacheSweeper();
+
+private:
+    using FireTVCallCallback = std::function<void(bool, int, const std::string&, const CommandTiming&)>;
 
     /**
      * Make async Fire TV API call (non-blocking with timeout)
      *
-     * Uses Drogon's async HttpClient with:
+     * Goes through AsyncLightningClient (Drogon's async HttpClient) with:
      * - Configurable timeout (default: 5 seconds via FIRETV_API_TIMEOUT_SECONDS)
      * - SSL verification disabled (Fire TV uses self-signed certs)
      * - Automatic timeout handling (ReqResult::Timeout)
@@ -144,25 +188,65 @@ private:
      * Note: Individual request cancellation is not supported by Drogon's HttpClient.
      * Requests timeout automatically after the configured duration.
      *
-     * @param device_id Device identifier
-     * @param endpoint API endpoint (e.g., "/navigation")
+     * @param device Target device (IP, API key and token)
+     * @param endpoint API endpoint (e.g., "/v1/FireTV?action=home")
      * @param json_body JSON request body
-     * @param completion_callback Callback invoked with (success, response_time_ms, error_msg)
+     * @param deadline Command deadline; caps the timeout, and the call is
+     *                 not sent once it has passed (error Deadline::EXCEEDED)
+     * @param received When Drogon finished reading the request; the time
+     *                 until the call is sent is the breakdown's queue_us
+     * @param trace Command trace (may be null); gets the request span and is
+     *              finished after completion_callback returns
+     * @param completion_callback Callback invoked with (success, response_time_ms, error_msg, timing);
+     *                            timing has queue_us and transfer_us
      */
-    void makeAsyncFireTVCall(const std::string& device_id,
+    void makeAsyncFireTVCall(const Device& device,
                              const std::string& endpoint,
                              const Json::Value& json_body,
-                             std::function<void(bool, int, const std::string&)> completion_callback);
+                             const Deadline& deadline,
+                             const trantor::Date& received,
+                             const std::shared_ptr<Trace>& trace,
+                             FireTVCallCallback completion_callback);
+
+    /**
+     * Start the trace of a single command (continuing `traceparent` if sent)
+     *
+     * Records the time Drogon spent before the handler ran as "receive" and
+     * wraps `callback` so the response carries X-Trace-Id.
+     */
+    static std::shared_ptr<Trace> startTrace(const HttpRequestPtr& req,
+                                             const std::string& device_id,
+                                             const char* command,
+                                             std::function<void(const HttpResponsePtr&)>& callback);
+
+    /**
+     * Request body as JSON, timed as the trace's "parse" span
+     */
+    static std::shared_ptr<Json::Value> jsonBody(const HttpRequestPtr& req);
+
+    /**
+     * Command deadline from the X-Request-Deadline-Ms header (budget in ms),
+     * or COMMAND_DEADLINE_MS when absent
+     */
+    static Deadline requestDeadline(const HttpRequestPtr& req);
+
+    /**
+     * Response status for a finished command (504 if its deadline passed)
+     */
+    static HttpStatusCode commandStatus(bool success, const std::string& error_msg);
 
     /**
      * Log command to database
+     *
+     * @param timing Latency breakdown; unmeasured phases are stored as NULL
      */
     void logCommand(const std::string& device_id,
                    const std::string& command_type,
                    const Json::Value& command_data,
                    bool success,
                    int response_time_ms,
-                   const std::string& error_message = "");
+                   const std::string& error_message = "",
+                   const CommandTiming& timing = CommandTiming());
 
     /**
      * Send error response
@@ -174,9 +258,8 @@ private:
     // Fire TV API timeout configuration
     static constexpr double FIRETV_API_TIMEOUT_SECONDS = 5.0;  // 5 seconds
 
-    // Static LRU cache of Lightning clients per device (max 100 entries, 1 hour TTL)
-    // Static to persist across controller instances
-    static LRUCache<std::string, std::shared_ptr<LightningClient>> clients_cache_;
+    // How often the sweepers drop idle device pools and HTTP clients
+    static constexpr int CLIENT_CACHE_SWEEP_SECONDS = 60;
 
     // Static background logger for async command history logging (max 1000 entries)
     // Static to persist across controller instances
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+
+using namespace drogon;
+
+namespace hms_firetv {
+
+/**
+ * DebugController - Diagnostics for slow or failed commands
+ *
+ * Endpoints:
+ * - GET /api/debug/traces            - Recent sampled command traces
+ * - GET /api/debug/traces/:trace_id  - One trace (?format=otlp for OTLP/JSON)
+ * - GET /api/debug/allocations       - Heap allocations per request type
+ *                                      (ENABLE_ALLOC_TRACKING builds; ?reset=1 clears)
+ * - GET /api/debug/profile           - CPU profile as folded stacks (PROFILER_ENABLED;
+ *                                      ?seconds=10, ?hz=99, ?format=json)
+ *
+ * Query parameters for the listing:
+ * - limit   - Max traces (default 50)
+ * - device  - Only this device
+ * - min_ms  - Only traces at least this long
+ */
+class DebugController : public drogon::HttpController<DebugController> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(DebugController::listTraces, "/api/debug/traces",     Get);
+    ADD_METHOD_TO(DebugController::getTrace,   "/api/debug/traces/{1}", Get);
+    ADD_METHOD_TO(DebugController::getAllocations, "/api/debug/allocations", Get);
+    ADD_METHOD_TO(DebugController::profile,        "/api/debug/profile",     Get);
+    METHOD_LIST_END
+
+    void listTraces(const HttpRequestPtr& req,
+                    std::function<void(const HttpResponsePtr&)>&& callback);
+
+    void getTrace(const HttpRequestPtr& req,
+                  std::function<void(const HttpResponsePtr&)>&& callback,
+                  std::string trace_id);
+
+    void getAllocations(const HttpRequestPtr& req,
+                        std::function<void(const HttpResponsePtr&)>&& callback);
+
+    /**
+     * Blocks only the response: sampling runs on the profiler's thread,
+     * which answers when the profile is done
+     */
+    void profile(const HttpRequestPtr& req,
+                 std::function<void(const HttpResponsePtr&)>&& callback);
+
+private:
+    void sendError(std::function<void(const HttpResponsePtr&)>&& callback,
+                   HttpStatusCode status, const std::string& message);
+
+    static constexpr size_t DEFAULT_LIMIT = 50;
+    static constexpr long DEFAULT_PROFILE_SECONDS = 10;
+};
+
+} // namespace hms_firetv
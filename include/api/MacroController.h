@@ -0,0 +1,91 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include "repositories/MacroRepository.h"
+
+using namespace drogon;
+
+namespace hms_firetv {
+
+/**
+ * MacroController - REST API for named command sequences
+ *
+ * Endpoints:
+ * - GET    /api/macros          - List macros
+ * - POST   /api/macros          - Create or replace macro
+ * - GET    /api/macros/:name    - Get macro
+ * - PUT    /api/macros/:name    - Update macro
+ * - DELETE /api/macros/:name    - Delete macro
+ *
+ * Run a macro with POST /api/devices/:id/commands/batch {"macro": "name"}
+ * or the MQTT "macro" command.
+ */
+class MacroController : public drogon::HttpController<MacroController> {
+public:
+    METHOD_LIST_BEGIN
+
+    ADD_METHOD_TO(MacroController::listMacros, "/api/macros", Get);
+    ADD_METHOD_TO(MacroController::createMacro, "/api/macros", Post);
+    ADD_METHOD_TO(MacroController::getMacro, "/api/macros/{1}", Get);
+    ADD_METHOD_TO(MacroController::updateMacro, "/api/macros/{1}", Put);
+    ADD_METHOD_TO(MacroController::deleteMacro, "/api/macros/{1}", Delete);
+
+    METHOD_LIST_END
+
+    /**
+     * List macros
+     * GET /api/macros
+     */
+    void listMacros(const HttpRequestPtr& req,
+                    std::function<void(const HttpResponsePtr&)>&& callback);
+
+    /**
+     * Create or replace macro
+     * POST /api/macros
+     * Body: {"name": "movie_night", "description": "...", "steps": [...]}
+     */
+    void createMacro(const HttpRequestPtr& req,
+                     std::function<void(const HttpResponsePtr&)>&& callback);
+
+    /**
+     * Get macro
+     * GET /api/macros/:name
+     */
+    void getMacro(const HttpRequestPtr& req,
+                  std::function<void(const HttpResponsePtr&)>&& callback,
+                  std::string name);
+
+    /**
+     * Update macro
+     * PUT /api/macros/:name
+     * Body: {"description": "...", "steps": [...]}
+     */
+    void updateMacro(const HttpRequestPtr& req,
+                     std::function<void(const HttpResponsePtr&)>&& callback,
+                     std::string name);
+
+    /**
+     * Delete macro
+     * DELETE /api/macros/:name
+     */
+    void deleteMacro(const HttpRequestPtr& req,
+                     std::function<void(const HttpResponsePtr&)>&& callback,
+                     std::string name);
+
+private:
+    /**
+     * Validate, save and respond with the stored macro
+     */
+    void saveAndRespond(Macro macro,
+                        HttpStatusCode success_status,
+                        std::function<void(const HttpResponsePtr&)>&& callback);
+
+    /**
+     * Send error response
+     */
+    void sendError(std::function<void(const HttpResponsePtr&)>&& callback,
+                   HttpStatusCode status,
+                   const std::string& message);
+};
+
+} // namespace hms_firetv
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <drogon/HttpController.h>
-#include "clients/LightningClient.h"
 #include "repositories/DeviceRepository.h"
+#include "services/PairingSessionManager.h"
 #include "database/IDatabase.h"
 #include <memory>
+#include <optional>
 
 using namespace drogon;
 
@@ -14,9 +15,14 @@ namespace hms_firetv {
  * PairingController - REST API for Fire TV device pairing
  *
  * Pairing Flow:
- * 1. POST /api/devices/:id/pair/start   - Wake device and display PIN on TV
- * 2. POST /api/devices/:id/pair/verify  - User enters PIN, complete pairing
- * 3. POST /api/devices/:id/pair/reset   - Clear pairing and start over
+ * 1. POST /api/devices/:id/pair/start   - Display PIN on TV (202, session_id)
+ * 2. POST /api/devices/:id/pair/verify  - User enters PIN, token is polled (202)
+ * 3. GET  /api/devices/:id/pair/status?since=<version>&wait_ms=<ms>
+ *                                       - Long-poll until paired / failed
+ * 4. POST /api/devices/:id/pair/reset   - Clear pairing and start over
+ *
+ * Start and verify return immediately; the TV requests run on
+ * PairingSessionManager's poller, never on the IO thread.
  *
  * Endpoints:
  * - POST /api/devices/:id/pair/start    - Start pairing (display PIN)
@@ -47,10 +53,9 @@ public:
      * POST /api/devices/:id/pair/start
      *
      * This will:
-     * 1. Wake the device
-     * 2. Generate a 6-digit PIN
-     * 3. Display PIN on TV screen
-     * 4. Store PIN in database with expiration (5 minutes)
+     * 1. Create an in-memory pairing session (expires after 5 minutes)
+     * 2. Ask the TV to display its PIN in the background
+     * 3. Return 202 with the session (state: displaying_pin)
      */
     void startPairing(const HttpRequestPtr& req,
                      std::function<void(const HttpResponsePtr&)>&& callback,
@@ -62,10 +67,10 @@ public:
      * Body: {"pin": "123456"}
      *
      * This will:
-     * 1. Verify PIN matches and hasn't expired
-     * 2. Complete pairing with Fire TV
-     * 3. Store client token in database
-     * 4. Clear PIN
+     * 1. Check the session is awaiting a PIN and hasn't expired
+     * 2. Return 202 with the session (state: verifying)
+     * 3. Poll the TV for the client token in the background
+     * 4. Store the client token in the database once issued (state: paired)
      */
     void verifyPairing(const HttpRequestPtr& req,
                       std::function<void(const HttpResponsePtr&)>&& callback,
@@ -76,9 +81,10 @@ public:
      * POST /api/devices/:id/pair/reset
      *
      * This will:
-     * 1. Clear client token
-     * 2. Clear PIN
-     * 3. Update device status to offline
+     * 1. Cancel any pairing session in progress
+     * 2. Clear client token
+     * 3. Clear PIN
+     * 4. Update device status to offline
      */
     void resetPairing(const HttpRequestPtr& req,
                      std::function<void(const HttpResponsePtr&)>&& callback,
@@ -88,10 +94,14 @@ public:
      * Get pairing status
      * GET /api/devices/:id/pair/status
      *
+     * Query: wait_ms (long-poll, max 30000) and since (last session version
+     * seen); answers as soon as the session version differs from `since`.
+     *
      * Returns:
      * - is_paired: boolean
      * - pairing_in_progress: boolean
      * - pin_expires_at: timestamp (if pairing in progress)
+     * - session: {session_id, state, attempts, version, error?} (if any)
      */
     void getPairingStatus(const HttpRequestPtr& req,
                          std::function<void(const HttpResponsePtr&)>&& callback,
@@ -106,26 +116,18 @@ private:
     std::string generatePin();
 
     /**
-     * Check if PIN has expired
-     */
-    bool isPinExpired(const std::string& expires_at);
-
-    /**
-     * Get or create Lightning client for device
+     * Build the pair/status response
      */
-    std::shared_ptr<LightningClient> getClient(const std::string& device_id);
+    static HttpResponsePtr statusResponse(const Device& device,
+                                          const std::optional<PairingSession>& session);
 
     /**
      * Send error response
      */
-    void sendError(std::function<void(const HttpResponsePtr&)>&& callback,
+    static void sendError(std::function<void(const HttpResponsePtr&)>&& callback,
                    HttpStatusCode status,
                    const std::string& message);
 
-    // Cache of Lightning clients per device
-    std::map<std::string, std::shared_ptr<LightningClient>> clients_;
-    std::mutex clients_mutex_;
-
     static std::shared_ptr<IDatabase> db_;
 };
 
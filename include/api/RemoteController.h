@@ -0,0 +1,49 @@
+#pragma once
+
+#include <drogon/WebSocketController.h>
+
+using namespace drogon;
+
+namespace hms_firetv {
+
+/**
+ * RemoteController - WebSocket control channel for the web remote (/api/remote)
+ *
+ * One socket per remote session replaces a POST per button press. Messages
+ * are short text or 4-byte binary commands (format in RemoteControlService)
+ * and go straight into the device's press queue; every command is answered
+ * with an ack echoing its number:
+ *
+ *   -> @living_room                 (or ?device=living_room on connect)
+ *   <- {"t":"device","id":"living_room","ok":true}
+ *   -> 12 up
+ *   <- {"t":"ack","n":12,"ok":true,"ms":61.4,"timing":{"queue_ms":0.02,"transfer_ms":61.3}}
+ *   -> 13 down+                     (hold: KeyRepeatService repeats it)
+ *   <- {"t":"ack","n":13,"ok":true,"hold":"started"}
+ *   -> 14 -
+ *   <- {"t":"ack","n":14,"ok":true,"released":true}
+ *
+ * The first message from the server lists the key names; a key's index is
+ * its binary code. A hold still active when the socket closes is released.
+ */
+class RemoteController : public drogon::WebSocketController<RemoteController> {
+public:
+    WS_PATH_LIST_BEGIN
+    WS_PATH_ADD("/api/remote");
+    WS_PATH_LIST_END
+
+    void handleNewConnection(const HttpRequestPtr& req,
+                             const WebSocketConnectionPtr& conn) override;
+
+    void handleNewMessage(const WebSocketConnectionPtr& conn,
+                          std::string&& message,
+                          const WebSocketMessageType& type) override;
+
+    void handleConnectionClosed(const WebSocketConnectionPtr& conn) override;
+
+private:
+    static void sendJson(const WebSocketConnectionPtr& conn, const Json::Value& json);
+    static void sendError(const WebSocketConnectionPtr& conn, uint32_t n, const std::string& error);
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "utils/StaticAssets.h"
+#include <drogon/drogon.h>
+#include <memory>
+
+using namespace drogon;
+
+namespace hms_firetv {
+
+/**
+ * StaticAssetServer - Serves the in-memory web UI bundle (StaticAssets)
+ *
+ * Hooked in as a pre-routing advice, so asset requests are answered before
+ * Drogon's router and static file handler run: one hash lookup, a header
+ * check and a prebuilt response. The same index.html response answers
+ * client-side routes (SPA fallback) from the custom 404 handler.
+ *
+ * Responses are built once per IO thread and variant (200 and 304) and
+ * marked as never expiring, which makes Drogon render each one to a buffer
+ * once and send that buffer again for every later request - no per-request
+ * copy, compression or file access. Per thread because Drogon updates a
+ * cached response's Date header in place.
+ *
+ * Files that were not loaded (over STATIC_MAX_FILE_KB) fall through to the
+ * document root.
+ */
+class StaticAssetServer {
+public:
+    /**
+     * Start serving `assets`; call after the thread count is set, before run()
+     */
+    static void install(std::shared_ptr<const StaticAssets> assets);
+
+    /**
+     * Response for an asset (variant negotiated, 304 when the ETag matches)
+     */
+    static HttpResponsePtr respond(const HttpRequestPtr& req, const StaticAssets::Asset& asset);
+
+    /**
+     * index.html for client-side routes; nullptr when there is no bundle
+     */
+    static HttpResponsePtr spaFallback(const HttpRequestPtr& req);
+
+    /**
+     * Counters: files, bytes per encoding, responses by encoding, not_modified
+     */
+    static Json::Value stats();
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include <drogon/WebSocketController.h>
+
+using namespace drogon;
+
+namespace hms_firetv {
+
+/**
+ * StreamController - Push channel for the web UI (WebSocket at /api/stream)
+ *
+ * Every connection is an EventBus subscriber: device status changes,
+ * command results and discovery events arrive as compact JSON deltas the
+ * moment they are published, so the UI does not poll.
+ *
+ * The first message is always
+ *
+ *   {"t":"hello","seq":N,"resync":true|false}
+ *
+ * With "resync": true the client loads the current state over REST once
+ * (GET /api/devices, /status) and applies events after it. A reconnecting
+ * client passes the last seq it applied (?since=N); if the bus still holds
+ * everything after it, those events are replayed and "resync" is false.
+ *
+ * Same path, plain GET (no Upgrade header): StreamSseController serves the
+ * same events as Server-Sent Events, for proxies that do not pass
+ * WebSockets. EventSource reconnects by itself and sends Last-Event-ID,
+ * which is honoured like ?since.
+ *
+ * CONFIGURATION:
+ * ==============
+ * STREAM_MAX_CLIENTS - Concurrent stream connections, WebSocket + SSE (default: 64)
+ */
+class StreamController : public drogon::WebSocketController<StreamController> {
+public:
+    WS_PATH_LIST_BEGIN
+    WS_PATH_ADD("/api/stream");
+    WS_PATH_LIST_END
+
+    void handleNewConnection(const HttpRequestPtr& req,
+                             const WebSocketConnectionPtr& conn) override;
+
+    void handleNewMessage(const WebSocketConnectionPtr& conn,
+                          std::string&& message,
+                          const WebSocketMessageType& type) override;
+
+    void handleConnectionClosed(const WebSocketConnectionPtr& conn) override;
+
+    /**
+     * Counters: clients by transport, plus the bus's
+     */
+    static Json::Value stats();
+
+    static constexpr int PING_INTERVAL_SECONDS = 30;
+};
+
+/**
+ * StreamSseController - Server-Sent Events fallback for GET /api/stream
+ */
+class StreamSseController : public drogon::HttpController<StreamSseController> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(StreamSseController::stream, "/api/stream", Get);
+    METHOD_LIST_END
+
+    void stream(const HttpRequestPtr& req,
+                std::function<void(const HttpResponsePtr&)>&& callback);
+
+    static constexpr double KEEPALIVE_SECONDS = 20.0;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <drogon/HttpClient.h>
+#include "clients/LightningClient.h"
+#include "models/Device.h"
+#include "utils/ShardedLRUCache.h"
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace hms_firetv {
+
+/**
+ * AsyncLightningClient - Non-blocking Lightning transport on Drogon's HttpClient
+ *
+ * Counterpart of LightningClient for code running on (or fanning out from)
+ * Drogon event loops: requests return immediately and complete through a
+ * callback on an IO thread. One HttpClient is cached per base URL, so the
+ * keep-alive TLS connection to each Fire TV is reused between commands.
+ *
+ * Results use the same CommandResult as the blocking client.
+ */
+class AsyncLightningClient {
+public:
+    using Callback = std::function<void(CommandResult)>;
+
+    /**
+     * POST to the Lightning API (https://{ip}:8080)
+     *
+     * @param device Target device (IP, API key and token)
+     * @param path API path including query (e.g., "/v1/FireTV?action=home")
+     * @param json_body JSON body, empty for none
+     * @param callback Invoked with the result
+     * @param timeout_seconds Request timeout
+     */
+    static void post(const Device& device,
+                     const std::string& path,
+                     const std::string& json_body,
+                     Callback callback,
+                     double timeout_seconds = COMMAND_TIMEOUT_SECONDS);
+
+    /**
+     * Check whether the Lightning API answers (any HTTP status counts)
+     *
+     * The API stops responding while the TV is in standby.
+     */
+    static void probe(const Device& device, std::function<void(bool)> callback,
+                      double timeout_seconds = PROBE_TIMEOUT_SECONDS);
+
+    /**
+     * Wake the device (POST http://{ip}:8009/apps/FireTVRemote)
+     */
+    static void wake(const Device& device, Callback callback,
+                     double timeout_seconds = WAKE_TIMEOUT_SECONDS);
+
+    /**
+     * Start/stop dropping HTTP clients unused for an hour
+     */
+    static void startSweeper(std::chrono::milliseconds interval);
+    static void stopSweeper();
+
+    static constexpr double COMMAND_TIMEOUT_SECONDS = 5.0;
+    static constexpr double PROBE_TIMEOUT_SECONDS = 2.0;
+    static constexpr double WAKE_TIMEOUT_SECONDS = 5.0;
+
+private:
+    static drogon::HttpClientPtr getHttpClient(const std::string& base_url);
+
+    static void send(const std::string& base_url,
+                     const drogon::HttpRequestPtr& req,
+                     double timeout_seconds,
+                     Callback callback);
+
+    // Max 100 base URLs, 1 hour TTL. Looked up on every command from every
+    // IO thread (one per core); LRUCache::get() takes its single mutex
+    // exclusively to reorder, the sharded cache only a shared shard lock
+    static ShardedLRUCache<std::string, drogon::HttpClientPtr> http_clients_;
+};
+
+} // namespace hms_firetv
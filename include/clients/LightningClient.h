@@ -1,13 +1,48 @@
 #pragma once
 
 #include <string>
+#include <chrono>
 #include <optional>
 #include <json/json.h>
 #include <curl/curl.h>
 #include <mutex>
+#include "utils/Deadline.h"
 
 namespace hms_firetv {
 
+/**
+ * CommandTiming - Where a command's time went, in microseconds (-1 = not measured)
+ *
+ * dns/connect/tls are phase durations from curl and are 0 on a reused
+ * keep-alive connection. ttfb runs from the request being sent to the first
+ * response byte: the TV's processing time plus one round trip. Drogon's
+ * async HttpClient reports no phases, so its requests only have transfer
+ * (and the queue time callers add).
+ */
+struct CommandTiming {
+    int64_t queue_us = -1;       // Waiting for the device's client
+    int64_t wake_us = -1;        // Wake probe and wake-up polling
+    int64_t dns_us = -1;
+    int64_t connect_us = -1;
+    int64_t tls_us = -1;
+    int64_t ttfb_us = -1;
+    int64_t transfer_us = -1;    // Whole HTTP exchange (curl's total time)
+    int64_t round_trip_us = -1;  // Whole exchange from a client without phases (Drogon HttpClient)
+
+    bool measured() const;
+
+    /**
+     * Add another command's phases (batches: totals over their steps)
+     */
+    void add(const CommandTiming& other);
+
+    /**
+     * {queue_ms, wake_ms, dns_ms, connect_ms, tls_ms, ttfb_ms, transfer_ms,
+     * round_trip_ms} to 0.01ms; phases that were not measured are left out
+     */
+    Json::Value toJson() const;
+};
+
 /**
  * CommandResult - Result of a Lightning command execution
  */
@@ -17,6 +52,7 @@ struct CommandResult {
     int response_time_ms;
     std::optional<std::string> error;
     Json::Value response_body;
+    CommandTiming timing;       // Transport phases (queue/wake are filled in by callers)
 
     CommandResult() : success(false), status_code(0), response_time_ms(0) {}
 };
@@ -38,7 +74,8 @@ struct CommandResult {
  * THREAD SAFETY:
  * ==============
  * This class is NOT thread-safe. Create one instance per device or use
- * external synchronization if sharing across threads.
+ * external synchronization if sharing across threads. Service code leases
+ * instances from LightningClientPool, which guarantees exclusive use.
  */
 class LightningClient {
 public:
@@ -185,6 +222,22 @@ public:
      */
     CommandResult sendKeyboardInput(const std::string& text);
 
+    // ========================================================================
+    // PRECOMPILED REQUESTS
+    // ========================================================================
+
+    /**
+     * Send a prebuilt Lightning request
+     *
+     * Used by command sequences whose paths were validated when compiled
+     * (see LightningStep). Reuses this client's connection.
+     *
+     * @param path API path including query (e.g., "/v1/FireTV?action=home")
+     * @param json_body JSON body (empty for no body)
+     * @return Command result with success status and timing
+     */
+    CommandResult sendRequest(const std::string& path, const std::string& json_body = "");
+
     // ========================================================================
     // HEALTH CHECK
     // ========================================================================
@@ -206,6 +259,26 @@ public:
      */
     bool healthCheck();
 
+    // ========================================================================
+    // DEADLINE
+    // ========================================================================
+
+    /**
+     * Bound every following request by a command deadline
+     *
+     * Request timeouts are capped to the time left. Once it has passed,
+     * requests fail at once with Deadline::EXCEEDED instead of being sent.
+     * LightningClientPool clears it when the lease returns.
+     */
+    void setDeadline(const Deadline& deadline) { deadline_ = deadline; }
+    const Deadline& deadline() const { return deadline_; }
+
+    /**
+     * Transport phases of the last request sent through this client
+     */
+    const CommandTiming& lastTiming() const { return last_timing_; }
+    void clearTiming() { last_timing_ = CommandTiming(); }
+
 private:
     // Device information
     std::string ip_address_;
@@ -219,6 +292,11 @@ private:
     // CURL handle (reused for all requests)
     CURL* curl_;
 
+    // Deadline of the command currently using this client (unset = none)
+    Deadline deadline_;
+
+    CommandTiming last_timing_;
+
     // Request timeout (seconds)
     static constexpr long WAKE_TIMEOUT = 5L;
     static constexpr long HEALTH_TIMEOUT = 2L;
@@ -260,6 +338,26 @@ private:
                                 long timeout_seconds = COMMAND_TIMEOUT,
                                 bool include_token = true);
 
+    /**
+     * Add DNS/connect/TLS/request/response spans for the transfer just done
+     * to the current trace (no-op when the command is not traced)
+     */
+    void traceTransfer(const std::string& url,
+                       std::chrono::steady_clock::time_point start,
+                       CURLcode res) const;
+
+    /**
+     * Phase durations of the transfer just done, from curl's cumulative times
+     */
+    void readTiming(CommandTiming& timing) const;
+
+    /**
+     * Fail the request without sending it if the deadline has passed
+     *
+     * @return true if the result was filled in and the request must be skipped
+     */
+    bool rejectIfExpired(CommandResult& result) const;
+
     /**
      * Parse JSON response body
      *
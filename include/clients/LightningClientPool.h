@@ -0,0 +1,328 @@
+#pragma once
+
+#include "clients/LightningClient.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * LightningClientSpec - Connection parameters a LightningClient is built from
+ */
+struct LightningClientSpec {
+    std::string ip_address;
+    std::string api_key;
+    std::string client_token;
+
+    bool operator==(const LightningClientSpec& other) const {
+        return ip_address == other.ip_address &&
+               api_key == other.api_key &&
+               client_token == other.client_token;
+    }
+    bool operator!=(const LightningClientSpec& other) const { return !(*this == other); }
+};
+
+/**
+ * LightningClientPool - Per-device pool of LightningClient handles
+ *
+ * LightningClient owns a single CURL handle and is NOT thread-safe. Instead of
+ * sharing one instance across Drogon IO threads, MQTT callbacks and pairing,
+ * callers lease a client, use it exclusively, and the lease returns it.
+ *
+ * Per device:
+ * - Up to max_parallel handles exist at once (configurable per TV)
+ * - Idle handles are kept warm for reuse (CURL connection cache survives)
+ * - When all handles are leased, requests wait in a FIFO waiter queue
+ *
+ * Device pools are never dropped while a handle is leased or a request is
+ * waiting: the limit and the queue order hold for as long as anyone uses the
+ * device. Only idle pools are pruned (by the sweeper, or oldest first once
+ * there are more than max_devices).
+ *
+ * USAGE:
+ * ======
+ * ```cpp
+ * auto client = LightningClientPool::getInstance().lease(device_id);
+ * if (!client) { ... device not found ... }
+ * client->sendNavigationCommand("home");
+ * // returned to the pool when `client` goes out of scope
+ * ```
+ *
+ * A thread must not wait for a second lease on a device while holding one,
+ * or it can deadlock itself when max_parallel is 1.
+ */
+class LightningClientPool {
+    struct DevicePool;
+
+public:
+    /**
+     * Lease - Exclusive, move-only handle to a pooled LightningClient
+     *
+     * Evaluates to false if the device could not be resolved or the
+     * command's deadline passed while waiting (see deadlineExceeded()).
+     * The leased client carries the deadline it was requested with.
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease() { release(); }
+
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        explicit operator bool() const { return client_ != nullptr; }
+        LightningClient* operator->() const { return client_.get(); }
+        LightningClient& operator*() const { return *client_; }
+        LightningClient* get() const { return client_.get(); }
+
+        /**
+         * True if the lease was refused because the deadline passed in the queue
+         */
+        bool deadlineExceeded() const { return deadline_exceeded_; }
+
+        /**
+         * Connection parameters the leased client was built from
+         */
+        const LightningClientSpec& spec() const { return spec_; }
+
+        /**
+         * Return the client to the pool early (idempotent)
+         */
+        void release();
+
+    private:
+        friend class LightningClientPool;
+
+        Lease(std::shared_ptr<DevicePool> pool, std::unique_ptr<LightningClient> client,
+              LightningClientSpec spec, uint64_t generation);
+
+        static Lease expired();
+
+        std::shared_ptr<DevicePool> pool_;
+        std::unique_ptr<LightningClient> client_;
+        LightningClientSpec spec_;
+        uint64_t generation_ = 0;
+        bool deadline_exceeded_ = false;
+    };
+
+    using LeaseCallback = std::function<void(Lease)>;
+
+    /**
+     * Resolves a device ID to its connection parameters (nullopt = unknown device)
+     */
+    using SpecResolver = std::function<std::optional<LightningClientSpec>(const std::string& device_id)>;
+
+    /**
+     * Per-device pool counters
+     */
+    struct DeviceStats {
+        size_t idle = 0;
+        size_t in_use = 0;
+        size_t waiting = 0;
+    };
+
+    /**
+     * Get singleton instance
+     *
+     * Max parallelism comes from LIGHTNING_MAX_PARALLEL_PER_DEVICE (default: 2).
+     * The singleton subscribes to DeviceRepository changes, so edits, pairing
+     * and discovery IP moves rebuild exactly the affected device's handles.
+     */
+    static LightningClientPool& getInstance();
+
+    /**
+     * Constructor
+     *
+     * @param max_parallel_per_device Maximum handles leased at once per device
+     * @param resolver Device lookup (default: DeviceRepository)
+     * @param max_devices Idle device pools kept before the oldest is pruned (default: 512)
+     */
+    explicit LightningClientPool(size_t max_parallel_per_device = DEFAULT_MAX_PARALLEL,
+                                 SpecResolver resolver = {},
+                                 size_t max_devices = 512);
+
+    /**
+     * Destructor - stops the sweeper thread if running
+     */
+    ~LightningClientPool();
+
+    LightningClientPool(const LightningClientPool&) = delete;
+    LightningClientPool& operator=(const LightningClientPool&) = delete;
+
+    /**
+     * Lease a client, blocking while all handles for the device are in use
+     *
+     * Gives up when the deadline passes; the wait is removed from the queue.
+     *
+     * @param device_id Device identifier
+     * @param deadline Command deadline (default: none)
+     * @return Lease (false if device not found or deadline exceeded)
+     */
+    Lease lease(const std::string& device_id, const Deadline& deadline = Deadline());
+
+    /**
+     * Lease a client without blocking
+     *
+     * The callback runs immediately on the calling thread if a handle is free,
+     * otherwise on the thread that returns the next handle for this device.
+     * A waiter whose deadline has passed by then receives an expired lease
+     * instead of taking the handle.
+     *
+     * @param device_id Device identifier
+     * @param callback Receives the lease (false if device not found or deadline exceeded)
+     * @param deadline Command deadline (default: none)
+     */
+    void leaseAsync(const std::string& device_id, LeaseCallback callback,
+                    const Deadline& deadline = Deadline());
+
+    /**
+     * Drop pooled handles for a device; the next lease rebuilds from fresh
+     * connection parameters. Outstanding leases finish on their old handle,
+     * which is discarded on return.
+     */
+    void invalidate(const std::string& device_id);
+
+    /**
+     * Re-resolve a device and rebuild its handles only if the IP, API key or
+     * client token changed (warm connections survive unrelated edits)
+     *
+     * @return true if the device's handles were rebuilt
+     */
+    bool refresh(const std::string& device_id);
+
+    /**
+     * Forget every device pool (outstanding leases still return to their old
+     * pool, so the per-device limit is not enforced across the reset)
+     */
+    void clear();
+
+    /**
+     * Counters for one device (zeros if the device has no pool)
+     */
+    DeviceStats stats(const std::string& device_id) const;
+
+    /**
+     * Counters for every device that currently has a pool
+     */
+    std::vector<std::pair<std::string, DeviceStats>> allStats() const;
+
+    size_t maxParallelPerDevice() const { return max_parallel_; }
+
+    /**
+     * Drop device pools with nothing leased or waiting that have not been
+     * used for idle_for. Called by the sweeper; safe to call manually as well.
+     *
+     * @return Number of device pools dropped
+     */
+    size_t pruneIdle(std::chrono::milliseconds idle_for);
+
+    /**
+     * Start/stop the sweeper that prunes device pools idle for POOL_IDLE_TTL_SECONDS
+     */
+    void startSweeper(std::chrono::milliseconds interval);
+    void stopSweeper();
+
+    static constexpr size_t DEFAULT_MAX_PARALLEL = 2;
+    static constexpr int POOL_IDLE_TTL_SECONDS = 3600;
+
+private:
+    struct Waiter {
+        LeaseCallback callback;
+        Deadline deadline;
+        uint64_t id = 0;
+    };
+
+    struct DevicePool {
+        std::string device_id;
+        size_t max_parallel;
+        std::mutex mutex;
+        std::optional<LightningClientSpec> spec;  // nullopt = resolve on next lease
+        uint64_t generation = 0;
+        size_t in_use = 0;
+        std::vector<std::unique_ptr<LightningClient>> idle;
+        std::deque<Waiter> waiters;
+        uint64_t next_waiter_id = 1;
+        SpecResolver resolver;
+
+        // Set under mutex when the pool is pruned; a lease that finds it set
+        // looks the device up again instead of using a pool nobody else sees
+        bool retired = false;
+
+        // Serializes refresh() so concurrent edits apply in order, without
+        // holding mutex across the device lookup
+        std::mutex refresh_mutex;
+
+        std::atomic<int64_t> last_used_ms{0};
+    };
+
+    // A slot taken under pool->mutex: either a lease, or a reservation that
+    // needs the device resolved first (done without the lock)
+    struct Slot {
+        Lease lease;
+        bool needs_spec = false;
+        uint64_t generation = 0;
+    };
+
+    std::shared_ptr<DevicePool> findPool(const std::string& device_id) const;
+    std::shared_ptr<DevicePool> getOrCreatePool(const std::string& device_id);
+
+    // Requires pools_mutex_ held exclusively. Removes the least recently used
+    // idle pool and returns it, to be destroyed after the lock is released.
+    std::shared_ptr<DevicePool> pruneOldestLocked();
+
+    // Marks the pool retired if nothing is leased or waiting and it was last
+    // used at or before cutoff_ms
+    static bool retireIfIdle(const std::shared_ptr<DevicePool>& pool, int64_t cutoff_ms);
+
+    // Serves the callback inline if a handle is free (returns 0), otherwise
+    // queues it and returns the waiter ID. Returns nullopt without touching
+    // the callback if the pool was pruned in the meantime.
+    static std::optional<uint64_t> leaseOrWait(const std::shared_ptr<DevicePool>& pool,
+                                               LeaseCallback& callback,
+                                               const Deadline& deadline);
+
+    // Requires pool->mutex held and a free slot; counts the slot as in use
+    static Slot takeSlotLocked(const std::shared_ptr<DevicePool>& pool);
+
+    // Resolves the device for a reserved slot without holding pool->mutex.
+    // Releases the slot and returns an empty lease if it cannot be resolved.
+    static Lease buildReserved(const std::shared_ptr<DevicePool>& pool, uint64_t generation);
+
+    // Hands free slots to queued waiters, oldest first
+    static void serveWaiters(const std::shared_ptr<DevicePool>& pool);
+
+    // Called from Lease::release()
+    static void giveBack(const std::shared_ptr<DevicePool>& pool,
+                         std::unique_ptr<LightningClient> client,
+                         uint64_t generation);
+
+    static std::optional<LightningClientSpec> resolveFromRepository(const std::string& device_id);
+
+    size_t max_parallel_;
+    SpecResolver resolver_;
+    size_t max_devices_;
+
+    mutable std::shared_mutex pools_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<DevicePool>> pools_;
+
+    std::mutex sweeper_mutex_;
+    std::condition_variable sweeper_cv_;
+    std::thread sweeper_thread_;
+    bool sweeper_running_ = false;
+};
+
+} // namespace hms_firetv
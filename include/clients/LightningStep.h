@@ -0,0 +1,76 @@
+#pragma once
+
+#include <json/json.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * LightningStep - One precompiled step of a command sequence
+ *
+ * Steps are validated and translated to their Lightning request (path + body)
+ * once, when a batch is received or a named macro is saved, so running a
+ * sequence is just a series of POSTs over one leased client.
+ *
+ * STEP FORMAT (JSON):
+ * ===================
+ * ```json
+ * {"command": "navigate", "action": "home"}          // select|home|back|menu|...
+ * {"command": "navigate", "direction": "down"}       // up|down|left|right
+ * {"command": "media",    "action": "play"}          // play|pause|scan (+ "direction")
+ * {"command": "volume",   "action": "volume_up"}     // volume_up|volume_down|mute
+ * {"command": "app",      "package": "com.netflix.ninja"}
+ * {"command": "text",     "text": "search query"}
+ * {"command": "wake"}
+ * {"command": "delay",    "ms": 500}
+ * ```
+ * Any step may add "delay_ms" to pause after it runs.
+ */
+struct LightningStep {
+    enum class Kind {
+        Request,  // POST path/body to the Lightning API
+        Wake,     // POST to the wake endpoint (port 8009)
+        Delay     // Pause only
+    };
+
+    Kind kind = Kind::Request;
+    std::string command;       // Step name as given, for results/logging
+    std::string path;          // Lightning API path incl. query (Request only)
+    std::string body;          // JSON body, empty for none (Request only)
+    int delay_after_ms = 0;    // Pause after this step
+
+    /**
+     * Human-readable target (e.g. "home", "com.netflix.ninja")
+     */
+    std::string detail;
+
+    /**
+     * Compile one JSON step
+     *
+     * @param step Step object
+     * @param error Set to the reason on failure
+     * @return Compiled step, or nullopt if invalid
+     */
+    static std::optional<LightningStep> compile(const Json::Value& step, std::string& error);
+};
+
+using LightningSequence = std::vector<LightningStep>;
+
+/**
+ * Compile a JSON array of steps
+ *
+ * @param steps JSON array (1..MAX_SEQUENCE_STEPS entries, at most
+ *              MAX_SEQUENCE_DELAY_MS of delays in total)
+ * @param error Set to "step N: reason" on failure
+ * @return Shared immutable sequence, or nullptr if invalid
+ */
+std::shared_ptr<const LightningSequence> compileSequence(const Json::Value& steps, std::string& error);
+
+constexpr size_t MAX_SEQUENCE_STEPS = 64;
+constexpr int MAX_STEP_DELAY_MS = 10000;
+constexpr int MAX_SEQUENCE_DELAY_MS = 60000;
+
+} // namespace hms_firetv
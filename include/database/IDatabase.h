@@ -1,6 +1,7 @@
 #pragma once
 #include "models/Device.h"
 #include "models/DeviceApp.h"
+#include "models/Macro.h"
 #include <json/json.h>
 #include <optional>
 #include <string>
@@ -29,6 +30,7 @@ public:
     virtual bool deleteDevice(const std::string& device_id) = 0;
     virtual bool deviceExists(const std::string& device_id) = 0;
     virtual bool updateLastSeen(const std::string& device_id, const std::string& status) = 0;
+    virtual bool updateDeviceIp(const std::string& device_id, const std::string& ip_address) = 0;
     virtual bool setPairingPin(const std::string& device_id, const std::string& pin_code,
                                int expires_secs) = 0;
     virtual bool verifyPinAndSetToken(const std::string& device_id, const std::string& pin_code,
@@ -53,6 +55,13 @@ public:
     virtual bool addPopularAppsToDevice(const std::string& device_id,
                                         const std::string& category) = 0;
 
+    // ── Macros ───────────────────────────────────────────────────────────────
+
+    virtual std::vector<Macro> getAllMacros() = 0;
+    virtual std::optional<Macro> getMacro(const std::string& name) = 0;
+    virtual bool saveMacro(const Macro& macro) = 0;  // Insert or replace by name
+    virtual bool deleteMacro(const std::string& name) = 0;
+
     // ── Stats (for StatsController) ───────────────────────────────────────────
 
     virtual Json::Value getOverallStats() = 0;
@@ -27,6 +27,7 @@ public:
     bool deleteDevice(const std::string& device_id) override;
     bool deviceExists(const std::string& device_id) override;
     bool updateLastSeen(const std::string& device_id, const std::string& status) override;
+    bool updateDeviceIp(const std::string& device_id, const std::string& ip_address) override;
     bool setPairingPin(const std::string& device_id, const std::string& pin_code,
                        int expires_secs) override;
     bool verifyPinAndSetToken(const std::string& device_id, const std::string& pin_code,
@@ -49,6 +50,11 @@ public:
     bool addPopularAppsToDevice(const std::string& device_id,
                                 const std::string& category) override;
 
+    std::vector<Macro> getAllMacros() override;
+    std::optional<Macro> getMacro(const std::string& name) override;
+    bool saveMacro(const Macro& macro) override;
+    bool deleteMacro(const std::string& name) override;
+
     Json::Value getOverallStats() override;
     Json::Value getAllDeviceStats() override;
 
@@ -62,6 +68,7 @@ private:
 #ifdef WITH_POSTGRESQL
     Device parseDevice(const pqxx::row& row);
     DeviceApp parseApp(const pqxx::row& row);
+    Macro parseMacro(const pqxx::row& row);
 #endif
 };
 
@@ -26,6 +26,7 @@ public:
     bool deleteDevice(const std::string& device_id) override;
     bool deviceExists(const std::string& device_id) override;
     bool updateLastSeen(const std::string& device_id, const std::string& status) override;
+    bool updateDeviceIp(const std::string& device_id, const std::string& ip_address) override;
     bool setPairingPin(const std::string& device_id, const std::string& pin_code,
                        int expires_secs) override;
     bool verifyPinAndSetToken(const std::string& device_id, const std::string& pin_code,
@@ -48,6 +49,11 @@ public:
     bool addPopularAppsToDevice(const std::string& device_id,
                                 const std::string& category) override;
 
+    std::vector<Macro> getAllMacros() override;
+    std::optional<Macro> getMacro(const std::string& name) override;
+    bool saveMacro(const Macro& macro) override;
+    bool deleteMacro(const std::string& name) override;
+
     Json::Value getOverallStats() override;
     Json::Value getAllDeviceStats() override;
 
@@ -58,8 +64,10 @@ private:
 
     void createSchema();
     bool exec(const std::string& sql);
+    bool hasColumn(const std::string& table, const std::string& column);
     Device parseDevice(sqlite3_stmt* stmt);
     DeviceApp parseApp(sqlite3_stmt* stmt);
+    Macro parseMacro(sqlite3_stmt* stmt);
 
     static std::chrono::system_clock::time_point parseTs(const char* s);
     static std::optional<std::chrono::system_clock::time_point> parseTsOpt(const char* s);
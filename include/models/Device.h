@@ -2,7 +2,11 @@
 
 #include <string>
 #include <optional>
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <sstream>
+#include <vector>
 #include <json/json.h>
 
 namespace hms_firetv {
@@ -27,6 +31,7 @@ struct Device {
     std::optional<std::chrono::system_clock::time_point> last_seen_at;    // Last successful command
     std::chrono::system_clock::time_point created_at;
     std::chrono::system_clock::time_point updated_at;
+    std::vector<std::string> tags;                               // Groups for broadcast (e.g. "lobby")
 
     // Constructor with defaults
     Device() : id(0), api_key("0987654321"), status("offline"), adb_enabled(false) {
@@ -42,6 +47,58 @@ struct Device {
         return client_token.has_value() && !client_token->empty();
     }
 
+    /**
+     * Check if device carries a tag (tags are stored lowercase)
+     */
+    bool hasTag(const std::string& tag) const {
+        return std::find(tags.begin(), tags.end(), tag) != tags.end();
+    }
+
+    /**
+     * Tags as stored in the database ("lobby,floor2")
+     */
+    std::string tagsString() const {
+        std::string out;
+        for (const auto& tag : tags) {
+            if (!out.empty()) out += ",";
+            out += tag;
+        }
+        return out;
+    }
+
+    /**
+     * Parse a comma-separated tag list: trimmed, lowercased, deduplicated
+     */
+    static std::vector<std::string> parseTags(const std::string& csv) {
+        std::vector<std::string> out;
+        std::istringstream stream(csv);
+        std::string tag;
+        while (std::getline(stream, tag, ',')) {
+            tag.erase(0, tag.find_first_not_of(" \t"));
+            tag.erase(tag.find_last_not_of(" \t") + 1);
+            std::transform(tag.begin(), tag.end(), tag.begin(),
+                           [](unsigned char c) { return std::tolower(c); });
+            if (!tag.empty() && std::find(out.begin(), out.end(), tag) == out.end()) {
+                out.push_back(tag);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * Parse tags from an API request: ["lobby", "floor2"] or "lobby,floor2"
+     */
+    static std::vector<std::string> tagsFromJson(const Json::Value& value) {
+        if (!value.isArray()) {
+            return parseTags(value.isString() ? value.asString() : "");
+        }
+        std::string csv;
+        for (const auto& tag : value) {
+            if (tag.isString()) csv += tag.asString() + ",";
+        }
+        return parseTags(csv);
+    }
+
     /**
      * Check if device is online
      */
@@ -73,6 +130,10 @@ struct Device {
         json["adb_enabled"] = adb_enabled;
         json["is_paired"] = isPaired();
         json["is_online"] = isOnline();
+        json["tags"] = Json::arrayValue;
+        for (const auto& tag : tags) {
+            json["tags"].append(tag);
+        }
 
         if (client_token.has_value()) {
             json["client_token"] = client_token.value();
@@ -112,6 +173,7 @@ struct Device {
         if (json.isMember("ip_address")) device.ip_address = json["ip_address"].asString();
         if (json.isMember("api_key")) device.api_key = json["api_key"].asString();
         if (json.isMember("adb_enabled")) device.adb_enabled = json["adb_enabled"].asBool();
+        if (json.isMember("tags")) device.tags = tagsFromJson(json["tags"]);
 
         return device;
     }
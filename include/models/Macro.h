@@ -0,0 +1,33 @@
+#pragma once
+#include <json/json.h>
+#include <string>
+
+namespace hms_firetv {
+
+/**
+ * Macro - Named command sequence
+ *
+ * Steps use the LightningStep JSON format and run server-side against a
+ * single device (POST /api/devices/{id}/commands/batch, MQTT "macro").
+ */
+struct Macro {
+    int id = 0;
+    std::string name;
+    std::string description;
+    Json::Value steps = Json::Value(Json::arrayValue);
+    std::string created_at;
+    std::string updated_at;
+
+    Json::Value toJson() const {
+        Json::Value json;
+        json["id"] = id;
+        json["name"] = name;
+        json["description"] = description;
+        json["steps"] = steps;
+        json["created_at"] = created_at;
+        json["updated_at"] = updated_at;
+        return json;
+    }
+};
+
+} // namespace hms_firetv
@@ -1,12 +1,13 @@
 #pragma once
 
-#include "clients/LightningClient.h"
+#include "clients/LightningClientPool.h"
 #include "repositories/DeviceRepository.h"
+#include "services/MacroRunner.h"
 #include <json/json.h>
+#include <functional>
 #include <string>
 #include <map>
 #include <memory>
-#include <mutex>
 
 namespace hms_firetv {
 
@@ -18,6 +19,11 @@ namespace hms_firetv {
  */
 class CommandHandler {
 public:
+    /**
+     * Receives a queued macro's per-step result (on a macro worker thread)
+     */
+    using MacroCallback = std::function<void(const SequenceResult&)>;
+
     /**
      * Constructor
      */
@@ -26,21 +32,36 @@ public:
     /**
      * Handle incoming MQTT command
      *
+     * An optional "timeout_ms" in the payload sets the command's time budget
+     * (default: COMMAND_DEADLINE_MS); the queue wait, wake-up and Lightning
+     * request all stop once it has run out.
+     *
      * @param device_id Device identifier
      * @param payload Command payload (JSON)
+     * @param timing If given, filled with the queue wait, wake time and the
+     *               last Lightning request's phases
+     * @param on_macro If given, called with the result of a "macro" command
+     *                 once it has run (or failed to queue)
+     * @return true if the TV accepted the command (held keys, streamed
+     *         text and macros count as accepted once queued)
      */
-    void handleCommand(const std::string& device_id, const Json::Value& payload);
+    bool handleCommand(const std::string& device_id, const Json::Value& payload,
+                       CommandTiming* timing = nullptr, MacroCallback on_macro = nullptr);
 
 protected:
     /**
-     * Get or create Lightning client for device
+     * Lease an exclusive Lightning client for device
      *
-     * Caches clients for reuse.
+     * Clients are pooled per device and shared with the REST controllers.
      *
      * @param device_id Device identifier
-     * @return Lightning client or nullptr if device not found
+     * @param deadline Command deadline, carried by the leased client
+     * @return Lease (false if device not found or deadline exceeded)
      */
-    std::shared_ptr<LightningClient> getClientForDevice(const std::string& device_id);
+    LightningClientPool::Lease getClientForDevice(const std::string& device_id,
+                                                  const Deadline& deadline = Deadline());
+
+    // Command handlers return true if the TV accepted the command
 
     /**
      * Handle media control command
@@ -48,7 +69,7 @@ protected:
      * @param client Lightning client
      * @param command Command string
      */
-    void handleMediaCommand(LightningClient& client, const std::string& command);
+    bool handleMediaCommand(LightningClient& client, const std::string& command);
 
     /**
      * Handle volume command
@@ -56,7 +77,7 @@ protected:
      * @param client Lightning client
      * @param command Command string
      */
-    void handleVolumeCommand(LightningClient& client, const std::string& command);
+    bool handleVolumeCommand(LightningClient& client, const std::string& command);
 
     /**
      * Handle navigation command
@@ -64,7 +85,7 @@ protected:
      * @param client Lightning client
      * @param payload Full command payload
      */
-    void handleNavigationCommand(LightningClient& client, const Json::Value& payload);
+    bool handleNavigationCommand(LightningClient& client, const Json::Value& payload);
 
     /**
      * Handle power command
@@ -72,7 +93,7 @@ protected:
      * @param client Lightning client
      * @param command Command string ("turn_on" or "turn_off")
      */
-    void handlePowerCommand(LightningClient& client, const std::string& command);
+    bool handlePowerCommand(LightningClient& client, const std::string& command);
 
     /**
      * Handle app launch command
@@ -80,7 +101,15 @@ protected:
      * @param client Lightning client
      * @param payload Full command payload
      */
-    void handleAppLaunchCommand(LightningClient& client, const Json::Value& payload);
+    bool handleAppLaunchCommand(LightningClient& client, const Json::Value& payload);
+
+    /**
+     * Handle navigate with "hold": true (start or heartbeat a key repeat)
+     *
+     * @param device_id Device identifier
+     * @param payload Navigate payload (direction or action)
+     */
+    void handleHoldCommand(const std::string& device_id, const Json::Value& payload);
 
     /**
      * Handle text input command
@@ -88,7 +117,23 @@ protected:
      * @param client Lightning client
      * @param payload Full command payload with text field
      */
-    void handleTextInputCommand(LightningClient& client, const Json::Value& payload);
+    bool handleTextInputCommand(LightningClient& client, const Json::Value& payload);
+
+    /**
+     * Handle macro command
+     *
+     * Queues a named macro ("name") or inline "steps" on MacroRunner, which
+     * leases the device's client and runs the steps on a macro worker, so
+     * inter-step delays never hold the MQTT callback thread.
+     *
+     * @param device_id Device identifier
+     * @param payload Full command payload
+     * @param deadline Command deadline (queue wait included)
+     * @param done Receives the result (may be null)
+     * @return true if the macro was queued
+     */
+    bool handleMacroCommand(const std::string& device_id, const Json::Value& payload,
+                            const Deadline& deadline, MacroCallback done);
 
     /**
      * Map app name to package name
@@ -102,17 +147,14 @@ protected:
      * Ensure device is awake before sending commands
      *
      * Checks if Lightning API is responding. If not, wakes the device
-     * and waits for it to become available.
+     * and waits for it to become available, giving up early if the
+     * client's deadline would pass before the next poll.
      *
      * @param client Lightning client
      * @return true if device is awake and ready, false if wake failed
      */
     bool ensureDeviceAwake(LightningClient& client);
 
-    // Lightning client cache
-    std::map<std::string, std::shared_ptr<LightningClient>> clients_;
-    std::mutex clients_mutex_;
-
     // App name → package mapping
     std::map<std::string, std::string> app_packages_;
 };
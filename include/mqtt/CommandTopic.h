@@ -0,0 +1,44 @@
+#pragma once
+
+#include <json/json.h>
+#include <optional>
+#include <string>
+
+namespace hms_firetv {
+
+/**
+ * CommandTopic - Turns an MQTT command message into a CommandHandler payload
+ *
+ * Home Assistant buttons publish "PRESS" (or "HOLD"/"RELEASE") to
+ * maestro_hub/colada/{device_id}/{action}; the text entity publishes the
+ * field value to .../send_text and macros their name to .../macro. Anything
+ * else is taken as a JSON command body.
+ *
+ * Kept free of the MQTT client so the parsing can be tested and benchmarked
+ * without a broker.
+ */
+class CommandTopic {
+public:
+    struct Message {
+        std::string device_id;
+        std::string action;       // Last topic segment (e.g. "dpad_up"), may be empty
+        Json::Value payload;      // {"command": ..., ...}
+    };
+
+    /**
+     * Parse a message on maestro_hub/colada/{device_id}/{action}
+     *
+     * @param error Set when the result is nullopt
+     */
+    static std::optional<Message> parse(const std::string& topic, const std::string& payload,
+                                        std::string& error);
+
+    /**
+     * Device ID from maestro_hub/colada/{device_id}/... (empty if not a command topic)
+     */
+    static std::string deviceId(const std::string& topic);
+
+    static constexpr const char* PREFIX = "maestro_hub/colada/";
+};
+
+} // namespace hms_firetv
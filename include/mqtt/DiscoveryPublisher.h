@@ -4,6 +4,7 @@
 #include "mqtt/MQTTClient.h"
 #include <json/json.h>
 #include <string>
+#include <vector>
 
 namespace hms_firetv {
 
@@ -51,6 +52,22 @@ public:
      */
     bool publishAvailability(const std::string& device_id, bool online);
 
+    /**
+     * One retained discovery config
+     */
+    struct Message {
+        std::string topic;
+        std::string payload;
+    };
+
+    /**
+     * Serialized discovery configs for a device: one per button (BUTTONS
+     * order), then the text entity
+     */
+    static std::vector<Message> buildMessages(const Device& device);
+
+    static const std::vector<std::string> BUTTONS;
+
 private:
     /**
      * Build button configuration JSON (matching Python service)
@@ -59,7 +76,7 @@ private:
      * @param button_id Button identifier (e.g., "up", "play", "volume_up")
      * @return Button configuration
      */
-    Json::Value buildButtonConfig(const Device& device, const std::string& button_id);
+    static Json::Value buildButtonConfig(const Device& device, const std::string& button_id);
 
     /**
      * Build device info for HA (matching Python discovery.py)
@@ -67,15 +84,15 @@ private:
      * @param device Device
      * @return Device info JSON
      */
-    Json::Value buildDeviceInfo(const Device& device);
+    static Json::Value buildDeviceInfo(const Device& device);
 
     /**
-     * Publish text entity for keyboard input
+     * Build text entity configuration for keyboard input
      *
-     * @param device Device to publish text entity for
-     * @return true if published successfully
+     * @param device Device to build config for
+     * @return Text entity configuration
      */
-    bool publishTextEntity(const Device& device);
+    static Json::Value buildTextConfig(const Device& device);
 
     // MQTT client reference
     MQTTClient& mqtt_client_;
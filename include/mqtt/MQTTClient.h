@@ -183,16 +183,6 @@ private:
      */
     std::string buildTopic(const std::string& device_id, const std::string& suffix) const;
 
-    /**
-     * Extract device_id from topic
-     *
-     * maestro_hub/firetv/{device_id}/set -> device_id
-     *
-     * @param topic Full topic path
-     * @return Device identifier or empty string
-     */
-    std::string extractDeviceId(const std::string& topic) const;
-
     /**
      * Message arrived callback (internal)
      */
@@ -1,17 +1,39 @@
 #pragma once
 #include "models/Device.h"
 #include "database/IDatabase.h"
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
 namespace hms_firetv {
 
+/**
+ * What changed about a device (passed to DeviceChangeListener)
+ */
+enum class DeviceChange {
+    Updated,   // Row updated (IP, API key, name, status, ...)
+    Deleted,   // Row deleted
+    Paired,    // Client token set by pairing
+    Unpaired   // Client token cleared
+};
+
+/**
+ * Called after a successful write that may change a device's connection parameters
+ */
+using DeviceChangeListener = std::function<void(const std::string& device_id, DeviceChange change)>;
+
 class DeviceRepository {
 public:
     static DeviceRepository& getInstance();
     static void setDatabase(std::shared_ptr<IDatabase> db);
 
+    /**
+     * Subscribe to device changes (listeners run synchronously on the writing thread)
+     */
+    static void addChangeListener(DeviceChangeListener listener);
+
     DeviceRepository(const DeviceRepository&) = delete;
     DeviceRepository& operator=(const DeviceRepository&) = delete;
 
@@ -19,19 +41,33 @@ public:
     std::optional<Device> getDeviceById(const std::string& device_id);
     std::vector<Device> getAllDevices();
     std::vector<Device> getDevicesByStatus(const std::string& status);
+    std::vector<Device> getDevicesByTag(const std::string& tag);
     bool updateDevice(const Device& device);
     bool deleteDevice(const std::string& device_id);
     bool setPairingPin(const std::string& device_id, const std::string& pin_code,
                        int expires_in_seconds = 300);
     bool verifyPinAndSetToken(const std::string& device_id, const std::string& pin_code,
                                const std::string& client_token);
+    bool completePairing(const std::string& device_id, const std::string& client_token);
     bool clearPairing(const std::string& device_id);
     bool updateLastSeen(const std::string& device_id, const std::string& status = "online");
+
+    /**
+     * Record a new IP for a device that answered there (marks it online).
+     * Writes only the IP and status, so it cannot undo a concurrent edit of
+     * the other fields; listeners see DeviceChange::Updated.
+     */
+    bool updateDeviceIp(const std::string& device_id, const std::string& ip_address);
     bool deviceExists(const std::string& device_id);
 
 private:
     DeviceRepository() = default;
+    static void notifyChange(const std::string& device_id, DeviceChange change);
+    static void publishPaired(const std::string& device_id, bool paired);
+
     static std::shared_ptr<IDatabase> db_;
+    static std::vector<DeviceChangeListener> listeners_;
+    static std::mutex listeners_mutex_;
 };
 
 } // namespace hms_firetv
@@ -0,0 +1,59 @@
+#pragma once
+#include "clients/LightningStep.h"
+#include "database/IDatabase.h"
+#include "models/Macro.h"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * MacroRepository - Named command sequences
+ *
+ * Macros are validated on save and their compiled form is cached by name,
+ * so running one never re-parses its steps. The cache is dropped on save
+ * and delete.
+ */
+class MacroRepository {
+public:
+    static MacroRepository& getInstance();
+    static void setDatabase(std::shared_ptr<IDatabase> db);
+
+    MacroRepository(const MacroRepository&) = delete;
+    MacroRepository& operator=(const MacroRepository&) = delete;
+
+    std::vector<Macro> getAllMacros();
+    std::optional<Macro> getMacro(const std::string& name);
+
+    /**
+     * Validate and store a macro (insert or replace by name)
+     *
+     * @param macro Macro to save
+     * @param error Set to the validation error on failure
+     * @return true if saved
+     */
+    bool saveMacro(const Macro& macro, std::string& error);
+
+    bool deleteMacro(const std::string& name);
+
+    /**
+     * Get a macro's compiled steps
+     *
+     * @param name Macro name
+     * @return Compiled sequence, or nullptr if unknown or invalid
+     */
+    std::shared_ptr<const LightningSequence> getCompiled(const std::string& name);
+
+private:
+    MacroRepository() = default;
+    static std::shared_ptr<IDatabase> db_;
+
+    std::mutex cache_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<const LightningSequence>> compiled_;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "clients/LightningStep.h"
+#include "models/Device.h"
+#include "utils/Deadline.h"
+#include <json/json.h>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * DeviceOutcome - Result of a broadcast for one device
+ */
+struct DeviceOutcome {
+    std::string device_id;
+    bool success = false;
+    bool woke = false;          // Device was asleep and had to be woken first
+    int status_code = 0;
+    int response_time_ms = 0;   // Command round trip
+    int64_t total_ms = 0;       // Wake + command, from the device's turn
+    std::optional<std::string> error;
+
+    Json::Value toJson() const;
+};
+
+/**
+ * BroadcastResult - Aggregate of a fleet-wide command
+ */
+struct BroadcastResult {
+    size_t targets = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    size_t woken = 0;
+    size_t concurrency = 0;
+    int64_t wall_ms = 0;        // First request out to last device done
+    std::vector<DeviceOutcome> devices;  // Same order as the targets
+
+    Json::Value toJson() const;
+};
+
+/**
+ * BroadcastService - Sends one command to many Fire TVs at once
+ *
+ * Fans out over AsyncLightningClient, so no thread is held per device:
+ * up to `concurrency` devices are in flight and each completion starts the
+ * next one. With pre-wake on, every device is probed first and sleeping TVs
+ * are woken and polled in parallel, so a fleet of sleeping TVs costs one
+ * wake-up time instead of one per TV.
+ *
+ * CONFIGURATION:
+ * ==============
+ * BROADCAST_CONCURRENCY - Max devices in flight (default: 16); a request
+ *                         may ask for fewer but never more
+ */
+class BroadcastService {
+public:
+    using ResultCallback = std::function<void(BroadcastResult)>;
+
+    static BroadcastService& getInstance();
+
+    /**
+     * Send a compiled step to every device
+     *
+     * Delay steps are rejected by parseRequest(), not here.
+     *
+     * @param devices Targets (duplicates are not filtered)
+     * @param step Request or Wake step
+     * @param pre_wake Probe, and wake if needed, before sending
+     * @param concurrency Max devices in flight (0 = configured cap)
+     * @param deadline Whole-broadcast deadline: devices not started by then
+     *                 are skipped, and wake polling and requests are cut short
+     * @param callback Invoked once, after the last device completes
+     */
+    void broadcast(std::vector<Device> devices,
+                   LightningStep step,
+                   bool pre_wake,
+                   size_t concurrency,
+                   const Deadline& deadline,
+                   ResultCallback callback);
+
+    /**
+     * Parsed form of a REST/MQTT broadcast body
+     *
+     * {"command": {...step...}, "tag": "lobby" | "devices": ["a","b"],
+     *  "wake": true, "concurrency": 8, "timeout_ms": 20000}
+     */
+    struct Request {
+        std::vector<Device> devices;
+        LightningStep step;
+        bool pre_wake = true;
+        size_t concurrency = 0;
+        Deadline deadline;
+    };
+
+    /**
+     * Validate a body and resolve its targets
+     *
+     * No tag and no device list targets every device. Without "timeout_ms"
+     * the deadline allows COMMAND_DEADLINE_MS per wave of `concurrency`
+     * devices.
+     *
+     * @return Request, or nullopt with error set
+     */
+    static std::optional<Request> parseRequest(const Json::Value& body, std::string& error);
+
+    size_t maxConcurrency() const { return max_concurrency_; }
+
+    // Wake-up polling: the Lightning API comes up a few seconds after the wake
+    static constexpr int WAKE_POLL_ATTEMPTS = 5;
+    static constexpr double WAKE_POLL_INTERVAL_SECONDS = 1.0;
+
+private:
+    explicit BroadcastService(size_t max_concurrency);
+    BroadcastService(const BroadcastService&) = delete;
+    BroadcastService& operator=(const BroadcastService&) = delete;
+
+    size_t max_concurrency_;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "utils/Metrics.h"
+#include <json/json.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * DeviceSloTracker - Rolling per-device latency and error-rate objectives
+ *
+ * Latency problems usually belong to one TV (weak Wi-Fi, an aging stick),
+ * which the fleet-wide /metrics histograms average away. Every command
+ * result (MQTT and REST) and every Lightning reachability probe is added to
+ * its device's window; a device whose p95 latency or error rate breaches
+ * its objective over the window is marked degraded, and recovers once both
+ * are back below 80% of their objectives (so a device on the edge does not
+ * flap).
+ *
+ * Memory per device is fixed: the window is a ring of `slots` time slots,
+ * each holding counters and a latency histogram with MetricHistogram's
+ * buckets. Old slots are reused as time moves on, never reallocated.
+ *
+ * Failed probes are counted but are not errors: a TV in standby fails its
+ * probe by design. Successful probes add their latency.
+ *
+ * A background thread evaluates every device each `eval_interval` and calls
+ * the alert listener on each transition (main publishes it to
+ * maestro_hub/firetv/<device_id>/slo). GET /api/stats/devices shows each
+ * device's window.
+ *
+ * CONFIGURATION:
+ * ==============
+ * SLO_WINDOW_SECONDS  - Rolling window length (default: 300)
+ * SLO_P95_MS          - p95 latency objective (default: 1500)
+ * SLO_ERROR_PERCENT   - Error rate objective, percent of commands (default: 5)
+ * SLO_MIN_SAMPLES     - Commands/probes needed before judging (default: 20)
+ */
+class DeviceSloTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::chrono::seconds window{300};
+        size_t slots = 10;
+        std::chrono::milliseconds max_p95{1500};
+        double max_error_rate = 0.05;
+        uint32_t min_samples = 20;
+        std::chrono::seconds eval_interval{10};
+    };
+
+    enum class State { Ok, Degraded };
+
+    /**
+     * One device's window at evaluation time
+     */
+    struct Snapshot {
+        std::string device_id;
+        State state = State::Ok;
+        uint64_t commands = 0;
+        uint64_t errors = 0;
+        uint64_t probes = 0;
+        uint64_t probe_failures = 0;
+        double error_rate = 0.0;
+        double p50_ms = 0.0;
+        double p95_ms = 0.0;
+        double p99_ms = 0.0;
+        std::vector<std::string> reasons;          // Breached objectives, while degraded
+        std::chrono::seconds in_state{0};
+
+        /**
+         * {device_id, state, commands, errors, probes, probe_failures,
+         *  error_rate, p50_ms, p95_ms, p99_ms, reasons, in_state_s}
+         */
+        Json::Value toJson() const;
+    };
+
+    /**
+     * Called on each ok <-> degraded transition (from the evaluating thread)
+     */
+    using AlertListener = std::function<void(const Snapshot&)>;
+
+    /**
+     * Get singleton instance (configured from the environment)
+     */
+    static DeviceSloTracker& getInstance();
+
+    explicit DeviceSloTracker(Options options);
+    ~DeviceSloTracker();
+
+    DeviceSloTracker(const DeviceSloTracker&) = delete;
+    DeviceSloTracker& operator=(const DeviceSloTracker&) = delete;
+
+    void recordCommand(const std::string& device_id, bool success, std::chrono::microseconds elapsed,
+                       Clock::time_point now = Clock::now());
+
+    void recordProbe(const std::string& device_id, bool reachable, std::chrono::microseconds elapsed,
+                     Clock::time_point now = Clock::now());
+
+    void setAlertListener(AlertListener listener);
+
+    /**
+     * Re-judge every device and notify transitions
+     *
+     * Called by the background thread; public so tests can pass their own time.
+     */
+    void evaluate(Clock::time_point now = Clock::now());
+
+    /**
+     * Window of one device (state Ok and zero counts if never seen)
+     */
+    Snapshot snapshot(const std::string& device_id, Clock::time_point now = Clock::now()) const;
+
+    /**
+     * Windows of all tracked devices, keyed by device id
+     */
+    Json::Value toJson(Clock::time_point now = Clock::now()) const;
+
+    /**
+     * Stop tracking a device (deleted)
+     */
+    void remove(const std::string& device_id);
+
+    /**
+     * Counters: devices, degraded, alerts, plus the objectives
+     */
+    Json::Value stats() const;
+
+    /**
+     * Start/stop the evaluation thread
+     */
+    void start();
+    void stop();
+
+    const Options& options() const { return options_; }
+
+    static const char* stateName(State state);
+
+private:
+    struct Slot {
+        int64_t epoch = -1;                       // Slot index since the clock's epoch
+        uint32_t commands = 0;
+        uint32_t errors = 0;
+        uint32_t probes = 0;
+        uint32_t probe_failures = 0;
+        std::array<uint32_t, MetricHistogram::BUCKETS> latency{};
+    };
+
+    struct Window {
+        std::vector<Slot> slots;
+        State state = State::Ok;
+        Clock::time_point state_since;
+        std::vector<std::string> reasons;
+    };
+
+    // Require mutex_ held
+    Window& windowFor(const std::string& device_id, Clock::time_point now);
+    Slot& slotFor(Window& window, Clock::time_point now);
+    Snapshot summarize(const std::string& device_id, const Window& window, Clock::time_point now) const;
+
+    int64_t epochOf(Clock::time_point now) const;
+    void evaluatorLoop();
+
+    Options options_;
+    std::chrono::nanoseconds slot_length_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Window> windows_;
+    AlertListener listener_;
+    uint64_t alerts_ = 0;
+
+    std::condition_variable cv_;
+    bool running_ = false;
+    std::thread evaluator_;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <json/json.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * EventBus - In-process fan-out of state changes to push clients
+ *
+ * The web UI used to poll /status and /api/devices every 10-15s, rebuilding
+ * JSON from the database each time. Instead, everything that changes what
+ * the UI shows is published here once and pushed to every /api/stream
+ * connection (WebSocket or SSE):
+ *
+ *   {"seq":41,"t":"device","id":"living_room","status":"online"}
+ *   {"seq":42,"t":"command","id":"living_room","cmd":"navigation","ok":true,"ms":84}
+ *   {"seq":43,"t":"discovery","event":"moved","id":"bedroom","from":"...","to":"..."}
+ *
+ * Events are compact deltas: a "device" event carries only the fields that
+ * changed since the last one for that device (per-command last-seen updates
+ * that leave the status as it was publish nothing). Device fields come from
+ * repository writes (status, name, ip_address, tags, adb_enabled,
+ * is_paired), reachability probes (reachable) and SLO transitions (slo). Each event is
+ * serialized once and the same buffer is handed to every subscriber.
+ *
+ * Every event gets a sequence number. The last `replay_capacity` events
+ * are kept so a client that reconnects can ask for what it missed
+ * (`since`); if they are gone - or nobody was subscribed when they were
+ * published, in which case they are not kept - it must refetch over REST.
+ *
+ * Subscribers are called synchronously on the publishing thread, in
+ * sequence order, and must only queue the payload (never block or publish).
+ *
+ * CONFIGURATION:
+ * ==============
+ * STREAM_REPLAY_EVENTS - Events kept for reconnecting clients (default: 256)
+ */
+class EventBus {
+public:
+    struct Event {
+        uint64_t seq = 0;
+        std::shared_ptr<const std::string> payload;   // Compact JSON, including "seq"
+    };
+
+    using Subscriber = std::function<void(const Event&)>;
+
+    /**
+     * Get singleton instance (configured from the environment)
+     */
+    static EventBus& getInstance();
+
+    explicit EventBus(size_t replay_capacity = 256);
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * Register a subscriber; returns its id for unsubscribe()
+     *
+     * No event is delivered to a subscriber after unsubscribe() returns.
+     */
+    uint64_t subscribe(Subscriber subscriber);
+    void unsubscribe(uint64_t id);
+
+    /**
+     * Publish {"seq", "t": type, ...fields}; returns the sequence number
+     */
+    uint64_t publish(const std::string& type, const Json::Value& fields);
+
+    /**
+     * Publish a "command" event: {id, cmd, ok, ms, via} ("mqtt" or "rest")
+     */
+    void commandResult(const std::string& device_id, const std::string& command, bool success,
+                       std::chrono::microseconds elapsed, const char* via);
+
+    /**
+     * Publish a "device" event with the members of `fields` that differ
+     * from the device's last published state (nothing if none do)
+     */
+    void deviceState(const std::string& device_id, const Json::Value& fields);
+
+    /**
+     * Publish a "device" lifecycle event ("created", "deleted") and reset
+     * the device's known state
+     */
+    void deviceLifecycle(const std::string& device_id, const std::string& change);
+
+    /**
+     * Events after `seq`, oldest first; nullopt when some are no longer
+     * available (the client must resync)
+     */
+    std::optional<std::vector<Event>> since(uint64_t seq) const;
+
+    /**
+     * Sequence number of the latest event (0 before the first)
+     */
+    uint64_t lastSeq() const;
+
+    /**
+     * Counters: subscribers, published (= last sequence number), delivered, retained
+     */
+    Json::Value stats() const;
+
+private:
+    // Require mutex_ held
+    uint64_t publishLocked(const std::string& type, const Json::Value& fields);
+
+    const size_t replay_capacity_;
+
+    // Recursive: a subscriber's send may close its connection, which unsubscribes
+    mutable std::recursive_mutex mutex_;
+    std::shared_ptr<const std::vector<std::pair<uint64_t, Subscriber>>> subscribers_;
+    uint64_t next_subscriber_ = 1;
+    uint64_t seq_ = 0;
+    uint64_t delivered_ = 0;
+    std::deque<Event> replay_;
+    std::unordered_map<std::string, Json::Value> devices_;   // Last published state
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "clients/LightningStep.h"
+#include "models/Device.h"
+#include "utils/TimerWheel.h"
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace hms_firetv {
+
+/**
+ * KeyRepeatService - Server-side auto-repeat for held navigation keys
+ *
+ * A UI holding a d-pad key used to send one HTTP/MQTT message per repeat.
+ * With press/hold/release the client sends one "hold" and one "release";
+ * the server sends the first press immediately and then repeats the key
+ * every `interval` after `initial_delay`, like a keyboard's auto-repeat:
+ *
+ *   {"command": "navigate", "direction": "down", "hold": true}   -> start
+ *   (same message again)                                         -> heartbeat
+ *   {"command": "release"}                                       -> stop
+ *
+ * Watchdog: a client that disappears mid-hold must not leave the TV
+ * scrolling, so holds end on their own unless the hold message is repeated
+ * (as a heartbeat) within `watchdog`. Holds are also capped at `max_hold`.
+ *
+ * Repeats are scheduled on one TimerWheel shared by all devices and sent
+ * over AsyncLightningClient, whose HttpClient per TV keeps one warm
+ * keep-alive connection. A repeat is skipped rather than queued while the
+ * previous one is still in flight, so a slow TV never builds a backlog.
+ * One key is held per device; holding another key replaces it.
+ *
+ * CONFIGURATION:
+ * ==============
+ * NAV_REPEAT_DELAY_MS     - Hold time before repeating starts (default: 400)
+ * NAV_REPEAT_INTERVAL_MS  - Time between repeats (default: 100)
+ * NAV_HOLD_WATCHDOG_MS    - Auto-release without a heartbeat (default: 2000)
+ */
+class KeyRepeatService {
+public:
+    using SendCallback = std::function<void(bool success)>;
+
+    /**
+     * Sends one key press (non-blocking; calls back when done)
+     */
+    using Sender = std::function<void(const Device& device, const LightningStep& step,
+                                      SendCallback done)>;
+
+    struct Options {
+        std::chrono::milliseconds initial_delay{400};
+        std::chrono::milliseconds interval{100};
+        std::chrono::milliseconds watchdog{2000};
+        std::chrono::milliseconds max_hold{30000};
+        std::chrono::milliseconds tick{10};
+    };
+
+    enum class HoldState {
+        Started,    // New hold, first press sent
+        Refreshed,  // Same key already held: heartbeat
+        Replaced    // Another key was held; it stopped
+    };
+
+    /**
+     * What a hold did once released
+     */
+    struct HoldSummary {
+        std::string key;
+        uint64_t repeats = 0;   // Presses sent after the first
+        int64_t held_ms = 0;
+
+        Json::Value toJson() const;
+    };
+
+    /**
+     * Get singleton instance
+     *
+     * Sends through the sender given to setSender() (main wires it to
+     * AsyncLightningClient), which must be set before first use.
+     */
+    static KeyRepeatService& getInstance();
+
+    static void setSender(Sender sender);
+
+    KeyRepeatService(Sender sender, Options options);
+    ~KeyRepeatService();
+
+    KeyRepeatService(const KeyRepeatService&) = delete;
+    KeyRepeatService& operator=(const KeyRepeatService&) = delete;
+
+    /**
+     * Press and hold a key, or refresh the hold's watchdog
+     *
+     * @param device Target device
+     * @param step Compiled navigate step (see navigationStep())
+     */
+    HoldState hold(const Device& device, const LightningStep& step);
+
+    /**
+     * Release the device's held key
+     *
+     * @return Summary, or nullopt if nothing was held
+     */
+    std::optional<HoldSummary> release(const std::string& device_id);
+
+    bool isHolding(const std::string& device_id) const;
+
+    /**
+     * Compile a navigate payload ({"direction": "up"} / {"action": "select"})
+     */
+    static std::optional<LightningStep> navigationStep(const Json::Value& payload, std::string& error);
+
+    static const char* holdStateName(HoldState state);
+
+    /**
+     * Counters: holds, repeats, skipped, watchdog_releases, active
+     */
+    Json::Value stats() const;
+
+    const Options& options() const { return options_; }
+
+    // Per-press request timeout (a repeat older than this is stale anyway)
+    static constexpr double PRESS_TIMEOUT_SECONDS = 2.0;
+
+    /**
+     * Stop repeating everything
+     */
+    void stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Hold {
+        Device device;
+        LightningStep step;
+        uint64_t generation = 0;
+        Clock::time_point started;
+        Clock::time_point last_heartbeat;
+        TimerWheel::TimerId timer = 0;
+        uint64_t repeats = 0;
+        bool in_flight = false;
+    };
+
+    // Requires mutex_ held
+    void scheduleRepeat(const std::string& device_id, Hold& hold, std::chrono::milliseconds delay);
+    HoldSummary summarize(const Hold& hold) const;
+
+    void repeat(const std::string& device_id, uint64_t generation);
+    void sendPress(const std::string& device_id, uint64_t generation,
+                   const Device& device, const LightningStep& step);
+
+    Sender sender_;
+    Options options_;
+    TimerWheel wheel_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Hold> holds_;
+    uint64_t next_generation_ = 1;
+
+    std::atomic<uint64_t> holds_started_{0};
+    std::atomic<uint64_t> repeats_sent_{0};
+    std::atomic<uint64_t> repeats_skipped_{0};
+    std::atomic<uint64_t> watchdog_releases_{0};
+
+    static Sender default_sender_;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "clients/LightningClient.h"
+#include "clients/LightningStep.h"
+#include "utils/Deadline.h"
+#include <json/json.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * StepResult - Outcome and timing of one sequence step
+ */
+struct StepResult {
+    size_t index = 0;
+    std::string command;
+    std::string detail;
+    bool success = false;
+    int status_code = 0;
+    int response_time_ms = 0;   // Lightning round trip (0 for delays)
+    int64_t started_at_ms = 0;  // Offset from sequence start
+    CommandTiming timing;       // Transport phases, or wake_us for wake steps
+    std::optional<std::string> error;
+
+    Json::Value toJson() const;
+};
+
+/**
+ * SequenceResult - Outcome of a whole batch or macro run
+ */
+struct SequenceResult {
+    bool success = false;
+    int64_t queue_ms = 0;       // Waiting for the device's client and a worker
+    int64_t total_ms = 0;       // Running the steps, delays included
+    size_t steps_run = 0;
+    std::vector<StepResult> steps;
+    std::optional<std::string> error;
+
+    /**
+     * Queue wait plus each phase summed over the steps
+     */
+    CommandTiming timing() const;
+
+    Json::Value toJson() const;
+};
+
+/**
+ * MacroRunner - Runs compiled command sequences server-side
+ *
+ * A sequence holds one leased LightningClient for its whole run, so steps go
+ * out in order over the same keep-alive connection and never interleave with
+ * other commands for that device. Runs are queued behind the device's other
+ * leases (LightningClientPool) and then executed on a small worker pool, so
+ * inter-step delays never block HTTP IO threads.
+ *
+ * CONFIGURATION:
+ * ==============
+ * - MACRO_WORKERS: concurrent sequences across all devices (default: 4)
+ */
+class MacroRunner {
+public:
+    using ResultCallback = std::function<void(SequenceResult)>;
+
+    static MacroRunner& getInstance();
+
+    ~MacroRunner();
+
+    MacroRunner(const MacroRunner&) = delete;
+    MacroRunner& operator=(const MacroRunner&) = delete;
+
+    /**
+     * Run a sequence on an already-leased client (blocking)
+     *
+     * Stops with error Deadline::EXCEEDED once the client's deadline has
+     * passed; delays are cut short at the deadline.
+     *
+     * @param client Client with exclusive use for the duration
+     * @param sequence Compiled steps
+     * @param stop_on_error Skip remaining steps after a failure
+     * @return Per-step results
+     */
+    static SequenceResult run(LightningClient& client,
+                              const LightningSequence& sequence,
+                              bool stop_on_error = true);
+
+    /**
+     * Queue a sequence for a device (non-blocking)
+     *
+     * The callback runs on a worker thread once the sequence finishes, or
+     * immediately with `error` set if the device is unknown or the runner
+     * is stopped.
+     *
+     * @param device_id Device identifier
+     * @param sequence Compiled steps (shared, e.g. from MacroRepository)
+     * @param stop_on_error Skip remaining steps after a failure
+     * @param deadline Command deadline (queue wait included)
+     * @param callback Receives the result
+     */
+    void runAsync(const std::string& device_id,
+                  std::shared_ptr<const LightningSequence> sequence,
+                  bool stop_on_error,
+                  const Deadline& deadline,
+                  ResultCallback callback);
+
+    /**
+     * Sequences waiting for a worker
+     */
+    size_t queueDepth() const;
+
+    /**
+     * Stop workers; queued sequences complete with an error
+     */
+    void stop();
+
+private:
+    using Job = std::function<void(bool cancelled)>;
+
+    explicit MacroRunner(size_t workers);
+
+    void ensureStarted();
+    void enqueue(Job job);
+    void workerLoop();
+
+    size_t worker_count_;
+    std::once_flag start_flag_;
+    std::atomic<bool> stopped_{false};
+    std::vector<std::thread> workers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <json/json.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * PairingState - Where a device's pairing session stands
+ *
+ *   DisplayingPin -> AwaitingPin -> Verifying -> Paired
+ *         |               ^            |
+ *         v               +--- Failed <-+        (any) -> Expired | Cancelled
+ */
+enum class PairingState {
+    DisplayingPin,  // Asking the TV to show its PIN
+    AwaitingPin,    // PIN on screen, waiting for the user to submit it
+    Verifying,      // Polling the TV for the client token
+    Paired,         // Token stored in the database
+    Failed,         // Display or verification failed (verify may be retried)
+    Expired,        // Session TTL reached before pairing completed
+    Cancelled       // Reset while in progress
+};
+
+const char* pairingStateName(PairingState state);
+
+/**
+ * PairingSession - Snapshot of one device's pairing session
+ */
+struct PairingSession {
+    std::string session_id;
+    std::string device_id;
+    PairingState state = PairingState::DisplayingPin;
+    int attempts = 0;                   // Token polls made for the current PIN
+    std::string error;
+    std::chrono::system_clock::time_point expires_at;
+    uint64_t version = 0;               // Bumped on every state change (long-poll cursor)
+
+    bool isActive() const {
+        return state == PairingState::DisplayingPin ||
+               state == PairingState::AwaitingPin ||
+               state == PairingState::Verifying;
+    }
+
+    Json::Value toJson() const;
+};
+
+/**
+ * PairingSessionManager - In-memory pairing state machine per device
+ *
+ * Pairing used to run on the HTTP IO thread: displaying the PIN and
+ * verifying it (three tries, a second apart, each up to the 10s Lightning
+ * timeout) could hold an event loop for 30+ seconds. Now the REST handlers
+ * only create or advance a session and return at once; the TV requests run
+ * on a few worker threads, and one poller thread runs the timers (token
+ * poll interval, session expiry, long-poll timeouts):
+ *
+ * - start():  session -> DisplayingPin, the PIN display request is queued
+ * - verify(): session -> Verifying, the token is polled every poll_interval
+ *             until it arrives or max_token_polls is reached
+ * - Paired:   the token is written to the database (the only DB write)
+ *
+ * Clients follow progress with waitForChange() (long-poll on the session
+ * version). Sessions expire after session_ttl; finished sessions are kept
+ * for finished_retention so a late status poll still sees the outcome.
+ *
+ * The poller never makes a TV request, so a slow TV cannot hold up expiry
+ * or long-poll answers. TV requests share tv_workers threads (default 2);
+ * a slow TV holds one of them for at most its (5s) request deadline.
+ *
+ * The TV and database operations are injectable for tests; getInstance()
+ * wires them to LightningClientPool and DeviceRepository.
+ */
+class PairingSessionManager {
+public:
+    struct Operations {
+        // Ask the TV to display its PIN; true if acknowledged
+        std::function<bool(const std::string& device_id)> display_pin;
+        // Submit the PIN; returns the client token, empty if not (yet) issued
+        std::function<std::string(const std::string& device_id, const std::string& pin)> verify_pin;
+        // Persist the token; true on success
+        std::function<bool(const std::string& device_id, const std::string& token)> complete;
+    };
+
+    struct Timing {
+        std::chrono::milliseconds poll_interval{1000};
+        int max_token_polls = 5;
+        std::chrono::milliseconds session_ttl{5 * 60 * 1000};
+        std::chrono::milliseconds finished_retention{5 * 60 * 1000};
+    };
+
+    /**
+     * Why verify() refused a PIN
+     */
+    enum class VerifyError {
+        None,
+        NoSession,      // Never started, cancelled or already paired
+        NotDisplayed,   // The TV never showed a PIN; start again
+        Expired,        // Session TTL reached
+        Busy            // PIN display or a previous verification still running
+    };
+
+    static const char* verifyErrorMessage(VerifyError error);
+
+    using ChangeCallback = std::function<void(std::optional<PairingSession>)>;
+
+    static PairingSessionManager& getInstance();
+
+    PairingSessionManager(Operations operations, Timing timing, size_t tv_workers = 2);
+    ~PairingSessionManager();
+
+    PairingSessionManager(const PairingSessionManager&) = delete;
+    PairingSessionManager& operator=(const PairingSessionManager&) = delete;
+
+    /**
+     * Start (or restart) pairing for a device
+     *
+     * Replaces any previous session for the device.
+     *
+     * @return New session (state DisplayingPin)
+     */
+    PairingSession start(const std::string& device_id);
+
+    /**
+     * Submit the PIN shown on the TV and start polling for the token
+     *
+     * Accepted while AwaitingPin, or Failed within the session TTL (retry).
+     *
+     * @param error Set on rejection
+     * @return Session (state Verifying), or nullopt
+     */
+    std::optional<PairingSession> verify(const std::string& device_id,
+                                         const std::string& pin,
+                                         VerifyError& error);
+
+    /**
+     * Current session for a device, if any
+     */
+    std::optional<PairingSession> get(const std::string& device_id) const;
+
+    /**
+     * Long-poll: call back once the session's version differs from
+     * `since_version`, or when `timeout` elapses (with the current state)
+     *
+     * Calls back immediately if it already differs. Callbacks run on the
+     * poller, a TV worker or the calling thread.
+     */
+    void waitForChange(const std::string& device_id,
+                       uint64_t since_version,
+                       std::chrono::milliseconds timeout,
+                       ChangeCallback callback);
+
+    /**
+     * Cancel an in-progress session (e.g. on pairing reset)
+     */
+    void cancel(const std::string& device_id);
+
+    /**
+     * Stop the poller and TV workers; pending long-polls are answered with the current state
+     */
+    void stop();
+
+    static constexpr int MAX_WAIT_MS = 30000;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Waiter {
+        uint64_t id;
+        uint64_t since_version;
+        ChangeCallback callback;
+    };
+
+    struct Entry {
+        PairingSession session;
+        std::string pin;
+        bool pin_displayed = false;
+        std::vector<Waiter> waiters;
+    };
+
+    using Notification = std::pair<ChangeCallback, std::optional<PairingSession>>;
+
+    // All require mutex_ held
+    void schedule(Clock::duration delay, std::function<void()> job);
+    void post(std::function<void()> job);
+    void changed(Entry& entry, std::vector<Notification>& out);
+    void scheduleExpiry(const std::string& device_id, const std::string& session_id);
+    void scheduleRemoval(const std::string& device_id, const std::string& session_id);
+    void finish(Entry& entry, PairingState state, const std::string& error,
+                std::vector<Notification>& out);
+    Entry* findSession(const std::string& device_id, const std::string& session_id);
+
+    // TV jobs (run on a worker without mutex_)
+    void runDisplay(const std::string& device_id, const std::string& session_id);
+    void runVerify(const std::string& device_id, const std::string& session_id);
+
+    void pollerLoop();
+    void workerLoop();
+    static void notify(std::vector<Notification>& notifications);
+    static std::string newSessionId();
+
+    Operations ops_;
+    Timing timing_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<std::string, Entry> sessions_;
+    std::multimap<Clock::time_point, std::function<void()>> timers_;
+    std::deque<std::function<void()>> tv_jobs_;
+    std::condition_variable tv_cv_;
+    uint64_t next_waiter_id_ = 1;
+    uint64_t next_version_ = 1;  // Global so a restarted session never reuses a version
+
+    std::thread poller_;
+    std::vector<std::thread> tv_workers_;
+    bool stopped_ = false;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "clients/LightningClient.h"
+#include "clients/LightningStep.h"
+#include "models/Device.h"
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * RemoteControlService - Ordered per-device key presses for the web remote
+ *
+ * Behind the /api/remote WebSocket: each press names a key from a fixed
+ * table of precompiled Lightning requests - no JSON body, routing or
+ * database lookup per press.
+ *
+ * Each device has a FIFO lane with one press in flight, so presses reach
+ * the TV in the order they were made (separate async REST calls can
+ * overtake each other). Lanes are bounded: a press that finds
+ * `max_queued` presses waiting is rejected rather than replayed seconds
+ * later. The device is resolved once and cached until DeviceRepository
+ * reports a change.
+ *
+ * The press in flight runs as a one-step sequence on MacroRunner, so it
+ * waits in the device's LightningClientPool queue behind MQTT commands
+ * and macros like any other lease and never exceeds the per-device limit.
+ *
+ * Presses are recorded like MQTT commands (metrics, SLO window, /api/stream
+ * "command" events with via "ws"), not in the command history.
+ *
+ * WIRE FORMAT (see parse()):
+ * ==========================
+ * Text:    "@living_room"  select device
+ *          "12 up"         press (12 is echoed in the ack)
+ *          "13 down+"      press and hold (repeats server-side)
+ *          "14 -"          release the held key
+ * Binary:  [n hi][n lo][key code][flags]   flags: 1 = hold, 2 = release
+ *
+ * Key codes are indexes into keyNames().
+ *
+ * CONFIGURATION:
+ * ==============
+ * REMOTE_MAX_QUEUED - Presses waiting per device before rejecting (default: 16)
+ */
+class RemoteControlService {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Outcome of one press, as acked to the client
+     */
+    struct Ack {
+        bool success = false;
+        std::string error;
+        CommandTiming timing;                  // queue_us (lane and client queue), plus the transport's phases
+        std::chrono::microseconds total{0};    // Queued to answered
+    };
+
+    using AckCallback = std::function<void(const Ack&)>;
+
+    /**
+     * Sends one request (non-blocking; calls back when done). The step is
+     * an entry of the key table.
+     */
+    using Sender = std::function<void(const Device& device, const LightningStep& step,
+                                      std::function<void(CommandResult)> done)>;
+
+    using Resolver = std::function<std::optional<Device>(const std::string& device_id)>;
+
+    struct Options {
+        size_t max_queued = 16;
+    };
+
+    /**
+     * One decoded control message
+     */
+    struct Message {
+        enum class Type { Select, Press, Hold, Release };
+
+        Type type = Type::Press;
+        uint32_t n = 0;                         // Client's number, echoed in the ack
+        const LightningStep* key = nullptr;     // Press/Hold
+        std::string device_id;                  // Select
+    };
+
+    /**
+     * Get singleton instance
+     *
+     * Sends through MacroRunner (leasing from LightningClientPool) and
+     * resolves devices from DeviceRepository.
+     */
+    static RemoteControlService& getInstance();
+
+    RemoteControlService(Sender sender, Resolver resolver, Options options);
+
+    RemoteControlService(const RemoteControlService&) = delete;
+    RemoteControlService& operator=(const RemoteControlService&) = delete;
+
+    /**
+     * Queue a key press; `done` runs once it is answered or rejected
+     * (from the sender's thread, or inline if rejected)
+     *
+     * @param key Entry of the key table (from key() or parse())
+     */
+    void press(const std::string& device_id, const LightningStep& key, AckCallback done);
+
+    /**
+     * Cached device, resolved on first use
+     */
+    std::optional<Device> device(const std::string& device_id);
+
+    /**
+     * Drop the cached device (it changed or was deleted)
+     */
+    void forget(const std::string& device_id);
+
+    /**
+     * Decode a text or binary control message
+     *
+     * @return Message, or nullopt with `error` set
+     */
+    static std::optional<Message> parse(std::string_view message, bool binary, std::string& error);
+
+    /**
+     * Key table: names are the Lightning actions, codes their indexes
+     */
+    static const std::vector<std::string>& keyNames();
+    static const LightningStep* key(std::string_view name);
+
+    /**
+     * Counters: devices, queued, sent, rejected
+     */
+    Json::Value stats() const;
+
+    const Options& options() const { return options_; }
+
+private:
+    struct Press {
+        const LightningStep* key;
+        AckCallback done;
+        Clock::time_point queued;
+    };
+
+    struct Lane {
+        std::optional<Device> device;
+        std::deque<Press> waiting;
+        bool in_flight = false;
+    };
+
+    void send(const std::string& device_id, const Device& device, Press press);
+    void finish(const std::string& device_id);
+
+    Sender sender_;
+    Resolver resolver_;
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Lane> lanes_;
+
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> rejected_{0};
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "models/Device.h"
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * ServiceStatus - What /health and /status report, kept up to date as it changes
+ *
+ * Orchestrators and Home Assistant poll these endpoints every few seconds,
+ * so answering them must not query the database or take its lock:
+ *
+ * - Connection flags are atomics: MQTTClient sets the MQTT flag on
+ *   connect/disconnect, and main refreshes the database flag from a timer.
+ * - Device totals (total/paired/online) are counters that DeviceRepository
+ *   adjusts on every write; the device list is read once at startup.
+ * - Response bodies are rendered once and cached. A change to a flag or a
+ *   device counter bumps a version and the next request renders again;
+ *   /status also re-renders when its subsystem counters (the details
+ *   provider) are older than `details_max_age`.
+ *
+ * A cached request is an atomic load, a version compare and a shared_ptr
+ * copy.
+ *
+ * PROBES:
+ * =======
+ * Live   - The process answers HTTP (always 200)
+ * Ready  - Startup finished and the database is connected (200, else 503)
+ * Health - Database and MQTT connected (200, else 503; the original /health)
+ *
+ * CONFIGURATION:
+ * ==============
+ * STATUS_CACHE_MS - Longest time /status serves the same subsystem counters (default: 1000)
+ */
+class ServiceStatus {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Probe { Live, Ready, Health };
+
+    struct DeviceCounts {
+        uint64_t total = 0;
+        uint64_t paired = 0;
+        uint64_t online = 0;
+    };
+
+    /**
+     * Fixed facts shown in the bodies
+     */
+    struct Info {
+        std::string service = "HMS FireTV";
+        std::string version;
+        std::string db_type;
+        std::string mqtt_broker;
+    };
+
+    /**
+     * Adds the subsystem sections (deadlines, key_repeat, slo, ...) to /status
+     */
+    using DetailsProvider = std::function<void(Json::Value& status)>;
+
+    using Body = std::shared_ptr<const std::string>;
+
+    /**
+     * Get singleton instance
+     */
+    static ServiceStatus& getInstance();
+
+    explicit ServiceStatus(std::chrono::milliseconds details_max_age);
+
+    ServiceStatus(const ServiceStatus&) = delete;
+    ServiceStatus& operator=(const ServiceStatus&) = delete;
+
+    void setInfo(Info info);
+    void setDetailsProvider(DetailsProvider provider);
+
+    // ---- Flags ----
+
+    void setReady(bool ready);
+    void setDatabaseConnected(bool connected);
+    void setMqttConnected(bool connected);
+
+    bool ready() const { return ready_.load(std::memory_order_relaxed); }
+    bool databaseConnected() const { return database_.load(std::memory_order_relaxed); }
+    bool mqttConnected() const { return mqtt_.load(std::memory_order_relaxed); }
+
+    /**
+     * Whether a probe passes (decides 200 or 503)
+     */
+    bool passes(Probe probe) const;
+
+    // ---- Devices ----
+
+    /**
+     * Replace all device state (startup, or after a bulk change)
+     */
+    void resetDevices(const std::vector<Device>& devices);
+
+    /**
+     * Add or update one device; unset fields keep their value
+     */
+    void deviceChanged(const std::string& device_id, std::optional<bool> paired, std::optional<bool> online);
+
+    void deviceRemoved(const std::string& device_id);
+
+    DeviceCounts devices() const;
+
+    // ---- Bodies ----
+
+    /**
+     * Compact JSON for /status
+     */
+    Body statusBody();
+
+    /**
+     * Compact JSON for a probe
+     */
+    Body probeBody(Probe probe);
+
+    /**
+     * Bumped on every flag or device counter change
+     */
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    static constexpr double DB_CHECK_SECONDS = 5.0;   // How often main refreshes the database flag
+
+private:
+    struct Cached {
+        uint64_t version = 0;
+        Clock::time_point built;
+        Body body;
+    };
+
+    struct DeviceState {
+        bool paired = false;
+        bool online = false;
+    };
+
+    void changed() { version_.fetch_add(1, std::memory_order_acq_rel); }
+    Json::Value baseJson() const;
+    static Body render(const Json::Value& json);
+
+    std::chrono::milliseconds details_max_age_;
+
+    std::atomic<bool> ready_{false};
+    std::atomic<bool> database_{false};
+    std::atomic<bool> mqtt_{false};
+    std::atomic<uint64_t> version_{1};
+
+    // Written under devices_mutex_, read lock-free
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> paired_{0};
+    std::atomic<uint64_t> online_{0};
+
+    std::mutex devices_mutex_;
+    std::unordered_map<std::string, DeviceState> devices_;
+
+    // Read with std::atomic_load; rebuilt under build_mutex_
+    std::mutex build_mutex_;
+    Info info_;
+    DetailsProvider details_;
+    std::shared_ptr<const Cached> status_cache_;
+    std::shared_ptr<const Cached> probe_cache_[3];
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace hms_firetv {
+
+/**
+ * TextEdit - How a new field value differs from the last one sent
+ */
+struct TextEdit {
+    enum class Kind {
+        Unchanged,
+        Append,     // Characters typed at the end
+        Backspace,  // Characters removed from the end
+        Replace     // Anything else (paste, edit in the middle, new field)
+    };
+
+    Kind kind = Kind::Replace;
+    size_t count = 0;  // Characters appended / removed (0 for Replace/Unchanged)
+
+    static TextEdit diff(const std::string& from, const std::string& to);
+    static const char* kindName(Kind kind);
+};
+
+/**
+ * TextInputService - Streaming (search-as-you-type) keyboard input
+ *
+ * Each keystroke from the HA text entity carries the whole field, and
+ * sending every one as its own request floods the TV. This keeps a small
+ * input session per device and:
+ *
+ * - debounces: the first keystroke opens a window of `debounce` ms, later
+ *   ones only replace the pending text, and the window sends the latest
+ *   text once — at most one request per window per device
+ * - never has more than one request in flight per device; text typed
+ *   meanwhile is sent when it completes, so the TV always ends on the
+ *   latest value
+ * - skips sends whose text equals what the TV already has
+ * - diffs each send against the last one (append/backspace/replace) for
+ *   logging and stats
+ *
+ * The Lightning keyboard endpoint only accepts the complete field value
+ * (it replaces, it cannot append or delete), so every send still carries
+ * the full text; the diff cannot shrink the payload with this protocol.
+ *
+ * Sends go through MacroRunner, i.e. the device's LightningClientPool queue
+ * and its kept-alive pooled connection. Sessions idle for `session_idle`
+ * are forgotten, so a field cleared on the TV is retyped in full.
+ *
+ * CONFIGURATION:
+ * ==============
+ * TEXT_INPUT_DEBOUNCE_MS - Debounce window (default: 150). MQTT send_text
+ *                          streams when > 0; 0 sends every message at once
+ */
+class TextInputService {
+public:
+    using SendCallback = std::function<void(bool success, const std::string& error)>;
+
+    /**
+     * Sends the full field value to a device and calls back once done
+     */
+    using Sender = std::function<void(const std::string& device_id,
+                                      const std::string& text,
+                                      SendCallback done)>;
+
+    struct Options {
+        std::chrono::milliseconds debounce{150};
+        std::chrono::milliseconds session_idle{30000};
+    };
+
+    /**
+     * Outcome of one submit()
+     */
+    struct Submission {
+        TextEdit edit;          // Against the previous submission
+        bool coalesced = false; // Joined a send that was already pending
+    };
+
+    static TextInputService& getInstance();
+
+    TextInputService(Sender sender, Options options);
+    ~TextInputService();
+
+    TextInputService(const TextInputService&) = delete;
+    TextInputService& operator=(const TextInputService&) = delete;
+
+    /**
+     * Queue the field's current value for a device (non-blocking)
+     */
+    Submission submit(const std::string& device_id, const std::string& text);
+
+    /**
+     * Forget a device's session (next text is sent in full, unconditionally)
+     */
+    void reset(const std::string& device_id);
+
+    /**
+     * Counters: submitted, sent, coalesced, skipped, failed
+     */
+    Json::Value stats() const;
+
+    std::chrono::milliseconds debounce() const { return options_.debounce; }
+
+    /**
+     * Stop the flush thread; pending text is dropped
+     */
+    void stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Session {
+        std::optional<std::string> sent;     // Last value the TV acknowledged
+        std::string submitted;               // Latest value received
+        bool dirty = false;                  // submitted not yet sent
+        bool scheduled = false;              // Flush timer armed
+        bool in_flight = false;              // Request outstanding
+        Clock::time_point last_activity;
+    };
+
+    // Require mutex_ held
+    void scheduleFlush(const std::string& device_id, Session& session, Clock::time_point at);
+
+    void flush(const std::string& device_id);
+    void onSent(const std::string& device_id, const std::string& text,
+                bool success, const std::string& error);
+    void flushLoop();
+
+    Sender sender_;
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<std::string, Session> sessions_;
+    std::multimap<Clock::time_point, std::string> due_;
+    bool stopped_ = false;
+    std::thread flusher_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::atomic<uint64_t> failed_{0};
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <json/json.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace hms_firetv {
+
+/**
+ * AllocTracker - Heap allocation accounting per request type
+ *
+ * Built with -DENABLE_ALLOC_TRACKING=ON (defines HMS_ALLOC_TRACKING), the
+ * global operator new/delete are replaced with counting versions that bump
+ * per-thread counters. Ingress points (MQTT message, REST handler) open an
+ * AllocScope, and when it closes the allocations made on that thread while
+ * it was open are added to its request type ("mqtt.navigate",
+ * "rest.media", ...). Work that continues on another thread (async
+ * Lightning callbacks, the log writer) is not attributed to the request,
+ * and neither is memory C libraries take with malloc (libcurl, SQLite).
+ *
+ * Without the option, AllocScope compiles to nothing and the endpoint
+ * reports `"enabled": false`.
+ *
+ * Served at GET /api/debug/allocations (?reset=1 clears the counters),
+ * together with glibc heap statistics (which are always available).
+ *
+ * USAGE:
+ * ======
+ * ```cpp
+ * AllocScope alloc_scope("mqtt");
+ * ...
+ * alloc_scope.setType("mqtt", command);   // Attribute to "mqtt.<command>"
+ * ```
+ */
+class AllocTracker {
+public:
+    struct Counts {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t frees = 0;
+    };
+
+    /**
+     * Get singleton instance
+     */
+    static AllocTracker& getInstance();
+
+    /**
+     * True if built with HMS_ALLOC_TRACKING
+     */
+    static constexpr bool enabled() {
+#ifdef HMS_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Allocations made by this thread since it started (zero when disabled)
+     */
+    static Counts threadCounts();
+
+    /**
+     * Allocations made by all threads since startup (zero when disabled)
+     */
+    static Counts processCounts();
+
+    /**
+     * Add one finished request of `type`
+     */
+    void record(std::string_view type, const Counts& counts);
+
+    /**
+     * {enabled, process: {...}, types: {type: {requests, allocations, bytes,
+     *  allocations_per_request, bytes_per_request, max_allocations}}, heap: {...}}
+     */
+    Json::Value toJson() const;
+
+    void reset();
+
+    static constexpr size_t MAX_TYPES = 128;   // Further types are folded into "other"
+
+private:
+    struct TypeStats {
+        uint64_t requests = 0;
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t max_allocations = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, TypeStats, std::less<>> types_;
+};
+
+/**
+ * Attributes this thread's allocations in the enclosing scope to a request type
+ *
+ * Scopes should not nest: an outer scope also counts everything its inner
+ * scopes counted.
+ */
+class AllocScope {
+public:
+#ifdef HMS_ALLOC_TRACKING
+    explicit AllocScope(std::string_view type);
+    ~AllocScope();
+
+    /**
+     * Rename the request type once it is known (copied; "source.detail")
+     */
+    void setType(std::string_view source, std::string_view detail = {});
+
+    /**
+     * Allocations so far in this scope
+     */
+    AllocTracker::Counts counts() const;
+
+private:
+    AllocTracker::Counts start_;
+    char type_[48];
+#else
+    explicit AllocScope(std::string_view) {}
+    void setType(std::string_view, std::string_view = {}) {}
+    AllocTracker::Counts counts() const { return {}; }
+#endif
+
+public:
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+};
+
+} // namespace hms_firetv
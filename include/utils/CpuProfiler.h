@@ -0,0 +1,101 @@
+#pragma once
+
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace hms_firetv {
+
+/**
+ * CpuProfiler - On-demand in-process sampling profiler
+ *
+ * For hosts where perf cannot be attached (containers without
+ * CAP_PERFMON, small ARM boards). While a profile runs, ITIMER_PROF raises
+ * SIGPROF every 1/hz seconds of process CPU time, on whichever thread is
+ * using the CPU. The handler stores that thread's backtrace in a
+ * preallocated buffer (no locks, no allocation). Afterwards the stacks are
+ * symbolized with dladdr and aggregated into folded stacks
+ * ("thread;outer;...;inner count"), the input format of flamegraph.pl,
+ * speedscope and inferno.
+ *
+ * Idle threads use no CPU and so get no samples: this shows where CPU time
+ * goes, not where requests wait (use the command traces for that).
+ *
+ * Compiled in always, inert until a profile is requested, and refused
+ * unless PROFILER_ENABLED is set. The SIGPROF handler is installed on the
+ * first profile and stays installed. One profile runs at a time.
+ *
+ * CONFIGURATION:
+ * ==============
+ * PROFILER_ENABLED      - Allow GET /api/debug/profile (default: false)
+ * PROFILER_MAX_SECONDS  - Longest profile accepted (default: 60)
+ */
+class CpuProfiler {
+public:
+    struct Options {
+        bool enabled = false;
+        std::chrono::seconds max_duration{60};
+        int max_hz = 1000;
+        size_t max_samples = 50000;    // Buffer cap (~13 MB at MAX_DEPTH frames each)
+    };
+
+    struct Profile {
+        std::chrono::milliseconds duration{0};
+        int hz = 0;
+        uint64_t samples = 0;
+        uint64_t dropped = 0;                    // Buffer full
+        std::map<std::string, uint64_t> stacks;  // Folded stack -> samples
+
+        /**
+         * One "frame;frame;... count" line per stack, root first
+         */
+        std::string folded() const;
+
+        /**
+         * {duration_ms, hz, samples, dropped, stacks: [{stack, samples}], top: [...]}
+         */
+        Json::Value toJson(size_t top_functions = 25) const;
+    };
+
+    using Done = std::function<void(Profile)>;
+
+    static constexpr int MAX_DEPTH = 32;
+    static constexpr int DEFAULT_HZ = 99;    // Off the round numbers timers and jobs tick at
+
+    /**
+     * Get singleton instance (configured from the environment)
+     */
+    static CpuProfiler& getInstance();
+
+    explicit CpuProfiler(Options options);
+    ~CpuProfiler();
+
+    CpuProfiler(const CpuProfiler&) = delete;
+    CpuProfiler& operator=(const CpuProfiler&) = delete;
+
+    bool enabled() const { return options_.enabled; }
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    const Options& options() const { return options_; }
+
+    /**
+     * Sample for `duration` at `hz`, then call `done` from the profiler's thread
+     *
+     * @param error Set when refused: disabled, already running, or out of range
+     * @return false if refused (`done` is not called)
+     */
+    bool start(std::chrono::milliseconds duration, int hz, Done done, std::string& error);
+
+private:
+    Options options_;
+    std::mutex mutex_;                  // Serializes start() and the worker handoff
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+};
+
+} // namespace hms_firetv
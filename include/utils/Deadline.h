@@ -0,0 +1,147 @@
+#pragma once
+
+#include "utils/ConfigManager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace hms_firetv {
+
+/**
+ * Deadline - Absolute point in time by which a command must be done
+ *
+ * Set once when a command enters the service (REST header, MQTT payload or
+ * the configured default) and passed down to every stage that can wait:
+ * the per-device lease queue, wake-up polling and the Lightning request.
+ * Each stage caps its own timeout to the time left and gives up as soon as
+ * the deadline has passed, so a caller that already gave up causes no more
+ * work on the TV.
+ *
+ * A default-constructed Deadline never expires.
+ *
+ * USAGE:
+ * ======
+ * ```cpp
+ * auto deadline = Deadline::fromBudget(req->getHeader(Deadline::HEADER));
+ * if (deadline.expired()) { ... cancel ... }
+ * long timeout_ms = deadline.capMs(5000);  // min(5s, time left)
+ * ```
+ *
+ * CONFIGURATION:
+ * ==============
+ * COMMAND_DEADLINE_MS - Budget for commands that do not set one (default: 15000)
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Where a command was cancelled, for the cancellation counters
+     */
+    enum class Stage {
+        Queue,      // Waiting for the device's client
+        Wake,       // Waking the TV / polling for it to come up
+        Transport   // Before or during the Lightning request
+    };
+
+    Deadline() : at_(Clock::time_point::max()) {}
+
+    static Deadline after(std::chrono::milliseconds budget) {
+        return Deadline(Clock::now() + budget);
+    }
+
+    /**
+     * Deadline from a relative budget in milliseconds (e.g. X-Request-Deadline-Ms)
+     *
+     * Empty, malformed or non-positive values fall back to the default budget;
+     * budgets are capped at MAX_BUDGET_MS.
+     */
+    static Deadline fromBudget(const std::string& budget_ms) {
+        char* end = nullptr;
+        long long value = budget_ms.empty() ? 0 : std::strtoll(budget_ms.c_str(), &end, 10);
+        if (value <= 0 || (end && *end != '\0')) {
+            return after(defaultBudget());
+        }
+        return after(std::chrono::milliseconds(std::min<long long>(value, MAX_BUDGET_MS)));
+    }
+
+    static Deadline fromBudget(int64_t budget_ms) {
+        if (budget_ms <= 0) {
+            return after(defaultBudget());
+        }
+        return after(std::chrono::milliseconds(std::min<int64_t>(budget_ms, MAX_BUDGET_MS)));
+    }
+
+    static std::chrono::milliseconds defaultBudget() {
+        static const int budget_ms = std::max(1,
+            ConfigManager::getEnvInt("COMMAND_DEADLINE_MS", DEFAULT_BUDGET_MS));
+        return std::chrono::milliseconds(budget_ms);
+    }
+
+    bool isSet() const { return at_ != Clock::time_point::max(); }
+    bool expired() const { return isSet() && Clock::now() >= at_; }
+    Clock::time_point at() const { return at_; }
+
+    /**
+     * Time left (0 once expired; very large if unset)
+     */
+    std::chrono::milliseconds remaining() const {
+        if (!isSet()) {
+            return std::chrono::milliseconds(static_cast<int64_t>(MAX_BUDGET_MS) * 1000);
+        }
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(at_ - Clock::now());
+        return std::max(left, std::chrono::milliseconds(0));
+    }
+
+    /**
+     * Cap a stage timeout to the time left (never below 1ms)
+     */
+    long capMs(long timeout_ms) const {
+        return std::max(1L, std::min(timeout_ms, static_cast<long>(remaining().count())));
+    }
+
+    double capSeconds(double timeout_seconds) const {
+        return capMs(static_cast<long>(timeout_seconds * 1000)) / 1000.0;
+    }
+
+    /**
+     * Record a command given up on because its deadline passed
+     */
+    static void recordCancelled(Stage stage) {
+        counters()[static_cast<size_t>(stage)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static uint64_t cancelledCount(Stage stage) {
+        return counters()[static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+    }
+
+    static const char* stageName(Stage stage) {
+        switch (stage) {
+            case Stage::Queue:     return "queue";
+            case Stage::Wake:      return "wake";
+            case Stage::Transport: return "transport";
+        }
+        return "unknown";
+    }
+
+    static constexpr const char* HEADER = "X-Request-Deadline-Ms";
+    static constexpr const char* EXCEEDED = "Deadline exceeded";
+    static constexpr int DEFAULT_BUDGET_MS = 15000;
+    static constexpr int MAX_BUDGET_MS = 120000;
+    static constexpr size_t STAGE_COUNT = 3;
+
+private:
+    explicit Deadline(Clock::time_point at) : at_(at) {}
+
+    static std::atomic<uint64_t>* counters() {
+        static std::atomic<uint64_t> cancelled[STAGE_COUNT] = {};
+        return cancelled;
+    }
+
+    Clock::time_point at_;
+};
+
+} // namespace hms_firetv
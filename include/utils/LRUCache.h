@@ -137,19 +137,15 @@ public:
         size_t removed = 0;
         auto now = Clock::now();
 
-        // Iterate from LRU (back) to MRU (front)
-        auto it = lru_list_.rbegin();
-        while (it != lru_list_.rend()) {
-            const K& key = *it;
-            auto cache_it = cache_map_.find(key);
-
-            if (cache_it != cache_map_.end() && isExpired(cache_it->second.expiry_time)) {
-                // Get forward iterator from reverse iterator
-                auto forward_it = std::next(it).base();
-                evictNoLock(key);
+        // Erase in place; list::erase returns the next valid iterator
+        auto it = lru_list_.begin();
+        while (it != lru_list_.end()) {
+            auto cache_it = cache_map_.find(*it);
+
+            if (cache_it != cache_map_.end() && now >= cache_it->second.expiry_time) {
+                cache_map_.erase(cache_it);
+                it = lru_list_.erase(it);
                 removed++;
-                // Continue from the same position (which is now the next element)
-                it = std::reverse_iterator<typename std::list<K>::iterator>(forward_it);
             } else {
                 ++it;
             }
@@ -185,14 +181,6 @@ private:
         }
     }
 
-    void evictNoLock(const K& key) {
-        auto it = cache_map_.find(key);
-        if (it != cache_map_.end()) {
-            lru_list_.erase(it->second.list_it);
-            cache_map_.erase(it);
-        }
-    }
-
     size_t max_size_;
     std::chrono::seconds ttl_;
     mutable std::mutex mutex_;
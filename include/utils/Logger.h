@@ -0,0 +1,262 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace hms_firetv {
+
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5
+};
+
+/**
+ * Lines below this level are compiled out entirely (their arguments are
+ * never evaluated). Build with -DHMS_LOG_COMPILE_LEVEL=2 to drop debug and
+ * trace logging from a release binary.
+ */
+#ifndef HMS_LOG_COMPILE_LEVEL
+#define HMS_LOG_COMPILE_LEVEL 1
+#endif
+
+/**
+ * One formatted log entry as it sits in the ring buffer
+ *
+ * Fixed size, so queueing a line never allocates; longer messages are
+ * truncated (and marked with "...").
+ */
+struct LogRecord {
+    static constexpr size_t MESSAGE_SIZE = 400;
+    static constexpr size_t FIELDS_SIZE = 112;
+
+    LogLevel level = LogLevel::Info;
+    const char* component = "";      // String literal (see LOG_* macros)
+    int64_t time_us = 0;             // system_clock, microseconds since epoch
+    uint32_t thread = 0;
+    uint16_t message_len = 0;
+    uint16_t fields_len = 0;
+    bool truncated = false;
+    char message[MESSAGE_SIZE];
+    char fields[FIELDS_SIZE];        // "key\x1fvalue\x1e" pairs
+};
+
+/**
+ * Logger - Leveled, asynchronous, structured logging
+ *
+ * Replaces std::cout/std::cerr with std::endl on hot paths, which flushed
+ * (one write syscall, serialized on the stream lock) per line.
+ *
+ * Features:
+ * - Producers format into a stack buffer and push it into a bounded
+ *   lock-free MPSC ring (no locks, no allocation, no syscall)
+ * - One writer thread drains the ring in batches and writes each batch
+ *   with a single write/flush per stream (stdout; stderr for warn/error)
+ * - Runtime level from LOG_LEVEL (one relaxed load when disabled);
+ *   compile-time floor from HMS_LOG_COMPILE_LEVEL
+ * - Structured fields (`.field("device", id)`) rendered as key=value, or
+ *   as JSON objects with LOG_FORMAT=json
+ * - When the ring is full, lines are dropped and counted rather than
+ *   blocking the caller; the writer reports how many were lost
+ * - Before start() and after stop(), lines are written synchronously, so
+ *   startup and shutdown output is never lost
+ *
+ * CONFIGURATION:
+ * ==============
+ * LOG_LEVEL   - trace, debug, info, warn, error or off (default: info)
+ * LOG_FORMAT  - text or json (default: text)
+ *
+ * USAGE:
+ * ======
+ * ```cpp
+ * LOG_INFO("MQTTClient") << "Published to " << topic;
+ * LOG_DEBUG("CommandHandler").field("device", device_id) << "Navigation succeeded";
+ * ```
+ */
+class Logger {
+public:
+    enum class Format { Text, Json };
+
+    /**
+     * Receives a batch of formatted lines for one stream (tests capture these)
+     */
+    using Sink = std::function<void(bool is_error, const std::string& batch)>;
+
+    struct Options {
+        size_t capacity = 4096;                          // Ring slots (rounded up to a power of two)
+        std::chrono::milliseconds flush_interval{50};    // Max time a line waits when idle
+    };
+
+    /**
+     * Get singleton instance (writes to stdout/stderr)
+     */
+    static Logger& getInstance();
+
+    Logger(Options options, Sink sink);
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * Start the writer thread (idempotent)
+     */
+    void start();
+
+    /**
+     * Drain everything queued and stop the writer; later lines are written synchronously
+     */
+    void stop();
+
+    /**
+     * Wait until every line queued so far has been written
+     */
+    void flush();
+
+    void setLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    void setFormat(Format format) { format_.store(format, std::memory_order_relaxed); }
+
+    /**
+     * Queue a record (or write it now if the writer is not running)
+     */
+    void submit(const LogRecord& record);
+
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t writtenCount() const { return written_.load(std::memory_order_relaxed); }
+
+    /**
+     * Parse "debug", "WARN", "warning", ... (unknown names give `fallback`)
+     */
+    static LogLevel parseLevel(std::string_view name, LogLevel fallback = LogLevel::Info);
+    static const char* levelName(LogLevel level);
+
+    /**
+     * Apply LOG_LEVEL and LOG_FORMAT
+     */
+    void configureFromEnv();
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    bool tryPush(const LogRecord& record);
+    bool tryPop(LogRecord& record);
+    void writerLoop();
+    void format(const LogRecord& record, std::string& out) const;
+    void writeNow(const LogRecord& record);
+
+    Sink sink_;
+    Options options_;
+    std::atomic<int> level_{static_cast<int>(LogLevel::Info)};
+    std::atomic<Format> format_{Format::Text};
+
+    // Vyukov bounded queue: producers CAS enqueue_pos_, the writer owns dequeue_pos_
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> writer_idle_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> queued_{0};
+    std::atomic<uint64_t> processed_{0};
+
+    std::mutex mutex_;                 // Writer wake-up, flush() and synchronous writes
+    std::condition_variable wake_cv_;
+    std::condition_variable drained_cv_;
+    std::thread writer_;
+};
+
+/**
+ * Builds one record on the stack; queued when it goes out of scope
+ */
+class LogLine {
+public:
+    LogLine(Logger& logger, LogLevel level, const char* component);
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    /**
+     * Attach a structured field
+     */
+    LogLine& field(std::string_view key, std::string_view value);
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    LogLine& field(std::string_view key, T value) {
+        return field(key, std::string_view(std::to_string(value)));
+    }
+
+    template <typename T>
+    LogLine& operator<<(const T& value) {
+        stream_ << value;
+        return *this;
+    }
+
+    // Accept std::endl and friends from converted call sites (they do nothing here)
+    LogLine& operator<<(std::ostream& (*)(std::ostream&)) { return *this; }
+
+private:
+    // Writes into the record's message buffer and stops at its end
+    class FixedBuffer : public std::streambuf {
+    public:
+        FixedBuffer(char* begin, size_t size) { setp(begin, begin + size); }
+        size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+        bool overflowed() const { return overflowed_; }
+
+    protected:
+        int_type overflow(int_type) override {
+            overflowed_ = true;
+            return traits_type::eof();
+        }
+
+    private:
+        bool overflowed_ = false;
+    };
+
+    Logger& logger_;
+    LogRecord record_;
+    FixedBuffer buffer_;
+    std::ostream stream_;
+};
+
+} // namespace hms_firetv
+
+// The `"" component` concatenation only accepts string literals, whose
+// pointers stay valid until the writer thread formats the line
+#define HMS_LOG_AT(level, component)                                                        \
+    if (static_cast<int>(level) < HMS_LOG_COMPILE_LEVEL ||                                  \
+        !::hms_firetv::Logger::getInstance().enabled(level)) {                              \
+    } else                                                                                  \
+        ::hms_firetv::LogLine(::hms_firetv::Logger::getInstance(), level, "" component)
+
+#define LOG_TRACE(component) HMS_LOG_AT(::hms_firetv::LogLevel::Trace, component)
+#define LOG_DEBUG(component) HMS_LOG_AT(::hms_firetv::LogLevel::Debug, component)
+#define LOG_INFO(component)  HMS_LOG_AT(::hms_firetv::LogLevel::Info, component)
+#define LOG_WARN(component)  HMS_LOG_AT(::hms_firetv::LogLevel::Warn, component)
+#define LOG_ERROR(component) HMS_LOG_AT(::hms_firetv::LogLevel::Error, component)
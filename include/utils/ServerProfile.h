@@ -0,0 +1,63 @@
+#pragma once
+
+#include <json/json.h>
+#include <cstddef>
+#include <string_view>
+
+namespace hms_firetv {
+
+/**
+ * ServerProfile - HTTP server settings, read once from the environment
+ *
+ * main applies it to Drogon before run(); see docs/SERVER_TUNING.md for
+ * what each setting trades off and how to measure a change.
+ *
+ * - One IO thread per core by default.
+ * - SO_REUSEPORT: every IO thread gets its own listening socket and the
+ *   kernel spreads new connections across them, instead of one acceptor
+ *   handing connections out.
+ * - TCP_NODELAY on accepted sockets: responses are a single small write,
+ *   so Nagle only adds delay.
+ * - Body caps. The global cap is the most Drogon reads for any request
+ *   and the only one that bounds memory: Drogon has no per-route limit.
+ *   Command routes take a few hundred bytes and get a smaller cap, but it
+ *   is checked after the body has been read, so it only rejects them.
+ *
+ * CONFIGURATION:
+ * ==============
+ * THREAD_NUM                 - IO threads, 0 = one per core (default: 0)
+ * HTTP_REUSE_PORT            - One listener per IO thread (default: true)
+ * HTTP_TCP_NODELAY           - Disable Nagle on accepted sockets (default: true)
+ * IDLE_CONNECTION_TIMEOUT    - Seconds before an idle keep-alive connection is closed (default: 60)
+ * HTTP_KEEPALIVE_REQUESTS    - Requests per connection before closing it, 0 = unlimited (default: 0)
+ * HTTP_PIPELINING_REQUESTS   - Pipelined requests queued per connection, 0 = unlimited (default: 16)
+ * HTTP_MAX_CONNECTIONS       - Concurrent connections (default: 10000)
+ * HTTP_MAX_CONNECTIONS_PER_IP - Per client address, 0 = unlimited (default: 0)
+ * HTTP_MAX_BODY_KB           - Any request body; what Drogon buffers at most (default: 64)
+ * HTTP_COMMAND_BODY_KB       - Rejects larger command, text, pairing and broadcast bodies (default: 8)
+ * HTTP_BATCH_BODY_KB         - Rejects larger batch and macro bodies (default: 64)
+ */
+struct ServerProfile {
+    size_t threads = 1;
+    bool reuse_port = true;
+    bool tcp_nodelay = true;
+    size_t idle_timeout_seconds = 60;
+    size_t keepalive_requests = 0;
+    size_t pipelining_requests = 16;
+    size_t max_connections = 10000;
+    size_t max_connections_per_ip = 0;
+    size_t max_body_bytes = 64 * 1024;
+    size_t command_body_bytes = 8 * 1024;
+    size_t batch_body_bytes = 64 * 1024;
+
+    static ServerProfile fromEnv();
+
+    /**
+     * Largest request body accepted for a path
+     */
+    size_t bodyLimitFor(std::string_view path) const;
+
+    Json::Value toJson() const;
+};
+
+} // namespace hms_firetv
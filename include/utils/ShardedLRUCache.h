@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * Sharded, low-contention approximate-LRU cache with TTL support
+ *
+ * Drop-in alternative to LRUCache for read-heavy paths shared by many threads.
+ *
+ * Features:
+ * - Keys are spread over N shards by hash; each shard has its own lock
+ * - CLOCK (second-chance) eviction: get() only sets a reference bit, so the
+ *   read path takes a shared lock and never reorders a list
+ * - Fixed slot arrays and an open-addressed index per shard, allocated once
+ *   at construction (no per-entry node allocation)
+ * - Time-to-live (TTL) for entries, enforced on read and by an optional
+ *   owned background sweeper
+ */
+template<typename K, typename V, typename Hash = std::hash<K>>
+class ShardedLRUCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = std::chrono::time_point<Clock>;
+
+    /**
+     * Constructor
+     * @param max_size Maximum number of entries across all shards (default: 100)
+     * @param ttl_seconds Time-to-live in seconds (default: 3600 = 1 hour)
+     * @param shard_count Number of shards (default: 8, capped at max_size)
+     */
+    explicit ShardedLRUCache(size_t max_size = 100, int ttl_seconds = 3600, size_t shard_count = 8)
+        : ttl_(std::chrono::seconds(ttl_seconds)) {
+        if (max_size == 0) max_size = 1;
+        if (shard_count == 0) shard_count = 1;
+        if (shard_count > max_size) shard_count = max_size;
+
+        shard_count_ = shard_count;
+        size_t per_shard = (max_size + shard_count - 1) / shard_count;
+        shards_.reset(new Shard[shard_count_]);
+        for (size_t i = 0; i < shard_count_; ++i) {
+            shards_[i].init(per_shard);
+        }
+    }
+
+    /**
+     * Destructor - stops the sweeper thread if running
+     */
+    ~ShardedLRUCache() {
+        stopSweeper();
+    }
+
+    // Non-copyable, non-movable (owns a sweeper thread and per-shard locks)
+    ShardedLRUCache(const ShardedLRUCache&) = delete;
+    ShardedLRUCache& operator=(const ShardedLRUCache&) = delete;
+
+    /**
+     * Get value from cache (shared lock only)
+     * @param key The key to look up
+     * @return Optional value if found and not expired
+     */
+    std::optional<V> get(const K& key) const {
+        size_t h = hasher_(key);
+        const Shard& shard = shardFor(h);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+        int32_t slot = shard.find(key, h);
+        if (slot < 0) {
+            return std::nullopt;
+        }
+
+        const Slot& s = shard.slots[slot];
+        if (isExpired(s.expiry_time)) {
+            return std::nullopt;  // Reclaimed by put() or the sweeper
+        }
+
+        // Second chance: avoid dirtying the cache line when the bit is already set
+        if (!s.referenced.load(std::memory_order_relaxed)) {
+            s.referenced.store(true, std::memory_order_relaxed);
+        }
+        return s.value;
+    }
+
+    /**
+     * Put value into cache
+     * @param key The key
+     * @param value The value to store
+     */
+    void put(const K& key, const V& value) {
+        size_t h = hasher_(key);
+        Shard& shard = shardFor(h);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        int32_t existing = shard.find(key, h);
+        if (existing >= 0) {
+            Slot& s = shard.slots[existing];
+            s.value = value;
+            s.expiry_time = Clock::now() + ttl_;
+            s.referenced.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        uint32_t slot = shard.acquireSlot();
+        Slot& s = shard.slots[slot];
+        s.key = key;
+        s.value = value;
+        s.hash = h;
+        s.expiry_time = Clock::now() + ttl_;
+        s.occupied = true;
+        s.referenced.store(false, std::memory_order_relaxed);
+        shard.indexInsert(slot);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Remove entry from cache
+     * @param key The key to remove
+     */
+    void remove(const K& key) {
+        size_t h = hasher_(key);
+        Shard& shard = shardFor(h);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        int32_t slot = shard.find(key, h);
+        if (slot >= 0) {
+            shard.release(static_cast<uint32_t>(slot));
+        }
+    }
+
+    /**
+     * Clear all entries
+     */
+    void clear() {
+        for (size_t i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.reset();
+        }
+    }
+
+    /**
+     * Get current size (may include expired entries not yet swept)
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            total += shards_[i].count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * Total capacity across all shards
+     */
+    size_t capacity() const {
+        return shard_count_ * shards_[0].slots.size();
+    }
+
+    /**
+     * Number of shards
+     */
+    size_t shardCount() const {
+        return shard_count_;
+    }
+
+    /**
+     * Check if key exists and is not expired (does not touch the reference bit)
+     */
+    bool contains(const K& key) const {
+        size_t h = hasher_(key);
+        const Shard& shard = shardFor(h);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+        int32_t slot = shard.find(key, h);
+        return slot >= 0 && !isExpired(shard.slots[slot].expiry_time);
+    }
+
+    /**
+     * Visit every live entry: fn(const K&, const V&)
+     * Runs under each shard's shared lock, so fn must not call back into the cache
+     */
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i = 0; i < shard_count_; ++i) {
+            const Shard& shard = shards_[i];
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const Slot& s : shard.slots) {
+                if (s.occupied && !isExpired(s.expiry_time)) {
+                    fn(s.key, s.value);
+                }
+            }
+        }
+    }
+
+    /**
+     * Clean up expired entries in every shard
+     * Called by the sweeper thread; safe to call manually as well
+     */
+    size_t cleanupExpired() {
+        size_t removed = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto now = Clock::now();
+            for (uint32_t slot = 0; slot < shard.slots.size(); ++slot) {
+                Slot& s = shard.slots[slot];
+                if (s.occupied && now >= s.expiry_time) {
+                    shard.release(slot);
+                    removed++;
+                }
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * Start the owned expiry sweeper
+     * @param interval How often cleanupExpired() runs
+     */
+    void startSweeper(std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(sweeper_mutex_);
+        if (sweeper_running_) {
+            return;  // Already running
+        }
+
+        sweeper_running_ = true;
+        sweeper_thread_ = std::thread([this, interval]() {
+            std::unique_lock<std::mutex> lock(sweeper_mutex_);
+            while (sweeper_running_) {
+                if (sweeper_cv_.wait_for(lock, interval, [this] { return !sweeper_running_; })) {
+                    break;
+                }
+                lock.unlock();
+                cleanupExpired();
+                lock.lock();
+            }
+        });
+    }
+
+    /**
+     * Stop the expiry sweeper (no-op if not running)
+     */
+    void stopSweeper() {
+        {
+            std::lock_guard<std::mutex> lock(sweeper_mutex_);
+            if (!sweeper_running_) {
+                return;
+            }
+            sweeper_running_ = false;
+        }
+        sweeper_cv_.notify_one();
+
+        if (sweeper_thread_.joinable()) {
+            sweeper_thread_.join();
+        }
+    }
+
+private:
+    struct Slot {
+        K key{};
+        V value{};
+        size_t hash = 0;
+        TimePoint expiry_time{};
+        bool occupied = false;
+        mutable std::atomic<bool> referenced{false};
+    };
+
+    // Padded so that neighbouring shard locks never share a cache line
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::vector<Slot> slots;           // Fixed capacity, allocated once
+        std::vector<uint32_t> index;       // Open-addressed: slot + 1, 0 = empty
+        std::vector<uint32_t> free_slots;  // Stack of unoccupied slot numbers
+        size_t index_mask = 0;
+        size_t clock_hand = 0;
+        std::atomic<size_t> count{0};
+
+        void init(size_t capacity) {
+            slots = std::vector<Slot>(capacity);
+            size_t index_size = 1;
+            while (index_size < capacity * 2) index_size <<= 1;
+            index.assign(index_size, 0);
+            index_mask = index_size - 1;
+            free_slots.reserve(capacity);
+            reset();
+        }
+
+        void reset() {
+            std::fill(index.begin(), index.end(), 0);
+            free_slots.clear();
+            for (size_t i = slots.size(); i > 0; --i) {
+                Slot& s = slots[i - 1];
+                s.occupied = false;
+                s.key = K{};
+                s.value = V{};
+                free_slots.push_back(static_cast<uint32_t>(i - 1));
+            }
+            clock_hand = 0;
+            count.store(0, std::memory_order_relaxed);
+        }
+
+        size_t home(size_t hash) const {
+            // Shard selection consumed the low bits; remix before probing
+            return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> 17) & index_mask;
+        }
+
+        int32_t find(const K& key, size_t hash) const {
+            for (size_t pos = home(hash);; pos = (pos + 1) & index_mask) {
+                uint32_t entry = index[pos];
+                if (entry == 0) return -1;
+                const Slot& s = slots[entry - 1];
+                if (s.hash == hash && s.key == key) return static_cast<int32_t>(entry - 1);
+            }
+        }
+
+        size_t findIndexPos(uint32_t slot) const {
+            for (size_t pos = home(slots[slot].hash);; pos = (pos + 1) & index_mask) {
+                if (index[pos] == slot + 1) return pos;
+            }
+        }
+
+        void indexInsert(uint32_t slot) {
+            size_t pos = home(slots[slot].hash);
+            while (index[pos] != 0) pos = (pos + 1) & index_mask;
+            index[pos] = slot + 1;
+        }
+
+        // Backward-shift deletion keeps probe chains intact without tombstones
+        void indexErase(size_t pos) {
+            size_t hole = pos;
+            size_t next = pos;
+            for (;;) {
+                index[hole] = 0;
+                for (;;) {
+                    next = (next + 1) & index_mask;
+                    if (index[next] == 0) return;
+                    size_t ideal = home(slots[index[next] - 1].hash);
+                    bool movable = (hole <= next) ? (ideal <= hole || ideal > next)
+                                                  : (ideal <= hole && ideal > next);
+                    if (movable) {
+                        index[hole] = index[next];
+                        hole = next;
+                        break;
+                    }
+                }
+            }
+        }
+
+        void release(uint32_t slot) {
+            indexErase(findIndexPos(slot));
+            Slot& s = slots[slot];
+            s.occupied = false;
+            s.key = K{};
+            s.value = V{};  // Drop the payload now (e.g. shared_ptr resources)
+            free_slots.push_back(slot);
+            count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        uint32_t acquireSlot() {
+            if (free_slots.empty()) {
+                evictOne();
+            }
+            uint32_t slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+
+        // CLOCK sweep: expired entries go first, referenced entries get a second chance
+        void evictOne() {
+            auto now = Clock::now();
+            size_t n = slots.size();
+            for (size_t step = 0; step < 2 * n + 1; ++step) {
+                uint32_t slot = static_cast<uint32_t>(clock_hand);
+                clock_hand = (clock_hand + 1) % n;
+
+                Slot& s = slots[slot];
+                if (!s.occupied) continue;
+                if (now < s.expiry_time &&
+                    s.referenced.exchange(false, std::memory_order_relaxed)) {
+                    continue;
+                }
+                release(slot);
+                return;
+            }
+        }
+    };
+
+    const Shard& shardFor(size_t hash) const { return shards_[hash % shard_count_]; }
+    Shard& shardFor(size_t hash) { return shards_[hash % shard_count_]; }
+
+    static bool isExpired(const TimePoint& expiry_time) {
+        return Clock::now() >= expiry_time;
+    }
+
+    std::chrono::seconds ttl_;
+    size_t shard_count_ = 1;
+    std::unique_ptr<Shard[]> shards_;
+    Hash hasher_;
+
+    // Owned expiry sweeper
+    std::mutex sweeper_mutex_;
+    std::condition_variable sweeper_cv_;
+    bool sweeper_running_ = false;
+    std::thread sweeper_thread_;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * StaticAssets - The web UI bundle, loaded into memory once at startup
+ *
+ * Every file under the static directory is read once and, for text-like
+ * types, compressed once with gzip and (when built with brotli) brotli at
+ * the highest level. Requests then only pick a prebuilt variant - no disk
+ * reads, no stat() and no per-request compression.
+ *
+ * Each variant has a strong ETag derived from the file's content (suffixed
+ * per encoding, since the bytes differ), so If-None-Match works across
+ * restarts and replicas. Cache-Control depends on the file name:
+ *
+ *   chunk-*.js, main-*.js, ... (Angular's fingerprinted output)
+ *       public, max-age=31536000, immutable   - content never changes under the name
+ *   index.html (also the SPA fallback)
+ *       no-cache                              - always revalidated, so deploys show up
+ *   anything else
+ *       public, max-age=3600
+ *
+ * Files larger than `max_file_bytes` are skipped and left to the document
+ * root. Not thread-safe while loading; read-only (and safe to share)
+ * afterwards.
+ *
+ * CONFIGURATION:
+ * ==============
+ * STATIC_MAX_FILE_KB - Larger files are served from disk instead (default: 4096)
+ */
+class StaticAssets {
+public:
+    enum class Encoding { Identity, Gzip, Brotli };
+
+    /**
+     * One encoding of a file
+     */
+    struct Variant {
+        Encoding encoding = Encoding::Identity;
+        std::string body;
+        std::string etag;     // Quoted, e.g. "9f2c41d07a3be611-br"
+        size_t id = 0;        // Unique across all variants (index for per-thread caches)
+    };
+
+    struct Asset {
+        std::string path;             // Request path, e.g. "/main-5KPILS5H.js"
+        std::string content_type;
+        std::string cache_control;
+        std::vector<Variant> variants;   // Identity first
+    };
+
+    struct Options {
+        size_t max_file_bytes = 4 * 1024 * 1024;
+        size_t min_compress_bytes = 256;   // Smaller bodies are not worth a Content-Encoding
+    };
+
+    explicit StaticAssets(Options options);
+
+    /**
+     * Load every regular file below `dir` (recursively)
+     *
+     * @return Number of files loaded
+     */
+    size_t loadDirectory(const std::string& dir);
+
+    /**
+     * Add one file from memory (`path` is the request path)
+     */
+    void add(const std::string& path, std::string body);
+
+    /**
+     * Asset for a request path ("/" is index.html), or nullptr
+     */
+    const Asset* find(const std::string& path) const;
+
+    /**
+     * index.html, for the SPA fallback; nullptr when not loaded
+     */
+    const Asset* index() const;
+
+    /**
+     * Best variant the client accepts: brotli, then gzip, then identity
+     */
+    static const Variant& select(const Asset& asset, std::string_view accept_encoding);
+
+    /**
+     * Whether an If-None-Match header matches the variant's ETag
+     */
+    static bool notModified(const Variant& variant, std::string_view if_none_match);
+
+    static const char* encodingName(Encoding encoding);
+    static std::string contentTypeFor(std::string_view path);
+    static std::string cacheControlFor(std::string_view path);
+    static bool compressionAvailable(Encoding encoding);
+
+    /**
+     * Total variants (ids are 0 .. variantCount() - 1)
+     */
+    size_t variantCount() const { return next_variant_id_; }
+
+    size_t fileCount() const { return assets_.size(); }
+
+    /**
+     * Bytes held per encoding
+     */
+    uint64_t bytes(Encoding encoding) const;
+
+    const Options& options() const { return options_; }
+
+private:
+    Options options_;
+    std::unordered_map<std::string, Asset> assets_;
+    size_t next_variant_id_ = 0;
+};
+
+} // namespace hms_firetv
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "utils/Logger.h"
+
+namespace hms_firetv {
+
+/**
+ * Hashed timer wheel for many short, frequently re-armed timers
+ *
+ * Features:
+ * - O(1) schedule and cancel (timers hash into `slots` buckets by tick)
+ * - One thread sleeps until the earliest pending timer's tick (and
+ *   indefinitely while none is pending); due callbacks run on it, outside
+ *   the lock, so a callback may schedule or cancel timers
+ * - Delays longer than one revolution wait for their round
+ * - Never fires early; at most one tick late
+ *
+ * Callbacks must not block; hand real work to another thread or an async
+ * client.
+ *
+ * USAGE:
+ * ======
+ * ```cpp
+ * TimerWheel wheel(std::chrono::milliseconds(10));
+ * wheel.start();
+ * auto id = wheel.schedule(std::chrono::milliseconds(150), [] { ... });
+ * wheel.cancel(id);
+ * ```
+ */
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;
+
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(10),
+                        size_t slots = 512)
+        : tick_(std::max(tick, std::chrono::milliseconds(1))),
+          slots_(std::max<size_t>(slots, 1)) {}
+
+    ~TimerWheel() {
+        stop();
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * Start the wheel thread (idempotent)
+     */
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_ || stopped_) {
+            return;
+        }
+        running_ = true;
+        started_at_ = Clock::now();
+        current_tick_ = 0;
+        thread_ = std::thread(&TimerWheel::run, this);
+    }
+
+    /**
+     * Stop the wheel thread; pending timers are dropped without firing
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopped_) {
+                return;
+            }
+            stopped_ = true;
+            for (auto& slot : slots_) {
+                slot.clear();
+            }
+            index_.clear();
+            due_ticks_.clear();
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * Run `callback` once after `delay`
+     *
+     * @return Timer id for cancel(), 0 if the wheel is stopped
+     */
+    TimerId schedule(std::chrono::milliseconds delay, Callback callback) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            return 0;
+        }
+
+        // Count from the tick in progress and round up, so a timer never fires early
+        uint64_t now_tick = running_
+            ? std::max(current_tick_, static_cast<uint64_t>((Clock::now() - started_at_) / tick_))
+            : current_tick_;
+        uint64_t ticks = static_cast<uint64_t>((std::max(delay, std::chrono::milliseconds(0)) + tick_ -
+                                                std::chrono::milliseconds(1)) / tick_);
+        uint64_t due = now_tick + ticks + 1;
+        size_t slot = static_cast<size_t>(due % slots_.size());
+
+        // The thread may be asleep until a later timer (or none)
+        bool earliest = due_ticks_.empty() || due < *due_ticks_.begin();
+
+        TimerId id = next_id_++;
+        slots_[slot].emplace(id, Timer{due, std::move(callback)});
+        index_.emplace(id, slot);
+        due_ticks_.insert(due);
+        if (earliest) {
+            cv_.notify_one();
+        }
+        return id;
+    }
+
+    /**
+     * Cancel a pending timer
+     *
+     * @return true if it had not fired yet
+     */
+    bool cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(id);
+        if (it == index_.end()) {
+            return false;
+        }
+        auto& slot = slots_[it->second];
+        auto timer = slot.find(id);
+        due_ticks_.erase(due_ticks_.find(timer->second.due_tick));
+        slot.erase(timer);
+        index_.erase(it);
+        return true;
+    }
+
+    /**
+     * Number of pending timers
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.size();
+    }
+
+    std::chrono::milliseconds tick() const { return tick_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        uint64_t due_tick;
+        Callback callback;
+    };
+
+    void run() {
+        std::vector<Callback> due;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopped_) {
+            if (due_ticks_.empty()) {
+                cv_.wait(lock);
+                continue;
+            }
+            // Tick N is complete at started_at_ + N ticks
+            auto next = started_at_ + tick_ * *due_ticks_.begin();
+            if (Clock::now() < next) {
+                cv_.wait_until(lock, next);
+                continue;
+            }
+
+            // Visit each slot the elapsed ticks map to, at most once per
+            // revolution however long the thread slept
+            uint64_t now_tick = static_cast<uint64_t>((Clock::now() - started_at_) / tick_);
+            uint64_t first = std::max(current_tick_ + 1,
+                                      now_tick >= slots_.size() ? now_tick - slots_.size() + 1 : 0);
+            for (uint64_t tick = first; tick <= now_tick; tick++) {
+                auto& slot = slots_[static_cast<size_t>(tick % slots_.size())];
+                for (auto it = slot.begin(); it != slot.end();) {
+                    if (it->second.due_tick <= now_tick) {
+                        due_ticks_.erase(due_ticks_.find(it->second.due_tick));
+                        due.push_back(std::move(it->second.callback));
+                        index_.erase(it->first);
+                        it = slot.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            current_tick_ = now_tick;
+
+            if (due.empty()) {
+                continue;
+            }
+            lock.unlock();
+            for (auto& callback : due) {
+                try {
+                    callback();
+                } catch (const std::exception& e) {
+                    LOG_ERROR("TimerWheel") << "Timer callback failed: " << e.what();
+                }
+            }
+            due.clear();
+            lock.lock();
+        }
+    }
+
+    const std::chrono::milliseconds tick_;
+    std::vector<std::unordered_map<TimerId, Timer>> slots_;
+    std::unordered_map<TimerId, size_t> index_;
+    std::multiset<uint64_t> due_ticks_;  // Due tick of every pending timer
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    Clock::time_point started_at_;
+    uint64_t current_tick_ = 0;
+    TimerId next_id_ = 1;
+    bool running_ = false;
+    bool stopped_ = false;
+};
+
+} // namespace hms_firetv
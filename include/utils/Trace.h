@@ -0,0 +1,287 @@
+#pragma once
+
+#include "utils/BackgroundLogger.h"
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hms_firetv {
+
+/**
+ * Trace - Timeline of one command from ingress to completion
+ *
+ * Created where a command enters the service (MQTT message, REST request)
+ * and filled with spans by each stage it passes through: receive, parse,
+ * queue wait for the device's client, wake probe, DNS/connect/TLS, the
+ * request itself (time until the TV answers), reading the response, and
+ * database writes. Spans may be added from any thread (async callbacks
+ * capture the shared_ptr); stages on the ingress thread find the trace
+ * through Trace::current() and record with TraceSpan.
+ *
+ * IDs are W3C trace-context compatible (32 hex digits), so a `traceparent`
+ * header from the caller is carried through and shows up in exports.
+ */
+class Trace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Span {
+        std::string name;
+        Clock::time_point start;
+        Clock::time_point end;
+        std::string detail;      // Free text (e.g. "reused connection", error message)
+        bool error = false;
+    };
+
+    Trace(std::string id, std::string source);
+
+    const std::string& id() const { return id_; }
+    const std::string& source() const { return source_; }
+    Clock::time_point started() const { return started_; }
+
+    /**
+     * What the trace is about (shown in listings and used as the root span name)
+     */
+    void setCommand(std::string device_id, std::string command);
+
+    /**
+     * Continue an upstream trace (32 hex digits; anything else is ignored)
+     */
+    void adoptId(std::string_view id);
+
+    /**
+     * Continue an upstream trace from a W3C traceparent ("00-<trace>-<span>-<flags>")
+     *
+     * @return false if the header is malformed (the trace keeps its own ID)
+     */
+    bool adoptTraceparent(std::string_view traceparent);
+
+    void addSpan(std::string name, Clock::time_point start, Clock::time_point end,
+                 std::string detail = "", bool error = false);
+
+    void setResult(bool success, std::string error = "");
+
+    /**
+     * Keep this trace regardless of sampling (upstream asked for it)
+     */
+    void forceSample() { forced_ = true; }
+    bool forced() const { return forced_; }
+
+    bool finished() const { return finished_.load(std::memory_order_acquire); }
+    bool success() const;
+    std::string deviceId() const;
+    std::chrono::microseconds duration() const;
+
+    /**
+     * {trace_id, source, device_id, command, success, error, duration_ms, spans: [...]}
+     */
+    Json::Value toJson() const;
+
+    /**
+     * One OTLP/JSON ExportTraceServiceRequest (resourceSpans) holding the
+     * command as the root span and each stage as a child
+     */
+    Json::Value toOtlp() const;
+
+    /**
+     * Trace of the command running on this thread (nullptr if none)
+     */
+    static Trace* current();
+
+    static bool isValidId(std::string_view id);
+
+private:
+    friend class Tracer;
+    friend class TraceContext;
+
+    std::string id_;
+    std::string span_id_;            // Root span
+    std::string parent_span_id_;     // From traceparent, if continued
+    const std::string source_;
+    const Clock::time_point started_;
+    const std::chrono::system_clock::time_point started_wall_;
+
+    mutable std::mutex mutex_;
+    std::string device_id_;
+    std::string command_;
+    std::vector<Span> spans_;
+    bool success_ = true;
+    std::string error_;
+    Clock::time_point ended_;
+
+    std::atomic<bool> finished_{false};
+    bool forced_ = false;
+
+    static thread_local Trace* current_;
+};
+
+/**
+ * Makes a trace current on this thread for the enclosing scope
+ */
+class TraceContext {
+public:
+    explicit TraceContext(const std::shared_ptr<Trace>& trace)
+        : previous_(Trace::current_) {
+        Trace::current_ = trace.get();
+    }
+    ~TraceContext() { Trace::current_ = previous_; }
+
+    TraceContext(const TraceContext&) = delete;
+    TraceContext& operator=(const TraceContext&) = delete;
+
+private:
+    Trace* previous_;
+};
+
+/**
+ * Times the enclosing scope as a span of the current trace (no-op without one)
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : trace_(Trace::current()), name_(name) {
+        if (trace_) {
+            start_ = Trace::Clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (trace_) {
+            trace_->addSpan(name_, start_, Trace::Clock::now(), std::move(detail_), error_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void fail(std::string detail = "") {
+        error_ = true;
+        detail_ = std::move(detail);
+    }
+
+    void note(std::string detail) { detail_ = std::move(detail); }
+
+private:
+    Trace* trace_;
+    const char* name_;
+    Trace::Clock::time_point start_;
+    std::string detail_;
+    bool error_ = false;
+};
+
+/**
+ * Tracer - Starts traces and keeps the sampled ones
+ *
+ * Every command is traced (a few small allocations, next to a network
+ * round trip), and the keep/drop decision is made when it finishes, so the
+ * traces that matter are never sampled away:
+ * - failed commands and commands slower than TRACE_SLOW_MS are always kept
+ * - traces the caller marked sampled (`traceparent` flag 01) are kept
+ * - the rest are kept at TRACE_SAMPLE_RATE, decided from the trace ID so
+ *   every service on the path makes the same choice
+ *
+ * Kept traces go into a fixed-size in-memory ring (GET /api/debug/traces)
+ * and, if TRACE_EXPORT_FILE is set, are appended to it as OTLP/JSON lines
+ * (one ExportTraceServiceRequest per line, as the OpenTelemetry collector's
+ * file exporter writes them) by a background thread.
+ *
+ * CONFIGURATION:
+ * ==============
+ * TRACE_SAMPLE_RATE   - Fraction of normal commands kept, 0..1 (default: 0.05)
+ * TRACE_SLOW_MS       - Always keep commands at least this slow; 0 = off (default: 500)
+ * TRACE_BUFFER_SIZE   - Traces kept in memory (default: 256)
+ * TRACE_EXPORT_FILE   - Append kept traces as OTLP/JSON lines (default: off)
+ *
+ * Setting both TRACE_SAMPLE_RATE and TRACE_SLOW_MS to 0 disables tracing.
+ */
+class Tracer {
+public:
+    struct Options {
+        double sample_rate = 0.05;
+        std::chrono::milliseconds slow{500};
+        size_t capacity = 256;
+        std::string export_file;
+    };
+
+    /**
+     * Get singleton instance (configured from the environment)
+     */
+    static Tracer& getInstance();
+
+    explicit Tracer(Options options);
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    bool enabled() const { return options_.sample_rate > 0 || options_.slow.count() > 0; }
+
+    /**
+     * Start a trace (nullptr when tracing is disabled)
+     *
+     * @param source "mqtt" or "rest"
+     * @param traceparent W3C traceparent header to continue, if any
+     */
+    std::shared_ptr<Trace> start(const char* source, std::string_view traceparent = {});
+
+    /**
+     * End the trace and keep it if sampled (idempotent)
+     */
+    void finish(const std::shared_ptr<Trace>& trace);
+
+    /**
+     * Kept traces, newest first
+     *
+     * @param limit Max traces returned
+     * @param device_id Only this device (empty = all)
+     * @param min_duration Only traces at least this long
+     */
+    std::vector<std::shared_ptr<const Trace>> recent(size_t limit, const std::string& device_id = "",
+                                                     std::chrono::milliseconds min_duration = {}) const;
+
+    std::shared_ptr<const Trace> find(const std::string& trace_id) const;
+
+    /**
+     * Counters: started, kept (by reason), exported, export_dropped
+     */
+    Json::Value stats() const;
+
+    const Options& options() const { return options_; }
+
+    /**
+     * Flush the export queue and stop its thread
+     */
+    void stop();
+
+    static std::string newTraceId();
+    static std::string newSpanId();
+
+private:
+    bool sampled(const Trace& trace) const;
+    void exportTrace(const std::shared_ptr<const Trace>& trace);
+
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<const Trace>> ring_;
+    size_t next_ = 0;
+
+    std::atomic<uint64_t> started_{0};
+    std::atomic<uint64_t> kept_slow_{0};
+    std::atomic<uint64_t> kept_error_{0};
+    std::atomic<uint64_t> kept_forced_{0};
+    std::atomic<uint64_t> kept_sampled_{0};
+    std::atomic<uint64_t> exported_{0};
+
+    std::ofstream export_stream_;    // Used only on the exporter thread
+    BackgroundLogger exporter_{1000};
+};
+
+} // namespace hms_firetv
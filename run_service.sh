@@ -15,7 +15,7 @@ export MQTT_PASS=exploracion
 
 export API_HOST=0.0.0.0
 export API_PORT=8888
-export THREAD_NUM=4
+export THREAD_NUM=0          # One IO thread per core
 export LOG_LEVEL=info
 
 echo "Starting HMS FireTV service..."
@@ -21,9 +21,13 @@ CREATE TABLE IF NOT EXISTS fire_tv_devices (
     adb_enabled BOOLEAN DEFAULT false,
     last_seen_at TIMESTAMP,
     created_at TIMESTAMP DEFAULT NOW(),
-    updated_at TIMESTAMP DEFAULT NOW()
+    updated_at TIMESTAMP DEFAULT NOW(),
+    tags TEXT NOT NULL DEFAULT ''
 );
 
+-- Databases created before tags existed
+ALTER TABLE fire_tv_devices ADD COLUMN IF NOT EXISTS tags TEXT NOT NULL DEFAULT '';
+
 -- Indexes for devices table
 CREATE INDEX IF NOT EXISTS idx_fire_tv_devices_device_id ON fire_tv_devices(device_id);
 CREATE INDEX IF NOT EXISTS idx_fire_tv_devices_ip_address ON fire_tv_devices(ip_address);
@@ -38,6 +42,7 @@ COMMENT ON COLUMN fire_tv_devices.client_token IS 'Pairing token from successful
 COMMENT ON COLUMN fire_tv_devices.pin_code IS 'Temporary PIN for pairing process';
 COMMENT ON COLUMN fire_tv_devices.pin_expires_at IS 'Expiration time for PIN';
 COMMENT ON COLUMN fire_tv_devices.status IS 'Device status: online, offline, pairing';
+COMMENT ON COLUMN fire_tv_devices.tags IS 'Comma-separated lowercase groups for broadcast (e.g., lobby,floor2)';
 
 -- ==============================================================================
 -- 2. Device Apps Table
@@ -77,9 +82,26 @@ CREATE TABLE IF NOT EXISTS command_history (
     success BOOLEAN NOT NULL,
     response_time_ms INT,
     error_message TEXT,
-    created_at TIMESTAMP DEFAULT NOW()
+    created_at TIMESTAMP DEFAULT NOW(),
+    queue_us INT,
+    wake_us INT,
+    dns_us INT,
+    connect_us INT,
+    tls_us INT,
+    ttfb_us INT,
+    transfer_us INT
 );
 
+-- Databases created before the latency breakdown existed
+ALTER TABLE command_history
+    ADD COLUMN IF NOT EXISTS queue_us INT,
+    ADD COLUMN IF NOT EXISTS wake_us INT,
+    ADD COLUMN IF NOT EXISTS dns_us INT,
+    ADD COLUMN IF NOT EXISTS connect_us INT,
+    ADD COLUMN IF NOT EXISTS tls_us INT,
+    ADD COLUMN IF NOT EXISTS ttfb_us INT,
+    ADD COLUMN IF NOT EXISTS transfer_us INT;
+
 -- Indexes for command_history table
 CREATE INDEX IF NOT EXISTS idx_command_history_device_id ON command_history(device_id);
 CREATE INDEX IF NOT EXISTS idx_command_history_created_at ON command_history(created_at DESC);
@@ -90,6 +112,8 @@ COMMENT ON TABLE command_history IS 'Audit log of all commands sent to devices';
 COMMENT ON COLUMN command_history.command_type IS 'Type: navigation, media, volume, app, pairing';
 COMMENT ON COLUMN command_history.command_data IS 'JSON payload of the command';
 COMMENT ON COLUMN command_history.response_time_ms IS 'Command execution time in milliseconds';
+COMMENT ON COLUMN command_history.ttfb_us IS 'Request sent to first response byte (TV processing), microseconds; NULL = not measured';
+COMMENT ON COLUMN command_history.transfer_us IS 'Whole HTTP exchange in microseconds; dns/connect/tls are 0 on a reused connection';
 
 -- ==============================================================================
 -- 4. Popular Apps Pre-populated Data
@@ -202,6 +226,27 @@ $$ LANGUAGE plpgsql;
 
 COMMENT ON FUNCTION cleanup_old_command_history IS 'Delete command history older than specified days (default 30)';
 
+-- ==============================================================================
+-- 9. Macros Table
+-- ==============================================================================
+CREATE TABLE IF NOT EXISTS macros (
+    id SERIAL PRIMARY KEY,
+    name VARCHAR(100) UNIQUE NOT NULL,
+    description TEXT DEFAULT '',
+    steps JSONB NOT NULL DEFAULT '[]',
+    created_at TIMESTAMP DEFAULT NOW(),
+    updated_at TIMESTAMP DEFAULT NOW()
+);
+
+COMMENT ON TABLE macros IS 'Named command sequences run server-side (batch endpoint, MQTT macro)';
+COMMENT ON COLUMN macros.steps IS 'Ordered steps, e.g. [{"command":"app","package":"..."},{"command":"delay","ms":500}]';
+
+DROP TRIGGER IF EXISTS update_macros_updated_at ON macros;
+CREATE TRIGGER update_macros_updated_at
+    BEFORE UPDATE ON macros
+    FOR EACH ROW
+    EXECUTE FUNCTION update_updated_at_column();
+
 -- ==============================================================================
 -- Schema Complete
 -- ==============================================================================
@@ -1,5 +1,5 @@
 #include "api/AppsController.h"
-#include <iostream>
+#include "utils/Logger.h"
 
 namespace hms_firetv {
 
@@ -27,11 +27,11 @@ void AppsController::listApps(const HttpRequestPtr& req,
         resp->setStatusCode(k200OK);
         callback(resp);
 
-        std::cout << "[AppsController] Listed " << apps.size() << " apps for device: "
-                  << device_id << std::endl;
+        LOG_DEBUG("AppsController") << "Listed " << apps.size() << " apps for device: "
+                                    << device_id;
 
     } catch (const std::exception& e) {
-        std::cerr << "[AppsController] Error listing apps: " << e.what() << std::endl;
+        LOG_ERROR("AppsController") << "Error listing apps: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to list apps");
     }
 }
@@ -80,7 +80,7 @@ void AppsController::addApp(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[AppsController] Error adding app: " << e.what() << std::endl;
+        LOG_ERROR("AppsController") << "Error adding app: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to add app");
     }
 }
@@ -140,7 +140,7 @@ void AppsController::updateApp(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[AppsController] Error updating app: " << e.what() << std::endl;
+        LOG_ERROR("AppsController") << "Error updating app: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to update app");
     }
 }
@@ -177,7 +177,7 @@ void AppsController::deleteApp(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[AppsController] Error deleting app: " << e.what() << std::endl;
+        LOG_ERROR("AppsController") << "Error deleting app: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to delete app");
     }
 }
@@ -221,7 +221,7 @@ void AppsController::toggleFavorite(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[AppsController] Error toggling favorite: " << e.what() << std::endl;
+        LOG_ERROR("AppsController") << "Error toggling favorite: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to toggle favorite");
     }
 }
@@ -262,7 +262,7 @@ void AppsController::getPopularApps(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[AppsController] Error getting popular apps: " << e.what() << std::endl;
+        LOG_ERROR("AppsController") << "Error getting popular apps: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to get popular apps");
     }
 }
@@ -304,7 +304,7 @@ void AppsController::bulkAddApps(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[AppsController] Error bulk adding apps: " << e.what() << std::endl;
+        LOG_ERROR("AppsController") << "Error bulk adding apps: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to bulk add apps");
     }
 }
@@ -0,0 +1,72 @@
+#include "api/BroadcastController.h"
+#include "utils/Logger.h"
+
+namespace hms_firetv {
+
+// ============================================================================
+// BROADCAST
+// ============================================================================
+
+void BroadcastController::broadcast(const HttpRequestPtr& req,
+                                    std::function<void(const HttpResponsePtr&)>&& callback) {
+    try {
+        auto json = req->getJsonObject();
+        if (!json) {
+            sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
+            return;
+        }
+
+        std::string error;
+        auto request = BroadcastService::parseRequest(*json, error);
+        if (!request) {
+            bool missing = error.rfind("Device not found", 0) == 0;
+            sendError(std::move(callback), missing ? k404NotFound : k400BadRequest, error);
+            return;
+        }
+
+        if (request->devices.empty()) {
+            sendError(std::move(callback), k404NotFound, "No paired devices match");
+            return;
+        }
+
+        // Header budget, if sent, wins over the body's
+        if (!req->getHeader(Deadline::HEADER).empty()) {
+            request->deadline = Deadline::fromBudget(req->getHeader(Deadline::HEADER));
+        }
+
+        std::string command = request->step.command;
+        BroadcastService::getInstance().broadcast(std::move(request->devices),
+            std::move(request->step), request->pre_wake, request->concurrency,
+            request->deadline,
+            [command, callback = std::move(callback)](BroadcastResult result) {
+                Json::Value response = result.toJson();
+                response["command"] = command;
+
+                auto resp = HttpResponse::newHttpJsonResponse(response);
+                resp->setStatusCode(result.failed == 0 ? k200OK : k500InternalServerError);
+                callback(resp);
+            });
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("BroadcastController") << "Error in broadcast: " << e.what();
+        sendError(std::move(callback), k500InternalServerError, "Broadcast failed");
+    }
+}
+
+// ============================================================================
+// HELPER METHODS
+// ============================================================================
+
+void BroadcastController::sendError(std::function<void(const HttpResponsePtr&)>&& callback,
+                                    HttpStatusCode status,
+                                    const std::string& message) {
+    Json::Value response;
+    response["success"] = false;
+    response["error"] = message;
+
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(status);
+    callback(resp);
+}
+
+} // namespace hms_firetv
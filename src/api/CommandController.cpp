@@ -1,16 +1,24 @@
 #include "api/CommandController.h"
+#include "clients/AsyncLightningClient.h"
+#include "clients/LightningClientPool.h"
+#include "repositories/MacroRepository.h"
+#include "services/MacroRunner.h"
+#include "services/TextInputService.h"
+#include "services/KeyRepeatService.h"
 #include "services/DatabaseService.h"
-#include <drogon/HttpClient.h>
-#include <iostream>
+#include "services/DeviceSloTracker.h"
+#include "services/EventBus.h"
+#include "utils/AllocTracker.h"
+#include "utils/Metrics.h"
+#include "utils/Logger.h"
+#include "utils/Trace.h"
+#include <algorithm>
 #include <chrono>
 
 using namespace drogon;
 
 namespace hms_firetv {
 
-// Static cache initialization
-LRUCache<std::string, std::shared_ptr<LightningClient>> CommandController::clients_cache_{100, 3600};
-
 // Static background logger initialization
 BackgroundLogger CommandController::background_logger_{1000};  // Max 1000 pending logs
 std::once_flag CommandController::logger_init_flag_;
@@ -53,7 +61,7 @@ void CommandController::sendCommand(const HttpRequestPtr& req,
         }
 
     } catch (const std::exception& e) {
-        std::cerr << "[CommandController] Error in sendCommand: " << e.what() << std::endl;
+        LOG_ERROR("CommandController") << "Error in sendCommand: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Command execution failed");
     }
 }
@@ -65,14 +73,60 @@ void CommandController::sendCommand(const HttpRequestPtr& req,
 void CommandController::navigate(const HttpRequestPtr& req,
                                 std::function<void(const HttpResponsePtr&)>&& callback,
                                 std::string device_id) {
+    AllocScope alloc_scope("rest.navigate");
+    auto trace = startTrace(req, device_id, "navigation", callback);
+    TraceContext trace_context(trace);
+
     try {
+        auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+        if (!device.has_value()) {
+            sendError(std::move(callback), k404NotFound, "Device not found");
+            return;
+        }
+
         // Parse request body
-        auto json = req->getJsonObject();
+        auto json = jsonBody(req);
         if (!json) {
             sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
             return;
         }
 
+        // Press-and-hold: the server repeats the key until release or watchdog
+        auto& repeater = KeyRepeatService::getInstance();
+        if (json->get("release", false).asBool()) {
+            auto summary = repeater.release(device_id);
+
+            Json::Value response;
+            response["success"] = true;
+            response["released"] = summary.has_value();
+            if (summary.has_value()) {
+                response["hold"] = summary->toJson();
+            }
+            callback(HttpResponse::newHttpJsonResponse(response));
+            return;
+        }
+        if (json->get("hold", false).asBool()) {
+            std::string error;
+            auto step = KeyRepeatService::navigationStep(*json, error);
+            if (!step) {
+                sendError(std::move(callback), k400BadRequest, error);
+                return;
+            }
+            auto state = repeater.hold(device.value(), step.value());
+
+            Json::Value response;
+            response["success"] = true;
+            response["holding"] = step->detail;
+            response["state"] = KeyRepeatService::holdStateName(state);
+            response["repeat_interval_ms"] = static_cast<Json::Int64>(repeater.options().interval.count());
+            response["watchdog_ms"] = static_cast<Json::Int64>(repeater.options().watchdog.count());
+
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k202Accepted);
+            callback(resp);
+            return;
+        }
+
         std::string action;
         if (json->isMember("action")) {
             action = (*json)["action"].asString();
@@ -94,14 +148,14 @@ void CommandController::navigate(const HttpRequestPtr& req,
         Json::Value fire_tv_body;  // Empty body for navigation
 
         // Make async Fire TV API call (non-blocking)
-        makeAsyncFireTVCall(device_id, endpoint, fire_tv_body,
+        makeAsyncFireTVCall(device.value(), endpoint, fire_tv_body, requestDeadline(req), req->creationDate(), trace,
             [this, device_id, action, callback = std::move(callback)]
-            (bool success, int response_time_ms, const std::string& error_msg) mutable {
+            (bool success, int response_time_ms, const std::string& error_msg, const CommandTiming& timing) mutable {
 
             // Log to database (async via background logger)
             Json::Value command_data;
             command_data["action"] = action;
-            logCommand(device_id, "navigation", command_data, success, response_time_ms, error_msg);
+            logCommand(device_id, "navigation", command_data, success, response_time_ms, error_msg, timing);
 
             // Send response to client
             Json::Value response;
@@ -109,21 +163,22 @@ void CommandController::navigate(const HttpRequestPtr& req,
             response["message"] = success ? "Navigation command sent" : "Navigation command failed";
             response["action"] = action;
             response["response_time_ms"] = response_time_ms;
+            response["timing"] = timing.toJson();
 
             if (!error_msg.empty()) {
                 response["error"] = error_msg;
             }
 
             auto resp = HttpResponse::newHttpJsonResponse(response);
-            resp->setStatusCode(success ? k200OK : k500InternalServerError);
+            resp->setStatusCode(commandStatus(success, error_msg));
             callback(resp);
 
-            std::cout << "[CommandController] Navigate " << action << " on " << device_id
-                      << " (" << response_time_ms << "ms)" << std::endl;
+            LOG_DEBUG("CommandController") << "Navigate " << action << " on " << device_id
+                                           << " (" << response_time_ms << "ms)";
         });
 
     } catch (const std::exception& e) {
-        std::cerr << "[CommandController] Error in navigate: " << e.what() << std::endl;
+        LOG_ERROR("CommandController") << "Error in navigate: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Navigation failed");
     }
 }
@@ -133,16 +188,20 @@ void CommandController::navigate(const HttpRequestPtr& req,
 // ============================================================================
 
 void CommandController::mediaControl(const HttpRequestPtr& req,
-                                    std::function<void(const HttpResponsePtr&)>&& callback,
-                                    std::string device_id) {
+                                     std::function<void(const HttpResponsePtr&)>&& callback,
+                                     std::string device_id) {
+    AllocScope alloc_scope("rest.media");
+    auto trace = startTrace(req, device_id, "media", callback);
+    TraceContext trace_context(trace);
+
     try {
-        auto client = getClient(device_id);
-        if (!client) {
+        auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+        if (!device.has_value()) {
             sendError(std::move(callback), k404NotFound, "Device not found");
             return;
         }
 
-        auto json = req->getJsonObject();
+        auto json = jsonBody(req);
         if (!json) {
             sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
             return;
@@ -155,31 +214,42 @@ void CommandController::mediaControl(const HttpRequestPtr& req,
 
         std::string action = (*json)["action"].asString();
 
-        // Execute media command
-        CommandResult result = client->sendMediaCommand(action);
+        // Build endpoint for Fire TV Lightning API
+        std::string endpoint = "/v1/media?action=" + action;
+        Json::Value fire_tv_body;  // Empty body for media commands
+
+        // Make async Fire TV API call (non-blocking)
+        makeAsyncFireTVCall(device.value(), endpoint, fire_tv_body, requestDeadline(req), req->creationDate(), trace,
+            [this, device_id, action, callback = std::move(callback)]
+            (bool success, int response_time_ms, const std::string& error_msg, const CommandTiming& timing) mutable {
 
-        // Log to database
-        Json::Value command_data;
-        command_data["action"] = action;
-        logCommand(device_id, "media", command_data, result.success, result.response_time_ms,
-                  result.error.has_value() ? result.error.value() : "");
+            // Log to database (async via background logger)
+            Json::Value command_data;
+            command_data["action"] = action;
+            logCommand(device_id, "media", command_data, success, response_time_ms, error_msg, timing);
 
-        Json::Value response;
-        response["success"] = result.success;
-        response["message"] = result.success ? "Media command sent" : "Media command failed";
-        response["action"] = action;
-        response["response_time_ms"] = result.response_time_ms;
+            // Send response to client
+            Json::Value response;
+            response["success"] = success;
+            response["message"] = success ? "Media command sent" : "Media command failed";
+            response["action"] = action;
+            response["response_time_ms"] = response_time_ms;
+            response["timing"] = timing.toJson();
 
-        if (result.error.has_value()) {
-            response["error"] = result.error.value();
-        }
+            if (!error_msg.empty()) {
+                response["error"] = error_msg;
+            }
 
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(result.success ? k200OK : k500InternalServerError);
-        callback(resp);
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(commandStatus(success, error_msg));
+            callback(resp);
+
+            LOG_DEBUG("CommandController") << "Media " << action << " on " << device_id
+                                           << " (" << response_time_ms << "ms)";
+        });
 
     } catch (const std::exception& e) {
-        std::cerr << "[CommandController] Error in mediaControl: " << e.what() << std::endl;
+        LOG_ERROR("CommandController") << "Error in mediaControl: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Media control failed");
     }
 }
@@ -189,16 +259,20 @@ void CommandController::mediaControl(const HttpRequestPtr& req,
 // ============================================================================
 
 void CommandController::volumeControl(const HttpRequestPtr& req,
-                                     std::function<void(const HttpResponsePtr&)>&& callback,
-                                     std::string device_id) {
+                                      std::function<void(const HttpResponsePtr&)>&& callback,
+                                      std::string device_id) {
+    AllocScope alloc_scope("rest.volume");
+    auto trace = startTrace(req, device_id, "volume", callback);
+    TraceContext trace_context(trace);
+
     try {
-        auto client = getClient(device_id);
-        if (!client) {
+        auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+        if (!device.has_value()) {
             sendError(std::move(callback), k404NotFound, "Device not found");
             return;
         }
 
-        auto json = req->getJsonObject();
+        auto json = jsonBody(req);
         if (!json) {
             sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
             return;
@@ -212,30 +286,41 @@ void CommandController::volumeControl(const HttpRequestPtr& req,
         std::string action = (*json)["action"].asString();
 
         // Volume control uses navigation commands
-        CommandResult result = client->sendNavigationCommand(action);
+        std::string endpoint = "/v1/FireTV?action=" + action;
+        Json::Value fire_tv_body;  // Empty body for volume commands
 
-        // Log to database
-        Json::Value command_data;
-        command_data["action"] = action;
-        logCommand(device_id, "volume", command_data, result.success, result.response_time_ms,
-                  result.error.has_value() ? result.error.value() : "");
+        // Make async Fire TV API call (non-blocking)
+        makeAsyncFireTVCall(device.value(), endpoint, fire_tv_body, requestDeadline(req), req->creationDate(), trace,
+            [this, device_id, action, callback = std::move(callback)]
+            (bool success, int response_time_ms, const std::string& error_msg, const CommandTiming& timing) mutable {
 
-        Json::Value response;
-        response["success"] = result.success;
-        response["message"] = result.success ? "Volume command sent" : "Volume command failed";
-        response["action"] = action;
-        response["response_time_ms"] = result.response_time_ms;
+            // Log to database (async via background logger)
+            Json::Value command_data;
+            command_data["action"] = action;
+            logCommand(device_id, "volume", command_data, success, response_time_ms, error_msg, timing);
 
-        if (result.error.has_value()) {
-            response["error"] = result.error.value();
-        }
+            // Send response to client
+            Json::Value response;
+            response["success"] = success;
+            response["message"] = success ? "Volume command sent" : "Volume command failed";
+            response["action"] = action;
+            response["response_time_ms"] = response_time_ms;
+            response["timing"] = timing.toJson();
 
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(result.success ? k200OK : k500InternalServerError);
-        callback(resp);
+            if (!error_msg.empty()) {
+                response["error"] = error_msg;
+            }
+
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(commandStatus(success, error_msg));
+            callback(resp);
+
+            LOG_DEBUG("CommandController") << "Volume " << action << " on " << device_id
+                                           << " (" << response_time_ms << "ms)";
+        });
 
     } catch (const std::exception& e) {
-        std::cerr << "[CommandController] Error in volumeControl: " << e.what() << std::endl;
+        LOG_ERROR("CommandController") << "Error in volumeControl: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Volume control failed");
     }
 }
@@ -245,16 +330,20 @@ void CommandController::volumeControl(const HttpRequestPtr& req,
 // ============================================================================
 
 void CommandController::launchApp(const HttpRequestPtr& req,
-                                 std::function<void(const HttpResponsePtr&)>&& callback,
-                                 std::string device_id) {
+                                  std::function<void(const HttpResponsePtr&)>&& callback,
+                                  std::string device_id) {
+    AllocScope alloc_scope("rest.app");
+    auto trace = startTrace(req, device_id, "app", callback);
+    TraceContext trace_context(trace);
+
     try {
-        auto client = getClient(device_id);
-        if (!client) {
+        auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+        if (!device.has_value()) {
             sendError(std::move(callback), k404NotFound, "Device not found");
             return;
         }
 
-        auto json = req->getJsonObject();
+        auto json = jsonBody(req);
         if (!json) {
             sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
             return;
@@ -267,31 +356,42 @@ void CommandController::launchApp(const HttpRequestPtr& req,
 
         std::string package = (*json)["package"].asString();
 
-        // Execute launch app command
-        CommandResult result = client->launchApp(package);
+        // Build endpoint for Fire TV Lightning API
+        std::string endpoint = "/v1/FireTV/app/" + package;
+        Json::Value fire_tv_body;  // Empty body for app launch
 
-        // Log to database
-        Json::Value command_data;
-        command_data["package"] = package;
-        logCommand(device_id, "app", command_data, result.success, result.response_time_ms,
-                  result.error.has_value() ? result.error.value() : "");
+        // Make async Fire TV API call (non-blocking)
+        makeAsyncFireTVCall(device.value(), endpoint, fire_tv_body, requestDeadline(req), req->creationDate(), trace,
+            [this, device_id, package, callback = std::move(callback)]
+            (bool success, int response_time_ms, const std::string& error_msg, const CommandTiming& timing) mutable {
 
-        Json::Value response;
-        response["success"] = result.success;
-        response["message"] = result.success ? "App launched" : "App launch failed";
-        response["package"] = package;
-        response["response_time_ms"] = result.response_time_ms;
+            // Log to database (async via background logger)
+            Json::Value command_data;
+            command_data["package"] = package;
+            logCommand(device_id, "app", command_data, success, response_time_ms, error_msg, timing);
 
-        if (result.error.has_value()) {
-            response["error"] = result.error.value();
-        }
+            // Send response to client
+            Json::Value response;
+            response["success"] = success;
+            response["message"] = success ? "App launched" : "App launch failed";
+            response["package"] = package;
+            response["response_time_ms"] = response_time_ms;
+            response["timing"] = timing.toJson();
 
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(result.success ? k200OK : k500InternalServerError);
-        callback(resp);
+            if (!error_msg.empty()) {
+                response["error"] = error_msg;
+            }
+
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(commandStatus(success, error_msg));
+            callback(resp);
+
+            LOG_DEBUG("CommandController") << "Launch " << package << " on " << device_id
+                                           << " (" << response_time_ms << "ms)";
+        });
 
     } catch (const std::exception& e) {
-        std::cerr << "[CommandController] Error in launchApp: " << e.what() << std::endl;
+        LOG_ERROR("CommandController") << "Error in launchApp: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "App launch failed");
     }
 }
@@ -301,16 +401,20 @@ void CommandController::launchApp(const HttpRequestPtr& req,
 // ============================================================================
 
 void CommandController::sendText(const HttpRequestPtr& req,
-                                std::function<void(const HttpResponsePtr&)>&& callback,
-                                std::string device_id) {
+                                 std::function<void(const HttpResponsePtr&)>&& callback,
+                                 std::string device_id) {
+    AllocScope alloc_scope("rest.text");
+    auto trace = startTrace(req, device_id, "text", callback);
+    TraceContext trace_context(trace);
+
     try {
-        auto client = getClient(device_id);
-        if (!client) {
+        auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+        if (!device.has_value()) {
             sendError(std::move(callback), k404NotFound, "Device not found");
             return;
         }
 
-        auto json = req->getJsonObject();
+        auto json = jsonBody(req);
         if (!json) {
             sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
             return;
@@ -323,35 +427,165 @@ void CommandController::sendText(const HttpRequestPtr& req,
 
         std::string text = (*json)["text"].asString();
 
-        // Execute send text command
-        CommandResult result = client->sendKeyboardInput(text);
+        // Streaming: queue the field value and answer at once (debounced send)
+        if ((*json).get("stream", false).asBool()) {
+            auto& text_input = TextInputService::getInstance();
+            auto submission = text_input.submit(device_id, text);
 
-        // Log to database
-        Json::Value command_data;
-        command_data["text"] = text;
-        logCommand(device_id, "text", command_data, result.success, result.response_time_ms,
-                  result.error.has_value() ? result.error.value() : "");
-
-        Json::Value response;
-        response["success"] = result.success;
-        response["message"] = result.success ? "Text sent" : "Text send failed";
-        response["text_length"] = static_cast<unsigned int>(text.length());
-        response["response_time_ms"] = result.response_time_ms;
+            Json::Value response;
+            response["success"] = true;
+            response["message"] = "Text queued";
+            response["text_length"] = static_cast<unsigned int>(text.length());
+            response["edit"] = TextEdit::kindName(submission.edit.kind);
+            response["coalesced"] = submission.coalesced;
+            response["debounce_ms"] = static_cast<Json::Int64>(text_input.debounce().count());
 
-        if (result.error.has_value()) {
-            response["error"] = result.error.value();
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k202Accepted);
+            callback(resp);
+            return;
         }
 
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(result.success ? k200OK : k500InternalServerError);
-        callback(resp);
+        // Keyboard input carries the text in the JSON body
+        std::string endpoint = "/v1/FireTV/keyboard";
+        Json::Value fire_tv_body;
+        fire_tv_body["text"] = text;
+
+        // Make async Fire TV API call (non-blocking)
+        makeAsyncFireTVCall(device.value(), endpoint, fire_tv_body, requestDeadline(req), req->creationDate(), trace,
+            [this, device_id, text, callback = std::move(callback)]
+            (bool success, int response_time_ms, const std::string& error_msg, const CommandTiming& timing) mutable {
+
+            // Log to database (async via background logger)
+            Json::Value command_data;
+            command_data["text"] = text;
+            logCommand(device_id, "text", command_data, success, response_time_ms, error_msg, timing);
+
+            // Send response to client
+            Json::Value response;
+            response["success"] = success;
+            response["message"] = success ? "Text sent" : "Text send failed";
+            response["text_length"] = static_cast<unsigned int>(text.length());
+            response["response_time_ms"] = response_time_ms;
+            response["timing"] = timing.toJson();
+
+            if (!error_msg.empty()) {
+                response["error"] = error_msg;
+            }
+
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(commandStatus(success, error_msg));
+            callback(resp);
+
+            LOG_DEBUG("CommandController") << "Text (" << text.length() << " chars) on " << device_id
+                                           << " (" << response_time_ms << "ms)";
+        });
 
     } catch (const std::exception& e) {
-        std::cerr << "[CommandController] Error in sendText: " << e.what() << std::endl;
+        LOG_ERROR("CommandController") << "Error in sendText: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Text send failed");
     }
 }
 
+// ============================================================================
+// BATCH / MACRO
+// ============================================================================
+
+void CommandController::sendBatch(const HttpRequestPtr& req,
+                                  std::function<void(const HttpResponsePtr&)>&& callback,
+                                  std::string device_id) {
+    AllocScope alloc_scope("rest.batch");
+    try {
+        if (!DeviceRepository::getInstance().deviceExists(device_id)) {
+            sendError(std::move(callback), k404NotFound, "Device not found");
+            return;
+        }
+
+        auto json = req->getJsonObject();
+        if (!json) {
+            sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
+            return;
+        }
+
+        std::shared_ptr<const LightningSequence> sequence;
+        std::string macro_name;
+        if (json->isMember("macro")) {
+            macro_name = (*json)["macro"].asString();
+            sequence = MacroRepository::getInstance().getCompiled(macro_name);
+            if (!sequence) {
+                sendError(std::move(callback), k404NotFound, "Macro not found: " + macro_name);
+                return;
+            }
+        } else if (json->isMember("steps")) {
+            std::string error;
+            sequence = compileSequence((*json)["steps"], error);
+            if (!sequence) {
+                sendError(std::move(callback), k400BadRequest, "Invalid steps: " + error);
+                return;
+            }
+        } else {
+            sendError(std::move(callback), k400BadRequest, "Missing 'steps' or 'macro' field");
+            return;
+        }
+
+        bool stop_on_error = json->get("stop_on_error", true).asBool();
+        size_t step_count = sequence->size();
+
+        // Runs on a macro worker: inter-step delays never hold an IO thread
+        MacroRunner::getInstance().runAsync(device_id, std::move(sequence), stop_on_error,
+            requestDeadline(req),
+            [this, device_id, macro_name, step_count, callback = std::move(callback)]
+            (SequenceResult result) mutable {
+
+            if (result.error.has_value() && result.steps.empty()) {
+                const auto& error = result.error.value();
+                HttpStatusCode status = k503ServiceUnavailable;
+                if (error == "Device not found") {
+                    status = k404NotFound;
+                } else if (error == Deadline::EXCEEDED) {
+                    status = k504GatewayTimeout;
+                }
+                sendError(std::move(callback), status, error);
+                return;
+            }
+
+            Json::Value command_data;
+            if (!macro_name.empty()) {
+                command_data["macro"] = macro_name;
+            }
+            command_data["steps"] = static_cast<Json::UInt>(step_count);
+            command_data["steps_run"] = static_cast<Json::UInt>(result.steps_run);
+            std::string error_msg;
+            for (const auto& step : result.steps) {
+                if (!step.success) {
+                    error_msg = "Step " + std::to_string(step.index) + " (" + step.command + ") failed";
+                    break;
+                }
+            }
+            logCommand(device_id, "batch", command_data, result.success,
+                       static_cast<int>(result.total_ms), error_msg, result.timing());
+
+            Json::Value response = result.toJson();
+            response["device_id"] = device_id;
+            if (!macro_name.empty()) {
+                response["macro"] = macro_name;
+            }
+
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(commandStatus(result.success, result.error.value_or("")));
+            callback(resp);
+
+            LOG_DEBUG("CommandController") << "Batch of " << result.steps_run << "/" << step_count
+                                           << " steps on " << device_id << " (queued " << result.queue_ms
+                                           << "ms, ran " << result.total_ms << "ms)";
+        });
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("CommandController") << "Error in sendBatch: " << e.what();
+        sendError(std::move(callback), k500InternalServerError, "Batch execution failed");
+    }
+}
+
 // ============================================================================
 // GET COMMAND HISTORY
 // ============================================================================
@@ -374,7 +608,8 @@ void CommandController::getHistory(const HttpRequestPtr& req,
 
         // Query database
         std::string query = "SELECT id, device_id, command_type, command_data::text, "
-                          "success, response_time_ms, error_message, created_at "
+                          "success, response_time_ms, error_message, created_at, "
+                          "queue_us, wake_us, dns_us, connect_us, tls_us, ttfb_us, transfer_us "
                           "FROM command_history "
                           "WHERE device_id = $1 "
                           "ORDER BY created_at DESC "
@@ -407,6 +642,21 @@ void CommandController::getHistory(const HttpRequestPtr& req,
                 entry["error_message"] = row["error_message"].as<std::string>();
             }
 
+            CommandTiming timing;
+            auto phase = [&row](const char* column) {
+                return row[column].is_null() ? int64_t{-1} : row[column].as<int64_t>();
+            };
+            timing.queue_us = phase("queue_us");
+            timing.wake_us = phase("wake_us");
+            timing.dns_us = phase("dns_us");
+            timing.connect_us = phase("connect_us");
+            timing.tls_us = phase("tls_us");
+            timing.ttfb_us = phase("ttfb_us");
+            timing.transfer_us = phase("transfer_us");
+            if (timing.measured()) {
+                entry["timing"] = timing.toJson();
+            }
+
             entry["created_at"] = row["created_at"].as<std::string>();
 
             response["history"].append(entry);
@@ -417,7 +667,7 @@ void CommandController::getHistory(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[CommandController] Error getting history: " << e.what() << std::endl;
+        LOG_ERROR("CommandController") << "Error getting history: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to get history");
     }
 }
@@ -426,140 +676,124 @@ void CommandController::getHistory(const HttpRequestPtr& req,
 // HELPER METHODS
 // ============================================================================
 
-void CommandController::makeAsyncFireTVCall(const std::string& device_id,
+void CommandController::makeAsyncFireTVCall(const Device& device,
                                              const std::string& endpoint,
                                              const Json::Value& json_body,
-                                             std::function<void(bool, int, const std::string&)> completion_callback) {
-    // Get device from database
-    auto device = DeviceRepository::getInstance().getDeviceById(device_id);
-    if (!device.has_value()) {
-        completion_callback(false, 0, "Device not found");
+                                             const Deadline& deadline,
+                                             const trantor::Date& received,
+                                             const std::shared_ptr<Trace>& trace,
+                                             FireTVCallCallback completion_callback) {
+    // Time the request spent in Drogon and the handler before it went out
+    CommandTiming timing;
+    timing.queue_us = std::max<int64_t>(0,
+        trantor::Date::now().microSecondsSinceEpoch() - received.microSecondsSinceEpoch());
+
+    // The caller already gave up: don't touch the TV
+    if (deadline.expired()) {
+        Deadline::recordCancelled(Deadline::Stage::Transport);
+        if (trace) {
+            trace->setResult(false, Deadline::EXCEEDED);
+        }
+        completion_callback(false, 0, Deadline::EXCEEDED, timing);
+        Tracer::getInstance().finish(trace);
         return;
     }
 
-    // Build Fire TV URL (HTTPS on port 8080)
-    // Note: Fire TV uses self-signed SSL certificates
-    std::string url = "https://" + device->ip_address + ":8080";
-
-    // Create async HTTP client with SSL verification disabled (last param = false)
-    // Parameters: hostString, loop, useOldTLS, validateCert
-    auto client = HttpClient::newHttpClient(url, nullptr, false, false);
-    client->enableCookies();
-
-    // Create POST request
-    auto req = HttpRequest::newHttpJsonRequest(json_body);
-    req->setMethod(Post);
-    req->setPath(endpoint);
-
-    // Add Lightning API headers
-    req->addHeader("X-Api-Key", device->api_key);
-    if (device->client_token.has_value()) {
-        req->addHeader("X-Client-Token", device->client_token.value());
+    std::string body;
+    if (!json_body.isNull()) {
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        body = Json::writeString(writer, json_body);
     }
-    req->addHeader("Content-Type", "application/json");
-
-    // Record start time
-    auto start_time = std::chrono::steady_clock::now();
-
-    // Send async request
-    client->sendRequest(req,
-        [completion_callback, start_time, device_id]
-        (ReqResult result, const HttpResponsePtr& response) {
 
-        // Calculate response time
-        auto end_time = std::chrono::steady_clock::now();
-        int response_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            end_time - start_time
-        ).count();
-
-        // Handle response
-        if (result == ReqResult::Ok && response) {
-            int status_code = static_cast<int>(response->getStatusCode());
-            bool success = (status_code >= 200 && status_code < 300);
-
-            std::string error_msg;
-            if (!success) {
-                error_msg = "HTTP " + std::to_string(status_code);
+    // Drogon's HttpClient reports no connect/TLS timing: one span for the round trip
+    auto sent = Trace::Clock::now();
+    AsyncLightningClient::post(device, endpoint, body,
+        [deadline, trace, endpoint, sent, timing, completion_callback = std::move(completion_callback)]
+        (CommandResult result) {
+            AllocScope alloc_scope("rest.response");   // On the HttpClient's loop, not the handler's
+            std::string error_msg = result.error.value_or("");
+            if (!result.success && result.status_code == 0 && deadline.expired()) {
+                Deadline::recordCancelled(Deadline::Stage::Transport);
+                error_msg = Deadline::EXCEEDED;
             }
-
-            completion_callback(success, response_time_ms, error_msg);
-
-        } else {
-            // Request failed (timeout, network error, etc.)
-            std::string error_msg;
-            switch (result) {
-                case ReqResult::Timeout:
-                    error_msg = "Timeout";
-                    break;
-                case ReqResult::NetworkFailure:
-                    error_msg = "Network failure";
-                    break;
-                case ReqResult::BadResponse:
-                    error_msg = "Bad response";
-                    break;
-                case ReqResult::BadServerAddress:
-                    error_msg = "Bad server address";
-                    break;
-                case ReqResult::HandshakeError:
-                    error_msg = "SSL handshake error";
-                    break;
-                default:
-                    error_msg = "Unknown error";
+            if (trace) {
+                trace->addSpan("request", sent, Trace::Clock::now(),
+                               error_msg.empty() ? endpoint : endpoint + ": " + error_msg, !result.success);
+                trace->setResult(result.success, error_msg);
             }
-
-            std::cerr << "[CommandController] Fire TV API call failed for " << device_id
-                      << ": " << error_msg << " (" << response_time_ms << "ms)" << std::endl;
-
-            completion_callback(false, response_time_ms, error_msg);
-        }
-    }, FIRETV_API_TIMEOUT_SECONDS);  // Pass timeout to sendRequest
+            // No wake on this path; HttpClient only reports the whole exchange,
+            // which history keeps as response_time_ms
+            CommandTiming breakdown = timing;
+            breakdown.round_trip_us = result.timing.round_trip_us;
+            completion_callback(result.success, result.response_time_ms, error_msg, breakdown);
+            Tracer::getInstance().finish(trace);
+        }, deadline.capSeconds(FIRETV_API_TIMEOUT_SECONDS));
 }
 
-std::shared_ptr<LightningClient> CommandController::getClient(const std::string& device_id) {
-    // Check cache first
-    auto cached = clients_cache_.get(device_id);
-    if (cached.has_value()) {
-        return cached.value();
-    }
-
-    // Get device from database
-    auto device = DeviceRepository::getInstance().getDeviceById(device_id);
-    if (!device.has_value()) {
+std::shared_ptr<Trace> CommandController::startTrace(const HttpRequestPtr& req,
+                                                     const std::string& device_id,
+                                                     const char* command,
+                                                     std::function<void(const HttpResponsePtr&)>& callback) {
+    auto trace = Tracer::getInstance().start("rest", req->getHeader("traceparent"));
+    if (!trace) {
         return nullptr;
     }
+    trace->setCommand(device_id, command);
+
+    // creationDate() is stamped when Drogon finished reading the request
+    auto now = Trace::Clock::now();
+    auto waited = std::chrono::microseconds(
+        trantor::Date::now().microSecondsSinceEpoch() - req->creationDate().microSecondsSinceEpoch());
+    trace->addSpan("receive", now - std::max(waited, std::chrono::microseconds(0)), now);
+
+    callback = [trace_id = trace->id(), inner = std::move(callback)](const HttpResponsePtr& resp) {
+        resp->addHeader("X-Trace-Id", trace_id);
+        inner(resp);
+    };
+    return trace;
+}
 
-    // Create new client
-    auto client = std::make_shared<LightningClient>(
-        device->ip_address,
-        device->api_key
-    );
+std::shared_ptr<Json::Value> CommandController::jsonBody(const HttpRequestPtr& req) {
+    TraceSpan span("parse");
+    return req->getJsonObject();
+}
 
-    // Set client token if device is paired
-    if (device->client_token.has_value()) {
-        client->setClientToken(device->client_token.value());
-    }
+Deadline CommandController::requestDeadline(const HttpRequestPtr& req) {
+    return Deadline::fromBudget(req->getHeader(Deadline::HEADER));
+}
 
-    // Cache client (will evict LRU if at capacity)
-    clients_cache_.put(device_id, client);
+HttpStatusCode CommandController::commandStatus(bool success, const std::string& error_msg) {
+    if (success) {
+        return k200OK;
+    }
+    return error_msg == Deadline::EXCEEDED ? k504GatewayTimeout : k500InternalServerError;
+}
 
-    return client;
+void CommandController::startClientCacheSweeper() {
+    LightningClientPool::getInstance().startSweeper(std::chrono::seconds(CLIENT_CACHE_SWEEP_SECONDS));
+    AsyncLightningClient::startSweeper(std::chrono::seconds(CLIENT_CACHE_SWEEP_SECONDS));
+    LOG_INFO("CommandController") << "Client pool sweeper started (every "
+                                  << CLIENT_CACHE_SWEEP_SECONDS << "s, max "
+                                  << LightningClientPool::getInstance().maxParallelPerDevice()
+                                  << " clients per device)";
 }
 
-void CommandController::invalidateClient(const std::string& device_id) {
-    clients_cache_.remove(device_id);
-    std::cout << "[CommandController] Invalidated cached client for device: " << device_id << std::endl;
+void CommandController::stopClientCacheSweeper() {
+    LightningClientPool::getInstance().stopSweeper();
+    AsyncLightningClient::stopSweeper();
 }
 
 void CommandController::initBackgroundLogger() {
     std::call_once(logger_init_flag_, []() {
         background_logger_.start();
-        std::cout << "[CommandController] Background logger initialized" << std::endl;
+        LOG_INFO("CommandController") << "Background logger initialized";
     });
 }
 
 void CommandController::shutdownBackgroundLogger() {
     background_logger_.stop();
-    std::cout << "[CommandController] Background logger shutdown complete" << std::endl;
+    LOG_INFO("CommandController") << "Background logger shutdown complete";
 }
 
 void CommandController::logCommand(const std::string& device_id,
@@ -567,7 +801,15 @@ void CommandController::logCommand(const std::string& device_id,
                                   const Json::Value& command_data,
                                   bool success,
                                   int response_time_ms,
-                                  const std::string& error_message) {
+                                  const std::string& error_message,
+                                  const CommandTiming& timing) {
+    Metrics::recordCommand(device_id, command_type, success,
+                           std::chrono::milliseconds(response_time_ms));
+    DeviceSloTracker::getInstance().recordCommand(device_id, success,
+                                                  std::chrono::milliseconds(response_time_ms));
+    EventBus::getInstance().commandResult(device_id, command_type, success,
+                                          std::chrono::milliseconds(response_time_ms), "rest");
+
     // Ensure background logger is started
     initBackgroundLogger();
 
@@ -575,12 +817,21 @@ void CommandController::logCommand(const std::string& device_id,
     Json::StreamWriterBuilder writer;
     std::string command_data_str = Json::writeString(writer, command_data);
 
+    // Breakdown columns are generated integers, inlined to stay within executeQueryParams' 8 parameters
+    std::string timing_values;
+    for (int64_t us : {timing.queue_us, timing.wake_us, timing.dns_us, timing.connect_us,
+                       timing.tls_us, timing.ttfb_us, timing.transfer_us}) {
+        timing_values += us >= 0 ? ", " + std::to_string(us) : ", NULL";
+    }
+
     // Enqueue log task to background thread (non-blocking)
     bool enqueued = background_logger_.enqueue([=]() {
         try {
+            ScopedLatency timer(Metrics::dbQuery("insert_command_history"));
             std::string query = "INSERT INTO command_history "
-                              "(device_id, command_type, command_data, success, response_time_ms, error_message) "
-                              "VALUES ($1, $2, $3::jsonb, $4, $5, $6)";
+                              "(device_id, command_type, command_data, success, response_time_ms, error_message, "
+                              "queue_us, wake_us, dns_us, connect_us, tls_us, ttfb_us, transfer_us) "
+                              "VALUES ($1, $2, $3::jsonb, $4, $5, $6" + timing_values + ")";
 
             DatabaseService::getInstance().executeQueryParams(query, {
                 device_id,
@@ -592,14 +843,14 @@ void CommandController::logCommand(const std::string& device_id,
             });
 
         } catch (const std::exception& e) {
-            std::cerr << "[CommandController] Failed to log command: " << e.what() << std::endl;
+            LOG_ERROR("CommandController") << "Failed to log command: " << e.what();
             // Don't throw - logging failures shouldn't crash the worker thread
         }
     });
 
     if (!enqueued) {
-        std::cerr << "[CommandController] Warning: Log queue full, dropped entry for "
-                  << device_id << std::endl;
+        LOG_WARN("CommandController") << "Log queue full, dropped entry for "
+                                      << device_id;
     }
 }
 
@@ -0,0 +1,114 @@
+#include "api/DebugController.h"
+#include "utils/AllocTracker.h"
+#include "utils/CpuProfiler.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace hms_firetv {
+
+void DebugController::listTraces(const HttpRequestPtr& req,
+                                 std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto& tracer = Tracer::getInstance();
+
+    size_t limit = DEFAULT_LIMIT;
+    std::string limit_param = req->getParameter("limit");
+    if (!limit_param.empty()) {
+        limit = static_cast<size_t>(std::max(1L, std::strtol(limit_param.c_str(), nullptr, 10)));
+    }
+    limit = std::min(limit, tracer.options().capacity);
+    std::string device_id = req->getParameter("device");
+    auto min_ms = std::chrono::milliseconds(std::max(0L, std::strtol(req->getParameter("min_ms").c_str(), nullptr, 10)));
+
+    Json::Value response;
+    response["success"] = true;
+    response["tracer"] = tracer.stats();
+    response["traces"] = Json::arrayValue;
+    for (const auto& trace : tracer.recent(limit, device_id, min_ms)) {
+        response["traces"].append(trace->toJson());
+    }
+    response["count"] = response["traces"].size();
+
+    callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+void DebugController::getTrace(const HttpRequestPtr& req,
+                               std::function<void(const HttpResponsePtr&)>&& callback,
+                               std::string trace_id) {
+    auto trace = Tracer::getInstance().find(trace_id);
+    if (!trace) {
+        sendError(std::move(callback), k404NotFound, "Trace not found (not sampled or already evicted)");
+        return;
+    }
+
+    if (req->getParameter("format") == "otlp") {
+        callback(HttpResponse::newHttpJsonResponse(trace->toOtlp()));
+        return;
+    }
+
+    Json::Value response;
+    response["success"] = true;
+    response["trace"] = trace->toJson();
+    callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+void DebugController::getAllocations(const HttpRequestPtr& req,
+                                     std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto& tracker = AllocTracker::getInstance();
+
+    Json::Value response;
+    response["success"] = true;
+    response["allocations"] = tracker.toJson();
+    if (req->getParameter("reset") == "1") {
+        tracker.reset();
+    }
+    callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+void DebugController::profile(const HttpRequestPtr& req,
+                              std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto& profiler = CpuProfiler::getInstance();
+
+    std::string seconds_param = req->getParameter("seconds");
+    long seconds = seconds_param.empty() ? DEFAULT_PROFILE_SECONDS : std::strtol(seconds_param.c_str(), nullptr, 10);
+    std::string hz_param = req->getParameter("hz");
+    long hz = hz_param.empty() ? CpuProfiler::DEFAULT_HZ : std::strtol(hz_param.c_str(), nullptr, 10);
+    bool json = req->getParameter("format") == "json";
+
+    std::string error;
+    auto shared_callback = std::make_shared<std::function<void(const HttpResponsePtr&)>>(std::move(callback));
+    bool started = profiler.start(std::chrono::seconds(seconds), static_cast<int>(hz),
+        [shared_callback, json](CpuProfiler::Profile profile) {
+            HttpResponsePtr resp;
+            if (json) {
+                Json::Value response;
+                response["success"] = true;
+                response["profile"] = profile.toJson();
+                resp = HttpResponse::newHttpJsonResponse(response);
+            } else {
+                resp = HttpResponse::newHttpResponse();
+                resp->setContentTypeCode(CT_TEXT_PLAIN);
+                resp->setBody(profile.folded());
+                resp->addHeader("X-Profile-Samples", std::to_string(profile.samples));
+                resp->addHeader("X-Profile-Dropped", std::to_string(profile.dropped));
+            }
+            (*shared_callback)(resp);
+        }, error);
+
+    if (!started) {
+        HttpStatusCode status = !profiler.enabled() ? k403Forbidden
+                              : profiler.running()  ? k409Conflict
+                                                    : k400BadRequest;
+        sendError(std::move(*shared_callback), status, error);
+    }
+}
+
+void DebugController::sendError(std::function<void(const HttpResponsePtr&)>&& callback,
+                                HttpStatusCode status, const std::string& message) {
+    Json::Value r; r["success"] = false; r["error"] = message;
+    auto resp = HttpResponse::newHttpJsonResponse(r);
+    resp->setStatusCode(status);
+    callback(resp);
+}
+
+} // namespace hms_firetv
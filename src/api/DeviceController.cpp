@@ -1,10 +1,9 @@
 #include "api/DeviceController.h"
-#include "api/CommandController.h"
 #include "repositories/DeviceRepository.h"
 #include "services/DiscoveryService.h"
-#include <iostream>
 
 #include "services/DiscoveryService.h"
+#include "utils/Logger.h"
 
 namespace hms_firetv {
 
@@ -36,10 +35,10 @@ void DeviceController::listDevices(const HttpRequestPtr& req,
         resp->setStatusCode(k200OK);
         callback(resp);
 
-        std::cout << "[DeviceController] Listed " << devices.size() << " devices" << std::endl;
+        LOG_DEBUG("DeviceController") << "Listed " << devices.size() << " devices";
 
     } catch (const std::exception& e) {
-        std::cerr << "[DeviceController] Error listing devices: " << e.what() << std::endl;
+        LOG_ERROR("DeviceController") << "Error listing devices: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to list devices");
     }
 }
@@ -66,10 +65,10 @@ void DeviceController::listDevices(const HttpRequestPtr& req,
             resp->setStatusCode(k200OK);
             callback(resp);
 
-            std::cout << "[DeviceController] Discovered " << devices.size() << " devices" << std::endl;
+            LOG_INFO("DeviceController") << "Discovered " << devices.size() << " devices";
 
         } catch (const std::exception& e) {
-            std::cerr << "[DeviceController] Error discovering devices: " << e.what() << std::endl;
+            LOG_ERROR("DeviceController") << "Error discovering devices: " << e.what();
             sendError(std::move(callback), k500InternalServerError, "Failed to discover devices");
         }
     }
@@ -97,10 +96,10 @@ void DeviceController::getDeviceById(const HttpRequestPtr& req,
         resp->setStatusCode(k200OK);
         callback(resp);
 
-        std::cout << "[DeviceController] Retrieved device: " << device_id << std::endl;
+        LOG_DEBUG("DeviceController") << "Retrieved device: " << device_id;
 
     } catch (const std::exception& e) {
-        std::cerr << "[DeviceController] Error getting device: " << e.what() << std::endl;
+        LOG_ERROR("DeviceController") << "Error getting device: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to get device");
     }
 }
@@ -135,6 +134,7 @@ void DeviceController::createDevice(const HttpRequestPtr& req,
         device.api_key = trim((*json).get("api_key", "0987654321").asString());
         device.status = "offline";
         device.adb_enabled = (*json).get("adb_enabled", false).asBool();
+        device.tags = Device::tagsFromJson((*json).get("tags", ""));
 
         // Check if device already exists
         auto existing = DeviceRepository::getInstance().getDeviceById(device.device_id);
@@ -164,10 +164,10 @@ void DeviceController::createDevice(const HttpRequestPtr& req,
         resp->setStatusCode(k201Created);
         callback(resp);
 
-        std::cout << "[DeviceController] Created device: " << device.device_id << std::endl;
+        LOG_INFO("DeviceController") << "Created device: " << device.device_id;
 
     } catch (const std::exception& e) {
-        std::cerr << "[DeviceController] Error creating device: " << e.what() << std::endl;
+        LOG_ERROR("DeviceController") << "Error creating device: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to create device");
     }
 }
@@ -215,6 +215,9 @@ void DeviceController::updateDevice(const HttpRequestPtr& req,
         if (json->isMember("client_token")) {
             device.client_token = (*json)["client_token"].asString();
         }
+        if (json->isMember("tags")) {
+            device.tags = Device::tagsFromJson((*json)["tags"]);
+        }
 
         // Save to database
         bool success = DeviceRepository::getInstance().updateDevice(device);
@@ -224,9 +227,6 @@ void DeviceController::updateDevice(const HttpRequestPtr& req,
             return;
         }
 
-        // Invalidate cached Lightning client (IP or token may have changed)
-        CommandController::invalidateClient(device_id);
-
         // Return updated device
         Json::Value response;
         response["success"] = true;
@@ -237,10 +237,10 @@ void DeviceController::updateDevice(const HttpRequestPtr& req,
         resp->setStatusCode(k200OK);
         callback(resp);
 
-        std::cout << "[DeviceController] Updated device: " << device_id << std::endl;
+        LOG_INFO("DeviceController") << "Updated device: " << device_id;
 
     } catch (const std::exception& e) {
-        std::cerr << "[DeviceController] Error updating device: " << e.what() << std::endl;
+        LOG_ERROR("DeviceController") << "Error updating device: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to update device");
     }
 }
@@ -268,9 +268,6 @@ void DeviceController::deleteDevice(const HttpRequestPtr& req,
             return;
         }
 
-        // Invalidate cached Lightning client
-        CommandController::invalidateClient(device_id);
-
         // Return success response
         Json::Value response;
         response["success"] = true;
@@ -280,10 +277,10 @@ void DeviceController::deleteDevice(const HttpRequestPtr& req,
         resp->setStatusCode(k200OK);
         callback(resp);
 
-        std::cout << "[DeviceController] Deleted device: " << device_id << std::endl;
+        LOG_INFO("DeviceController") << "Deleted device: " << device_id;
 
     } catch (const std::exception& e) {
-        std::cerr << "[DeviceController] Error deleting device: " << e.what() << std::endl;
+        LOG_ERROR("DeviceController") << "Error deleting device: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to delete device");
     }
 }
@@ -324,7 +321,7 @@ void DeviceController::getDeviceStatus(const HttpRequestPtr& req,
         callback(resp);
 
     } catch (const std::exception& e) {
-        std::cerr << "[DeviceController] Error getting device status: " << e.what() << std::endl;
+        LOG_ERROR("DeviceController") << "Error getting device status: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to get device status");
     }
 }
@@ -342,6 +339,10 @@ Json::Value DeviceController::deviceToJson(const Device& device) {
     json["api_key"] = device.api_key;
     json["status"] = device.status;
     json["adb_enabled"] = device.adb_enabled;
+    json["tags"] = Json::arrayValue;
+    for (const auto& tag : device.tags) {
+        json["tags"].append(tag);
+    }
     json["is_paired"] = device.client_token.has_value() && !device.client_token.value().empty();
 
     // Include client_token only if present (sensitive data)
@@ -0,0 +1,198 @@
+#include "api/MacroController.h"
+#include "utils/Logger.h"
+
+namespace hms_firetv {
+
+// ============================================================================
+// LIST MACROS
+// ============================================================================
+
+void MacroController::listMacros(const HttpRequestPtr& req,
+                                 std::function<void(const HttpResponsePtr&)>&& callback) {
+    try {
+        auto macros = MacroRepository::getInstance().getAllMacros();
+
+        Json::Value response;
+        response["success"] = true;
+        response["count"] = static_cast<unsigned int>(macros.size());
+        response["macros"] = Json::arrayValue;
+
+        for (const auto& macro : macros) {
+            response["macros"].append(macro.toJson());
+        }
+
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k200OK);
+        callback(resp);
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("MacroController") << "Error listing macros: " << e.what();
+        sendError(std::move(callback), k500InternalServerError, "Failed to list macros");
+    }
+}
+
+// ============================================================================
+// CREATE MACRO
+// ============================================================================
+
+void MacroController::createMacro(const HttpRequestPtr& req,
+                                  std::function<void(const HttpResponsePtr&)>&& callback) {
+    try {
+        auto json = req->getJsonObject();
+        if (!json) {
+            sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
+            return;
+        }
+
+        if (!json->isMember("name") || !json->isMember("steps")) {
+            sendError(std::move(callback), k400BadRequest, "Missing 'name' or 'steps' field");
+            return;
+        }
+
+        Macro macro;
+        macro.name = (*json)["name"].asString();
+        macro.description = json->get("description", "").asString();
+        macro.steps = (*json)["steps"];
+
+        saveAndRespond(std::move(macro), k201Created, std::move(callback));
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("MacroController") << "Error creating macro: " << e.what();
+        sendError(std::move(callback), k500InternalServerError, "Failed to create macro");
+    }
+}
+
+// ============================================================================
+// GET MACRO
+// ============================================================================
+
+void MacroController::getMacro(const HttpRequestPtr& req,
+                               std::function<void(const HttpResponsePtr&)>&& callback,
+                               std::string name) {
+    try {
+        auto macro = MacroRepository::getInstance().getMacro(name);
+        if (!macro.has_value()) {
+            sendError(std::move(callback), k404NotFound, "Macro not found");
+            return;
+        }
+
+        Json::Value response;
+        response["success"] = true;
+        response["macro"] = macro->toJson();
+
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k200OK);
+        callback(resp);
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("MacroController") << "Error getting macro: " << e.what();
+        sendError(std::move(callback), k500InternalServerError, "Failed to get macro");
+    }
+}
+
+// ============================================================================
+// UPDATE MACRO
+// ============================================================================
+
+void MacroController::updateMacro(const HttpRequestPtr& req,
+                                  std::function<void(const HttpResponsePtr&)>&& callback,
+                                  std::string name) {
+    try {
+        auto json = req->getJsonObject();
+        if (!json) {
+            sendError(std::move(callback), k400BadRequest, "Invalid JSON body");
+            return;
+        }
+
+        auto existing = MacroRepository::getInstance().getMacro(name);
+        if (!existing.has_value()) {
+            sendError(std::move(callback), k404NotFound, "Macro not found");
+            return;
+        }
+
+        Macro macro = existing.value();
+        if (json->isMember("description")) {
+            macro.description = (*json)["description"].asString();
+        }
+        if (json->isMember("steps")) {
+            macro.steps = (*json)["steps"];
+        }
+
+        saveAndRespond(std::move(macro), k200OK, std::move(callback));
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("MacroController") << "Error updating macro: " << e.what();
+        sendError(std::move(callback), k500InternalServerError, "Failed to update macro");
+    }
+}
+
+// ============================================================================
+// DELETE MACRO
+// ============================================================================
+
+void MacroController::deleteMacro(const HttpRequestPtr& req,
+                                  std::function<void(const HttpResponsePtr&)>&& callback,
+                                  std::string name) {
+    try {
+        if (!MacroRepository::getInstance().deleteMacro(name)) {
+            sendError(std::move(callback), k404NotFound, "Macro not found");
+            return;
+        }
+
+        Json::Value response;
+        response["success"] = true;
+        response["message"] = "Macro deleted successfully";
+
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k200OK);
+        callback(resp);
+
+        LOG_INFO("MacroController") << "Deleted macro: " << name;
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("MacroController") << "Error deleting macro: " << e.what();
+        sendError(std::move(callback), k500InternalServerError, "Failed to delete macro");
+    }
+}
+
+// ============================================================================
+// HELPER METHODS
+// ============================================================================
+
+void MacroController::saveAndRespond(Macro macro,
+                                     HttpStatusCode success_status,
+                                     std::function<void(const HttpResponsePtr&)>&& callback) {
+    std::string error;
+    if (!MacroRepository::getInstance().saveMacro(macro, error)) {
+        sendError(std::move(callback), k400BadRequest, error);
+        return;
+    }
+
+    auto saved = MacroRepository::getInstance().getMacro(macro.name);
+
+    Json::Value response;
+    response["success"] = true;
+    response["message"] = "Macro saved successfully";
+    response["macro"] = saved.has_value() ? saved->toJson() : macro.toJson();
+
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(success_status);
+    callback(resp);
+
+    LOG_INFO("MacroController") << "Saved macro '" << macro.name << "' ("
+                                << macro.steps.size() << " steps)";
+}
+
+void MacroController::sendError(std::function<void(const HttpResponsePtr&)>&& callback,
+                                HttpStatusCode status,
+                                const std::string& message) {
+    Json::Value response;
+    response["success"] = false;
+    response["error"] = message;
+
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(status);
+    callback(resp);
+}
+
+} // namespace hms_firetv
@@ -1,10 +1,10 @@
 #include "api/PairingController.h"
-#include <iostream>
+#include "utils/Logger.h"
+#include <algorithm>
 #include <random>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
-#include <thread>
 
 namespace hms_firetv {
 
@@ -36,50 +36,26 @@ void PairingController::startPairing(const HttpRequestPtr& req,
             return;
         }
 
-        // Get Lightning client
-        auto client = getClient(device_id);
-        if (!client) {
-            sendError(std::move(callback), k500InternalServerError, "Failed to create client");
-            return;
-        }
-
-        // Trigger PIN display on TV — the TV generates and shows its own PIN
-        if (!client->displayPin()) {
-            sendError(std::move(callback), k500InternalServerError,
-                     "Failed to display PIN on TV. Check device connectivity.");
-            return;
-        }
-
-        // Store pairing session expiry (5 minutes) — no pin_code stored, TV owns the PIN
-        auto now = std::chrono::system_clock::now();
-        auto expires = now + std::chrono::minutes(5);
-        auto expires_time_t = std::chrono::system_clock::to_time_t(expires);
-        std::ostringstream oss;
-        oss << std::put_time(std::gmtime(&expires_time_t), "%Y-%m-%d %H:%M:%S");
-        std::string expires_at = oss.str();
-
-        if (!db_ || !db_->setPairingPin(device_id, "", 300)) {
-            sendError(std::move(callback), k500InternalServerError, "Failed to store pairing session");
-            return;
-        }
+        // The TV is asked to display its PIN in the background; the session
+        // moves to awaiting_pin once it has (follow it via /pair/status)
+        auto session = PairingSessionManager::getInstance().start(device_id);
+        auto json = session.toJson();
 
-        // Return response
         Json::Value response;
         response["success"] = true;
-        response["message"] = "PIN displayed on TV. Enter the PIN to complete pairing.";
+        response["message"] = "Displaying PIN on TV. Enter the PIN to complete pairing.";
         response["device_id"] = device_id;
-        response["pin_expires_at"] = expires_at;
-        response["expires_in_seconds"] = 300;
+        response["session_id"] = session.session_id;
+        response["session"] = json;
+        response["pin_expires_at"] = json["expires_at"];
+        response["expires_in_seconds"] = json["expires_in_seconds"];
 
         auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k200OK);
+        resp->setStatusCode(k202Accepted);
         callback(resp);
 
-        std::cout << "[PairingController] Started pairing for " << device_id
-                  << ", PIN expires at " << expires_at << std::endl;
-
     } catch (const std::exception& e) {
-        std::cerr << "[PairingController] Error starting pairing: " << e.what() << std::endl;
+        LOG_ERROR("PairingController") << "Error starting pairing: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to start pairing");
     }
 }
@@ -113,72 +89,34 @@ void PairingController::verifyPairing(const HttpRequestPtr& req,
             return;
         }
 
-        // Check if pairing session is in progress
-        if (device->status != "pairing") {
-            sendError(std::move(callback), k400BadRequest,
-                     "No pairing in progress. Start pairing first.");
-            return;
-        }
-
-        // Check if pairing session has expired
-        std::string expires_at_str = "";
-        if (device->pin_expires_at.has_value()) {
-            auto expires_time_t = std::chrono::system_clock::to_time_t(device->pin_expires_at.value());
-            std::ostringstream oss;
-            oss << std::put_time(std::gmtime(&expires_time_t), "%Y-%m-%d %H:%M:%S");
-            expires_at_str = oss.str();
-        }
-
-        if (isPinExpired(expires_at_str)) {
-            if (db_) db_->clearPairing(device_id);
-            sendError(std::move(callback), k410Gone, "Pairing session expired. Start pairing again.");
-            return;
-        }
-
-        // Get Lightning client
-        auto client = getClient(device_id);
-        if (!client) {
-            sendError(std::move(callback), k500InternalServerError, "Failed to create client");
-            return;
-        }
-
-        // Complete pairing with Fire TV — retry up to 3 times in case TV returns "OK" first
-        std::string client_token;
-        for (int attempt = 0; attempt < 3 && client_token.empty(); ++attempt) {
-            if (attempt > 0) std::this_thread::sleep_for(std::chrono::seconds(1));
-            client_token = client->verifyPin(entered_pin);
-        }
-
-        if (client_token.empty()) {
-            sendError(std::move(callback), k500InternalServerError,
-                     "Failed to complete pairing with device");
-            return;
-        }
-
-        // Store client token and clear PIN
-        if (!db_ || !db_->completePairing(device_id, client_token)) {
-            sendError(std::move(callback), k500InternalServerError, "Failed to store pairing token");
+        // Token polling runs in the background; the session ends up paired or failed
+        using VerifyError = PairingSessionManager::VerifyError;
+        VerifyError error = VerifyError::None;
+        auto session = PairingSessionManager::getInstance().verify(device_id, entered_pin, error);
+        if (!session.has_value()) {
+            HttpStatusCode status = k400BadRequest;
+            if (error == VerifyError::Expired) {
+                status = k410Gone;
+            } else if (error == VerifyError::Busy || error == VerifyError::NotDisplayed) {
+                status = k409Conflict;
+            }
+            sendError(std::move(callback), status, PairingSessionManager::verifyErrorMessage(error));
             return;
         }
 
-        // Update client with token
-        client->setClientToken(client_token);
-
-        // Return success
         Json::Value response;
         response["success"] = true;
-        response["message"] = "Device paired successfully";
+        response["message"] = "Verifying PIN. Poll /pair/status for the result.";
         response["device_id"] = device_id;
-        response["is_paired"] = true;
+        response["session_id"] = session->session_id;
+        response["session"] = session->toJson();
 
         auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k200OK);
+        resp->setStatusCode(k202Accepted);
         callback(resp);
 
-        std::cout << "[PairingController] Successfully paired device: " << device_id << std::endl;
-
     } catch (const std::exception& e) {
-        std::cerr << "[PairingController] Error verifying pairing: " << e.what() << std::endl;
+        LOG_ERROR("PairingController") << "Error verifying pairing: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to verify pairing");
     }
 }
@@ -198,17 +136,13 @@ void PairingController::resetPairing(const HttpRequestPtr& req,
             return;
         }
 
-        if (!db_ || !db_->clearPairing(device_id)) {
+        PairingSessionManager::getInstance().cancel(device_id);
+
+        if (!DeviceRepository::getInstance().clearPairing(device_id)) {
             sendError(std::move(callback), k500InternalServerError, "Failed to reset pairing");
             return;
         }
 
-        // Clear cached client
-        {
-            std::lock_guard<std::mutex> lock(clients_mutex_);
-            clients_.erase(device_id);
-        }
-
         // Return success
         Json::Value response;
         response["success"] = true;
@@ -220,10 +154,10 @@ void PairingController::resetPairing(const HttpRequestPtr& req,
         resp->setStatusCode(k200OK);
         callback(resp);
 
-        std::cout << "[PairingController] Reset pairing for device: " << device_id << std::endl;
+        LOG_INFO("PairingController") << "Reset pairing for device: " << device_id;
 
     } catch (const std::exception& e) {
-        std::cerr << "[PairingController] Error resetting pairing: " << e.what() << std::endl;
+        LOG_ERROR("PairingController") << "Error resetting pairing: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to reset pairing");
     }
 }
@@ -243,38 +177,42 @@ void PairingController::getPairingStatus(const HttpRequestPtr& req,
             return;
         }
 
-        Json::Value response;
-        response["success"] = true;
-        response["device_id"] = device_id;
-        response["is_paired"] = device->client_token.has_value() && !device->client_token.value().empty();
-
-        // Check if pairing is in progress
-        std::string expires_at_str = "";
-        if (device->pin_expires_at.has_value()) {
-            auto expires_time_t = std::chrono::system_clock::to_time_t(device->pin_expires_at.value());
-            std::ostringstream oss;
-            oss << std::put_time(std::gmtime(&expires_time_t), "%Y-%m-%d %H:%M:%S");
-            expires_at_str = oss.str();
+        int wait_ms = 0;
+        uint64_t since = 0;
+        try {
+            if (!req->getParameter("wait_ms").empty()) {
+                wait_ms = std::clamp(std::stoi(req->getParameter("wait_ms")),
+                                     0, PairingSessionManager::MAX_WAIT_MS);
+            }
+            if (!req->getParameter("since").empty()) {
+                since = std::stoull(req->getParameter("since"));
+            }
+        } catch (const std::exception&) {
+            sendError(std::move(callback), k400BadRequest, "'wait_ms' and 'since' must be integers");
+            return;
         }
 
-        bool pairing_in_progress = device->pin_code.has_value() &&
-                                   !device->pin_code.value().empty() &&
-                                   !isPinExpired(expires_at_str);
-
-        response["pairing_in_progress"] = pairing_in_progress;
-
-        if (pairing_in_progress) {
-            response["pin_expires_at"] = expires_at_str;
+        if (wait_ms == 0) {
+            callback(statusResponse(device.value(), PairingSessionManager::getInstance().get(device_id)));
+            return;
         }
 
-        response["status"] = device->status;
-
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k200OK);
-        callback(resp);
+        // Long-poll: answer as soon as the session moves past `since`
+        PairingSessionManager::getInstance().waitForChange(device_id, since,
+            std::chrono::milliseconds(wait_ms),
+            [device_id, callback = std::move(callback)](std::optional<PairingSession> session) {
+            // Re-read: the device may have been paired while we waited
+            auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+            if (!device.has_value()) {
+                sendError(std::function<void(const HttpResponsePtr&)>(callback),
+                          k404NotFound, "Device not found");
+                return;
+            }
+            callback(statusResponse(device.value(), session));
+        });
 
     } catch (const std::exception& e) {
-        std::cerr << "[PairingController] Error getting pairing status: " << e.what() << std::endl;
+        LOG_ERROR("PairingController") << "Error getting pairing status: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to get pairing status");
     }
 }
@@ -295,62 +233,29 @@ std::string PairingController::generatePin() {
     return oss.str();
 }
 
-bool PairingController::isPinExpired(const std::string& expires_at) {
-    if (expires_at.empty()) {
-        return false;  // no expiry set — session still valid
-    }
+HttpResponsePtr PairingController::statusResponse(const Device& device,
+                                                  const std::optional<PairingSession>& session) {
+    Json::Value response;
+    response["success"] = true;
+    response["device_id"] = device.device_id;
+    response["is_paired"] = device.client_token.has_value() && !device.client_token.value().empty();
 
-    try {
-        std::tm tm = {};
-        std::istringstream ss(expires_at);
-        ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    bool pairing_in_progress = session.has_value() && session->isActive();
+    response["pairing_in_progress"] = pairing_in_progress;
 
-        if (ss.fail()) {
-            return true;
+    if (session.has_value()) {
+        auto json = session->toJson();
+        if (pairing_in_progress) {
+            response["pin_expires_at"] = json["expires_at"];
         }
-
-        // timegm interprets tm as UTC, matching how we stored it with gmtime
-        auto expires_time = std::chrono::system_clock::from_time_t(timegm(&tm));
-        auto now = std::chrono::system_clock::now();
-
-        return now >= expires_time;
-
-    } catch (const std::exception& e) {
-        std::cerr << "[PairingController] Error parsing expiration time: " << e.what() << std::endl;
-        return true;
-    }
-}
-
-std::shared_ptr<LightningClient> PairingController::getClient(const std::string& device_id) {
-    std::lock_guard<std::mutex> lock(clients_mutex_);
-
-    // Check if client already exists
-    auto it = clients_.find(device_id);
-    if (it != clients_.end()) {
-        return it->second;
-    }
-
-    // Get device from database
-    auto device = DeviceRepository::getInstance().getDeviceById(device_id);
-    if (!device.has_value()) {
-        return nullptr;
+        response["session"] = json;
     }
 
-    // Create new client
-    auto client = std::make_shared<LightningClient>(
-        device->ip_address,
-        device->api_key
-    );
+    response["status"] = device.status;
 
-    // Set client token if device is paired
-    if (device->client_token.has_value() && !device->client_token.value().empty()) {
-        client->setClientToken(device->client_token.value());
-    }
-
-    // Cache client
-    clients_[device_id] = client;
-
-    return client;
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k200OK);
+    return resp;
 }
 
 void PairingController::sendError(std::function<void(const HttpResponsePtr&)>&& callback,
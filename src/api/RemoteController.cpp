@@ -0,0 +1,167 @@
+#include "api/RemoteController.h"
+#include "services/KeyRepeatService.h"
+#include "services/RemoteControlService.h"
+#include "utils/Logger.h"
+#include <cmath>
+
+namespace hms_firetv {
+
+namespace {
+
+// Per-connection state; only touched from the connection's IO thread
+struct RemoteSession {
+    std::string device_id;
+    bool holding = false;
+};
+
+} // namespace
+
+void RemoteController::handleNewConnection(const HttpRequestPtr& req,
+                                           const WebSocketConnectionPtr& conn) {
+    auto session = std::make_shared<RemoteSession>();
+    conn->setContext(session);
+
+    Json::Value hello;
+    hello["t"] = "hello";
+    hello["keys"] = Json::arrayValue;
+    for (const auto& name : RemoteControlService::keyNames()) {
+        hello["keys"].append(name);
+    }
+    hello["max_queued"] = static_cast<Json::UInt64>(RemoteControlService::getInstance().options().max_queued);
+    sendJson(conn, hello);
+
+    std::string device_id = req->getParameter("device");
+    if (!device_id.empty()) {
+        handleNewMessage(conn, "@" + device_id, WebSocketMessageType::Text);
+    }
+}
+
+void RemoteController::handleNewMessage(const WebSocketConnectionPtr& conn,
+                                        std::string&& message,
+                                        const WebSocketMessageType& type) {
+    if (type != WebSocketMessageType::Text && type != WebSocketMessageType::Binary) {
+        return;   // Ping/pong/close are handled by Drogon
+    }
+    auto session = conn->getContext<RemoteSession>();
+    if (!session) {
+        return;
+    }
+
+    std::string error;
+    auto parsed = RemoteControlService::parse(message, type == WebSocketMessageType::Binary, error);
+    if (!parsed) {
+        sendError(conn, 0, error);
+        return;
+    }
+    auto& remote = RemoteControlService::getInstance();
+
+    if (parsed->type == RemoteControlService::Message::Type::Select) {
+        if (session->holding) {
+            KeyRepeatService::getInstance().release(session->device_id);
+            session->holding = false;
+        }
+        bool found = remote.device(parsed->device_id).has_value();
+        if (found) {
+            session->device_id = parsed->device_id;
+        }
+        Json::Value reply;
+        reply["t"] = "device";
+        reply["id"] = parsed->device_id;
+        reply["ok"] = found;
+        sendJson(conn, reply);
+        return;
+    }
+
+    if (session->device_id.empty()) {
+        sendError(conn, parsed->n, "No device selected");
+        return;
+    }
+    uint32_t n = parsed->n;
+
+    switch (parsed->type) {
+        case RemoteControlService::Message::Type::Press: {
+            std::weak_ptr<WebSocketConnection> weak_conn = conn;
+            remote.press(session->device_id, *parsed->key,
+                [weak_conn, n](const RemoteControlService::Ack& result) {
+                    auto connection = weak_conn.lock();
+                    if (!connection || !connection->connected()) {
+                        return;
+                    }
+                    Json::Value ack;
+                    ack["t"] = "ack";
+                    ack["n"] = n;
+                    ack["ok"] = result.success;
+                    ack["ms"] = std::round(static_cast<double>(result.total.count()) / 10.0) / 100.0;
+                    ack["timing"] = result.timing.toJson();
+                    if (!result.error.empty()) {
+                        ack["error"] = result.error;
+                    }
+                    sendJson(connection, ack);
+                });
+            return;
+        }
+
+        case RemoteControlService::Message::Type::Hold: {
+            auto device = remote.device(session->device_id);
+            if (!device) {
+                sendError(conn, n, "Device not found");
+                return;
+            }
+            auto state = KeyRepeatService::getInstance().hold(device.value(), *parsed->key);
+            session->holding = true;
+
+            Json::Value ack;
+            ack["t"] = "ack";
+            ack["n"] = n;
+            ack["ok"] = true;
+            ack["hold"] = KeyRepeatService::holdStateName(state);
+            sendJson(conn, ack);
+            return;
+        }
+
+        case RemoteControlService::Message::Type::Release: {
+            auto summary = KeyRepeatService::getInstance().release(session->device_id);
+            session->holding = false;
+
+            Json::Value ack;
+            ack["t"] = "ack";
+            ack["n"] = n;
+            ack["ok"] = true;
+            ack["released"] = summary.has_value();
+            if (summary.has_value()) {
+                ack["repeats"] = static_cast<Json::UInt64>(summary->repeats);
+            }
+            sendJson(conn, ack);
+            return;
+        }
+
+        case RemoteControlService::Message::Type::Select:
+            return;   // Handled above
+    }
+}
+
+void RemoteController::handleConnectionClosed(const WebSocketConnectionPtr& conn) {
+    auto session = conn->getContext<RemoteSession>();
+    if (session && session->holding) {
+        // Do not leave the TV scrolling until the watchdog notices
+        KeyRepeatService::getInstance().release(session->device_id);
+    }
+    conn->clearContext();
+}
+
+void RemoteController::sendJson(const WebSocketConnectionPtr& conn, const Json::Value& json) {
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    conn->send(Json::writeString(writer, json));
+}
+
+void RemoteController::sendError(const WebSocketConnectionPtr& conn, uint32_t n, const std::string& error) {
+    Json::Value reply;
+    reply["t"] = "ack";
+    reply["n"] = n;
+    reply["ok"] = false;
+    reply["error"] = error;
+    sendJson(conn, reply);
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,112 @@
+#include "api/StaticAssetServer.h"
+#include <drogon/IOThreadStorage.h>
+#include <atomic>
+#include <vector>
+
+namespace hms_firetv {
+
+namespace {
+
+// Prebuilt responses, indexed by Variant::id
+struct ThreadResponses {
+    std::vector<HttpResponsePtr> ok;
+    std::vector<HttpResponsePtr> not_modified;
+};
+
+std::shared_ptr<const StaticAssets> assets_;
+std::unique_ptr<IOThreadStorage<ThreadResponses>> responses_;
+
+std::atomic<uint64_t> served_identity_{0};
+std::atomic<uint64_t> served_gzip_{0};
+std::atomic<uint64_t> served_brotli_{0};
+std::atomic<uint64_t> served_not_modified_{0};
+
+HttpResponsePtr build(const StaticAssets::Asset& asset, const StaticAssets::Variant& variant, bool not_modified) {
+    auto resp = HttpResponse::newHttpResponse();
+    if (not_modified) {
+        resp->setStatusCode(k304NotModified);
+    } else {
+        resp->setStatusCode(k200OK);
+        resp->setContentTypeString(asset.content_type);
+        resp->setBody(variant.body);
+        if (variant.encoding != StaticAssets::Encoding::Identity) {
+            resp->addHeader("Content-Encoding", StaticAssets::encodingName(variant.encoding));
+        }
+    }
+    resp->addHeader("ETag", variant.etag);
+    resp->addHeader("Cache-Control", asset.cache_control);
+    if (asset.variants.size() > 1) {
+        resp->addHeader("Vary", "Accept-Encoding");
+    }
+    resp->setExpiredTime(0);   // Drogon keeps the rendered buffer and reuses it
+    return resp;
+}
+
+} // namespace
+
+void StaticAssetServer::install(std::shared_ptr<const StaticAssets> assets) {
+    assets_ = std::move(assets);
+    responses_ = std::make_unique<IOThreadStorage<ThreadResponses>>();
+
+    app().registerPreRoutingAdvice(
+        [](const HttpRequestPtr& req, AdviceCallback&& acb, AdviceChainCallback&& accb) {
+            if (req->method() == Get || req->method() == Head) {
+                if (const auto* asset = assets_->find(req->path())) {
+                    acb(respond(req, *asset));
+                    return;
+                }
+            }
+            accb();
+        });
+}
+
+HttpResponsePtr StaticAssetServer::respond(const HttpRequestPtr& req, const StaticAssets::Asset& asset) {
+    const auto& variant = StaticAssets::select(asset, req->getHeader("accept-encoding"));
+    bool not_modified = StaticAssets::notModified(variant, req->getHeader("if-none-match"));
+
+    if (not_modified) {
+        served_not_modified_.fetch_add(1, std::memory_order_relaxed);
+    } else if (variant.encoding == StaticAssets::Encoding::Brotli) {
+        served_brotli_.fetch_add(1, std::memory_order_relaxed);
+    } else if (variant.encoding == StaticAssets::Encoding::Gzip) {
+        served_gzip_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        served_identity_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto& thread = responses_->getThreadData();
+    auto& slots = not_modified ? thread.not_modified : thread.ok;
+    if (slots.size() < assets_->variantCount()) {
+        slots.resize(assets_->variantCount());
+    }
+    auto& resp = slots[variant.id];
+    if (!resp) {
+        resp = build(asset, variant, not_modified);
+    }
+    return resp;
+}
+
+HttpResponsePtr StaticAssetServer::spaFallback(const HttpRequestPtr& req) {
+    const auto* index = assets_ ? assets_->index() : nullptr;
+    return index ? respond(req, *index) : nullptr;
+}
+
+Json::Value StaticAssetServer::stats() {
+    Json::Value json;
+    if (!assets_) {
+        json["files"] = 0;
+        return json;
+    }
+    using Encoding = StaticAssets::Encoding;
+    json["files"] = static_cast<Json::UInt64>(assets_->fileCount());
+    for (auto encoding : {Encoding::Identity, Encoding::Gzip, Encoding::Brotli}) {
+        json["bytes"][StaticAssets::encodingName(encoding)] = static_cast<Json::UInt64>(assets_->bytes(encoding));
+    }
+    json["served"]["identity"] = static_cast<Json::UInt64>(served_identity_.load(std::memory_order_relaxed));
+    json["served"]["gzip"] = static_cast<Json::UInt64>(served_gzip_.load(std::memory_order_relaxed));
+    json["served"]["br"] = static_cast<Json::UInt64>(served_brotli_.load(std::memory_order_relaxed));
+    json["not_modified"] = static_cast<Json::UInt64>(served_not_modified_.load(std::memory_order_relaxed));
+    return json;
+}
+
+} // namespace hms_firetv
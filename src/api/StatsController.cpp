@@ -1,5 +1,6 @@
 #include "api/StatsController.h"
-#include <iostream>
+#include "services/DeviceSloTracker.h"
+#include "utils/Logger.h"
 
 namespace hms_firetv {
 
@@ -15,7 +16,7 @@ void StatsController::getOverallStats(const HttpRequestPtr& req,
         resp->setStatusCode(k200OK);
         callback(resp);
     } catch (const std::exception& e) {
-        std::cerr << "[StatsController] getOverallStats error: " << e.what() << std::endl;
+        LOG_ERROR("StatsController") << "getOverallStats error: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to get statistics");
     }
 }
@@ -27,13 +28,24 @@ void StatsController::getDeviceStats(const HttpRequestPtr& req,
         Json::Value response;
         response["success"] = true;
         auto devices = db_->getAllDeviceStats();
+
+        // Rolling latency/error window from memory; "degraded" lists devices breaching their SLO
+        auto& slo = DeviceSloTracker::getInstance();
+        response["degraded"] = Json::arrayValue;
+        for (auto& device : devices) {
+            auto snapshot = slo.snapshot(device["device_id"].asString());
+            device["slo"] = snapshot.toJson();
+            if (snapshot.state == DeviceSloTracker::State::Degraded) {
+                response["degraded"].append(device["slo"]);
+            }
+        }
         response["count"] = static_cast<int>(devices.size());
         response["devices"] = devices;
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k200OK);
         callback(resp);
     } catch (const std::exception& e) {
-        std::cerr << "[StatsController] getDeviceStats error: " << e.what() << std::endl;
+        LOG_ERROR("StatsController") << "getDeviceStats error: " << e.what();
         sendError(std::move(callback), k500InternalServerError, "Failed to get device statistics");
     }
 }
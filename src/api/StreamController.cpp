@@ -0,0 +1,307 @@
+#include "api/StreamController.h"
+#include "services/EventBus.h"
+#include "utils/ConfigManager.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace hms_firetv {
+
+namespace {
+
+std::atomic<int> g_ws_clients{0};
+std::atomic<int> g_sse_clients{0};
+
+int maxClients() {
+    static const int max_clients = std::max(1, ConfigManager::getEnvInt("STREAM_MAX_CLIENTS", 64));
+    return max_clients;
+}
+
+bool atCapacity() {
+    return g_ws_clients.load() + g_sse_clients.load() >= maxClients();
+}
+
+// ?since=N or Last-Event-ID; nullopt for a fresh client
+std::optional<uint64_t> parseSince(const std::string& value) {
+    if (value.empty()) {
+        return std::nullopt;
+    }
+    char* end = nullptr;
+    unsigned long long seq = std::strtoull(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0') {
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(seq);
+}
+
+/**
+ * One stream connection, whatever the transport
+ *
+ * Events published while the greeting is being prepared are held back and
+ * sent after it, so the client always sees hello, replay, live - in order
+ * and without duplicates.
+ */
+class StreamSession : public std::enable_shared_from_this<StreamSession> {
+public:
+    // Sends one event; false once the peer is gone
+    using Writer = std::function<bool(uint64_t seq, const std::string& payload)>;
+
+    explicit StreamSession(Writer writer) : writer_(std::move(writer)) {}
+
+    void open(std::optional<uint64_t> since) {
+        auto& bus = EventBus::getInstance();
+        std::weak_ptr<StreamSession> weak = shared_from_this();
+        subscription_ = bus.subscribe([weak](const EventBus::Event& event) {
+            if (auto session = weak.lock()) {
+                session->onEvent(event);
+            }
+        });
+
+        // Outside mutex_: the bus holds its own lock while calling onEvent
+        uint64_t head = bus.lastSeq();
+        std::optional<std::vector<EventBus::Event>> missed;
+        if (since.has_value()) {
+            missed = bus.since(since.value());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Json::Value hello;
+            hello["t"] = "hello";
+            hello["seq"] = static_cast<Json::UInt64>(missed ? since.value() : head);
+            hello["resync"] = !missed.has_value();
+            Json::StreamWriterBuilder writer;
+            writer["indentation"] = "";
+            if (!writer_(hello["seq"].asUInt64(), Json::writeString(writer, hello))) {
+                closed_ = true;
+            }
+            last_sent_ = hello["seq"].asUInt64();
+
+            if (missed) {
+                for (const auto& event : missed.value()) {
+                    deliver(event);
+                }
+            }
+            for (const auto& event : pending_) {
+                deliver(event);
+            }
+            pending_.clear();
+            ready_ = true;
+        }
+        if (closed_) {
+            close();
+        }
+    }
+
+    void close() {
+        closed_ = true;
+        uint64_t id = subscription_.exchange(0);
+        if (id != 0) {
+            EventBus::getInstance().unsubscribe(id);
+        }
+    }
+
+    bool closed() const { return closed_; }
+
+private:
+    void onEvent(const EventBus::Event& event) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) {
+                return;
+            }
+            if (!ready_) {
+                pending_.push_back(event);
+                return;
+            }
+            deliver(event);
+        }
+        if (closed_) {
+            close();
+        }
+    }
+
+    // Requires mutex_ held
+    void deliver(const EventBus::Event& event) {
+        if (closed_ || event.seq <= last_sent_) {
+            return;
+        }
+        if (!writer_(event.seq, *event.payload)) {
+            closed_ = true;
+            return;
+        }
+        last_sent_ = event.seq;
+    }
+
+    Writer writer_;
+    std::mutex mutex_;
+    bool ready_ = false;
+    uint64_t last_sent_ = 0;
+    std::vector<EventBus::Event> pending_;
+    std::atomic<bool> closed_{false};
+    std::atomic<uint64_t> subscription_{0};
+};
+
+// ============================================================================
+// SSE CLIENTS (swept by the keepalive timer)
+// ============================================================================
+
+struct SseClient {
+    std::mutex mutex;
+    ResponseStreamPtr stream;
+    std::shared_ptr<StreamSession> session;
+
+    bool write(const std::string& frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!stream) {
+            return false;
+        }
+        if (!stream->send(frame)) {
+            stream->close();
+            stream.reset();
+            return false;
+        }
+        return true;
+    }
+};
+
+std::mutex g_sse_mutex;
+std::vector<std::shared_ptr<SseClient>> g_sse;
+
+// Comment lines keep proxies and the idle timeout from closing a quiet
+// stream, and are how disconnected clients are noticed
+void sweepSseClients() {
+    std::vector<std::shared_ptr<SseClient>> clients;
+    {
+        std::lock_guard<std::mutex> lock(g_sse_mutex);
+        clients = g_sse;
+    }
+
+    std::vector<std::shared_ptr<SseClient>> gone;
+    for (const auto& client : clients) {
+        if (client->session->closed() || !client->write(": keepalive\n\n")) {
+            gone.push_back(client);
+        }
+    }
+    if (gone.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_sse_mutex);
+    for (const auto& client : gone) {
+        client->session->close();
+        g_sse.erase(std::remove(g_sse.begin(), g_sse.end(), client), g_sse.end());
+        g_sse_clients--;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// WEBSOCKET
+// ============================================================================
+
+void StreamController::handleNewConnection(const HttpRequestPtr& req,
+                                           const WebSocketConnectionPtr& conn) {
+    if (atCapacity()) {
+        LOG_WARN("StreamController") << "Rejecting stream client: " << maxClients() << " connected";
+        conn->shutdown(CloseCode::kViolation, "Too many stream clients");
+        return;
+    }
+
+    std::weak_ptr<WebSocketConnection> weak_conn = conn;
+    auto session = std::make_shared<StreamSession>([weak_conn](uint64_t, const std::string& payload) {
+        auto connection = weak_conn.lock();
+        if (!connection || !connection->connected()) {
+            return false;
+        }
+        connection->send(payload);
+        return true;
+    });
+    conn->setContext(session);
+    conn->setPingMessage("", std::chrono::seconds(PING_INTERVAL_SECONDS));
+    g_ws_clients++;
+
+    session->open(parseSince(req->getParameter("since")));
+    LOG_DEBUG("StreamController") << "WebSocket client connected from " << req->peerAddr().toIp();
+}
+
+void StreamController::handleNewMessage(const WebSocketConnectionPtr&,
+                                        std::string&&,
+                                        const WebSocketMessageType&) {
+    // Server-to-client only; pings are answered by Drogon
+}
+
+void StreamController::handleConnectionClosed(const WebSocketConnectionPtr& conn) {
+    auto session = conn->getContext<StreamSession>();
+    if (!session) {
+        return;   // Rejected at capacity
+    }
+    session->close();
+    conn->clearContext();
+    g_ws_clients--;
+}
+
+Json::Value StreamController::stats() {
+    Json::Value json;
+    json["websocket_clients"] = g_ws_clients.load();
+    json["sse_clients"] = g_sse_clients.load();
+    json["max_clients"] = maxClients();
+    json["bus"] = EventBus::getInstance().stats();
+    return json;
+}
+
+// ============================================================================
+// SERVER-SENT EVENTS
+// ============================================================================
+
+void StreamSseController::stream(const HttpRequestPtr& req,
+                                 std::function<void(const HttpResponsePtr&)>&& callback) {
+    if (atCapacity()) {
+        Json::Value error;
+        error["success"] = false;
+        error["error"] = "Too many stream clients";
+        auto resp = HttpResponse::newHttpJsonResponse(error);
+        resp->setStatusCode(k503ServiceUnavailable);
+        callback(resp);
+        return;
+    }
+
+    static std::once_flag keepalive_flag;
+    std::call_once(keepalive_flag, [] {
+        app().getLoop()->runEvery(KEEPALIVE_SECONDS, [] { sweepSseClients(); });
+    });
+
+    std::string last_event_id = req->getHeader("last-event-id");
+    auto since = parseSince(last_event_id.empty() ? req->getParameter("since") : last_event_id);
+
+    // disableKickoffTimeout: the stream is meant to stay open
+    auto resp = HttpResponse::newAsyncStreamResponse(
+        [since](ResponseStreamPtr stream) {
+            auto client = std::make_shared<SseClient>();
+            client->stream = std::move(stream);
+            std::weak_ptr<SseClient> weak_client = client;
+            client->session = std::make_shared<StreamSession>(
+                [weak_client](uint64_t seq, const std::string& payload) {
+                    auto sse = weak_client.lock();
+                    return sse && sse->write("id: " + std::to_string(seq) + "\ndata: " + payload + "\n\n");
+                });
+            {
+                std::lock_guard<std::mutex> lock(g_sse_mutex);
+                g_sse.push_back(client);
+                g_sse_clients++;
+            }
+            client->session->open(since);
+        },
+        true);
+    resp->setContentTypeString("text/event-stream");
+    resp->addHeader("Cache-Control", "no-cache");
+    resp->addHeader("X-Accel-Buffering", "no");   // nginx: do not buffer the stream
+    callback(resp);
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,140 @@
+#include "clients/AsyncLightningClient.h"
+#include "services/DeviceSloTracker.h"
+#include "services/EventBus.h"
+#include "utils/Metrics.h"
+#include "utils/Logger.h"
+
+using namespace drogon;
+
+namespace hms_firetv {
+
+ShardedLRUCache<std::string, HttpClientPtr> AsyncLightningClient::http_clients_{100, 3600, 8};
+
+namespace {
+
+std::string describe(ReqResult result) {
+    switch (result) {
+        case ReqResult::Timeout:          return "Timeout";
+        case ReqResult::NetworkFailure:   return "Network failure";
+        case ReqResult::BadResponse:      return "Bad response";
+        case ReqResult::BadServerAddress: return "Bad server address";
+        case ReqResult::HandshakeError:   return "SSL handshake error";
+        default:                          return "Unknown error";
+    }
+}
+
+} // namespace
+
+void AsyncLightningClient::post(const Device& device,
+                                const std::string& path,
+                                const std::string& json_body,
+                                Callback callback,
+                                double timeout_seconds) {
+    auto req = HttpRequest::newHttpRequest();
+    req->setMethod(Post);
+    req->setPath(path);
+    req->addHeader("X-Api-Key", device.api_key);
+    if (device.client_token.has_value() && !device.client_token->empty()) {
+        req->addHeader("X-Client-Token", device.client_token.value());
+    }
+    req->setContentTypeCode(CT_APPLICATION_JSON);
+    if (!json_body.empty()) {
+        req->setBody(json_body);
+    }
+
+    send("https://" + device.ip_address + ":8080", req, timeout_seconds, std::move(callback));
+}
+
+void AsyncLightningClient::probe(const Device& device, std::function<void(bool)> callback,
+                                 double timeout_seconds) {
+    auto req = HttpRequest::newHttpRequest();
+    req->setMethod(Get);
+    req->setPath("/v1/FireTV");
+    req->addHeader("X-Api-Key", device.api_key);
+
+    send("https://" + device.ip_address + ":8080", req, timeout_seconds,
+        [device_id = device.device_id, callback = std::move(callback)](CommandResult result) {
+            bool up = result.status_code > 0;  // Any response means the API is up
+            DeviceSloTracker::getInstance().recordProbe(device_id, up,
+                                                        std::chrono::milliseconds(result.response_time_ms));
+            Json::Value state;
+            state["reachable"] = up;
+            EventBus::getInstance().deviceState(device_id, state);
+            callback(up);
+        });
+}
+
+void AsyncLightningClient::wake(const Device& device, Callback callback, double timeout_seconds) {
+    auto req = HttpRequest::newHttpRequest();
+    req->setMethod(Post);
+    req->setPath("/apps/FireTVRemote");
+
+    send("http://" + device.ip_address + ":8009", req, timeout_seconds,
+        [callback = std::move(callback)](CommandResult result) {
+            // 404 still means the DIAL server answered, i.e. the TV is reachable
+            result.success = result.success || result.status_code == 404;
+            Metrics::recordWake(result.success);
+            callback(std::move(result));
+        });
+}
+
+void AsyncLightningClient::startSweeper(std::chrono::milliseconds interval) {
+    http_clients_.startSweeper(interval);
+}
+
+void AsyncLightningClient::stopSweeper() {
+    http_clients_.stopSweeper();
+}
+
+// ============================================================================
+// INTERNALS
+// ============================================================================
+
+HttpClientPtr AsyncLightningClient::getHttpClient(const std::string& base_url) {
+    auto cached = http_clients_.get(base_url);
+    Metrics::recordCacheLookup("http_clients", cached.has_value());
+    if (cached.has_value()) {
+        return cached.value();
+    }
+
+    // Parameters: hostString, loop, useOldTLS, validateCert (self-signed, so false)
+    // Keyed by URL, so an IP change simply starts a new connection
+    auto client = HttpClient::newHttpClient(base_url, nullptr, false, false);
+    client->enableCookies();
+    http_clients_.put(base_url, client);
+    return client;
+}
+
+void AsyncLightningClient::send(const std::string& base_url,
+                                const HttpRequestPtr& req,
+                                double timeout_seconds,
+                                Callback callback) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    getHttpClient(base_url)->sendRequest(req,
+        [callback = std::move(callback), start_time, base_url]
+        (ReqResult req_result, const HttpResponsePtr& response) {
+
+        CommandResult result;
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_time);
+        result.response_time_ms = static_cast<int>(elapsed.count() / 1000);
+        result.timing.round_trip_us = elapsed.count();   // HttpClient reports no phases
+
+        if (req_result == ReqResult::Ok && response) {
+            result.status_code = static_cast<int>(response->getStatusCode());
+            result.success = (result.status_code >= 200 && result.status_code < 300);
+            if (!result.success) {
+                result.error = "HTTP " + std::to_string(result.status_code);
+            }
+        } else {
+            result.error = describe(req_result);
+            LOG_ERROR("AsyncLightningClient") << "Request to " << base_url << " failed: "
+                                              << result.error.value() << " (" << result.response_time_ms << "ms)";
+        }
+
+        callback(std::move(result));
+    }, timeout_seconds);
+}
+
+} // namespace hms_firetv
@@ -1,11 +1,56 @@
 #include "clients/LightningClient.h"
-#include <iostream>
+#include "utils/Metrics.h"
+#include "utils/Logger.h"
+#include "utils/Trace.h"
+#include <algorithm>
 #include <sstream>
 #include <chrono>
 #include <json/json.h>
 
 namespace hms_firetv {
 
+// ============================================================================
+// TIMING
+// ============================================================================
+
+bool CommandTiming::measured() const {
+    return queue_us >= 0 || wake_us >= 0 || transfer_us >= 0 || round_trip_us >= 0;
+}
+
+void CommandTiming::add(const CommandTiming& other) {
+    auto sum = [](int64_t& into, int64_t value) {
+        if (value >= 0) {
+            into = std::max<int64_t>(into, 0) + value;
+        }
+    };
+    sum(queue_us, other.queue_us);
+    sum(wake_us, other.wake_us);
+    sum(dns_us, other.dns_us);
+    sum(connect_us, other.connect_us);
+    sum(tls_us, other.tls_us);
+    sum(ttfb_us, other.ttfb_us);
+    sum(transfer_us, other.transfer_us);
+    sum(round_trip_us, other.round_trip_us);
+}
+
+Json::Value CommandTiming::toJson() const {
+    Json::Value json(Json::objectValue);
+    auto put = [&json](const char* key, int64_t us) {
+        if (us >= 0) {
+            json[key] = static_cast<double>(us / 10) / 100.0;
+        }
+    };
+    put("queue_ms", queue_us);
+    put("wake_ms", wake_us);
+    put("dns_ms", dns_us);
+    put("connect_ms", connect_us);
+    put("tls_ms", tls_us);
+    put("ttfb_ms", ttfb_us);
+    put("transfer_ms", transfer_us);
+    put("round_trip_ms", round_trip_us);
+    return json;
+}
+
 // ============================================================================
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================================================
@@ -22,10 +67,10 @@ LightningClient::LightningClient(const std::string& ip_address,
     // Initialize CURL handle
     curl_ = curl_easy_init();
     if (!curl_) {
-        std::cerr << "[LightningClient] Failed to initialize CURL" << std::endl;
+        LOG_ERROR("LightningClient") << "Failed to initialize CURL";
     }
 
-    std::cout << "[LightningClient] Initialized for device at " << ip_address << std::endl;
+    LOG_DEBUG("LightningClient") << "Initialized for device at " << ip_address;
 }
 
 LightningClient::~LightningClient() {
@@ -39,7 +84,7 @@ LightningClient::~LightningClient() {
 // ============================================================================
 
 bool LightningClient::wakeDevice() {
-    std::cout << "[LightningClient] Waking device " << ip_address_ << std::endl;
+    LOG_INFO("LightningClient") << "Waking device " << ip_address_;
 
     auto result = executePost(wake_url_, "", WAKE_TIMEOUT, false);
 
@@ -47,19 +92,20 @@ bool LightningClient::wakeDevice() {
     bool success = result.status_code == 200 ||
                    result.status_code == 201 ||
                    result.status_code == 204;
+    Metrics::recordWake(success);
 
     if (success) {
-        std::cout << "[LightningClient] Device wake successful ("
-                  << result.response_time_ms << "ms)" << std::endl;
+        LOG_INFO("LightningClient") << "Device wake successful ("
+                                    << result.response_time_ms << "ms)";
     } else {
-        std::cout << "[LightningClient] Device wake failed or already awake" << std::endl;
+        LOG_INFO("LightningClient") << "Device wake failed or already awake";
     }
 
     return success;
 }
 
 bool LightningClient::displayPin(const std::string& friendly_name) {
-    std::cout << "[LightningClient] Displaying PIN on " << ip_address_ << std::endl;
+    LOG_INFO("LightningClient") << "Displaying PIN on " << ip_address_;
 
     Json::Value payload;
     payload["friendlyName"] = friendly_name;
@@ -71,22 +117,21 @@ bool LightningClient::displayPin(const std::string& friendly_name) {
     auto result = executePost(url, json_body, COMMAND_TIMEOUT, false);
 
     if (result.success) {
-        std::cout << "[LightningClient] PIN display triggered on " << ip_address_
-                  << " HTTP " << result.status_code
-                  << " (" << result.response_time_ms << "ms)" << std::endl;
+        LOG_INFO("LightningClient") << "PIN display triggered on " << ip_address_
+                                    << " HTTP " << result.status_code
+                                    << " (" << result.response_time_ms << "ms)";
         return true;
     }
 
-    std::cerr << "[LightningClient] Failed to display PIN on " << ip_address_
-              << " — HTTP " << result.status_code
-              << (result.error.has_value() ? " (" + result.error.value() + ")" : "")
-              << std::endl;
+    LOG_ERROR("LightningClient") << "Failed to display PIN on " << ip_address_
+                                 << " — HTTP " << result.status_code
+                                 << (result.error.has_value() ? " (" + result.error.value() + ")" : "");
     return false;
 }
 
 std::string LightningClient::verifyPin(const std::string& pin) {
-    std::cout << "[LightningClient] Verifying PIN " << pin
-              << " on " << ip_address_ << std::endl;
+    LOG_INFO("LightningClient") << "Verifying PIN " << pin
+                                << " on " << ip_address_;
 
     // Build JSON payload
     Json::Value payload;
@@ -104,20 +149,19 @@ std::string LightningClient::verifyPin(const std::string& pin) {
             std::string token = result.response_body["description"].asString();
             if (!token.empty() && token != "OK") {
                 client_token_ = token;
-                std::cout << "[LightningClient] PIN verified, token: " << token
-                          << " (" << result.response_time_ms << "ms)" << std::endl;
+                LOG_INFO("LightningClient") << "PIN verified, token: " << token
+                                            << " (" << result.response_time_ms << "ms)";
                 return token;
             }
             // "OK" means TV accepted the PIN but token isn't ready yet
-            std::cout << "[LightningClient] PIN accepted, token pending..." << std::endl;
+            LOG_INFO("LightningClient") << "PIN accepted, token pending...";
         } else {
-            std::cerr << "[LightningClient] PIN verify response missing 'description' field" << std::endl;
+            LOG_ERROR("LightningClient") << "PIN verify response missing 'description' field";
         }
     } else {
-        std::cerr << "[LightningClient] Failed to verify PIN on " << ip_address_
-                  << " — HTTP " << result.status_code
-                  << (result.error.has_value() ? " (" + result.error.value() + ")" : "")
-                  << std::endl;
+        LOG_ERROR("LightningClient") << "Failed to verify PIN on " << ip_address_
+                                     << " — HTTP " << result.status_code
+                                     << (result.error.has_value() ? " (" + result.error.value() + ")" : "");
     }
 
     return "";
@@ -146,11 +190,11 @@ CommandResult LightningClient::sendMediaCommand(const std::string& action,
     auto result = executePost(url);
 
     if (result.success) {
-        std::cout << "[LightningClient] Media command '" << action
-                  << "' sent (" << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("LightningClient") << "Media command '" << action
+                                     << "' sent (" << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[LightningClient] Media command '" << action
-                  << "' failed: " << result.status_code << std::endl;
+        LOG_ERROR("LightningClient") << "Media command '" << action
+                                     << "' failed: " << result.status_code;
     }
 
     return result;
@@ -182,11 +226,11 @@ CommandResult LightningClient::sendNavigationCommand(const std::string& action)
     auto result = executePost(url);
 
     if (result.success) {
-        std::cout << "[LightningClient] Navigation command '" << action
-                  << "' sent (" << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("LightningClient") << "Navigation command '" << action
+                                     << "' sent (" << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[LightningClient] Navigation command '" << action
-                  << "' failed: " << result.status_code << std::endl;
+        LOG_ERROR("LightningClient") << "Navigation command '" << action
+                                     << "' failed: " << result.status_code;
     }
 
     return result;
@@ -238,11 +282,11 @@ CommandResult LightningClient::launchApp(const std::string& package_name) {
     auto result = executePost(url);
 
     if (result.success) {
-        std::cout << "[LightningClient] Launched app '" << package_name
-                  << "' (" << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("LightningClient") << "Launched app '" << package_name
+                                     << "' (" << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[LightningClient] App launch failed: "
-                  << result.status_code << std::endl;
+        LOG_ERROR("LightningClient") << "App launch failed: "
+                                     << result.status_code;
     }
 
     return result;
@@ -264,11 +308,26 @@ CommandResult LightningClient::sendKeyboardInput(const std::string& text) {
     auto result = executePost(url, json_body);
 
     if (result.success) {
-        std::cout << "[LightningClient] Keyboard input sent ("
-                  << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("LightningClient") << "Keyboard input sent ("
+                                     << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[LightningClient] Keyboard input failed: "
-                  << result.status_code << std::endl;
+        LOG_ERROR("LightningClient") << "Keyboard input failed: "
+                                     << result.status_code;
+    }
+
+    return result;
+}
+
+// ============================================================================
+// PRECOMPILED REQUESTS
+// ============================================================================
+
+CommandResult LightningClient::sendRequest(const std::string& path, const std::string& json_body) {
+    auto result = executePost(base_url_ + path, json_body);
+
+    if (!result.success) {
+        LOG_ERROR("LightningClient") << "Request '" << path
+                                     << "' failed: " << result.status_code;
     }
 
     return result;
@@ -328,11 +387,15 @@ struct curl_slist* LightningClient::buildHeaders(bool include_token) {
 CommandResult LightningClient::executeGet(const std::string& url, long timeout_seconds) {
     CommandResult result;
     auto start_time = std::chrono::steady_clock::now();
+    last_timing_ = CommandTiming();
 
     if (!curl_) {
         result.error = "CURL not initialized";
         return result;
     }
+    if (rejectIfExpired(result)) {
+        return result;
+    }
 
     std::string response_body;
     struct curl_slist* headers = buildHeaders(true);
@@ -344,13 +407,17 @@ CommandResult LightningClient::executeGet(const std::string& url, long timeout_s
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_body);
-    curl_easy_setopt(curl_, CURLOPT_TIMEOUT, timeout_seconds);
+    curl_easy_setopt(curl_, CURLOPT_TIMEOUT_MS, deadline_.capMs(timeout_seconds * 1000L));
     curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L);  // Disable SSL verification (self-signed cert)
     curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYHOST, 0L);
     curl_easy_setopt(curl_, CURLOPT_FOLLOWLOCATION, 1L);  // Follow redirects
 
     // Execute request
+    auto transfer_start = std::chrono::steady_clock::now();
     CURLcode res = curl_easy_perform(curl_);
+    traceTransfer(url, transfer_start, res);
+    readTiming(result.timing);
+    last_timing_ = result.timing;
 
     // Calculate response time
     auto end_time = std::chrono::steady_clock::now();
@@ -368,7 +435,12 @@ CommandResult LightningClient::executeGet(const std::string& url, long timeout_s
 
     // Check for errors
     if (res != CURLE_OK) {
-        result.error = curl_easy_strerror(res);
+        if (res == CURLE_OPERATION_TIMEDOUT && deadline_.expired()) {
+            Deadline::recordCancelled(Deadline::Stage::Transport);
+            result.error = Deadline::EXCEEDED;
+        } else {
+            result.error = curl_easy_strerror(res);
+        }
         result.success = false;
         return result;
     }
@@ -388,11 +460,15 @@ CommandResult LightningClient::executePost(const std::string& url,
                                              bool include_token) {
     CommandResult result;
     auto start_time = std::chrono::steady_clock::now();
+    last_timing_ = CommandTiming();
 
     if (!curl_) {
         result.error = "CURL not initialized";
         return result;
     }
+    if (rejectIfExpired(result)) {
+        return result;
+    }
 
     std::string response_body;
     struct curl_slist* headers = buildHeaders(include_token);
@@ -404,7 +480,7 @@ CommandResult LightningClient::executePost(const std::string& url,
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_body);
-    curl_easy_setopt(curl_, CURLOPT_TIMEOUT, timeout_seconds);
+    curl_easy_setopt(curl_, CURLOPT_TIMEOUT_MS, deadline_.capMs(timeout_seconds * 1000L));
     curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L);  // Disable SSL verification (self-signed cert)
     curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYHOST, 0L);
     curl_easy_setopt(curl_, CURLOPT_FOLLOWLOCATION, 1L);  // Follow redirects
@@ -417,7 +493,11 @@ CommandResult LightningClient::executePost(const std::string& url,
     }
 
     // Execute request
+    auto transfer_start = std::chrono::steady_clock::now();
     CURLcode res = curl_easy_perform(curl_);
+    traceTransfer(url, transfer_start, res);
+    readTiming(result.timing);
+    last_timing_ = result.timing;
 
     // Calculate response time
     auto end_time = std::chrono::steady_clock::now();
@@ -435,7 +515,12 @@ CommandResult LightningClient::executePost(const std::string& url,
 
     // Check for errors
     if (res != CURLE_OK) {
-        result.error = curl_easy_strerror(res);
+        if (res == CURLE_OPERATION_TIMEDOUT && deadline_.expired()) {
+            Deadline::recordCancelled(Deadline::Stage::Transport);
+            result.error = Deadline::EXCEEDED;
+        } else {
+            result.error = curl_easy_strerror(res);
+        }
         result.success = false;
         return result;
     }
@@ -449,6 +534,84 @@ CommandResult LightningClient::executePost(const std::string& url,
     return result;
 }
 
+void LightningClient::traceTransfer(const std::string& url,
+                                    std::chrono::steady_clock::time_point start,
+                                    CURLcode res) const {
+    Trace* trace = Trace::current();
+    if (!trace) {
+        return;
+    }
+
+    // curl's phase timestamps are cumulative microseconds from the start of the transfer
+    auto phase = [this](CURLINFO info) {
+        curl_off_t us = 0;
+        curl_easy_getinfo(curl_, info, &us);
+        return std::chrono::microseconds(us);
+    };
+    auto dns = phase(CURLINFO_NAMELOOKUP_TIME_T);
+    auto connect = phase(CURLINFO_CONNECT_TIME_T);
+    auto tls = phase(CURLINFO_APPCONNECT_TIME_T);
+    auto sent = phase(CURLINFO_PRETRANSFER_TIME_T);
+    auto first_byte = phase(CURLINFO_STARTTRANSFER_TIME_T);
+    auto total = phase(CURLINFO_TOTAL_TIME_T);
+
+    bool failed = res != CURLE_OK;
+    std::string path = url.substr(std::min(url.size(), url.find('/', url.find("//") + 2)));
+
+    // A reused keep-alive connection reports no connect or handshake time
+    if (connect.count() > 0) {
+        if (dns.count() > 0) {
+            trace->addSpan("dns", start, start + dns);
+        }
+        trace->addSpan("connect", start + dns, start + connect);
+        if (tls.count() > 0) {
+            trace->addSpan("tls", start + connect, start + tls);
+        }
+    }
+    if (sent.count() == 0) {
+        // Never got to send (connect/TLS failure or timeout)
+        trace->addSpan("request", start, start + total, path + ": " + curl_easy_strerror(res), true);
+        return;
+    }
+    if (first_byte.count() == 0) {
+        trace->addSpan("request", start + sent, start + total, path + ": " + curl_easy_strerror(res), true);
+        return;
+    }
+    trace->addSpan("request", start + sent, start + first_byte,
+                   connect.count() > 0 ? path : path + " (reused connection)");
+    trace->addSpan("response", start + first_byte, start + total,
+                   failed ? curl_easy_strerror(res) : "", failed);
+}
+
+void LightningClient::readTiming(CommandTiming& timing) const {
+    auto cumulative = [this](CURLINFO info) -> int64_t {
+        curl_off_t us = 0;
+        curl_easy_getinfo(curl_, info, &us);
+        return static_cast<int64_t>(us);
+    };
+    int64_t dns = cumulative(CURLINFO_NAMELOOKUP_TIME_T);
+    int64_t connect = cumulative(CURLINFO_CONNECT_TIME_T);
+    int64_t tls = cumulative(CURLINFO_APPCONNECT_TIME_T);
+    int64_t sent = cumulative(CURLINFO_PRETRANSFER_TIME_T);
+    int64_t first_byte = cumulative(CURLINFO_STARTTRANSFER_TIME_T);
+
+    // Zero cumulative times are phases that did not happen (reused connection, plain HTTP)
+    timing.dns_us = dns;
+    timing.connect_us = connect > 0 ? connect - dns : 0;
+    timing.tls_us = tls > 0 ? tls - connect : 0;
+    timing.ttfb_us = first_byte > 0 && sent > 0 ? first_byte - sent : -1;
+    timing.transfer_us = cumulative(CURLINFO_TOTAL_TIME_T);
+}
+
+bool LightningClient::rejectIfExpired(CommandResult& result) const {
+    if (!deadline_.expired()) {
+        return false;
+    }
+    Deadline::recordCancelled(Deadline::Stage::Transport);
+    result.error = Deadline::EXCEEDED;
+    return true;
+}
+
 Json::Value LightningClient::parseJsonResponse(const std::string& body) {
     Json::Value root;
     Json::CharReaderBuilder reader;
@@ -456,7 +619,7 @@ Json::Value LightningClient::parseJsonResponse(const std::string& body) {
 
     std::istringstream stream(body);
     if (!Json::parseFromStream(reader, stream, &root, &errors)) {
-        std::cerr << "[LightningClient] JSON parse error: " << errors << std::endl;
+        LOG_ERROR("LightningClient") << "JSON parse error: " << errors;
     }
 
     return root;
@@ -0,0 +1,568 @@
+#include "clients/LightningClientPool.h"
+#include "repositories/DeviceRepository.h"
+#include "utils/ConfigManager.h"
+#include "utils/Metrics.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <future>
+#include <utility>
+
+namespace hms_firetv {
+
+namespace {
+
+int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// ============================================================================
+// LEASE
+// ============================================================================
+
+LightningClientPool::Lease::Lease(std::shared_ptr<DevicePool> pool,
+                                  std::unique_ptr<LightningClient> client,
+                                  LightningClientSpec spec,
+                                  uint64_t generation)
+    : pool_(std::move(pool)),
+      client_(std::move(client)),
+      spec_(std::move(spec)),
+      generation_(generation) {}
+
+LightningClientPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::move(other.pool_)),
+      client_(std::move(other.client_)),
+      spec_(std::move(other.spec_)),
+      generation_(other.generation_),
+      deadline_exceeded_(other.deadline_exceeded_) {}
+
+LightningClientPool::Lease LightningClientPool::Lease::expired() {
+    Lease lease;
+    lease.deadline_exceeded_ = true;
+    return lease;
+}
+
+LightningClientPool::Lease& LightningClientPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = std::move(other.pool_);
+        client_ = std::move(other.client_);
+        spec_ = std::move(other.spec_);
+        generation_ = other.generation_;
+        deadline_exceeded_ = other.deadline_exceeded_;
+    }
+    return *this;
+}
+
+void LightningClientPool::Lease::release() {
+    if (!pool_) {
+        return;
+    }
+    auto pool = std::move(pool_);
+    pool_.reset();
+    if (client_) {
+        client_->setDeadline(Deadline());  // Next lessee brings its own
+        client_->clearTiming();
+    }
+    LightningClientPool::giveBack(pool, std::move(client_), generation_);
+}
+
+// ============================================================================
+// POOL
+// ============================================================================
+
+LightningClientPool& LightningClientPool::getInstance() {
+    static LightningClientPool instance(static_cast<size_t>(std::max(1,
+        ConfigManager::getEnvInt("LIGHTNING_MAX_PARALLEL_PER_DEVICE",
+                                 static_cast<int>(DEFAULT_MAX_PARALLEL)))));
+
+    static const bool subscribed = [] {
+        DeviceRepository::addChangeListener([](const std::string& device_id, DeviceChange change) {
+            if (change == DeviceChange::Deleted) {
+                LightningClientPool::getInstance().invalidate(device_id);
+            } else {
+                LightningClientPool::getInstance().refresh(device_id);
+            }
+        });
+        return true;
+    }();
+    (void)subscribed;
+
+    return instance;
+}
+
+LightningClientPool::LightningClientPool(size_t max_parallel_per_device,
+                                         SpecResolver resolver,
+                                         size_t max_devices)
+    : max_parallel_(max_parallel_per_device == 0 ? 1 : max_parallel_per_device),
+      resolver_(resolver ? std::move(resolver) : SpecResolver(&LightningClientPool::resolveFromRepository)),
+      max_devices_(max_devices == 0 ? 1 : max_devices) {}
+
+LightningClientPool::~LightningClientPool() {
+    stopSweeper();
+}
+
+LightningClientPool::Lease LightningClientPool::lease(const std::string& device_id,
+                                                     const Deadline& deadline) {
+    auto promise = std::make_shared<std::promise<Lease>>();
+    auto future = promise->get_future();
+    LeaseCallback callback = [promise](Lease lease) {
+        promise->set_value(std::move(lease));
+    };
+
+    // Looked up again if the pool was pruned between lookup and lease
+    std::shared_ptr<DevicePool> pool;
+    std::optional<uint64_t> waiter_id;
+    while (!waiter_id.has_value()) {
+        pool = getOrCreatePool(device_id);
+        waiter_id = leaseOrWait(pool, callback, deadline);
+    }
+
+    if (waiter_id.value() == 0 || !deadline.isSet() ||
+        future.wait_until(deadline.at()) == std::future_status::ready) {
+        return future.get();
+    }
+
+    // Timed out: withdraw from the queue unless a handle was just handed to us
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        auto it = std::find_if(pool->waiters.begin(), pool->waiters.end(),
+                               [&waiter_id](const Waiter& w) { return w.id == waiter_id.value(); });
+        if (it != pool->waiters.end()) {
+            pool->waiters.erase(it);
+            Deadline::recordCancelled(Deadline::Stage::Queue);
+            return Lease::expired();
+        }
+    }
+    return future.get();
+}
+
+void LightningClientPool::leaseAsync(const std::string& device_id, LeaseCallback callback,
+                                     const Deadline& deadline) {
+    // Looked up again if the pool was pruned between lookup and lease
+    std::optional<uint64_t> waiter_id;
+    while (!waiter_id.has_value()) {
+        waiter_id = leaseOrWait(getOrCreatePool(device_id), callback, deadline);
+    }
+}
+
+void LightningClientPool::invalidate(const std::string& device_id) {
+    auto pool = findPool(device_id);
+    if (!pool) {
+        return;
+    }
+
+    // Destroy idle handles outside the pool lock
+    std::vector<std::unique_ptr<LightningClient>> discarded;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->generation++;
+        pool->spec.reset();
+        discarded.swap(pool->idle);
+    }
+
+    LOG_INFO("LightningClientPool") << "Invalidated clients for device: " << device_id;
+}
+
+bool LightningClientPool::refresh(const std::string& device_id) {
+    auto pool = findPool(device_id);
+    if (!pool) {
+        return false;  // Nothing pooled yet; the next lease resolves fresh
+    }
+
+    // Concurrent refreshes apply in order; leases are not held up by the lookup
+    std::lock_guard<std::mutex> serial(pool->refresh_mutex);
+    std::optional<LightningClientSpec> latest;
+    try {
+        latest = pool->resolver(device_id);
+    } catch (const std::exception& e) {
+        LOG_ERROR("LightningClientPool") << "Failed to resolve device "
+                                         << device_id << ": " << e.what();
+    }
+
+    std::vector<std::unique_ptr<LightningClient>> discarded;
+    std::string old_ip;
+    std::string new_ip;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (latest.has_value() && pool->spec.has_value() && latest.value() == pool->spec.value()) {
+            return false;
+        }
+
+        old_ip = pool->spec.has_value() ? pool->spec->ip_address : "";
+        new_ip = latest.has_value() ? latest->ip_address : "";
+        pool->generation++;
+        pool->spec = std::move(latest);
+        discarded.swap(pool->idle);
+    }
+
+    if (old_ip != new_ip) {
+        LOG_INFO("LightningClientPool") << "Rebuilding clients for device " << device_id
+                                        << " (" << old_ip << " -> " << new_ip << ")";
+    } else {
+        LOG_INFO("LightningClientPool") << "Rebuilding clients for device " << device_id;
+    }
+    return true;
+}
+
+void LightningClientPool::clear() {
+    std::unordered_map<std::string, std::shared_ptr<DevicePool>> forgotten;
+    {
+        std::unique_lock<std::shared_mutex> lock(pools_mutex_);
+        forgotten.swap(pools_);
+    }
+    for (auto& [device_id, pool] : forgotten) {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->retired = true;
+    }
+}
+
+LightningClientPool::DeviceStats LightningClientPool::stats(const std::string& device_id) const {
+    DeviceStats stats;
+    auto pool = findPool(device_id);
+    if (!pool) {
+        return stats;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    stats.idle = pool->idle.size();
+    stats.in_use = pool->in_use;
+    stats.waiting = pool->waiters.size();
+    return stats;
+}
+
+std::vector<std::pair<std::string, LightningClientPool::DeviceStats>> LightningClientPool::allStats() const {
+    std::vector<std::shared_ptr<DevicePool>> pools;
+    {
+        std::shared_lock<std::shared_mutex> lock(pools_mutex_);
+        pools.reserve(pools_.size());
+        for (const auto& [device_id, pool] : pools_) {
+            pools.push_back(pool);
+        }
+    }
+
+    std::vector<std::pair<std::string, DeviceStats>> out;
+    for (const auto& pool : pools) {
+        DeviceStats stats;
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        stats.idle = pool->idle.size();
+        stats.in_use = pool->in_use;
+        stats.waiting = pool->waiters.size();
+        out.emplace_back(pool->device_id, stats);
+    }
+    return out;
+}
+
+size_t LightningClientPool::pruneIdle(std::chrono::milliseconds idle_for) {
+    int64_t cutoff = steadyNowMs() - idle_for.count();
+    std::vector<std::shared_ptr<DevicePool>> pruned;  // Destroyed after the lock is released
+    {
+        std::unique_lock<std::shared_mutex> lock(pools_mutex_);
+        for (auto it = pools_.begin(); it != pools_.end();) {
+            if (retireIfIdle(it->second, cutoff)) {
+                pruned.push_back(std::move(it->second));
+                it = pools_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (!pruned.empty()) {
+        LOG_DEBUG("LightningClientPool") << "Pruned " << pruned.size() << " idle device pool(s)";
+    }
+    return pruned.size();
+}
+
+void LightningClientPool::startSweeper(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(sweeper_mutex_);
+    if (sweeper_running_) {
+        return;  // Already running
+    }
+
+    sweeper_running_ = true;
+    sweeper_thread_ = std::thread([this, interval]() {
+        std::unique_lock<std::mutex> lock(sweeper_mutex_);
+        while (sweeper_running_) {
+            if (sweeper_cv_.wait_for(lock, interval, [this] { return !sweeper_running_; })) {
+                break;
+            }
+            lock.unlock();
+            pruneIdle(std::chrono::seconds(POOL_IDLE_TTL_SECONDS));
+            lock.lock();
+        }
+    });
+}
+
+void LightningClientPool::stopSweeper() {
+    {
+        std::lock_guard<std::mutex> lock(sweeper_mutex_);
+        if (!sweeper_running_) {
+            return;
+        }
+        sweeper_running_ = false;
+    }
+    sweeper_cv_.notify_one();
+
+    if (sweeper_thread_.joinable()) {
+        sweeper_thread_.join();
+    }
+}
+
+// ============================================================================
+// INTERNALS
+// ============================================================================
+
+std::shared_ptr<LightningClientPool::DevicePool>
+LightningClientPool::findPool(const std::string& device_id) const {
+    std::shared_lock<std::shared_mutex> lock(pools_mutex_);
+    auto it = pools_.find(device_id);
+    return it == pools_.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<LightningClientPool::DevicePool>
+LightningClientPool::getOrCreatePool(const std::string& device_id) {
+    // Touched under the map lock, so pruning sees the use before it decides
+    {
+        std::shared_lock<std::shared_mutex> lock(pools_mutex_);
+        auto it = pools_.find(device_id);
+        if (it != pools_.end()) {
+            it->second->last_used_ms.store(steadyNowMs(), std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<DevicePool> pruned;  // Destroyed after the lock is released
+    std::unique_lock<std::shared_mutex> lock(pools_mutex_);
+
+    // Another thread may have created it while we waited
+    auto it = pools_.find(device_id);
+    if (it != pools_.end()) {
+        it->second->last_used_ms.store(steadyNowMs(), std::memory_order_relaxed);
+        return it->second;
+    }
+
+    // Pools in use are kept even above the limit
+    if (pools_.size() >= max_devices_) {
+        pruned = pruneOldestLocked();
+    }
+
+    auto pool = std::make_shared<DevicePool>();
+    pool->device_id = device_id;
+    pool->max_parallel = max_parallel_;
+    pool->resolver = resolver_;
+    pool->last_used_ms.store(steadyNowMs(), std::memory_order_relaxed);
+    pools_.emplace(device_id, pool);
+    return pool;
+}
+
+std::shared_ptr<LightningClientPool::DevicePool> LightningClientPool::pruneOldestLocked() {
+    auto oldest = pools_.end();
+    int64_t oldest_ms = 0;
+    for (auto it = pools_.begin(); it != pools_.end(); ++it) {
+        int64_t used_ms = it->second->last_used_ms.load(std::memory_order_relaxed);
+        if (oldest != pools_.end() && used_ms >= oldest_ms) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(it->second->mutex);
+        if (it->second->in_use == 0 && it->second->waiters.empty()) {
+            oldest = it;
+            oldest_ms = used_ms;
+        }
+    }
+
+    if (oldest == pools_.end() || !retireIfIdle(oldest->second, oldest_ms)) {
+        return nullptr;
+    }
+    auto pruned = std::move(oldest->second);
+    pools_.erase(oldest);
+    return pruned;
+}
+
+bool LightningClientPool::retireIfIdle(const std::shared_ptr<DevicePool>& pool, int64_t cutoff_ms) {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    if (pool->in_use > 0 || !pool->waiters.empty() ||
+        pool->last_used_ms.load(std::memory_order_relaxed) > cutoff_ms) {
+        return false;
+    }
+    pool->retired = true;
+    return true;
+}
+
+std::optional<uint64_t> LightningClientPool::leaseOrWait(const std::shared_ptr<DevicePool>& pool,
+                                                         LeaseCallback& callback,
+                                                         const Deadline& deadline) {
+    if (deadline.expired()) {
+        Deadline::recordCancelled(Deadline::Stage::Queue);
+        callback(Lease::expired());
+        return 0;
+    }
+
+    Slot slot;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->retired) {
+            return std::nullopt;
+        }
+        if (pool->in_use >= pool->max_parallel || !pool->waiters.empty()) {
+            uint64_t id = pool->next_waiter_id++;
+            pool->waiters.push_back(Waiter{std::move(callback), deadline, id});
+            return id;
+        }
+        slot = takeSlotLocked(pool);
+    }
+
+    Lease lease = std::move(slot.lease);
+    if (slot.needs_spec) {
+        lease = buildReserved(pool, slot.generation);
+        if (!lease) {
+            serveWaiters(pool);  // Requests may have queued behind the reservation
+        }
+    }
+    if (lease) {
+        lease->setDeadline(deadline);
+    }
+    callback(std::move(lease));
+    return 0;
+}
+
+LightningClientPool::Slot LightningClientPool::takeSlotLocked(const std::shared_ptr<DevicePool>& pool) {
+    Slot slot;
+    Metrics::recordCacheLookup("lightning_clients", !pool->idle.empty());
+    pool->in_use++;
+    slot.generation = pool->generation;
+
+    if (!pool->idle.empty()) {
+        auto client = std::move(pool->idle.back());
+        pool->idle.pop_back();
+        slot.lease = Lease(pool, std::move(client), pool->spec.value(), pool->generation);
+    } else if (pool->spec.has_value()) {
+        const auto& spec = pool->spec.value();
+        slot.lease = Lease(pool, std::make_unique<LightningClient>(spec.ip_address, spec.api_key, spec.client_token),
+                           spec, pool->generation);
+    } else {
+        slot.needs_spec = true;
+    }
+    return slot;
+}
+
+LightningClientPool::Lease LightningClientPool::buildReserved(const std::shared_ptr<DevicePool>& pool,
+                                                             uint64_t generation) {
+    std::optional<LightningClientSpec> spec;
+    try {
+        spec = pool->resolver(pool->device_id);
+    } catch (const std::exception& e) {
+        LOG_ERROR("LightningClientPool") << "Failed to resolve device "
+                                         << pool->device_id << ": " << e.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (!spec.has_value()) {
+            pool->in_use--;  // Failed acquisitions do not take a slot
+            return Lease();
+        }
+        // An invalidate() while resolving wins; this handle is discarded on return
+        if (pool->generation == generation && !pool->spec.has_value()) {
+            pool->spec = spec;
+        }
+    }
+
+    auto client = std::make_unique<LightningClient>(spec->ip_address, spec->api_key, spec->client_token);
+    return Lease(pool, std::move(client), std::move(spec.value()), generation);
+}
+
+void LightningClientPool::serveWaiters(const std::shared_ptr<DevicePool>& pool) {
+    // Runs from Lease destructors: a throwing waiter must not escape
+    auto deliver = [](LeaseCallback& waiter, Lease lease) {
+        try {
+            waiter(std::move(lease));
+        } catch (const std::exception& e) {
+            LOG_ERROR("LightningClientPool") << "Lease waiter threw: " << e.what();
+        } catch (...) {
+            LOG_ERROR("LightningClientPool") << "Lease waiter threw unknown exception";
+        }
+    };
+
+    // Each round hands out slots until one needs the device resolved, which
+    // happens without the lock. A failed lookup frees the slot again, so this
+    // drains every waiter when the device can no longer be resolved.
+    for (;;) {
+        std::vector<std::pair<LeaseCallback, Lease>> ready;
+        std::optional<Waiter> resolving;
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            while (!pool->waiters.empty() && pool->in_use < pool->max_parallel) {
+                Waiter waiter = std::move(pool->waiters.front());
+                pool->waiters.pop_front();
+
+                // Nobody is waiting for the result any more: don't spend a handle on it
+                if (waiter.deadline.expired()) {
+                    Deadline::recordCancelled(Deadline::Stage::Queue);
+                    ready.emplace_back(std::move(waiter.callback), Lease::expired());
+                    continue;
+                }
+
+                Slot slot = takeSlotLocked(pool);
+                if (slot.needs_spec) {
+                    generation = slot.generation;
+                    resolving = std::move(waiter);
+                    break;
+                }
+                slot.lease->setDeadline(waiter.deadline);
+                ready.emplace_back(std::move(waiter.callback), std::move(slot.lease));
+            }
+        }
+
+        for (auto& [waiter, lease] : ready) {
+            deliver(waiter, std::move(lease));
+        }
+        if (!resolving.has_value()) {
+            return;
+        }
+
+        Lease lease = buildReserved(pool, generation);
+        if (lease) {
+            lease->setDeadline(resolving->deadline);
+        }
+        deliver(resolving->callback, std::move(lease));
+    }
+}
+
+void LightningClientPool::giveBack(const std::shared_ptr<DevicePool>& pool,
+                                   std::unique_ptr<LightningClient> client,
+                                   uint64_t generation) {
+    std::unique_ptr<LightningClient> discarded;  // Destroyed after the lock is released
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->in_use--;
+        pool->last_used_ms.store(steadyNowMs(), std::memory_order_relaxed);
+
+        // Handles built from stale connection parameters are not reused
+        if (client && generation == pool->generation && pool->idle.size() < pool->max_parallel) {
+            pool->idle.push_back(std::move(client));
+        } else {
+            discarded = std::move(client);
+        }
+    }
+
+    serveWaiters(pool);
+}
+
+std::optional<LightningClientSpec> LightningClientPool::resolveFromRepository(const std::string& device_id) {
+    auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+    if (!device.has_value()) {
+        return std::nullopt;
+    }
+
+    LightningClientSpec spec;
+    spec.ip_address = device->ip_address;
+    spec.api_key = device->api_key;
+    spec.client_token = device->client_token.value_or("");
+    return spec;
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,160 @@
+#include "clients/LightningStep.h"
+#include <algorithm>
+#include <cctype>
+
+namespace hms_firetv {
+
+namespace {
+
+// Values are spliced into request paths, so only plain tokens are accepted
+bool isActionToken(const std::string& value) {
+    return !value.empty() && value.size() <= 32 &&
+           std::all_of(value.begin(), value.end(), [](unsigned char c) {
+               return std::islower(c) || std::isdigit(c) || c == '_';
+           });
+}
+
+bool isPackageName(const std::string& value) {
+    return !value.empty() && value.size() <= 128 &&
+           std::all_of(value.begin(), value.end(), [](unsigned char c) {
+               return std::isalnum(c) || c == '.' || c == '_';
+           });
+}
+
+bool readDelay(const Json::Value& value, int& out, std::string& error) {
+    if (!value.isIntegral() || value.asInt64() < 0 || value.asInt64() > MAX_STEP_DELAY_MS) {
+        error = "delay must be 0-" + std::to_string(MAX_STEP_DELAY_MS) + " ms";
+        return false;
+    }
+    out = value.asInt();
+    return true;
+}
+
+} // namespace
+
+std::optional<LightningStep> LightningStep::compile(const Json::Value& step, std::string& error) {
+    if (!step.isObject() || !step["command"].isString()) {
+        error = "missing 'command'";
+        return std::nullopt;
+    }
+
+    LightningStep compiled;
+    compiled.command = step["command"].asString();
+    const std::string& command = compiled.command;
+
+    if (step.isMember("delay_ms") && !readDelay(step["delay_ms"], compiled.delay_after_ms, error)) {
+        return std::nullopt;
+    }
+
+    if (command == "navigate") {
+        std::string action = step.get("action", step.get("direction", "").asString()).asString();
+        if (action == "up" || action == "down" || action == "left" || action == "right") {
+            action = "dpad_" + action;
+        }
+        if (!isActionToken(action)) {
+            error = "invalid navigation action";
+            return std::nullopt;
+        }
+        compiled.path = "/v1/FireTV?action=" + action;
+        compiled.detail = action;
+
+    } else if (command == "media") {
+        std::string action = step.get("action", "").asString();
+        if (!isActionToken(action)) {
+            error = "invalid media action";
+            return std::nullopt;
+        }
+        compiled.path = "/v1/media?action=" + action;
+        compiled.detail = action;
+
+        if (action == "scan") {
+            std::string direction = step.get("direction", "forward").asString();
+            if (direction != "forward" && direction != "back") {
+                error = "scan direction must be 'forward' or 'back'";
+                return std::nullopt;
+            }
+            compiled.path += "&direction=" + direction;
+            compiled.detail += " " + direction;
+        }
+
+    } else if (command == "volume") {
+        std::string action = step.get("action", "").asString();
+        if (!isActionToken(action)) {
+            error = "invalid volume action";
+            return std::nullopt;
+        }
+        compiled.path = "/v1/FireTV?action=" + action;
+        compiled.detail = action;
+
+    } else if (command == "app") {
+        std::string package = step.get("package", "").asString();
+        if (!isPackageName(package)) {
+            error = "invalid 'package'";
+            return std::nullopt;
+        }
+        compiled.path = "/v1/FireTV/app/" + package;
+        compiled.detail = package;
+
+    } else if (command == "text") {
+        if (!step["text"].isString()) {
+            error = "missing 'text'";
+            return std::nullopt;
+        }
+        Json::Value payload;
+        payload["text"] = step["text"];
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        compiled.path = "/v1/FireTV/keyboard";
+        compiled.body = Json::writeString(writer, payload);
+
+    } else if (command == "wake") {
+        compiled.kind = Kind::Wake;
+
+    } else if (command == "delay") {
+        compiled.kind = Kind::Delay;
+        if (!readDelay(step.get("ms", Json::Value()), compiled.delay_after_ms, error)) {
+            return std::nullopt;
+        }
+
+    } else {
+        error = "unknown command '" + command + "'";
+        return std::nullopt;
+    }
+
+    return compiled;
+}
+
+std::shared_ptr<const LightningSequence> compileSequence(const Json::Value& steps, std::string& error) {
+    if (!steps.isArray() || steps.empty()) {
+        error = "'steps' must be a non-empty array";
+        return nullptr;
+    }
+    if (steps.size() > MAX_SEQUENCE_STEPS) {
+        error = "too many steps (max " + std::to_string(MAX_SEQUENCE_STEPS) + ")";
+        return nullptr;
+    }
+
+    auto sequence = std::make_shared<LightningSequence>();
+    sequence->reserve(steps.size());
+    int total_delay_ms = 0;
+
+    for (Json::ArrayIndex i = 0; i < steps.size(); i++) {
+        std::string step_error;
+        auto step = LightningStep::compile(steps[i], step_error);
+        if (!step.has_value()) {
+            error = "step " + std::to_string(i) + ": " + step_error;
+            return nullptr;
+        }
+        total_delay_ms += step->delay_after_ms;
+        sequence->push_back(std::move(step.value()));
+    }
+
+    if (total_delay_ms > MAX_SEQUENCE_DELAY_MS) {
+        error = "total delay exceeds " + std::to_string(MAX_SEQUENCE_DELAY_MS) + " ms";
+        return nullptr;
+    }
+
+    return sequence;
+}
+
+} // namespace hms_firetv
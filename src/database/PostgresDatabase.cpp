@@ -1,7 +1,7 @@
 #include "database/PostgresDatabase.h"
 #include "services/DatabaseService.h"
+#include "utils/Logger.h"
 #include <pqxx/pqxx>
-#include <iostream>
 #include <sstream>
 
 namespace hms_firetv {
@@ -15,7 +15,7 @@ bool PostgresDatabase::connect() {
         DatabaseService::getInstance().initialize(host_, port_, name_, user_, password_);
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "[PostgresDB] connect failed: " << e.what() << std::endl;
+        LOG_ERROR("PostgresDB") << "connect failed: " << e.what();
         return false;
     }
 }
@@ -47,6 +47,7 @@ Device PostgresDatabase::parseDevice(const pqxx::row& row) {
     d.adb_enabled = row["adb_enabled"].as<bool>();
     if (!row["client_token"].is_null()) d.client_token = row["client_token"].as<std::string>();
     if (!row["pin_code"].is_null()) d.pin_code = row["pin_code"].as<std::string>();
+    if (!row["tags"].is_null()) d.tags = Device::parseTags(row["tags"].as<std::string>());
     if (!row["created_at"].is_null()) d.created_at = pgTs(row["created_at"].as<std::string>());
     if (!row["updated_at"].is_null()) d.updated_at = pgTs(row["updated_at"].as<std::string>());
     return d;
@@ -66,14 +67,32 @@ DeviceApp PostgresDatabase::parseApp(const pqxx::row& row) {
     return a;
 }
 
+Macro PostgresDatabase::parseMacro(const pqxx::row& row) {
+    Macro m;
+    m.id          = row["id"].as<int>();
+    m.name        = row["name"].as<std::string>();
+    m.description = row["description"].is_null() ? "" : row["description"].as<std::string>();
+    if (!row["created_at"].is_null()) m.created_at = row["created_at"].as<std::string>();
+    if (!row["updated_at"].is_null()) m.updated_at = row["updated_at"].as<std::string>();
+
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    std::istringstream stream(row["steps"].as<std::string>());
+    if (!Json::parseFromStream(reader, stream, &m.steps, &errors) || !m.steps.isArray()) {
+        LOG_ERROR("PostgresDB") << "Invalid steps for macro " << m.name;
+        m.steps = Json::arrayValue;
+    }
+    return m;
+}
+
 // ── Devices ───────────────────────────────────────────────────────────────────
 
 std::optional<Device> PostgresDatabase::createDevice(const Device& device) {
     auto r = DatabaseService::getInstance().executeQueryParams(
-        "INSERT INTO fire_tv_devices (device_id,name,ip_address,api_key,status,adb_enabled,"
-        "created_at,updated_at) VALUES ($1,$2,$3,$4,$5,$6,NOW(),NOW()) RETURNING id",
+        "INSERT INTO fire_tv_devices (device_id,name,ip_address,api_key,status,adb_enabled,tags,"
+        "created_at,updated_at) VALUES ($1,$2,$3,$4,$5,$6,$7,NOW(),NOW()) RETURNING id",
         {device.device_id, device.name, device.ip_address, device.api_key,
-         device.status, device.adb_enabled ? "true" : "false"});
+         device.status, device.adb_enabled ? "true" : "false", device.tagsString()});
     if (r.empty()) return std::nullopt;
     return getDeviceById(device.device_id);
 }
@@ -103,10 +122,11 @@ std::vector<Device> PostgresDatabase::getDevicesByStatus(const std::string& stat
 
 bool PostgresDatabase::updateDevice(const Device& device) {
     return DatabaseService::getInstance().executeQueryParams(
-        "UPDATE fire_tv_devices SET name=$1,ip_address=$2,status=$3,adb_enabled=$4,"
-        "updated_at=NOW() WHERE device_id=$5",
-        {device.name, device.ip_address, device.status,
-         device.adb_enabled ? "true" : "false", device.device_id}).empty()
+        "UPDATE fire_tv_devices SET name=$1,ip_address=$2,api_key=$3,client_token=NULLIF($4,''),"
+        "status=$5,adb_enabled=$6,tags=$7,updated_at=NOW() WHERE device_id=$8",
+        {device.name, device.ip_address, device.api_key, device.client_token.value_or(""),
+         device.status, device.adb_enabled ? "true" : "false", device.tagsString(),
+         device.device_id}).empty()
         ? DatabaseService::getInstance().isConnected() : true;
 }
 
@@ -128,6 +148,13 @@ bool PostgresDatabase::updateLastSeen(const std::string& device_id, const std::s
         ? DatabaseService::getInstance().isConnected() : true;
 }
 
+bool PostgresDatabase::updateDeviceIp(const std::string& device_id, const std::string& ip_address) {
+    return DatabaseService::getInstance().executeQueryParams(
+        "UPDATE fire_tv_devices SET ip_address=$1,status='online',last_seen_at=NOW(),"
+        "updated_at=NOW() WHERE device_id=$2", {ip_address, device_id}).empty()
+        ? DatabaseService::getInstance().isConnected() : true;
+}
+
 bool PostgresDatabase::setPairingPin(const std::string& device_id, const std::string& pin_code,
                                      int expires_secs) {
     return DatabaseService::getInstance().executeQueryParams(
@@ -263,6 +290,42 @@ bool PostgresDatabase::addPopularAppsToDevice(const std::string& device_id,
     return true;
 }
 
+// ── Macros ────────────────────────────────────────────────────────────────────
+
+std::vector<Macro> PostgresDatabase::getAllMacros() {
+    auto r = DatabaseService::getInstance().executeQuery(
+        "SELECT id,name,description,steps::text AS steps,created_at::text,updated_at::text "
+        "FROM macros ORDER BY name");
+    std::vector<Macro> out;
+    for (const auto& row : r) out.push_back(parseMacro(row));
+    return out;
+}
+
+std::optional<Macro> PostgresDatabase::getMacro(const std::string& name) {
+    auto r = DatabaseService::getInstance().executeQueryParams(
+        "SELECT id,name,description,steps::text AS steps,created_at::text,updated_at::text "
+        "FROM macros WHERE name=$1", {name});
+    if (r.empty()) return std::nullopt;
+    return parseMacro(r[0]);
+}
+
+bool PostgresDatabase::saveMacro(const Macro& macro) {
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    DatabaseService::getInstance().executeQueryParams(
+        "INSERT INTO macros (name,description,steps) VALUES ($1,$2,$3::jsonb) "
+        "ON CONFLICT (name) DO UPDATE SET description=EXCLUDED.description,"
+        "steps=EXCLUDED.steps,updated_at=CURRENT_TIMESTAMP",
+        {macro.name, macro.description, Json::writeString(writer, macro.steps)});
+    return true;
+}
+
+bool PostgresDatabase::deleteMacro(const std::string& name) {
+    auto r = DatabaseService::getInstance().executeQueryParams(
+        "DELETE FROM macros WHERE name=$1 RETURNING id", {name});
+    return !r.empty();
+}
+
 // ── Stats ─────────────────────────────────────────────────────────────────────
 
 Json::Value PostgresDatabase::getOverallStats() {
@@ -296,19 +359,28 @@ Json::Value PostgresDatabase::getOverallStats() {
     auto cmd_r = DatabaseService::getInstance().executeQuery(
         "SELECT COUNT(*) as total,"
         " SUM(CASE WHEN success=true THEN 1 ELSE 0 END) as succ,"
-        " AVG(response_time_ms) as avg_rt "
+        " AVG(response_time_ms) as avg_rt,"
+        " AVG(queue_us) as queue, AVG(wake_us) as wake, AVG(dns_us) as dns, AVG(connect_us) as connect,"
+        " AVG(tls_us) as tls, AVG(ttfb_us) as ttfb, AVG(transfer_us) as transfer "
         "FROM command_history WHERE created_at > NOW()-INTERVAL '24 hours'");
     int total_cmds = 0, succ_cmds = 0;
     double avg_rt = 0.0;
+    Json::Value breakdown(Json::objectValue);
     if (!cmd_r.empty()) {
         total_cmds = cmd_r[0]["total"].is_null() ? 0 : cmd_r[0]["total"].as<int>();
         succ_cmds  = cmd_r[0]["succ"].is_null()  ? 0 : cmd_r[0]["succ"].as<int>();
         avg_rt     = cmd_r[0]["avg_rt"].is_null() ? 0.0 : cmd_r[0]["avg_rt"].as<double>();
+        // Breakdown averages cover only the commands whose transport measured that phase
+        for (const char* phase : {"queue", "wake", "dns", "connect", "tls", "ttfb", "transfer"}) {
+            if (!cmd_r[0][phase].is_null())
+                breakdown[std::string(phase) + "_ms"] = cmd_r[0][phase].as<double>() / 1000.0;
+        }
     }
     double rate = total_cmds > 0 ? (double)succ_cmds / total_cmds * 100.0 : 0.0;
     Json::Value cmds;
     cmds["last_24h"] = total_cmds; cmds["successful_24h"] = succ_cmds;
     cmds["success_rate"] = rate; cmds["avg_response_time_ms"] = avg_rt;
+    cmds["avg_breakdown_ms"] = breakdown;
     r["commands"] = cmds;
 
     return r;
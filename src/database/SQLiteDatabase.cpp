@@ -1,6 +1,6 @@
 #include "database/SQLiteDatabase.h"
+#include "utils/Logger.h"
 #include <filesystem>
-#include <iostream>
 #include <cstring>
 #include <ctime>
 #include <sstream>
@@ -58,7 +58,7 @@ bool SQLiteDatabase::connect() {
     }
 
     if (sqlite3_open(db_path_.c_str(), &db_) != SQLITE_OK) {
-        std::cerr << "[SQLiteDB] Failed to open: " << sqlite3_errmsg(db_) << std::endl;
+        LOG_ERROR("SQLiteDB") << "Failed to open: " << sqlite3_errmsg(db_);
         db_ = nullptr;
         return false;
     }
@@ -66,7 +66,7 @@ bool SQLiteDatabase::connect() {
     exec("PRAGMA foreign_keys=ON");
     exec("PRAGMA synchronous=NORMAL");
     createSchema();
-    std::cout << "[SQLiteDB] Connected (" << db_path_ << ")" << std::endl;
+    LOG_INFO("SQLiteDB") << "Connected (" << db_path_ << ")";
     return true;
 }
 
@@ -84,13 +84,23 @@ bool SQLiteDatabase::exec(const std::string& sql) {
     char* err = nullptr;
     int rc = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &err);
     if (rc != SQLITE_OK) {
-        std::cerr << "[SQLiteDB] exec error: " << (err ? err : "?") << " SQL: " << sql << std::endl;
+        LOG_ERROR("SQLiteDB") << "exec error: " << (err ? err : "?") << " SQL: " << sql;
         sqlite3_free(err);
         return false;
     }
     return true;
 }
 
+bool SQLiteDatabase::hasColumn(const std::string& table, const std::string& column) {
+    std::string sql = "PRAGMA table_info(" + table + ")";
+    StmtGuard g;
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &g.s, nullptr) != SQLITE_OK) return false;
+    while (sqlite3_step(g.s) == SQLITE_ROW) {
+        if (col_str(g.s, 1) == column) return true;
+    }
+    return false;
+}
+
 void SQLiteDatabase::createSchema() {
     exec(R"(
 CREATE TABLE IF NOT EXISTS fire_tv_devices (
@@ -106,8 +116,13 @@ CREATE TABLE IF NOT EXISTS fire_tv_devices (
     adb_enabled INTEGER NOT NULL DEFAULT 0,
     last_seen_at TEXT,
     created_at TEXT DEFAULT CURRENT_TIMESTAMP,
-    updated_at TEXT DEFAULT CURRENT_TIMESTAMP
+    updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+    tags TEXT NOT NULL DEFAULT ''
 ))");
+    // Databases created before tags existed
+    if (!hasColumn("fire_tv_devices", "tags")) {
+        exec("ALTER TABLE fire_tv_devices ADD COLUMN tags TEXT NOT NULL DEFAULT ''");
+    }
     exec("CREATE INDEX IF NOT EXISTS idx_ftd_device_id ON fire_tv_devices(device_id)");
     exec("CREATE INDEX IF NOT EXISTS idx_ftd_status ON fire_tv_devices(status)");
 
@@ -144,11 +159,34 @@ CREATE TABLE IF NOT EXISTS command_history (
     success INTEGER NOT NULL DEFAULT 0,
     response_time_ms INTEGER,
     error_message TEXT,
-    created_at TEXT DEFAULT CURRENT_TIMESTAMP
+    created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+    queue_us INTEGER,
+    wake_us INTEGER,
+    dns_us INTEGER,
+    connect_us INTEGER,
+    tls_us INTEGER,
+    ttfb_us INTEGER,
+    transfer_us INTEGER
 ))");
+    // Databases created before the latency breakdown existed
+    for (const char* column : {"queue_us", "wake_us", "dns_us", "connect_us", "tls_us", "ttfb_us", "transfer_us"}) {
+        if (!hasColumn("command_history", column)) {
+            exec(std::string("ALTER TABLE command_history ADD COLUMN ") + column + " INTEGER");
+        }
+    }
     exec("CREATE INDEX IF NOT EXISTS idx_ch_device_id ON command_history(device_id)");
     exec("CREATE INDEX IF NOT EXISTS idx_ch_created_at ON command_history(created_at)");
 
+    exec(R"(
+CREATE TABLE IF NOT EXISTS macros (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    name TEXT NOT NULL UNIQUE,
+    description TEXT DEFAULT '',
+    steps TEXT NOT NULL DEFAULT '[]',
+    created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+    updated_at TEXT DEFAULT CURRENT_TIMESTAMP
+))");
+
     // Seed popular apps (ignore duplicates)
     exec(R"(
 INSERT OR IGNORE INTO popular_apps (package_name, app_name, category) VALUES
@@ -171,7 +209,7 @@ INSERT OR IGNORE INTO popular_apps (package_name, app_name, category) VALUES
 
 Device SQLiteDatabase::parseDevice(sqlite3_stmt* s) {
     // Columns: id, device_id, name, ip_address, api_key, client_token, pin_code,
-    //          pin_expires_at, status, adb_enabled, last_seen_at, created_at, updated_at
+    //          pin_expires_at, status, adb_enabled, last_seen_at, created_at, updated_at, tags
     Device d;
     d.id           = sqlite3_column_int(s, 0);
     d.device_id    = col_str(s, 1);
@@ -186,6 +224,7 @@ Device SQLiteDatabase::parseDevice(sqlite3_stmt* s) {
     d.last_seen_at  = parseTsOpt(col_text(s, 10));
     d.created_at    = parseTs(col_text(s, 11));
     d.updated_at    = parseTs(col_text(s, 12));
+    d.tags          = Device::parseTags(col_str(s, 13));
     return d;
 }
 
@@ -205,13 +244,32 @@ DeviceApp SQLiteDatabase::parseApp(sqlite3_stmt* s) {
     return a;
 }
 
+Macro SQLiteDatabase::parseMacro(sqlite3_stmt* s) {
+    // Columns: id, name, description, steps, created_at, updated_at
+    Macro m;
+    m.id          = sqlite3_column_int(s, 0);
+    m.name        = col_str(s, 1);
+    m.description = col_str(s, 2);
+    m.created_at  = col_str(s, 4);
+    m.updated_at  = col_str(s, 5);
+
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    std::istringstream stream(col_str(s, 3));
+    if (!Json::parseFromStream(reader, stream, &m.steps, &errors) || !m.steps.isArray()) {
+        LOG_ERROR("SQLiteDatabase") << "Invalid steps for macro " << m.name;
+        m.steps = Json::arrayValue;
+    }
+    return m;
+}
+
 // ── Device CRUD ───────────────────────────────────────────────────────────────
 
 std::optional<Device> SQLiteDatabase::createDevice(const Device& device) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     const char* sql =
-        "INSERT INTO fire_tv_devices (device_id,name,ip_address,api_key,status,adb_enabled,"
-        "created_at,updated_at) VALUES (?,?,?,?,?,?,CURRENT_TIMESTAMP,CURRENT_TIMESTAMP)";
+        "INSERT INTO fire_tv_devices (device_id,name,ip_address,api_key,status,adb_enabled,tags,"
+        "created_at,updated_at) VALUES (?,?,?,?,?,?,?,CURRENT_TIMESTAMP,CURRENT_TIMESTAMP)";
     StmtGuard g;
     if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) != SQLITE_OK) return std::nullopt;
     sqlite3_bind_text(g.s, 1, device.device_id.c_str(), -1, SQLITE_TRANSIENT);
@@ -220,6 +278,8 @@ std::optional<Device> SQLiteDatabase::createDevice(const Device& device) {
     sqlite3_bind_text(g.s, 4, device.api_key.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(g.s, 5, device.status.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(g.s, 6, device.adb_enabled ? 1 : 0);
+    std::string tags = device.tagsString();
+    sqlite3_bind_text(g.s, 7, tags.c_str(), -1, SQLITE_TRANSIENT);
     if (sqlite3_step(g.s) != SQLITE_DONE) return std::nullopt;
     return getDeviceById(device.device_id);
 }
@@ -258,15 +318,22 @@ std::vector<Device> SQLiteDatabase::getDevicesByStatus(const std::string& status
 bool SQLiteDatabase::updateDevice(const Device& device) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     const char* sql =
-        "UPDATE fire_tv_devices SET name=?,ip_address=?,status=?,adb_enabled=?,"
-        "updated_at=CURRENT_TIMESTAMP WHERE device_id=?";
+        "UPDATE fire_tv_devices SET name=?,ip_address=?,api_key=?,client_token=?,status=?,"
+        "adb_enabled=?,tags=?,updated_at=CURRENT_TIMESTAMP WHERE device_id=?";
     StmtGuard g;
     if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) != SQLITE_OK) return false;
     sqlite3_bind_text(g.s, 1, device.name.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(g.s, 2, device.ip_address.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(g.s, 3, device.status.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(g.s, 4, device.adb_enabled ? 1 : 0);
-    sqlite3_bind_text(g.s, 5, device.device_id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(g.s, 3, device.api_key.c_str(), -1, SQLITE_TRANSIENT);
+    if (device.client_token.has_value() && !device.client_token->empty())
+        sqlite3_bind_text(g.s, 4, device.client_token->c_str(), -1, SQLITE_TRANSIENT);
+    else
+        sqlite3_bind_null(g.s, 4);
+    sqlite3_bind_text(g.s, 5, device.status.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(g.s, 6, device.adb_enabled ? 1 : 0);
+    std::string tags = device.tagsString();
+    sqlite3_bind_text(g.s, 7, tags.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(g.s, 8, device.device_id.c_str(), -1, SQLITE_TRANSIENT);
     return sqlite3_step(g.s) == SQLITE_DONE;
 }
 
@@ -300,6 +367,18 @@ bool SQLiteDatabase::updateLastSeen(const std::string& device_id, const std::str
     return sqlite3_step(g.s) == SQLITE_DONE;
 }
 
+bool SQLiteDatabase::updateDeviceIp(const std::string& device_id, const std::string& ip_address) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const char* sql =
+        "UPDATE fire_tv_devices SET ip_address=?,status='online',"
+        "last_seen_at=CURRENT_TIMESTAMP,updated_at=CURRENT_TIMESTAMP WHERE device_id=?";
+    StmtGuard g;
+    if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) != SQLITE_OK) return false;
+    sqlite3_bind_text(g.s, 1, ip_address.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(g.s, 2, device_id.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(g.s) == SQLITE_DONE && sqlite3_changes(db_) > 0;
+}
+
 bool SQLiteDatabase::setPairingPin(const std::string& device_id, const std::string& pin_code,
                                    int expires_secs) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
@@ -517,6 +596,57 @@ bool SQLiteDatabase::addPopularAppsToDevice(const std::string& device_id,
     return sqlite3_step(g.s) == SQLITE_DONE;
 }
 
+// ── Macros ────────────────────────────────────────────────────────────────────
+
+std::vector<Macro> SQLiteDatabase::getAllMacros() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const char* sql =
+        "SELECT id,name,description,steps,created_at,updated_at FROM macros ORDER BY name";
+    StmtGuard g;
+    std::vector<Macro> out;
+    if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) != SQLITE_OK) return out;
+    while (sqlite3_step(g.s) == SQLITE_ROW) out.push_back(parseMacro(g.s));
+    return out;
+}
+
+std::optional<Macro> SQLiteDatabase::getMacro(const std::string& name) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const char* sql =
+        "SELECT id,name,description,steps,created_at,updated_at FROM macros WHERE name=?";
+    StmtGuard g;
+    if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) != SQLITE_OK) return std::nullopt;
+    sqlite3_bind_text(g.s, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(g.s) != SQLITE_ROW) return std::nullopt;
+    return parseMacro(g.s);
+}
+
+bool SQLiteDatabase::saveMacro(const Macro& macro) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const char* sql =
+        "INSERT INTO macros (name,description,steps,created_at,updated_at) "
+        "VALUES (?,?,?,CURRENT_TIMESTAMP,CURRENT_TIMESTAMP) "
+        "ON CONFLICT(name) DO UPDATE SET description=excluded.description,"
+        "steps=excluded.steps,updated_at=CURRENT_TIMESTAMP";
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    std::string steps = Json::writeString(writer, macro.steps);
+    StmtGuard g;
+    if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) != SQLITE_OK) return false;
+    sqlite3_bind_text(g.s, 1, macro.name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(g.s, 2, macro.description.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(g.s, 3, steps.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(g.s) == SQLITE_DONE;
+}
+
+bool SQLiteDatabase::deleteMacro(const std::string& name) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const char* sql = "DELETE FROM macros WHERE name=?";
+    StmtGuard g;
+    if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) != SQLITE_OK) return false;
+    sqlite3_bind_text(g.s, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(g.s) == SQLITE_DONE && sqlite3_changes(db_) > 0;
+}
+
 // ── Stats ─────────────────────────────────────────────────────────────────────
 
 Json::Value SQLiteDatabase::getOverallStats() {
@@ -564,9 +694,12 @@ Json::Value SQLiteDatabase::getOverallStats() {
     // Commands last 24h
     int total_cmds = 0, successful_cmds = 0;
     double avg_rt = 0.0;
+    Json::Value breakdown(Json::objectValue);
     {
+        // Breakdown averages cover only the commands whose transport measured that phase
         const char* sql =
-            "SELECT COUNT(*), SUM(success), AVG(response_time_ms) "
+            "SELECT COUNT(*), SUM(success), AVG(response_time_ms), "
+            "AVG(queue_us), AVG(wake_us), AVG(dns_us), AVG(connect_us), AVG(tls_us), AVG(ttfb_us), AVG(transfer_us) "
             "FROM command_history WHERE created_at > datetime('now','-24 hours')";
         StmtGuard g;
         if (sqlite3_prepare_v2(db_, sql, -1, &g.s, nullptr) == SQLITE_OK &&
@@ -574,12 +707,17 @@ Json::Value SQLiteDatabase::getOverallStats() {
             total_cmds     = sqlite3_column_int(g.s, 0);
             successful_cmds = col_is_null(g.s, 1) ? 0 : sqlite3_column_int(g.s, 1);
             avg_rt          = col_is_null(g.s, 2) ? 0.0 : sqlite3_column_double(g.s, 2);
+            const char* phases[] = {"queue_ms", "wake_ms", "dns_ms", "connect_ms", "tls_ms", "ttfb_ms", "transfer_ms"};
+            for (int i = 0; i < 7; i++) {
+                if (!col_is_null(g.s, 3 + i)) breakdown[phases[i]] = sqlite3_column_double(g.s, 3 + i) / 1000.0;
+            }
         }
     }
     double success_rate = total_cmds > 0 ? (double)successful_cmds / total_cmds * 100.0 : 0.0;
     Json::Value cmds;
     cmds["last_24h"] = total_cmds; cmds["successful_24h"] = successful_cmds;
     cmds["success_rate"] = success_rate; cmds["avg_response_time_ms"] = avg_rt;
+    cmds["avg_breakdown_ms"] = breakdown;
     r["commands"] = cmds;
 
     return r;
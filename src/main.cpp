@@ -1,13 +1,23 @@
 #include <drogon/drogon.h>
 #include <iostream>
-#include <fstream>
+#include <algorithm>
 #include <csignal>
 #include <filesystem>
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <sstream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
 #include "utils/ConfigManager.h"
 #include "utils/AppConfig.h"
+#include "utils/Deadline.h"
+#include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include "utils/ServerProfile.h"
+#include "utils/StaticAssets.h"
+#include "utils/Trace.h"
 #include "database/IDatabase.h"
 #include "database/SQLiteDatabase.h"
 #ifdef WITH_POSTGRESQL
@@ -15,7 +25,9 @@
 #endif
 #include "repositories/DeviceRepository.h"
 #include "repositories/AppsRepository.h"
+#include "repositories/MacroRepository.h"
 #include "api/StatsController.h"
+#include "api/DebugController.h"
 #include "mqtt/MQTTClient.h"
 #include "mqtt/DiscoveryPublisher.h"
 #include "mqtt/CommandHandler.h"
@@ -23,7 +35,23 @@
 #include "api/CommandController.h"
 #include "api/PairingController.h"
 #include "api/AppsController.h"
+#include "api/MacroController.h"
+#include "api/BroadcastController.h"
+#include "api/StreamController.h"
+#include "api/RemoteController.h"
+#include "api/StaticAssetServer.h"
 #include "services/DiscoveryService.h"
+#include "services/DeviceSloTracker.h"
+#include "services/EventBus.h"
+#include "services/MacroRunner.h"
+#include "services/BroadcastService.h"
+#include "services/PairingSessionManager.h"
+#include "services/TextInputService.h"
+#include "services/KeyRepeatService.h"
+#include "services/RemoteControlService.h"
+#include "services/ServiceStatus.h"
+#include "clients/AsyncLightningClient.h"
+#include "clients/LightningClientPool.h"
 
 using namespace drogon;
 using namespace hms_firetv;
@@ -33,6 +61,64 @@ void signalHandler(int signal) {
     app().quit();
 }
 
+// Drogon keeps its own logger; give it the same threshold
+trantor::Logger::LogLevel drogonLogLevel(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return trantor::Logger::LogLevel::kTrace;
+        case LogLevel::Debug: return trantor::Logger::LogLevel::kDebug;
+        case LogLevel::Info:  return trantor::Logger::LogLevel::kInfo;
+        case LogLevel::Warn:  return trantor::Logger::LogLevel::kWarn;
+        case LogLevel::Error: return trantor::Logger::LogLevel::kError;
+        case LogLevel::Off:   return trantor::Logger::LogLevel::kFatal;
+    }
+    return trantor::Logger::LogLevel::kInfo;
+}
+
+// Gauges read at scrape time from the components that already keep them
+void registerMetricCollectors() {
+    auto& registry = MetricsRegistry::getInstance();
+    using Sample = MetricsRegistry::Sample;
+
+    registry.addCollector("firetv_client_pool_handles", "Lightning client handles per device by state",
+        "gauge", [] {
+            std::vector<Sample> samples;
+            for (const auto& [device_id, stats] : LightningClientPool::getInstance().allStats()) {
+                samples.push_back({{{"device", device_id}, {"state", "idle"}}, double(stats.idle)});
+                samples.push_back({{{"device", device_id}, {"state", "in_use"}}, double(stats.in_use)});
+            }
+            return samples;
+        });
+    registry.addCollector("firetv_client_pool_waiting", "Commands queued for a device's client",
+        "gauge", [] {
+            std::vector<Sample> samples;
+            for (const auto& [device_id, stats] : LightningClientPool::getInstance().allStats()) {
+                samples.push_back({{{"device", device_id}}, double(stats.waiting)});
+            }
+            return samples;
+        });
+    registry.addCollector("firetv_macro_queue_depth", "Sequences waiting for a macro worker",
+        "gauge", [] {
+            return std::vector<Sample>{{{}, double(MacroRunner::getInstance().queueDepth())}};
+        });
+    registry.addCollector("firetv_history_log_queue_size", "Command history writes waiting for the database",
+        "gauge", [] {
+            return std::vector<Sample>{{{}, double(CommandController::backgroundLogger().queueSize())}};
+        });
+    registry.addCollector("firetv_history_log_dropped_total", "Command history writes dropped (queue full)",
+        "counter", [] {
+            return std::vector<Sample>{{{}, double(CommandController::backgroundLogger().droppedCount())}};
+        });
+    registry.addCollector("firetv_deadline_cancellations_total", "Commands cancelled by their deadline, by stage",
+        "counter", [] {
+            std::vector<Sample> samples;
+            for (auto stage : {Deadline::Stage::Queue, Deadline::Stage::Wake, Deadline::Stage::Transport}) {
+                samples.push_back({{{"stage", Deadline::stageName(stage)}},
+                                   double(Deadline::cancelledCount(stage))});
+            }
+            return samples;
+        });
+}
+
 int main() {
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
@@ -41,13 +127,15 @@ int main() {
     std::cout << "Starting HMS FireTV v1.0.6\n";
     std::cout << "================================================================================\n";
 
+    // Logging: LOG_LEVEL/LOG_FORMAT, written by a background thread from here on
+    hms_firetv::Logger::getInstance().configureFromEnv();
+    hms_firetv::Logger::getInstance().start();
+
     try {
         // Load configuration
         std::string api_host     = ConfigManager::getEnv("API_HOST", "0.0.0.0");
         int api_port             = ConfigManager::getEnvInt("API_PORT", 8888);
-        int thread_num           = ConfigManager::getEnvInt("THREAD_NUM", 4);
-        int idle_timeout         = ConfigManager::getEnvInt("IDLE_CONNECTION_TIMEOUT", 60);
-        std::string log_level    = ConfigManager::getEnv("LOG_LEVEL", "info");
+        ServerProfile server     = ServerProfile::fromEnv();
         std::string mqtt_broker  = ConfigManager::getEnv("MQTT_BROKER_HOST", "192.168.2.15");
         int mqtt_port            = ConfigManager::getEnvInt("MQTT_BROKER_PORT", 1883);
         std::string mqtt_user    = ConfigManager::getEnv("MQTT_USER", "aamat");
@@ -63,7 +151,8 @@ int main() {
         }
 
         std::cout << "Configuration:\n";
-        std::cout << "  API: " << api_host << ":" << api_port << "\n";
+        std::cout << "  API: " << api_host << ":" << api_port << " (" << server.threads << " threads"
+                  << (server.reuse_port ? ", SO_REUSEPORT" : "") << ")\n";
         std::cout << "  DB type: " << config.database.type << "\n";
         if (config.database.type == "sqlite")
             std::cout << "  DB path: " << config.database.sqlite_path << "\n";
@@ -100,6 +189,7 @@ int main() {
         // Inject DB into repositories and StatsController
         DeviceRepository::setDatabase(db);
         AppsRepository::setDatabase(db);
+        MacroRepository::setDatabase(db);
         StatsController::setDatabase(db);
         PairingController::setDatabase(db);
 
@@ -107,6 +197,16 @@ int main() {
         CommandController::initBackgroundLogger();
         std::cout << "  ✓ Background logger initialized\n";
 
+        CommandController::startClientCacheSweeper();
+
+        // Held navigation keys repeat over the async client's keep-alive connection
+        KeyRepeatService::setSender([](const Device& device, const LightningStep& step,
+                                       KeyRepeatService::SendCallback done) {
+            AsyncLightningClient::post(device, step.path, step.body,
+                [done = std::move(done)](CommandResult result) { done(result.success); },
+                KeyRepeatService::PRESS_TIMEOUT_SECONDS);
+        });
+
         // MQTT — connect in background so startup is never blocked by broker availability
         auto mqtt_client = std::make_shared<MQTTClient>("hms_firetv");
         std::atomic<bool> mqtt_stop{false};
@@ -137,17 +237,82 @@ int main() {
                                         int published = 0;
                                         for (const auto& d : devices)
                                             if (discovery_publisher->publishDevice(d)) published++;
-                                        std::cout << "[HA_STATUS] Republished " << published << "/" << devices.size() << " devices\n";
+                                        LOG_INFO("HA_STATUS") << "Republished " << published << "/" << devices.size() << " devices";
                                     } catch (...) {}
                                 }
                             });
 
+                        // Commands carrying a "request_id" get a completion notice with the
+                        // latency breakdown on maestro_hub/firetv/{device_id}/result (used by tools/loadgen);
+                        // a macro's notice carries its per-step result and is sent once it has run
+                        std::weak_ptr<MQTTClient> weak_mqtt = mqtt_client;
                         mqtt_client->subscribeToAllCommands(
-                            [command_handler](const std::string& device_id, const Json::Value& payload) {
-                                command_handler->handleCommand(device_id, payload);
+                            [command_handler, weak_mqtt](const std::string& device_id, const Json::Value& payload) {
+                                auto publish_result = [weak_mqtt, device_id,
+                                                       request_id = payload["request_id"]](Json::Value result) {
+                                    auto mqtt = weak_mqtt.lock();
+                                    if (!mqtt) return;
+                                    result["request_id"] = request_id;
+                                    Json::StreamWriterBuilder writer;
+                                    writer["indentation"] = "";
+                                    mqtt->publish("maestro_hub/firetv/" + device_id + "/result",
+                                                  Json::writeString(writer, result));
+                                };
+                                bool wants_result = payload["request_id"].isString();
+
+                                CommandHandler::MacroCallback on_macro;
+                                if (wants_result) {
+                                    on_macro = [publish_result](const SequenceResult& sequence) {
+                                        publish_result(sequence.toJson());
+                                    };
+                                }
+                                CommandTiming timing;
+                                bool success = command_handler->handleCommand(device_id, payload, &timing, on_macro);
+                                if (!wants_result || payload["command"].asString() == "macro") return;
+
+                                Json::Value result;
+                                result["success"] = success;
+                                if (timing.measured()) {
+                                    result["timing"] = timing.toJson();
+                                }
+                                publish_result(std::move(result));
                             });
                         std::cout << "  ✓ Subscribed to all command topics\n";
 
+                        // Fleet-wide commands: same body as POST /api/broadcast,
+                        // aggregated result published when the last device is done
+                        mqtt_client->subscribe("maestro_hub/firetv/broadcast/set",
+                            [weak_mqtt](const std::string&, const std::string& payload) {
+                                Json::Value body;
+                                Json::CharReaderBuilder reader;
+                                std::string error;
+                                std::istringstream stream(payload);
+                                if (!Json::parseFromStream(reader, stream, &body, &error)) {
+                                    LOG_ERROR("Broadcast") << "Invalid JSON payload: " << error;
+                                    return;
+                                }
+                                auto request = BroadcastService::parseRequest(body, error);
+                                if (!request) {
+                                    LOG_ERROR("Broadcast") << "Rejected: " << error;
+                                    return;
+                                }
+                                std::string command = request->step.command;
+                                BroadcastService::getInstance().broadcast(std::move(request->devices),
+                                    std::move(request->step), request->pre_wake, request->concurrency,
+                                    request->deadline,
+                                    [weak_mqtt, command](BroadcastResult result) {
+                                        auto mqtt = weak_mqtt.lock();
+                                        if (!mqtt) return;
+                                        Json::Value json = result.toJson();
+                                        json["command"] = command;
+                                        Json::StreamWriterBuilder writer;
+                                        writer["indentation"] = "";
+                                        mqtt->publish("maestro_hub/firetv/broadcast/result",
+                                                      Json::writeString(writer, json));
+                                    });
+                            });
+                        std::cout << "  ✓ Subscribed to broadcast topic\n";
+
                         // Paho handles reconnect from here — thread's job is done
                         return;
                     }
@@ -169,93 +334,161 @@ int main() {
         DiscoveryService::getInstance().start();
         std::cout << "  ✓ DiscoveryService started (every " << discovery_interval << "s)\n";
 
+        // Per-device SLOs: degraded/recovered events on maestro_hub/firetv/{device_id}/slo and /api/stream
+        DeviceSloTracker::getInstance().setAlertListener(
+            [weak_mqtt = std::weak_ptr<MQTTClient>(mqtt_client)](const DeviceSloTracker::Snapshot& snapshot) {
+                Json::Value state;
+                state["slo"] = DeviceSloTracker::stateName(snapshot.state);
+                EventBus::getInstance().deviceState(snapshot.device_id, state);
+
+                auto mqtt = weak_mqtt.lock();
+                if (!mqtt || !mqtt->isConnected()) return;
+                Json::StreamWriterBuilder writer;
+                writer["indentation"] = "";
+                mqtt->publish("maestro_hub/firetv/" + snapshot.device_id + "/slo",
+                              Json::writeString(writer, snapshot.toJson()));
+            });
+        DeviceSloTracker::getInstance().start();
+        std::cout << "  ✓ DeviceSloTracker started (p95 <= "
+                  << DeviceSloTracker::getInstance().options().max_p95.count() << "ms over "
+                  << DeviceSloTracker::getInstance().options().window.count() << "s)\n";
+
         std::cout << "Services initialized\n";
         std::cout << "--------------------------------------------------------------------------------\n";
 
         // HTTP server
-        app().setLogLevel(trantor::Logger::LogLevel::kInfo)
+        app().setLogLevel(drogonLogLevel(hms_firetv::Logger::getInstance().level()))
             .addListener(api_host, api_port)
-            .setThreadNum(thread_num)
-            .setIdleConnectionTimeout(idle_timeout)
-            .setMaxConnectionNum(10000)
-            .setMaxConnectionNumPerIP(0)
-            .setClientMaxBodySize(10 * 1024 * 1024)
+            .setThreadNum(server.threads)
+            .enableReusePort(server.reuse_port)
+            .setIdleConnectionTimeout(server.idle_timeout_seconds)
+            .setKeepaliveRequestsNumber(server.keepalive_requests)
+            .setPipeliningRequestsNumber(server.pipelining_requests)
+            .setMaxConnectionNum(server.max_connections)
+            .setMaxConnectionNumPerIP(server.max_connections_per_ip)
+            .setClientMaxBodySize(server.max_body_bytes)
             .setDocumentRoot("./static")
             .setStaticFilesCacheTime(3600);
 
-        // SPA fallback
-        std::string spa_fallback;
-        {
-            std::ifstream ifs("./static/index.html");
-            if (ifs.good())
-                spa_fallback = std::string(std::istreambuf_iterator<char>(ifs), {});
+        if (server.tcp_nodelay) {
+            app().setAfterAcceptSockOptCallback([](int fd) {
+                int on = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            });
+        }
+
+        // Per-route body caps. Checked after Drogon has read the body (up to the
+        // global cap above, the only memory bound), so they only reject.
+        app().registerPreRoutingAdvice(
+            [server](const HttpRequestPtr& req, AdviceCallback&& acb, AdviceChainCallback&& accb) {
+                size_t limit = server.bodyLimitFor(req->path());
+                if (req->body().size() > limit) {
+                    Json::Value err;
+                    err["success"] = false;
+                    err["error"] = "Request body too large (limit " + std::to_string(limit) + " bytes)";
+                    auto resp = HttpResponse::newHttpJsonResponse(err);
+                    resp->setStatusCode(k413RequestEntityTooLarge);
+                    acb(resp);
+                    return;
+                }
+                accb();
+            });
+
+        // Web UI: loaded and precompressed once, served from memory (disk for anything skipped)
+        auto static_assets = std::make_shared<StaticAssets>([] {
+            StaticAssets::Options options;
+            options.max_file_bytes = static_cast<size_t>(std::max(1, ConfigManager::getEnvInt("STATIC_MAX_FILE_KB", 4096))) * 1024;
+            return options;
+        }());
+        if (static_assets->loadDirectory("./static") > 0) {
+            StaticAssetServer::install(static_assets);
+            std::cout << "  ✓ Static assets in memory: " << static_assets->fileCount() << " files, "
+                      << static_assets->bytes(StaticAssets::Encoding::Identity) / 1024 << " KB ("
+                      << static_assets->bytes(StaticAssets::Encoding::Gzip) / 1024 << " KB gzip, "
+                      << static_assets->bytes(StaticAssets::Encoding::Brotli) / 1024 << " KB br)\n";
         }
-        if (!spa_fallback.empty()) {
+
+        // SPA fallback: client-side routes get index.html (same response as "/")
+        if (static_assets->index()) {
             app().setCustomErrorHandler(
-                [spa_fallback](HttpStatusCode code, const HttpRequestPtr& req) -> HttpResponsePtr {
+                [](HttpStatusCode code, const HttpRequestPtr& req) -> HttpResponsePtr {
                     if (code == k404NotFound) {
                         const auto& path = req->path();
-                        if (path.find("/api/") == 0 || path == "/health" || path == "/status") {
+                        if (path.find("/api/") == 0 || path.find("/health") == 0 || path == "/status") {
                             Json::Value err; err["success"] = false; err["error"] = "Not found: " + path;
                             return HttpResponse::newHttpJsonResponse(err);
                         }
-                        auto resp = HttpResponse::newHttpResponse();
-                        resp->setStatusCode(k200OK);
-                        resp->setContentTypeCode(CT_TEXT_HTML);
-                        resp->setBody(spa_fallback);
-                        return resp;
+                        return StaticAssetServer::spaFallback(req);
                     }
                     return nullptr;
                 });
         }
 
-        // Health endpoint
-        app().registerHandler("/health",
-            [mqtt_client, &config, db](const HttpRequestPtr&,
-                std::function<void(const HttpResponsePtr&)>&& callback) {
-                Json::Value r;
-                r["service"] = "HMS FireTV";
-                r["version"] = "1.0.6";
-                r["db_type"] = config.database.type;
-                bool db_ok   = db && db->isConnected();
-                bool mqtt_ok = mqtt_client && mqtt_client->isConnected();
-                r["database"] = db_ok ? "connected" : "disconnected";
-                r["mqtt"]     = mqtt_ok ? "connected" : "disconnected";
-                r["status"]   = (db_ok && mqtt_ok) ? "healthy" : "degraded";
-                auto resp = HttpResponse::newHttpJsonResponse(r);
-                resp->setStatusCode((db_ok && mqtt_ok) ? k200OK : k503ServiceUnavailable);
-                callback(resp);
-            }, {Get});
+        // Health and status: served from ServiceStatus (atomic flags, device
+        // counters, cached bodies) so frequent polling never touches the database
+        auto& service_status = ServiceStatus::getInstance();
+        service_status.setInfo({"HMS FireTV", "1.0.6", config.database.type, mqtt_addr});
+        service_status.setDatabaseConnected(db && db->isConnected());
+        try {
+            service_status.resetDevices(DeviceRepository::getInstance().getAllDevices());
+        } catch (const std::exception& e) {
+            LOG_WARN("Main") << "Could not load device counts: " << e.what();
+        }
+        service_status.setDetailsProvider([server_json = server.toJson()](Json::Value& r) {
+            r["server"] = server_json;
+            r["deadlines"]["default_ms"] = static_cast<Json::Int64>(Deadline::defaultBudget().count());
+            for (auto stage : {Deadline::Stage::Queue, Deadline::Stage::Wake, Deadline::Stage::Transport}) {
+                r["deadlines"]["cancelled"][Deadline::stageName(stage)] =
+                    static_cast<Json::UInt64>(Deadline::cancelledCount(stage));
+            }
+            r["text_input"] = TextInputService::getInstance().stats();
+            r["key_repeat"] = KeyRepeatService::getInstance().stats();
+            r["remote"] = RemoteControlService::getInstance().stats();
+            r["tracing"] = Tracer::getInstance().stats();
+            r["slo"] = DeviceSloTracker::getInstance().stats();
+            r["stream"] = StreamController::stats();
+            r["static"] = StaticAssetServer::stats();
+        });
+
+        // The database flag is refreshed here instead of per request
+        app().getLoop()->runEvery(ServiceStatus::DB_CHECK_SECONDS, [db]() {
+            ServiceStatus::getInstance().setDatabaseConnected(db && db->isConnected());
+        });
+
+        auto sendBody = [](ServiceStatus::Body body, bool ok,
+                           std::function<void(const HttpResponsePtr&)>& callback) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(ok ? k200OK : k503ServiceUnavailable);
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            resp->addHeader("Cache-Control", "no-store");
+            resp->setBody(*body);
+            callback(resp);
+        };
+
+        for (auto [path, probe] : {std::pair{"/health", ServiceStatus::Probe::Health},
+                                   std::pair{"/health/live", ServiceStatus::Probe::Live},
+                                   std::pair{"/health/ready", ServiceStatus::Probe::Ready}}) {
+            app().registerHandler(path,
+                [sendBody, probe = probe](const HttpRequestPtr&,
+                    std::function<void(const HttpResponsePtr&)>&& callback) {
+                    auto& status = ServiceStatus::getInstance();
+                    sendBody(status.probeBody(probe), status.passes(probe), callback);
+                }, {Get});
+        }
 
-        // Status endpoint
         app().registerHandler("/status",
-            [mqtt_client, &config, db, mqtt_addr](const HttpRequestPtr&,
-                std::function<void(const HttpResponsePtr&)>&& callback) {
-                Json::Value r;
-                r["service"] = "HMS FireTV";
-                r["version"] = "1.0.6";
-                r["status"]  = "running";
-                bool db_ok   = db && db->isConnected();
-                bool mqtt_ok = mqtt_client && mqtt_client->isConnected();
-                r["connections"]["database"] = db_ok ? "connected" : "disconnected";
-                r["connections"]["mqtt"]     = mqtt_ok ? "connected" : "disconnected";
-                r["config"]["db_type"]       = config.database.type;
-                r["config"]["mqtt_broker"]   = mqtt_addr;
-                try {
-                    auto devices = DeviceRepository::getInstance().getAllDevices();
-                    int paired = 0, online = 0;
-                    for (const auto& d : devices) {
-                        if (d.isPaired()) paired++;
-                        if (d.isOnline()) online++;
-                    }
-                    r["devices"]["total"]  = static_cast<int>(devices.size());
-                    r["devices"]["paired"] = paired;
-                    r["devices"]["online"] = online;
-                } catch (...) {
-                    r["devices"]["total"] = 0;
-                }
-                auto resp = HttpResponse::newHttpJsonResponse(r);
+            [sendBody](const HttpRequestPtr&, std::function<void(const HttpResponsePtr&)>&& callback) {
+                sendBody(ServiceStatus::getInstance().statusBody(), true, callback);
+            }, {Get});
+
+        // Prometheus scrape endpoint
+        registerMetricCollectors();
+        app().registerHandler("/metrics",
+            [](const HttpRequestPtr&, std::function<void(const HttpResponsePtr&)>&& callback) {
+                auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k200OK);
+                resp->setContentTypeString(MetricsRegistry::CONTENT_TYPE);
+                resp->setBody(MetricsRegistry::getInstance().render());
                 callback(resp);
             }, {Get});
 
@@ -263,13 +496,24 @@ int main() {
         std::cout << "HMS FireTV ready on " << api_host << ":" << api_port << "\n";
         std::cout << "================================================================================\n";
 
+        ServiceStatus::getInstance().setReady(true);
         app().run();
+        ServiceStatus::getInstance().setReady(false);
 
         mqtt_stop.store(true);
         DiscoveryService::getInstance().stop();
+        DeviceSloTracker::getInstance().stop();
+        KeyRepeatService::getInstance().stop();
+        TextInputService::getInstance().stop();
+        MacroRunner::getInstance().stop();
+        PairingSessionManager::getInstance().stop();
+        CommandController::stopClientCacheSweeper();
         CommandController::shutdownBackgroundLogger();
+        Tracer::getInstance().stop();
+        hms_firetv::Logger::getInstance().stop();
 
     } catch (const std::exception& e) {
+        hms_firetv::Logger::getInstance().stop();
         std::cerr << "Fatal error: " << e.what() << std::endl;
         try { CommandController::shutdownBackgroundLogger(); } catch (...) {}
         return 1;
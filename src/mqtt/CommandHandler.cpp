@@ -1,6 +1,14 @@
 #include "mqtt/CommandHandler.h"
+#include "repositories/MacroRepository.h"
+#include "services/MacroRunner.h"
+#include "services/TextInputService.h"
+#include "services/KeyRepeatService.h"
+#include "services/DeviceSloTracker.h"
+#include "services/EventBus.h"
+#include "utils/Metrics.h"
+#include "utils/Logger.h"
+#include "utils/Trace.h"
 #include <algorithm>
-#include <iostream>
 #include <thread>
 #include <chrono>
 
@@ -11,7 +19,7 @@ namespace hms_firetv {
 // ============================================================================
 
 CommandHandler::CommandHandler() {
-    std::cout << "[CommandHandler] Initialized" << std::endl;
+    LOG_INFO("CommandHandler") << "Initialized";
 
     // Initialize app package mappings
     app_packages_["Netflix"] = "com.netflix.ninja";
@@ -28,84 +36,158 @@ CommandHandler::CommandHandler() {
 // COMMAND HANDLING
 // ============================================================================
 
-void CommandHandler::handleCommand(const std::string& device_id, const Json::Value& payload) {
-    std::cout << "[CommandHandler] Handling command for " << device_id << std::endl;
+bool CommandHandler::handleCommand(const std::string& device_id, const Json::Value& payload,
+                                   CommandTiming* timing, MacroCallback on_macro) {
+    LOG_DEBUG("CommandHandler") << "Handling command for " << device_id;
 
     // Get command from payload
     if (!payload.isMember("command")) {
-        std::cerr << "[CommandHandler] No 'command' field in payload" << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "No 'command' field in payload";
+        return false;
     }
 
     std::string command = payload["command"].asString();
-    std::cout << "[CommandHandler] Command: " << command << std::endl;
+    LOG_DEBUG("CommandHandler") << "Command: " << command;
+
+    // Started by MQTTClient on receipt; a "trace_id" in the payload continues the caller's trace
+    Trace* trace = Trace::current();
+    if (trace) {
+        trace->setCommand(device_id, command);
+        if (payload["trace_id"].isString() && Trace::isValidId(payload["trace_id"].asString())) {
+            trace->adoptId(payload["trace_id"].asString());
+            trace->forceSample();
+        }
+    }
+
+    // Held keys repeat server-side; no lease or wake check per heartbeat
+    if (command == "release" || (command == "navigate" && payload.get("release", false).asBool())) {
+        KeyRepeatService::getInstance().release(device_id);
+        return true;
+    }
+    if (command == "navigate" && payload.get("hold", false).asBool()) {
+        handleHoldCommand(device_id, payload);
+        return true;
+    }
+
+    // Search-as-you-type from the text entity: debounced per device, with no
+    // lease or wake check per keystroke ("stream": false for a one-shot send)
+    if ((command == "send_text" || command == "keyboard_input") &&
+        payload.get("stream", true).asBool() &&
+        payload["text"].isString() &&
+        TextInputService::getInstance().debounce().count() > 0) {
+        TextInputService::getInstance().submit(device_id, payload["text"].asString());
+        return true;
+    }
 
-    // Get Lightning client for device
-    auto client = getClientForDevice(device_id);
+    // Deadline starts on receipt: "timeout_ms" budget in the payload, else COMMAND_DEADLINE_MS
+    int64_t budget_ms = payload["timeout_ms"].isIntegral() ? payload["timeout_ms"].asInt64() : 0;
+    Deadline deadline = Deadline::fromBudget(budget_ms);
+
+    // Macros take their own lease through MacroRunner and finish later
+    if (command == "macro") {
+        return handleMacroCommand(device_id, payload, deadline, std::move(on_macro));
+    }
+
+    auto received = std::chrono::steady_clock::now();
+    auto record = [&](bool success, const char* error) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - received);
+        Metrics::recordCommand(device_id, command, success, elapsed);
+        DeviceSloTracker::getInstance().recordCommand(device_id, success, elapsed);
+        EventBus::getInstance().commandResult(device_id, command, success, elapsed, "mqtt");
+        if (trace) {
+            trace->setResult(success, error);
+        }
+    };
+
+    // Get Lightning client for device (carries the deadline while leased)
+    auto micros_since = [](std::chrono::steady_clock::time_point start) {
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    };
+    CommandTiming phases;
+
+    LightningClientPool::Lease client;
+    {
+        TraceSpan span("queue_wait");
+        client = getClientForDevice(device_id, deadline);
+    }
+    phases.queue_us = micros_since(received);
+    if (timing) {
+        *timing = phases;
+    }
     if (!client) {
-        std::cerr << "[CommandHandler] Failed to get client for device: " << device_id << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "Failed to get client for device: " << device_id;
+        record(false, client.deadlineExceeded() ? Deadline::EXCEEDED : "No client for device");
+        return false;
     }
 
     // Ensure device is awake (skip for turn_on which handles this itself)
     if (command != "turn_on") {
-        if (!ensureDeviceAwake(*client)) {
-            std::cerr << "[CommandHandler] Failed to wake device " << device_id << std::endl;
-            return;
+        auto wake_start = std::chrono::steady_clock::now();
+        bool awake = ensureDeviceAwake(*client);
+        phases.wake_us = micros_since(wake_start);
+        if (!awake) {
+            LOG_ERROR("CommandHandler") << "Failed to wake device " << device_id;
+            record(false, "Device did not wake");
+            if (timing) {
+                *timing = phases;
+            }
+            return false;
         }
     }
 
     // Route command
+    bool success = false;
+    bool known = true;
     if (command.find("media_") == 0) {
-        handleMediaCommand(*client, command);
+        success = handleMediaCommand(*client, command);
     } else if (command.find("volume_") == 0) {
-        handleVolumeCommand(*client, command);
+        success = handleVolumeCommand(*client, command);
     } else if (command == "turn_on" || command == "turn_off") {
-        handlePowerCommand(*client, command);
+        success = handlePowerCommand(*client, command);
     } else if (command == "navigate") {
-        handleNavigationCommand(*client, payload);
+        success = handleNavigationCommand(*client, payload);
     } else if (command == "select_source" || command == "launch_app") {
-        handleAppLaunchCommand(*client, payload);
+        success = handleAppLaunchCommand(*client, payload);
     } else if (command == "send_text" || command == "keyboard_input") {
-        handleTextInputCommand(*client, payload);
+        success = handleTextInputCommand(*client, payload);
     } else {
-        std::cerr << "[CommandHandler] Unknown command: " << command << std::endl;
+        LOG_ERROR("CommandHandler") << "Unknown command: " << command;
+        known = false;
+    }
+    if (known) {
+        record(success, success ? "" : "Command failed");
+    } else if (trace) {
+        trace->setResult(false, "Unknown command");
+    }
+    if (timing) {
+        const CommandTiming& transport = client->lastTiming();
+        phases.dns_us = transport.dns_us;
+        phases.connect_us = transport.connect_us;
+        phases.tls_us = transport.tls_us;
+        phases.ttfb_us = transport.ttfb_us;
+        phases.transfer_us = transport.transfer_us;
+        *timing = phases;
     }
 
     // Update last seen
     DeviceRepository::getInstance().updateLastSeen(device_id, "online");
+    return success;
 }
 
 // ============================================================================
 // CLIENT MANAGEMENT
 // ============================================================================
 
-std::shared_ptr<LightningClient> CommandHandler::getClientForDevice(const std::string& device_id) {
-    std::lock_guard<std::mutex> lock(clients_mutex_);
-
-    // Check cache first
-    auto it = clients_.find(device_id);
-    if (it != clients_.end()) {
-        return it->second;
+LightningClientPool::Lease CommandHandler::getClientForDevice(const std::string& device_id,
+                                                              const Deadline& deadline) {
+    auto client = LightningClientPool::getInstance().lease(device_id, deadline);
+    if (client.deadlineExceeded()) {
+        LOG_ERROR("CommandHandler") << "Deadline exceeded waiting for client: " << device_id;
+    } else if (!client) {
+        LOG_ERROR("CommandHandler") << "Device not found: " << device_id;
     }
-
-    // Get device from database
-    auto device = DeviceRepository::getInstance().getDeviceById(device_id);
-    if (!device.has_value()) {
-        std::cerr << "[CommandHandler] Device not found: " << device_id << std::endl;
-        return nullptr;
-    }
-
-    // Create Lightning client
-    auto client = std::make_shared<LightningClient>(
-        device->ip_address,
-        device->api_key,
-        device->client_token.value_or("")
-    );
-
-    // Cache client
-    clients_[device_id] = client;
-
     return client;
 }
 
@@ -113,7 +195,7 @@ std::shared_ptr<LightningClient> CommandHandler::getClientForDevice(const std::s
 // COMMAND HANDLERS
 // ============================================================================
 
-void CommandHandler::handleMediaCommand(LightningClient& client, const std::string& command) {
+bool CommandHandler::handleMediaCommand(LightningClient& client, const std::string& command) {
     CommandResult result;
 
     if (command == "media_play_pause" || command == "media_play") {
@@ -127,20 +209,21 @@ void CommandHandler::handleMediaCommand(LightningClient& client, const std::stri
     } else if (command == "media_previous_track") {
         result = client.scanBackward();
     } else {
-        std::cerr << "[CommandHandler] Unknown media command: " << command << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "Unknown media command: " << command;
+        return false;
     }
 
     if (result.success) {
-        std::cout << "[CommandHandler] ✅ Media command succeeded ("
-                  << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("CommandHandler") << "✅ Media command succeeded ("
+                                    << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[CommandHandler] ❌ Media command failed: "
-                  << result.status_code << std::endl;
+        LOG_ERROR("CommandHandler") << "❌ Media command failed: "
+                                    << result.status_code;
     }
+    return result.success;
 }
 
-void CommandHandler::handleVolumeCommand(LightningClient& client, const std::string& command) {
+bool CommandHandler::handleVolumeCommand(LightningClient& client, const std::string& command) {
     CommandResult result;
 
     if (command == "volume_up") {
@@ -150,20 +233,21 @@ void CommandHandler::handleVolumeCommand(LightningClient& client, const std::str
     } else if (command == "volume_mute") {
         result = client.sendNavigationCommand("volume_mute");
     } else {
-        std::cerr << "[CommandHandler] Unknown volume command: " << command << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "Unknown volume command: " << command;
+        return false;
     }
 
     if (result.success) {
-        std::cout << "[CommandHandler] ✅ Volume command succeeded ("
-                  << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("CommandHandler") << "✅ Volume command succeeded ("
+                                    << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[CommandHandler] ❌ Volume command failed: "
-                  << result.status_code << std::endl;
+        LOG_ERROR("CommandHandler") << "❌ Volume command failed: "
+                                    << result.status_code;
     }
+    return result.success;
 }
 
-void CommandHandler::handleNavigationCommand(LightningClient& client, const Json::Value& payload) {
+bool CommandHandler::handleNavigationCommand(LightningClient& client, const Json::Value& payload) {
     CommandResult result;
 
     // Check for direction
@@ -179,8 +263,8 @@ void CommandHandler::handleNavigationCommand(LightningClient& client, const Json
         } else if (direction == "right") {
             result = client.dpadRight();
         } else {
-            std::cerr << "[CommandHandler] Unknown direction: " << direction << std::endl;
-            return;
+            LOG_ERROR("CommandHandler") << "Unknown direction: " << direction;
+            return false;
         }
     }
     // Check for action
@@ -196,48 +280,52 @@ void CommandHandler::handleNavigationCommand(LightningClient& client, const Json
         } else if (action == "menu") {
             result = client.menu();
         } else {
-            std::cerr << "[CommandHandler] Unknown action: " << action << std::endl;
-            return;
+            LOG_ERROR("CommandHandler") << "Unknown action: " << action;
+            return false;
         }
     } else {
-        std::cerr << "[CommandHandler] Navigate command missing direction or action" << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "Navigate command missing direction or action";
+        return false;
     }
 
     if (result.success) {
-        std::cout << "[CommandHandler] ✅ Navigation command succeeded ("
-                  << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("CommandHandler") << "✅ Navigation command succeeded ("
+                                    << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[CommandHandler] ❌ Navigation command failed: "
-                  << result.status_code << std::endl;
+        LOG_ERROR("CommandHandler") << "❌ Navigation command failed: "
+                                    << result.status_code;
     }
+    return result.success;
 }
 
-void CommandHandler::handlePowerCommand(LightningClient& client, const std::string& command) {
+bool CommandHandler::handlePowerCommand(LightningClient& client, const std::string& command) {
     CommandResult result;
 
     if (command == "turn_on") {
         // Wake device
         bool woke = client.wakeDevice();
         if (woke) {
-            std::cout << "[CommandHandler] ✅ Device wake command sent" << std::endl;
-            // Wait for device to boot
-            std::this_thread::sleep_for(std::chrono::seconds(3));
+            LOG_INFO("CommandHandler") << "✅ Device wake command sent";
+            // Wait for device to boot (no longer than the command may take)
+            auto booted_at = Deadline::Clock::now() + std::chrono::seconds(3);
+            std::this_thread::sleep_until(std::min(booted_at, client.deadline().at()));
         } else {
-            std::cerr << "[CommandHandler] ❌ Wake command failed" << std::endl;
+            LOG_ERROR("CommandHandler") << "❌ Wake command failed";
         }
+        return woke;
     } else if (command == "turn_off") {
         // Send sleep command
         result = client.sleep();
         if (result.success) {
-            std::cout << "[CommandHandler] ✅ Sleep command succeeded" << std::endl;
+            LOG_DEBUG("CommandHandler") << "✅ Sleep command succeeded";
         } else {
-            std::cerr << "[CommandHandler] ❌ Sleep command failed" << std::endl;
+            LOG_ERROR("CommandHandler") << "❌ Sleep command failed";
         }
     }
+    return result.success;
 }
 
-void CommandHandler::handleAppLaunchCommand(LightningClient& client, const Json::Value& payload) {
+bool CommandHandler::handleAppLaunchCommand(LightningClient& client, const Json::Value& payload) {
     std::string package;
 
     // Check for package name directly
@@ -250,25 +338,26 @@ void CommandHandler::handleAppLaunchCommand(LightningClient& client, const Json:
         package = getPackageForApp(app_name);
 
         if (package.empty()) {
-            std::cerr << "[CommandHandler] Unknown app: " << app_name << std::endl;
-            return;
+            LOG_ERROR("CommandHandler") << "Unknown app: " << app_name;
+            return false;
         }
     } else {
-        std::cerr << "[CommandHandler] App launch missing 'package' or 'source'" << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "App launch missing 'package' or 'source'";
+        return false;
     }
 
     // Launch app
-    std::cout << "[CommandHandler] Launching app: " << package << std::endl;
+    LOG_DEBUG("CommandHandler") << "Launching app: " << package;
     auto result = client.launchApp(package);
 
     if (result.success) {
-        std::cout << "[CommandHandler] ✅ App launched successfully ("
-                  << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("CommandHandler") << "✅ App launched successfully ("
+                                    << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[CommandHandler] ❌ App launch failed: "
-                  << result.status_code << std::endl;
+        LOG_ERROR("CommandHandler") << "❌ App launch failed: "
+                                    << result.status_code;
     }
+    return result.success;
 }
 
 // ============================================================================
@@ -299,33 +388,67 @@ std::string CommandHandler::getPackageForApp(const std::string& app_name) {
 
 bool CommandHandler::ensureDeviceAwake(LightningClient& client) {
     // Check if Lightning API is responding
-    if (client.isLightningApiAvailable()) {
-        return true;  // Already awake
+    {
+        TraceSpan probe("wake_probe");
+        if (client.isLightningApiAvailable()) {
+            return true;  // Already awake
+        }
+        probe.note("asleep");
     }
 
-    std::cout << "[CommandHandler] Device appears to be asleep, attempting wake..." << std::endl;
+    LOG_INFO("CommandHandler") << "Device appears to be asleep, attempting wake...";
+    TraceSpan wake("wake");
 
     // Try to wake the device
     if (!client.wakeDevice()) {
-        std::cerr << "[CommandHandler] Wake request failed" << std::endl;
+        LOG_ERROR("CommandHandler") << "Wake request failed";
+        wake.fail("Wake request failed");
         return false;
     }
 
-    // Wait for device to wake up (typically takes 2-5 seconds)
+    // Wait for device to wake up (typically takes 2-5 seconds), but only while
+    // the command can still make its deadline
+    const Deadline& deadline = client.deadline();
     for (int attempt = 0; attempt < 5; ++attempt) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        auto next_poll = Deadline::Clock::now() + std::chrono::milliseconds(1000);
+        if (deadline.isSet() && next_poll >= deadline.at()) {
+            Deadline::recordCancelled(Deadline::Stage::Wake);
+            LOG_ERROR("CommandHandler") << "Deadline exceeded waiting for device to wake";
+            wake.fail(Deadline::EXCEEDED);
+            return false;
+        }
+        std::this_thread::sleep_until(next_poll);
 
         if (client.isLightningApiAvailable()) {
-            std::cout << "[CommandHandler] Device woke up after " << (attempt + 1) << "s" << std::endl;
+            LOG_INFO("CommandHandler") << "Device woke up after " << (attempt + 1) << "s";
+            wake.note("woke after " + std::to_string(attempt + 1) + " polls");
             return true;
         }
     }
 
-    std::cerr << "[CommandHandler] Device did not wake up after 5 seconds" << std::endl;
+    LOG_ERROR("CommandHandler") << "Device did not wake up after 5 seconds";
+    wake.fail("Device did not wake up");
     return false;
 }
 
-void CommandHandler::handleTextInputCommand(LightningClient& client, const Json::Value& payload) {
+void CommandHandler::handleHoldCommand(const std::string& device_id, const Json::Value& payload) {
+    std::string error;
+    auto step = KeyRepeatService::navigationStep(payload, error);
+    if (!step) {
+        LOG_ERROR("CommandHandler") << "Invalid hold: " << error;
+        return;
+    }
+
+    auto device = DeviceRepository::getInstance().getDeviceById(device_id);
+    if (!device) {
+        LOG_ERROR("CommandHandler") << "Device not found: " << device_id;
+        return;
+    }
+
+    KeyRepeatService::getInstance().hold(device.value(), step.value());
+}
+
+bool CommandHandler::handleTextInputCommand(LightningClient& client, const Json::Value& payload) {
     std::string text;
 
     // Check for text field (from text entity)
@@ -337,26 +460,94 @@ void CommandHandler::handleTextInputCommand(LightningClient& client, const Json:
         text = payload.asString();
     }
     else {
-        std::cerr << "[CommandHandler] Text input missing 'text' field" << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "Text input missing 'text' field";
+        return false;
     }
 
     if (text.empty()) {
-        std::cerr << "[CommandHandler] Text input is empty" << std::endl;
-        return;
+        LOG_ERROR("CommandHandler") << "Text input is empty";
+        return false;
     }
 
     // Send keyboard input
-    std::cout << "[CommandHandler] Sending keyboard input: " << text << std::endl;
+    LOG_DEBUG("CommandHandler") << "Sending keyboard input: " << text;
     auto result = client.sendKeyboardInput(text);
 
     if (result.success) {
-        std::cout << "[CommandHandler] ✅ Text input sent successfully ("
-                  << result.response_time_ms << "ms)" << std::endl;
+        LOG_DEBUG("CommandHandler") << "✅ Text input sent successfully ("
+                                    << result.response_time_ms << "ms)";
     } else {
-        std::cerr << "[CommandHandler] ❌ Text input failed: "
-                  << result.status_code << std::endl;
+        LOG_ERROR("CommandHandler") << "❌ Text input failed: "
+                                    << result.status_code;
     }
+    return result.success;
+}
+
+bool CommandHandler::handleMacroCommand(const std::string& device_id, const Json::Value& payload,
+                                        const Deadline& deadline, MacroCallback done) {
+    auto received = std::chrono::steady_clock::now();
+    auto record = [device_id, received](bool success) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - received);
+        Metrics::recordCommand(device_id, "macro", success, elapsed);
+        DeviceSloTracker::getInstance().recordCommand(device_id, success, elapsed);
+        EventBus::getInstance().commandResult(device_id, "macro", success, elapsed, "mqtt");
+    };
+
+    std::shared_ptr<const LightningSequence> sequence;
+    std::string label;
+    std::string error;
+
+    if (payload.isMember("name")) {
+        label = payload["name"].asString();
+        sequence = MacroRepository::getInstance().getCompiled(label);
+        if (!sequence) {
+            error = "Unknown macro: " + label;
+        }
+    } else if (payload.isMember("steps")) {
+        label = "inline";
+        sequence = compileSequence(payload["steps"], error);
+        if (!sequence) {
+            error = "Invalid macro steps: " + error;
+        }
+    } else {
+        error = "Macro missing 'name' or 'steps' field";
+    }
+
+    if (!sequence) {
+        LOG_ERROR("CommandHandler") << error;
+        record(false);
+        if (Trace* trace = Trace::current()) {
+            trace->setResult(false, error);
+        }
+        if (done) {
+            SequenceResult result;
+            result.error = error;
+            done(result);
+        }
+        return false;
+    }
+
+    size_t step_count = sequence->size();
+    MacroRunner::getInstance().runAsync(device_id, std::move(sequence),
+        payload.get("stop_on_error", true).asBool(), deadline,
+        [device_id, label, step_count, record, done = std::move(done)](SequenceResult result) {
+        record(result.success);
+
+        if (result.success) {
+            LOG_DEBUG("CommandHandler") << "✅ Macro '" << label << "' ran "
+                                        << result.steps_run << " steps (" << result.total_ms << "ms)";
+            DeviceRepository::getInstance().updateLastSeen(device_id, "online");
+        } else {
+            LOG_ERROR("CommandHandler") << "❌ Macro '" << label << "' failed after "
+                                        << result.steps_run << "/" << step_count << " steps"
+                                        << (result.error ? ": " + *result.error : "");
+        }
+        if (done) {
+            done(result);
+        }
+    });
+    return true;
 }
 
 } // namespace hms_firetv
@@ -0,0 +1,108 @@
+#include "mqtt/CommandTopic.h"
+#include <sstream>
+
+namespace hms_firetv {
+
+std::string CommandTopic::deviceId(const std::string& topic) {
+    // Extract device_id from: maestro_hub/colada/{device_id}/{action}
+    static const std::string prefix = PREFIX;
+
+    size_t prefix_pos = topic.find(prefix);
+    if (prefix_pos == std::string::npos) {
+        return "";
+    }
+
+    size_t start = prefix_pos + prefix.length();
+    size_t slash_pos = topic.find('/', start);
+
+    if (slash_pos == std::string::npos) {
+        return "";
+    }
+
+    return topic.substr(start, slash_pos - start);
+}
+
+std::optional<CommandTopic::Message> CommandTopic::parse(const std::string& topic,
+                                                         const std::string& payload_str,
+                                                         std::string& error) {
+    Message message;
+    message.device_id = deviceId(topic);
+    if (message.device_id.empty()) {
+        error = "Failed to extract device_id from topic: " + topic;
+        return std::nullopt;
+    }
+
+    // Action is the rest of the topic after the device_id
+    std::string prefix = PREFIX + message.device_id + "/";
+    size_t action_pos = topic.find(prefix);
+    if (action_pos != std::string::npos) {
+        message.action = topic.substr(action_pos + prefix.length());
+    }
+    const std::string& action = message.action;
+
+    // Convert button press to JSON command format that CommandHandler expects
+    Json::Value& payload = message.payload;
+    if (action == "send_text") {
+        // Text input from text entity - payload is the text string
+        payload["command"] = "send_text";
+        payload["text"] = payload_str;
+    } else if (action == "macro" && !payload_str.empty() && payload_str[0] != '{') {
+        // Named macro - payload is the macro name
+        payload["command"] = "macro";
+        payload["name"] = payload_str;
+    } else if ((payload_str == "HOLD" || payload_str == "RELEASE") &&
+               (action.find("dpad_") == 0 || action == "select" || action == "home" ||
+                action == "back" || action == "menu")) {
+        // Long press on a navigation button: HOLD starts (or heartbeats) the
+        // server-side repeat, RELEASE stops it
+        payload["command"] = "navigate";
+        if (action.find("dpad_") == 0) {
+            payload["direction"] = action.substr(5);
+        } else {
+            payload["action"] = action;
+        }
+        payload[payload_str == "HOLD" ? "hold" : "release"] = true;
+    } else if (payload_str == "PRESS" && !action.empty()) {
+        // Button press - convert action to command format
+        // Map Python action names to our command format
+        if (action.find("dpad_") == 0) {
+            // Navigation: dpad_up, dpad_down, etc.
+            std::string direction = action.substr(5); // Remove "dpad_" prefix
+            payload["command"] = "navigate";
+            payload["direction"] = direction;
+        } else if (action == "select" || action == "home" || action == "back" || action == "menu") {
+            // Navigation actions
+            payload["command"] = "navigate";
+            payload["action"] = action;
+        } else if (action == "play" || action == "pause") {
+            // Media controls
+            payload["command"] = "media_" + action;
+        } else if (action == "volume_up" || action == "volume_down" || action == "mute") {
+            // Volume controls
+            payload["command"] = action;
+        } else if (action == "sleep") {
+            // Power off
+            payload["command"] = "turn_off";
+        } else if (action == "wake") {
+            // Power on
+            payload["command"] = "turn_on";
+        } else {
+            error = "Unknown button action: " + action;
+            return std::nullopt;
+        }
+    } else {
+        // Try to parse as JSON (for backwards compatibility)
+        Json::CharReaderBuilder reader;
+        std::string errors;
+        std::istringstream stream(payload_str);
+
+        if (!Json::parseFromStream(reader, stream, &payload, &errors)) {
+            error = "JSON parse error: " + errors;
+            return std::nullopt;
+        }
+    }
+
+    return message;
+}
+
+} // namespace hms_firetv
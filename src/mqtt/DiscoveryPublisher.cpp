@@ -1,5 +1,6 @@
 #include "mqtt/DiscoveryPublisher.h"
-#include <iostream>
+#include "utils/Logger.h"
+#include <map>
 
 namespace hms_firetv {
 
@@ -9,62 +10,81 @@ namespace hms_firetv {
 
 DiscoveryPublisher::DiscoveryPublisher(MQTTClient& mqtt_client)
     : mqtt_client_(mqtt_client) {
-    std::cout << "[DiscoveryPublisher] Initialized" << std::endl;
+    LOG_INFO("DiscoveryPublisher") << "Initialized";
 }
 
 // ============================================================================
 // PUBLIC METHODS
 // ============================================================================
 
-bool DiscoveryPublisher::publishDevice(const Device& device) {
-    std::cout << "[DiscoveryPublisher] Publishing button discovery for " << device.device_id << std::endl;
+// Python service publishes 15 button entities per device
+const std::vector<std::string> DiscoveryPublisher::BUTTONS = {
+    // Navigation
+    "up", "down", "left", "right", "select",
+    // Media
+    "play", "pause",
+    // System
+    "home", "back", "menu",
+    // Volume
+    "volume_up", "volume_down", "mute",
+    // Power
+    "sleep", "wake"
+};
+
+std::vector<DiscoveryPublisher::Message> DiscoveryPublisher::buildMessages(const Device& device) {
+    Json::StreamWriterBuilder writer;
+    std::vector<Message> messages;
+    messages.reserve(BUTTONS.size() + 1);
+
+    for (const auto& button : BUTTONS) {
+        // Topic: homeassistant/button/colada/{device_id}_{button}/config
+        messages.push_back({
+            "homeassistant/button/colada/" + device.device_id + "_" + button + "/config",
+            Json::writeString(writer, buildButtonConfig(device, button))
+        });
+    }
 
-    // Python service publishes 15 button entities per device
-    std::vector<std::string> buttons = {
-        // Navigation
-        "up", "down", "left", "right", "select",
-        // Media
-        "play", "pause",
-        // System
-        "home", "back", "menu",
-        // Volume
-        "volume_up", "volume_down", "mute",
-        // Power
-        "sleep", "wake"
-    };
+    // Topic: homeassistant/text/colada/{device_id}_text_input/config
+    messages.push_back({
+        "homeassistant/text/colada/" + device.device_id + "_text_input/config",
+        Json::writeString(writer, buildTextConfig(device))
+    });
+    return messages;
+}
 
-    size_t published = 0;
-    for (const auto& button : buttons) {
-        Json::Value config = buildButtonConfig(device, button);
+bool DiscoveryPublisher::publishDevice(const Device& device) {
+    LOG_INFO("DiscoveryPublisher") << "Publishing button discovery for " << device.device_id;
 
-        // Topic: homeassistant/button/colada/{device_id}_{button}/config
-        std::string topic = "homeassistant/button/colada/" + device.device_id + "_" + button + "/config";
+    auto messages = buildMessages(device);
 
-        if (mqtt_client_.publish(topic, Json::writeString(Json::StreamWriterBuilder(), config), 1, true)) {
+    size_t published = 0;
+    for (size_t i = 0; i < BUTTONS.size(); i++) {
+        if (mqtt_client_.publish(messages[i].topic, messages[i].payload, 1, true)) {
             published++;
         }
     }
 
-    if (published == buttons.size()) {
-        std::cout << "[DiscoveryPublisher] ✅ Published " << published << " buttons for " << device.name << std::endl;
+    if (published == BUTTONS.size()) {
+        LOG_INFO("DiscoveryPublisher") << "✅ Published " << published << " buttons for " << device.name;
     } else {
-        std::cerr << "[DiscoveryPublisher] ⚠️  Only published " << published << "/" << buttons.size() << " buttons" << std::endl;
+        LOG_WARN("DiscoveryPublisher") << "Only published " << published << "/" << BUTTONS.size() << " buttons";
     }
 
     // Publish text entity for keyboard input
-    if (publishTextEntity(device)) {
-        std::cout << "[DiscoveryPublisher] ✅ Published text entity for " << device.name << std::endl;
+    const auto& text_entity = messages.back();
+    if (mqtt_client_.publish(text_entity.topic, text_entity.payload, 1, true)) {
+        LOG_INFO("DiscoveryPublisher") << "✅ Published text entity for " << device.name;
     } else {
-        std::cerr << "[DiscoveryPublisher] ⚠️  Failed to publish text entity" << std::endl;
+        LOG_WARN("DiscoveryPublisher") << "Failed to publish text entity";
     }
 
     // Publish initial availability
     publishAvailability(device.device_id, device.status == "online");
-    return published == buttons.size();
+    return published == BUTTONS.size();
 }
 
 bool DiscoveryPublisher::removeDevice(const std::string& device_id) {
-    std::cout << "[DiscoveryPublisher] Removing device " << device_id << std::endl;
+    LOG_INFO("DiscoveryPublisher") << "Removing device " << device_id;
     return mqtt_client_.removeDevice(device_id);
 }
 
@@ -80,7 +100,7 @@ Json::Value DiscoveryPublisher::buildButtonConfig(const Device& device, const st
     Json::Value config;
 
     // Map button IDs to friendly names and icons (matching Python service)
-    std::map<std::string, std::pair<std::string, std::string>> button_info = {
+    static const std::map<std::string, std::pair<std::string, std::string>> button_info = {
         // Navigation
         {"up", {"Up", "mdi:arrow-up"}},
         {"down", {"Down", "mdi:arrow-down"}},
@@ -103,12 +123,14 @@ Json::Value DiscoveryPublisher::buildButtonConfig(const Device& device, const st
         {"wake", {"Wake", "mdi:power"}}
     };
 
-    auto info = button_info[button_id];
-    std::string friendly_name = info.first;
-    std::string icon = info.second;
+    static const std::pair<std::string, std::string> unknown;
+    auto info_it = button_info.find(button_id);
+    const auto& info = info_it != button_info.end() ? info_it->second : unknown;
+    const std::string& friendly_name = info.first;
+    const std::string& icon = info.second;
 
     // Map button IDs to actions (matching Python line 48-70)
-    std::map<std::string, std::string> button_actions = {
+    static const std::map<std::string, std::string> button_actions = {
         {"up", "dpad_up"},
         {"down", "dpad_down"},
         {"left", "dpad_left"},
@@ -126,7 +148,8 @@ Json::Value DiscoveryPublisher::buildButtonConfig(const Device& device, const st
         {"wake", "wake"}
     };
 
-    std::string action = button_actions[button_id];
+    auto action_it = button_actions.find(button_id);
+    std::string action = action_it != button_actions.end() ? action_it->second : "";
 
     // Button configuration (matching Python discovery.py line 75-87)
     config["name"] = device.name + " " + friendly_name;
@@ -163,7 +186,7 @@ Json::Value DiscoveryPublisher::buildDeviceInfo(const Device& device) {
     return device_info;
 }
 
-bool DiscoveryPublisher::publishTextEntity(const Device& device) {
+Json::Value DiscoveryPublisher::buildTextConfig(const Device& device) {
     Json::Value config;
 
     // Text entity configuration for keyboard input
@@ -174,10 +197,7 @@ bool DiscoveryPublisher::publishTextEntity(const Device& device) {
     config["icon"] = "mdi:keyboard";
     config["mode"] = "text";  // Single-line text input
 
-    // Topic: homeassistant/text/colada/{device_id}_text_input/config
-    std::string topic = "homeassistant/text/colada/" + device.device_id + "_text_input/config";
-
-    return mqtt_client_.publish(topic, Json::writeString(Json::StreamWriterBuilder(), config), 1, true);
+    return config;
 }
 
 } // namespace hms_firetv
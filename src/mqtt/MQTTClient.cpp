@@ -1,9 +1,27 @@
 #include "mqtt/MQTTClient.h"
+#include "mqtt/CommandTopic.h"
 #include "repositories/DeviceRepository.h"
-#include <iostream>
+#include "services/EventBus.h"
+#include "services/ServiceStatus.h"
+#include "utils/AllocTracker.h"
+#include "utils/Metrics.h"
+#include "utils/Logger.h"
+#include "utils/Trace.h"
 
 namespace hms_firetv {
 
+namespace {
+
+// Broker state for /api/stream clients (the dashboard's MQTT indicator) and /health
+void publishConnectionState(bool connected) {
+    ServiceStatus::getInstance().setMqttConnected(connected);
+    Json::Value fields;
+    fields["mqtt"] = connected ? "connected" : "disconnected";
+    EventBus::getInstance().publish("service", fields);
+}
+
+} // namespace
+
 // ============================================================================
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================================================
@@ -16,7 +34,7 @@ MQTTClient::MQTTClient(const std::string& client_id)
     // Create async MQTT client (no connection yet)
     client_ = nullptr;  // Will be created in connect()
 
-    std::cout << "[MQTTClient] Initialized with client_id: " << client_id << std::endl;
+    LOG_INFO("MQTTClient") << "Initialized with client_id: " << client_id;
 }
 
 MQTTClient::~MQTTClient() {
@@ -36,7 +54,7 @@ bool MQTTClient::connect(const std::string& broker_address,
     username_ = username;
     password_ = password;
 
-    std::cout << "[MQTTClient] Connecting to " << broker_address << "..." << std::endl;
+    LOG_INFO("MQTTClient") << "Connecting to " << broker_address << "...";
 
     try {
         // Create client with unique ID
@@ -70,12 +88,13 @@ bool MQTTClient::connect(const std::string& broker_address,
 
         connected_ = true;
         initial_connect_done_ = true;
-        std::cout << "[MQTTClient] Connected successfully" << std::endl;
+        LOG_INFO("MQTTClient") << "Connected successfully";
+        publishConnectionState(true);
 
         return true;
 
     } catch (const mqtt::exception& e) {
-        std::cerr << "[MQTTClient] Connection failed: " << e.what() << std::endl;
+        LOG_ERROR("MQTTClient") << "Connection failed: " << e.what();
         connected_ = false;
         return false;
     }
@@ -86,12 +105,13 @@ void MQTTClient::disconnect() {
 
     if (client_ && connected_) {
         try {
-            std::cout << "[MQTTClient] Disconnecting..." << std::endl;
+            LOG_INFO("MQTTClient") << "Disconnecting...";
             client_->disconnect()->wait();
             connected_ = false;
-            std::cout << "[MQTTClient] Disconnected" << std::endl;
+            LOG_INFO("MQTTClient") << "Disconnected";
+            publishConnectionState(false);
         } catch (const mqtt::exception& e) {
-            std::cerr << "[MQTTClient] Disconnect error: " << e.what() << std::endl;
+            LOG_ERROR("MQTTClient") << "Disconnect error: " << e.what();
         }
     }
 }
@@ -107,14 +127,14 @@ bool MQTTClient::isConnected() const {
 
 bool MQTTClient::subscribeToCommands(const std::string& device_id, CommandCallback callback) {
     if (!isConnected()) {
-        std::cerr << "[MQTTClient] Not connected, cannot subscribe" << std::endl;
+        LOG_ERROR("MQTTClient") << "Not connected, cannot subscribe";
         return false;
     }
 
     std::string topic = buildTopic(device_id, "set");
 
     try {
-        std::cout << "[MQTTClient] Subscribing to: " << topic << std::endl;
+        LOG_INFO("MQTTClient") << "Subscribing to: " << topic;
         client_->subscribe(topic, 1)->wait();  // QoS 1
 
         // Store callback
@@ -123,18 +143,18 @@ bool MQTTClient::subscribeToCommands(const std::string& device_id, CommandCallba
             command_callbacks_[device_id] = callback;
         }
 
-        std::cout << "[MQTTClient] ✅ Subscribed to commands for " << device_id << std::endl;
+        LOG_INFO("MQTTClient") << "✅ Subscribed to commands for " << device_id;
         return true;
 
     } catch (const mqtt::exception& e) {
-        std::cerr << "[MQTTClient] ❌ Subscribe failed: " << e.what() << std::endl;
+        LOG_ERROR("MQTTClient") << "❌ Subscribe failed: " << e.what();
         return false;
     }
 }
 
 bool MQTTClient::subscribeToAllCommands(CommandCallback callback) {
     if (!isConnected()) {
-        std::cerr << "[MQTTClient] Not connected, cannot subscribe" << std::endl;
+        LOG_ERROR("MQTTClient") << "Not connected, cannot subscribe";
         return false;
     }
 
@@ -150,7 +170,7 @@ bool MQTTClient::subscribeToAllCommands(CommandCallback callback) {
         auto devices = DeviceRepository::getInstance().getAllDevices();
 
         if (devices.empty()) {
-            std::cerr << "[MQTTClient] No devices found in database" << std::endl;
+            LOG_ERROR("MQTTClient") << "No devices found in database";
             return false;
         }
 
@@ -175,23 +195,23 @@ bool MQTTClient::subscribeToAllCommands(CommandCallback callback) {
             auto token = client_->subscribe(topics_ptr, qos_levels);
             token->wait();
 
-            std::cout << "[MQTTClient] Subscribed to " << all_topics.size() << " topics" << std::endl;
+            LOG_INFO("MQTTClient") << "Subscribed to " << all_topics.size() << " topics";
             return true;
 
         } catch (const mqtt::exception& e) {
-            std::cerr << "[MQTTClient] Batch subscription failed: " << e.what() << std::endl;
+            LOG_ERROR("MQTTClient") << "Batch subscription failed: " << e.what();
             return false;
         }
 
     } catch (const std::exception& e) {
-        std::cerr << "[MQTTClient] Failed to query devices or subscribe: " << e.what() << std::endl;
+        LOG_ERROR("MQTTClient") << "Failed to query devices or subscribe: " << e.what();
         return false;
     }
 }
 
 bool MQTTClient::subscribe(const std::string& topic, std::function<void(const std::string&, const std::string&)> callback) {
     if (!connected_) {
-        std::cerr << "[MQTTClient] Not connected, cannot subscribe" << std::endl;
+        LOG_ERROR("MQTTClient") << "Not connected, cannot subscribe";
         return false;
     }
 
@@ -205,11 +225,11 @@ bool MQTTClient::subscribe(const std::string& topic, std::function<void(const st
             topic_callbacks_[topic] = callback;
         }
 
-        std::cout << "[MQTTClient] ✅ Subscribed to: " << topic << std::endl;
+        LOG_INFO("MQTTClient") << "✅ Subscribed to: " << topic;
         return true;
 
     } catch (const mqtt::exception& e) {
-        std::cerr << "[MQTTClient] ❌ Subscribe failed: " << e.what() << std::endl;
+        LOG_ERROR("MQTTClient") << "❌ Subscribe failed: " << e.what();
         return false;
     }
 }
@@ -217,7 +237,7 @@ bool MQTTClient::subscribe(const std::string& topic, std::function<void(const st
 void MQTTClient::registerTopicCallback(const std::string& topic, std::function<void(const std::string&, const std::string&)> callback) {
     std::lock_guard<std::mutex> lock(topic_callbacks_mutex_);
     topic_callbacks_[topic] = callback;
-    std::cout << "[MQTTClient] ✅ Registered callback for topic: " << topic << " (no MQTT subscription made)" << std::endl;
+    LOG_INFO("MQTTClient") << "✅ Registered callback for topic: " << topic << " (no MQTT subscription made)";
 }
 
 // ============================================================================
@@ -266,7 +286,7 @@ bool MQTTClient::publish(const std::string& topic,
                          int qos,
                          bool retain) {
     if (!isConnected()) {
-        std::cerr << "[MQTTClient] Not connected, cannot publish" << std::endl;
+        LOG_ERROR("MQTTClient") << "Not connected, cannot publish";
         return false;
     }
 
@@ -276,15 +296,16 @@ bool MQTTClient::publish(const std::string& topic,
         pubmsg->set_retained(retain);
 
         client_->publish(pubmsg);  // Async, no wait
+        Metrics::recordMqttMessage(false, payload.length());
 
-        std::cout << "[MQTTClient] Published to " << topic
-                  << " (" << payload.length() << " bytes)"
-                  << (retain ? " [retained]" : "") << std::endl;
+        LOG_DEBUG("MQTTClient") << "Published to " << topic
+                                << " (" << payload.length() << " bytes)"
+                                << (retain ? " [retained]" : "");
 
         return true;
 
     } catch (const mqtt::exception& e) {
-        std::cerr << "[MQTTClient] Publish failed: " << e.what() << std::endl;
+        LOG_ERROR("MQTTClient") << "Publish failed: " << e.what();
         return false;
     }
 }
@@ -293,38 +314,23 @@ std::string MQTTClient::buildTopic(const std::string& device_id, const std::stri
     return topic_prefix_ + "/" + device_id + "/" + suffix;
 }
 
-std::string MQTTClient::extractDeviceId(const std::string& topic) const {
-    // Extract device_id from: maestro_hub/colada/{device_id}/{action}
-    std::string prefix = "maestro_hub/colada/";
-
-    size_t prefix_pos = topic.find(prefix);
-    if (prefix_pos == std::string::npos) {
-        return "";
-    }
-
-    size_t start = prefix_pos + prefix.length();
-    size_t slash_pos = topic.find('/', start);
-
-    if (slash_pos == std::string::npos) {
-        return "";
-    }
-
-    return topic.substr(start, slash_pos - start);
-}
-
 // ============================================================================
 // CALLBACKS
 // ============================================================================
 
 void MQTTClient::onMessageArrived(mqtt::const_message_ptr msg) {
+    auto arrived = Trace::Clock::now();
+    AllocScope alloc_scope("mqtt");
     std::string topic = msg->get_topic();
     std::string payload_str = msg->to_string();
+    Metrics::recordMqttMessage(true, payload_str.size());
 
     // Check for exact match in topic callbacks first (e.g., homeassistant/status)
     {
         std::lock_guard<std::mutex> lock(topic_callbacks_mutex_);
         auto it = topic_callbacks_.find(topic);
         if (it != topic_callbacks_.end()) {
+            alloc_scope.setType("mqtt", "subscription");
             it->second(topic, payload_str);
             return; // Stop processing after exact match
         }
@@ -332,65 +338,34 @@ void MQTTClient::onMessageArrived(mqtt::const_message_ptr msg) {
 
     // If no exact match, continue to maestro_hub command handler below...
 
-    // Extract device_id from topic: maestro_hub/colada/{device_id}/{action}
-    std::string device_id = extractDeviceId(topic);
-    if (device_id.empty()) {
-        std::cerr << "[MQTTClient] Failed to extract device_id from topic: " << topic << std::endl;
+    // Commands are traced from receipt; CommandHandler names the trace and
+    // each stage on this thread adds its span
+    auto trace = Tracer::getInstance().start("mqtt");
+    TraceContext trace_context(trace);
+
+    auto parse_start = Trace::Clock::now();
+    if (trace) {
+        trace->addSpan("receive", arrived, parse_start, topic);
+    }
+
+    // maestro_hub/colada/{device_id}/{action} -> command payload
+    std::string error;
+    auto message = CommandTopic::parse(topic, payload_str, error);
+    if (!message) {
+        LOG_ERROR("MQTTClient") << error;
         return;
     }
+    const std::string& device_id = message->device_id;
+    const Json::Value& payload = message->payload;
 
-    // Extract action from topic (last part after device_id)
-    std::string prefix = "maestro_hub/colada/" + device_id + "/";
-    std::string action;
-    size_t action_pos = topic.find(prefix);
-    if (action_pos != std::string::npos) {
-        action = topic.substr(action_pos + prefix.length());
+    const char* command_begin = nullptr;
+    const char* command_end = nullptr;
+    if (payload["command"].isString() && payload["command"].getString(&command_begin, &command_end)) {
+        alloc_scope.setType("mqtt", std::string_view(command_begin, command_end - command_begin));
     }
 
-    // Convert button press to JSON command format that CommandHandler expects
-    Json::Value payload;
-    if (action == "send_text") {
-        // Text input from text entity - payload is the text string
-        payload["command"] = "send_text";
-        payload["text"] = payload_str;
-    } else if (payload_str == "PRESS" && !action.empty()) {
-        // Button press - convert action to command format
-        // Map Python action names to our command format
-        if (action.find("dpad_") == 0) {
-            // Navigation: dpad_up, dpad_down, etc.
-            std::string direction = action.substr(5); // Remove "dpad_" prefix
-            payload["command"] = "navigate";
-            payload["direction"] = direction;
-        } else if (action == "select" || action == "home" || action == "back" || action == "menu") {
-            // Navigation actions
-            payload["command"] = "navigate";
-            payload["action"] = action;
-        } else if (action == "play" || action == "pause") {
-            // Media controls
-            payload["command"] = "media_" + action;
-        } else if (action == "volume_up" || action == "volume_down" || action == "mute") {
-            // Volume controls
-            payload["command"] = action;
-        } else if (action == "sleep") {
-            // Power off
-            payload["command"] = "turn_off";
-        } else if (action == "wake") {
-            // Power on
-            payload["command"] = "turn_on";
-        } else {
-            std::cerr << "[MQTTClient] Unknown button action: " << action << std::endl;
-            return;
-        }
-    } else {
-        // Try to parse as JSON (for backwards compatibility)
-        Json::CharReaderBuilder reader;
-        std::string errors;
-        std::istringstream stream(payload_str);
-
-        if (!Json::parseFromStream(reader, stream, &payload, &errors)) {
-            std::cerr << "[MQTTClient] JSON parse error: " << errors << std::endl;
-            return;
-        }
+    if (trace) {
+        trace->addSpan("parse", parse_start, Trace::Clock::now());
     }
 
     // Find and call callback
@@ -400,6 +375,7 @@ void MQTTClient::onMessageArrived(mqtt::const_message_ptr msg) {
     auto it = command_callbacks_.find(device_id);
     if (it != command_callbacks_.end()) {
         it->second(device_id, payload);
+        Tracer::getInstance().finish(trace);
         return;
     }
 
@@ -407,10 +383,11 @@ void MQTTClient::onMessageArrived(mqtt::const_message_ptr msg) {
     auto wildcard_it = command_callbacks_.find("*");
     if (wildcard_it != command_callbacks_.end()) {
         wildcard_it->second(device_id, payload);
+        Tracer::getInstance().finish(trace);
         return;
     }
 
-    std::cerr << "[MQTTClient] No callback registered for device: " << device_id << std::endl;
+    LOG_ERROR("MQTTClient") << "No callback registered for device: " << device_id;
 }
 
 void MQTTClient::onConnectionLost(const std::string& cause) {
@@ -418,10 +395,11 @@ void MQTTClient::onConnectionLost(const std::string& cause) {
         std::lock_guard<std::mutex> lock(connection_mutex_);
         connected_ = false;
     }
-    std::cerr << "[MQTTClient] Connection lost: " << cause << std::endl;
+    LOG_ERROR("MQTTClient") << "Connection lost: " << cause;
+    publishConnectionState(false);
 
     if (auto_reconnect_) {
-        std::cout << "[MQTTClient] Auto-reconnect enabled (handled by paho-mqtt)" << std::endl;
+        LOG_INFO("MQTTClient") << "Auto-reconnect enabled (handled by paho-mqtt)";
     }
 }
 
@@ -434,7 +412,8 @@ void MQTTClient::onReconnected(const std::string& cause) {
         std::unique_lock<std::mutex> lock(connection_mutex_, std::try_to_lock);
         connected_ = true;
     }
-    std::cout << "[MQTTClient] Reconnected: " << cause << std::endl;
+    LOG_INFO("MQTTClient") << "Reconnected: " << cause;
+    publishConnectionState(true);
 
     // Re-subscribe — fire-and-forget (no ->wait()) to avoid paho callback thread deadlock
     bool has_wildcard = false;
@@ -454,9 +433,9 @@ void MQTTClient::onReconnected(const std::string& cause) {
             std::vector<int> qos_levels(all_topics.size(), 1);
             auto topics_ptr = mqtt::string_collection::create(all_topics);
             client_->subscribe(topics_ptr, qos_levels);
-            std::cout << "[MQTTClient] Re-subscribed to " << all_topics.size() << " topics after reconnect" << std::endl;
+            LOG_INFO("MQTTClient") << "Re-subscribed to " << all_topics.size() << " topics after reconnect";
         } catch (const std::exception& e) {
-            std::cerr << "[MQTTClient] Re-subscribe failed: " << e.what() << std::endl;
+            LOG_ERROR("MQTTClient") << "Re-subscribe failed: " << e.what();
         }
     }
 
@@ -465,9 +444,9 @@ void MQTTClient::onReconnected(const std::string& cause) {
         for (const auto& [topic, callback] : topic_callbacks_) {
             try {
                 client_->subscribe(topic, 1);
-                std::cout << "[MQTTClient] Re-subscribed to " << topic << std::endl;
+                LOG_INFO("MQTTClient") << "Re-subscribed to " << topic;
             } catch (const mqtt::exception& e) {
-                std::cerr << "[MQTTClient] Re-subscribe failed for " << topic << ": " << e.what() << std::endl;
+                LOG_ERROR("MQTTClient") << "Re-subscribe failed for " << topic << ": " << e.what();
             }
         }
     }
@@ -1,9 +1,16 @@
 #include "repositories/DeviceRepository.h"
-#include <iostream>
+#include "services/EventBus.h"
+#include "services/ServiceStatus.h"
+#include "utils/Metrics.h"
+#include "utils/Trace.h"
+#include "utils/Logger.h"
+#include <algorithm>
 
 namespace hms_firetv {
 
 std::shared_ptr<IDatabase> DeviceRepository::db_;
+std::vector<DeviceChangeListener> DeviceRepository::listeners_;
+std::mutex DeviceRepository::listeners_mutex_;
 
 DeviceRepository& DeviceRepository::getInstance() {
     static DeviceRepository instance;
@@ -12,18 +19,55 @@ DeviceRepository& DeviceRepository::getInstance() {
 
 void DeviceRepository::setDatabase(std::shared_ptr<IDatabase> db) { db_ = std::move(db); }
 
+void DeviceRepository::addChangeListener(DeviceChangeListener listener) {
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    listeners_.push_back(std::move(listener));
+}
+
+void DeviceRepository::notifyChange(const std::string& device_id, DeviceChange change) {
+    std::vector<DeviceChangeListener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex_);
+        listeners = listeners_;
+    }
+    for (const auto& listener : listeners) {
+        try {
+            listener(device_id, change);
+        } catch (const std::exception& e) {
+            LOG_ERROR("DeviceRepository") << "Change listener failed for " << device_id
+                                          << ": " << e.what();
+        }
+    }
+}
+
+void DeviceRepository::publishPaired(const std::string& device_id, bool paired) {
+    Json::Value state;
+    state["is_paired"] = paired;
+    EventBus::getInstance().deviceState(device_id, state);
+    ServiceStatus::getInstance().deviceChanged(device_id, paired, std::nullopt);
+}
+
 std::optional<Device> DeviceRepository::createDevice(const Device& device) {
     if (!db_) return std::nullopt;
-    return db_->createDevice(device);
+    auto created = db_->createDevice(device);
+    if (created.has_value()) {
+        EventBus::getInstance().deviceLifecycle(created->device_id, "created");
+        ServiceStatus::getInstance().deviceChanged(created->device_id, created->isPaired(), created->isOnline());
+    }
+    return created;
 }
 
 std::optional<Device> DeviceRepository::getDeviceById(const std::string& device_id) {
     if (!db_) return std::nullopt;
+    ScopedLatency timer(Metrics::dbQuery("get_device"));
+    TraceSpan span("db.get_device");
     return db_->getDeviceById(device_id);
 }
 
 std::vector<Device> DeviceRepository::getAllDevices() {
     if (!db_) return {};
+    ScopedLatency timer(Metrics::dbQuery("list_devices"));
+    TraceSpan span("db.list_devices");
     return db_->getAllDevices();
 }
 
@@ -32,14 +76,42 @@ std::vector<Device> DeviceRepository::getDevicesByStatus(const std::string& stat
     return db_->getDevicesByStatus(status);
 }
 
+std::vector<Device> DeviceRepository::getDevicesByTag(const std::string& tag) {
+    auto devices = getAllDevices();
+    auto wanted = Device::parseTags(tag);
+    if (wanted.empty()) return {};
+    devices.erase(std::remove_if(devices.begin(), devices.end(),
+                                 [&wanted](const Device& d) { return !d.hasTag(wanted[0]); }),
+                  devices.end());
+    return devices;
+}
+
 bool DeviceRepository::updateDevice(const Device& device) {
     if (!db_) return false;
-    return db_->updateDevice(device);
+    if (!db_->updateDevice(device)) return false;
+    notifyChange(device.device_id, DeviceChange::Updated);
+
+    Json::Value state;
+    state["name"] = device.name;
+    state["ip_address"] = device.ip_address;
+    state["status"] = device.status;
+    state["adb_enabled"] = device.adb_enabled;
+    state["tags"] = Json::arrayValue;
+    for (const auto& tag : device.tags) {
+        state["tags"].append(tag);
+    }
+    EventBus::getInstance().deviceState(device.device_id, state);
+    ServiceStatus::getInstance().deviceChanged(device.device_id, std::nullopt, device.isOnline());
+    return true;
 }
 
 bool DeviceRepository::deleteDevice(const std::string& device_id) {
     if (!db_) return false;
-    return db_->deleteDevice(device_id);
+    if (!db_->deleteDevice(device_id)) return false;
+    notifyChange(device_id, DeviceChange::Deleted);
+    EventBus::getInstance().deviceLifecycle(device_id, "deleted");
+    ServiceStatus::getInstance().deviceRemoved(device_id);
+    return true;
 }
 
 bool DeviceRepository::setPairingPin(const std::string& device_id, const std::string& pin_code,
@@ -52,17 +124,53 @@ bool DeviceRepository::verifyPinAndSetToken(const std::string& device_id,
                                              const std::string& pin_code,
                                              const std::string& client_token) {
     if (!db_) return false;
-    return db_->verifyPinAndSetToken(device_id, pin_code, client_token);
+    if (!db_->verifyPinAndSetToken(device_id, pin_code, client_token)) return false;
+    notifyChange(device_id, DeviceChange::Paired);
+    publishPaired(device_id, true);
+    return true;
+}
+
+bool DeviceRepository::completePairing(const std::string& device_id, const std::string& client_token) {
+    if (!db_) return false;
+    if (!db_->completePairing(device_id, client_token)) return false;
+    notifyChange(device_id, DeviceChange::Paired);
+    publishPaired(device_id, true);
+    return true;
 }
 
 bool DeviceRepository::clearPairing(const std::string& device_id) {
     if (!db_) return false;
-    return db_->clearPairing(device_id);
+    if (!db_->clearPairing(device_id)) return false;
+    notifyChange(device_id, DeviceChange::Unpaired);
+    publishPaired(device_id, false);
+    return true;
 }
 
 bool DeviceRepository::updateLastSeen(const std::string& device_id, const std::string& status) {
     if (!db_) return false;
-    return db_->updateLastSeen(device_id, status);
+    ScopedLatency timer(Metrics::dbQuery("update_last_seen"));
+    TraceSpan span("db.update_last_seen");
+    if (!db_->updateLastSeen(device_id, status)) return false;
+
+    // Called on every command: the bus only publishes when the status changes
+    Json::Value state;
+    state["status"] = status;
+    EventBus::getInstance().deviceState(device_id, state);
+    ServiceStatus::getInstance().deviceChanged(device_id, std::nullopt, status == "online");
+    return true;
+}
+
+bool DeviceRepository::updateDeviceIp(const std::string& device_id, const std::string& ip_address) {
+    if (!db_) return false;
+    if (!db_->updateDeviceIp(device_id, ip_address)) return false;
+    notifyChange(device_id, DeviceChange::Updated);
+
+    Json::Value state;
+    state["ip_address"] = ip_address;
+    state["status"] = "online";
+    EventBus::getInstance().deviceState(device_id, state);
+    ServiceStatus::getInstance().deviceChanged(device_id, std::nullopt, true);
+    return true;
 }
 
 bool DeviceRepository::deviceExists(const std::string& device_id) {
@@ -0,0 +1,85 @@
+#include "repositories/MacroRepository.h"
+#include "utils/Logger.h"
+
+namespace hms_firetv {
+
+std::shared_ptr<IDatabase> MacroRepository::db_;
+
+MacroRepository& MacroRepository::getInstance() {
+    static MacroRepository instance;
+    return instance;
+}
+
+void MacroRepository::setDatabase(std::shared_ptr<IDatabase> db) { db_ = std::move(db); }
+
+std::vector<Macro> MacroRepository::getAllMacros() {
+    if (!db_) return {};
+    return db_->getAllMacros();
+}
+
+std::optional<Macro> MacroRepository::getMacro(const std::string& name) {
+    if (!db_) return std::nullopt;
+    return db_->getMacro(name);
+}
+
+bool MacroRepository::saveMacro(const Macro& macro, std::string& error) {
+    if (!db_) {
+        error = "Database not available";
+        return false;
+    }
+    if (macro.name.empty() || macro.name.size() > 100) {
+        error = "Macro name must be 1-100 characters";
+        return false;
+    }
+
+    auto sequence = compileSequence(macro.steps, error);
+    if (!sequence) {
+        return false;
+    }
+
+    if (!db_->saveMacro(macro)) {
+        error = "Failed to save macro";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    compiled_[macro.name] = std::move(sequence);
+    return true;
+}
+
+bool MacroRepository::deleteMacro(const std::string& name) {
+    if (!db_) return false;
+    bool deleted = db_->deleteMacro(name);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    compiled_.erase(name);
+    return deleted;
+}
+
+std::shared_ptr<const LightningSequence> MacroRepository::getCompiled(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = compiled_.find(name);
+        if (it != compiled_.end()) {
+            return it->second;
+        }
+    }
+
+    auto macro = getMacro(name);
+    if (!macro.has_value()) {
+        return nullptr;
+    }
+
+    std::string error;
+    auto sequence = compileSequence(macro->steps, error);
+    if (!sequence) {
+        LOG_ERROR("MacroRepository") << "Stored macro '" << name << "' is invalid: " << error;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    compiled_[name] = sequence;
+    return sequence;
+}
+
+} // namespace hms_firetv
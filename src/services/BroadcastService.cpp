@@ -0,0 +1,356 @@
+#include "services/BroadcastService.h"
+#include "clients/AsyncLightningClient.h"
+#include "repositories/DeviceRepository.h"
+#include "utils/ConfigManager.h"
+#include "utils/Logger.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace hms_firetv {
+
+namespace {
+
+int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * State shared by every device chain of one broadcast
+ */
+struct BroadcastRun {
+    std::mutex mutex;
+    std::vector<Device> devices;
+    LightningStep step;
+    bool pre_wake = true;
+    Deadline deadline;
+    size_t next = 0;            // Next device to start
+    size_t remaining = 0;       // Devices not yet completed
+    int64_t start_ms = 0;
+    BroadcastResult result;
+    BroadcastService::ResultCallback callback;
+};
+
+void startNext(const std::shared_ptr<BroadcastRun>& run);
+
+/**
+ * Store a device's outcome; true once it was the last device
+ */
+bool recordOutcome(const std::shared_ptr<BroadcastRun>& run, size_t index,
+                   DeviceOutcome outcome, int64_t device_start_ms) {
+    outcome.total_ms = steadyNowMs() - device_start_ms;
+
+    std::lock_guard<std::mutex> lock(run->mutex);
+    auto& result = run->result;
+    if (outcome.success) {
+        result.succeeded++;
+    } else {
+        result.failed++;
+    }
+    if (outcome.woke) {
+        result.woken++;
+    }
+    result.devices[index] = std::move(outcome);
+    return --run->remaining == 0;
+}
+
+void finish(const std::shared_ptr<BroadcastRun>& run) {
+    run->result.wall_ms = steadyNowMs() - run->start_ms;
+    LOG_INFO("BroadcastService") << run->step.command << " to " << run->result.targets
+                                 << " devices: " << run->result.succeeded << " ok, " << run->result.failed
+                                 << " failed, " << run->result.woken << " woken (" << run->result.wall_ms
+                                 << "ms, concurrency " << run->result.concurrency << ")";
+
+    auto callback = std::move(run->callback);
+    callback(std::move(run->result));
+}
+
+void complete(const std::shared_ptr<BroadcastRun>& run, size_t index,
+              DeviceOutcome outcome, int64_t device_start_ms) {
+    if (recordOutcome(run, index, std::move(outcome), device_start_ms)) {
+        finish(run);
+    } else {
+        startNext(run);
+    }
+}
+
+void sendStep(const std::shared_ptr<BroadcastRun>& run, size_t index,
+              DeviceOutcome outcome, int64_t device_start_ms) {
+    const auto& device = run->devices[index];
+    const auto& deadline = run->deadline;
+
+    if (deadline.expired()) {
+        Deadline::recordCancelled(Deadline::Stage::Transport);
+        outcome.error = Deadline::EXCEEDED;
+        complete(run, index, std::move(outcome), device_start_ms);
+        return;
+    }
+
+    auto finish = [run, index, outcome = std::move(outcome), device_start_ms]
+                  (CommandResult result) mutable {
+        outcome.success = result.success;
+        outcome.status_code = result.status_code;
+        outcome.response_time_ms = result.response_time_ms;
+        outcome.error = result.error;
+        if (!result.success && result.status_code == 0 && run->deadline.expired()) {
+            Deadline::recordCancelled(Deadline::Stage::Transport);
+            outcome.error = Deadline::EXCEEDED;
+        }
+        complete(run, index, std::move(outcome), device_start_ms);
+    };
+
+    if (run->step.kind == LightningStep::Kind::Wake) {
+        AsyncLightningClient::wake(device, std::move(finish),
+                                   deadline.capSeconds(AsyncLightningClient::WAKE_TIMEOUT_SECONDS));
+    } else {
+        AsyncLightningClient::post(device, run->step.path, run->step.body, std::move(finish),
+                                   deadline.capSeconds(AsyncLightningClient::COMMAND_TIMEOUT_SECONDS));
+    }
+}
+
+void pollUntilAwake(const std::shared_ptr<BroadcastRun>& run, size_t index,
+                    DeviceOutcome outcome, int64_t device_start_ms, int attempt) {
+    // Not worth another poll if the command could not be sent after it
+    auto next_poll = Deadline::Clock::now() + std::chrono::milliseconds(
+        static_cast<int64_t>(BroadcastService::WAKE_POLL_INTERVAL_SECONDS * 1000));
+    if (run->deadline.isSet() && next_poll >= run->deadline.at()) {
+        Deadline::recordCancelled(Deadline::Stage::Wake);
+        outcome.error = Deadline::EXCEEDED;
+        complete(run, index, std::move(outcome), device_start_ms);
+        return;
+    }
+
+    drogon::app().getLoop()->runAfter(BroadcastService::WAKE_POLL_INTERVAL_SECONDS,
+        [run, index, outcome = std::move(outcome), device_start_ms, attempt]() mutable {
+        AsyncLightningClient::probe(run->devices[index],
+            [run, index, outcome = std::move(outcome), device_start_ms, attempt](bool awake) mutable {
+            if (awake) {
+                sendStep(run, index, std::move(outcome), device_start_ms);
+            } else if (attempt < BroadcastService::WAKE_POLL_ATTEMPTS) {
+                pollUntilAwake(run, index, std::move(outcome), device_start_ms, attempt + 1);
+            } else {
+                outcome.error = "Device did not wake";
+                complete(run, index, std::move(outcome), device_start_ms);
+            }
+        }, run->deadline.capSeconds(AsyncLightningClient::PROBE_TIMEOUT_SECONDS));
+    });
+}
+
+void startDevice(const std::shared_ptr<BroadcastRun>& run, size_t index) {
+    const int64_t device_start_ms = steadyNowMs();
+    const auto& device = run->devices[index];
+
+    DeviceOutcome outcome;
+    outcome.device_id = device.device_id;
+
+    if (!run->pre_wake || run->step.kind == LightningStep::Kind::Wake) {
+        sendStep(run, index, std::move(outcome), device_start_ms);
+        return;
+    }
+
+    AsyncLightningClient::probe(device,
+        [run, index, outcome = std::move(outcome), device_start_ms](bool awake) mutable {
+        if (awake) {
+            sendStep(run, index, std::move(outcome), device_start_ms);
+            return;
+        }
+
+        AsyncLightningClient::wake(run->devices[index],
+            [run, index, outcome = std::move(outcome), device_start_ms](CommandResult wake) mutable {
+            if (!wake.success) {
+                outcome.error = "Wake failed: " + wake.error.value_or("HTTP " + std::to_string(wake.status_code));
+                complete(run, index, std::move(outcome), device_start_ms);
+                return;
+            }
+            outcome.woke = true;
+            pollUntilAwake(run, index, std::move(outcome), device_start_ms, 1);
+        }, run->deadline.capSeconds(AsyncLightningClient::WAKE_TIMEOUT_SECONDS));
+    }, run->deadline.capSeconds(AsyncLightningClient::PROBE_TIMEOUT_SECONDS));
+}
+
+void startNext(const std::shared_ptr<BroadcastRun>& run) {
+    // Devices still queued behind the concurrency cap when the deadline
+    // passed fail here in a loop, not one nested completion per device
+    while (true) {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(run->mutex);
+            if (run->next >= run->devices.size()) {
+                return;
+            }
+            index = run->next++;
+        }
+
+        if (!run->deadline.expired()) {
+            startDevice(run, index);
+            return;
+        }
+
+        Deadline::recordCancelled(Deadline::Stage::Queue);
+        DeviceOutcome outcome;
+        outcome.device_id = run->devices[index].device_id;
+        outcome.error = Deadline::EXCEEDED;
+        if (recordOutcome(run, index, std::move(outcome), steadyNowMs())) {
+            finish(run);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// RESULTS
+// ============================================================================
+
+Json::Value DeviceOutcome::toJson() const {
+    Json::Value json;
+    json["device_id"] = device_id;
+    json["success"] = success;
+    json["woke"] = woke;
+    json["status_code"] = status_code;
+    json["response_time_ms"] = response_time_ms;
+    json["total_ms"] = static_cast<Json::Int64>(total_ms);
+    if (error.has_value()) {
+        json["error"] = error.value();
+    }
+    return json;
+}
+
+Json::Value BroadcastResult::toJson() const {
+    Json::Value json;
+    json["success"] = (failed == 0);
+    json["targets"] = static_cast<Json::UInt>(targets);
+    json["succeeded"] = static_cast<Json::UInt>(succeeded);
+    json["failed"] = static_cast<Json::UInt>(failed);
+    json["woken"] = static_cast<Json::UInt>(woken);
+    json["concurrency"] = static_cast<Json::UInt>(concurrency);
+    json["wall_ms"] = static_cast<Json::Int64>(wall_ms);
+    json["devices"] = Json::arrayValue;
+    for (const auto& device : devices) {
+        json["devices"].append(device.toJson());
+    }
+    return json;
+}
+
+// ============================================================================
+// SERVICE
+// ============================================================================
+
+BroadcastService& BroadcastService::getInstance() {
+    static BroadcastService instance(static_cast<size_t>(std::max(1,
+        ConfigManager::getEnvInt("BROADCAST_CONCURRENCY", 16))));
+    return instance;
+}
+
+BroadcastService::BroadcastService(size_t max_concurrency)
+    : max_concurrency_(max_concurrency) {}
+
+void BroadcastService::broadcast(std::vector<Device> devices,
+                                 LightningStep step,
+                                 bool pre_wake,
+                                 size_t concurrency,
+                                 const Deadline& deadline,
+                                 ResultCallback callback) {
+    size_t cap = (concurrency == 0) ? max_concurrency_ : std::min(concurrency, max_concurrency_);
+
+    auto run = std::make_shared<BroadcastRun>();
+    run->devices = std::move(devices);
+    run->step = std::move(step);
+    run->pre_wake = pre_wake;
+    run->deadline = deadline;
+    run->remaining = run->devices.size();
+    run->start_ms = steadyNowMs();
+    run->result.targets = run->devices.size();
+    run->result.concurrency = std::min(cap, run->devices.size());
+    run->result.devices.resize(run->devices.size());
+    run->callback = std::move(callback);
+
+    if (run->devices.empty()) {
+        auto done = std::move(run->callback);
+        done(std::move(run->result));
+        return;
+    }
+
+    // Each completion starts the next device, keeping `cap` in flight
+    for (size_t i = 0; i < run->result.concurrency; i++) {
+        startNext(run);
+    }
+}
+
+std::optional<BroadcastService::Request> BroadcastService::parseRequest(const Json::Value& body,
+                                                                        std::string& error) {
+    if (!body.isObject() || !body.isMember("command")) {
+        error = "Missing 'command' field";
+        return std::nullopt;
+    }
+
+    auto step = LightningStep::compile(body["command"], error);
+    if (!step) {
+        return std::nullopt;
+    }
+    if (step->kind == LightningStep::Kind::Delay) {
+        error = "Delay cannot be broadcast";
+        return std::nullopt;
+    }
+
+    Request request;
+    request.step = std::move(step.value());
+    request.pre_wake = body.get("wake", true).asBool();
+    if (body.isMember("concurrency")) {
+        if (!body["concurrency"].isUInt() || body["concurrency"].asUInt() == 0) {
+            error = "'concurrency' must be a positive integer";
+            return std::nullopt;
+        }
+        request.concurrency = body["concurrency"].asUInt();
+    }
+    if (body.isMember("timeout_ms") && (!body["timeout_ms"].isIntegral() || body["timeout_ms"].asInt64() <= 0)) {
+        error = "'timeout_ms' must be a positive integer";
+        return std::nullopt;
+    }
+
+    auto& repository = DeviceRepository::getInstance();
+    if (body.isMember("devices")) {
+        if (!body["devices"].isArray() || body["devices"].empty()) {
+            error = "'devices' must be a non-empty array";
+            return std::nullopt;
+        }
+        for (const auto& id : body["devices"]) {
+            auto device = repository.getDeviceById(id.asString());
+            if (!device) {
+                error = "Device not found: " + id.asString();
+                return std::nullopt;
+            }
+            request.devices.push_back(std::move(device.value()));
+        }
+    } else if (body.isMember("tag")) {
+        request.devices = repository.getDevicesByTag(body["tag"].asString());
+    } else {
+        request.devices = repository.getAllDevices();
+    }
+
+    // Unpaired devices would only collect 401s
+    request.devices.erase(std::remove_if(request.devices.begin(), request.devices.end(),
+        [&request](const Device& device) {
+            return !device.isPaired() && request.step.kind != LightningStep::Kind::Wake;
+        }), request.devices.end());
+
+    if (body.isMember("timeout_ms")) {
+        request.deadline = Deadline::fromBudget(body["timeout_ms"].asInt64());
+    } else {
+        size_t cap = getInstance().maxConcurrency();
+        if (request.concurrency > 0) {
+            cap = std::min(cap, request.concurrency);
+        }
+        size_t waves = std::max<size_t>(1, (request.devices.size() + cap - 1) / cap);
+        request.deadline = Deadline::after(std::min(Deadline::defaultBudget() * static_cast<int64_t>(waves),
+                                                    std::chrono::milliseconds(Deadline::MAX_BUDGET_MS)));
+    }
+
+    return request;
+}
+
+} // namespace hms_firetv
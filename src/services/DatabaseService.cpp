@@ -1,5 +1,5 @@
 #include "services/DatabaseService.h"
-#include <iostream>
+#include "utils/Logger.h"
 #include <thread>
 #include <chrono>
 
@@ -31,15 +31,15 @@ void DatabaseService::initialize(const std::string& host, int port, const std::s
             DEFAULT_CONNECTION_TIMEOUT_MS
         );
 
-        std::cout << "[DatabaseService] ✅ Connected to PostgreSQL: "
-                  << dbname << "@" << host << ":" << port << std::endl;
-        std::cout << "[DatabaseService] Pool initialized with "
-                  << pool_->poolSize() << " connections" << std::endl;
+        LOG_INFO("DatabaseService") << "✅ Connected to PostgreSQL: "
+                                    << dbname << "@" << host << ":" << port;
+        LOG_INFO("DatabaseService") << "Pool initialized with "
+                                    << pool_->poolSize() << " connections";
 
     } catch (const std::exception& e) {
-        std::cerr << "[DatabaseService] ❌ Failed to initialize connection pool for "
-                  << host << ":" << port << "/" << dbname << std::endl;
-        std::cerr << "[DatabaseService] Error: " << e.what() << std::endl;
+        LOG_ERROR("DatabaseService") << "❌ Failed to initialize connection pool for "
+                                     << host << ":" << port << "/" << dbname;
+        LOG_ERROR("DatabaseService") << "Error: " << e.what();
         throw;  // Fail-fast during initialization
     }
 }
@@ -50,7 +50,7 @@ void DatabaseService::initialize(const std::string& host, int port, const std::s
 
 pqxx::result DatabaseService::executeQuery(const std::string& query) {
     if (!pool_) {
-        std::cerr << "[DatabaseService] ❌ Connection pool not initialized" << std::endl;
+        LOG_ERROR("DatabaseService") << "❌ Connection pool not initialized";
         return pqxx::result{};
     }
 
@@ -70,15 +70,15 @@ pqxx::result DatabaseService::executeQuery(const std::string& query) {
 
             // Success! Log if we recovered from previous failures
             if (attempt > 0) {
-                std::cout << "[DatabaseService] ✅ Query succeeded after "
-                          << (attempt + 1) << " attempts" << std::endl;
+                LOG_INFO("DatabaseService") << "✅ Query succeeded after "
+                                            << (attempt + 1) << " attempts";
             }
             return result;
 
         } catch (const std::exception& e) {
-            std::cerr << "[DatabaseService] ❌ Query failed (attempt "
-                      << (attempt + 1) << "/" << MAX_RETRIES << "): "
-                      << e.what() << std::endl;
+            LOG_ERROR("DatabaseService") << "❌ Query failed (attempt "
+                                         << (attempt + 1) << "/" << MAX_RETRIES << "): "
+                                         << e.what();
 
             // Sleep before retry (except on last attempt)
             if (attempt < MAX_RETRIES - 1) {
@@ -87,14 +87,14 @@ pqxx::result DatabaseService::executeQuery(const std::string& query) {
         }
     }
 
-    std::cerr << "[DatabaseService] ❌ Query failed after " << MAX_RETRIES << " attempts" << std::endl;
+    LOG_ERROR("DatabaseService") << "❌ Query failed after " << MAX_RETRIES << " attempts";
     return pqxx::result{};
 }
 
 pqxx::result DatabaseService::executeQueryParams(const std::string& query,
                                                   const std::vector<std::string>& params) {
     if (!pool_) {
-        std::cerr << "[DatabaseService] ❌ Connection pool not initialized" << std::endl;
+        LOG_ERROR("DatabaseService") << "❌ Connection pool not initialized";
         return pqxx::result{};
     }
 
@@ -142,7 +142,7 @@ pqxx::result DatabaseService::executeQueryParams(const std::string& query,
                     break;
                 default:
                     // For more than 8 params, fall back to non-parameterized (not ideal but rare)
-                    std::cerr << "[DatabaseService] Warning: More than 8 parameters, using non-parameterized query" << std::endl;
+                    LOG_WARN("DatabaseService") << "More than 8 parameters, using non-parameterized query";
                     result = txn.exec(query);
             }
 
@@ -150,15 +150,15 @@ pqxx::result DatabaseService::executeQueryParams(const std::string& query,
 
             // Success! Log if we recovered from previous failures
             if (attempt > 0) {
-                std::cout << "[DatabaseService] ✅ Parameterized query succeeded after "
-                          << (attempt + 1) << " attempts" << std::endl;
+                LOG_INFO("DatabaseService") << "✅ Parameterized query succeeded after "
+                                            << (attempt + 1) << " attempts";
             }
             return result;
 
         } catch (const std::exception& e) {
-            std::cerr << "[DatabaseService] ❌ Parameterized query failed (attempt "
-                      << (attempt + 1) << "/" << MAX_RETRIES << "): "
-                      << e.what() << std::endl;
+            LOG_ERROR("DatabaseService") << "❌ Parameterized query failed (attempt "
+                                         << (attempt + 1) << "/" << MAX_RETRIES << "): "
+                                         << e.what();
 
             // Sleep before retry (except on last attempt)
             if (attempt < MAX_RETRIES - 1) {
@@ -167,8 +167,8 @@ pqxx::result DatabaseService::executeQueryParams(const std::string& query,
         }
     }
 
-    std::cerr << "[DatabaseService] ❌ Parameterized query failed after "
-              << MAX_RETRIES << " attempts" << std::endl;
+    LOG_ERROR("DatabaseService") << "❌ Parameterized query failed after "
+                                 << MAX_RETRIES << " attempts";
     return pqxx::result{};
 }
 
@@ -0,0 +1,349 @@
+#include "services/DeviceSloTracker.h"
+#include "utils/ConfigManager.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace hms_firetv {
+
+namespace {
+
+// A degraded device recovers below this fraction of each objective
+constexpr double RECOVERY_FRACTION = 0.8;
+
+// Upper bound of the bucket holding the q-quantile, like MetricHistogram::percentileMicros
+double percentileMs(const std::array<uint64_t, MetricHistogram::BUCKETS>& buckets, uint64_t total, double q) {
+    if (total == 0) {
+        return 0.0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < MetricHistogram::BUCKETS; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            uint64_t us = bucket + 1 < MetricHistogram::BUCKETS
+                ? MetricHistogram::bucketLowerBound(bucket + 1)
+                : MetricHistogram::bucketLowerBound(bucket) * 2;
+            return static_cast<double>(us) / 1000.0;
+        }
+    }
+    return 0.0;
+}
+
+std::string formatReason(const char* what, double value, double objective, const char* unit) {
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%s %.1f%s > %.1f%s", what, value, unit, objective, unit);
+    return buf;
+}
+
+} // namespace
+
+// ============================================================================
+// LIFECYCLE
+// ============================================================================
+
+DeviceSloTracker& DeviceSloTracker::getInstance() {
+    static DeviceSloTracker instance([] {
+        Options options;
+        options.window = std::chrono::seconds(std::max(10,
+            ConfigManager::getEnvInt("SLO_WINDOW_SECONDS", 300)));
+        options.max_p95 = std::chrono::milliseconds(std::max(1,
+            ConfigManager::getEnvInt("SLO_P95_MS", 1500)));
+        options.max_error_rate = std::min(100, std::max(0,
+            ConfigManager::getEnvInt("SLO_ERROR_PERCENT", 5))) / 100.0;
+        options.min_samples = static_cast<uint32_t>(std::max(1,
+            ConfigManager::getEnvInt("SLO_MIN_SAMPLES", 20)));
+        return options;
+    }());
+    return instance;
+}
+
+DeviceSloTracker::DeviceSloTracker(Options options)
+    : options_(options),
+      slot_length_(std::chrono::duration_cast<std::chrono::nanoseconds>(options.window) /
+                   static_cast<int64_t>(std::max<size_t>(1, options.slots))) {
+    options_.slots = std::max<size_t>(1, options_.slots);
+}
+
+DeviceSloTracker::~DeviceSloTracker() {
+    stop();
+}
+
+void DeviceSloTracker::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    evaluator_ = std::thread(&DeviceSloTracker::evaluatorLoop, this);
+    LOG_INFO("DeviceSloTracker") << "Tracking p95 <= " << options_.max_p95.count() << "ms, errors <= "
+                                 << options_.max_error_rate * 100.0 << "% over " << options_.window.count() << "s";
+}
+
+void DeviceSloTracker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (evaluator_.joinable()) {
+        evaluator_.join();
+    }
+}
+
+void DeviceSloTracker::evaluatorLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait_for(lock, options_.eval_interval);
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        evaluate();
+        lock.lock();
+    }
+}
+
+void DeviceSloTracker::setAlertListener(AlertListener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = std::move(listener);
+}
+
+void DeviceSloTracker::remove(const std::string& device_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    windows_.erase(device_id);
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+int64_t DeviceSloTracker::epochOf(Clock::time_point now) const {
+    return now.time_since_epoch() / slot_length_;
+}
+
+DeviceSloTracker::Window& DeviceSloTracker::windowFor(const std::string& device_id, Clock::time_point now) {
+    auto it = windows_.find(device_id);
+    if (it == windows_.end()) {
+        it = windows_.emplace(device_id, Window{}).first;
+        it->second.slots.resize(options_.slots);
+        it->second.state_since = now;
+    }
+    return it->second;
+}
+
+DeviceSloTracker::Slot& DeviceSloTracker::slotFor(Window& window, Clock::time_point now) {
+    int64_t epoch = epochOf(now);
+    Slot& slot = window.slots[static_cast<size_t>(epoch) % window.slots.size()];
+    if (slot.epoch != epoch) {
+        slot = Slot();   // Stale: last used a full window ago
+        slot.epoch = epoch;
+    }
+    return slot;
+}
+
+void DeviceSloTracker::recordCommand(const std::string& device_id, bool success,
+                                     std::chrono::microseconds elapsed, Clock::time_point now) {
+    uint64_t us = elapsed.count() < 0 ? 0 : static_cast<uint64_t>(elapsed.count());
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot& slot = slotFor(windowFor(device_id, now), now);
+    slot.commands++;
+    if (!success) {
+        slot.errors++;
+    }
+    slot.latency[MetricHistogram::bucketFor(us)]++;
+}
+
+void DeviceSloTracker::recordProbe(const std::string& device_id, bool reachable,
+                                   std::chrono::microseconds elapsed, Clock::time_point now) {
+    uint64_t us = elapsed.count() < 0 ? 0 : static_cast<uint64_t>(elapsed.count());
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot& slot = slotFor(windowFor(device_id, now), now);
+    slot.probes++;
+    if (!reachable) {
+        slot.probe_failures++;   // Standby, not an error
+        return;
+    }
+    slot.latency[MetricHistogram::bucketFor(us)]++;
+}
+
+// ============================================================================
+// EVALUATION
+// ============================================================================
+
+DeviceSloTracker::Snapshot DeviceSloTracker::summarize(const std::string& device_id, const Window& window,
+                                                       Clock::time_point now) const {
+    Snapshot snapshot;
+    snapshot.device_id = device_id;
+    snapshot.state = window.state;
+    snapshot.reasons = window.reasons;
+    snapshot.in_state = std::chrono::duration_cast<std::chrono::seconds>(now - window.state_since);
+
+    int64_t epoch = epochOf(now);
+    int64_t oldest = epoch - static_cast<int64_t>(window.slots.size()) + 1;
+    std::array<uint64_t, MetricHistogram::BUCKETS> latency{};
+    uint64_t timed = 0;
+    for (const auto& slot : window.slots) {
+        if (slot.epoch < oldest || slot.epoch > epoch) {
+            continue;
+        }
+        snapshot.commands += slot.commands;
+        snapshot.errors += slot.errors;
+        snapshot.probes += slot.probes;
+        snapshot.probe_failures += slot.probe_failures;
+        for (size_t b = 0; b < MetricHistogram::BUCKETS; b++) {
+            latency[b] += slot.latency[b];
+            timed += slot.latency[b];
+        }
+    }
+
+    if (snapshot.commands > 0) {
+        snapshot.error_rate = static_cast<double>(snapshot.errors) / static_cast<double>(snapshot.commands);
+    }
+    snapshot.p50_ms = percentileMs(latency, timed, 0.50);
+    snapshot.p95_ms = percentileMs(latency, timed, 0.95);
+    snapshot.p99_ms = percentileMs(latency, timed, 0.99);
+    return snapshot;
+}
+
+void DeviceSloTracker::evaluate(Clock::time_point now) {
+    std::vector<Snapshot> transitions;
+    AlertListener listener;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const double max_p95_ms = static_cast<double>(options_.max_p95.count());
+
+        for (auto it = windows_.begin(); it != windows_.end();) {
+            Window& window = it->second;
+            Snapshot snapshot = summarize(it->first, window, now);
+            uint64_t samples = snapshot.commands + snapshot.probes;
+
+            if (samples == 0 && window.state == State::Ok) {
+                it = windows_.erase(it);   // Idle: nothing to judge or show
+                continue;
+            }
+
+            std::vector<std::string> breaches;
+            if (snapshot.p95_ms > max_p95_ms) {
+                breaches.push_back(formatReason("p95", snapshot.p95_ms, max_p95_ms, "ms"));
+            }
+            if (snapshot.error_rate > options_.max_error_rate) {
+                breaches.push_back(formatReason("error rate", snapshot.error_rate * 100.0,
+                                                options_.max_error_rate * 100.0, "%"));
+            }
+
+            State next = window.state;
+            if (window.state == State::Ok) {
+                if (samples >= options_.min_samples && !breaches.empty()) {
+                    next = State::Degraded;
+                }
+            } else if (samples == 0) {
+                next = State::Ok;   // Nothing left in the window to hold the alert up
+            } else if (samples >= options_.min_samples &&
+                       snapshot.p95_ms <= max_p95_ms * RECOVERY_FRACTION &&
+                       snapshot.error_rate <= options_.max_error_rate * RECOVERY_FRACTION) {
+                next = State::Ok;
+            }
+
+            if (next == State::Degraded && !breaches.empty()) {
+                window.reasons = breaches;   // Keep the last breach while recovering
+            }
+            if (next != window.state) {
+                window.state = next;
+                window.state_since = now;
+                if (next == State::Ok) {
+                    window.reasons.clear();
+                }
+                snapshot.state = next;
+                snapshot.reasons = window.reasons;
+                snapshot.in_state = std::chrono::seconds(0);
+                transitions.push_back(std::move(snapshot));
+                alerts_++;
+            }
+            ++it;
+        }
+        listener = listener_;
+    }
+
+    for (const auto& snapshot : transitions) {
+        if (snapshot.state == State::Degraded) {
+            LOG_WARN("DeviceSloTracker") << snapshot.device_id << " degraded: p95 " << snapshot.p95_ms
+                                         << "ms, error rate " << snapshot.error_rate * 100.0 << "% over "
+                                         << snapshot.commands << " commands";
+        } else {
+            LOG_INFO("DeviceSloTracker") << snapshot.device_id << " recovered";
+        }
+        if (listener) {
+            listener(snapshot);
+        }
+    }
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+DeviceSloTracker::Snapshot DeviceSloTracker::snapshot(const std::string& device_id, Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = windows_.find(device_id);
+    if (it == windows_.end()) {
+        Snapshot empty;
+        empty.device_id = device_id;
+        return empty;
+    }
+    return summarize(it->first, it->second, now);
+}
+
+Json::Value DeviceSloTracker::toJson(Clock::time_point now) const {
+    Json::Value json(Json::objectValue);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [device_id, window] : windows_) {
+        json[device_id] = summarize(device_id, window, now).toJson();
+    }
+    return json;
+}
+
+Json::Value DeviceSloTracker::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Json::Value json;
+    int degraded = 0;
+    for (const auto& [device_id, window] : windows_) {
+        if (window.state == State::Degraded) {
+            degraded++;
+        }
+    }
+    json["devices"] = static_cast<int>(windows_.size());
+    json["degraded"] = degraded;
+    json["alerts"] = static_cast<Json::UInt64>(alerts_);
+    json["window_s"] = static_cast<Json::Int64>(options_.window.count());
+    json["objective_p95_ms"] = static_cast<Json::Int64>(options_.max_p95.count());
+    json["objective_error_rate"] = options_.max_error_rate;
+    return json;
+}
+
+const char* DeviceSloTracker::stateName(State state) {
+    return state == State::Degraded ? "degraded" : "ok";
+}
+
+Json::Value DeviceSloTracker::Snapshot::toJson() const {
+    Json::Value json;
+    json["device_id"] = device_id;
+    json["state"] = stateName(state);
+    json["commands"] = static_cast<Json::UInt64>(commands);
+    json["errors"] = static_cast<Json::UInt64>(errors);
+    json["probes"] = static_cast<Json::UInt64>(probes);
+    json["probe_failures"] = static_cast<Json::UInt64>(probe_failures);
+    json["error_rate"] = error_rate;
+    json["p50_ms"] = p50_ms;
+    json["p95_ms"] = p95_ms;
+    json["p99_ms"] = p99_ms;
+    json["reasons"] = Json::arrayValue;
+    for (const auto& reason : reasons) {
+        json["reasons"].append(reason);
+    }
+    json["in_state_s"] = static_cast<Json::Int64>(in_state.count());
+    return json;
+}
+
+} // namespace hms_firetv
@@ -1,7 +1,6 @@
 #include "services/DiscoveryService.h"
-#include "services/DatabaseService.h"
-#include <iostream>
-#include <sstream>
+#include "services/EventBus.h"
+#include "utils/Logger.h"
 #include <chrono>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -31,8 +30,8 @@ namespace hms_firetv {
                                        int scan_interval_seconds)
         : subnet_prefix_(subnet_prefix),
           scan_interval_seconds_(scan_interval_seconds) {
-        std::cout << "[DiscoveryService] Initialized for subnet " << subnet_prefix
-                << ".0/24, interval=" << scan_interval_seconds << "s\n";
+        LOG_INFO("DiscoveryService") << "Initialized for subnet " << subnet_prefix
+                                   << ".0/24, interval=" << scan_interval_seconds << "s";
     }
 
     DiscoveryService::~DiscoveryService() {
@@ -43,7 +42,7 @@ namespace hms_firetv {
         if (running_.load()) return;
         running_.store(true);
         scan_thread_ = std::thread(&DiscoveryService::scanLoop, this);
-        std::cout << "[DiscoveryService] Started\n";
+        LOG_INFO("DiscoveryService") << "Started";
     }
 
     void DiscoveryService::stop() {
@@ -51,7 +50,7 @@ namespace hms_firetv {
         if (scan_thread_.joinable()) {
             scan_thread_.join();
         }
-        std::cout << "[DiscoveryService] Stopped\n";
+        LOG_INFO("DiscoveryService") << "Stopped";
     }
 
     void DiscoveryService::setMqttClient(std::shared_ptr<MQTTClient> mqtt_client) {
@@ -68,7 +67,7 @@ namespace hms_firetv {
             try {
                 runOnce();
             } catch (const std::exception &e) {
-                std::cerr << "[DiscoveryService] Scan error: " << e.what() << "\n";
+                LOG_ERROR("DiscoveryService") << "Scan error: " << e.what();
             }
 
             for (int i = 0; i < scan_interval_seconds_ && running_.load(); ++i) {
@@ -78,18 +77,23 @@ namespace hms_firetv {
     }
 
     void DiscoveryService::runOnce() {
-        std::cout << "[DiscoveryService] Starting subnet scan...\n";
+        LOG_INFO("DiscoveryService") << "Starting subnet scan...";
         auto discovered = scanSubnet();
-        std::cout << "[DiscoveryService] Found " << discovered.size()
-                << " devices with port 8009 open\n";
+        LOG_INFO("DiscoveryService") << "Found " << discovered.size()
+                                   << " devices with port 8009 open";
 
         if (!discovered.empty()) {
             matchAndUpdate(discovered);
         }
+
+        Json::Value scan;
+        scan["event"] = "scan";
+        scan["found"] = static_cast<Json::UInt64>(discovered.size());
+        EventBus::getInstance().publish("discovery", scan);
     }
 
     std::vector<DiscoveredDevice> DiscoveryService::getUnregisteredDevices() {
-        std::cout << "[DiscoveryService] Starting subnet scan...\n";
+        LOG_INFO("DiscoveryService") << "Starting subnet scan...";
         std::vector<DiscoveredDevice> unregistered = scanSubnet();
         auto registeredDevices = DeviceRepository::getInstance().getAllDevices(); // Ensure devices are loaded
         unregistered.erase(
@@ -293,23 +297,24 @@ namespace hms_firetv {
 
                 if (probeLightningWithToken(d.ip_address, device.api_key,
                                             device.client_token.value())) {
-                    std::cout << "[DiscoveryService] Device '" << device.device_id
-                            << "' moved: " << device.ip_address
-                            << " -> " << d.ip_address << "\n";
-
-                    std::ostringstream query;
-                    query << "UPDATE fire_tv_devices SET "
-                            << "ip_address = '" << d.ip_address << "', "
-                            << "last_seen_at = NOW(), "
-                            << "status = 'online', "
-                            << "updated_at = NOW() "
-                            << "WHERE device_id = '" << device.device_id << "'";
-                    DatabaseService::getInstance().executeCommand(query.str());
+                    LOG_INFO("DiscoveryService") << "Device '" << device.device_id
+                                               << "' moved: " << device.ip_address
+                                               << " -> " << d.ip_address;
+
+                    // Through the repository so the client pool rebuilds this device
+                    DeviceRepository::getInstance().updateDeviceIp(device.device_id, d.ip_address);
 
                     if (mqtt_client_) {
                         mqtt_client_->publishAvailability(device.device_id, true);
                     }
 
+                    Json::Value event;
+                    event["event"] = "moved";
+                    event["id"] = device.device_id;
+                    event["from"] = device.ip_address;
+                    event["to"] = d.ip_address;
+                    EventBus::getInstance().publish("discovery", event);
+
                     break;
                 }
             }
@@ -0,0 +1,161 @@
+#include "services/EventBus.h"
+#include "utils/ConfigManager.h"
+#include <algorithm>
+
+namespace hms_firetv {
+
+EventBus& EventBus::getInstance() {
+    static EventBus instance(static_cast<size_t>(
+        std::max(0, ConfigManager::getEnvInt("STREAM_REPLAY_EVENTS", 256))));
+    return instance;
+}
+
+EventBus::EventBus(size_t replay_capacity)
+    : replay_capacity_(replay_capacity),
+      subscribers_(std::make_shared<const std::vector<std::pair<uint64_t, Subscriber>>>()) {}
+
+uint64_t EventBus::subscribe(Subscriber subscriber) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto next = std::make_shared<std::vector<std::pair<uint64_t, Subscriber>>>(*subscribers_);
+    uint64_t id = next_subscriber_++;
+    next->emplace_back(id, std::move(subscriber));
+    subscribers_ = std::move(next);
+    return id;
+}
+
+void EventBus::unsubscribe(uint64_t id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto next = std::make_shared<std::vector<std::pair<uint64_t, Subscriber>>>(*subscribers_);
+    next->erase(std::remove_if(next->begin(), next->end(),
+                               [id](const auto& entry) { return entry.first == id; }),
+                next->end());
+    subscribers_ = std::move(next);
+}
+
+uint64_t EventBus::publish(const std::string& type, const Json::Value& fields) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return publishLocked(type, fields);
+}
+
+uint64_t EventBus::publishLocked(const std::string& type, const Json::Value& fields) {
+    uint64_t seq = ++seq_;
+
+    // Nobody listening: not even kept for replay, so reconnecting clients resync
+    if (subscribers_->empty()) {
+        replay_.clear();
+        return seq;
+    }
+
+    Json::Value event(Json::objectValue);
+    event["seq"] = static_cast<Json::UInt64>(seq);
+    event["t"] = type;
+    if (fields.isObject()) {
+        for (const auto& name : fields.getMemberNames()) {
+            event[name] = fields[name];
+        }
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    Event published{seq, std::make_shared<const std::string>(Json::writeString(writer, event))};
+
+    if (replay_capacity_ > 0) {
+        if (replay_.size() >= replay_capacity_) {
+            replay_.pop_front();
+        }
+        replay_.push_back(published);
+    }
+
+    // Held for the delivery loop, so every subscriber sees events in order;
+    // the snapshot keeps the list valid if a subscriber unsubscribes meanwhile
+    auto subscribers = subscribers_;
+    for (const auto& [id, subscriber] : *subscribers) {
+        subscriber(published);
+        delivered_++;
+    }
+    return seq;
+}
+
+void EventBus::commandResult(const std::string& device_id, const std::string& command, bool success,
+                             std::chrono::microseconds elapsed, const char* via) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (subscribers_->empty()) {
+        publishLocked("command", Json::Value());   // Skip building the fields
+        return;
+    }
+
+    Json::Value fields;
+    fields["id"] = device_id;
+    fields["cmd"] = command;
+    fields["ok"] = success;
+    fields["ms"] = static_cast<Json::Int64>(elapsed.count() / 1000);
+    fields["via"] = via;
+    publishLocked("command", fields);
+}
+
+void EventBus::deviceState(const std::string& device_id, const Json::Value& fields) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    Json::Value& known = devices_[device_id];
+
+    Json::Value delta(Json::objectValue);
+    for (const auto& name : fields.getMemberNames()) {
+        if (!known.isMember(name) || known[name] != fields[name]) {
+            known[name] = fields[name];
+            delta[name] = fields[name];
+        }
+    }
+    if (delta.empty()) {
+        return;
+    }
+    delta["id"] = device_id;
+    publishLocked("device", delta);
+}
+
+void EventBus::deviceLifecycle(const std::string& device_id, const std::string& change) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    devices_.erase(device_id);
+
+    Json::Value fields;
+    fields["id"] = device_id;
+    fields["change"] = change;
+    publishLocked("device", fields);
+}
+
+std::optional<std::vector<EventBus::Event>> EventBus::since(uint64_t seq) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (seq > seq_) {
+        return std::nullopt;   // From before a restart
+    }
+    if (seq == seq_) {
+        return std::vector<Event>();
+    }
+    // replay_ is contiguous and ends at seq_
+    if (replay_.empty() || replay_.front().seq > seq + 1) {
+        return std::nullopt;
+    }
+
+    std::vector<Event> missed;
+    missed.reserve(static_cast<size_t>(seq_ - seq));
+    for (const auto& event : replay_) {
+        if (event.seq > seq) {
+            missed.push_back(event);
+        }
+    }
+    return missed;
+}
+
+uint64_t EventBus::lastSeq() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return seq_;
+}
+
+Json::Value EventBus::stats() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    Json::Value json;
+    json["subscribers"] = static_cast<Json::UInt64>(subscribers_->size());
+    json["published"] = static_cast<Json::UInt64>(seq_);
+    json["delivered"] = static_cast<Json::UInt64>(delivered_);
+    json["retained"] = static_cast<Json::UInt64>(replay_.size());
+    return json;
+}
+
+} // namespace hms_firetv
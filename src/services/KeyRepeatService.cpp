@@ -0,0 +1,242 @@
+#include "services/KeyRepeatService.h"
+#include "utils/ConfigManager.h"
+#include "utils/Logger.h"
+#include <algorithm>
+
+namespace hms_firetv {
+
+KeyRepeatService::Sender KeyRepeatService::default_sender_;
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+Json::Value KeyRepeatService::HoldSummary::toJson() const {
+    Json::Value json;
+    json["key"] = key;
+    json["repeats"] = static_cast<Json::UInt64>(repeats);
+    json["held_ms"] = static_cast<Json::Int64>(held_ms);
+    return json;
+}
+
+const char* KeyRepeatService::holdStateName(HoldState state) {
+    switch (state) {
+        case HoldState::Started:   return "started";
+        case HoldState::Refreshed: return "refreshed";
+        case HoldState::Replaced:  return "replaced";
+    }
+    return "unknown";
+}
+
+std::optional<LightningStep> KeyRepeatService::navigationStep(const Json::Value& payload,
+                                                              std::string& error) {
+    Json::Value step;
+    step["command"] = "navigate";
+    if (payload.isMember("direction")) {
+        step["direction"] = payload["direction"];
+    } else if (payload.isMember("action")) {
+        step["action"] = payload["action"];
+    } else {
+        error = "Missing 'action' or 'direction' field";
+        return std::nullopt;
+    }
+    return LightningStep::compile(step, error);
+}
+
+// ============================================================================
+// SERVICE
+// ============================================================================
+
+void KeyRepeatService::setSender(Sender sender) {
+    default_sender_ = std::move(sender);
+}
+
+KeyRepeatService& KeyRepeatService::getInstance() {
+    static KeyRepeatService instance(
+        [](const Device& device, const LightningStep& step, SendCallback done) {
+            if (!default_sender_) {
+                LOG_ERROR("KeyRepeatService") << "No sender configured";
+                done(false);
+                return;
+            }
+            default_sender_(device, step, std::move(done));
+        },
+        [] {
+            Options options;
+            options.initial_delay = std::chrono::milliseconds(std::max(0,
+                ConfigManager::getEnvInt("NAV_REPEAT_DELAY_MS", 400)));
+            options.interval = std::chrono::milliseconds(std::max(20,
+                ConfigManager::getEnvInt("NAV_REPEAT_INTERVAL_MS", 100)));
+            options.watchdog = std::chrono::milliseconds(std::max(100,
+                ConfigManager::getEnvInt("NAV_HOLD_WATCHDOG_MS", 2000)));
+            return options;
+        }());
+    return instance;
+}
+
+KeyRepeatService::KeyRepeatService(Sender sender, Options options)
+    : sender_(std::move(sender)), options_(options), wheel_(options.tick) {
+    wheel_.start();
+}
+
+KeyRepeatService::~KeyRepeatService() {
+    stop();
+}
+
+KeyRepeatService::HoldState KeyRepeatService::hold(const Device& device, const LightningStep& step) {
+    HoldState state = HoldState::Started;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        auto it = holds_.find(device.device_id);
+
+        if (it != holds_.end() && it->second.step.path == step.path) {
+            it->second.last_heartbeat = now;
+            return HoldState::Refreshed;
+        }
+        if (it != holds_.end()) {
+            wheel_.cancel(it->second.timer);
+            LOG_DEBUG("KeyRepeatService") << device.device_id << ": " << it->second.step.detail
+                                          << " replaced by " << step.detail << " after " << it->second.repeats
+                                          << " repeats";
+            state = HoldState::Replaced;
+        }
+
+        Hold& hold = holds_[device.device_id];
+        hold = Hold();
+        hold.device = device;
+        hold.step = step;
+        hold.generation = generation = next_generation_++;
+        hold.started = now;
+        hold.last_heartbeat = now;
+        hold.in_flight = true;
+        scheduleRepeat(device.device_id, hold, options_.initial_delay);
+    }
+    holds_started_.fetch_add(1, std::memory_order_relaxed);
+
+    // The press itself goes out now; repeats follow from the wheel
+    sendPress(device.device_id, generation, device, step);
+    return state;
+}
+
+std::optional<KeyRepeatService::HoldSummary> KeyRepeatService::release(const std::string& device_id) {
+    HoldSummary summary;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = holds_.find(device_id);
+        if (it == holds_.end()) {
+            return std::nullopt;
+        }
+        wheel_.cancel(it->second.timer);
+        summary = summarize(it->second);
+        holds_.erase(it);
+    }
+
+    LOG_DEBUG("KeyRepeatService") << device_id << ": released " << summary.key << " after "
+                                  << summary.repeats << " repeats (" << summary.held_ms << "ms)";
+    return summary;
+}
+
+bool KeyRepeatService::isHolding(const std::string& device_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return holds_.count(device_id) > 0;
+}
+
+Json::Value KeyRepeatService::stats() const {
+    Json::Value json;
+    json["holds"] = static_cast<Json::UInt64>(holds_started_.load(std::memory_order_relaxed));
+    json["repeats"] = static_cast<Json::UInt64>(repeats_sent_.load(std::memory_order_relaxed));
+    json["skipped"] = static_cast<Json::UInt64>(repeats_skipped_.load(std::memory_order_relaxed));
+    json["watchdog_releases"] = static_cast<Json::UInt64>(watchdog_releases_.load(std::memory_order_relaxed));
+    json["interval_ms"] = static_cast<Json::Int64>(options_.interval.count());
+    json["watchdog_ms"] = static_cast<Json::Int64>(options_.watchdog.count());
+    std::lock_guard<std::mutex> lock(mutex_);
+    json["active"] = static_cast<Json::UInt>(holds_.size());
+    return json;
+}
+
+void KeyRepeatService::stop() {
+    wheel_.stop();
+    std::lock_guard<std::mutex> lock(mutex_);
+    holds_.clear();
+}
+
+// ============================================================================
+// REPEATING
+// ============================================================================
+
+void KeyRepeatService::scheduleRepeat(const std::string& device_id, Hold& hold,
+                                      std::chrono::milliseconds delay) {
+    hold.timer = wheel_.schedule(delay, [this, device_id, generation = hold.generation]() {
+        repeat(device_id, generation);
+    });
+}
+
+KeyRepeatService::HoldSummary KeyRepeatService::summarize(const Hold& hold) const {
+    HoldSummary summary;
+    summary.key = hold.step.detail;
+    summary.repeats = hold.repeats;
+    summary.held_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - hold.started).count();
+    return summary;
+}
+
+void KeyRepeatService::repeat(const std::string& device_id, uint64_t generation) {
+    Device device;
+    LightningStep step;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = holds_.find(device_id);
+        if (it == holds_.end() || it->second.generation != generation) {
+            return;  // Released or replaced
+        }
+        Hold& hold = it->second;
+        auto now = Clock::now();
+
+        // Client gone (no heartbeat) or held for too long: let go
+        bool orphaned = now - hold.last_heartbeat > options_.watchdog;
+        if (orphaned || now - hold.started > options_.max_hold) {
+            auto summary = summarize(hold);
+            holds_.erase(it);
+            if (orphaned) {
+                watchdog_releases_.fetch_add(1, std::memory_order_relaxed);
+            }
+            LOG_INFO("KeyRepeatService") << device_id << ": auto-released " << summary.key
+                                         << (orphaned ? " (no heartbeat)" : " (max hold)") << " after "
+                                         << summary.repeats << " repeats";
+            return;
+        }
+
+        scheduleRepeat(device_id, hold, options_.interval);
+
+        // Previous press still on the wire: skip rather than queue behind it
+        if (hold.in_flight) {
+            repeats_skipped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        hold.in_flight = true;
+        hold.repeats++;
+        device = hold.device;
+        step = hold.step;
+    }
+
+    repeats_sent_.fetch_add(1, std::memory_order_relaxed);
+    sendPress(device_id, generation, device, step);
+}
+
+void KeyRepeatService::sendPress(const std::string& device_id, uint64_t generation,
+                                 const Device& device, const LightningStep& step) {
+    sender_(device, step, [this, device_id, generation](bool success) {
+        if (!success) {
+            LOG_ERROR("KeyRepeatService") << "Key press failed on " << device_id;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = holds_.find(device_id);
+        if (it != holds_.end() && it->second.generation == generation) {
+            it->second.in_flight = false;
+        }
+    });
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,294 @@
+#include "services/MacroRunner.h"
+#include "clients/LightningClientPool.h"
+#include "utils/ConfigManager.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+
+namespace hms_firetv {
+
+namespace {
+
+int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// ============================================================================
+// RESULTS
+// ============================================================================
+
+Json::Value StepResult::toJson() const {
+    Json::Value json;
+    json["index"] = static_cast<Json::UInt>(index);
+    json["command"] = command;
+    if (!detail.empty()) {
+        json["detail"] = detail;
+    }
+    json["success"] = success;
+    json["status_code"] = status_code;
+    json["response_time_ms"] = response_time_ms;
+    json["started_at_ms"] = static_cast<Json::Int64>(started_at_ms);
+    if (timing.measured()) {
+        json["timing"] = timing.toJson();
+    }
+    if (error.has_value()) {
+        json["error"] = error.value();
+    }
+    return json;
+}
+
+CommandTiming SequenceResult::timing() const {
+    CommandTiming total;
+    total.queue_us = queue_ms * 1000;
+    for (const auto& step : steps) {
+        total.add(step.timing);
+    }
+    return total;
+}
+
+Json::Value SequenceResult::toJson() const {
+    Json::Value json;
+    json["success"] = success;
+    json["queue_ms"] = static_cast<Json::Int64>(queue_ms);
+    json["total_ms"] = static_cast<Json::Int64>(total_ms);
+    json["timing"] = timing().toJson();
+    json["steps_run"] = static_cast<Json::UInt>(steps_run);
+    json["steps"] = Json::arrayValue;
+    for (const auto& step : steps) {
+        json["steps"].append(step.toJson());
+    }
+    if (error.has_value()) {
+        json["error"] = error.value();
+    }
+    return json;
+}
+
+// ============================================================================
+// RUNNER
+// ============================================================================
+
+MacroRunner& MacroRunner::getInstance() {
+    static MacroRunner instance(static_cast<size_t>(std::max(1,
+        ConfigManager::getEnvInt("MACRO_WORKERS", 4))));
+    return instance;
+}
+
+MacroRunner::MacroRunner(size_t workers) : worker_count_(workers) {}
+
+MacroRunner::~MacroRunner() {
+    stop();
+}
+
+SequenceResult MacroRunner::run(LightningClient& client,
+                                const LightningSequence& sequence,
+                                bool stop_on_error) {
+    SequenceResult result;
+    result.success = true;
+    result.steps.reserve(sequence.size());
+    const int64_t start = steadyNowMs();
+
+    const Deadline& deadline = client.deadline();
+
+    for (size_t i = 0; i < sequence.size(); i++) {
+        const auto& step = sequence[i];
+
+        if (deadline.expired()) {
+            Deadline::recordCancelled(step.kind == LightningStep::Kind::Wake
+                                          ? Deadline::Stage::Wake : Deadline::Stage::Transport);
+            result.success = false;
+            result.error = Deadline::EXCEEDED;
+            break;
+        }
+
+        StepResult step_result;
+        step_result.index = i;
+        step_result.command = step.command;
+        step_result.detail = step.detail;
+        step_result.started_at_ms = steadyNowMs() - start;
+
+        switch (step.kind) {
+            case LightningStep::Kind::Request: {
+                auto command = client.sendRequest(step.path, step.body);
+                step_result.success = command.success;
+                step_result.status_code = command.status_code;
+                step_result.response_time_ms = command.response_time_ms;
+                step_result.timing = command.timing;
+                step_result.error = command.error;
+                break;
+            }
+            case LightningStep::Kind::Wake: {
+                auto wake_start = std::chrono::steady_clock::now();
+                step_result.success = client.wakeDevice();
+                step_result.timing.wake_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - wake_start).count();
+                step_result.response_time_ms = static_cast<int>(step_result.timing.wake_us / 1000);
+                break;
+            }
+            case LightningStep::Kind::Delay:
+                step_result.success = true;
+                break;
+        }
+
+        bool failed = !step_result.success;
+        result.steps.push_back(std::move(step_result));
+        result.steps_run++;
+
+        if (failed) {
+            result.success = false;
+            if (stop_on_error) {
+                break;
+            }
+        }
+
+        if (step.delay_after_ms > 0 && i + 1 < sequence.size()) {
+            auto wake_at = Deadline::Clock::now() + std::chrono::milliseconds(step.delay_after_ms);
+            std::this_thread::sleep_until(std::min(wake_at, deadline.at()));
+        }
+    }
+
+    result.total_ms = steadyNowMs() - start;
+    return result;
+}
+
+void MacroRunner::runAsync(const std::string& device_id,
+                           std::shared_ptr<const LightningSequence> sequence,
+                           bool stop_on_error,
+                           const Deadline& deadline,
+                           ResultCallback callback) {
+    if (stopped_.load()) {
+        SequenceResult result;
+        result.error = "Macro runner stopped";
+        callback(std::move(result));
+        return;
+    }
+    ensureStarted();
+
+    const int64_t queued_at = steadyNowMs();
+
+    // May run inline or on whichever thread releases the device's client:
+    // hand off to a worker right away
+    LightningClientPool::getInstance().leaseAsync(device_id,
+        [this, sequence = std::move(sequence), stop_on_error, queued_at,
+         callback = std::move(callback)](LightningClientPool::Lease lease) mutable {
+
+        if (!lease) {
+            SequenceResult result;
+            result.error = lease.deadlineExceeded() ? Deadline::EXCEEDED : "Device not found";
+            callback(std::move(result));
+            return;
+        }
+
+        auto shared_lease = std::make_shared<LightningClientPool::Lease>(std::move(lease));
+        enqueue([shared_lease, sequence, stop_on_error, queued_at,
+                 callback = std::move(callback)](bool cancelled) {
+            if (cancelled) {
+                shared_lease->release();
+                SequenceResult result;
+                result.error = "Macro runner stopped";
+                callback(std::move(result));
+                return;
+            }
+
+            int64_t queue_ms = steadyNowMs() - queued_at;
+            if ((*shared_lease)->deadline().expired()) {
+                // Waited for a worker past the deadline
+                shared_lease->release();
+                Deadline::recordCancelled(Deadline::Stage::Queue);
+                SequenceResult result;
+                result.error = Deadline::EXCEEDED;
+                result.queue_ms = queue_ms;
+                callback(std::move(result));
+                return;
+            }
+            SequenceResult result = run(**shared_lease, *sequence, stop_on_error);
+            result.queue_ms = queue_ms;
+            shared_lease->release();  // Serve the next waiter before reporting
+            callback(std::move(result));
+        });
+    }, deadline);
+}
+
+size_t MacroRunner::queueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
+
+void MacroRunner::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_.exchange(true)) {
+            return;
+        }
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+
+    // Leases were taken before enqueueing; fail the leftovers so they return
+    std::deque<Job> leftover;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        leftover.swap(jobs_);
+    }
+    for (auto& job : leftover) {
+        job(true);
+    }
+}
+
+void MacroRunner::ensureStarted() {
+    std::call_once(start_flag_, [this]() {
+        for (size_t i = 0; i < worker_count_; i++) {
+            workers_.emplace_back(&MacroRunner::workerLoop, this);
+        }
+        LOG_INFO("MacroRunner") << "Started " << worker_count_ << " workers";
+    });
+}
+
+void MacroRunner::enqueue(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopped_.load()) {
+            jobs_.push_back(std::move(job));
+            job = nullptr;
+        }
+    }
+
+    if (job) {
+        job(true);  // Stopped between lease and enqueue
+        return;
+    }
+    cv_.notify_one();
+}
+
+void MacroRunner::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !jobs_.empty() || stopped_.load(); });
+            if (stopped_.load()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        try {
+            job(false);
+        } catch (const std::exception& e) {
+            LOG_ERROR("MacroRunner") << "Sequence failed: " << e.what();
+        } catch (...) {
+            LOG_ERROR("MacroRunner") << "Sequence failed with unknown exception";
+        }
+    }
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,562 @@
+#include "services/PairingSessionManager.h"
+#include "clients/LightningClientPool.h"
+#include "repositories/DeviceRepository.h"
+#include "utils/Deadline.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace hms_firetv {
+
+namespace {
+
+// Per TV request issued by a worker
+constexpr std::chrono::milliseconds TV_REQUEST_BUDGET{5000};
+
+std::string formatUtc(std::chrono::system_clock::time_point time) {
+    auto time_t_value = std::chrono::system_clock::to_time_t(time);
+    std::ostringstream oss;
+    oss << std::put_time(std::gmtime(&time_t_value), "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
+
+} // namespace
+
+// ============================================================================
+// SESSION
+// ============================================================================
+
+const char* pairingStateName(PairingState state) {
+    switch (state) {
+        case PairingState::DisplayingPin: return "displaying_pin";
+        case PairingState::AwaitingPin:   return "awaiting_pin";
+        case PairingState::Verifying:     return "verifying";
+        case PairingState::Paired:        return "paired";
+        case PairingState::Failed:        return "failed";
+        case PairingState::Expired:       return "expired";
+        case PairingState::Cancelled:     return "cancelled";
+    }
+    return "unknown";
+}
+
+Json::Value PairingSession::toJson() const {
+    Json::Value json;
+    json["session_id"] = session_id;
+    json["device_id"] = device_id;
+    json["state"] = pairingStateName(state);
+    json["attempts"] = attempts;
+    json["version"] = static_cast<Json::UInt64>(version);
+    if (!error.empty()) {
+        json["error"] = error;
+    }
+    if (isActive() || state == PairingState::Failed) {
+        auto left = std::chrono::duration_cast<std::chrono::seconds>(
+            expires_at - std::chrono::system_clock::now()).count();
+        json["expires_at"] = formatUtc(expires_at);
+        json["expires_in_seconds"] = static_cast<Json::Int64>(std::max<int64_t>(0, left));
+    }
+    return json;
+}
+
+// ============================================================================
+// MANAGER
+// ============================================================================
+
+const char* PairingSessionManager::verifyErrorMessage(VerifyError error) {
+    switch (error) {
+        case VerifyError::None:         return "";
+        case VerifyError::NoSession:    return "No pairing in progress. Start pairing first.";
+        case VerifyError::NotDisplayed: return "PIN was not displayed on TV. Start pairing again.";
+        case VerifyError::Expired:      return "Pairing session expired. Start pairing again.";
+        case VerifyError::Busy:         return "Pairing step already in progress";
+    }
+    return "";
+}
+
+PairingSessionManager& PairingSessionManager::getInstance() {
+    static PairingSessionManager instance(Operations{
+        [](const std::string& device_id) {
+            auto client = LightningClientPool::getInstance().lease(
+                device_id, Deadline::after(TV_REQUEST_BUDGET));
+            return client && client->displayPin();
+        },
+        [](const std::string& device_id, const std::string& pin) {
+            auto client = LightningClientPool::getInstance().lease(
+                device_id, Deadline::after(TV_REQUEST_BUDGET));
+            return client ? client->verifyPin(pin) : std::string();
+        },
+        [](const std::string& device_id, const std::string& token) {
+            // Repository notifies the client pool, which rebuilds with the new token
+            return DeviceRepository::getInstance().completePairing(device_id, token);
+        }
+    }, Timing{});
+    return instance;
+}
+
+PairingSessionManager::PairingSessionManager(Operations operations, Timing timing,
+                                             size_t tv_workers)
+    : ops_(std::move(operations)), timing_(timing) {
+    poller_ = std::thread(&PairingSessionManager::pollerLoop, this);
+    for (size_t i = 0; i < std::max<size_t>(1, tv_workers); i++) {
+        tv_workers_.emplace_back(&PairingSessionManager::workerLoop, this);
+    }
+}
+
+PairingSessionManager::~PairingSessionManager() {
+    stop();
+}
+
+PairingSession PairingSessionManager::start(const std::string& device_id) {
+    std::vector<Notification> notifications;
+    PairingSession session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = sessions_[device_id];
+
+        // Long-polls on the previous session follow the device to the new one
+        entry.session = PairingSession();
+        entry.session.session_id = newSessionId();
+        entry.session.device_id = device_id;
+        entry.session.expires_at = std::chrono::system_clock::now() + timing_.session_ttl;
+        entry.pin.clear();
+        entry.pin_displayed = false;
+        changed(entry, notifications);
+        session = entry.session;
+
+        post([this, device_id, id = session.session_id]() {
+            runDisplay(device_id, id);
+        });
+        scheduleExpiry(device_id, session.session_id);
+    }
+    notify(notifications);
+
+    LOG_INFO("PairingSessionManager") << "Started session " << session.session_id
+                                      << " for " << device_id;
+    return session;
+}
+
+std::optional<PairingSession> PairingSessionManager::verify(const std::string& device_id,
+                                                            const std::string& pin,
+                                                            VerifyError& error) {
+    std::vector<Notification> notifications;
+    std::optional<PairingSession> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(device_id);
+        if (it == sessions_.end()) {
+            error = VerifyError::NoSession;
+            return std::nullopt;
+        }
+
+        auto& entry = it->second;
+        switch (entry.session.state) {
+            case PairingState::DisplayingPin:
+            case PairingState::Verifying:
+                error = VerifyError::Busy;
+                return std::nullopt;
+            case PairingState::Expired:
+                error = VerifyError::Expired;
+                return std::nullopt;
+            case PairingState::Paired:
+            case PairingState::Cancelled:
+                error = VerifyError::NoSession;
+                return std::nullopt;
+            case PairingState::AwaitingPin:
+            case PairingState::Failed:
+                break;
+        }
+        if (!entry.pin_displayed) {
+            error = VerifyError::NotDisplayed;
+            return std::nullopt;
+        }
+
+        entry.pin = pin;
+        entry.session.state = PairingState::Verifying;
+        entry.session.attempts = 0;
+        entry.session.error.clear();
+        changed(entry, notifications);
+        session = entry.session;
+
+        post([this, device_id, id = entry.session.session_id]() {
+            runVerify(device_id, id);
+        });
+    }
+    notify(notifications);
+
+    error = VerifyError::None;
+    return session;
+}
+
+std::optional<PairingSession> PairingSessionManager::get(const std::string& device_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(device_id);
+    if (it == sessions_.end()) {
+        return std::nullopt;
+    }
+    return it->second.session;
+}
+
+void PairingSessionManager::waitForChange(const std::string& device_id,
+                                          uint64_t since_version,
+                                          std::chrono::milliseconds timeout,
+                                          ChangeCallback callback) {
+    std::optional<PairingSession> current;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(device_id);
+        if (it != sessions_.end()) {
+            current = it->second.session;
+        }
+
+        bool answer_now = stopped_ || timeout.count() <= 0 || !current ||
+                          current->version != since_version;
+        if (!answer_now) {
+            uint64_t waiter_id = next_waiter_id_++;
+            it->second.waiters.push_back(Waiter{waiter_id, since_version, std::move(callback)});
+
+            // Timed out: answer with whatever the session looks like now
+            schedule(timeout, [this, device_id, waiter_id]() {
+                ChangeCallback expired;
+                std::optional<PairingSession> session;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto it = sessions_.find(device_id);
+                    if (it == sessions_.end()) {
+                        return;
+                    }
+                    auto& waiters = it->second.waiters;
+                    for (auto w = waiters.begin(); w != waiters.end(); ++w) {
+                        if (w->id == waiter_id) {
+                            expired = std::move(w->callback);
+                            waiters.erase(w);
+                            session = it->second.session;
+                            break;
+                        }
+                    }
+                }
+                if (expired) {
+                    expired(std::move(session));
+                }
+            });
+            return;
+        }
+    }
+    callback(std::move(current));
+}
+
+void PairingSessionManager::cancel(const std::string& device_id) {
+    std::vector<Notification> notifications;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(device_id);
+        if (it == sessions_.end()) {
+            return;
+        }
+        auto& session = it->second.session;
+        if (!session.isActive() && session.state != PairingState::Failed) {
+            return;
+        }
+        finish(it->second, PairingState::Cancelled, "", notifications);
+    }
+    notify(notifications);
+
+    LOG_INFO("PairingSessionManager") << "Cancelled pairing for " << device_id;
+}
+
+void PairingSessionManager::stop() {
+    std::vector<Notification> notifications;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            return;
+        }
+        stopped_ = true;
+        timers_.clear();
+        tv_jobs_.clear();
+        for (auto& [device_id, entry] : sessions_) {
+            for (auto& waiter : entry.waiters) {
+                notifications.emplace_back(std::move(waiter.callback), entry.session);
+            }
+            entry.waiters.clear();
+        }
+    }
+    cv_.notify_all();
+    tv_cv_.notify_all();
+    if (poller_.joinable()) {
+        poller_.join();
+    }
+    for (auto& worker : tv_workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    notify(notifications);
+}
+
+// ============================================================================
+// STATE MACHINE (mutex_ held)
+// ============================================================================
+
+void PairingSessionManager::schedule(Clock::duration delay, std::function<void()> job) {
+    if (stopped_) {
+        return;
+    }
+    bool earliest = timers_.empty() || Clock::now() + delay < timers_.begin()->first;
+    timers_.emplace(Clock::now() + delay, std::move(job));
+    if (earliest) {
+        cv_.notify_one();
+    }
+}
+
+void PairingSessionManager::post(std::function<void()> job) {
+    if (stopped_) {
+        return;
+    }
+    tv_jobs_.push_back(std::move(job));
+    tv_cv_.notify_one();
+}
+
+void PairingSessionManager::changed(Entry& entry, std::vector<Notification>& out) {
+    // Versions are global, so every waiter's cursor is now stale
+    entry.session.version = next_version_++;
+    for (auto& waiter : entry.waiters) {
+        out.emplace_back(std::move(waiter.callback), entry.session);
+    }
+    entry.waiters.clear();
+}
+
+void PairingSessionManager::finish(Entry& entry, PairingState state, const std::string& error,
+                                   std::vector<Notification>& out) {
+    entry.session.state = state;
+    entry.session.error = error;
+    entry.pin.clear();
+    changed(entry, out);
+    if (state != PairingState::Failed) {
+        scheduleRemoval(entry.session.device_id, entry.session.session_id);
+    }
+}
+
+void PairingSessionManager::scheduleExpiry(const std::string& device_id,
+                                           const std::string& session_id) {
+    schedule(timing_.session_ttl, [this, device_id, session_id]() {
+        std::vector<Notification> notifications;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto* entry = findSession(device_id, session_id);
+            if (!entry) {
+                return;
+            }
+            auto& session = entry->session;
+            if (!session.isActive() && session.state != PairingState::Failed) {
+                return;
+            }
+            finish(*entry, PairingState::Expired, "Pairing session expired", notifications);
+        }
+        notify(notifications);
+    });
+}
+
+void PairingSessionManager::scheduleRemoval(const std::string& device_id,
+                                            const std::string& session_id) {
+    schedule(timing_.finished_retention, [this, device_id, session_id]() {
+        std::vector<Notification> notifications;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto* entry = findSession(device_id, session_id);
+            if (!entry) {
+                return;
+            }
+            for (auto& waiter : entry->waiters) {
+                notifications.emplace_back(std::move(waiter.callback), std::nullopt);
+            }
+            sessions_.erase(device_id);
+        }
+        notify(notifications);
+    });
+}
+
+PairingSessionManager::Entry* PairingSessionManager::findSession(const std::string& device_id,
+                                                                 const std::string& session_id) {
+    auto it = sessions_.find(device_id);
+    if (it == sessions_.end() || it->second.session.session_id != session_id) {
+        return nullptr;  // Gone, or replaced by a newer start()
+    }
+    return &it->second;
+}
+
+// ============================================================================
+// TV JOBS
+// ============================================================================
+
+void PairingSessionManager::runDisplay(const std::string& device_id,
+                                       const std::string& session_id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto* entry = findSession(device_id, session_id);
+        if (!entry || entry->session.state != PairingState::DisplayingPin) {
+            return;
+        }
+    }
+
+    bool displayed = false;
+    try {
+        displayed = ops_.display_pin(device_id);
+    } catch (const std::exception& e) {
+        LOG_ERROR("PairingSessionManager") << "Error displaying PIN on " << device_id
+                                           << ": " << e.what();
+    }
+
+    std::vector<Notification> notifications;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto* entry = findSession(device_id, session_id);
+        if (!entry || entry->session.state != PairingState::DisplayingPin) {
+            return;
+        }
+        if (displayed) {
+            entry->pin_displayed = true;
+            entry->session.state = PairingState::AwaitingPin;
+            changed(*entry, notifications);
+        } else {
+            finish(*entry, PairingState::Failed,
+                   "Failed to display PIN on TV. Check device connectivity.", notifications);
+        }
+    }
+    notify(notifications);
+}
+
+void PairingSessionManager::runVerify(const std::string& device_id,
+                                      const std::string& session_id) {
+    std::string pin;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto* entry = findSession(device_id, session_id);
+        if (!entry || entry->session.state != PairingState::Verifying) {
+            return;
+        }
+        pin = entry->pin;
+    }
+
+    // The TV may answer "OK" before it issues the token, so poll until it does
+    std::string token;
+    try {
+        token = ops_.verify_pin(device_id, pin);
+    } catch (const std::exception& e) {
+        LOG_ERROR("PairingSessionManager") << "Error verifying PIN on " << device_id
+                                           << ": " << e.what();
+    }
+
+    bool stored = false;
+    if (!token.empty()) {
+        try {
+            stored = ops_.complete(device_id, token);
+        } catch (const std::exception& e) {
+            LOG_ERROR("PairingSessionManager") << "Error storing token for " << device_id
+                                               << ": " << e.what();
+        }
+    }
+
+    std::vector<Notification> notifications;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto* entry = findSession(device_id, session_id);
+        if (!entry || entry->session.state != PairingState::Verifying) {
+            return;
+        }
+        auto& session = entry->session;
+        session.attempts++;
+
+        if (!token.empty()) {
+            if (stored) {
+                finish(*entry, PairingState::Paired, "", notifications);
+            } else {
+                finish(*entry, PairingState::Failed, "Failed to store pairing token", notifications);
+            }
+        } else if (session.attempts >= timing_.max_token_polls) {
+            finish(*entry, PairingState::Failed, "Failed to complete pairing with device",
+                   notifications);
+        } else {
+            // The poller only hands the next poll back to a worker
+            schedule(timing_.poll_interval, [this, device_id, session_id]() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                post([this, device_id, session_id]() {
+                    runVerify(device_id, session_id);
+                });
+            });
+        }
+    }
+    notify(notifications);
+
+    if (stored) {
+        LOG_INFO("PairingSessionManager") << "Paired device " << device_id;
+    }
+}
+
+// ============================================================================
+// POLLER AND WORKERS
+// ============================================================================
+
+void PairingSessionManager::pollerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        if (timers_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        auto due = timers_.begin()->first;
+        if (Clock::now() < due) {
+            cv_.wait_until(lock, due);
+            continue;
+        }
+        auto job = std::move(timers_.begin()->second);
+        timers_.erase(timers_.begin());
+
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+void PairingSessionManager::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        tv_cv_.wait(lock, [this]() { return stopped_ || !tv_jobs_.empty(); });
+        if (stopped_) {
+            return;
+        }
+        auto job = std::move(tv_jobs_.front());
+        tv_jobs_.pop_front();
+
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+void PairingSessionManager::notify(std::vector<Notification>& notifications) {
+    for (auto& [callback, session] : notifications) {
+        if (callback) {
+            callback(std::move(session));
+        }
+    }
+    notifications.clear();
+}
+
+std::string PairingSessionManager::newSessionId() {
+    static std::mutex rng_mutex;
+    static std::mt19937_64 rng(std::random_device{}());
+
+    uint64_t value;
+    {
+        std::lock_guard<std::mutex> lock(rng_mutex);
+        value = rng();
+    }
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << value;
+    return oss.str();
+}
+
+} // namespace hms_firetv
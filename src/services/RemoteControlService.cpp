@@ -0,0 +1,332 @@
+#include "services/RemoteControlService.h"
+#include "repositories/DeviceRepository.h"
+#include "services/DeviceSloTracker.h"
+#include "services/EventBus.h"
+#include "services/MacroRunner.h"
+#include "utils/ConfigManager.h"
+#include "utils/Metrics.h"
+#include <algorithm>
+#include <charconv>
+
+namespace hms_firetv {
+
+// ============================================================================
+// KEY TABLE
+// ============================================================================
+
+namespace {
+
+struct KeyTable {
+    std::vector<std::string> names;
+    std::vector<LightningStep> steps;
+    std::vector<std::shared_ptr<const LightningSequence>> sequences;   // One step each, for MacroRunner
+};
+
+// Codes are part of the binary wire format: append only
+const KeyTable& keyTable() {
+    static const KeyTable table = [] {
+        KeyTable built;
+        auto add = [&built](const char* command, const char* action) {
+            Json::Value step;
+            step["command"] = command;
+            step["action"] = action;
+            std::string error;
+            auto compiled = LightningStep::compile(step, error);
+            built.names.emplace_back(action);
+            built.steps.push_back(compiled.value());
+            built.sequences.push_back(std::make_shared<const LightningSequence>(1, compiled.value()));
+        };
+        for (const char* action : {"dpad_up", "dpad_down", "dpad_left", "dpad_right", "select",
+                                   "home", "back", "menu", "volume_up", "volume_down",
+                                   "volume_mute", "sleep", "wake"}) {
+            add("navigate", action);
+        }
+        for (const char* action : {"play", "pause", "scan_forward", "scan_backward"}) {
+            add("media", action);
+        }
+        return built;
+    }();
+    return table;
+}
+
+std::shared_ptr<const LightningSequence> keySequence(const LightningStep& step) {
+    const auto& table = keyTable();
+    if (&step >= table.steps.data() && &step < table.steps.data() + table.steps.size()) {
+        return table.sequences[static_cast<size_t>(&step - table.steps.data())];
+    }
+    return std::make_shared<const LightningSequence>(1, step);
+}
+
+CommandResult commandResult(const SequenceResult& sequence) {
+    CommandResult result;
+    result.success = sequence.success;
+    result.timing = sequence.timing();
+    result.error = sequence.error;
+    if (!sequence.steps.empty()) {
+        const StepResult& step = sequence.steps.front();
+        result.status_code = step.status_code;
+        result.response_time_ms = step.response_time_ms;
+        if (!result.error.has_value()) {
+            result.error = step.error;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+const std::vector<std::string>& RemoteControlService::keyNames() {
+    return keyTable().names;
+}
+
+const LightningStep* RemoteControlService::key(std::string_view name) {
+    const auto& table = keyTable();
+    // d-pad keys may drop the prefix ("up")
+    for (size_t i = 0; i < table.names.size(); i++) {
+        std::string_view candidate = table.names[i];
+        if (candidate == name ||
+            (candidate.size() == name.size() + 5 && candidate.substr(0, 5) == "dpad_" && candidate.substr(5) == name)) {
+            return &table.steps[i];
+        }
+    }
+    return nullptr;
+}
+
+std::optional<RemoteControlService::Message> RemoteControlService::parse(std::string_view message, bool binary,
+                                                                         std::string& error) {
+    Message parsed;
+
+    if (binary) {
+        if (message.size() != 4) {
+            error = "binary commands are 4 bytes";
+            return std::nullopt;
+        }
+        auto byte = [&message](size_t i) { return static_cast<uint8_t>(message[i]); };
+        parsed.n = static_cast<uint32_t>(byte(0)) << 8 | byte(1);
+        uint8_t flags = byte(3);
+        if (flags & 2) {
+            parsed.type = Message::Type::Release;
+            return parsed;
+        }
+        if (byte(2) >= keyTable().steps.size()) {
+            error = "unknown key code " + std::to_string(byte(2));
+            return std::nullopt;
+        }
+        parsed.type = (flags & 1) ? Message::Type::Hold : Message::Type::Press;
+        parsed.key = &keyTable().steps[byte(2)];
+        return parsed;
+    }
+
+    if (!message.empty() && message[0] == '@') {
+        parsed.type = Message::Type::Select;
+        parsed.device_id = std::string(message.substr(1));
+        if (parsed.device_id.empty()) {
+            error = "missing device id";
+            return std::nullopt;
+        }
+        return parsed;
+    }
+
+    size_t space = message.find(' ');
+    if (space == std::string_view::npos) {
+        error = "expected '<n> <key>'";
+        return std::nullopt;
+    }
+    auto [end, ec] = std::from_chars(message.data(), message.data() + space, parsed.n);
+    if (ec != std::errc() || end != message.data() + space) {
+        error = "invalid command number";
+        return std::nullopt;
+    }
+
+    std::string_view name = message.substr(space + 1);
+    if (name == "-") {
+        parsed.type = Message::Type::Release;
+        return parsed;
+    }
+    if (!name.empty() && name.back() == '+') {
+        parsed.type = Message::Type::Hold;
+        name.remove_suffix(1);
+    }
+    parsed.key = key(name);
+    if (!parsed.key) {
+        error = "unknown key '" + std::string(name) + "'";
+        return std::nullopt;
+    }
+    return parsed;
+}
+
+// ============================================================================
+// SERVICE
+// ============================================================================
+
+RemoteControlService& RemoteControlService::getInstance() {
+    static RemoteControlService instance(
+        [](const Device& device, const LightningStep& step, std::function<void(CommandResult)> done) {
+            // Takes its turn in the device's client queue with MQTT commands and macros
+            MacroRunner::getInstance().runAsync(device.device_id, keySequence(step), true,
+                Deadline::after(Deadline::defaultBudget()),
+                [done = std::move(done)](SequenceResult sequence) { done(commandResult(sequence)); });
+        },
+        [](const std::string& device_id) { return DeviceRepository::getInstance().getDeviceById(device_id); },
+        [] {
+            Options options;
+            options.max_queued = static_cast<size_t>(std::max(1, ConfigManager::getEnvInt("REMOTE_MAX_QUEUED", 16)));
+            return options;
+        }());
+
+    static const bool subscribed = [] {
+        DeviceRepository::addChangeListener([](const std::string& device_id, DeviceChange) {
+            RemoteControlService::getInstance().forget(device_id);
+        });
+        return true;
+    }();
+    (void)subscribed;
+
+    return instance;
+}
+
+RemoteControlService::RemoteControlService(Sender sender, Resolver resolver, Options options)
+    : sender_(std::move(sender)), resolver_(std::move(resolver)), options_(options) {}
+
+std::optional<Device> RemoteControlService::device(const std::string& device_id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto lane = lanes_.find(device_id);
+        if (lane != lanes_.end() && lane->second.device.has_value()) {
+            return lane->second.device;
+        }
+    }
+
+    // Outside the lock: a database read must not stall other devices' presses
+    auto resolved = resolver_(device_id);
+    if (resolved.has_value()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lanes_[device_id].device = resolved;
+    }
+    return resolved;
+}
+
+void RemoteControlService::forget(const std::string& device_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto lane = lanes_.find(device_id);
+    if (lane == lanes_.end()) {
+        return;
+    }
+    if (!lane->second.in_flight && lane->second.waiting.empty()) {
+        lanes_.erase(lane);
+    } else {
+        lane->second.device.reset();   // Waiting presses resolve it again
+    }
+}
+
+void RemoteControlService::press(const std::string& device_id, const LightningStep& key, AckCallback done) {
+    auto resolved = device(device_id);
+    if (!resolved.has_value()) {
+        rejected_++;
+        Ack ack;
+        ack.error = "Device not found";
+        done(ack);
+        return;
+    }
+
+    Press press{&key, std::move(done), Clock::now()};
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Lane& lane = lanes_[device_id];
+        if (!lane.in_flight) {
+            lane.in_flight = true;
+        } else if (lane.waiting.size() < options_.max_queued) {
+            lane.waiting.push_back(std::move(press));
+            return;
+        } else {
+            full = true;
+        }
+    }
+
+    if (full) {
+        rejected_++;
+        Ack ack;
+        ack.error = "Too many presses queued";
+        press.done(ack);
+        return;
+    }
+    send(device_id, resolved.value(), std::move(press));
+}
+
+void RemoteControlService::send(const std::string& device_id, const Device& device, Press press) {
+    auto started = Clock::now();
+    const LightningStep& key = *press.key;
+    sender_(device, key,
+        [this, device_id, started, press = std::move(press)](CommandResult result) {
+            auto now = Clock::now();
+            Ack ack;
+            ack.success = result.success;
+            if (result.error.has_value()) {
+                ack.error = result.error.value();
+            }
+            ack.timing = result.timing;
+            // Lane wait, plus the client queue wait if the sender reports one
+            ack.timing.queue_us = std::chrono::duration_cast<std::chrono::microseconds>(started - press.queued).count() +
+                                  std::max<int64_t>(0, result.timing.queue_us);
+            ack.total = std::chrono::duration_cast<std::chrono::microseconds>(now - press.queued);
+            sent_++;
+
+            Metrics::recordCommand(device_id, press.key->command, ack.success, ack.total);
+            DeviceSloTracker::getInstance().recordCommand(device_id, ack.success, ack.total);
+            EventBus::getInstance().commandResult(device_id, press.key->command, ack.success, ack.total, "ws");
+
+            press.done(ack);
+            finish(device_id);
+        });
+}
+
+void RemoteControlService::finish(const std::string& device_id) {
+    std::optional<Press> next;
+    std::optional<Device> device;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto lane = lanes_.find(device_id);
+        if (lane == lanes_.end()) {
+            return;
+        }
+        if (lane->second.waiting.empty()) {
+            lane->second.in_flight = false;
+            return;
+        }
+        next = std::move(lane->second.waiting.front());
+        lane->second.waiting.pop_front();
+        device = lane->second.device;
+    }
+
+    if (!device.has_value()) {
+        device = resolver_(device_id);   // Forgotten while presses waited
+        if (!device.has_value()) {
+            Ack ack;
+            ack.error = "Device not found";
+            rejected_++;
+            next->done(ack);
+            finish(device_id);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        lanes_[device_id].device = device;
+    }
+    send(device_id, device.value(), std::move(next.value()));
+}
+
+Json::Value RemoteControlService::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t queued = 0;
+    for (const auto& [device_id, lane] : lanes_) {
+        queued += lane.waiting.size();
+    }
+    Json::Value json;
+    json["devices"] = static_cast<Json::UInt64>(lanes_.size());
+    json["queued"] = static_cast<Json::UInt64>(queued);
+    json["sent"] = static_cast<Json::UInt64>(sent_.load());
+    json["rejected"] = static_cast<Json::UInt64>(rejected_.load());
+    return json;
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,213 @@
+#include "services/ServiceStatus.h"
+#include "utils/ConfigManager.h"
+#include <algorithm>
+
+namespace hms_firetv {
+
+ServiceStatus& ServiceStatus::getInstance() {
+    static ServiceStatus instance(
+        std::chrono::milliseconds(std::max(0, ConfigManager::getEnvInt("STATUS_CACHE_MS", 1000))));
+    return instance;
+}
+
+ServiceStatus::ServiceStatus(std::chrono::milliseconds details_max_age)
+    : details_max_age_(details_max_age) {}
+
+void ServiceStatus::setInfo(Info info) {
+    std::lock_guard<std::mutex> lock(build_mutex_);
+    info_ = std::move(info);
+    changed();
+}
+
+void ServiceStatus::setDetailsProvider(DetailsProvider provider) {
+    std::lock_guard<std::mutex> lock(build_mutex_);
+    details_ = std::move(provider);
+    changed();
+}
+
+// ============================================================================
+// FLAGS
+// ============================================================================
+
+void ServiceStatus::setReady(bool ready) {
+    if (ready_.exchange(ready, std::memory_order_relaxed) != ready) {
+        changed();
+    }
+}
+
+void ServiceStatus::setDatabaseConnected(bool connected) {
+    if (database_.exchange(connected, std::memory_order_relaxed) != connected) {
+        changed();
+    }
+}
+
+void ServiceStatus::setMqttConnected(bool connected) {
+    if (mqtt_.exchange(connected, std::memory_order_relaxed) != connected) {
+        changed();
+    }
+}
+
+bool ServiceStatus::passes(Probe probe) const {
+    switch (probe) {
+        case Probe::Live:   return true;
+        case Probe::Ready:  return ready() && databaseConnected();
+        case Probe::Health: return databaseConnected() && mqttConnected();
+    }
+    return false;
+}
+
+// ============================================================================
+// DEVICES
+// ============================================================================
+
+void ServiceStatus::resetDevices(const std::vector<Device>& devices) {
+    std::lock_guard<std::mutex> lock(devices_mutex_);
+    devices_.clear();
+    uint64_t paired = 0;
+    uint64_t online = 0;
+    for (const auto& device : devices) {
+        devices_[device.device_id] = {device.isPaired(), device.isOnline()};
+        paired += device.isPaired() ? 1 : 0;
+        online += device.isOnline() ? 1 : 0;
+    }
+    total_.store(devices_.size(), std::memory_order_relaxed);
+    paired_.store(paired, std::memory_order_relaxed);
+    online_.store(online, std::memory_order_relaxed);
+    changed();
+}
+
+void ServiceStatus::deviceChanged(const std::string& device_id, std::optional<bool> paired,
+                                  std::optional<bool> online) {
+    std::lock_guard<std::mutex> lock(devices_mutex_);
+    auto [it, inserted] = devices_.try_emplace(device_id);
+    DeviceState& state = it->second;
+    bool differs = inserted;
+    if (inserted) {
+        total_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (paired.has_value() && paired.value() != state.paired) {
+        state.paired = paired.value();
+        paired_.fetch_add(state.paired ? 1 : -1, std::memory_order_relaxed);
+        differs = true;
+    }
+    if (online.has_value() && online.value() != state.online) {
+        state.online = online.value();
+        online_.fetch_add(state.online ? 1 : -1, std::memory_order_relaxed);
+        differs = true;
+    }
+    // updateLastSeen calls this on every command; the body only changes with the counts
+    if (differs) {
+        changed();
+    }
+}
+
+void ServiceStatus::deviceRemoved(const std::string& device_id) {
+    std::lock_guard<std::mutex> lock(devices_mutex_);
+    auto it = devices_.find(device_id);
+    if (it == devices_.end()) {
+        return;
+    }
+    total_.fetch_sub(1, std::memory_order_relaxed);
+    if (it->second.paired) paired_.fetch_sub(1, std::memory_order_relaxed);
+    if (it->second.online) online_.fetch_sub(1, std::memory_order_relaxed);
+    devices_.erase(it);
+    changed();
+}
+
+ServiceStatus::DeviceCounts ServiceStatus::devices() const {
+    DeviceCounts counts;
+    counts.total = total_.load(std::memory_order_relaxed);
+    counts.paired = paired_.load(std::memory_order_relaxed);
+    counts.online = online_.load(std::memory_order_relaxed);
+    return counts;
+}
+
+// ============================================================================
+// BODIES
+// ============================================================================
+
+ServiceStatus::Body ServiceStatus::statusBody() {
+    auto cached = std::atomic_load(&status_cache_);
+    if (cached && cached->version == version() && Clock::now() - cached->built < details_max_age_) {
+        return cached->body;
+    }
+
+    std::lock_guard<std::mutex> lock(build_mutex_);
+    uint64_t current = version();
+    auto now = Clock::now();
+    cached = std::atomic_load(&status_cache_);
+    if (cached && cached->version == current && now - cached->built < details_max_age_) {
+        return cached->body;   // Another thread just rebuilt it
+    }
+
+    Json::Value json = baseJson();
+    json["status"] = "running";
+    json["connections"]["database"] = databaseConnected() ? "connected" : "disconnected";
+    json["connections"]["mqtt"] = mqttConnected() ? "connected" : "disconnected";
+    json["config"]["db_type"] = info_.db_type;
+    json["config"]["mqtt_broker"] = info_.mqtt_broker;
+    auto counts = devices();
+    json["devices"]["total"] = static_cast<Json::UInt64>(counts.total);
+    json["devices"]["paired"] = static_cast<Json::UInt64>(counts.paired);
+    json["devices"]["online"] = static_cast<Json::UInt64>(counts.online);
+    if (details_) {
+        details_(json);
+    }
+
+    auto fresh = std::make_shared<const Cached>(Cached{current, now, render(json)});
+    std::atomic_store(&status_cache_, fresh);
+    return fresh->body;
+}
+
+ServiceStatus::Body ServiceStatus::probeBody(Probe probe) {
+    auto& slot = probe_cache_[static_cast<int>(probe)];
+    auto cached = std::atomic_load(&slot);
+    if (cached && cached->version == version()) {
+        return cached->body;
+    }
+
+    std::lock_guard<std::mutex> lock(build_mutex_);
+    uint64_t current = version();
+    cached = std::atomic_load(&slot);
+    if (cached && cached->version == current) {
+        return cached->body;
+    }
+
+    Json::Value json = baseJson();
+    bool db_ok = databaseConnected();
+    switch (probe) {
+        case Probe::Live:
+            json["status"] = "alive";
+            break;
+        case Probe::Ready:
+            json["status"] = passes(Probe::Ready) ? "ready" : "not_ready";
+            json["started"] = ready();
+            json["database"] = db_ok ? "connected" : "disconnected";
+            break;
+        case Probe::Health:
+            json["db_type"] = info_.db_type;
+            json["database"] = db_ok ? "connected" : "disconnected";
+            json["mqtt"] = mqttConnected() ? "connected" : "disconnected";
+            json["status"] = passes(Probe::Health) ? "healthy" : "degraded";
+            break;
+    }
+
+    auto fresh = std::make_shared<const Cached>(Cached{current, Clock::now(), render(json)});
+    std::atomic_store(&slot, fresh);
+    return fresh->body;
+}
+
+Json::Value ServiceStatus::baseJson() const {
+    Json::Value json;
+    json["service"] = info_.service;
+    json["version"] = info_.version;
+    return json;
+}
+
+ServiceStatus::Body ServiceStatus::render(const Json::Value& json) {
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return std::make_shared<const std::string>(Json::writeString(writer, json));
+}
+
+} // namespace hms_firetv
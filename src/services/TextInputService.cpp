@@ -0,0 +1,271 @@
+#include "services/TextInputService.h"
+#include "clients/LightningStep.h"
+#include "services/MacroRunner.h"
+#include "utils/ConfigManager.h"
+#include "utils/Deadline.h"
+#include "utils/Logger.h"
+#include <algorithm>
+
+namespace hms_firetv {
+
+namespace {
+
+/**
+ * Default sender: a one-step sequence on MacroRunner, so the text goes
+ * through the device's lease queue over its pooled keep-alive connection
+ */
+void sendTextStep(const std::string& device_id, const std::string& text,
+                  TextInputService::SendCallback done) {
+    Json::Value step;
+    step["command"] = "text";
+    step["text"] = text;
+    Json::Value steps(Json::arrayValue);
+    steps.append(step);
+
+    std::string error;
+    auto sequence = compileSequence(steps, error);
+    if (!sequence) {
+        done(false, error);
+        return;
+    }
+
+    MacroRunner::getInstance().runAsync(device_id, std::move(sequence), true,
+        Deadline::after(Deadline::defaultBudget()),
+        [done = std::move(done)](SequenceResult result) {
+        std::string message = result.error.value_or("");
+        if (message.empty() && !result.steps.empty()) {
+            message = result.steps.front().error.value_or("");
+        }
+        done(result.success, message);
+    });
+}
+
+} // namespace
+
+// ============================================================================
+// DIFF
+// ============================================================================
+
+TextEdit TextEdit::diff(const std::string& from, const std::string& to) {
+    TextEdit edit;
+    if (from == to) {
+        edit.kind = Kind::Unchanged;
+    } else if (to.size() > from.size() && to.compare(0, from.size(), from) == 0) {
+        edit.kind = Kind::Append;
+        edit.count = to.size() - from.size();
+    } else if (to.size() < from.size() && from.compare(0, to.size(), to) == 0) {
+        edit.kind = Kind::Backspace;
+        edit.count = from.size() - to.size();
+    }
+    return edit;
+}
+
+const char* TextEdit::kindName(Kind kind) {
+    switch (kind) {
+        case Kind::Unchanged: return "unchanged";
+        case Kind::Append:    return "append";
+        case Kind::Backspace: return "backspace";
+        case Kind::Replace:   return "replace";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// SERVICE
+// ============================================================================
+
+TextInputService& TextInputService::getInstance() {
+    static TextInputService instance(sendTextStep, [] {
+        Options options;
+        options.debounce = std::chrono::milliseconds(std::max(0,
+            ConfigManager::getEnvInt("TEXT_INPUT_DEBOUNCE_MS", 150)));
+        return options;
+    }());
+    return instance;
+}
+
+TextInputService::TextInputService(Sender sender, Options options)
+    : sender_(std::move(sender)), options_(options) {
+    flusher_ = std::thread(&TextInputService::flushLoop, this);
+}
+
+TextInputService::~TextInputService() {
+    stop();
+}
+
+TextInputService::Submission TextInputService::submit(const std::string& device_id,
+                                                      const std::string& text) {
+    Submission submission;
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    auto it = sessions_.find(device_id);
+
+    // Long idle: the field on the TV may have changed, start over
+    if (it != sessions_.end() && !it->second.in_flight && !it->second.scheduled &&
+        now - it->second.last_activity > options_.session_idle) {
+        sessions_.erase(it);
+        it = sessions_.end();
+    }
+
+    if (it == sessions_.end()) {
+        it = sessions_.emplace(device_id, Session()).first;
+        submission.edit.kind = TextEdit::Kind::Replace;
+    } else {
+        submission.edit = TextEdit::diff(it->second.submitted, text);
+    }
+
+    auto& session = it->second;
+    submission.coalesced = session.dirty;
+    if (submission.coalesced) {
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    session.submitted = text;
+    session.dirty = true;
+    session.last_activity = now;
+
+    if (!session.scheduled && !session.in_flight) {
+        scheduleFlush(device_id, session, now + options_.debounce);
+    }
+    return submission;
+}
+
+void TextInputService::reset(const std::string& device_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(device_id);
+    if (it == sessions_.end()) {
+        return;
+    }
+    if (it->second.in_flight || it->second.scheduled) {
+        it->second.sent.reset();  // Still sending; just forget what the TV has
+    } else {
+        sessions_.erase(it);
+    }
+}
+
+Json::Value TextInputService::stats() const {
+    Json::Value json;
+    json["debounce_ms"] = static_cast<Json::Int64>(options_.debounce.count());
+    json["submitted"] = static_cast<Json::UInt64>(submitted_.load(std::memory_order_relaxed));
+    json["sent"] = static_cast<Json::UInt64>(sent_.load(std::memory_order_relaxed));
+    json["coalesced"] = static_cast<Json::UInt64>(coalesced_.load(std::memory_order_relaxed));
+    json["skipped"] = static_cast<Json::UInt64>(skipped_.load(std::memory_order_relaxed));
+    json["failed"] = static_cast<Json::UInt64>(failed_.load(std::memory_order_relaxed));
+    return json;
+}
+
+void TextInputService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            return;
+        }
+        stopped_ = true;
+        due_.clear();
+    }
+    cv_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+}
+
+void TextInputService::scheduleFlush(const std::string& device_id, Session& session,
+                                     Clock::time_point at) {
+    if (stopped_) {
+        return;
+    }
+    session.scheduled = true;
+    bool earliest = due_.empty() || at < due_.begin()->first;
+    due_.emplace(at, device_id);
+    if (earliest) {
+        cv_.notify_one();
+    }
+}
+
+void TextInputService::flush(const std::string& device_id) {
+    std::string text;
+    TextEdit edit;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(device_id);
+        if (it == sessions_.end()) {
+            return;
+        }
+        auto& session = it->second;
+        session.scheduled = false;
+        if (!session.dirty || session.in_flight) {
+            return;
+        }
+
+        session.dirty = false;
+        if (session.sent && *session.sent == session.submitted) {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            return;  // Typed and erased within the window: TV already shows it
+        }
+
+        text = session.submitted;
+        edit = session.sent ? TextEdit::diff(*session.sent, text) : TextEdit();
+        session.in_flight = true;
+    }
+
+    LOG_DEBUG("TextInputService").field("device", device_id).field("edit", TextEdit::kindName(edit.kind))
+        .field("count", edit.count) << "Sending " << text.size() << " chars";
+
+    sender_(device_id, text, [this, device_id, text](bool success, const std::string& error) {
+        onSent(device_id, text, success, error);
+    });
+}
+
+void TextInputService::onSent(const std::string& device_id, const std::string& text,
+                              bool success, const std::string& error) {
+    if (success) {
+        sent_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR("TextInputService") << "Text input failed for " << device_id
+                                      << (error.empty() ? "" : ": " + error);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(device_id);
+    if (it == sessions_.end()) {
+        return;
+    }
+    auto& session = it->second;
+    session.in_flight = false;
+    if (success) {
+        session.sent = text;
+    } else {
+        session.sent.reset();  // Unknown field state; next send goes out regardless
+    }
+
+    // Typed while in flight: send the latest value, one window after this send
+    if (session.dirty && !session.scheduled) {
+        scheduleFlush(device_id, session, Clock::now() + options_.debounce);
+    }
+}
+
+void TextInputService::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        if (due_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        auto at = due_.begin()->first;
+        if (Clock::now() < at) {
+            cv_.wait_until(lock, at);
+            continue;
+        }
+        std::string device_id = std::move(due_.begin()->second);
+        due_.erase(due_.begin());
+
+        lock.unlock();
+        flush(device_id);
+        lock.lock();
+    }
+}
+
+} // namespace hms_firetv
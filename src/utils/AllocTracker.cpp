@@ -0,0 +1,237 @@
+#include "utils/AllocTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace hms_firetv {
+
+// ============================================================================
+// COUNTING ALLOCATOR
+// ============================================================================
+
+#ifdef HMS_ALLOC_TRACKING
+
+namespace {
+
+// Trivial types only: these are touched from operator new, including during
+// thread startup and teardown
+thread_local uint64_t t_allocations = 0;
+thread_local uint64_t t_bytes = 0;
+thread_local uint64_t t_frees = 0;
+
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_bytes{0};
+std::atomic<uint64_t> g_frees{0};
+
+inline void countAlloc(std::size_t size) {
+    t_allocations++;
+    t_bytes += size;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+inline void countFree(void* ptr) {
+    if (ptr) {
+        t_frees++;
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void* allocate(std::size_t size) {
+    countAlloc(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t align) {
+    countAlloc(size);
+    std::size_t alignment = static_cast<std::size_t>(align);
+    // aligned_alloc wants a multiple of the alignment
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded);
+}
+
+} // namespace
+
+#endif // HMS_ALLOC_TRACKING
+
+// ============================================================================
+// TRACKER
+// ============================================================================
+
+AllocTracker& AllocTracker::getInstance() {
+    static AllocTracker instance;
+    return instance;
+}
+
+AllocTracker::Counts AllocTracker::threadCounts() {
+#ifdef HMS_ALLOC_TRACKING
+    return {t_allocations, t_bytes, t_frees};
+#else
+    return {};
+#endif
+}
+
+AllocTracker::Counts AllocTracker::processCounts() {
+#ifdef HMS_ALLOC_TRACKING
+    return {g_allocations.load(std::memory_order_relaxed),
+            g_bytes.load(std::memory_order_relaxed),
+            g_frees.load(std::memory_order_relaxed)};
+#else
+    return {};
+#endif
+}
+
+void AllocTracker::record(std::string_view type, const Counts& counts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = types_.find(type);
+    if (it == types_.end()) {
+        if (types_.size() >= MAX_TYPES) {
+            type = "other";
+        }
+        it = types_.emplace(std::string(type), TypeStats{}).first;
+    }
+    TypeStats& stats = it->second;
+    stats.requests++;
+    stats.allocations += counts.allocations;
+    stats.bytes += counts.bytes;
+    stats.max_allocations = std::max(stats.max_allocations, counts.allocations);
+}
+
+Json::Value AllocTracker::toJson() const {
+    Json::Value json;
+    json["enabled"] = enabled();
+
+    Counts process = processCounts();
+    json["process"]["allocations"] = static_cast<Json::UInt64>(process.allocations);
+    json["process"]["bytes"] = static_cast<Json::UInt64>(process.bytes);
+    json["process"]["frees"] = static_cast<Json::UInt64>(process.frees);
+
+    json["types"] = Json::objectValue;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [type, stats] : types_) {
+            Json::Value entry;
+            entry["requests"] = static_cast<Json::UInt64>(stats.requests);
+            entry["allocations"] = static_cast<Json::UInt64>(stats.allocations);
+            entry["bytes"] = static_cast<Json::UInt64>(stats.bytes);
+            entry["allocations_per_request"] = stats.requests
+                ? static_cast<double>(stats.allocations) / static_cast<double>(stats.requests) : 0.0;
+            entry["bytes_per_request"] = stats.requests
+                ? static_cast<double>(stats.bytes) / static_cast<double>(stats.requests) : 0.0;
+            entry["max_allocations"] = static_cast<Json::UInt64>(stats.max_allocations);
+            json["types"][type] = entry;
+        }
+    }
+
+    // What malloc itself holds, tracked or not
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 info = ::mallinfo2();
+    json["heap"]["arena_bytes"] = static_cast<Json::UInt64>(info.arena);
+    json["heap"]["mmapped_bytes"] = static_cast<Json::UInt64>(info.hblkhd);
+    json["heap"]["in_use_bytes"] = static_cast<Json::UInt64>(info.uordblks);
+    json["heap"]["free_bytes"] = static_cast<Json::UInt64>(info.fordblks);
+    json["heap"]["releasable_bytes"] = static_cast<Json::UInt64>(info.keepcost);
+#endif
+    return json;
+}
+
+void AllocTracker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    types_.clear();
+}
+
+// ============================================================================
+// SCOPE
+// ============================================================================
+
+#ifdef HMS_ALLOC_TRACKING
+
+AllocScope::AllocScope(std::string_view type) : start_(AllocTracker::threadCounts()) {
+    setType(type);
+}
+
+AllocScope::~AllocScope() {
+    AllocTracker::getInstance().record(type_, counts());
+}
+
+void AllocScope::setType(std::string_view source, std::string_view detail) {
+    // Fixed buffer: naming the scope must not allocate inside it
+    size_t length = std::min(source.size(), sizeof(type_) - 1);
+    std::memcpy(type_, source.data(), length);
+    if (!detail.empty() && length + 1 < sizeof(type_) - 1) {
+        type_[length++] = '.';
+        size_t detail_length = std::min(detail.size(), sizeof(type_) - 1 - length);
+        std::memcpy(type_ + length, detail.data(), detail_length);
+        length += detail_length;
+    }
+    type_[length] = '\0';
+}
+
+AllocTracker::Counts AllocScope::counts() const {
+    AllocTracker::Counts now = AllocTracker::threadCounts();
+    return {now.allocations - start_.allocations, now.bytes - start_.bytes, now.frees - start_.frees};
+}
+
+#endif // HMS_ALLOC_TRACKING
+
+} // namespace hms_firetv
+
+// ============================================================================
+// GLOBAL OPERATOR NEW / DELETE
+// ============================================================================
+
+#ifdef HMS_ALLOC_TRACKING
+
+using hms_firetv::allocate;
+using hms_firetv::allocateAligned;
+using hms_firetv::countFree;
+
+void* operator new(std::size_t size) {
+    if (void* ptr = allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    if (void* ptr = allocateAligned(size, align)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    if (void* ptr = allocateAligned(size, align)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+
+void operator delete(void* ptr) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete[](void* ptr) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { countFree(ptr); std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { countFree(ptr); std::free(ptr); }
+
+#endif // HMS_ALLOC_TRACKING
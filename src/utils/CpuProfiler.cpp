@@ -0,0 +1,304 @@
+#include "utils/CpuProfiler.h"
+#include "utils/ConfigManager.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fstream>
+#include <memory>
+#include <signal.h>
+#include <sstream>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv {
+
+// ============================================================================
+// SAMPLE BUFFER (shared with the signal handler)
+// ============================================================================
+
+namespace {
+
+struct Sample {
+    std::atomic<bool> ready{false};
+    pid_t tid = 0;
+    int depth = 0;
+    void* frames[CpuProfiler::MAX_DEPTH];
+};
+
+struct Buffer {
+    explicit Buffer(size_t capacity) : samples(new Sample[capacity]), capacity(capacity) {}
+
+    std::unique_ptr<Sample[]> samples;
+    const size_t capacity;
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+std::atomic<Buffer*> g_buffer{nullptr};
+std::atomic<int> g_in_handler{0};
+
+// Frames of the handler itself and the kernel's signal trampoline
+constexpr int HANDLER_FRAMES = 2;
+
+std::string threadName(pid_t tid) {
+    std::ifstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+    std::string name;
+    if (std::getline(comm, name) && !name.empty()) {
+        return name;
+    }
+    return "thread-" + std::to_string(tid);   // Exited since
+}
+
+std::string symbolize(void* address) {
+    Dl_info info;
+    if (dladdr(address, &info) == 0) {
+        std::ostringstream out;
+        out << address;
+        return out.str();
+    }
+    if (info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+    }
+
+    // No exported symbol (static function, stripped library): module+offset for addr2line
+    const char* module = info.dli_fname ? std::strrchr(info.dli_fname, '/') : nullptr;
+    std::ostringstream out;
+    out << (module ? module + 1 : (info.dli_fname ? info.dli_fname : "?")) << "+0x" << std::hex
+        << (reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    return out.str();
+}
+
+// Folded-stack frames may not contain the separators
+std::string sanitize(std::string frame) {
+    std::replace(frame.begin(), frame.end(), ';', ':');
+    std::replace(frame.begin(), frame.end(), ' ', '_');
+    return frame;
+}
+
+void onSignal(int) {
+    int saved_errno = errno;
+    g_in_handler.fetch_add(1, std::memory_order_acquire);
+
+    Buffer* buffer = g_buffer.load(std::memory_order_acquire);
+    if (buffer) {
+        size_t slot = buffer->next.fetch_add(1, std::memory_order_relaxed);
+        if (slot < buffer->capacity) {
+            Sample& sample = buffer->samples[slot];
+            sample.tid = static_cast<pid_t>(::syscall(SYS_gettid));
+            sample.depth = ::backtrace(sample.frames, CpuProfiler::MAX_DEPTH);
+            sample.ready.store(true, std::memory_order_release);
+        } else {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    g_in_handler.fetch_sub(1, std::memory_order_release);
+    errno = saved_errno;
+}
+
+CpuProfiler::Profile collect(const Buffer& buffer, std::chrono::milliseconds duration, int hz) {
+    CpuProfiler::Profile profile;
+    profile.duration = duration;
+    profile.hz = hz;
+    profile.dropped = buffer.dropped.load(std::memory_order_relaxed);
+
+    std::unordered_map<void*, std::string> symbols;
+    std::unordered_map<pid_t, std::string> threads;
+    size_t count = std::min(buffer.next.load(std::memory_order_relaxed), buffer.capacity);
+
+    for (size_t i = 0; i < count; i++) {
+        const Sample& sample = buffer.samples[i];
+        if (!sample.ready.load(std::memory_order_acquire) || sample.depth <= HANDLER_FRAMES) {
+            continue;
+        }
+
+        auto thread = threads.find(sample.tid);
+        if (thread == threads.end()) {
+            thread = threads.emplace(sample.tid, sanitize(threadName(sample.tid))).first;
+        }
+
+        // Root first; return addresses point past the call, so look up the byte before
+        std::string stack = thread->second;
+        for (int f = sample.depth - 1; f >= HANDLER_FRAMES; f--) {
+            void* address = sample.frames[f];
+            void* lookup = f == HANDLER_FRAMES ? address : static_cast<char*>(address) - 1;
+            auto symbol = symbols.find(lookup);
+            if (symbol == symbols.end()) {
+                symbol = symbols.emplace(lookup, sanitize(symbolize(lookup))).first;
+            }
+            stack += ';';
+            stack += symbol->second;
+        }
+        profile.stacks[stack]++;
+        profile.samples++;
+    }
+    return profile;
+}
+
+} // namespace
+
+// ============================================================================
+// PROFILER
+// ============================================================================
+
+CpuProfiler& CpuProfiler::getInstance() {
+    static CpuProfiler instance([] {
+        Options options;
+        options.enabled = ConfigManager::getEnvBool("PROFILER_ENABLED", false);
+        options.max_duration = std::chrono::seconds(std::max(1, ConfigManager::getEnvInt("PROFILER_MAX_SECONDS", 60)));
+        return options;
+    }());
+    return instance;
+}
+
+CpuProfiler::CpuProfiler(Options options) : options_(options) {}
+
+CpuProfiler::~CpuProfiler() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool CpuProfiler::start(std::chrono::milliseconds duration, int hz, Done done, std::string& error) {
+    if (!options_.enabled) {
+        error = "Profiler disabled (set PROFILER_ENABLED=true)";
+        return false;
+    }
+    if (duration.count() <= 0 || duration > options_.max_duration) {
+        error = "Duration must be between 1ms and " + std::to_string(options_.max_duration.count()) + "s";
+        return false;
+    }
+    if (hz < 1 || hz > options_.max_hz) {
+        error = "hz must be between 1 and " + std::to_string(options_.max_hz);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_.load(std::memory_order_acquire)) {
+        error = "A profile is already running";
+        return false;
+    }
+    if (worker_.joinable()) {
+        worker_.join();   // Previous profile, already finished
+    }
+
+    // hz samples per CPU-second: one busy core fills hz per second, each
+    // further busy core as much again
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    double expected = static_cast<double>(hz) * std::chrono::duration<double>(duration).count() * cores;
+    size_t capacity = std::min(options_.max_samples, static_cast<size_t>(expected) + 16);
+    auto buffer = std::make_shared<Buffer>(capacity);
+
+    // backtrace() loads libgcc's unwinder on first use; never from the handler
+    void* warmup[1];
+    ::backtrace(warmup, 1);
+
+    // Installed once and left in place: a SIGPROF still pending after the
+    // timer stops must not hit the default action (terminate)
+    static std::once_flag install_flag;
+    std::call_once(install_flag, [] {
+        struct sigaction action {};
+        action.sa_handler = &onSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, nullptr);
+    });
+
+    running_.store(true, std::memory_order_release);
+    g_buffer.store(buffer.get(), std::memory_order_release);
+
+    struct itimerval timer {};
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = std::max(1, 1000000 / hz);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        g_buffer.store(nullptr, std::memory_order_release);
+        running_.store(false, std::memory_order_release);
+        error = std::string("setitimer failed: ") + std::strerror(errno);
+        return false;
+    }
+    LOG_INFO("CpuProfiler") << "Profiling for " << duration.count() << "ms at " << hz << "Hz";
+
+    worker_ = std::thread([this, buffer, duration, hz, done = std::move(done)]() {
+        auto started = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(duration);
+
+        struct itimerval off {};
+        setitimer(ITIMER_PROF, &off, nullptr);
+        g_buffer.store(nullptr, std::memory_order_release);
+        while (g_in_handler.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started);
+        Profile profile = collect(*buffer, elapsed, hz);
+        running_.store(false, std::memory_order_release);
+        LOG_INFO("CpuProfiler") << "Profile done: " << profile.samples << " samples, "
+                                << profile.stacks.size() << " stacks, " << profile.dropped << " dropped";
+        done(std::move(profile));
+    });
+    return true;
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+std::string CpuProfiler::Profile::folded() const {
+    std::string out;
+    for (const auto& [stack, samples] : stacks) {
+        out += stack;
+        out += ' ';
+        out += std::to_string(samples);
+        out += '\n';
+    }
+    return out;
+}
+
+Json::Value CpuProfiler::Profile::toJson(size_t top_functions) const {
+    Json::Value json;
+    json["duration_ms"] = static_cast<Json::Int64>(duration.count());
+    json["hz"] = hz;
+    json["samples"] = static_cast<Json::UInt64>(samples);
+    json["dropped"] = static_cast<Json::UInt64>(dropped);
+
+    // Self samples per leaf function
+    std::map<std::string, uint64_t> self;
+    json["stacks"] = Json::arrayValue;
+    for (const auto& [stack, count] : stacks) {
+        Json::Value entry;
+        entry["stack"] = stack;
+        entry["samples"] = static_cast<Json::UInt64>(count);
+        json["stacks"].append(entry);
+
+        size_t leaf = stack.rfind(';');
+        self[leaf == std::string::npos ? stack : stack.substr(leaf + 1)] += count;
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> ranked(self.begin(), self.end());
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    json["top"] = Json::arrayValue;
+    for (size_t i = 0; i < ranked.size() && i < top_functions; i++) {
+        Json::Value entry;
+        entry["function"] = ranked[i].first;
+        entry["self_samples"] = static_cast<Json::UInt64>(ranked[i].second);
+        entry["self_percent"] = samples ? 100.0 * static_cast<double>(ranked[i].second) / static_cast<double>(samples) : 0.0;
+        json["top"].append(entry);
+    }
+    return json;
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,428 @@
+#include "utils/Logger.h"
+#include "utils/ConfigManager.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace hms_firetv {
+
+namespace {
+
+constexpr char FIELD_SEPARATOR = '\x1f';
+constexpr char PAIR_SEPARATOR = '\x1e';
+constexpr size_t BATCH_BYTES = 64 * 1024;
+
+uint32_t currentThreadNumber() {
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+size_t roundUpToPowerOfTwo(size_t n) {
+    size_t size = 2;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+void appendJsonEscaped(std::string& out, const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+}
+
+// Messages carried over from std::cout sometimes end in '\n' already
+size_t trimmedLength(const LogRecord& record) {
+    size_t len = record.message_len;
+    while (len > 0 && (record.message[len - 1] == '\n' || record.message[len - 1] == '\r')) {
+        len--;
+    }
+    return len;
+}
+
+void appendTimestamp(std::string& out, int64_t time_us) {
+    time_t seconds = static_cast<time_t>(time_us / 1000000);
+    struct tm tm_utc;
+    gmtime_r(&seconds, &tm_utc);
+    char buf[40];
+    size_t n = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm_utc);
+    std::snprintf(buf + n, sizeof(buf) - n, ".%03dZ", static_cast<int>((time_us / 1000) % 1000));
+    out += buf;
+}
+
+} // namespace
+
+// ============================================================================
+// LOGGER
+// ============================================================================
+
+Logger& Logger::getInstance() {
+    static Logger instance(Options(), [](bool is_error, const std::string& batch) {
+        FILE* stream = is_error ? stderr : stdout;
+        std::fwrite(batch.data(), 1, batch.size(), stream);
+        std::fflush(stream);
+    });
+    return instance;
+}
+
+Logger::Logger(Options options, Sink sink)
+    : sink_(std::move(sink)), options_(options) {
+    size_t capacity = roundUpToPowerOfTwo(std::max<size_t>(options_.capacity, 2));
+    cells_.reset(new Cell[capacity]);
+    for (size_t i = 0; i < capacity; i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask_ = capacity - 1;
+}
+
+Logger::~Logger() {
+    stop();
+}
+
+void Logger::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_.load() || writer_.joinable()) {
+        return;
+    }
+    running_ = true;
+    writer_ = std::thread(&Logger::writerLoop, this);
+}
+
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    wake_cv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void Logger::flush() {
+    if (!running_.load()) {
+        return;
+    }
+    uint64_t target = queued_.load(std::memory_order_acquire);
+    wake_cv_.notify_one();
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_cv_.wait_for(lock, std::chrono::seconds(5), [&] {
+        return processed_.load(std::memory_order_acquire) >= target || !running_.load();
+    });
+}
+
+void Logger::submit(const LogRecord& record) {
+    if (!running_.load(std::memory_order_acquire)) {
+        writeNow(record);
+        return;
+    }
+    if (!tryPush(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+
+    // The writer polls every flush_interval anyway; only nudge it when it sleeps
+    if (writer_idle_.load(std::memory_order_relaxed)) {
+        wake_cv_.notify_one();
+    }
+}
+
+bool Logger::tryPush(const LogRecord& record) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Copy only the used part of the buffers
+    LogRecord& slot = cell->record;
+    slot.level = record.level;
+    slot.component = record.component;
+    slot.time_us = record.time_us;
+    slot.thread = record.thread;
+    slot.message_len = record.message_len;
+    slot.fields_len = record.fields_len;
+    slot.truncated = record.truncated;
+    std::memcpy(slot.message, record.message, record.message_len);
+    std::memcpy(slot.fields, record.fields, record.fields_len);
+
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool Logger::tryPop(LogRecord& record) {
+    Cell* cell = &cells_[dequeue_pos_ & mask_];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (sequence != dequeue_pos_ + 1) {
+        return false;  // Empty (or the producer is still copying)
+    }
+
+    const LogRecord& slot = cell->record;
+    record.level = slot.level;
+    record.component = slot.component;
+    record.time_us = slot.time_us;
+    record.thread = slot.thread;
+    record.message_len = slot.message_len;
+    record.fields_len = slot.fields_len;
+    record.truncated = slot.truncated;
+    std::memcpy(record.message, slot.message, slot.message_len);
+    std::memcpy(record.fields, slot.fields, slot.fields_len);
+
+    cell->sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+    dequeue_pos_++;
+    return true;
+}
+
+void Logger::writerLoop() {
+    std::string out_batch;
+    std::string err_batch;
+    out_batch.reserve(BATCH_BYTES);
+    err_batch.reserve(BATCH_BYTES / 4);
+    auto record = std::make_unique<LogRecord>();
+    uint64_t reported_drops = 0;
+    bool stopping = false;
+
+    auto emit = [&]() {
+        if (!out_batch.empty()) {
+            sink_(false, out_batch);
+            out_batch.clear();
+        }
+        if (!err_batch.empty()) {
+            sink_(true, err_batch);
+            err_batch.clear();
+        }
+    };
+
+    for (;;) {
+        uint64_t batch = 0;
+        while (tryPop(*record)) {
+            format(*record, record->level >= LogLevel::Warn ? err_batch : out_batch);
+            batch++;
+            if (out_batch.size() + err_batch.size() >= BATCH_BYTES) {
+                emit();
+            }
+        }
+
+        uint64_t drops = dropped_.load(std::memory_order_relaxed);
+        if (drops != reported_drops) {
+            LogRecord notice;
+            notice.level = LogLevel::Warn;
+            notice.component = "Logger";
+            notice.time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            int n = std::snprintf(notice.message, LogRecord::MESSAGE_SIZE,
+                                  "%llu log lines dropped (buffer full)",
+                                  static_cast<unsigned long long>(drops - reported_drops));
+            notice.message_len = static_cast<uint16_t>(std::max(0, n));
+            format(notice, err_batch);
+            reported_drops = drops;
+        }
+
+        if (batch > 0 || !err_batch.empty()) {
+            emit();
+            written_.fetch_add(batch, std::memory_order_relaxed);
+            processed_.fetch_add(batch, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(mutex_);
+            drained_cv_.notify_all();
+        }
+
+        if (stopping) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_.load()) {
+            stopping = true;  // One more pass for anything queued while stopping
+            continue;
+        }
+        writer_idle_.store(true, std::memory_order_relaxed);
+        wake_cv_.wait_for(lock, options_.flush_interval, [this] {
+            const Cell& next = cells_[dequeue_pos_ & mask_];
+            return !running_.load() || next.sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1;
+        });
+        writer_idle_.store(false, std::memory_order_relaxed);
+    }
+
+}
+
+void Logger::writeNow(const LogRecord& record) {
+    std::string line;
+    format(record, line);
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_(record.level >= LogLevel::Warn, line);
+    written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::format(const LogRecord& record, std::string& out) const {
+    if (format_.load(std::memory_order_relaxed) == Format::Json) {
+        out += "{\"ts\":\"";
+        appendTimestamp(out, record.time_us);
+        out += "\",\"level\":\"";
+        out += levelName(record.level);
+        out += "\",\"component\":\"";
+        appendJsonEscaped(out, record.component, std::strlen(record.component));
+        out += "\",\"thread\":";
+        out += std::to_string(record.thread);
+        out += ",\"msg\":\"";
+        appendJsonEscaped(out, record.message, trimmedLength(record));
+        if (record.truncated) {
+            out += "...";
+        }
+        out += '"';
+
+        const char* p = record.fields;
+        const char* end = record.fields + record.fields_len;
+        while (p < end) {
+            const char* sep = static_cast<const char*>(std::memchr(p, FIELD_SEPARATOR, end - p));
+            const char* stop = static_cast<const char*>(std::memchr(p, PAIR_SEPARATOR, end - p));
+            if (!sep || !stop || sep > stop) {
+                break;
+            }
+            out += ",\"";
+            appendJsonEscaped(out, p, sep - p);
+            out += "\":\"";
+            appendJsonEscaped(out, sep + 1, stop - sep - 1);
+            out += '"';
+            p = stop + 1;
+        }
+        out += "}\n";
+        return;
+    }
+
+    appendTimestamp(out, record.time_us);
+    out += ' ';
+    const char* level = levelName(record.level);
+    out += level;
+    out.append(6 - std::min<size_t>(5, std::strlen(level)), ' ');
+    out += '[';
+    out += record.component;
+    out += "] ";
+    out.append(record.message, trimmedLength(record));
+    if (record.truncated) {
+        out += "...";
+    }
+
+    const char* p = record.fields;
+    const char* end = record.fields + record.fields_len;
+    while (p < end) {
+        const char* sep = static_cast<const char*>(std::memchr(p, FIELD_SEPARATOR, end - p));
+        const char* stop = static_cast<const char*>(std::memchr(p, PAIR_SEPARATOR, end - p));
+        if (!sep || !stop || sep > stop) {
+            break;
+        }
+        out += ' ';
+        out.append(p, sep - p);
+        out += '=';
+        out.append(sep + 1, stop - sep - 1);
+        p = stop + 1;
+    }
+    out += '\n';
+}
+
+LogLevel Logger::parseLevel(std::string_view name, LogLevel fallback) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "trace") return LogLevel::Trace;
+    if (lower == "debug") return LogLevel::Debug;
+    if (lower == "info") return LogLevel::Info;
+    if (lower == "warn" || lower == "warning") return LogLevel::Warn;
+    if (lower == "error") return LogLevel::Error;
+    if (lower == "off" || lower == "none") return LogLevel::Off;
+    return fallback;
+}
+
+const char* Logger::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info:  return "INFO";
+        case LogLevel::Warn:  return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off:   return "OFF";
+    }
+    return "INFO";
+}
+
+void Logger::configureFromEnv() {
+    std::string level = ConfigManager::getEnv("LOG_LEVEL", "info");
+    LogLevel parsed = parseLevel(level, LogLevel::Info);
+    setLevel(parsed);
+    setFormat(ConfigManager::getEnv("LOG_FORMAT", "text") == "json" ? Format::Json : Format::Text);
+
+    if (static_cast<int>(parsed) < HMS_LOG_COMPILE_LEVEL) {
+        std::fprintf(stderr, "[Logger] LOG_LEVEL=%s is below the compiled-in level %s\n",
+                     level.c_str(), levelName(static_cast<LogLevel>(HMS_LOG_COMPILE_LEVEL)));
+    }
+}
+
+// ============================================================================
+// LOG LINE
+// ============================================================================
+
+LogLine::LogLine(Logger& logger, LogLevel level, const char* component)
+    : logger_(logger),
+      buffer_(record_.message, LogRecord::MESSAGE_SIZE),
+      stream_(&buffer_) {
+    record_.level = level;
+    record_.component = component;
+    record_.time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record_.thread = currentThreadNumber();
+}
+
+LogLine::~LogLine() {
+    record_.message_len = static_cast<uint16_t>(buffer_.size());
+    record_.truncated = record_.truncated || buffer_.overflowed();
+    logger_.submit(record_);
+}
+
+LogLine& LogLine::field(std::string_view key, std::string_view value) {
+    size_t needed = key.size() + value.size() + 2;
+    if (record_.fields_len + needed > LogRecord::FIELDS_SIZE) {
+        record_.truncated = true;
+        return *this;
+    }
+    char* p = record_.fields + record_.fields_len;
+    std::memcpy(p, key.data(), key.size());
+    p += key.size();
+    *p++ = FIELD_SEPARATOR;
+    std::memcpy(p, value.data(), value.size());
+    p += value.size();
+    *p++ = PAIR_SEPARATOR;
+    record_.fields_len = static_cast<uint16_t>(record_.fields_len + needed);
+    return *this;
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,323 @@
+#include "utils/Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace hms_firetv {
+
+// ============================================================================
+// HISTOGRAM
+// ============================================================================
+
+uint64_t MetricHistogram::percentileMicros(double q) const {
+    uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+        seen += bucketCount(bucket);
+        if (seen >= rank) {
+            return bucket + 1 < BUCKETS ? bucketLowerBound(bucket + 1) : bucketLowerBound(bucket) * 2;
+        }
+    }
+    return bucketLowerBound(BUCKETS - 1) * 2;  // Buckets raced ahead of count_
+}
+
+// ============================================================================
+// TEXT FORMAT
+// ============================================================================
+
+namespace metrics_detail {
+
+// Exported `le` edges are the powers of two from 2^7us (128us) to 2^26us (~67s);
+// the finer internal buckets are summed into them
+constexpr size_t EXPORT_MIN_POWER = 7;
+constexpr size_t EXPORT_MAX_POWER = 26;
+
+static void appendEscaped(std::string& out, const std::string& value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"':  out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default:   out += c;
+        }
+    }
+}
+
+void appendLabels(std::string& out, const std::string* names, const std::string* values, size_t n,
+                  const char* extra_name, const std::string& extra_value) {
+    if (n == 0 && !extra_name) {
+        return;
+    }
+    out += '{';
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) {
+            out += ',';
+        }
+        out += names[i];
+        out += "=\"";
+        appendEscaped(out, values[i]);
+        out += '"';
+    }
+    if (extra_name) {
+        if (n > 0) {
+            out += ',';
+        }
+        out += extra_name;
+        out += "=\"";
+        appendEscaped(out, extra_value);
+        out += '"';
+    }
+    out += '}';
+}
+
+void appendValue(std::string& out, double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", value);
+    out += buf;
+}
+
+void renderSeries(std::string& out, const std::string& name, const std::string* names,
+                  const std::string* values, size_t n, const MetricCounter& metric) {
+    out += name;
+    appendLabels(out, names, values, n);
+    out += ' ';
+    out += std::to_string(metric.value());
+    out += '\n';
+}
+
+void renderSeries(std::string& out, const std::string& name, const std::string* names,
+                  const std::string* values, size_t n, const MetricGauge& metric) {
+    out += name;
+    appendLabels(out, names, values, n);
+    out += ' ';
+    out += std::to_string(metric.value());
+    out += '\n';
+}
+
+void renderSeries(std::string& out, const std::string& name, const std::string* names,
+                  const std::string* values, size_t n, const MetricHistogram& metric) {
+    // Read the buckets first: count_ is bumped last, so it never runs behind them
+    uint64_t cumulative = 0;
+    size_t bucket = 0;
+    for (size_t power = EXPORT_MIN_POWER; power <= EXPORT_MAX_POWER; power++) {
+        // Buckets below 2^power end at index (power - 1) * SUB_BUCKETS
+        size_t end = (power - 1) * MetricHistogram::SUB_BUCKETS;
+        for (; bucket < end; bucket++) {
+            cumulative += metric.bucketCount(bucket);
+        }
+        std::string le;
+        appendValue(le, static_cast<double>(uint64_t(1) << power) / 1e6);
+        out += name + "_bucket";
+        appendLabels(out, names, values, n, "le", le);
+        out += ' ' + std::to_string(cumulative) + '\n';
+    }
+    for (; bucket < MetricHistogram::BUCKETS; bucket++) {
+        cumulative += metric.bucketCount(bucket);
+    }
+    uint64_t count = std::max(cumulative, metric.count());
+
+    out += name + "_bucket";
+    appendLabels(out, names, values, n, "le", "+Inf");
+    out += ' ' + std::to_string(count) + '\n';
+    out += name + "_sum";
+    appendLabels(out, names, values, n);
+    out += ' ';
+    appendValue(out, static_cast<double>(metric.sumMicros()) / 1e6);
+    out += '\n';
+    out += name + "_count";
+    appendLabels(out, names, values, n);
+    out += ' ' + std::to_string(count) + '\n';
+}
+
+const char* typeName(const MetricCounter&) { return "counter"; }
+const char* typeName(const MetricGauge&) { return "gauge"; }
+const char* typeName(const MetricHistogram&) { return "histogram"; }
+
+} // namespace metrics_detail
+
+// ============================================================================
+// REGISTRY
+// ============================================================================
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+void MetricsRegistry::addCollector(const std::string& name, const std::string& help,
+                                   const std::string& type, Collector collector) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : collectors_) {
+        if (entry.name == name) {
+            entry.collector = std::move(collector);  // Re-registration replaces
+            return;
+        }
+    }
+    collectors_.push_back({name, help, type, std::move(collector)});
+}
+
+std::string MetricsRegistry::render() const {
+    std::string out;
+    out.reserve(16 * 1024);
+
+    std::vector<CollectorEntry> collectors;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& family : families_) {
+            family->render(out);
+        }
+        collectors = collectors_;
+    }
+
+    // Collectors may take other locks; run them outside ours
+    for (const auto& entry : collectors) {
+        std::vector<Sample> samples;
+        try {
+            samples = entry.collector();
+        } catch (const std::exception&) {
+            continue;  // A failing source leaves its metric out of this scrape
+        }
+        out += "# HELP " + entry.name + " " + entry.help + "\n";
+        out += "# TYPE " + entry.name + " " + entry.type + "\n";
+        for (const auto& sample : samples) {
+            std::vector<std::string> names, values;
+            for (const auto& [label, value] : sample.labels) {
+                names.push_back(label);
+                values.push_back(value);
+            }
+            out += entry.name;
+            metrics_detail::appendLabels(out, names.data(), values.data(), names.size());
+            out += ' ';
+            metrics_detail::appendValue(out, sample.value);
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+// ============================================================================
+// SERVICE METRICS
+// ============================================================================
+
+namespace {
+
+MetricFamily<MetricHistogram, 2>& commandDuration() {
+    static auto& family = MetricsRegistry::getInstance().histogram<2>(
+        "firetv_command_duration_seconds", "Command latency from receipt to TV response",
+        {"device", "command"});
+    return family;
+}
+
+MetricFamily<MetricCounter, 3>& commandsTotal() {
+    static auto& family = MetricsRegistry::getInstance().counter<3>(
+        "firetv_commands_total", "Commands handled", {"device", "command", "result"});
+    return family;
+}
+
+MetricFamily<MetricCounter, 1>& wakeRequests() {
+    static auto& family = MetricsRegistry::getInstance().counter<1>(
+        "firetv_wake_requests_total", "Wake requests sent to TVs", {"result"});
+    return family;
+}
+
+MetricFamily<MetricCounter, 1>& mqttMessages() {
+    static auto& family = MetricsRegistry::getInstance().counter<1>(
+        "firetv_mqtt_messages_total", "MQTT messages received (in) and published (out)", {"direction"});
+    return family;
+}
+
+MetricFamily<MetricCounter, 1>& mqttBytes() {
+    static auto& family = MetricsRegistry::getInstance().counter<1>(
+        "firetv_mqtt_bytes_total", "MQTT payload bytes received (in) and published (out)", {"direction"});
+    return family;
+}
+
+MetricFamily<MetricHistogram, 1>& dbQueries() {
+    static auto& family = MetricsRegistry::getInstance().histogram<1>(
+        "firetv_db_query_duration_seconds", "Database query latency", {"op"});
+    return family;
+}
+
+MetricFamily<MetricCounter, 2>& cacheLookups() {
+    static auto& family = MetricsRegistry::getInstance().counter<2>(
+        "firetv_cache_lookups_total", "Cache lookups by outcome", {"cache", "result"});
+    return family;
+}
+
+/**
+ * Series one (device, command) pair records into
+ */
+struct CommandSeries {
+    MetricHistogram* duration;
+    MetricCounter* success;
+    MetricCounter* failure;
+};
+
+using CommandKey = std::pair<std::string, std::string>;
+using CommandView = std::pair<std::string_view, std::string_view>;
+
+// Compares owned keys with string_view lookups, so a hit never allocates
+struct CommandKeyLess {
+    using is_transparent = void;
+
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const {
+        return CommandView(a.first, a.second) < CommandView(b.first, b.second);
+    }
+};
+
+// Per-thread handles by (device, command): series live for the process, so
+// after a thread's first command for a pair, recording takes no lock
+const CommandSeries& commandSeries(std::string_view device_id, std::string_view command) {
+    thread_local std::map<CommandKey, CommandSeries, CommandKeyLess> handles;
+
+    auto it = handles.find(CommandView(device_id, command));
+    if (it == handles.end()) {
+        CommandSeries series{
+            &commandDuration().labels({device_id, command}),
+            &commandsTotal().labels({device_id, command, "success"}),
+            &commandsTotal().labels({device_id, command, "failure"})};
+        it = handles.emplace(CommandKey(device_id, command), series).first;
+    }
+    return it->second;
+}
+
+} // namespace
+
+void Metrics::recordCommand(std::string_view device_id, std::string_view command, bool success,
+                            std::chrono::microseconds elapsed) {
+    const CommandSeries& series = commandSeries(device_id, command);
+    series.duration->observe(elapsed);
+    (success ? series.success : series.failure)->inc();
+}
+
+void Metrics::recordWake(bool success) {
+    static MetricCounter& ok = wakeRequests().labels({"success"});
+    static MetricCounter& failed = wakeRequests().labels({"failure"});
+    (success ? ok : failed).inc();
+}
+
+void Metrics::recordMqttMessage(bool inbound, size_t bytes) {
+    static MetricCounter& in = mqttMessages().labels({"in"});
+    static MetricCounter& out = mqttMessages().labels({"out"});
+    static MetricCounter& in_bytes = mqttBytes().labels({"in"});
+    static MetricCounter& out_bytes = mqttBytes().labels({"out"});
+    (inbound ? in : out).inc();
+    (inbound ? in_bytes : out_bytes).inc(bytes);
+}
+
+void Metrics::recordCacheLookup(std::string_view cache, bool hit) {
+    cacheLookups().labels({cache, hit ? "hit" : "miss"}).inc();
+}
+
+MetricHistogram& Metrics::dbQuery(std::string_view op) {
+    return dbQueries().labels({op});
+}
+
+} // namespace hms_firetv
@@ -0,0 +1,80 @@
+#include "utils/ServerProfile.h"
+#include "utils/ConfigManager.h"
+#include <algorithm>
+#include <thread>
+
+namespace hms_firetv {
+
+namespace {
+
+size_t envSize(const char* key, size_t default_value) {
+    return static_cast<size_t>(std::max(0, ConfigManager::getEnvInt(key, static_cast<int>(default_value))));
+}
+
+} // namespace
+
+ServerProfile ServerProfile::fromEnv() {
+    ServerProfile profile;
+    profile.threads = envSize("THREAD_NUM", 0);
+    if (profile.threads == 0) {
+        profile.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    profile.reuse_port = ConfigManager::getEnvBool("HTTP_REUSE_PORT", profile.reuse_port);
+    profile.tcp_nodelay = ConfigManager::getEnvBool("HTTP_TCP_NODELAY", profile.tcp_nodelay);
+    profile.idle_timeout_seconds = envSize("IDLE_CONNECTION_TIMEOUT", profile.idle_timeout_seconds);
+    profile.keepalive_requests = envSize("HTTP_KEEPALIVE_REQUESTS", profile.keepalive_requests);
+    profile.pipelining_requests = envSize("HTTP_PIPELINING_REQUESTS", profile.pipelining_requests);
+    profile.max_connections = envSize("HTTP_MAX_CONNECTIONS", profile.max_connections);
+    profile.max_connections_per_ip = envSize("HTTP_MAX_CONNECTIONS_PER_IP", profile.max_connections_per_ip);
+    profile.max_body_bytes = envSize("HTTP_MAX_BODY_KB", profile.max_body_bytes / 1024) * 1024;
+    profile.command_body_bytes = envSize("HTTP_COMMAND_BODY_KB", profile.command_body_bytes / 1024) * 1024;
+    profile.batch_body_bytes = envSize("HTTP_BATCH_BODY_KB", profile.batch_body_bytes / 1024) * 1024;
+
+    // A route cap above the global one could never be reached
+    profile.command_body_bytes = std::min(profile.command_body_bytes, profile.max_body_bytes);
+    profile.batch_body_bytes = std::min(profile.batch_body_bytes, profile.max_body_bytes);
+    return profile;
+}
+
+size_t ServerProfile::bodyLimitFor(std::string_view path) const {
+    if (path == "/api/broadcast") {
+        return command_body_bytes;
+    }
+    if (path.rfind("/api/macros", 0) == 0) {
+        return batch_body_bytes;
+    }
+    constexpr std::string_view devices = "/api/devices/";
+    if (path.rfind(devices, 0) == 0) {
+        // /api/devices/{id}<route>
+        size_t slash = path.find('/', devices.size());
+        std::string_view route = slash == std::string_view::npos ? std::string_view() : path.substr(slash);
+        if (route == "/commands/batch") {
+            return batch_body_bytes;
+        }
+        for (std::string_view command : {"/command", "/navigate", "/media", "/volume", "/app", "/text",
+                                         "/pair/start", "/pair/verify"}) {
+            if (route == command) {
+                return command_body_bytes;
+            }
+        }
+    }
+    return max_body_bytes;
+}
+
+Json::Value ServerProfile::toJson() const {
+    Json::Value json;
+    json["threads"] = static_cast<Json::UInt64>(threads);
+    json["reuse_port"] = reuse_port;
+    json["tcp_nodelay"] = tcp_nodelay;
+    json["idle_timeout_s"] = static_cast<Json::UInt64>(idle_timeout_seconds);
+    json["keepalive_requests"] = static_cast<Json::UInt64>(keepalive_requests);
+    json["pipelining_requests"] = static_cast<Json::UInt64>(pipelining_requests);
+    json["max_connections"] = static_cast<Json::UInt64>(max_connections);
+    json["max_connections_per_ip"] = static_cast<Json::UInt64>(max_connections_per_ip);
+    json["max_body_bytes"] = static_cast<Json::UInt64>(max_body_bytes);
+    json["command_body_bytes"] = static_cast<Json::UInt64>(command_body_bytes);
+    json["batch_body_bytes"] = static_cast<Json::UInt64>(batch_body_bytes);
+    return json;
+}
+
+} // namespace hms_firetv
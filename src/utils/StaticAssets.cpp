@@ -0,0 +1,297 @@
+#include "utils/StaticAssets.h"
+#include <zlib.h>
+#ifdef HMS_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace hms_firetv {
+
+namespace {
+
+std::string gzip(const std::string& input) {
+    z_stream stream{};
+    // 15 + 16: gzip wrapper instead of raw zlib
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return {};
+    }
+    std::string output(deflateBound(&stream, input.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+    int status = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return status == Z_STREAM_END ? output : std::string();
+}
+
+std::string brotli(const std::string& input) {
+#ifdef HMS_HAVE_BROTLI
+    size_t size = BrotliEncoderMaxCompressedSize(input.size());
+    if (size == 0) {
+        return {};
+    }
+    std::string output(size, '\0');
+    if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               input.size(), reinterpret_cast<const uint8_t*>(input.data()),
+                               &size, reinterpret_cast<uint8_t*>(output.data()))) {
+        return {};
+    }
+    output.resize(size);
+    return output;
+#else
+    (void)input;
+    return {};
+#endif
+}
+
+// FNV-1a: stable across builds and processes, unlike std::hash
+std::string contentHash(const std::string& body) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : body) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return hex;
+}
+
+std::string_view extension(std::string_view path) {
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+        return {};
+    }
+    return path.substr(dot + 1);
+}
+
+bool compressible(std::string_view content_type) {
+    return content_type.rfind("text/", 0) == 0 ||
+           content_type.rfind("application/javascript", 0) == 0 ||
+           content_type.rfind("application/json", 0) == 0 ||
+           content_type == "image/svg+xml" ||
+           content_type == "image/x-icon";
+}
+
+// Angular names build output <name>-<HASH>.<ext>, HASH being 8+ of [A-Z0-9]
+bool fingerprinted(std::string_view path) {
+    size_t slash = path.rfind('/');
+    std::string_view name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+    size_t dash = name.rfind('-');
+    if (dash == std::string_view::npos) {
+        return false;
+    }
+    size_t dot = name.find('.', dash);
+    if (dot == std::string_view::npos || dot - dash - 1 < 8) {
+        return false;
+    }
+    for (size_t i = dash + 1; i < dot; i++) {
+        char c = name[i];
+        if (!std::isdigit(static_cast<unsigned char>(c)) && !(c >= 'A' && c <= 'Z')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether an Accept-Encoding list allows `coding` (q=0 means no; "*" covers it)
+bool accepts(std::string_view header, std::string_view coding) {
+    bool star = false;
+    while (!header.empty()) {
+        size_t comma = header.find(',');
+        std::string_view item = header.substr(0, comma);
+        header = comma == std::string_view::npos ? std::string_view() : header.substr(comma + 1);
+
+        size_t semi = item.find(';');
+        std::string_view name = item.substr(0, semi);
+        while (!name.empty() && name.front() == ' ') name.remove_prefix(1);
+        while (!name.empty() && name.back() == ' ') name.remove_suffix(1);
+
+        bool allowed = true;
+        if (semi != std::string_view::npos) {
+            std::string_view params = item.substr(semi + 1);
+            size_t q = params.find("q=");
+            if (q != std::string_view::npos) {
+                allowed = std::strtod(std::string(params.substr(q + 2)).c_str(), nullptr) > 0.0;
+            }
+        }
+        if (name == coding) {
+            return allowed;
+        }
+        if (name == "*") {
+            star = allowed;
+        }
+    }
+    return star;
+}
+
+} // namespace
+
+StaticAssets::StaticAssets(Options options) : options_(options) {}
+
+size_t StaticAssets::loadDirectory(const std::string& dir) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec)) {
+        return 0;
+    }
+
+    size_t loaded = 0;
+    for (auto it = fs::recursive_directory_iterator(dir, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->file_size(ec) > options_.max_file_bytes) {
+            continue;
+        }
+        std::ifstream file(it->path(), std::ios::binary);
+        if (!file.good()) {
+            continue;
+        }
+        std::string body(std::istreambuf_iterator<char>(file), {});
+        add("/" + fs::relative(it->path(), dir, ec).generic_string(), std::move(body));
+        loaded++;
+    }
+    return loaded;
+}
+
+void StaticAssets::add(const std::string& path, std::string body) {
+    Asset asset;
+    asset.path = path;
+    asset.content_type = contentTypeFor(path);
+    asset.cache_control = cacheControlFor(path);
+
+    std::string hash = contentHash(body);
+    bool compress = compressible(asset.content_type) && body.size() >= options_.min_compress_bytes;
+
+    // Only keep encodings that actually save bytes
+    std::vector<Variant> variants;
+    if (compress) {
+        for (auto [encoding, suffix] : {std::pair{Encoding::Brotli, "-br"}, std::pair{Encoding::Gzip, "-gz"}}) {
+            std::string compressed = encoding == Encoding::Brotli ? brotli(body) : gzip(body);
+            if (!compressed.empty() && compressed.size() < body.size()) {
+                variants.push_back({encoding, std::move(compressed), "\"" + hash + suffix + "\"", 0});
+            }
+        }
+    }
+    asset.variants.push_back({Encoding::Identity, std::move(body), "\"" + hash + "\"", 0});
+    for (auto& variant : variants) {
+        asset.variants.push_back(std::move(variant));
+    }
+
+    // A replaced file's old ids are simply never used again
+    for (auto& variant : asset.variants) {
+        variant.id = next_variant_id_++;
+    }
+    assets_[path] = std::move(asset);
+}
+
+const StaticAssets::Asset* StaticAssets::find(const std::string& path) const {
+    auto it = assets_.find(path == "/" ? "/index.html" : path);
+    return it == assets_.end() ? nullptr : &it->second;
+}
+
+const StaticAssets::Asset* StaticAssets::index() const {
+    return find("/index.html");
+}
+
+const StaticAssets::Variant& StaticAssets::select(const Asset& asset, std::string_view accept_encoding) {
+    if (!accept_encoding.empty()) {
+        for (auto preferred : {Encoding::Brotli, Encoding::Gzip}) {
+            for (const auto& variant : asset.variants) {
+                if (variant.encoding == preferred && accepts(accept_encoding, encodingName(preferred))) {
+                    return variant;
+                }
+            }
+        }
+    }
+    return asset.variants.front();
+}
+
+bool StaticAssets::notModified(const Variant& variant, std::string_view if_none_match) {
+    while (!if_none_match.empty()) {
+        size_t comma = if_none_match.find(',');
+        std::string_view tag = if_none_match.substr(0, comma);
+        if_none_match = comma == std::string_view::npos ? std::string_view() : if_none_match.substr(comma + 1);
+
+        while (!tag.empty() && tag.front() == ' ') tag.remove_prefix(1);
+        while (!tag.empty() && tag.back() == ' ') tag.remove_suffix(1);
+        if (tag.rfind("W/", 0) == 0) {
+            tag.remove_prefix(2);   // If-None-Match uses weak comparison
+        }
+        if (tag == "*" || tag == variant.etag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* StaticAssets::encodingName(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::Gzip:   return "gzip";
+        case Encoding::Brotli: return "br";
+        default:               return "identity";
+    }
+}
+
+std::string StaticAssets::contentTypeFor(std::string_view path) {
+    static const std::unordered_map<std::string_view, const char*> types = {
+        {"html", "text/html; charset=utf-8"},
+        {"js", "application/javascript; charset=utf-8"},
+        {"mjs", "application/javascript; charset=utf-8"},
+        {"css", "text/css; charset=utf-8"},
+        {"json", "application/json"},
+        {"txt", "text/plain; charset=utf-8"},
+        {"map", "application/json"},
+        {"svg", "image/svg+xml"},
+        {"ico", "image/x-icon"},
+        {"png", "image/png"},
+        {"jpg", "image/jpeg"},
+        {"jpeg", "image/jpeg"},
+        {"gif", "image/gif"},
+        {"webp", "image/webp"},
+        {"woff", "font/woff"},
+        {"woff2", "font/woff2"},
+        {"ttf", "font/ttf"},
+    };
+    auto it = types.find(extension(path));
+    return it == types.end() ? "application/octet-stream" : it->second;
+}
+
+std::string StaticAssets::cacheControlFor(std::string_view path) {
+    if (fingerprinted(path)) {
+        return "public, max-age=31536000, immutable";
+    }
+    if (extension(path) == "html") {
+        return "no-cache";
+    }
+    return "public, max-age=3600";
+}
+
+bool StaticAssets::compressionAvailable(Encoding encoding) {
+#ifdef HMS_HAVE_BROTLI
+    (void)encoding;
+    return true;
+#else
+    return encoding != Encoding::Brotli;
+#endif
+}
+
+uint64_t StaticAssets::bytes(Encoding encoding) const {
+    uint64_t total = 0;
+    for (const auto& [path, asset] : assets_) {
+        for (const auto& variant : asset.variants) {
+            if (variant.encoding == encoding) {
+                total += variant.body.size();
+            }
+        }
+    }
+    return total;
+}
+
+} // namespace hms_firetv
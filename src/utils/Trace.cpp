@@ -0,0 +1,408 @@
+#include "utils/Trace.h"
+#include "utils/ConfigManager.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+namespace hms_firetv {
+
+thread_local Trace* Trace::current_ = nullptr;
+
+namespace {
+
+std::string randomHex(size_t bytes) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+    std::string out;
+    out.reserve(bytes * 2);
+    while (out.size() < bytes * 2) {
+        uint64_t value = rng();
+        for (int i = 0; i < 16 && out.size() < bytes * 2; i++) {
+            out += DIGITS[value & 0xf];
+            value >>= 4;
+        }
+    }
+    return out;
+}
+
+bool isHex(std::string_view text) {
+    return std::all_of(text.begin(), text.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+    });
+}
+
+double millis(Trace::Clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count() / 1000.0;
+}
+
+Json::Value otlpAttribute(const char* key, const std::string& value) {
+    Json::Value attribute;
+    attribute["key"] = key;
+    attribute["value"]["stringValue"] = value;
+    return attribute;
+}
+
+// OTLP SpanKind: 1 internal, 2 server, 3 client, 5 consumer
+int otlpKind(const std::string& span_name) {
+    if (span_name == "connect" || span_name == "tls" || span_name == "dns" ||
+        span_name == "request" || span_name == "response" || span_name == "wake_probe") {
+        return 3;
+    }
+    return 1;
+}
+
+} // namespace
+
+// ============================================================================
+// TRACE
+// ============================================================================
+
+Trace::Trace(std::string id, std::string source)
+    : id_(std::move(id)),
+      span_id_(Tracer::newSpanId()),
+      source_(std::move(source)),
+      started_(Clock::now()),
+      started_wall_(std::chrono::system_clock::now()) {}
+
+Trace* Trace::current() {
+    return current_;
+}
+
+bool Trace::isValidId(std::string_view id) {
+    return id.size() == 32 && isHex(id) && id != std::string(32, '0');
+}
+
+void Trace::setCommand(std::string device_id, std::string command) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    device_id_ = std::move(device_id);
+    command_ = std::move(command);
+}
+
+void Trace::adoptId(std::string_view id) {
+    if (isValidId(id)) {
+        id_ = std::string(id);
+    }
+}
+
+bool Trace::adoptTraceparent(std::string_view traceparent) {
+    // version(2)-trace_id(32)-parent_id(16)-flags(2)
+    if (traceparent.size() < 55 || traceparent[2] != '-' || traceparent[35] != '-' ||
+        traceparent[52] != '-') {
+        return false;
+    }
+    std::string_view trace_id = traceparent.substr(3, 32);
+    std::string_view parent = traceparent.substr(36, 16);
+    std::string_view flags = traceparent.substr(53, 2);
+    if (!isValidId(trace_id) || !isHex(parent) || !isHex(flags) || parent == std::string(16, '0')) {
+        return false;
+    }
+    id_ = std::string(trace_id);
+    parent_span_id_ = std::string(parent);
+    if (std::strtol(std::string(flags).c_str(), nullptr, 16) & 0x01) {
+        forced_ = true;
+    }
+    return true;
+}
+
+void Trace::addSpan(std::string name, Clock::time_point start, Clock::time_point end,
+                    std::string detail, bool error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    spans_.push_back({std::move(name), start, end, std::move(detail), error});
+}
+
+void Trace::setResult(bool success, std::string error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    success_ = success;
+    error_ = std::move(error);
+}
+
+bool Trace::success() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return success_;
+}
+
+std::string Trace::deviceId() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return device_id_;
+}
+
+std::chrono::microseconds Trace::duration() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto end = finished() ? ended_ : Clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - started_);
+}
+
+Json::Value Trace::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto end = finished() ? ended_ : Clock::now();
+
+    Json::Value json;
+    json["trace_id"] = id_;
+    json["source"] = source_;
+    json["device_id"] = device_id_;
+    json["command"] = command_;
+    json["success"] = success_;
+    if (!error_.empty()) {
+        json["error"] = error_;
+    }
+    json["started_at_ms"] = static_cast<Json::Int64>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(started_wall_.time_since_epoch()).count());
+    json["duration_ms"] = millis(end - started_);
+
+    json["spans"] = Json::arrayValue;
+    for (const auto& span : spans_) {
+        Json::Value entry;
+        entry["name"] = span.name;
+        entry["offset_ms"] = millis(span.start - started_);
+        entry["duration_ms"] = millis(span.end - span.start);
+        if (!span.detail.empty()) {
+            entry["detail"] = span.detail;
+        }
+        if (span.error) {
+            entry["error"] = true;
+        }
+        json["spans"].append(entry);
+    }
+    return json;
+}
+
+Json::Value Trace::toOtlp() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto end = finished() ? ended_ : Clock::now();
+
+    // OTLP/JSON carries 64-bit integers as strings
+    auto unixNanos = [this](Clock::time_point t) {
+        auto wall = started_wall_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(t - started_);
+        return std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            wall.time_since_epoch()).count());
+    };
+
+    Json::Value spans(Json::arrayValue);
+
+    Json::Value root;
+    root["traceId"] = id_;
+    root["spanId"] = span_id_;
+    if (!parent_span_id_.empty()) {
+        root["parentSpanId"] = parent_span_id_;
+    }
+    root["name"] = source_ + " " + (command_.empty() ? std::string("command") : command_);
+    root["kind"] = source_ == "mqtt" ? 5 : 2;
+    root["startTimeUnixNano"] = unixNanos(started_);
+    root["endTimeUnixNano"] = unixNanos(end);
+    root["attributes"].append(otlpAttribute("firetv.device_id", device_id_));
+    root["attributes"].append(otlpAttribute("firetv.command", command_));
+    root["attributes"].append(otlpAttribute("firetv.source", source_));
+    root["status"]["code"] = success_ ? 1 : 2;
+    if (!error_.empty()) {
+        root["status"]["message"] = error_;
+    }
+    spans.append(root);
+
+    for (const auto& span : spans_) {
+        Json::Value child;
+        child["traceId"] = id_;
+        child["spanId"] = Tracer::newSpanId();
+        child["parentSpanId"] = span_id_;
+        child["name"] = span.name;
+        child["kind"] = otlpKind(span.name);
+        child["startTimeUnixNano"] = unixNanos(span.start);
+        child["endTimeUnixNano"] = unixNanos(span.end);
+        if (!span.detail.empty()) {
+            child["attributes"].append(otlpAttribute("firetv.detail", span.detail));
+        }
+        if (span.error) {
+            child["status"]["code"] = 2;
+        }
+        spans.append(child);
+    }
+
+    Json::Value scope;
+    scope["scope"]["name"] = "hms-firetv";
+    scope["spans"] = spans;
+
+    Json::Value resource;
+    resource["resource"]["attributes"].append(otlpAttribute("service.name", "hms-firetv"));
+    resource["scopeSpans"].append(scope);
+
+    Json::Value request;
+    request["resourceSpans"].append(resource);
+    return request;
+}
+
+// ============================================================================
+// TRACER
+// ============================================================================
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance([] {
+        Options options;
+        std::string rate = ConfigManager::getEnv("TRACE_SAMPLE_RATE", "");
+        if (!rate.empty()) {
+            options.sample_rate = std::min(1.0, std::max(0.0, std::atof(rate.c_str())));
+        }
+        options.slow = std::chrono::milliseconds(std::max(0, ConfigManager::getEnvInt("TRACE_SLOW_MS", 500)));
+        options.capacity = static_cast<size_t>(std::max(1, ConfigManager::getEnvInt("TRACE_BUFFER_SIZE", 256)));
+        options.export_file = ConfigManager::getEnv("TRACE_EXPORT_FILE", "");
+        return options;
+    }());
+    return instance;
+}
+
+Tracer::Tracer(Options options)
+    : options_(std::move(options)) {
+    options_.capacity = std::max<size_t>(1, options_.capacity);
+    ring_.resize(options_.capacity);
+    if (!options_.export_file.empty()) {
+        exporter_.start();
+    }
+}
+
+Tracer::~Tracer() {
+    stop();
+}
+
+void Tracer::stop() {
+    exporter_.stop();
+}
+
+std::string Tracer::newTraceId() {
+    return randomHex(16);
+}
+
+std::string Tracer::newSpanId() {
+    return randomHex(8);
+}
+
+std::shared_ptr<Trace> Tracer::start(const char* source, std::string_view traceparent) {
+    if (!enabled()) {
+        return nullptr;
+    }
+    started_.fetch_add(1, std::memory_order_relaxed);
+    auto trace = std::make_shared<Trace>(newTraceId(), source);
+    if (!traceparent.empty()) {
+        trace->adoptTraceparent(traceparent);
+    }
+    return trace;
+}
+
+bool Tracer::sampled(const Trace& trace) const {
+    if (options_.sample_rate <= 0) {
+        return false;
+    }
+    if (options_.sample_rate >= 1) {
+        return true;
+    }
+    // Low 64 bits of the ID, as in W3C/OpenTelemetry ratio sampling
+    uint64_t value = std::strtoull(trace.id().substr(16).c_str(), nullptr, 16);
+    return static_cast<double>(value) < options_.sample_rate * 18446744073709551616.0;
+}
+
+void Tracer::finish(const std::shared_ptr<Trace>& trace) {
+    if (!trace) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(trace->mutex_);
+        if (trace->finished()) {
+            return;
+        }
+        trace->ended_ = Trace::Clock::now();
+        trace->finished_.store(true, std::memory_order_release);
+    }
+
+    bool keep = true;
+    if (!trace->success()) {
+        kept_error_.fetch_add(1, std::memory_order_relaxed);
+    } else if (options_.slow.count() > 0 && trace->duration() >= options_.slow) {
+        kept_slow_.fetch_add(1, std::memory_order_relaxed);
+    } else if (trace->forced()) {
+        kept_forced_.fetch_add(1, std::memory_order_relaxed);
+    } else if (sampled(*trace)) {
+        kept_sampled_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        keep = false;
+    }
+    if (!keep) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ring_[next_] = trace;
+        next_ = (next_ + 1) % ring_.size();
+    }
+    if (!options_.export_file.empty()) {
+        exportTrace(trace);
+    }
+}
+
+void Tracer::exportTrace(const std::shared_ptr<const Trace>& trace) {
+    // File I/O stays off the request path; the exporter thread owns the stream
+    exporter_.enqueue([this, trace]() {
+        if (!export_stream_.is_open()) {
+            export_stream_.open(options_.export_file, std::ios::app);
+            if (!export_stream_) {
+                LOG_ERROR("Tracer") << "Cannot open trace export file " << options_.export_file;
+                export_stream_.close();
+                return;
+            }
+        }
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        export_stream_ << Json::writeString(writer, trace->toOtlp()) << '\n';
+        export_stream_.flush();
+        exported_.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+std::vector<std::shared_ptr<const Trace>> Tracer::recent(size_t limit, const std::string& device_id,
+                                                         std::chrono::milliseconds min_duration) const {
+    std::vector<std::shared_ptr<const Trace>> traces;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < ring_.size() && traces.size() < limit; i++) {
+        const auto& trace = ring_[(next_ + ring_.size() - 1 - i) % ring_.size()];
+        if (!trace) {
+            break;  // Ring not full yet
+        }
+        if (!device_id.empty() && trace->deviceId() != device_id) {
+            continue;
+        }
+        if (trace->duration() < min_duration) {
+            continue;
+        }
+        traces.push_back(trace);
+    }
+    return traces;
+}
+
+std::shared_ptr<const Trace> Tracer::find(const std::string& trace_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& trace : ring_) {
+        if (trace && trace->id() == trace_id) {
+            return trace;
+        }
+    }
+    return nullptr;
+}
+
+Json::Value Tracer::stats() const {
+    Json::Value stats;
+    stats["enabled"] = enabled();
+    stats["sample_rate"] = options_.sample_rate;
+    stats["slow_ms"] = static_cast<Json::Int64>(options_.slow.count());
+    stats["capacity"] = static_cast<Json::UInt64>(options_.capacity);
+    stats["started"] = static_cast<Json::UInt64>(started_.load(std::memory_order_relaxed));
+    stats["kept"]["error"] = static_cast<Json::UInt64>(kept_error_.load(std::memory_order_relaxed));
+    stats["kept"]["slow"] = static_cast<Json::UInt64>(kept_slow_.load(std::memory_order_relaxed));
+    stats["kept"]["forced"] = static_cast<Json::UInt64>(kept_forced_.load(std::memory_order_relaxed));
+    stats["kept"]["sampled"] = static_cast<Json::UInt64>(kept_sampled_.load(std::memory_order_relaxed));
+    if (!options_.export_file.empty()) {
+        stats["export_file"] = options_.export_file;
+        stats["exported"] = static_cast<Json::UInt64>(exported_.load(std::memory_order_relaxed));
+        stats["export_dropped"] = static_cast<Json::UInt64>(exporter_.droppedCount());
+    }
+    return stats;
+}
+
+} // namespace hms_firetv
@@ -0,0 +1 @@
+import{c as _}from"./chunk-TTKMRQAF.js";import"./chunk-G5Q6IVPP.js";import{a as St,b as Sv}from"./chunk-JDYRMWYY.js";import{a as f}from"./chunk-4KT5IJ7H.js";import{$a as s,Ha as m,Ia as v,Ja as u,Ka as C,Ma as e,N as x,Na as t,Oa as b,Ta as p,Ya as l,Za as n,_a as r,ba as c,na as a,ya as g}from"./chunk-3C5URT7C.js";var S=(d,o)=>o.device_id;function E(d,o){d&1&&(e(0,"div",0)(1,"p",2),n(2,"Loading..."),t()())}function M(d,o){if(d&1&&(e(0,"tr")(1,"td"),b(2,"span",16),t(),e(3,"td")(4,"div",17),n(5),t(),e(6,"div",18),n(7),t()(),e(8,"td",2),n(9),t(),e(10,"td")(11,"span",19),n(12),t()(),e(13,"td",2),n(14),t()()),d&2){let i=o.$implicit;a(2),l("dot-online",i.status==="online"&&i.reachable!==!1)("dot-offline",i.status==="offline"||i.reachable===!1)("dot-pairing",i.status==="pairing"),a(3),r(i.name),a(2),r(i.device_id),a(2),r(i.ip_address),a(2),l("badge-success",i.is_paired)("badge-gray",!i.is_paired),a(),s(" ",i.is_paired?"Yes":"No"," "),a(2),r(i.last_seen_at||"Never")}}function P(d,o){if(d&1&&(e(0,"div",0)(1,"h2"),n(2,"Your Devices"),t(),e(3,"table")(4,"thead")(5,"tr")(6,"th"),n(7,"Status"),t(),e(8,"th"),n(9,"Device"),t(),e(10,"th"),n(11,"IP Address"),t(),e(12,"th"),n(13,"Paired"),t(),e(14,"th"),n(15,"Last Seen"),t()()(),e(16,"tbody"),u(17,M,15,15,"tr",null,S),t()()()),d&2){let i=p(2);a(17),C(i.devices())}}function O(d,o){d&1&&(e(0,"div",9)(1,"p"),n(2,"No devices configured."),t(),e(3,"a",20),n(4,"Add Device"),t()())}function y(d,o){if(d&1&&(e(0,"div",3)(1,"div",4)(2,"div",5),n(3,"DB"),t(),e(4,"div",6),n(5,"Database"),t(),e(6,"div",7),n(7),t()(),e(8,"div",4)(9,"div",5),n(10,"MQ"),t(),e(11,"div",6),n(12,"MQTT"),t(),e(13,"div",7),n(14),t()(),e(15,"div",4)(16,"div",8),n(17),t(),e(18,"div",6),n(19,"Devices"),t(),e(20,"div",7),n(21),t()(),e(22,"div",4)(23,"div",8),n(24),t(),e(25,"div",6),n(26,"Paired"),t(),e(27,"div",7),n(28),t()()(),m(29,P,19,0,"div",0)(30,O,5,0,"div",9),e(31,"div",10)(32,"a",11)(33,"div",12),n(34,"Manage Devices"),t(),e(35,"div",13),n(36,"Add, edit, or pair devices"),t()(),e(37,"a",14)(38,"div",12),n(39,"Remote Control"),t(),e(40,"div",13),n(41,"Control your Fire TV"),t()(),e(42,"a",15)(43,"div",12),n(44,"Manage Apps"),t(),e(45,"div",13),n(46,"Configure device apps"),t()()()),d&2){let i=p();a(2),l("connected",i.dbConnected()),a(5),r(i.dbConnected()?"Connected":"Disconnected"),a(2),l("connected",i.mqttConnected()),a(5),r(i.mqttConnected()?"Connected":"Disconnected"),a(3),r(i.totalDevices()),a(4),s("",i.onlineDevices()," online"),a(3),r(i.pairedDevices()),a(4),s("",i.totalDevices()-i.pairedDevices()," unpaired"),a(),v(i.devices().length>0?29:30)}}var h=class d{api=x(f);stream=x(St);timer=null;events=null;loading=c(!0);dbConnected=c(!1);mqttConnected=c(!1);totalDevices=c(0);pairedDevices=c(0);onlineDevices=c(0);devices=c([]);ngOnInit(){this.load(),this.stream.start(),this.events=this.stream.events.subscribe(o=>this.onEvent(o)),this.timer=setInterval(()=>{this.stream.connected()||this.load()},15e3)}ngOnDestroy(){this.timer&&clearInterval(this.timer),this.events?.unsubscribe()}onEvent(o){if(o.t==="hello")o.resync&&this.load();else if(o.t==="device"){let i=Sv(this.devices(),o);if(!i){this.load();return}this.devices.set(i),this.pairedDevices.set(i.filter(D=>D.is_paired).length),this.onlineDevices.set(i.filter(D=>D.status==="online").length)}else o.t==="service"&&o.mqtt&&this.mqttConnected.set(o.mqtt==="connected")}load(){this.api.getStatus().subscribe({next:o=>{this.dbConnected.set(o.connections?.database==="connected"),this.mqttConnected.set(o.connections?.mqtt==="connected"),this.totalDevices.set(o.devices?.total??0),this.pairedDevices.set(o.devices?.paired??0),this.onlineDevices.set(o.devices?.online??0)},error:()=>{}}),this.api.getDevices().subscribe({next:o=>{this.devices.set(o.devices||[]),this.loading.set(!1)},error:()=>this.loading.set(!1)})}static \u0275fac=function(i){return new(i||d)};static \u0275cmp=g({type:d,selectors:[["app-dashboard"]],decls:7,vars:1,consts:[[1,"card"],[1,"subtitle"],[1,"muted"],[1,"grid"],[1,"card","stat-card"],[1,"stat-icon"],[1,"stat-label"],[1,"stat-value"],[1,"stat-icon","num"],[1,"card","empty-state"],[1,"grid","actions-grid"],["routerLink","/devices",1,"card","action-card"],[1,"action-title"],[1,"action-desc"],["routerLink","/remote",1,"card","action-card"],["routerLink","/apps",1,"card","action-card"],[1,"dot"],[1,"device-name"],[1,"device-id"],[1,"badge"],["routerLink","/devices",1,"btn","btn-primary"]],template:function(i,D){i&1&&(e(0,"div",0)(1,"h1"),n(2,"Dashboard"),t(),e(3,"p",1),n(4,"Colada Lightning \u2014 Fire TV Control"),t()(),m(5,E,3,0,"div",0)(6,y,47,11)),i&2&&(a(5),v(D.loading()?5:6))},dependencies:[_],styles:["h1[_ngcontent-%COMP%]{font-size:22px;font-weight:600}h2[_ngcontent-%COMP%]{font-size:18px;font-weight:600;margin-bottom:16px}.subtitle[_ngcontent-%COMP%]{color:var(--text-muted);font-size:14px;margin-top:4px}.grid[_ngcontent-%COMP%]{display:grid;grid-template-columns:repeat(4,1fr);gap:0}.stat-card[_ngcontent-%COMP%]{text-align:center}.stat-icon[_ngcontent-%COMP%]{font-size:28px;font-weight:700;color:var(--error);margin-bottom:8px}.stat-icon.connected[_ngcontent-%COMP%]{color:var(--success)}.stat-icon.num[_ngcontent-%COMP%]{color:var(--accent)}.stat-label[_ngcontent-%COMP%]{font-size:13px;color:var(--text-muted);text-transform:uppercase;letter-spacing:.5px}.stat-value[_ngcontent-%COMP%]{font-size:14px;color:var(--text);margin-top:4px}.device-name[_ngcontent-%COMP%]{font-weight:500}.device-id[_ngcontent-%COMP%]{font-size:12px;color:var(--text-muted)}.muted[_ngcontent-%COMP%]{color:var(--text-muted)}.empty-state[_ngcontent-%COMP%]{text-align:center;padding:40px}.empty-state[_ngcontent-%COMP%]   p[_ngcontent-%COMP%]{margin-bottom:16px;color:var(--text-muted)}.actions-grid[_ngcontent-%COMP%]{grid-template-columns:repeat(3,1fr)}.action-card[_ngcontent-%COMP%]{text-decoration:none;color:var(--text);cursor:pointer;transition:border-color .2s;border:1px solid transparent}.action-card[_ngcontent-%COMP%]:hover{border-color:var(--accent)}.action-title[_ngcontent-%COMP%]{font-size:16px;font-weight:600;color:var(--accent);margin-bottom:4px}.action-desc[_ngcontent-%COMP%]{font-size:13px;color:var(--text-muted)}"]})};export{h as DashboardComponent};
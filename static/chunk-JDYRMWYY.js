@@ -0,0 +1 @@
+import{I as l,ba as c,f as h}from"./chunk-3C5URT7C.js";var s=class n{connected=c(!1);events=new h;lastSeq=null;useSse=typeof WebSocket>"u";retryMs=1e3;started=!1;start(){this.started||(this.started=!0,this.connect())}connect(){let e=this.lastSeq!==null?`?since=${this.lastSeq}`:"";if(!this.useSse){let r=location.protocol==="https:"?"wss:":"ws:",o=new WebSocket(`${r}//${location.host}/api/stream${e}`),i=!1;o.onopen=()=>i=!0,o.onmessage=a=>this.dispatch(a.data),o.onclose=()=>{this.connected.set(!1),i||(this.useSse=!0),this.reconnect()};return}let t=new EventSource(`/api/stream${e}`);t.onmessage=r=>this.dispatch(r.data),t.onerror=()=>{this.connected.set(!1),t.readyState===EventSource.CLOSED&&this.reconnect()}}reconnect(){setTimeout(()=>this.connect(),this.retryMs),this.retryMs=Math.min(this.retryMs*2,3e4)}dispatch(e){let t;try{t=JSON.parse(e)}catch{return}if(t.t==="hello")this.retryMs=1e3,this.connected.set(!0);else if(this.lastSeq!==null&&t.seq<=this.lastSeq)return;this.lastSeq=t.seq,this.events.next(t)}static \u0275fac=function(t){return new(t||n)};static \u0275prov=l({token:n,factory:n.\u0275fac,providedIn:"root"})};function d(n,e){if(e.change||!n.some(u=>u.device_id===e.id))return null;let{seq:t,t:r,id:o,...i}=e;return n.map(u=>u.device_id===o?{...u,...i}:u)}export{s as a,d as b};
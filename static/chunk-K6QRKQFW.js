@@ -0,0 +1 @@
+import{a as T,b as F,c as I,g as N}from"./chunk-QIDQYIKN.js";import"./chunk-G5Q6IVPP.js";import{a as St,b as Sv}from"./chunk-JDYRMWYY.js";import{a as P}from"./chunk-4KT5IJ7H.js";import{$a as f,Ha as x,Ia as C,Ja as y,Ka as S,La as w,Ma as t,N as k,Na as i,Oa as E,Ra as u,S as m,Sa as p,T as _,Ta as c,Ya as V,Za as r,_a as g,ba as v,bb as h,cb as b,db as D,na as s,ya as M}from"./chunk-3C5URT7C.js";var A=(a,n)=>n.device_id,W=(a,n)=>n.ip_address;function L(a,n){if(a&1){let e=u();t(0,"button",14),p("click",function(){m(e);let o=c().$implicit,d=c();return _(d.startPair(o))}),r(1,"Pair"),i()}}function B(a,n){if(a&1){let e=u();t(0,"button",15),p("click",function(){m(e);let o=c().$implicit,d=c();return _(d.unpair(o))}),r(1,"Unpair"),i()}}function j(a,n){if(a&1){let e=u();t(0,"tr")(1,"td"),E(2,"span",5),i(),t(3,"td")(4,"a",6),p("click",function(){let o=m(e).$implicit,d=c();return _(d.openEdit(o))}),r(5),i(),t(6,"div",7),r(7),i()(),t(8,"td",8),r(9),i(),t(10,"td")(11,"span",9),r(12),i()(),t(13,"td",8),r(14),i(),t(15,"td")(16,"div",10),x(17,L,2,0,"button",11)(18,B,2,0,"button",12),t(19,"button",13),p("click",function(){let o=m(e).$implicit,d=c();return _(d.remove(o))}),r(20,"Delete"),i()()()()}if(a&2){let e=n.$implicit;s(2),V("dot-online",e.status==="online"&&e.reachable!==!1)("dot-offline",e.status==="offline"||e.reachable===!1)("dot-pairing",e.status==="pairing"),s(3),g(e.name),s(2),g(e.device_id),s(2),g(e.ip_address),s(2),V("badge-success",e.is_paired)("badge-gray",!e.is_paired),s(),f(" ",e.is_paired?"Yes":"No"," "),s(2),g(e.adb_enabled?"On":"Off"),s(3),C(e.is_paired?18:17)}}function U(a,n){a&1&&(t(0,"tr")(1,"td",16),r(2,'No devices. Click "Add Device" to get started.'),i()())}function $(a,n){if(a&1&&(t(0,"div",23),r(1),i()),a&2){let e=c(2);s(),g(e.error())}}function z(a,n){if(a&1){let e=u();t(0,"div",17),p("click",function(o){m(e);let d=c();return _(d.onOverlay(o))}),t(1,"div",18)(2,"h2"),r(3),i(),t(4,"div",19)(5,"label"),r(6,"Device ID"),i(),t(7,"input",20),D("ngModelChange",function(o){m(e);let d=c();return b(d.form.device_id,o)||(d.form.device_id=o),_(o)}),i()(),t(8,"div",19)(9,"label"),r(10,"Name"),i(),t(11,"input",21),D("ngModelChange",function(o){m(e);let d=c();return b(d.form.name,o)||(d.form.name=o),_(o)}),i()(),t(12,"div",19)(13,"label"),r(14,"IP Address"),i(),t(15,"input",22),D("ngModelChange",function(o){m(e);let d=c();return b(d.form.ip_address,o)||(d.form.ip_address=o),_(o)}),i()(),x(16,$,2,1,"div",23),t(17,"div",24)(18,"button",25),p("click",function(){m(e);let o=c();return _(o.closeForm())}),r(19,"Cancel"),i(),t(20,"button",26),p("click",function(){m(e);let o=c();return _(o.save())}),r(21),i()()()()}if(a&2){let e=c();s(3),g(e.editDevice()?"Edit Device":"Add Device"),s(4),h("ngModel",e.form.device_id),w("disabled",!!e.editDevice()),s(4),h("ngModel",e.form.name),s(4),h("ngModel",e.form.ip_address),s(),C(e.error()?16:-1),s(4),w("disabled",e.saving()),s(),f(" ",e.saving()?"Saving...":"Save"," ")}}function H(a,n){if(a&1&&(t(0,"div",23),r(1),i()),a&2){let e=c(3);s(),g(e.error())}}function R(a,n){if(a&1){let e=u();t(0,"p",8),r(1,"A PIN should appear on your TV screen."),i(),t(2,"div",27)(3,"label"),r(4,"Enter PIN"),i(),t(5,"input",28),D("ngModelChange",function(o){m(e);let d=c(2);return b(d.pairPin,o)||(d.pairPin=o),_(o)}),i()(),x(6,H,2,1,"div",23),t(7,"div",24)(8,"button",25),p("click",function(){m(e);let o=c(2);return _(o.closePair())}),r(9,"Cancel"),i(),t(10,"button",26),p("click",function(){m(e);let o=c(2);return _(o.verifyPin())}),r(11," Verify "),i()()}if(a&2){let e=c(2);s(5),h("ngModel",e.pairPin),s(),C(e.error()?6:-1),s(4),w("disabled",!e.pairPin||e.saving())}}function q(a,n){if(a&1){let e=u();t(0,"div",29),r(1,"Device paired successfully!"),i(),t(2,"div",30)(3,"button",3),p("click",function(){m(e);let o=c(2);return _(o.closePair())}),r(4,"Done"),i()()}}function Y(a,n){if(a&1){let e=u();t(0,"div",17),p("click",function(o){m(e);let d=c();return _(d.onOverlay(o))}),t(1,"div",18)(2,"h2"),r(3),i(),x(4,R,12,3)(5,q,5,0),i()()}if(a&2){let e,l=c();s(3),f("Pair: ",(e=l.pairDevice())==null?null:e.name),s(),C(l.pairStep()==="waiting"?4:5)}}function G(a,n){a&1&&(t(0,"p",8),r(1,"Searching for new devices..."),i())}function J(a,n){a&1&&(t(0,"h2"),r(1,"News Devices Found"),i())}function K(a,n){if(a&1){let e=u();t(0,"li")(1,"strong"),r(2,"Hostname:"),i(),r(3),i(),t(4,"li")(5,"strong"),r(6,"IP Address:"),i(),r(7),i(),t(8,"li",31)(9,"button",25),p("click",function(){m(e);let o=c(2);return _(o.dismissNewDevice())}),r(10,"Dismiss"),i(),t(11,"button",3),p("click",function(){let o=m(e).$implicit,d=c(2);return _(d.openAddFromDiscovery(o))}),r(12,"Add Device"),i()()}if(a&2){let e=n.$implicit;s(3),f(" ",e.hostname||"Unknown"),s(4),f(" ",e.ip_address)}}function Q(a,n){if(a&1){let e=u();t(0,"div",17),p("click",function(o){m(e);let d=c();return _(d.onOverlay(o))}),t(1,"div",18),x(2,G,2,0,"p",8)(3,J,2,0,"h2"),t(4,"ul"),y(5,K,13,2,null,null,W),t(7,"li"),E(8,"br"),i()(),t(9,"button",3),p("click",function(){m(e);let o=c();return _(o.closeDiscovery())}),r(10,"Close"),i()()()}if(a&2){let e=c();s(2),C(e.discovering&&!e.newDevices().length?2:3),s(3),S(e.newDevices())}}var O=class a{api=k(P);stream=k(St);timer=null;events=null;devices=v([]);showForm=v(!1);editDevice=v(null);saving=v(!1);error=v("");newDevices=v([]);newDevice=v(!1);showPairModal=v(!1);pairDevice=v(null);pairStep=v("waiting");pairPin="";discovering=!1;form={device_id:"",name:"",ip_address:""};ngOnInit(){this.loadDevices(),this.stream.start(),this.events=this.stream.events.subscribe(n=>this.onEvent(n)),this.timer=setInterval(()=>{this.stream.connected()||this.loadDevices()},1e4)}ngOnDestroy(){this.timer&&clearInterval(this.timer),this.events?.unsubscribe()}onEvent(n){if(n.t==="hello")n.resync&&this.loadDevices();else if(n.t==="device"){let e=Sv(this.devices(),n);e?this.devices.set(e):this.loadDevices()}}loadDevices(){this.api.getDevices().subscribe({next:n=>this.devices.set(n.devices||[])})}openAdd(){this.form={device_id:"",name:"",ip_address:""},this.editDevice.set(null),this.error.set(""),this.newDevice.set(!1),this.showForm.set(!0)}openEdit(n){this.form={device_id:n.device_id,name:n.name,ip_address:n.ip_address},this.editDevice.set(n),this.error.set(""),this.showForm.set(!0)}closeForm(){this.showForm.set(!1),this.editDevice.set(null)}listNewDevices(){let n=this;this.discovering||(this.discovering=!0,this.api.discover().subscribe({next:e=>{n.newDevices.set(e.devices||[]),n.discovering=!1},error:e=>{}}),this.showForm.set(!1),this.editDevice.set(null),this.error.set(""),this.newDevice.set(!0))}save(){if(!this.form.device_id||!this.form.name||!this.form.ip_address){this.error.set("All fields are required.");return}this.saving.set(!0),this.error.set(""),(this.editDevice()?this.api.updateDevice(this.form.device_id,this.form):this.api.createDevice(this.form)).subscribe({next:()=>{this.saving.set(!1),this.closeForm(),this.loadDevices()},error:e=>{this.saving.set(!1),this.error.set(e.error?.detail||"Failed to save.")}})}remove(n){confirm(`Delete "${n.name}"? This cannot be undone.`)&&this.api.deleteDevice(n.device_id).subscribe({next:()=>this.loadDevices()})}startPair(n){this.pairDevice.set(n),this.pairStep.set("waiting"),this.pairPin="",this.error.set(""),this.showPairModal.set(!0),this.api.startPairing(n.device_id).subscribe({error:e=>this.error.set(e.error?.detail||"Failed to start pairing.")})}verifyPin(){let n=this.pairDevice();!n||!this.pairPin||(this.saving.set(!0),this.error.set(""),this.api.verifyPairing(n.device_id,this.pairPin).subscribe({next:()=>{this.saving.set(!1),this.pairStep.set("done"),this.loadDevices()},error:e=>{this.saving.set(!1),this.error.set(e.error?.detail||"PIN verification failed.")}}))}unpair(n){confirm(`Unpair "${n.name}"?`)&&this.api.resetPairing(n.device_id).subscribe({next:()=>this.loadDevices()})}closePair(){this.showPairModal.set(!1),this.pairDevice.set(null)}openAddFromDiscovery(n){this.form={device_id:"",name:n.hostname||"",ip_address:n.ip_address},this.editDevice.set(null),this.error.set(""),this.newDevice.set(!1),this.showForm.set(!0)}dismissNewDevice(){}closeDiscovery(){this.newDevice.set(!1)}onOverlay(n){n.target.classList.contains("modal-overlay")&&(this.closeForm(),this.closePair())}static \u0275fac=function(e){return new(e||a)};static \u0275cmp=M({type:a,selectors:[["app-devices"]],decls:31,vars:4,consts:[[1,"card"],[1,"header"],[1,"btn","btn-primary",2,"margin-right","10px",3,"click"],[1,"btn","btn-primary",3,"click"],[1,"modal-overlay"],[1,"dot"],[1,"device-link",3,"click"],[1,"device-id"],[1,"muted"],[1,"badge"],[1,"actions"],[1,"btn","btn-primary","btn-sm"],[1,"btn","btn-secondary","btn-sm"],[1,"btn","btn-danger","btn-sm",3,"click"],[1,"btn","btn-primary","btn-sm",3,"click"],[1,"btn","btn-secondary","btn-sm",3,"click"],["colspan","6",1,"empty"],[1,"modal-overlay",3,"click"],[1,"modal"],[1,"form-group"],["type","text","placeholder","living_room",3,"ngModelChange","ngModel","disabled"],["type","text","placeholder","Living Room Fire TV",3,"ngModelChange","ngModel"],["type","text","placeholder","192.168.2.xxx",3,"ngModelChange","ngModel"],[1,"error-msg"],[1,"btn-row"],[1,"btn","btn-secondary",3,"click"],[1,"btn","btn-primary",3,"click","disabled"],[1,"form-group",2,"margin-top","16px"],["type","text","placeholder","Enter PIN from TV",3,"ngModelChange","ngModel"],[1,"success-msg"],[1,"btn-row",2,"margin-top","16px"],[2,"display","flex","gap","8px","margin-top","16px"]],template:function(e,l){e&1&&(t(0,"div",0)(1,"div",1)(2,"h1"),r(3,"Devices"),i(),t(4,"div")(5,"button",2),p("click",function(){return l.listNewDevices()}),r(6,"Discover"),i(),t(7,"button",3),p("click",function(){return l.openAdd()}),r(8,"Add Device"),i()()(),t(9,"table")(10,"thead")(11,"tr")(12,"th"),r(13,"Status"),i(),t(14,"th"),r(15,"Device"),i(),t(16,"th"),r(17,"IP Address"),i(),t(18,"th"),r(19,"Paired"),i(),t(20,"th"),r(21,"ADB"),i(),t(22,"th"),r(23,"Actions"),i()()(),t(24,"tbody"),y(25,j,21,16,"tr",null,A,!1,U,3,0,"tr"),i()()(),x(28,z,22,8,"div",4),x(29,Y,6,2,"div",4),x(30,Q,11,1,"div",4)),e&2&&(s(25),S(l.devices()),s(3),C(l.showForm()?28:-1),s(),C(l.showPairModal()?29:-1),s(),C(l.newDevice()?30:-1))},dependencies:[N,T,F,I],styles:[".header[_ngcontent-%COMP%]{display:flex;justify-content:space-between;align-items:center;margin-bottom:20px}h1[_ngcontent-%COMP%]{font-size:22px;font-weight:600}.device-link[_ngcontent-%COMP%]{color:var(--accent);cursor:pointer;text-decoration:none}.device-link[_ngcontent-%COMP%]:hover{text-decoration:underline}.device-id[_ngcontent-%COMP%]{font-size:12px;color:var(--text-muted)}.muted[_ngcontent-%COMP%]{color:var(--text-muted)}.actions[_ngcontent-%COMP%]{display:flex;gap:4px}.empty[_ngcontent-%COMP%]{text-align:center;color:var(--text-muted);padding:40px 0!important}.btn-row[_ngcontent-%COMP%]{display:flex;justify-content:flex-end;gap:8px;margin-top:20px}"]})};export{O as DevicesComponent};
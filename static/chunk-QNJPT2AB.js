@@ -0,0 +1 @@
+import{I as c}from"./chunk-3C5URT7C.js";var l=class s{socket=null;deviceId="";keys=new Set;next=1;pending=new Map;retry=null;open(e){if(this.close(),!e||typeof WebSocket>"u")return;this.deviceId=e;let t=location.protocol==="https:"?"wss:":"ws:",n=new WebSocket(`${t}//${location.host}/api/remote?device=${encodeURIComponent(e)}`);n.onmessage=o=>this.dispatch(o.data),n.onclose=()=>{this.socket===n&&(this.socket=null,this.failPending("Connection closed"),this.retry=setTimeout(()=>this.open(this.deviceId),3e3))},this.socket=n}close(){this.retry&&clearTimeout(this.retry),this.retry=null;let e=this.socket;this.socket=null,e?.close(),this.failPending("Connection closed"),this.keys.clear()}press(e){if(this.socket?.readyState!==WebSocket.OPEN||!this.keys.has(e))return null;let t=this.next;return this.next=this.next%65535+1,this.socket.send(`${t} ${e}`),new Promise(n=>this.pending.set(t,n))}dispatch(e){let t;try{t=JSON.parse(e)}catch{return}if(t.t==="hello")this.keys=new Set(t.keys||[]);else if(t.t==="ack"){let n=this.pending.get(t.n);this.pending.delete(t.n),n?.(t)}}failPending(e){for(let[t,n]of this.pending)n({n:t,ok:!1,error:e});this.pending.clear()}static \u0275fac=function(t){return new(t||s)};static \u0275prov=c({token:s,factory:s.\u0275fac,providedIn:"root"})};export{l as a};
@@ -0,0 +1 @@
+import{a as P,b as O,c as D,d as F,e as I,f as A,g as N}from"./chunk-QIDQYIKN.js";import"./chunk-G5Q6IVPP.js";import{a as R}from"./chunk-4KT5IJ7H.js";import{a as Rs}from"./chunk-QNJPT2AB.js";import{$a as E,Ha as x,Ia as C,Ja as b,Ka as f,La as g,Ma as n,N as M,Na as i,Ra as v,S as l,Sa as d,T as s,Ta as c,Xa as S,Ya as T,Za as a,_a as w,ba as u,bb as k,cb as h,db as y,na as m,ya as V}from"./chunk-3C5URT7C.js";var z=(p,o)=>o.device_id,B=(p,o)=>o.package;function L(p,o){if(p&1&&(n(0,"option",4),a(1),i()),p&2){let e=o.$implicit;g("value",e.device_id),m(),w(e.name)}}function j(p,o){if(p&1){let e=v();n(0,"button",21),d("click",function(){let t=l(e).$implicit,_=c(3);return s(_.launchApp(t))}),a(1),i()}if(p&2){let e=o.$implicit,r=c(3);S("background",r.getColor(e.package)),m(),E(" ",e.name," ")}}function K(p,o){if(p&1&&(n(0,"div",0)(1,"h3"),a(2,"Quick Launch"),i(),n(3,"div",19),b(4,j,2,3,"button",20,B),i()()),p&2){let e=c(2);m(4),f(e.favoriteApps())}}function H(p,o){if(p&1&&(n(0,"div",22),a(1),i()),p&2){let e=c(2);T("error",e.feedbackError()),m(),w(e.feedback())}}function Q(p,o){if(p&1){let e=v();x(0,K,6,0,"div",0),n(1,"div",6)(2,"div",7)(3,"div",8)(4,"button",9),d("click",function(){l(e);let t=c();return s(t.nav("dpad_up"))}),a(5,"\u25B2"),i()(),n(6,"div",8)(7,"button",9),d("click",function(){l(e);let t=c();return s(t.nav("dpad_left"))}),a(8,"\u25C0"),i(),n(9,"button",10),d("click",function(){l(e);let t=c();return s(t.nav("select"))}),a(10,"OK"),i(),n(11,"button",9),d("click",function(){l(e);let t=c();return s(t.nav("dpad_right"))}),a(12,"\u25B6"),i()(),n(13,"div",8)(14,"button",9),d("click",function(){l(e);let t=c();return s(t.nav("dpad_down"))}),a(15,"\u25BC"),i()(),n(16,"div",11)(17,"button",12),d("click",function(){l(e);let t=c();return s(t.nav("back"))}),a(18,"Back"),i(),n(19,"button",12),d("click",function(){l(e);let t=c();return s(t.nav("home"))}),a(20,"Home"),i(),n(21,"button",12),d("click",function(){l(e);let t=c();return s(t.nav("menu"))}),a(22,"Menu"),i()()(),n(23,"div",0)(24,"h3"),a(25,"Power"),i(),n(26,"div",13)(27,"button",14),d("click",function(){l(e);let t=c();return s(t.nav("wake"))}),a(28,"Wake"),i(),n(29,"button",12),d("click",function(){l(e);let t=c();return s(t.nav("sleep"))}),a(30,"Sleep"),i()()(),n(31,"div",0)(32,"h3"),a(33,"Media"),i(),n(34,"div",13)(35,"button",12),d("click",function(){l(e);let t=c();return s(t.media("play"))}),a(36,"Play"),i(),n(37,"button",12),d("click",function(){l(e);let t=c();return s(t.media("pause"))}),a(38,"Pause"),i(),n(39,"button",12),d("click",function(){l(e);let t=c();return s(t.media("scan_forward"))}),a(40,"FF"),i(),n(41,"button",12),d("click",function(){l(e);let t=c();return s(t.media("scan_backward"))}),a(42,"RW"),i()()(),n(43,"div",0)(44,"h3"),a(45,"Volume"),i(),n(46,"div",13)(47,"button",12),d("click",function(){l(e);let t=c();return s(t.nav("volume_up"))}),a(48,"Vol +"),i(),n(49,"button",12),d("click",function(){l(e);let t=c();return s(t.nav("volume_down"))}),a(50,"Vol -"),i(),n(51,"button",12),d("click",function(){l(e);let t=c();return s(t.nav("volume_mute"))}),a(52,"Mute"),i()()(),n(53,"div",0)(54,"h3"),a(55,"Keyboard"),i(),n(56,"div",15)(57,"input",16),y("ngModelChange",function(t){l(e);let _=c();return h(_.textInput,t)||(_.textInput=t),s(t)}),d("keydown.enter",function(){l(e);let t=c();return s(t.sendText())}),i(),n(58,"button",17),d("click",function(){l(e);let t=c();return s(t.sendText())}),a(59,"Send"),i()()()(),x(60,H,2,3,"div",18)}if(p&2){let e=c();C(e.favoriteApps().length>0?0:-1),m(57),k("ngModel",e.textInput),m(),g("disabled",!e.textInput),m(2),C(e.feedback()?60:-1)}}function $(p,o){p&1&&(n(0,"div",5)(1,"p",23),a(2,"Select a device to control"),i()())}var q={"com.netflix.ninja":"#e50914","com.amazon.avod.thirdpartyclient":"#00a8e1","com.disney.disneyplus":"#113ccf","com.google.android.youtube.tv":"#ff0000","com.hulu.plus":"#1ce783","com.hbo.hbonow":"#b535f6","com.spotify.tv.android":"#1db954","com.plexapp.android":"#e5a00d","com.apple.atve.androidtv.appletv":"#555"},W=class p{api=M(R);remote=M(Rs);devices=u([]);favoriteApps=u([]);selectedDevice="";textInput="";feedback=u("");feedbackError=u(!1);ngOnInit(){this.api.getDevices().subscribe({next:o=>this.devices.set(o.devices||[])})}ngOnDestroy(){this.remote.close()}onDeviceChange(){this.favoriteApps.set([]),this.remote.open(this.selectedDevice),this.selectedDevice&&this.api.getApps(this.selectedDevice).subscribe({next:o=>{let e=o.apps||o||[];this.favoriteApps.set(e.filter(r=>r.is_favorite))}})}getColor(o){return q[o]||"var(--accent)"}launchApp(o){this.api.launchApp(this.selectedDevice,o.package).subscribe({next:()=>this.showFeedback("Launched "+o.name),error:e=>this.showFeedback(e.error?.detail||"Launch failed",!0)})}nav(o){this.selectedDevice&&(this.pressOverSocket(o)||this.api.sendNavigation(this.selectedDevice,o).subscribe({next:()=>this.showFeedback("Command sent"),error:e=>this.showFeedback(e.error?.detail||"Command failed",!0)}))}media(o){this.selectedDevice&&(this.pressOverSocket(o)||this.api.sendMedia(this.selectedDevice,o).subscribe({next:()=>this.showFeedback("Command sent"),error:e=>this.showFeedback(e.error?.detail||"Command failed",!0)}))}sendText(){!this.selectedDevice||!this.textInput||this.api.sendKeyboard(this.selectedDevice,this.textInput).subscribe({next:()=>{this.showFeedback("Text sent"),this.textInput=""},error:o=>this.showFeedback(o.error?.detail||"Send failed",!0)})}pressOverSocket(o){let e=this.remote.press(o);return e?(e.then(r=>{r.ok?this.showFeedback(`Command sent (${r.ms} ms)`):this.showFeedback(r.error||"Command failed",!0)}),!0):!1}showFeedback(o,e=!1){this.feedback.set(o),this.feedbackError.set(e),setTimeout(()=>this.feedback.set(""),2e3)}static \u0275fac=function(e){return new(e||p)};static \u0275cmp=V({type:p,selectors:[["app-remote"]],decls:11,vars:2,consts:[[1,"card"],[1,"header"],[1,"device-select",3,"ngModelChange","ngModel"],["value",""],[3,"value"],[1,"card","empty"],[1,"remote-layout"],[1,"card","remote-pad"],[1,"pad-row"],[1,"pad-btn",3,"click"],[1,"pad-btn","select-btn",3,"click"],[1,"pad-row","nav-row"],[1,"btn","btn-secondary",3,"click"],[1,"btn-group"],[1,"btn","btn-primary",3,"click"],[1,"keyboard-row"],["type","text","placeholder","Type text...",3,"ngModelChange","keydown.enter","ngModel"],[1,"btn","btn-primary",3,"click","disabled"],[1,"card","feedback",3,"error"],[1,"app-row"],[1,"app-btn",3,"background"],[1,"app-btn",3,"click"],[1,"card","feedback"],[1,"muted"]],template:function(e,r){e&1&&(n(0,"div",0)(1,"div",1)(2,"h1"),a(3,"Remote Control"),i(),n(4,"select",2),y("ngModelChange",function(_){return h(r.selectedDevice,_)||(r.selectedDevice=_),_}),d("ngModelChange",function(){return r.onDeviceChange()}),n(5,"option",3),a(6,"Select device..."),i(),b(7,L,2,2,"option",4,z),i()()(),x(9,Q,61,4)(10,$,3,0,"div",5)),e&2&&(m(4),k("ngModel",r.selectedDevice),m(3),f(r.devices()),m(2),C(r.selectedDevice?9:10))},dependencies:[N,I,A,P,F,O,D],styles:[".header[_ngcontent-%COMP%]{display:flex;justify-content:space-between;align-items:center}h1[_ngcontent-%COMP%]{font-size:22px;font-weight:600}h3[_ngcontent-%COMP%]{font-size:15px;font-weight:600;color:var(--accent);margin-bottom:12px;text-transform:uppercase;letter-spacing:.5px}.device-select[_ngcontent-%COMP%]{width:auto;min-width:200px}.app-row[_ngcontent-%COMP%]{display:flex;gap:8px;flex-wrap:wrap}.app-btn[_ngcontent-%COMP%]{padding:10px 18px;border:none;border-radius:8px;color:#fff;font-weight:600;font-size:13px;cursor:pointer;transition:opacity .15s,transform .1s}.app-btn[_ngcontent-%COMP%]:hover{opacity:.85}.app-btn[_ngcontent-%COMP%]:active{transform:scale(.95)}.remote-layout[_ngcontent-%COMP%]{display:grid;grid-template-columns:1fr 1fr;gap:0}.remote-pad[_ngcontent-%COMP%]{grid-row:span 2;display:flex;flex-direction:column;align-items:center;gap:8px}.pad-row[_ngcontent-%COMP%]{display:flex;gap:8px;align-items:center}.pad-btn[_ngcontent-%COMP%]{width:56px;height:56px;border-radius:50%;border:1px solid var(--border);background:var(--bg-hover);color:var(--text);font-size:20px;cursor:pointer;transition:background .15s;display:flex;align-items:center;justify-content:center}.pad-btn[_ngcontent-%COMP%]:hover{background:var(--accent);color:#000}.pad-btn[_ngcontent-%COMP%]:active{transform:scale(.95)}.select-btn[_ngcontent-%COMP%]{background:var(--accent);color:#000;font-weight:700;font-size:14px}.nav-row[_ngcontent-%COMP%]{margin-top:16px}.btn-group[_ngcontent-%COMP%]{display:flex;gap:8px;flex-wrap:wrap}.keyboard-row[_ngcontent-%COMP%]{display:flex;gap:8px}.keyboard-row[_ngcontent-%COMP%]   input[_ngcontent-%COMP%]{flex:1}.muted[_ngcontent-%COMP%]{color:var(--text-muted)}.empty[_ngcontent-%COMP%]{text-align:center;padding:40px}.feedback[_ngcontent-%COMP%]{font-size:13px;color:var(--success)}.feedback.error[_ngcontent-%COMP%]{color:var(--error)}"]})};export{W as RemoteComponent};
@@ -1 +1 @@
-import{a as l,b as v,c as f,d as u,e as g}from"./chunk-TTKMRQAF.js";import"./chunk-G5Q6IVPP.js";import{Ma as e,Na as n,Oa as s,Za as r,aa as c,vb as d,ya as a}from"./chunk-3C5URT7C.js";var C=[{path:"",redirectTo:"dashboard",pathMatch:"full"},{path:"dashboard",loadComponent:()=>import("./chunk-WJA7NTE7.js").then(t=>t.DashboardComponent)},{path:"remote",loadComponent:()=>import("./chunk-OIUWIOGL.js").then(t=>t.RemoteComponent)},{path:"devices",loadComponent:()=>import("./chunk-YXXULPJA.js").then(t=>t.DevicesComponent)},{path:"apps",loadComponent:()=>import("./chunk-WWSWYCDP.js").then(t=>t.AppsComponent)},{path:"settings",loadComponent:()=>import("./chunk-SH7P346U.js").then(t=>t.SettingsComponent)},{path:"**",redirectTo:"dashboard"}];var b={providers:[c(),g(C),d()]};var i=class t{static \u0275fac=function(o){return new(o||t)};static \u0275cmp=a({type:t,selectors:[["app-nav-bar"]],decls:14,vars:0,consts:[[1,"nav-bar"],[1,"nav-brand"],[1,"nav-links"],["routerLink","/dashboard","routerLinkActive","active"],["routerLink","/remote","routerLinkActive","active"],["routerLink","/devices","routerLinkActive","active"],["routerLink","/apps","routerLinkActive","active"],["routerLink","/settings","routerLinkActive","active"]],template:function(o,h){o&1&&(e(0,"nav",0)(1,"div",1),r(2,"Colada Lightning"),n(),e(3,"div",2)(4,"a",3),r(5,"Dashboard"),n(),e(6,"a",4),r(7,"Remote"),n(),e(8,"a",5),r(9,"Devices"),n(),e(10,"a",6),r(11,"Apps"),n(),e(12,"a",7),r(13,"Settings"),n()()())},dependencies:[f,u],styles:[".nav-bar[_ngcontent-%COMP%]{display:flex;align-items:center;justify-content:space-between;padding:0 24px;height:56px;background:var(--bg-card);border-bottom:1px solid var(--border)}.nav-brand[_ngcontent-%COMP%]{font-size:18px;font-weight:700;color:var(--accent);letter-spacing:.5px}.nav-links[_ngcontent-%COMP%]{display:flex;gap:24px}.nav-links[_ngcontent-%COMP%]   a[_ngcontent-%COMP%]{color:var(--text-muted);text-decoration:none;font-size:14px;padding:8px 0;border-bottom:2px solid transparent;transition:color .2s,border-color .2s}.nav-links[_ngcontent-%COMP%]   a[_ngcontent-%COMP%]:hover{color:var(--text)}.nav-links[_ngcontent-%COMP%]   a.active[_ngcontent-%COMP%]{color:var(--accent);border-bottom-color:var(--accent)}"]})};var p=class t{static \u0275fac=function(o){return new(o||t)};static \u0275cmp=a({type:t,selectors:[["app-root"]],decls:3,vars:0,template:function(o,h){o&1&&(s(0,"app-nav-bar"),e(1,"main"),s(2,"router-outlet"),n())},dependencies:[v,i],styles:["[_nghost-%COMP%]{display:block;min-height:100vh;background:#121212}main[_ngcontent-%COMP%]{max-width:1200px;margin:0 auto}"]})};l(p,b).catch(t=>console.error(t));
+import{a as l,b as v,c as f,d as u,e as g}from"./chunk-TTKMRQAF.js";import"./chunk-G5Q6IVPP.js";import{Ma as e,Na as n,Oa as s,Za as r,aa as c,vb as d,ya as a}from"./chunk-3C5URT7C.js";var C=[{path:"",redirectTo:"dashboard",pathMatch:"full"},{path:"dashboard",loadComponent:()=>import("./chunk-J355CHXV.js").then(t=>t.DashboardComponent)},{path:"remote",loadComponent:()=>import("./chunk-Z4CWEEU5.js").then(t=>t.RemoteComponent)},{path:"devices",loadComponent:()=>import("./chunk-K6QRKQFW.js").then(t=>t.DevicesComponent)},{path:"apps",loadComponent:()=>import("./chunk-WWSWYCDP.js").then(t=>t.AppsComponent)},{path:"settings",loadComponent:()=>import("./chunk-SH7P346U.js").then(t=>t.SettingsComponent)},{path:"**",redirectTo:"dashboard"}];var b={providers:[c(),g(C),d()]};var i=class t{static \u0275fac=function(o){return new(o||t)};static \u0275cmp=a({type:t,selectors:[["app-nav-bar"]],decls:14,vars:0,consts:[[1,"nav-bar"],[1,"nav-brand"],[1,"nav-links"],["routerLink","/dashboard","routerLinkActive","active"],["routerLink","/remote","routerLinkActive","active"],["routerLink","/devices","routerLinkActive","active"],["routerLink","/apps","routerLinkActive","active"],["routerLink","/settings","routerLinkActive","active"]],template:function(o,h){o&1&&(e(0,"nav",0)(1,"div",1),r(2,"Colada Lightning"),n(),e(3,"div",2)(4,"a",3),r(5,"Dashboard"),n(),e(6,"a",4),r(7,"Remote"),n(),e(8,"a",5),r(9,"Devices"),n(),e(10,"a",6),r(11,"Apps"),n(),e(12,"a",7),r(13,"Settings"),n()()())},dependencies:[f,u],styles:[".nav-bar[_ngcontent-%COMP%]{display:flex;align-items:center;justify-content:space-between;padding:0 24px;height:56px;background:var(--bg-card);border-bottom:1px solid var(--border)}.nav-brand[_ngcontent-%COMP%]{font-size:18px;font-weight:700;color:var(--accent);letter-spacing:.5px}.nav-links[_ngcontent-%COMP%]{display:flex;gap:24px}.nav-links[_ngcontent-%COMP%]   a[_ngcontent-%COMP%]{color:var(--text-muted);text-decoration:none;font-size:14px;padding:8px 0;border-bottom:2px solid transparent;transition:color .2s,border-color .2s}.nav-links[_ngcontent-%COMP%]   a[_ngcontent-%COMP%]:hover{color:var(--text)}.nav-links[_ngcontent-%COMP%]   a.active[_ngcontent-%COMP%]{color:var(--accent);border-bottom-color:var(--accent)}"]})};var p=class t{static \u0275fac=function(o){return new(o||t)};static \u0275cmp=a({type:t,selectors:[["app-root"]],decls:3,vars:0,template:function(o,h){o&1&&(s(0,"app-nav-bar"),e(1,"main"),s(2,"router-outlet"),n())},dependencies:[v,i],styles:["[_nghost-%COMP%]{display:block;min-height:100vh;background:#121212}main[_ngcontent-%COMP%]{max-width:1200px;margin:0 auto}"]})};l(p,b).catch(t=>console.error(t));
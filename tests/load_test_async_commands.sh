@@ -0,0 +1,129 @@
+#!/bin/bash
+# ==============================================================================
+# HMS FireTV - Async Command Load Test
+# ==============================================================================
+#
+# Verifies the HTTP server stays responsive while Fire TVs time out.
+#
+# Registers a device at an unroutable IP, floods every command endpoint with
+# concurrent requests (each waits for the Fire TV timeout), and meanwhile
+# measures /health latency. Before the async conversion, THREAD_NUM blocked
+# commands froze the whole server; now /health must stay fast.
+#
+# Usage:
+#   ./tests/load_test_async_commands.sh [base_url] [concurrency] [max_health_ms]
+#
+# Set RESULTS_FILE to append one line per run (date, host, cores, commit,
+# concurrency, /health p50/max, total) for the commit or PR description.
+#
+# Prerequisites:
+#   1. HMS FireTV service running (./build/hms_firetv)
+#   2. curl installed
+#
+
+BASE_URL="${1:-http://localhost:8888}"
+CONCURRENCY="${2:-64}"
+MAX_HEALTH_MS="${3:-500}"
+DEVICE_ID="loadtest_$(date +%s)"
+BLACKHOLE_IP="10.255.255.1"   # Unroutable: every Fire TV call hits the timeout
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+pass() {
+    echo -e "${GREEN}✓ PASS${NC}: $1"
+}
+
+fail() {
+    echo -e "${RED}✗ FAIL${NC}: $1"
+    cleanup
+    exit 1
+}
+
+info() {
+    echo -e "${YELLOW}➜${NC} $1"
+}
+
+cleanup() {
+    curl -s -o /dev/null -X DELETE "$BASE_URL/api/devices/$DEVICE_ID"
+}
+
+echo "================================================================================================="
+echo "HMS FireTV Async Command Load Test"
+echo "================================================================================================="
+echo "  Base URL:       $BASE_URL"
+echo "  Concurrency:    $CONCURRENCY in-flight commands"
+echo "  Health budget:  ${MAX_HEALTH_MS}ms"
+echo ""
+
+# ==============================================================================
+# Setup
+# ==============================================================================
+info "Registering unreachable device $DEVICE_ID ($BLACKHOLE_IP)"
+status=$(curl -s -o /dev/null -w "%{http_code}" -X POST "$BASE_URL/api/devices" \
+    -H "Content-Type: application/json" \
+    -d "{\"device_id\":\"$DEVICE_ID\",\"name\":\"Load Test\",\"ip_address\":\"$BLACKHOLE_IP\"}")
+[ "$status" == "201" ] || [ "$status" == "200" ] || fail "Could not create device (HTTP $status)"
+
+# ==============================================================================
+# Flood command endpoints
+# ==============================================================================
+ENDPOINTS=(
+    "navigate|{\"action\":\"home\"}"
+    "media|{\"action\":\"play\"}"
+    "volume|{\"action\":\"volume_up\"}"
+    "app|{\"package\":\"com.netflix.ninja\"}"
+    "text|{\"text\":\"load test\"}"
+)
+
+info "Sending $CONCURRENCY concurrent commands"
+start_ns=$(date +%s%N)
+pids=()
+for i in $(seq 1 "$CONCURRENCY"); do
+    entry="${ENDPOINTS[$((i % ${#ENDPOINTS[@]}))]}"
+    path="${entry%%|*}"
+    body="${entry#*|}"
+    curl -s -o /dev/null -X POST "$BASE_URL/api/devices/$DEVICE_ID/$path" \
+        -H "Content-Type: application/json" -d "$body" &
+    pids+=($!)
+done
+
+# ==============================================================================
+# Measure responsiveness while commands are pending
+# ==============================================================================
+sleep 0.2
+samples=()
+for i in $(seq 1 20); do
+    t=$(curl -s -o /dev/null -w "%{time_total}" "$BASE_URL/health")
+    samples+=("$(awk "BEGIN { printf \"%.1f\", $t * 1000 }")")
+    sleep 0.1
+done
+sorted=$(printf '%s\n' "${samples[@]}" | sort -n)
+p50_ms=$(echo "$sorted" | sed -n "$(( (${#samples[@]} + 1) / 2 ))p")
+max_ms=$(echo "$sorted" | tail -1)
+info "/health latency under load: p50 ${p50_ms}ms, max ${max_ms}ms (${#samples[@]} samples)"
+
+wait "${pids[@]}"
+total_ms=$(( ($(date +%s%N) - start_ns) / 1000000 ))
+info "All $CONCURRENCY commands completed in ${total_ms}ms"
+
+cleanup
+
+if [ -n "$RESULTS_FILE" ]; then
+    echo "$(date -u +%Y-%m-%dT%H:%M:%SZ) host=$(hostname -s) cores=$(nproc)" \
+         "commit=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)" \
+         "concurrency=$CONCURRENCY health_p50_ms=$p50_ms health_max_ms=$max_ms" \
+         "commands_total_ms=$total_ms" >> "$RESULTS_FILE"
+    info "Recorded in $RESULTS_FILE"
+fi
+
+# ==============================================================================
+# Verdict
+# ==============================================================================
+if awk "BEGIN { exit !($max_ms <= $MAX_HEALTH_MS) }"; then
+    pass "/health stayed under ${MAX_HEALTH_MS}ms while $CONCURRENCY commands timed out"
+else
+    fail "/health took ${max_ms}ms (budget ${MAX_HEALTH_MS}ms) — IO threads are blocked"
+fi
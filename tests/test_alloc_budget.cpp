@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "clients/LightningStep.h"
+#include "database/SQLiteDatabase.h"
+#include "mqtt/CommandTopic.h"
+#include "utils/AllocTracker.h"
+#include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+
+using namespace hms_firetv;
+
+// Built with HMS_ALLOC_TRACKING (see tests/CMakeLists.txt). Budgets are
+// heap allocations per call on the calling thread, set a little above what
+// the code does today: a change that makes a hot path allocate more fails
+// here. Lower a budget when you make a path cheaper; raise one only with a
+// reason in the commit.
+namespace budget {
+constexpr uint64_t MQTT_PRESS_TO_STEP = 8;      // 6: Json payload members + compiled request
+constexpr uint64_t MQTT_JSON_PARSE = 32;        // 27: jsoncpp reader and stream for a small object
+constexpr uint64_t SQLITE_GET_DEVICE = 4;       // 1: the tags vector (short strings stay inline; sqlite uses malloc)
+} // namespace budget
+
+namespace {
+
+// Allocations made by one call, after a warm-up call (function-local
+// statics, metric series, thread-locals)
+template <typename F>
+uint64_t allocationsOf(F&& f) {
+    f();
+    AllocScope scope("test");
+    f();
+    return scope.counts().allocations;
+}
+
+} // namespace
+
+TEST(AllocBudgetTest, CountsOnlyTheScopesThread) {
+    ASSERT_TRUE(AllocTracker::enabled());
+    AllocTracker::getInstance().reset();
+    uint64_t expected = 0;
+    {
+        AllocScope scope("test.thread");
+        std::thread([] { delete new std::string(100, 'x'); }).join();
+        uint64_t thread_state = scope.counts().allocations;
+        EXPECT_LE(thread_state, 1u);   // std::thread's own state, not the string
+        auto* value = new int(7);
+        expected = thread_state + 1;
+        EXPECT_EQ(scope.counts().allocations, expected);
+        EXPECT_GE(scope.counts().bytes, sizeof(int));
+        delete value;
+        scope.setType("test", "renamed");
+    }
+
+    auto json = AllocTracker::getInstance().toJson();
+    EXPECT_TRUE(json["enabled"].asBool());
+    ASSERT_TRUE(json["types"].isMember("test.renamed"));
+    EXPECT_EQ(json["types"]["test.renamed"]["requests"].asUInt64(), 1u);
+    EXPECT_EQ(json["types"]["test.renamed"]["allocations"].asUInt64(), expected);
+    EXPECT_GE(json["process"]["allocations"].asUInt64(), expected);
+}
+
+TEST(AllocBudgetTest, MqttButtonPressToLightningStep) {
+    const std::string topic = "maestro_hub/colada/living_room/dpad_up";
+    const std::string payload = "PRESS";
+    std::string error;
+    auto allocations = allocationsOf([&] {
+        auto message = CommandTopic::parse(topic, payload, error);
+        auto step = LightningStep::compile(message->payload, error);
+        ASSERT_TRUE(step.has_value()) << error;
+    });
+    EXPECT_LE(allocations, budget::MQTT_PRESS_TO_STEP);
+}
+
+TEST(AllocBudgetTest, MqttJsonCommandParse) {
+    const std::string topic = "maestro_hub/colada/living_room/navigate";
+    const std::string payload = R"({"command":"navigate","action":"select","request_id":"42"})";
+    std::string error;
+    auto allocations = allocationsOf([&] {
+        auto message = CommandTopic::parse(topic, payload, error);
+        ASSERT_TRUE(message.has_value()) << error;
+    });
+    EXPECT_LE(allocations, budget::MQTT_JSON_PARSE);
+}
+
+TEST(AllocBudgetTest, MetricsRecordingDoesNotAllocate) {
+    auto allocations = allocationsOf([] {
+        Metrics::recordCommand("living_room", "navigate", true, std::chrono::microseconds(1500));
+        Metrics::recordMqttMessage(true, 64);
+    });
+    EXPECT_EQ(allocations, 0u);
+}
+
+TEST(AllocBudgetTest, DisabledLogLevelDoesNotAllocate) {
+    Logger::getInstance().setLevel(LogLevel::Info);
+    std::string device_id = "living_room";
+    auto allocations = allocationsOf([&] {
+        LOG_DEBUG("CommandHandler") << "Handling command for " << device_id;
+    });
+    EXPECT_EQ(allocations, 0u);
+}
+
+TEST(AllocBudgetTest, SQLiteDeviceLookup) {
+    std::string path = "/tmp/hms_firetv_test_alloc_" + std::to_string(::getpid()) + ".db";
+    std::remove(path.c_str());
+    {
+        SQLiteDatabase db(path);
+        ASSERT_TRUE(db.connect());
+        Device device;
+        device.device_id = "living_room";
+        device.name = "Living Room TV";
+        device.ip_address = "192.168.1.50";
+        device.api_key = "0987654321";
+        device.status = "online";
+        device.tags = {"lobby"};
+        ASSERT_TRUE(db.createDevice(device));
+
+        const std::string device_id = "living_room";
+        auto allocations = allocationsOf([&] {
+            auto found = db.getDeviceById(device_id);
+            ASSERT_TRUE(found.has_value());
+        });
+        EXPECT_LE(allocations, budget::SQLITE_GET_DEVICE);
+    }
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
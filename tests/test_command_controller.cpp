@@ -3,6 +3,9 @@
 #include "repositories/DeviceRepository.h"
 #include "services/DatabaseService.h"
 #include <drogon/drogon.h>
+#include <chrono>
+#include <future>
+#include <thread>
 
 using namespace hms_firetv;
 using namespace drogon;
@@ -36,6 +39,8 @@ protected:
 
     void TearDown() override {
         try {
+            DatabaseService::getInstance().executeQuery(
+                "DELETE FROM command_history WHERE device_id LIKE 'unittest_%'");
             std::string cleanup = "DELETE FROM fire_tv_devices WHERE device_id LIKE 'unittest_%'";
             DatabaseService::getInstance().executeQuery(cleanup);
         } catch (...) {}
@@ -64,7 +69,74 @@ TEST_F(CommandControllerTest, GetHistoryReturnsValidResponse) {
     EXPECT_TRUE(response_data["history"].isArray());
 }
 
+// Test: A single REST command reports its latency breakdown and stores it
+TEST_F(CommandControllerTest, NavigateRecordsTimingBreakdown) {
+    // Nothing listens on the Lightning port: the command fails fast but is still timed
+    Device device;
+    device.device_id = "unittest_timing_device";
+    device.name = "Unit Test Timing Device";
+    device.ip_address = "127.0.0.1";
+    device.api_key = "test_key";
+    device.status = "online";
+    device.adb_enabled = false;
+    DeviceRepository::getInstance().createDevice(device);
+
+    CommandController controller;
+    auto parse = [](const HttpResponsePtr& resp) {
+        Json::Value json;
+        Json::Reader reader;
+        reader.parse(std::string(resp->getBody()), json);
+        return json;
+    };
+
+    Json::Value body;
+    body["action"] = "home";
+    auto done = std::make_shared<std::promise<Json::Value>>();
+    auto future = done->get_future();
+    controller.navigate(HttpRequest::newHttpJsonRequest(body), [done, parse](const HttpResponsePtr& resp) {
+        done->set_value(parse(resp));
+    }, device.device_id);
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    auto response = future.get();
+    ASSERT_TRUE(response.isMember("timing"));
+    EXPECT_TRUE(response["timing"].isMember("queue_ms"));
+    EXPECT_TRUE(response["timing"].isMember("round_trip_ms"));
+    EXPECT_FALSE(response["timing"].isMember("transfer_ms"));  // HttpClient has no phases
+
+    // History rows are written by the background logger
+    Json::Value entry;
+    for (int i = 0; i < 50 && entry.isNull(); i++) {
+        controller.getHistory(HttpRequest::newHttpRequest(), [&entry, parse](const HttpResponsePtr& resp) {
+            auto history = parse(resp)["history"];
+            if (!history.empty()) {
+                entry = history[0];
+            }
+        }, device.device_id);
+        if (entry.isNull()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    ASSERT_FALSE(entry.isNull());
+    EXPECT_EQ(entry["command_type"].asString(), "navigation");
+    EXPECT_TRUE(entry["timing"].isMember("queue_ms"));
+    EXPECT_FALSE(entry["timing"].isMember("transfer_ms"));
+    EXPECT_TRUE(entry.isMember("response_time_ms"));  // The round trip
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
+
+    // Async commands complete on Drogon's event loop
+    std::promise<void> started;
+    std::thread loop([&started]() {
+        app().getLoop()->queueInLoop([&started]() { started.set_value(); });
+        app().run();
+    });
+    started.get_future().wait();
+
+    int result = RUN_ALL_TESTS();
+    app().getLoop()->queueInLoop([]() { app().quit(); });
+    loop.join();
+    return result;
 }
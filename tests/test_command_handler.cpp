@@ -5,6 +5,7 @@
 #include "services/DatabaseService.h"
 #include <thread>
 #include <chrono>
+#include <future>
 
 using namespace hms_firetv;
 
@@ -187,6 +188,56 @@ TEST_F(CommandHandlerTest, HandleCommand_HandlesMissingCommandField) {
     SUCCEED() << "Missing command field handled gracefully";
 }
 
+// Test: macros are queued on MacroRunner; the result arrives on the callback
+TEST_F(CommandHandlerTest, HandleCommand_QueuesMacroWithoutBlocking) {
+    Json::Value payload;
+    payload["command"] = "macro";
+    payload["steps"] = Json::arrayValue;
+    Json::Value step;
+    step["command"] = "delay";
+    step["ms"] = 300;
+    payload["steps"].append(step);
+    step["ms"] = 10;  // A trailing delay is skipped
+    payload["steps"].append(step);
+
+    std::promise<SequenceResult> done;
+    auto start = std::chrono::steady_clock::now();
+    bool queued = handler->handleCommand(test_device_id, payload, nullptr,
+        [&done](const SequenceResult& result) { done.set_value(result); });
+    auto returned_after = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(queued);
+    EXPECT_LT(returned_after, std::chrono::milliseconds(200));
+
+    auto future = done.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    SequenceResult result = future.get();
+    EXPECT_TRUE(result.success);
+    ASSERT_EQ(result.steps.size(), 2u);
+    EXPECT_GE(result.total_ms, 300);
+}
+
+// Test: a macro for an unknown device reports the error on the callback
+TEST_F(CommandHandlerTest, HandleCommand_MacroReportsMissingDevice) {
+    Json::Value payload;
+    payload["command"] = "macro";
+    payload["steps"] = Json::arrayValue;
+    Json::Value step;
+    step["command"] = "delay";
+    step["ms"] = 10;
+    payload["steps"].append(step);
+
+    std::promise<SequenceResult> done;
+    handler->handleCommand("nonexistent_device_xyz", payload, nullptr,
+        [&done](const SequenceResult& result) { done.set_value(result); });
+
+    auto future = done.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    SequenceResult result = future.get();
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(result.error.value_or(""), "Device not found");
+}
+
 // Test: handleCommand handles navigation commands
 TEST_F(CommandHandlerTest, HandleCommand_RoutesNavigationCommands) {
     Json::Value payload;
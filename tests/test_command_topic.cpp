@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "mqtt/CommandTopic.h"
+
+using namespace hms_firetv;
+
+TEST(CommandTopicTest, ExtractsDeviceId) {
+    EXPECT_EQ(CommandTopic::deviceId("maestro_hub/colada/living_room/dpad_up"), "living_room");
+    EXPECT_EQ(CommandTopic::deviceId("maestro_hub/colada/living_room"), "");
+    EXPECT_EQ(CommandTopic::deviceId("homeassistant/button/x/config"), "");
+}
+
+TEST(CommandTopicTest, MapsButtonPresses) {
+    std::string error;
+    auto nav = CommandTopic::parse("maestro_hub/colada/living_room/dpad_left", "PRESS", error);
+    ASSERT_TRUE(nav.has_value());
+    EXPECT_EQ(nav->device_id, "living_room");
+    EXPECT_EQ(nav->action, "dpad_left");
+    EXPECT_EQ(nav->payload["command"].asString(), "navigate");
+    EXPECT_EQ(nav->payload["direction"].asString(), "left");
+
+    auto sleep = CommandTopic::parse("maestro_hub/colada/living_room/sleep", "PRESS", error);
+    ASSERT_TRUE(sleep.has_value());
+    EXPECT_EQ(sleep->payload["command"].asString(), "turn_off");
+
+    EXPECT_FALSE(CommandTopic::parse("maestro_hub/colada/living_room/bogus", "PRESS", error));
+    EXPECT_EQ(error, "Unknown button action: bogus");
+}
+
+TEST(CommandTopicTest, MapsHoldTextAndMacro) {
+    std::string error;
+    auto hold = CommandTopic::parse("maestro_hub/colada/tv/select", "HOLD", error);
+    ASSERT_TRUE(hold.has_value());
+    EXPECT_EQ(hold->payload["action"].asString(), "select");
+    EXPECT_TRUE(hold->payload["hold"].asBool());
+
+    auto text = CommandTopic::parse("maestro_hub/colada/tv/send_text", "{not json", error);
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(text->payload["command"].asString(), "send_text");
+    EXPECT_EQ(text->payload["text"].asString(), "{not json");
+
+    auto macro = CommandTopic::parse("maestro_hub/colada/tv/macro", "movie_night", error);
+    ASSERT_TRUE(macro.has_value());
+    EXPECT_EQ(macro->payload["name"].asString(), "movie_night");
+}
+
+TEST(CommandTopicTest, FallsBackToJsonBody) {
+    std::string error;
+    auto json = CommandTopic::parse("maestro_hub/colada/tv/cmd",
+                                    R"({"command":"media","action":"play_pause"})", error);
+    ASSERT_TRUE(json.has_value());
+    EXPECT_EQ(json->payload["action"].asString(), "play_pause");
+
+    EXPECT_FALSE(CommandTopic::parse("maestro_hub/colada/tv/cmd", "{broken", error));
+    EXPECT_EQ(error.rfind("JSON parse error", 0), 0u);
+    EXPECT_FALSE(CommandTopic::parse("other/topic", "PRESS", error));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "utils/CpuProfiler.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <pthread.h>
+#include <sstream>
+#include <thread>
+
+using namespace hms_firetv;
+
+namespace {
+
+CpuProfiler::Options enabledOptions() {
+    CpuProfiler::Options options;
+    options.enabled = true;
+    options.max_duration = std::chrono::seconds(5);
+    return options;
+}
+
+// Waits for the profile from the profiler's thread
+struct Result {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    CpuProfiler::Profile profile;
+
+    CpuProfiler::Done callback() {
+        return [this](CpuProfiler::Profile p) {
+            std::lock_guard<std::mutex> lock(mutex);
+            profile = std::move(p);
+            done = true;
+            cv.notify_all();
+        };
+    }
+
+    bool wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(10), [this] { return done; });
+    }
+};
+
+std::atomic<uint64_t> sink{0};
+
+__attribute__((noinline)) void burnCpu(std::chrono::milliseconds duration) {
+    auto end = std::chrono::steady_clock::now() + duration;
+    uint64_t x = 1;
+    while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 1000; i++) {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+    }
+    sink += x;
+}
+
+} // namespace
+
+TEST(CpuProfilerTest, RefusesWhenDisabledOrOutOfRange) {
+    CpuProfiler disabled(CpuProfiler::Options{});
+    std::string error;
+    EXPECT_FALSE(disabled.start(std::chrono::milliseconds(100), 99, [](CpuProfiler::Profile) {}, error));
+    EXPECT_NE(error.find("PROFILER_ENABLED"), std::string::npos);
+
+    CpuProfiler profiler(enabledOptions());
+    EXPECT_FALSE(profiler.start(std::chrono::seconds(6), 99, [](CpuProfiler::Profile) {}, error));
+    EXPECT_FALSE(profiler.start(std::chrono::milliseconds(100), 0, [](CpuProfiler::Profile) {}, error));
+    EXPECT_FALSE(profiler.running());
+}
+
+TEST(CpuProfilerTest, SamplesBusyThreadIntoFoldedStacks) {
+    CpuProfiler profiler(enabledOptions());
+    Result result;
+    std::string error;
+
+    std::thread burner([] {
+        pthread_setname_np(pthread_self(), "burner");
+        burnCpu(std::chrono::milliseconds(600));
+    });
+    ASSERT_TRUE(profiler.start(std::chrono::milliseconds(400), 200, result.callback(), error)) << error;
+    EXPECT_TRUE(profiler.running());
+
+    // One profile at a time
+    std::string busy;
+    EXPECT_FALSE(profiler.start(std::chrono::milliseconds(100), 99, [](CpuProfiler::Profile) {}, busy));
+
+    ASSERT_TRUE(result.wait());
+    burner.join();
+    EXPECT_FALSE(profiler.running());
+
+    const auto& profile = result.profile;
+    EXPECT_EQ(profile.hz, 200);
+    EXPECT_GE(profile.samples, 20u);   // ~80 expected for 400ms of one busy core
+
+    // Every line is "thread;frames... count" and the counts add up
+    uint64_t total = 0;
+    bool saw_burner = false;
+    std::istringstream folded(profile.folded());
+    std::string line;
+    while (std::getline(folded, line)) {
+        size_t space = line.rfind(' ');
+        ASSERT_NE(space, std::string::npos) << line;
+        total += std::stoull(line.substr(space + 1));
+        if (line.rfind("burner;", 0) == 0) {
+            saw_burner = true;
+        }
+    }
+    EXPECT_EQ(total, profile.samples);
+    EXPECT_TRUE(saw_burner);
+
+    auto json = profile.toJson(5);
+    EXPECT_EQ(json["samples"].asUInt64(), profile.samples);
+    EXPECT_LE(json["top"].size(), 5u);
+    EXPECT_GT(json["top"][0]["self_samples"].asUInt64(), 0u);
+}
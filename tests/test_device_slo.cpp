@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "services/DeviceSloTracker.h"
+#include <string>
+#include <vector>
+
+using namespace hms_firetv;
+using namespace std::chrono_literals;
+
+namespace {
+
+DeviceSloTracker::Options testOptions() {
+    DeviceSloTracker::Options options;
+    options.window = 60s;
+    options.slots = 6;            // 10s slots
+    options.max_p95 = 500ms;
+    options.max_error_rate = 0.10;
+    options.min_samples = 10;
+    return options;
+}
+
+// Fixed origin on a slot boundary, so tests control which slot a sample lands in
+DeviceSloTracker::Clock::time_point origin() {
+    return DeviceSloTracker::Clock::time_point(std::chrono::hours(24));
+}
+
+struct Alerts {
+    std::vector<DeviceSloTracker::Snapshot> received;
+
+    DeviceSloTracker::AlertListener listener() {
+        return [this](const DeviceSloTracker::Snapshot& snapshot) { received.push_back(snapshot); };
+    }
+};
+
+} // namespace
+
+TEST(DeviceSloTrackerTest, SummarizesWindowPercentilesAndErrors) {
+    DeviceSloTracker tracker(testOptions());
+    auto t0 = origin();
+    for (int i = 0; i < 19; i++) {
+        tracker.recordCommand("living_room", true, 100ms, t0);
+    }
+    tracker.recordCommand("living_room", false, 2s, t0 + 1s);
+    tracker.recordProbe("living_room", true, 50ms, t0 + 2s);
+    tracker.recordProbe("living_room", false, 3s, t0 + 2s);
+
+    auto snapshot = tracker.snapshot("living_room", t0 + 5s);
+    EXPECT_EQ(snapshot.commands, 20u);
+    EXPECT_EQ(snapshot.errors, 1u);
+    EXPECT_EQ(snapshot.probes, 2u);
+    EXPECT_EQ(snapshot.probe_failures, 1u);
+    EXPECT_DOUBLE_EQ(snapshot.error_rate, 0.05);
+
+    // Bucket upper bounds: within 25% above the true value
+    EXPECT_GE(snapshot.p50_ms, 100.0);
+    EXPECT_LE(snapshot.p50_ms, 125.0);
+    EXPECT_LE(snapshot.p95_ms, 125.0);   // 20 of 21 timed samples are 100ms or less
+    EXPECT_GE(snapshot.p99_ms, 2000.0);
+
+    auto unknown = tracker.snapshot("bedroom", t0);
+    EXPECT_EQ(unknown.commands, 0u);
+    EXPECT_EQ(unknown.state, DeviceSloTracker::State::Ok);
+}
+
+TEST(DeviceSloTrackerTest, OldSlotsLeaveTheWindow) {
+    DeviceSloTracker tracker(testOptions());
+    auto t0 = origin();
+    tracker.recordCommand("living_room", false, 100ms, t0);
+    tracker.recordCommand("living_room", true, 100ms, t0 + 30s);
+
+    EXPECT_EQ(tracker.snapshot("living_room", t0 + 59s).commands, 2u);
+    EXPECT_EQ(tracker.snapshot("living_room", t0 + 60s).commands, 1u);   // First slot expired
+    EXPECT_EQ(tracker.snapshot("living_room", t0 + 60s).errors, 0u);
+
+    // Writing into a reused slot starts it from zero
+    tracker.recordCommand("living_room", true, 100ms, t0 + 61s);
+    auto snapshot = tracker.snapshot("living_room", t0 + 61s);
+    EXPECT_EQ(snapshot.commands, 2u);
+    EXPECT_EQ(snapshot.errors, 0u);
+}
+
+TEST(DeviceSloTrackerTest, SlowDeviceIsDegradedAndRecoversWithHysteresis) {
+    DeviceSloTracker tracker(testOptions());
+    Alerts alerts;
+    tracker.setAlertListener(alerts.listener());
+    auto t0 = origin();
+
+    // Too few samples to judge
+    for (int i = 0; i < 5; i++) {
+        tracker.recordCommand("living_room", true, 900ms, t0);
+    }
+    tracker.evaluate(t0 + 1s);
+    EXPECT_TRUE(alerts.received.empty());
+
+    for (int i = 0; i < 10; i++) {
+        tracker.recordCommand("living_room", true, 900ms, t0 + 1s);
+        tracker.recordCommand("bedroom", true, 80ms, t0 + 1s);
+    }
+    tracker.evaluate(t0 + 2s);
+    ASSERT_EQ(alerts.received.size(), 1u);
+    EXPECT_EQ(alerts.received[0].device_id, "living_room");
+    EXPECT_EQ(alerts.received[0].state, DeviceSloTracker::State::Degraded);
+    ASSERT_EQ(alerts.received[0].reasons.size(), 1u);
+    EXPECT_NE(alerts.received[0].reasons[0].find("p95"), std::string::npos);
+
+    // Still degraded: no repeat alert
+    tracker.evaluate(t0 + 3s);
+    EXPECT_EQ(alerts.received.size(), 1u);
+
+    // Just under the objective is not enough to recover (needs < 80%)
+    auto t1 = t0 + 60s;
+    for (int i = 0; i < 20; i++) {
+        tracker.recordCommand("living_room", true, 450ms, t1);
+    }
+    tracker.evaluate(t1 + 1s);
+    EXPECT_EQ(alerts.received.size(), 1u);
+    EXPECT_EQ(tracker.snapshot("living_room", t1 + 1s).state, DeviceSloTracker::State::Degraded);
+
+    auto t2 = t1 + 60s;
+    for (int i = 0; i < 20; i++) {
+        tracker.recordCommand("living_room", true, 100ms, t2);
+    }
+    tracker.evaluate(t2 + 1s);
+    ASSERT_EQ(alerts.received.size(), 2u);
+    EXPECT_EQ(alerts.received[1].state, DeviceSloTracker::State::Ok);
+    EXPECT_TRUE(alerts.received[1].reasons.empty());
+    EXPECT_EQ(tracker.stats()["alerts"].asUInt64(), 2u);
+}
+
+TEST(DeviceSloTrackerTest, ErrorRateBreachAndStandbyProbes) {
+    DeviceSloTracker tracker(testOptions());
+    Alerts alerts;
+    tracker.setAlertListener(alerts.listener());
+    auto t0 = origin();
+
+    // A TV in standby fails every probe: not an error
+    for (int i = 0; i < 30; i++) {
+        tracker.recordProbe("bedroom", false, 2s, t0);
+    }
+    for (int i = 0; i < 16; i++) {
+        tracker.recordCommand("living_room", true, 50ms, t0);
+    }
+    for (int i = 0; i < 4; i++) {
+        tracker.recordCommand("living_room", false, 50ms, t0);
+    }
+    tracker.evaluate(t0 + 1s);
+
+    ASSERT_EQ(alerts.received.size(), 1u);
+    EXPECT_EQ(alerts.received[0].device_id, "living_room");
+    EXPECT_DOUBLE_EQ(alerts.received[0].error_rate, 0.20);
+    ASSERT_EQ(alerts.received[0].reasons.size(), 1u);
+    EXPECT_NE(alerts.received[0].reasons[0].find("error rate"), std::string::npos);
+
+    auto json = tracker.toJson(t0 + 1s);
+    EXPECT_EQ(json["living_room"]["state"].asString(), "degraded");
+    EXPECT_EQ(json["bedroom"]["state"].asString(), "ok");
+    EXPECT_EQ(json["bedroom"]["probe_failures"].asUInt64(), 30u);
+
+    // Window empties: the alert clears, and idle devices are dropped
+    tracker.evaluate(t0 + 2min);
+    ASSERT_EQ(alerts.received.size(), 2u);
+    EXPECT_EQ(alerts.received[1].state, DeviceSloTracker::State::Ok);
+    tracker.evaluate(t0 + 2min);
+    EXPECT_EQ(tracker.stats()["devices"].asInt(), 0);
+}
+
+TEST(DeviceSloTrackerTest, EvaluatorThreadStartsAndStops) {
+    auto options = testOptions();
+    options.eval_interval = std::chrono::seconds(1);
+    DeviceSloTracker tracker(options);
+    tracker.start();
+    tracker.start();   // Idempotent
+    tracker.recordCommand("living_room", true, 10ms);
+    tracker.stop();
+    tracker.stop();
+    EXPECT_EQ(tracker.snapshot("living_room").commands, 1u);
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "models/Device.h"
+
+using namespace hms_firetv;
+
+TEST(DeviceTagsTest, ParseTrimsLowercasesAndDeduplicates) {
+    auto tags = Device::parseTags(" Lobby, floor2 ,,LOBBY,bar ");
+    ASSERT_EQ(tags.size(), 3u);
+    EXPECT_EQ(tags[0], "lobby");
+    EXPECT_EQ(tags[1], "floor2");
+    EXPECT_EQ(tags[2], "bar");
+
+    EXPECT_TRUE(Device::parseTags("").empty());
+    EXPECT_TRUE(Device::parseTags(" , ").empty());
+}
+
+TEST(DeviceTagsTest, AcceptsArrayOrCommaSeparatedJson) {
+    Json::Value array(Json::arrayValue);
+    array.append("Lobby");
+    array.append("floor2");
+    array.append(7);  // Non-strings are ignored
+
+    Device device;
+    device.tags = Device::tagsFromJson(array);
+    EXPECT_EQ(device.tagsString(), "lobby,floor2");
+    EXPECT_EQ(Device::tagsFromJson(Json::Value("lobby, floor2")), device.tags);
+    EXPECT_TRUE(Device::tagsFromJson(Json::Value()).empty());
+}
+
+TEST(DeviceTagsTest, RoundTripsThroughJson) {
+    Device device;
+    device.device_id = "lobby_tv";
+    device.tags = {"lobby", "floor2"};
+
+    auto json = device.toJson();
+    ASSERT_TRUE(json["tags"].isArray());
+    EXPECT_EQ(json["tags"].size(), 2u);
+
+    auto parsed = Device::fromJson(json);
+    EXPECT_TRUE(parsed.hasTag("lobby"));
+    EXPECT_TRUE(parsed.hasTag("floor2"));
+    EXPECT_FALSE(parsed.hasTag("Lobby"));  // Stored lowercase; callers normalize first
+}
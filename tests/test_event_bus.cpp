@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "services/EventBus.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace hms_firetv;
+
+namespace {
+
+Json::Value parse(const std::string& payload) {
+    Json::Value json;
+    Json::CharReaderBuilder reader;
+    std::string error;
+    std::istringstream stream(payload);
+    EXPECT_TRUE(Json::parseFromStream(reader, stream, &json, &error)) << error;
+    return json;
+}
+
+struct Received {
+    std::vector<EventBus::Event> events;
+
+    EventBus::Subscriber subscriber() {
+        return [this](const EventBus::Event& event) { events.push_back(event); };
+    }
+
+    Json::Value json(size_t i) const { return parse(*events.at(i).payload); }
+};
+
+} // namespace
+
+TEST(EventBusTest, FansOutOneSerializedPayload) {
+    EventBus bus;
+    Received first, second;
+    bus.subscribe(first.subscriber());
+    bus.subscribe(second.subscriber());
+
+    Json::Value fields;
+    fields["event"] = "scan";
+    fields["found"] = 3;
+    uint64_t seq = bus.publish("discovery", fields);
+
+    ASSERT_EQ(first.events.size(), 1u);
+    ASSERT_EQ(second.events.size(), 1u);
+    EXPECT_EQ(first.events[0].payload, second.events[0].payload);   // Same buffer
+    EXPECT_EQ(first.events[0].seq, seq);
+
+    auto json = first.json(0);
+    EXPECT_EQ(json["t"].asString(), "discovery");
+    EXPECT_EQ(json["seq"].asUInt64(), seq);
+    EXPECT_EQ(json["found"].asInt(), 3);
+    EXPECT_EQ(first.events[0].payload->find('\n'), std::string::npos);   // Compact
+}
+
+TEST(EventBusTest, DeviceStatePublishesOnlyChangedFields) {
+    EventBus bus;
+    Received received;
+    bus.subscribe(received.subscriber());
+
+    Json::Value online;
+    online["status"] = "online";
+    bus.deviceState("living_room", online);
+    bus.deviceState("living_room", online);   // Unchanged: nothing
+    bus.deviceState("living_room", online);
+    ASSERT_EQ(received.events.size(), 1u);
+    EXPECT_EQ(received.json(0)["id"].asString(), "living_room");
+    EXPECT_EQ(received.json(0)["status"].asString(), "online");
+
+    Json::Value update;
+    update["status"] = "online";
+    update["ip_address"] = "192.168.2.50";
+    bus.deviceState("living_room", update);
+    ASSERT_EQ(received.events.size(), 2u);
+    auto delta = received.json(1);
+    EXPECT_EQ(delta["ip_address"].asString(), "192.168.2.50");
+    EXPECT_FALSE(delta.isMember("status"));
+
+    // Deleting forgets the state: the next update is published in full
+    bus.deviceLifecycle("living_room", "deleted");
+    ASSERT_EQ(received.events.size(), 3u);
+    EXPECT_EQ(received.json(2)["change"].asString(), "deleted");
+    bus.deviceState("living_room", online);
+    EXPECT_EQ(received.events.size(), 4u);
+}
+
+TEST(EventBusTest, CommandResults) {
+    EventBus bus;
+    Received received;
+    bus.subscribe(received.subscriber());
+
+    bus.commandResult("bedroom", "navigation", true, std::chrono::microseconds(84500), "rest");
+    ASSERT_EQ(received.events.size(), 1u);
+    auto json = received.json(0);
+    EXPECT_EQ(json["t"].asString(), "command");
+    EXPECT_EQ(json["id"].asString(), "bedroom");
+    EXPECT_EQ(json["cmd"].asString(), "navigation");
+    EXPECT_TRUE(json["ok"].asBool());
+    EXPECT_EQ(json["ms"].asInt(), 84);
+    EXPECT_EQ(json["via"].asString(), "rest");
+}
+
+TEST(EventBusTest, ReplaysMissedEventsOrAsksForResync) {
+    EventBus bus(4);
+    Received received;
+    uint64_t id = bus.subscribe(received.subscriber());
+
+    for (int i = 0; i < 6; i++) {
+        bus.publish("discovery", Json::Value());
+    }
+    EXPECT_EQ(bus.lastSeq(), 6u);
+
+    auto missed = bus.since(3);
+    ASSERT_TRUE(missed.has_value());
+    ASSERT_EQ(missed->size(), 3u);
+    EXPECT_EQ(missed->front().seq, 4u);
+    EXPECT_EQ(missed->back().seq, 6u);
+
+    EXPECT_TRUE(bus.since(2).has_value());    // Oldest retained is 3
+    EXPECT_FALSE(bus.since(1).has_value());   // 2 has been dropped
+    EXPECT_TRUE(bus.since(6)->empty());
+    EXPECT_FALSE(bus.since(99).has_value());  // Sequence from before a restart
+
+    // Published with nobody subscribed: not retained, so everyone resyncs
+    bus.unsubscribe(id);
+    bus.publish("discovery", Json::Value());
+    EXPECT_EQ(received.events.size(), 6u);
+    EXPECT_FALSE(bus.since(6).has_value());
+    EXPECT_TRUE(bus.since(7)->empty());
+    EXPECT_EQ(bus.stats()["retained"].asUInt64(), 0u);
+}
+
+TEST(EventBusTest, SubscriberMayUnsubscribeWhileBeingCalled) {
+    EventBus bus;
+    Received other;
+    uint64_t self = 0;
+    int calls = 0;
+    self = bus.subscribe([&](const EventBus::Event&) {
+        calls++;
+        bus.unsubscribe(self);   // A connection closing during its own send
+    });
+    bus.subscribe(other.subscriber());
+
+    bus.publish("discovery", Json::Value());
+    bus.publish("discovery", Json::Value());
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(other.events.size(), 2u);
+    EXPECT_EQ(bus.stats()["subscribers"].asUInt64(), 1u);
+}
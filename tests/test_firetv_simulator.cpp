@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "LatencyModel.h"
+#include "VirtualFleet.h"
+
+using namespace hms_firetv::simulator;
+using namespace std::chrono_literals;
+
+namespace {
+
+VirtualFleet::Request request(VirtualFleet::Endpoint endpoint, const std::string& argument = "") {
+    VirtualFleet::Request req;
+    req.endpoint = endpoint;
+    req.api_key = "0987654321";
+    req.argument = argument;
+    return req;
+}
+
+} // namespace
+
+TEST(LatencyModelTest, ParsesSpecs) {
+    std::string error;
+    std::mt19937_64 rng(1);
+
+    auto fixed = LatencyModel::parse("25", error);
+    ASSERT_TRUE(fixed.has_value());
+    EXPECT_EQ(fixed->sample(rng), 25ms);
+
+    auto uniform = LatencyModel::parse("uniform:10:20", error);
+    ASSERT_TRUE(uniform.has_value());
+    for (int i = 0; i < 100; i++) {
+        auto sample = uniform->sample(rng);
+        EXPECT_GE(sample, 10ms);
+        EXPECT_LE(sample, 20ms);
+    }
+
+    EXPECT_TRUE(LatencyModel::parse("lognormal:25:0.4", error).has_value());
+    EXPECT_FALSE(LatencyModel::parse("uniform:20:10", error).has_value());
+    EXPECT_FALSE(LatencyModel::parse("gamma:1:2", error).has_value());
+    EXPECT_FALSE(LatencyModel::parse("normal:40", error).has_value());
+    EXPECT_FALSE(LatencyModel::parse("fixed:abc", error).has_value());
+}
+
+TEST(VirtualFleetTest, GeneratesConsecutiveAddresses) {
+    auto ips = VirtualFleet::ipRange("127.0.1.254", 3);
+    ASSERT_EQ(ips.size(), 3u);
+    EXPECT_EQ(ips[0], "127.0.1.254");
+    EXPECT_EQ(ips[2], "127.0.2.0");
+    EXPECT_THROW(VirtualFleet::ipRange("not-an-ip", 1), std::invalid_argument);
+    EXPECT_THROW(VirtualFleet::ipRange("255.255.255.255", 2), std::invalid_argument);
+}
+
+TEST(VirtualFleetTest, SleepsAndWakes) {
+    std::string error;
+    VirtualFleet::Options options;
+    options.latency = *LatencyModel::parse("5", error);
+    options.wake_latency = *LatencyModel::parse("2000", error);
+    options.sleep_after = 10s;
+    VirtualFleet fleet(options, {"127.0.1.1"});
+    auto t0 = VirtualFleet::Clock::now();
+
+    EXPECT_TRUE(fleet.acceptsConnection("127.0.1.1", t0));
+    EXPECT_FALSE(fleet.acceptsConnection("127.0.1.2", t0));
+
+    auto reply = fleet.lightning("127.0.1.1", request(VirtualFleet::Endpoint::Navigate, "dpad_up"), t0);
+    EXPECT_EQ(reply.status, 200);
+    EXPECT_EQ(reply.delay, 5ms);
+
+    // Idle past sleep_after: refuses connections, hangs requests on old ones
+    auto t1 = t0 + 11s;
+    EXPECT_FALSE(fleet.acceptsConnection("127.0.1.1", t1));
+    EXPECT_TRUE(fleet.lightning("127.0.1.1", request(VirtualFleet::Endpoint::Status), t1).hang);
+    EXPECT_NE(fleet.dialStatus("127.0.1.1", t1).body.find("stopped"), std::string::npos);
+
+    // Wake takes wake_latency
+    EXPECT_EQ(fleet.wake("127.0.1.1", t1).status, 201);
+    EXPECT_FALSE(fleet.acceptsConnection("127.0.1.1", t1 + 1s));
+    EXPECT_TRUE(fleet.acceptsConnection("127.0.1.1", t1 + 2s));
+
+    // The sleep action turns it off at once
+    fleet.lightning("127.0.1.1", request(VirtualFleet::Endpoint::Navigate, "sleep"), t1 + 3s);
+    EXPECT_FALSE(fleet.acceptsConnection("127.0.1.1", t1 + 3s));
+
+    auto stats = fleet.stats(t1 + 3s);
+    EXPECT_EQ(stats["wakes"].asUInt64(), 1u);
+    EXPECT_EQ(stats["sleeps"].asUInt64(), 2u);
+}
+
+TEST(VirtualFleetTest, PairsWithPinAndRequiresToken) {
+    VirtualFleet::Options options;
+    options.require_token = true;
+    options.pin = "1234";
+    VirtualFleet fleet(options, {"127.0.1.1"});
+    const std::string ip = "127.0.1.1";
+
+    auto bad_key = request(VirtualFleet::Endpoint::Navigate, "home");
+    bad_key.api_key = "wrong";
+    EXPECT_EQ(fleet.lightning(ip, bad_key).status, 401);
+    EXPECT_EQ(fleet.lightning(ip, request(VirtualFleet::Endpoint::Navigate, "home")).status, 401);
+
+    EXPECT_EQ(fleet.lightning(ip, request(VirtualFleet::Endpoint::PinDisplay, "HMS")).status, 200);
+    EXPECT_EQ(fleet.pin(ip).value(), "1234");
+    EXPECT_EQ(fleet.lightning(ip, request(VirtualFleet::Endpoint::PinVerify, "0000")).status, 400);
+
+    auto verified = fleet.lightning(ip, request(VirtualFleet::Endpoint::PinVerify, "1234"));
+    ASSERT_EQ(verified.status, 200);
+    std::string token = fleet.toJson()[0]["client_token"].asString();
+    ASSERT_FALSE(token.empty());
+    EXPECT_NE(verified.body.find(token), std::string::npos);
+
+    auto paired = request(VirtualFleet::Endpoint::App, "com.netflix.ninja");
+    paired.client_token = token;
+    EXPECT_EQ(fleet.lightning(ip, paired).status, 200);
+    EXPECT_EQ(fleet.toJson()[0]["foreground_app"].asString(), "com.netflix.ninja");
+}
+
+TEST(VirtualFleetTest, InjectsFaultsAtConfiguredRates) {
+    VirtualFleet::Options options;
+    options.error_rate = 0.2;
+    options.hang_rate = 0.1;
+    options.asleep_fraction = 0.5;
+    std::vector<std::string> ips = VirtualFleet::ipRange("127.0.1.1", 4);
+    VirtualFleet fleet(options, ips);
+    EXPECT_EQ(fleet.stats()["awake"].asUInt64(), 2u);
+
+    int errors = 0, hangs = 0;
+    const int total = 10000;
+    for (int i = 0; i < total; i++) {
+        auto reply = fleet.lightning(ips[3], request(VirtualFleet::Endpoint::Navigate, "select"));
+        errors += reply.status == 500 ? 1 : 0;
+        hangs += reply.hang ? 1 : 0;
+    }
+    EXPECT_NEAR(errors / static_cast<double>(total), 0.2, 0.02);
+    EXPECT_NEAR(hangs / static_cast<double>(total), 0.1, 0.02);
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include "services/KeyRepeatService.h"
+#include "utils/TimerWheel.h"
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hms_firetv;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * Counts presses; completes them at once unless `hold_callbacks` is set
+ */
+struct FakeRemote {
+    std::atomic<int> presses{0};
+    std::atomic<bool> hold_callbacks{false};
+    std::mutex mutex;
+    std::vector<KeyRepeatService::SendCallback> held;
+    std::vector<std::string> paths;
+
+    KeyRepeatService::Sender sender() {
+        return [this](const Device&, const LightningStep& step, KeyRepeatService::SendCallback done) {
+            presses++;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                paths.push_back(step.path);
+                if (hold_callbacks) {
+                    held.push_back(std::move(done));
+                    return;
+                }
+            }
+            done(true);
+        };
+    }
+};
+
+KeyRepeatService::Options fastOptions() {
+    KeyRepeatService::Options options;
+    options.initial_delay = 40ms;
+    options.interval = 20ms;
+    options.watchdog = 1000ms;
+    options.tick = 2ms;
+    return options;
+}
+
+Device tv(const std::string& id = "tv1") {
+    Device device;
+    device.device_id = id;
+    device.ip_address = "127.0.0.1";
+    return device;
+}
+
+LightningStep key(const std::string& direction) {
+    Json::Value payload;
+    payload["direction"] = direction;
+    std::string error;
+    auto step = KeyRepeatService::navigationStep(payload, error);
+    EXPECT_TRUE(step.has_value()) << error;
+    return step.value_or(LightningStep());
+}
+
+} // namespace
+
+// ============================================================================
+// TIMER WHEEL
+// ============================================================================
+
+TEST(TimerWheelTest, FiresInOrderAndNeverEarly) {
+    TimerWheel wheel(1ms, 8);  // Small wheel: 30ms wraps around it several times
+    wheel.start();
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::promise<void> done;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::chrono::milliseconds> late(3);
+
+    for (int i : {2, 0, 1}) {
+        auto delay = std::chrono::milliseconds(10 + i * 10);
+        wheel.schedule(delay, [&, i, delay] {
+            std::lock_guard<std::mutex> lock(mutex);
+            late[i] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start) - delay;
+            order.push_back(i);
+            if (order.size() == 3) {
+                done.set_value();
+            }
+        });
+    }
+
+    ASSERT_EQ(done.get_future().wait_for(1s), std::future_status::ready);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    for (auto lateness : late) {
+        EXPECT_GE(lateness.count(), 0);
+    }
+}
+
+TEST(TimerWheelTest, CancelledTimerDoesNotFire) {
+    TimerWheel wheel(1ms);
+    wheel.start();
+
+    std::atomic<bool> fired{false};
+    auto id = wheel.schedule(20ms, [&] { fired = true; });
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(id));
+    std::this_thread::sleep_for(50ms);
+    EXPECT_FALSE(fired);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheelTest, EarlierTimerWakesASleepingWheel) {
+    TimerWheel wheel(1ms, 8);
+    wheel.start();
+    std::this_thread::sleep_for(30ms);  // Idle across several revolutions
+
+    // The thread sleeps until the 1s timer; the 10ms one must cut that short
+    wheel.schedule(1s, [] {});
+    std::promise<void> fired;
+    auto start = std::chrono::steady_clock::now();
+    wheel.schedule(10ms, [&fired] { fired.set_value(); });
+
+    ASSERT_EQ(fired.get_future().wait_for(500ms), std::future_status::ready);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, 10ms);
+    EXPECT_LT(elapsed, 200ms);
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+// ============================================================================
+// KEY REPEAT
+// ============================================================================
+
+TEST(KeyRepeatServiceTest, HoldPressesAtOnceThenRepeatsUntilRelease) {
+    FakeRemote remote;
+    KeyRepeatService service(remote.sender(), fastOptions());
+
+    EXPECT_EQ(service.hold(tv(), key("down")), KeyRepeatService::HoldState::Started);
+    EXPECT_EQ(remote.presses, 1);
+
+    std::this_thread::sleep_for(150ms);
+    auto summary = service.release("tv1");
+    ASSERT_TRUE(summary.has_value());
+    EXPECT_GE(summary->repeats, 3u);
+    EXPECT_EQ(summary->key, "dpad_down");
+
+    int after_release = remote.presses;
+    std::this_thread::sleep_for(60ms);
+    EXPECT_EQ(remote.presses, after_release);
+    EXPECT_FALSE(service.release("tv1").has_value());
+}
+
+TEST(KeyRepeatServiceTest, WatchdogReleasesWithoutHeartbeat) {
+    FakeRemote remote;
+    auto options = fastOptions();
+    options.watchdog = 100ms;
+    KeyRepeatService service(remote.sender(), options);
+
+    service.hold(tv(), key("up"));
+    std::this_thread::sleep_for(250ms);
+
+    EXPECT_FALSE(service.isHolding("tv1"));
+    EXPECT_EQ(service.stats()["watchdog_releases"].asUInt64(), 1u);
+}
+
+TEST(KeyRepeatServiceTest, HeartbeatKeepsTheHoldAlive) {
+    FakeRemote remote;
+    auto options = fastOptions();
+    options.watchdog = 100ms;
+    KeyRepeatService service(remote.sender(), options);
+
+    service.hold(tv(), key("up"));
+    for (int i = 0; i < 5; i++) {
+        std::this_thread::sleep_for(50ms);
+        EXPECT_EQ(service.hold(tv(), key("up")), KeyRepeatService::HoldState::Refreshed);
+    }
+    EXPECT_TRUE(service.isHolding("tv1"));
+    EXPECT_EQ(service.stats()["watchdog_releases"].asUInt64(), 0u);
+}
+
+TEST(KeyRepeatServiceTest, HoldingAnotherKeyReplacesTheFirst) {
+    FakeRemote remote;
+    KeyRepeatService service(remote.sender(), fastOptions());
+
+    service.hold(tv(), key("up"));
+    EXPECT_EQ(service.hold(tv(), key("left")), KeyRepeatService::HoldState::Replaced);
+    std::this_thread::sleep_for(100ms);
+    service.release("tv1");
+
+    std::lock_guard<std::mutex> lock(remote.mutex);
+    ASSERT_GE(remote.paths.size(), 3u);
+    for (size_t i = 1; i < remote.paths.size(); i++) {
+        EXPECT_EQ(remote.paths[i], remote.paths[1]);  // Only "left" after the switch
+    }
+}
+
+TEST(KeyRepeatServiceTest, SlowDeviceSkipsRepeatsInsteadOfQueueing) {
+    FakeRemote remote;
+    remote.hold_callbacks = true;  // First press never completes
+    KeyRepeatService service(remote.sender(), fastOptions());
+
+    service.hold(tv(), key("right"));
+    std::this_thread::sleep_for(150ms);
+
+    EXPECT_EQ(remote.presses, 1);
+    EXPECT_GE(service.stats()["skipped"].asUInt64(), 3u);
+    service.release("tv1");
+
+    // Completing after release is harmless
+    std::lock_guard<std::mutex> lock(remote.mutex);
+    for (auto& done : remote.held) {
+        done(true);
+    }
+}
@@ -0,0 +1,481 @@
+#include <gtest/gtest.h>
+#include "clients/LightningClientPool.h"
+#include <curl/curl.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hms_firetv;
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+/**
+ * In-memory device table standing in for DeviceRepository
+ */
+class FakeDevices {
+public:
+    void set(const std::string& device_id, const std::string& ip, const std::string& token = "") {
+        std::lock_guard<std::mutex> lock(mutex_);
+        devices_[device_id] = LightningClientSpec{ip, "0987654321", token};
+    }
+
+    void remove(const std::string& device_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        devices_.erase(device_id);
+    }
+
+    int lookups() const { return lookups_.load(); }
+
+    LightningClientPool::SpecResolver resolver() {
+        return [this](const std::string& device_id) -> std::optional<LightningClientSpec> {
+            lookups_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = devices_.find(device_id);
+            if (it == devices_.end()) {
+                return std::nullopt;
+            }
+            return it->second;
+        };
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, LightningClientSpec> devices_;
+    std::atomic<int> lookups_{0};
+};
+
+class LightningClientPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        devices_.set("living_room", "192.168.2.10", "token_a");
+        devices_.set("bedroom", "192.168.2.11");
+    }
+
+    FakeDevices devices_;
+};
+
+// ============================================================================
+// BASIC LEASING
+// ============================================================================
+
+TEST_F(LightningClientPoolTest, LeaseBuildsClientFromDeviceSpec) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    auto client = pool.lease("living_room");
+    ASSERT_TRUE(client);
+    EXPECT_EQ(client.spec().ip_address, "192.168.2.10");
+    EXPECT_EQ(client->getClientToken(), "token_a");
+
+    auto stats = pool.stats("living_room");
+    EXPECT_EQ(stats.in_use, 1);
+    EXPECT_EQ(stats.idle, 0);
+}
+
+TEST_F(LightningClientPoolTest, UnknownDeviceReturnsEmptyLease) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    auto client = pool.lease("garage");
+    EXPECT_FALSE(client);
+    EXPECT_EQ(pool.stats("garage").in_use, 0);
+}
+
+TEST_F(LightningClientPoolTest, ReleasedClientIsReused) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    LightningClient* first = nullptr;
+    {
+        auto client = pool.lease("bedroom");
+        first = client.get();
+    }
+    EXPECT_EQ(pool.stats("bedroom").idle, 1);
+
+    auto again = pool.lease("bedroom");
+    EXPECT_EQ(again.get(), first);
+    EXPECT_EQ(devices_.lookups(), 1);  // Device resolved once, not per lease
+}
+
+TEST_F(LightningClientPoolTest, ConcurrentLeasesGetDistinctClients) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    auto a = pool.lease("living_room");
+    auto b = pool.lease("living_room");
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+    EXPECT_NE(a.get(), b.get());
+    EXPECT_EQ(pool.stats("living_room").in_use, 2);
+}
+
+TEST_F(LightningClientPoolTest, MoveTransfersOwnership) {
+    LightningClientPool pool(1, devices_.resolver());
+
+    auto a = pool.lease("bedroom");
+    LightningClientPool::Lease b = std::move(a);
+    EXPECT_FALSE(a);
+    EXPECT_TRUE(b);
+
+    b.release();
+    b.release();  // Idempotent
+    EXPECT_EQ(pool.stats("bedroom").in_use, 0);
+    EXPECT_EQ(pool.stats("bedroom").idle, 1);
+}
+
+// ============================================================================
+// WAITER QUEUE
+// ============================================================================
+
+TEST_F(LightningClientPoolTest, WaitersAreServedInFifoOrder) {
+    LightningClientPool pool(1, devices_.resolver());
+
+    auto holder = pool.lease("living_room");
+    std::vector<int> order;
+    std::deque<LightningClientPool::Lease> held;  // References stay valid across push_back
+
+    for (int i = 0; i < 3; i++) {
+        pool.leaseAsync("living_room", [&order, &held, i](LightningClientPool::Lease lease) {
+            EXPECT_TRUE(lease);
+            order.push_back(i);
+            held.push_back(std::move(lease));
+        });
+    }
+    EXPECT_EQ(pool.stats("living_room").waiting, 3);
+    EXPECT_TRUE(order.empty());
+
+    holder.release();                 // Serves waiter 0
+    ASSERT_EQ(order.size(), 1);
+    held.back().release();            // Serves waiter 1 (nested in the callback chain)
+    held.back().release();
+    held.back().release();
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(pool.stats("living_room").waiting, 0);
+}
+
+TEST_F(LightningClientPoolTest, BlockingLeaseWaitsForRelease) {
+    LightningClientPool pool(1, devices_.resolver());
+
+    auto holder = pool.lease("bedroom");
+    std::atomic<bool> acquired{false};
+
+    std::thread waiter([&pool, &acquired]() {
+        auto client = pool.lease("bedroom");
+        acquired = static_cast<bool>(client);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(acquired.load());
+
+    holder.release();
+    waiter.join();
+    EXPECT_TRUE(acquired.load());
+}
+
+TEST_F(LightningClientPoolTest, DeletedDeviceDrainsWaiters) {
+    LightningClientPool pool(1, devices_.resolver());
+
+    auto holder = pool.lease("bedroom");
+    int empty_leases = 0;
+    for (int i = 0; i < 2; i++) {
+        pool.leaseAsync("bedroom", [&empty_leases](LightningClientPool::Lease lease) {
+            if (!lease) empty_leases++;
+        });
+    }
+
+    devices_.remove("bedroom");
+    pool.invalidate("bedroom");
+    holder.release();
+
+    EXPECT_EQ(empty_leases, 2);
+    EXPECT_EQ(pool.stats("bedroom").waiting, 0);
+}
+
+// ============================================================================
+// DEADLINES
+// ============================================================================
+
+TEST_F(LightningClientPoolTest, BlockingLeaseGivesUpAtDeadline) {
+    LightningClientPool pool(1, devices_.resolver());
+    auto holder = pool.lease("bedroom");
+    uint64_t cancelled_before = Deadline::cancelledCount(Deadline::Stage::Queue);
+
+    auto start = std::chrono::steady_clock::now();
+    auto lease = pool.lease("bedroom", Deadline::after(std::chrono::milliseconds(50)));
+    auto waited = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FALSE(lease);
+    EXPECT_TRUE(lease.deadlineExceeded());
+    EXPECT_GE(waited, std::chrono::milliseconds(50));
+    EXPECT_LT(waited, std::chrono::seconds(2));
+    EXPECT_EQ(pool.stats("bedroom").waiting, 0);  // Withdrawn from the queue
+    EXPECT_EQ(Deadline::cancelledCount(Deadline::Stage::Queue), cancelled_before + 1);
+}
+
+TEST_F(LightningClientPoolTest, ExpiredWaiterDoesNotTakeTheHandle) {
+    LightningClientPool pool(1, devices_.resolver());
+    auto holder = pool.lease("bedroom");
+
+    bool expired = false;
+    bool served = false;
+    pool.leaseAsync("bedroom", [&expired](LightningClientPool::Lease lease) {
+        expired = !lease && lease.deadlineExceeded();
+    }, Deadline::after(std::chrono::milliseconds(1)));
+    pool.leaseAsync("bedroom", [&served](LightningClientPool::Lease lease) {
+        served = static_cast<bool>(lease);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    holder.release();
+
+    EXPECT_TRUE(expired);
+    EXPECT_TRUE(served);
+}
+
+TEST_F(LightningClientPoolTest, LeasedClientCarriesDeadlineUntilReturned) {
+    LightningClientPool pool(1, devices_.resolver());
+
+    auto deadline = Deadline::after(std::chrono::seconds(5));
+    {
+        auto lease = pool.lease("bedroom", deadline);
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(lease->deadline().isSet());
+        EXPECT_FALSE(lease.deadlineExceeded());
+    }
+
+    auto again = pool.lease("bedroom");
+    EXPECT_FALSE(again->deadline().isSet());
+}
+
+TEST_F(LightningClientPoolTest, ExpiredClientFailsWithoutSending) {
+    LightningClientPool pool(1, devices_.resolver());
+    auto lease = pool.lease("bedroom");
+    lease->setDeadline(Deadline::after(std::chrono::milliseconds(0)));
+
+    auto result = lease->home();
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(result.error.value_or(""), Deadline::EXCEEDED);
+    EXPECT_EQ(result.status_code, 0);
+}
+
+// ============================================================================
+// INVALIDATION
+// ============================================================================
+
+TEST_F(LightningClientPoolTest, InvalidateRebuildsWithNewSpec) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    auto outstanding = pool.lease("living_room");
+    { auto idle = pool.lease("living_room"); }
+    EXPECT_EQ(pool.stats("living_room").idle, 1);
+
+    devices_.set("living_room", "192.168.2.99", "token_b");
+    pool.invalidate("living_room");
+    EXPECT_EQ(pool.stats("living_room").idle, 0);
+
+    auto fresh = pool.lease("living_room");
+    EXPECT_EQ(fresh.spec().ip_address, "192.168.2.99");
+    EXPECT_EQ(fresh->getClientToken(), "token_b");
+
+    // Stale handle is discarded instead of returning to the pool
+    outstanding.release();
+    EXPECT_EQ(pool.stats("living_room").idle, 0);
+}
+
+TEST_F(LightningClientPoolTest, InvalidateOnlyAffectsThatDevice) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    { auto a = pool.lease("living_room"); }
+    { auto b = pool.lease("bedroom"); }
+
+    pool.invalidate("living_room");
+    EXPECT_EQ(pool.stats("living_room").idle, 0);
+    EXPECT_EQ(pool.stats("bedroom").idle, 1);
+}
+
+TEST_F(LightningClientPoolTest, RefreshKeepsHandlesWhenNothingRelevantChanged) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    LightningClient* warm = nullptr;
+    {
+        auto client = pool.lease("bedroom");
+        warm = client.get();
+    }
+
+    // e.g. a rename: same IP, key and token
+    EXPECT_FALSE(pool.refresh("bedroom"));
+    auto again = pool.lease("bedroom");
+    EXPECT_EQ(again.get(), warm);
+}
+
+TEST_F(LightningClientPoolTest, RefreshRebuildsAfterIpMove) {
+    LightningClientPool pool(2, devices_.resolver());
+
+    { auto client = pool.lease("bedroom"); }
+    { auto client = pool.lease("living_room"); }
+
+    devices_.set("bedroom", "192.168.2.50");
+    EXPECT_TRUE(pool.refresh("bedroom"));
+    EXPECT_FALSE(pool.refresh("living_room"));
+
+    EXPECT_EQ(pool.stats("bedroom").idle, 0);
+    EXPECT_EQ(pool.stats("living_room").idle, 1);
+    EXPECT_EQ(pool.lease("bedroom").spec().ip_address, "192.168.2.50");
+}
+
+// ============================================================================
+// PRUNING
+// ============================================================================
+
+TEST_F(LightningClientPoolTest, LeasedPoolIsNeverPruned) {
+    LightningClientPool pool(1, devices_.resolver(), 1);
+
+    auto holder = pool.lease("living_room");
+    ASSERT_TRUE(holder);
+
+    // Over capacity and past the idle time: only the idle pool goes
+    ASSERT_TRUE(pool.lease("bedroom"));
+    EXPECT_EQ(pool.pruneIdle(std::chrono::milliseconds(0)), 1u);
+    EXPECT_EQ(pool.allStats().size(), 1u);
+
+    // The device still has one handle out, so the next request must wait
+    bool served = false;
+    pool.leaseAsync("living_room", [&served](LightningClientPool::Lease lease) {
+        served = static_cast<bool>(lease);
+    });
+    EXPECT_FALSE(served);
+    EXPECT_EQ(pool.stats("living_room").in_use, 1);
+    EXPECT_EQ(pool.stats("living_room").waiting, 1);
+
+    holder.release();
+    EXPECT_TRUE(served);
+}
+
+TEST_F(LightningClientPoolTest, IdlePoolIsPrunedUnderPressure) {
+    LightningClientPool pool(1, devices_.resolver(), 1);
+
+    ASSERT_TRUE(pool.lease("living_room"));
+    ASSERT_TRUE(pool.lease("bedroom"));
+
+    auto all = pool.allStats();
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_EQ(all[0].first, "bedroom");
+}
+
+TEST_F(LightningClientPoolTest, LookupDoesNotHoldThePoolLock) {
+    std::promise<void> entered;
+    std::promise<void> proceed;
+    auto proceed_future = proceed.get_future().share();
+    auto inner = devices_.resolver();
+    LightningClientPool pool(2, [&, inner](const std::string& device_id) {
+        entered.set_value();
+        proceed_future.wait();
+        return inner(device_id);
+    });
+
+    std::thread leaser([&pool]() { EXPECT_TRUE(pool.lease("bedroom")); });
+    entered.get_future().wait();
+
+    // Answered while the lookup is still running
+    EXPECT_EQ(pool.stats("bedroom").in_use, 1);
+
+    proceed.set_value();
+    leaser.join();
+    EXPECT_EQ(pool.stats("bedroom").idle, 1);
+}
+
+// ============================================================================
+// STRESS (run under -DENABLE_TSAN=ON)
+// ============================================================================
+
+TEST_F(LightningClientPoolTest, StressNeverSharesAClient) {
+    constexpr size_t kMaxParallel = 2;
+    constexpr int kThreads = 16;
+    constexpr int kIterations = 500;
+    const std::vector<std::string> ids = {"living_room", "bedroom", "office", "kitchen"};
+
+    devices_.set("office", "192.168.2.12");
+    devices_.set("kitchen", "192.168.2.13");
+    // Fewer pool slots than devices: pools are also pruned under pressure
+    LightningClientPool pool(kMaxParallel, devices_.resolver(), 2);
+
+    std::map<std::string, std::atomic<int>> active;
+    for (const auto& id : ids) active[id] = 0;
+    std::atomic<int> max_seen{0};
+    std::atomic<int> completed{0};
+    std::atomic<bool> stop_invalidator{false};
+
+    // Touch the client without synchronization: TSAN flags any sharing
+    auto use = [&](const std::string& id, LightningClientPool::Lease& lease, int i) {
+        ASSERT_TRUE(lease);
+        int now = ++active[id];
+        int prev = max_seen.load();
+        while (now > prev && !max_seen.compare_exchange_weak(prev, now)) {}
+
+        std::string token = "t" + std::to_string(i);
+        lease->setClientToken(token);
+        EXPECT_EQ(lease->getClientToken(), token);
+
+        --active[id];
+        completed++;
+    };
+
+    std::thread invalidator([&]() {
+        int n = 0;
+        while (!stop_invalidator.load()) {
+            pool.invalidate(ids[n++ % ids.size()]);
+            pool.pruneIdle(std::chrono::milliseconds(0));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; t++) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < kIterations; i++) {
+                const std::string& id = ids[(i + t) % ids.size()];
+                if (i % 2 == 0) {
+                    auto lease = pool.lease(id);
+                    use(id, lease, i);
+                } else {
+                    std::atomic<bool> done{false};
+                    pool.leaseAsync(id, [&, id, i](LightningClientPool::Lease lease) {
+                        use(id, lease, i);
+                        done = true;
+                    });
+                    while (!done.load()) std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    stop_invalidator = true;
+    invalidator.join();
+
+    EXPECT_EQ(completed.load(), kThreads * kIterations);
+    EXPECT_LE(max_seen.load(), static_cast<int>(kMaxParallel));
+    for (const auto& id : ids) {
+        auto stats = pool.stats(id);
+        EXPECT_EQ(stats.in_use, 0) << id;
+        EXPECT_EQ(stats.waiting, 0) << id;
+        EXPECT_LE(stats.idle, kMaxParallel) << id;
+    }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    ::testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+    curl_global_cleanup();
+    return result;
+}
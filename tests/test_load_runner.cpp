@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "LoadRunner.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace hms_firetv::loadgen;
+
+namespace {
+
+/**
+ * Answers every request after a fixed service time, one at a time (a
+ * single-threaded server), or fails/drops the requests `outcome` picks
+ */
+class FakeTransport : public Transport {
+public:
+    enum class Outcome { OK, ERROR, HANG };
+
+    FakeTransport(std::chrono::milliseconds service_time,
+                  std::function<Outcome(const LoadRequest&)> outcome = nullptr)
+        : service_time_(service_time), outcome_(std::move(outcome)), worker_([this] { serve(); }) {}
+
+    ~FakeTransport() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        worker_.join();
+    }
+
+    const char* name() const override { return "fake"; }
+
+    void send(const LoadRequest& request, Done done) override {
+        Outcome outcome = outcome_ ? outcome_(request) : Outcome::OK;
+        if (outcome == Outcome::HANG) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.emplace_back(std::move(done), outcome == Outcome::OK);
+        cv_.notify_all();
+    }
+
+private:
+    void serve() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) {
+                return;
+            }
+            auto [done, ok] = std::move(queue_.front());
+            queue_.erase(queue_.begin());
+            lock.unlock();
+            std::this_thread::sleep_for(service_time_);
+            done(ok, ok ? "" : "http_500");
+            lock.lock();
+        }
+    }
+
+    std::chrono::milliseconds service_time_;
+    std::function<Outcome(const LoadRequest&)> outcome_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::pair<Done, bool>> queue_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+LoadRequest request(uint64_t sequence) {
+    LoadRequest request;
+    request.device_id = "sim_" + std::to_string(sequence % 4 + 1);
+    request.command = "navigate";
+    request.action = "select";
+    request.request_id = std::to_string(sequence);
+    return request;
+}
+
+LoadRunner::Options quick(size_t connections) {
+    LoadRunner::Options options;
+    options.connections = connections;
+    options.warmup = std::chrono::milliseconds(0);
+    options.duration = std::chrono::milliseconds(600);
+    options.drain = std::chrono::milliseconds(2000);
+    return options;
+}
+
+} // namespace
+
+TEST(LoadRunnerTest, PercentileUsesNearestRank) {
+    std::vector<uint64_t> samples;
+    for (uint64_t i = 1; i <= 100; i++) {
+        samples.push_back(i);
+    }
+    EXPECT_EQ(StepResult::percentile(samples, 0.5), 50u);
+    EXPECT_EQ(StepResult::percentile(samples, 0.99), 99u);
+    EXPECT_EQ(StepResult::percentile(samples, 1.0), 100u);
+    EXPECT_EQ(StepResult::percentile(samples, 0.0), 1u);
+    EXPECT_EQ(StepResult::percentile({}, 0.5), 0u);
+}
+
+TEST(LoadRunnerTest, UnderCapacityCorrectedMatchesUncorrected) {
+    // 20 req/s against a 5ms service: never queues
+    FakeTransport transport(std::chrono::milliseconds(5));
+    LoadRunner runner(transport, request, quick(1));
+    auto result = runner.run(20);
+
+    EXPECT_GE(result.ok, 10u);
+    EXPECT_LE(result.ok, 13u);
+    EXPECT_EQ(result.errors + result.timeouts, 0u);
+    EXPECT_LT(StepResult::percentile(result.corrected_us, 0.99), 30000u);
+    EXPECT_LT(StepResult::percentile(result.corrected_us, 0.99) -
+              StepResult::percentile(result.uncorrected_us, 0.99), 20000u);
+}
+
+TEST(LoadRunnerTest, OverCapacityLatencyIsCorrectedForCoordinatedOmission) {
+    // 100 req/s intended against a 40ms service (25 req/s capacity): every
+    // request waits for its predecessor, so the backlog grows by ~30ms per
+    // request. Measured from the actual send each one still looks like 40ms.
+    FakeTransport transport(std::chrono::milliseconds(40));
+    LoadRunner runner(transport, request, quick(1));
+    auto result = runner.run(100);
+
+    ASSERT_GE(result.ok, 10u);
+    auto uncorrected = StepResult::percentile(result.uncorrected_us, 0.99);
+    auto corrected = StepResult::percentile(result.corrected_us, 0.99);
+    EXPECT_LT(uncorrected, 80000u);
+    EXPECT_GT(corrected, 3 * uncorrected);
+    EXPECT_LT(result.throughput(), 50.0);
+
+    auto json = result.toJson();
+    EXPECT_GT(json["latency_ms"]["p99"].asDouble(), json["uncorrected_latency_ms"]["p99"].asDouble());
+    EXPECT_EQ(json["connections"].asUInt64(), 1u);
+}
+
+TEST(LoadRunnerTest, CountsErrorsAndUnansweredRequestsAsTimeouts) {
+    FakeTransport transport(std::chrono::milliseconds(1), [](const LoadRequest& request) {
+        uint64_t sequence = std::stoull(request.request_id);
+        if (sequence % 10 == 3) return FakeTransport::Outcome::ERROR;
+        if (sequence == 5) return FakeTransport::Outcome::HANG;
+        return FakeTransport::Outcome::OK;
+    });
+    auto options = quick(4);
+    options.drain = std::chrono::milliseconds(100);
+    LoadRunner runner(transport, request, options);
+    auto result = runner.run(100);
+
+    EXPECT_EQ(result.timeouts, 1u);
+    EXPECT_GE(result.errors, 5u);
+    EXPECT_EQ(result.ok + result.errors + result.timeouts, result.sent);
+    EXPECT_NEAR(result.errorRate(), static_cast<double>(result.errors + 1) / result.sent, 1e-9);
+    EXPECT_EQ(result.corrected_us.size(), result.ok);
+}
+
+TEST(LoadRunnerTest, StepsAreIndependent) {
+    FakeTransport transport(std::chrono::milliseconds(2));
+    LoadRunner runner(transport, request, quick(2));
+
+    auto slow = runner.run(20);
+    auto fast = runner.run(100);
+    EXPECT_GT(fast.sent, 2 * slow.sent);
+    EXPECT_EQ(fast.ok, fast.sent);
+    EXPECT_EQ(slow.ok, slow.sent);
+}
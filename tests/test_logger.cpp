@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "utils/Logger.h"
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hms_firetv;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * Collects what the writer thread emits
+ */
+struct CapturedOutput {
+    std::mutex mutex;
+    std::string out;
+    std::string err;
+    int batches = 0;
+
+    Logger::Sink sink() {
+        return [this](bool is_error, const std::string& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            (is_error ? err : out) += batch;
+            batches++;
+        };
+    }
+
+    size_t lines() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::count(out.begin(), out.end(), '\n') + std::count(err.begin(), err.end(), '\n');
+    }
+};
+
+} // namespace
+
+TEST(LoggerTest, WritesLevelComponentAndFields) {
+    CapturedOutput output;
+    Logger logger(Logger::Options(), output.sink());
+    logger.start();
+
+    LogLine(logger, LogLevel::Info, "MQTTClient").field("device", "tv1").field("bytes", 42)
+        << "Published to " << "maestro_hub/colada/tv1/state" << std::endl;
+    LogLine(logger, LogLevel::Error, "CommandHandler") << "Wake request failed";
+    logger.flush();
+
+    EXPECT_NE(output.out.find("INFO  [MQTTClient] Published to maestro_hub/colada/tv1/state device=tv1 bytes=42\n"),
+              std::string::npos) << output.out;
+    EXPECT_NE(output.err.find("ERROR [CommandHandler] Wake request failed\n"), std::string::npos) << output.err;
+    EXPECT_EQ(output.out.find("Wake request"), std::string::npos);
+}
+
+TEST(LoggerTest, JsonFormatEscapesMessageAndFields) {
+    CapturedOutput output;
+    Logger logger(Logger::Options(), output.sink());
+    logger.setFormat(Logger::Format::Json);
+    logger.start();
+
+    LogLine(logger, LogLevel::Warn, "Pairing").field("pin", "12\"34") << "Bad \"PIN\"\n";
+    logger.flush();
+
+    EXPECT_NE(output.err.find("\"level\":\"WARN\",\"component\":\"Pairing\""), std::string::npos) << output.err;
+    EXPECT_NE(output.err.find("\"msg\":\"Bad \\\"PIN\\\"\",\"pin\":\"12\\\"34\"}\n"), std::string::npos) << output.err;
+}
+
+TEST(LoggerTest, LongMessagesAreTruncated) {
+    CapturedOutput output;
+    Logger logger(Logger::Options(), output.sink());
+
+    // Not started: written synchronously
+    LogLine(logger, LogLevel::Info, "Test") << std::string(1000, 'x');
+    EXPECT_NE(output.out.find(std::string(LogRecord::MESSAGE_SIZE, 'x') + "...\n"), std::string::npos);
+}
+
+TEST(LoggerTest, ManyThreadsAreBatchedWithoutLoss) {
+    CapturedOutput output;
+    Logger::Options options;
+    options.capacity = 1 << 16;
+    Logger logger(options, output.sink());
+    logger.start();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&logger, t] {
+            for (int i = 0; i < 2000; i++) {
+                LogLine(logger, LogLevel::Info, "Load") << "thread " << t << " line " << i;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.stop();
+
+    EXPECT_EQ(output.lines(), 16000u);
+    EXPECT_EQ(logger.droppedCount(), 0u);
+    EXPECT_LT(output.batches, 16000);  // Many lines per write
+}
+
+TEST(LoggerTest, FullBufferDropsInsteadOfBlocking) {
+    CapturedOutput output;
+    Logger::Options options;
+    options.capacity = 8;
+    options.flush_interval = 1000ms;
+    Logger logger(options, [&output](bool is_error, const std::string& batch) {
+        std::this_thread::sleep_for(50ms);  // Slow terminal
+        output.sink()(is_error, batch);
+    });
+    logger.start();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++) {
+        LogLine(logger, LogLevel::Info, "Flood") << "line " << i;
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 200ms);
+    logger.stop();
+
+    EXPECT_GT(logger.droppedCount(), 0u);
+    EXPECT_NE(output.err.find("log lines dropped"), std::string::npos);
+}
+
+TEST(LoggerTest, ParsesLevelNames) {
+    EXPECT_EQ(Logger::parseLevel("DEBUG"), LogLevel::Debug);
+    EXPECT_EQ(Logger::parseLevel("warning"), LogLevel::Warn);
+    EXPECT_EQ(Logger::parseLevel("off"), LogLevel::Off);
+    EXPECT_EQ(Logger::parseLevel("verbose", LogLevel::Error), LogLevel::Error);
+}
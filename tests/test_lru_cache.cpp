@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+#include "utils/LRUCache.h"
+#include "utils/ShardedLRUCache.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace hms_firetv;
+
+// ============================================================================
+// LRUCache - BASIC FUNCTIONALITY
+// ============================================================================
+
+TEST(LRUCacheTest, PutAndGet) {
+    LRUCache<std::string, int> cache(10, 3600);
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+
+    EXPECT_EQ(cache.get("a").value_or(-1), 1);
+    EXPECT_EQ(cache.get("b").value_or(-1), 2);
+    EXPECT_FALSE(cache.get("missing").has_value());
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(LRUCacheTest, EvictsLeastRecentlyUsed) {
+    LRUCache<std::string, int> cache(2, 3600);
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    cache.get("a");       // "b" is now LRU
+    cache.put("c", 3);    // Evicts "b"
+
+    EXPECT_TRUE(cache.contains("a"));
+    EXPECT_FALSE(cache.contains("b"));
+    EXPECT_TRUE(cache.contains("c"));
+}
+
+TEST(LRUCacheTest, ExpiredEntriesAreCleanedUp) {
+    LRUCache<std::string, int> cache(10, 0);  // Everything expires immediately
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+
+    EXPECT_FALSE(cache.get("a").has_value());
+    EXPECT_EQ(cache.cleanupExpired(), 1);  // "a" was already evicted by get()
+    EXPECT_EQ(cache.size(), 0);
+}
+
+// ============================================================================
+// ShardedLRUCache - BASIC FUNCTIONALITY
+// ============================================================================
+
+TEST(ShardedLRUCacheTest, PutAndGet) {
+    ShardedLRUCache<std::string, int> cache(64, 3600, 4);
+
+    for (int i = 0; i < 32; i++) {
+        cache.put("key_" + std::to_string(i), i);
+    }
+
+    for (int i = 0; i < 32; i++) {
+        EXPECT_EQ(cache.get("key_" + std::to_string(i)).value_or(-1), i);
+    }
+    EXPECT_FALSE(cache.get("missing").has_value());
+    EXPECT_EQ(cache.size(), 32);
+}
+
+TEST(ShardedLRUCacheTest, PutOverwritesExistingValue) {
+    ShardedLRUCache<std::string, int> cache(8, 3600, 2);
+
+    cache.put("a", 1);
+    cache.put("a", 2);
+
+    EXPECT_EQ(cache.get("a").value_or(-1), 2);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(ShardedLRUCacheTest, RemoveAndClear) {
+    ShardedLRUCache<std::string, int> cache(16, 3600, 4);
+
+    for (int i = 0; i < 10; i++) {
+        cache.put("key_" + std::to_string(i), i);
+    }
+
+    cache.remove("key_3");
+    EXPECT_FALSE(cache.contains("key_3"));
+    EXPECT_EQ(cache.size(), 9);
+
+    // Remaining keys must survive backward-shift deletion in the index
+    for (int i = 0; i < 10; i++) {
+        if (i == 3) continue;
+        EXPECT_TRUE(cache.contains("key_" + std::to_string(i))) << "key_" << i;
+    }
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_FALSE(cache.contains("key_0"));
+}
+
+TEST(ShardedLRUCacheTest, NeverExceedsCapacity) {
+    ShardedLRUCache<int, int> cache(32, 3600, 4);
+
+    for (int i = 0; i < 1000; i++) {
+        cache.put(i, i);
+    }
+
+    EXPECT_LE(cache.size(), cache.capacity());
+    EXPECT_GE(cache.capacity(), 32);
+}
+
+TEST(ShardedLRUCacheTest, ReferencedEntriesGetSecondChance) {
+    // Single shard so eviction order is deterministic
+    ShardedLRUCache<std::string, int> cache(3, 3600, 1);
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    cache.put("c", 3);
+
+    cache.get("a");      // Reference bit set on "a"
+    cache.put("d", 4);   // CLOCK skips "a", evicts "b"
+
+    EXPECT_TRUE(cache.contains("a"));
+    EXPECT_FALSE(cache.contains("b"));
+    EXPECT_TRUE(cache.contains("c"));
+    EXPECT_TRUE(cache.contains("d"));
+}
+
+TEST(ShardedLRUCacheTest, ExpiredEntriesAreNotReturned) {
+    ShardedLRUCache<std::string, int> cache(8, 0, 2);  // Everything expires immediately
+
+    cache.put("a", 1);
+
+    EXPECT_FALSE(cache.get("a").has_value());
+    EXPECT_FALSE(cache.contains("a"));
+    EXPECT_EQ(cache.cleanupExpired(), 1);
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(ShardedLRUCacheTest, SweeperRemovesExpiredEntries) {
+    ShardedLRUCache<std::string, int> cache(8, 0, 2);
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    EXPECT_EQ(cache.size(), 2);
+
+    cache.startSweeper(std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    EXPECT_EQ(cache.size(), 0);
+    cache.stopSweeper();
+    cache.stopSweeper();  // Idempotent
+}
+
+TEST(ShardedLRUCacheTest, RemoveReleasesValue) {
+    ShardedLRUCache<std::string, std::shared_ptr<int>> cache(4, 3600, 1);
+
+    auto value = std::make_shared<int>(42);
+    cache.put("a", value);
+    EXPECT_EQ(value.use_count(), 2);
+
+    cache.remove("a");
+    EXPECT_EQ(value.use_count(), 1);
+}
+
+// ============================================================================
+// THREAD SAFETY / THROUGHPUT
+// ============================================================================
+
+namespace {
+
+constexpr int kThreads = 8;
+constexpr int kOpsPerThread = 200000;
+constexpr int kRounds = 3;
+
+// Shaped like AsyncLightningClient::http_clients_: 100 base URLs in
+// 8 shards, a lookup per command and a put only when a client is new
+constexpr int kKeys = 100;
+constexpr size_t kShards = 8;
+
+// Mostly-read workload: 1 put per 256 gets
+template<typename Cache>
+double runMixedWorkload(Cache& cache, const std::vector<std::string>& keys) {
+    for (int i = 0; i < kKeys; i++) {
+        cache.put(keys[i], i);
+    }
+
+    std::atomic<long> hits{0};
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; t++) {
+        workers.emplace_back([&cache, &keys, &hits, t]() {
+            long local_hits = 0;
+            for (int i = 0; i < kOpsPerThread; i++) {
+                const std::string& key = keys[(i * 7 + t) % kKeys];
+                if ((i & 255) == 0) {
+                    cache.put(key, i);
+                } else if (cache.get(key).has_value()) {
+                    local_hits++;
+                }
+            }
+            hits += local_hits;
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GT(hits.load(), 0);
+    return (static_cast<double>(kThreads) * kOpsPerThread) / elapsed;
+}
+
+std::vector<std::string> makeKeys() {
+    std::vector<std::string> keys;
+    for (int i = 0; i < kKeys; i++) {
+        keys.push_back("device_" + std::to_string(i));
+    }
+    return keys;
+}
+
+} // namespace
+
+TEST(ShardedLRUCacheTest, ConcurrentPutGetRemove) {
+    ShardedLRUCache<int, int> cache(128, 3600, 8);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < kThreads; t++) {
+        workers.emplace_back([&cache, t]() {
+            for (int i = 0; i < 20000; i++) {
+                int key = (i + t) % 256;
+                switch (i % 4) {
+                    case 0: cache.put(key, i); break;
+                    case 1: cache.remove(key); break;
+                    default: {
+                        auto v = cache.get(key);
+                        if (v.has_value()) {
+                            EXPECT_GE(v.value(), 0);
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    EXPECT_LE(cache.size(), cache.capacity());
+}
+
+TEST(ShardedLRUCacheTest, MultiThreadedThroughputVsLRUCache) {
+    auto keys = makeKeys();
+
+    LRUCache<std::string, int> single_lock(kKeys, 3600);
+    ShardedLRUCache<std::string, int> sharded(kKeys, 3600, kShards);
+
+    // Best of a few interleaved rounds, so a scheduler hiccup in one
+    // round does not decide the comparison
+    double single_ops = 0;
+    double sharded_ops = 0;
+    for (int round = 0; round < kRounds; round++) {
+        single_ops = std::max(single_ops, runMixedWorkload(single_lock, keys));
+        sharded_ops = std::max(sharded_ops, runMixedWorkload(sharded, keys));
+    }
+
+    std::cout << "LRUCache (single mutex): " << static_cast<long>(single_ops) << " ops/s, "
+              << "ShardedLRUCache (" << kShards << " shards): " << static_cast<long>(sharded_ops)
+              << " ops/s, ratio " << sharded_ops / single_ops << "x ("
+              << kThreads << " threads, " << kOpsPerThread << " ops each, "
+              << std::thread::hardware_concurrency() << " cores)" << std::endl;
+
+    // LRUCache::get() moves the entry to the front, so every lookup takes
+    // the one mutex exclusively; the sharded cache spreads them over
+    // shards. It must never be the slower of the two.
+    EXPECT_GE(sharded_ops, single_ops * 0.9);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
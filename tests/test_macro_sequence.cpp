@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include "clients/LightningStep.h"
+#include "services/MacroRunner.h"
+#include <curl/curl.h>
+#include <future>
+#include <sstream>
+#include <string>
+
+using namespace hms_firetv;
+
+namespace {
+
+Json::Value parse(const std::string& text) {
+    Json::Value root;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    std::istringstream stream(text);
+    EXPECT_TRUE(Json::parseFromStream(reader, stream, &root, &errors)) << errors;
+    return root;
+}
+
+} // namespace
+
+// ============================================================================
+// STEP COMPILATION
+// ============================================================================
+
+TEST(LightningStepTest, CompilesEachCommandToItsLightningRequest) {
+    std::string error;
+    auto sequence = compileSequence(parse(R"([
+        {"command": "navigate", "direction": "up"},
+        {"command": "navigate", "action": "home"},
+        {"command": "media", "action": "scan", "direction": "back"},
+        {"command": "volume", "action": "volume_down"},
+        {"command": "app", "package": "com.netflix.ninja", "delay_ms": 2000},
+        {"command": "text", "text": "the \"office\""},
+        {"command": "wake"},
+        {"command": "delay", "ms": 250}
+    ])"), error);
+    ASSERT_NE(sequence, nullptr) << error;
+    ASSERT_EQ(sequence->size(), 8u);
+
+    const auto& s = *sequence;
+    EXPECT_EQ(s[0].path, "/v1/FireTV?action=dpad_up");
+    EXPECT_EQ(s[1].path, "/v1/FireTV?action=home");
+    EXPECT_EQ(s[2].path, "/v1/media?action=scan&direction=back");
+    EXPECT_EQ(s[3].path, "/v1/FireTV?action=volume_down");
+    EXPECT_EQ(s[4].path, "/v1/FireTV/app/com.netflix.ninja");
+    EXPECT_EQ(s[4].delay_after_ms, 2000);
+    EXPECT_EQ(s[5].path, "/v1/FireTV/keyboard");
+    EXPECT_EQ(parse(s[5].body)["text"].asString(), "the \"office\"");
+    EXPECT_EQ(s[6].kind, LightningStep::Kind::Wake);
+    EXPECT_EQ(s[7].kind, LightningStep::Kind::Delay);
+    EXPECT_EQ(s[7].delay_after_ms, 250);
+}
+
+TEST(LightningStepTest, RejectsValuesThatWouldAlterThePath) {
+    std::string error;
+    EXPECT_EQ(compileSequence(parse(R"([{"command": "navigate", "action": "home&x=1"}])"), error), nullptr);
+    EXPECT_NE(error.find("step 0"), std::string::npos);
+
+    EXPECT_EQ(compileSequence(parse(R"([{"command": "app", "package": "../v1/pair"}])"), error), nullptr);
+    EXPECT_EQ(compileSequence(parse(R"([{"command": "media", "action": "scan", "direction": "up"}])"), error), nullptr);
+}
+
+TEST(LightningStepTest, RejectsMalformedSequences) {
+    std::string error;
+    EXPECT_EQ(compileSequence(Json::Value(Json::arrayValue), error), nullptr);
+    EXPECT_EQ(compileSequence(parse(R"({"command": "wake"})"), error), nullptr);
+    EXPECT_EQ(compileSequence(parse(R"([{"command": "reboot"}])"), error), nullptr);
+    EXPECT_EQ(compileSequence(parse(R"([{"command": "delay"}])"), error), nullptr);
+    EXPECT_EQ(compileSequence(parse(R"([{"command": "delay", "ms": -5}])"), error), nullptr);
+
+    // Second step is bad: error names it
+    EXPECT_EQ(compileSequence(parse(R"([{"command": "wake"}, {"action": "home"}])"), error), nullptr);
+    EXPECT_NE(error.find("step 1"), std::string::npos);
+}
+
+TEST(LightningStepTest, EnforcesStepAndDelayLimits) {
+    std::string error;
+
+    Json::Value too_many(Json::arrayValue);
+    for (size_t i = 0; i <= MAX_SEQUENCE_STEPS; i++) {
+        too_many.append(parse(R"({"command": "navigate", "action": "select"})"));
+    }
+    EXPECT_EQ(compileSequence(too_many, error), nullptr);
+
+    Json::Value too_slow(Json::arrayValue);
+    for (int total = 0; total <= MAX_SEQUENCE_DELAY_MS; total += MAX_STEP_DELAY_MS) {
+        Json::Value step;
+        step["command"] = "delay";
+        step["ms"] = MAX_STEP_DELAY_MS;
+        too_slow.append(step);
+    }
+    EXPECT_EQ(compileSequence(too_slow, error), nullptr);
+}
+
+// ============================================================================
+// SEQUENCE EXECUTION
+// ============================================================================
+
+TEST(MacroRunnerTest, DelaysAreTimedBetweenSteps) {
+    std::string error;
+    auto sequence = compileSequence(parse(R"([
+        {"command": "delay", "ms": 30},
+        {"command": "delay", "ms": 30}
+    ])"), error);
+    ASSERT_NE(sequence, nullptr);
+
+    LightningClient client("127.0.0.1");
+    auto result = MacroRunner::run(client, *sequence);
+
+    EXPECT_TRUE(result.success);
+    ASSERT_EQ(result.steps_run, 2u);
+    EXPECT_EQ(result.steps[0].started_at_ms, 0);
+    EXPECT_GE(result.steps[1].started_at_ms, 30);
+    EXPECT_GE(result.total_ms, 30);  // No pause after the final step
+
+    auto json = result.toJson();
+    EXPECT_EQ(json["steps"].size(), 2u);
+    EXPECT_TRUE(json["steps"][1].isMember("started_at_ms"));
+}
+
+TEST(MacroRunnerTest, StopOnErrorSkipsRemainingSteps) {
+    std::string error;
+    auto sequence = compileSequence(parse(R"([
+        {"command": "navigate", "action": "home"},
+        {"command": "delay", "ms": 1}
+    ])"), error);
+    ASSERT_NE(sequence, nullptr);
+
+    // Nothing listens on 127.0.0.1:8080 in the test environment: refused at once
+    LightningClient client("127.0.0.1");
+
+    auto stopped = MacroRunner::run(client, *sequence, true);
+    EXPECT_FALSE(stopped.success);
+    EXPECT_EQ(stopped.steps_run, 1u);
+    EXPECT_TRUE(stopped.steps[0].error.has_value());
+
+    auto continued = MacroRunner::run(client, *sequence, false);
+    EXPECT_FALSE(continued.success);
+    EXPECT_EQ(continued.steps_run, 2u);
+    EXPECT_TRUE(continued.steps[1].success);
+}
+
+TEST(MacroRunnerTest, RequestStepsCarryTransportTiming) {
+    std::string error;
+    auto sequence = compileSequence(parse(R"([{"command": "navigate", "action": "home"}])"), error);
+    ASSERT_NE(sequence, nullptr);
+
+    // Refused: curl timed the lookup and the attempt, but no byte ever came back
+    LightningClient client("127.0.0.1");
+    auto result = MacroRunner::run(client, *sequence);
+    ASSERT_EQ(result.steps_run, 1u);
+    const auto& timing = result.steps[0].timing;
+    EXPECT_GE(timing.dns_us, 0);
+    EXPECT_GE(timing.transfer_us, 0);
+    EXPECT_EQ(timing.ttfb_us, -1);
+    EXPECT_EQ(client.lastTiming().transfer_us, timing.transfer_us);
+
+    result.queue_ms = 7;
+    auto json = result.toJson();
+    EXPECT_DOUBLE_EQ(json["timing"]["queue_ms"].asDouble(), 7.0);
+    EXPECT_TRUE(json["timing"].isMember("transfer_ms"));
+    EXPECT_FALSE(json["timing"].isMember("ttfb_ms"));
+    EXPECT_FALSE(json["timing"].isMember("wake_ms"));
+}
+
+TEST(CommandTimingTest, SumsMeasuredPhasesAndOmitsTheRest) {
+    CommandTiming first;
+    first.dns_us = 1500;
+    first.ttfb_us = 20000;
+    first.transfer_us = 25000;
+    CommandTiming second;
+    second.wake_us = 3000000;
+    second.ttfb_us = 10000;
+
+    CommandTiming total;
+    EXPECT_FALSE(total.measured());
+    EXPECT_TRUE(total.toJson().empty());
+    total.add(first);
+    total.add(second);
+    EXPECT_TRUE(total.measured());
+    EXPECT_EQ(total.ttfb_us, 30000);
+    EXPECT_EQ(total.wake_us, 3000000);
+    EXPECT_EQ(total.connect_us, -1);
+
+    auto json = total.toJson();
+    EXPECT_DOUBLE_EQ(json["dns_ms"].asDouble(), 1.5);
+    EXPECT_DOUBLE_EQ(json["ttfb_ms"].asDouble(), 30.0);
+    EXPECT_DOUBLE_EQ(json["wake_ms"].asDouble(), 3000.0);
+    EXPECT_FALSE(json.isMember("connect_ms"));
+    EXPECT_FALSE(json.isMember("queue_ms"));
+}
+
+TEST(CommandTimingTest, RoundTripIsReportedApartFromTransfer) {
+    CommandTiming timing;
+    timing.queue_us = 200;
+    timing.round_trip_us = 48000;   // Client without phases: the whole exchange
+    EXPECT_TRUE(timing.measured());
+
+    auto json = timing.toJson();
+    EXPECT_DOUBLE_EQ(json["round_trip_ms"].asDouble(), 48.0);
+    EXPECT_FALSE(json.isMember("transfer_ms"));
+    EXPECT_FALSE(json.isMember("ttfb_ms"));
+}
+
+TEST(MacroRunnerTest, StopsAtClientDeadline) {
+    std::string error;
+    auto sequence = compileSequence(parse(R"([
+        {"command": "delay", "ms": 5000},
+        {"command": "delay", "ms": 1}
+    ])"), error);
+    ASSERT_NE(sequence, nullptr);
+
+    LightningClient client("127.0.0.1");
+    client.setDeadline(Deadline::after(std::chrono::milliseconds(30)));
+    auto result = MacroRunner::run(client, *sequence);
+
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(result.steps_run, 1u);  // The delay was cut short at the deadline
+    EXPECT_LT(result.total_ms, 1000);
+    EXPECT_EQ(result.error.value_or(""), Deadline::EXCEEDED);
+}
+
+TEST(MacroRunnerTest, UnknownDeviceCompletesWithError) {
+    std::string error;
+    auto sequence = compileSequence(parse(R"([{"command": "wake"}])"), error);
+    ASSERT_NE(sequence, nullptr);
+
+    // No database configured: no device resolves
+    std::promise<SequenceResult> done;
+    MacroRunner::getInstance().runAsync("garage", sequence, true, Deadline(), [&done](SequenceResult result) {
+        done.set_value(std::move(result));
+    });
+
+    auto result = done.get_future().get();
+    EXPECT_FALSE(result.success);
+    ASSERT_TRUE(result.error.has_value());
+    EXPECT_TRUE(result.steps.empty());
+    MacroRunner::getInstance().stop();
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    ::testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+    curl_global_cleanup();
+    return result;
+}
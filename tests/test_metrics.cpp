@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "utils/Metrics.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hms_firetv;
+
+TEST(MetricsTest, CounterSumsShardsAcrossThreads) {
+    MetricCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; i++) {
+                counter.inc();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.value(), 80000u);
+}
+
+TEST(MetricsTest, HistogramBucketsAreContiguousAndOrdered) {
+    for (size_t bucket = 1; bucket < MetricHistogram::BUCKETS; bucket++) {
+        uint64_t lower = MetricHistogram::bucketLowerBound(bucket);
+        EXPECT_GT(lower, MetricHistogram::bucketLowerBound(bucket - 1));
+        EXPECT_EQ(MetricHistogram::bucketFor(lower), bucket);
+        EXPECT_EQ(MetricHistogram::bucketFor(lower - 1), bucket - 1);
+    }
+    EXPECT_EQ(MetricHistogram::bucketFor(UINT64_MAX), MetricHistogram::BUCKETS - 1);
+}
+
+TEST(MetricsTest, PercentileIsWithinOneBucket) {
+    MetricHistogram histogram;
+    for (uint64_t ms = 1; ms <= 100; ms++) {
+        histogram.observe(std::chrono::milliseconds(ms));
+    }
+    EXPECT_EQ(histogram.count(), 100u);
+
+    // True p50 is 50ms and p99 is 99ms; buckets are at most 25% wide
+    uint64_t p50 = histogram.percentileMicros(0.5);
+    uint64_t p99 = histogram.percentileMicros(0.99);
+    EXPECT_GE(p50, 50000u);
+    EXPECT_LE(p50, 62500u);
+    EXPECT_GE(p99, 99000u);
+    EXPECT_LE(p99, 123750u);
+    EXPECT_EQ(MetricHistogram().percentileMicros(0.5), 0u);
+}
+
+TEST(MetricsTest, LabeledSeriesAreStable) {
+    MetricsRegistry registry;
+    auto& family = registry.counter<2>("test_total", "Test", {"device", "result"});
+
+    std::string device = "tv1";
+    MetricCounter& first = family.labels({device, "ok"});
+    MetricCounter& again = family.labels({std::string_view(device), "ok"});
+    EXPECT_EQ(&first, &again);
+    EXPECT_NE(&first, &family.labels({"tv2", "ok"}));
+
+    // Same name returns the same family
+    EXPECT_EQ(&family, &registry.counter<2>("test_total", "Test", {"device", "result"}));
+}
+
+TEST(MetricsTest, RendersPrometheusText) {
+    MetricsRegistry registry;
+    registry.counter<1>("test_commands_total", "Commands", {"device"}).labels({"living \"room\""}).inc(3);
+    auto& latency = registry.histogram<1>("test_latency_seconds", "Latency", {"op"}).labels({"get"});
+    latency.observe(std::chrono::microseconds(100));   // Below the first exported edge
+    latency.observe(std::chrono::milliseconds(5));
+    latency.observe(std::chrono::seconds(100));         // Above the last one
+    registry.addCollector("test_queue_depth", "Queue", "gauge", [] {
+        return std::vector<MetricsRegistry::Sample>{{{{"queue", "macro"}}, 2}};
+    });
+
+    std::string text = registry.render();
+    EXPECT_NE(text.find("# TYPE test_commands_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("test_commands_total{device=\"living \\\"room\\\"\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{op=\"get\",le=\"0.000128\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{op=\"get\",le=\"0.008192\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{op=\"get\",le=\"+Inf\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_count{op=\"get\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("test_queue_depth{queue=\"macro\"} 2\n"), std::string::npos);
+}
+
+TEST(MetricsTest, RecordCommandCountsEveryThreadIntoOneSeries) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t] {
+            std::string device = "metrics_test_tv";  // Fresh string per thread: looked up by value
+            for (int i = 0; i < 1000; i++) {
+                Metrics::recordCommand(device, "navigate", (i + t) % 4 != 0, std::chrono::microseconds(250));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto& registry = MetricsRegistry::getInstance();
+    auto& total = registry.counter<3>("firetv_commands_total", "", {"device", "command", "result"});
+    auto& duration = registry.histogram<2>("firetv_command_duration_seconds", "", {"device", "command"});
+    EXPECT_EQ(total.labels({"metrics_test_tv", "navigate", "success"}).value(), 3000u);
+    EXPECT_EQ(total.labels({"metrics_test_tv", "navigate", "failure"}).value(), 1000u);
+    EXPECT_EQ(duration.labels({"metrics_test_tv", "navigate"}).count(), 4000u);
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include "services/PairingSessionManager.h"
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace hms_firetv;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * Fake TV: displays the PIN, issues the token after `polls_before_token`
+ * verify calls, records what was stored
+ */
+struct FakeTv {
+    std::atomic<bool> display_ok{true};
+    std::atomic<int> display_delay_ms{0};
+    std::atomic<int> polls_before_token{0};
+    std::atomic<int> verify_calls{0};
+    std::mutex mutex;
+    std::string stored_token;
+
+    PairingSessionManager::Operations operations() {
+        return {
+            [this](const std::string&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(display_delay_ms.load()));
+                return display_ok.load();
+            },
+            [this](const std::string&, const std::string& pin) {
+                int call = ++verify_calls;
+                return (pin == "1234" && call > polls_before_token) ? std::string("token-abc")
+                                                                    : std::string();
+            },
+            [this](const std::string&, const std::string& token) {
+                std::lock_guard<std::mutex> lock(mutex);
+                stored_token = token;
+                return true;
+            }
+        };
+    }
+};
+
+PairingSessionManager::Timing fastTiming() {
+    PairingSessionManager::Timing timing;
+    timing.poll_interval = 10ms;
+    timing.max_token_polls = 3;
+    timing.session_ttl = 5s;
+    timing.finished_retention = 5s;
+    return timing;
+}
+
+// Block until the session reaches `state` (or fail after 2s)
+PairingSession waitFor(PairingSessionManager& manager, const std::string& device_id,
+                       PairingState state) {
+    uint64_t since = 0;
+    auto give_up = std::chrono::steady_clock::now() + 2s;
+    while (std::chrono::steady_clock::now() < give_up) {
+        std::promise<std::optional<PairingSession>> changed;
+        manager.waitForChange(device_id, since, 500ms, [&changed](std::optional<PairingSession> s) {
+            changed.set_value(std::move(s));
+        });
+        auto session = changed.get_future().get();
+        if (!session) {
+            break;
+        }
+        if (session->state == state) {
+            return *session;
+        }
+        since = session->version;
+    }
+    ADD_FAILURE() << "Session never reached " << pairingStateName(state);
+    return PairingSession();
+}
+
+} // namespace
+
+TEST(PairingSessionTest, StartReturnsAtOnceAndDisplaysInBackground) {
+    FakeTv tv;
+    PairingSessionManager manager(tv.operations(), fastTiming());
+
+    auto session = manager.start("tv1");
+    EXPECT_EQ(session.state, PairingState::DisplayingPin);
+    EXPECT_EQ(session.session_id.size(), 16u);
+
+    auto awaiting = waitFor(manager, "tv1", PairingState::AwaitingPin);
+    EXPECT_EQ(awaiting.session_id, session.session_id);
+}
+
+TEST(PairingSessionTest, VerifyPollsUntilTokenAndStoresIt) {
+    FakeTv tv;
+    tv.polls_before_token = 2;  // TV answers "OK" twice before issuing the token
+    PairingSessionManager manager(tv.operations(), fastTiming());
+
+    manager.start("tv1");
+    waitFor(manager, "tv1", PairingState::AwaitingPin);
+
+    PairingSessionManager::VerifyError error;
+    auto verifying = manager.verify("tv1", "1234", error);
+    ASSERT_TRUE(verifying.has_value());
+    EXPECT_EQ(verifying->state, PairingState::Verifying);
+
+    auto paired = waitFor(manager, "tv1", PairingState::Paired);
+    EXPECT_EQ(paired.attempts, 3);
+    std::lock_guard<std::mutex> lock(tv.mutex);
+    EXPECT_EQ(tv.stored_token, "token-abc");
+}
+
+TEST(PairingSessionTest, WrongPinFailsAfterMaxPollsAndCanBeRetried) {
+    FakeTv tv;
+    PairingSessionManager manager(tv.operations(), fastTiming());
+
+    manager.start("tv1");
+    waitFor(manager, "tv1", PairingState::AwaitingPin);
+
+    PairingSessionManager::VerifyError error;
+    ASSERT_TRUE(manager.verify("tv1", "0000", error).has_value());
+    auto failed = waitFor(manager, "tv1", PairingState::Failed);
+    EXPECT_EQ(failed.attempts, 3);
+    EXPECT_FALSE(failed.error.empty());
+
+    ASSERT_TRUE(manager.verify("tv1", "1234", error).has_value());
+    waitFor(manager, "tv1", PairingState::Paired);
+}
+
+TEST(PairingSessionTest, VerifyIsRejectedWithoutADisplayedPin) {
+    FakeTv tv;
+    tv.display_ok = false;
+    PairingSessionManager manager(tv.operations(), fastTiming());
+
+    PairingSessionManager::VerifyError error;
+    EXPECT_FALSE(manager.verify("tv1", "1234", error).has_value());
+    EXPECT_EQ(error, PairingSessionManager::VerifyError::NoSession);
+
+    manager.start("tv1");
+    waitFor(manager, "tv1", PairingState::Failed);
+    EXPECT_FALSE(manager.verify("tv1", "1234", error).has_value());
+    EXPECT_EQ(error, PairingSessionManager::VerifyError::NotDisplayed);
+    EXPECT_EQ(tv.verify_calls, 0);
+}
+
+TEST(PairingSessionTest, SessionExpiresAfterTtl) {
+    FakeTv tv;
+    auto timing = fastTiming();
+    timing.session_ttl = 50ms;
+    PairingSessionManager manager(tv.operations(), timing);
+
+    manager.start("tv1");
+    waitFor(manager, "tv1", PairingState::Expired);
+
+    PairingSessionManager::VerifyError error;
+    EXPECT_FALSE(manager.verify("tv1", "1234", error).has_value());
+    EXPECT_EQ(error, PairingSessionManager::VerifyError::Expired);
+}
+
+TEST(PairingSessionTest, LongPollTimesOutWithUnchangedSession) {
+    FakeTv tv;
+    PairingSessionManager manager(tv.operations(), fastTiming());
+
+    manager.start("tv1");
+    auto awaiting = waitFor(manager, "tv1", PairingState::AwaitingPin);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::promise<std::optional<PairingSession>> answered;
+    manager.waitForChange("tv1", awaiting.version, 50ms, [&answered](std::optional<PairingSession> s) {
+        answered.set_value(std::move(s));
+    });
+    auto session = answered.get_future().get();
+    ASSERT_TRUE(session.has_value());
+    EXPECT_EQ(session->version, awaiting.version);
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, 50ms);
+}
+
+TEST(PairingSessionTest, SlowTvDoesNotHoldUpTimers) {
+    FakeTv tv;
+    tv.display_delay_ms = 1000;
+    PairingSessionManager manager(tv.operations(), fastTiming());
+
+    // The PIN display hangs on a worker; the long-poll timeout still fires
+    auto session = manager.start("tv1");
+    auto begin = std::chrono::steady_clock::now();
+    std::promise<std::optional<PairingSession>> answered;
+    manager.waitForChange("tv1", session.version, 50ms, [&answered](std::optional<PairingSession> s) {
+        answered.set_value(std::move(s));
+    });
+    auto answer = answered.get_future().get();
+    ASSERT_TRUE(answer.has_value());
+    EXPECT_EQ(answer->state, PairingState::DisplayingPin);
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, 500ms);
+}
+
+TEST(PairingSessionTest, CancelWakesLongPollAndStopsVerification) {
+    FakeTv tv;
+    tv.polls_before_token = 1000;
+    PairingSessionManager manager(tv.operations(), fastTiming());
+
+    manager.start("tv1");
+    waitFor(manager, "tv1", PairingState::AwaitingPin);
+    PairingSessionManager::VerifyError error;
+    auto verifying = manager.verify("tv1", "1234", error);
+    ASSERT_TRUE(verifying.has_value());
+
+    std::promise<std::optional<PairingSession>> answered;
+    manager.waitForChange("tv1", verifying->version, 5s, [&answered](std::optional<PairingSession> s) {
+        answered.set_value(std::move(s));
+    });
+    manager.cancel("tv1");
+
+    auto session = answered.get_future().get();
+    ASSERT_TRUE(session.has_value());
+    EXPECT_EQ(session->state, PairingState::Cancelled);
+
+    int calls = tv.verify_calls;
+    std::this_thread::sleep_for(50ms);
+    EXPECT_LE(tv.verify_calls, calls + 1);  // At most the poll already in flight
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include "services/RemoteControlService.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace hms_firetv;
+
+namespace {
+
+// Holds every request until the test answers it, like a TV that is thinking
+struct FakeTv {
+    struct Request {
+        std::string device_ip;
+        std::string path;
+        std::function<void(CommandResult)> done;
+    };
+
+    std::vector<Request> requests;
+    std::vector<std::string> resolved;
+
+    RemoteControlService::Sender sender() {
+        return [this](const Device& device, const LightningStep& step, std::function<void(CommandResult)> done) {
+            requests.push_back({device.ip_address, step.path, std::move(done)});
+        };
+    }
+
+    RemoteControlService::Resolver resolver() {
+        return [this](const std::string& device_id) -> std::optional<Device> {
+            resolved.push_back(device_id);
+            if (device_id == "missing") {
+                return std::nullopt;
+            }
+            Device device;
+            device.device_id = device_id;
+            device.ip_address = "192.168.2." + std::to_string(resolved.size());
+            return device;
+        };
+    }
+
+    void answer(size_t i, bool success = true) {
+        CommandResult result;
+        result.success = success;
+        result.status_code = success ? 200 : 500;
+        if (!success) {
+            result.error = "HTTP 500";
+        }
+        result.timing.queue_us = 5000;   // Waited for the device's pooled client
+        result.timing.transfer_us = 42000;
+        requests.at(i).done(result);
+    }
+};
+
+RemoteControlService::Options smallQueue() {
+    RemoteControlService::Options options;
+    options.max_queued = 2;
+    return options;
+}
+
+} // namespace
+
+TEST(RemoteControlTest, ParsesTextCommands) {
+    std::string error;
+    auto press = RemoteControlService::parse("12 up", false, error);
+    ASSERT_TRUE(press.has_value()) << error;
+    EXPECT_EQ(press->type, RemoteControlService::Message::Type::Press);
+    EXPECT_EQ(press->n, 12u);
+    EXPECT_EQ(press->key->path, "/v1/FireTV?action=dpad_up");
+
+    auto hold = RemoteControlService::parse("13 dpad_down+", false, error);
+    ASSERT_TRUE(hold.has_value()) << error;
+    EXPECT_EQ(hold->type, RemoteControlService::Message::Type::Hold);
+    EXPECT_EQ(hold->key->detail, "dpad_down");
+
+    auto media = RemoteControlService::parse("14 play", false, error);
+    ASSERT_TRUE(media.has_value()) << error;
+    EXPECT_EQ(media->key->path, "/v1/media?action=play");
+
+    auto release = RemoteControlService::parse("15 -", false, error);
+    ASSERT_TRUE(release.has_value());
+    EXPECT_EQ(release->type, RemoteControlService::Message::Type::Release);
+
+    auto select = RemoteControlService::parse("@living_room", false, error);
+    ASSERT_TRUE(select.has_value());
+    EXPECT_EQ(select->type, RemoteControlService::Message::Type::Select);
+    EXPECT_EQ(select->device_id, "living_room");
+
+    EXPECT_FALSE(RemoteControlService::parse("up", false, error).has_value());
+    EXPECT_FALSE(RemoteControlService::parse("x up", false, error).has_value());
+    EXPECT_FALSE(RemoteControlService::parse("16 reboot", false, error).has_value());
+    EXPECT_NE(error.find("reboot"), std::string::npos);
+    EXPECT_FALSE(RemoteControlService::parse("@", false, error).has_value());
+}
+
+TEST(RemoteControlTest, ParsesBinaryCommands) {
+    const auto& names = RemoteControlService::keyNames();
+    auto code = std::find(names.begin(), names.end(), "select") - names.begin();
+
+    std::string error;
+    std::string frame{'\x01', '\x02', static_cast<char>(code), '\x00'};
+    auto press = RemoteControlService::parse(frame, true, error);
+    ASSERT_TRUE(press.has_value()) << error;
+    EXPECT_EQ(press->n, 258u);
+    EXPECT_EQ(press->type, RemoteControlService::Message::Type::Press);
+    EXPECT_EQ(press->key->detail, "select");
+
+    frame[3] = '\x01';
+    EXPECT_EQ(RemoteControlService::parse(frame, true, error)->type, RemoteControlService::Message::Type::Hold);
+    frame[3] = '\x02';
+    EXPECT_EQ(RemoteControlService::parse(frame, true, error)->type, RemoteControlService::Message::Type::Release);
+
+    frame[2] = static_cast<char>(names.size());
+    frame[3] = '\x00';
+    EXPECT_FALSE(RemoteControlService::parse(frame, true, error).has_value());
+    EXPECT_FALSE(RemoteControlService::parse("abc", true, error).has_value());
+}
+
+TEST(RemoteControlTest, PressesReachTheTvInOrderOneAtATime) {
+    FakeTv tv;
+    RemoteControlService service(tv.sender(), tv.resolver(), smallQueue());
+    std::vector<std::string> acks;
+    auto ack = [&acks](const char* name) {
+        return [&acks, name](const RemoteControlService::Ack& result) {
+            acks.push_back(std::string(name) + (result.success ? ":ok" : ":" + result.error));
+        };
+    };
+
+    service.press("living_room", *RemoteControlService::key("down"), ack("down"));
+    service.press("living_room", *RemoteControlService::key("down"), ack("down2"));
+    service.press("living_room", *RemoteControlService::key("select"), ack("select"));
+    service.press("bedroom", *RemoteControlService::key("home"), ack("home"));
+
+    // One in flight per device; the other device is independent
+    ASSERT_EQ(tv.requests.size(), 2u);
+    EXPECT_EQ(tv.requests[0].path, "/v1/FireTV?action=dpad_down");
+    EXPECT_EQ(tv.requests[1].path, "/v1/FireTV?action=home");
+    EXPECT_EQ(service.stats()["queued"].asUInt64(), 2u);
+
+    // Lane full (2 waiting): rejected at once
+    service.press("living_room", *RemoteControlService::key("back"), ack("back"));
+    ASSERT_EQ(acks.size(), 1u);
+    EXPECT_EQ(acks[0], "back:Too many presses queued");
+
+    tv.answer(0);
+    ASSERT_EQ(tv.requests.size(), 3u);
+    EXPECT_EQ(tv.requests[2].path, "/v1/FireTV?action=dpad_down");
+    tv.answer(2, false);
+    ASSERT_EQ(tv.requests.size(), 4u);
+    EXPECT_EQ(tv.requests[3].path, "/v1/FireTV?action=select");
+    tv.answer(3);
+    tv.answer(1);
+
+    EXPECT_EQ(acks, (std::vector<std::string>{"back:Too many presses queued", "down:ok", "down2:HTTP 500",
+                                              "select:ok", "home:ok"}));
+    EXPECT_EQ(service.stats()["queued"].asUInt64(), 0u);
+    EXPECT_EQ(service.stats()["sent"].asUInt64(), 4u);
+    EXPECT_EQ(service.stats()["rejected"].asUInt64(), 1u);
+}
+
+TEST(RemoteControlTest, AckCarriesQueueAndTransportTiming) {
+    FakeTv tv;
+    RemoteControlService service(tv.sender(), tv.resolver(), smallQueue());
+    std::vector<RemoteControlService::Ack> acks;
+    auto collect = [&acks](const RemoteControlService::Ack& ack) { acks.push_back(ack); };
+
+    service.press("living_room", *RemoteControlService::key("up"), collect);
+    service.press("living_room", *RemoteControlService::key("up"), collect);
+    tv.answer(0);
+    tv.answer(1);
+
+    ASSERT_EQ(acks.size(), 2u);
+    EXPECT_EQ(acks[1].timing.transfer_us, 42000);
+    EXPECT_GE(acks[0].timing.queue_us, 5000);   // Client queue wait is kept
+    EXPECT_GE(acks[1].timing.queue_us, 5000);   // Waited behind the first press as well
+    EXPECT_GE(acks[1].total.count(), acks[1].timing.queue_us - 5000);   // The fake's wait takes no time
+}
+
+TEST(RemoteControlTest, DeviceIsResolvedOnceUntilForgotten) {
+    FakeTv tv;
+    RemoteControlService service(tv.sender(), tv.resolver(), smallQueue());
+    auto ignore = [](const RemoteControlService::Ack&) {};
+
+    service.press("living_room", *RemoteControlService::key("up"), ignore);
+    tv.answer(0);
+    service.press("living_room", *RemoteControlService::key("up"), ignore);
+    tv.answer(1);
+    EXPECT_EQ(tv.resolved.size(), 1u);
+
+    // IP changed: the next press resolves again and goes to the new address
+    service.forget("living_room");
+    service.press("living_room", *RemoteControlService::key("up"), ignore);
+    EXPECT_EQ(tv.resolved.size(), 2u);
+    EXPECT_NE(tv.requests[2].device_ip, tv.requests[0].device_ip);
+    tv.answer(2);
+
+    std::string error;
+    service.press("missing", *RemoteControlService::key("up"),
+                  [&error](const RemoteControlService::Ack& ack) { error = ack.error; });
+    EXPECT_EQ(error, "Device not found");
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "utils/ServerProfile.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+using namespace hms_firetv;
+
+TEST(ServerProfileTest, CommandRoutesGetTheSmallCap) {
+    ServerProfile profile;
+    profile.max_body_bytes = 1024 * 1024;
+    profile.command_body_bytes = 8 * 1024;
+    profile.batch_body_bytes = 64 * 1024;
+
+    for (const char* path : {"/api/devices/living_room/navigate", "/api/devices/living_room/command",
+                             "/api/devices/living_room/media", "/api/devices/living_room/volume",
+                             "/api/devices/living_room/app", "/api/devices/living_room/text",
+                             "/api/devices/living_room/pair/verify", "/api/broadcast"}) {
+        EXPECT_EQ(profile.bodyLimitFor(path), 8u * 1024) << path;
+    }
+    EXPECT_EQ(profile.bodyLimitFor("/api/devices/living_room/commands/batch"), 64u * 1024);
+    EXPECT_EQ(profile.bodyLimitFor("/api/macros/evening"), 64u * 1024);
+
+    // Device CRUD and app management keep the global cap, even with command-like ids
+    EXPECT_EQ(profile.bodyLimitFor("/api/devices"), 1024u * 1024);
+    EXPECT_EQ(profile.bodyLimitFor("/api/devices/text"), 1024u * 1024);
+    EXPECT_EQ(profile.bodyLimitFor("/api/devices/living_room/apps/bulk"), 1024u * 1024);
+    EXPECT_EQ(profile.bodyLimitFor("/api/devices/living_room/apps/app"), 1024u * 1024);
+}
+
+TEST(ServerProfileTest, ReadsEnvironment) {
+    ::unsetenv("THREAD_NUM");
+    ::setenv("HTTP_REUSE_PORT", "false", 1);
+    ::setenv("HTTP_MAX_BODY_KB", "4", 1);
+    ::setenv("HTTP_COMMAND_BODY_KB", "2", 1);
+    ::setenv("HTTP_BATCH_BODY_KB", "16", 1);
+
+    auto profile = ServerProfile::fromEnv();
+    EXPECT_EQ(profile.threads, std::max(1u, std::thread::hardware_concurrency()));
+    EXPECT_FALSE(profile.reuse_port);
+    EXPECT_TRUE(profile.tcp_nodelay);
+    EXPECT_EQ(profile.max_body_bytes, 4u * 1024);
+    EXPECT_EQ(profile.command_body_bytes, 2u * 1024);
+    EXPECT_EQ(profile.batch_body_bytes, 4u * 1024);   // Capped at the global limit
+
+    ::setenv("THREAD_NUM", "3", 1);
+    EXPECT_EQ(ServerProfile::fromEnv().threads, 3u);
+
+    for (const char* key : {"THREAD_NUM", "HTTP_REUSE_PORT", "HTTP_MAX_BODY_KB", "HTTP_COMMAND_BODY_KB",
+                            "HTTP_BATCH_BODY_KB"}) {
+        ::unsetenv(key);
+    }
+}
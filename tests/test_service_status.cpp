@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "services/ServiceStatus.h"
+#include <sstream>
+#include <thread>
+
+using namespace hms_firetv;
+
+namespace {
+
+Json::Value parse(const ServiceStatus::Body& body) {
+    Json::Value json;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    std::istringstream stream(*body);
+    EXPECT_TRUE(Json::parseFromStream(reader, stream, &json, &errors)) << errors;
+    return json;
+}
+
+Device device(const std::string& id, bool paired, bool online) {
+    Device d;
+    d.device_id = id;
+    d.status = online ? "online" : "offline";
+    if (paired) {
+        d.client_token = "token";
+    }
+    return d;
+}
+
+} // namespace
+
+TEST(ServiceStatusTest, DeviceCountersFollowChanges) {
+    ServiceStatus status(std::chrono::milliseconds(60000));
+    status.resetDevices({device("a", true, true), device("b", false, true), device("c", true, false)});
+    auto counts = status.devices();
+    EXPECT_EQ(counts.total, 3u);
+    EXPECT_EQ(counts.paired, 2u);
+    EXPECT_EQ(counts.online, 2u);
+
+    status.deviceChanged("b", true, std::nullopt);     // Paired
+    status.deviceChanged("a", std::nullopt, false);    // Went offline
+    status.deviceChanged("d", false, true);            // Created
+    status.deviceRemoved("c");
+    status.deviceRemoved("missing");
+
+    counts = status.devices();
+    EXPECT_EQ(counts.total, 3u);
+    EXPECT_EQ(counts.paired, 2u);
+    EXPECT_EQ(counts.online, 2u);
+}
+
+TEST(ServiceStatusTest, StatusBodyIsCachedUntilSomethingChanges) {
+    ServiceStatus status(std::chrono::milliseconds(60000));
+    status.setInfo({"HMS FireTV", "1.0.6", "sqlite", "tcp://broker:1883"});
+    int details_calls = 0;
+    status.setDetailsProvider([&details_calls](Json::Value& r) {
+        details_calls++;
+        r["slo"]["tracked"] = 1;
+    });
+    status.resetDevices({device("a", true, true)});
+
+    auto first = status.statusBody();
+    auto second = status.statusBody();
+    EXPECT_EQ(first, second);   // Same shared body, not re-rendered
+    EXPECT_EQ(details_calls, 1);
+
+    auto json = parse(first);
+    EXPECT_EQ(json["status"].asString(), "running");
+    EXPECT_EQ(json["devices"]["paired"].asUInt64(), 1u);
+    EXPECT_EQ(json["config"]["mqtt_broker"].asString(), "tcp://broker:1883");
+    EXPECT_EQ(json["slo"]["tracked"].asInt(), 1);
+
+    // Same status again (as on every command): still cached
+    status.deviceChanged("a", std::nullopt, true);
+    EXPECT_EQ(status.statusBody(), first);
+
+    status.deviceChanged("a", std::nullopt, false);
+    auto changed = status.statusBody();
+    EXPECT_NE(changed, first);
+    EXPECT_EQ(parse(changed)["devices"]["online"].asUInt64(), 0u);
+    EXPECT_EQ(details_calls, 2);
+}
+
+TEST(ServiceStatusTest, SubsystemCountersRefreshAfterMaxAge) {
+    ServiceStatus status(std::chrono::milliseconds(20));
+    int details_calls = 0;
+    status.setDetailsProvider([&details_calls](Json::Value&) { details_calls++; });
+
+    status.statusBody();
+    status.statusBody();
+    EXPECT_EQ(details_calls, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    status.statusBody();
+    EXPECT_EQ(details_calls, 2);
+}
+
+TEST(ServiceStatusTest, ProbesReadFlags) {
+    using Probe = ServiceStatus::Probe;
+    ServiceStatus status(std::chrono::milliseconds(60000));
+
+    EXPECT_TRUE(status.passes(Probe::Live));
+    EXPECT_FALSE(status.passes(Probe::Ready));
+    EXPECT_FALSE(status.passes(Probe::Health));
+    EXPECT_EQ(parse(status.probeBody(Probe::Ready))["status"].asString(), "not_ready");
+
+    status.setDatabaseConnected(true);
+    status.setReady(true);
+    EXPECT_TRUE(status.passes(Probe::Ready));
+    EXPECT_FALSE(status.passes(Probe::Health));   // MQTT still down
+    EXPECT_EQ(parse(status.probeBody(Probe::Ready))["status"].asString(), "ready");
+    EXPECT_EQ(parse(status.probeBody(Probe::Health))["status"].asString(), "degraded");
+
+    status.setMqttConnected(true);
+    auto healthy = status.probeBody(Probe::Health);
+    EXPECT_EQ(parse(healthy)["status"].asString(), "healthy");
+    EXPECT_EQ(parse(healthy)["mqtt"].asString(), "connected");
+    EXPECT_EQ(status.probeBody(Probe::Health), healthy);
+
+    // Setting a flag to its current value does not invalidate the bodies
+    uint64_t version = status.version();
+    status.setMqttConnected(true);
+    EXPECT_EQ(status.version(), version);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "utils/StaticAssets.h"
+#include <zlib.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace hms_firetv;
+
+namespace {
+
+using Encoding = StaticAssets::Encoding;
+
+std::string gunzip(const std::string& input) {
+    z_stream stream{};
+    inflateInit2(&stream, 15 + 16);
+    std::string output(1 << 20, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+    inflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    inflateEnd(&stream);
+    return output;
+}
+
+std::string bundle() {
+    std::string js;
+    for (int i = 0; i < 200; i++) {
+        js += "export function handler" + std::to_string(i) + "(event) { return event.target.value; }\n";
+    }
+    return js;
+}
+
+} // namespace
+
+TEST(StaticAssetsTest, CachingDependsOnFingerprint) {
+    EXPECT_EQ(StaticAssets::cacheControlFor("/chunk-3C5URT7C.js"), "public, max-age=31536000, immutable");
+    EXPECT_EQ(StaticAssets::cacheControlFor("/main-5KPILS5H.js"), "public, max-age=31536000, immutable");
+    EXPECT_EQ(StaticAssets::cacheControlFor("/styles-IPJ6PNRK.css"), "public, max-age=31536000, immutable");
+    EXPECT_EQ(StaticAssets::cacheControlFor("/index.html"), "no-cache");
+    EXPECT_EQ(StaticAssets::cacheControlFor("/favicon.ico"), "public, max-age=3600");
+    EXPECT_EQ(StaticAssets::cacheControlFor("/my-component.js"), "public, max-age=3600");
+
+    EXPECT_EQ(StaticAssets::contentTypeFor("/main-5KPILS5H.js"), "application/javascript; charset=utf-8");
+    EXPECT_EQ(StaticAssets::contentTypeFor("/unknown.bin"), "application/octet-stream");
+}
+
+TEST(StaticAssetsTest, PrecompressesTextAndNegotiates) {
+    StaticAssets assets(StaticAssets::Options{});
+    std::string js = bundle();
+    assets.add("/chunk-ABCDEFGH.js", js);
+    assets.add("/logo.png", std::string(4096, 'x'));
+
+    const auto* asset = assets.find("/chunk-ABCDEFGH.js");
+    ASSERT_NE(asset, nullptr);
+
+    const auto& gzip = StaticAssets::select(*asset, "gzip, deflate");
+    EXPECT_EQ(gzip.encoding, Encoding::Gzip);
+    EXPECT_LT(gzip.body.size(), js.size());
+    EXPECT_EQ(gunzip(gzip.body), js);
+
+    EXPECT_EQ(StaticAssets::select(*asset, "").encoding, Encoding::Identity);
+    EXPECT_EQ(StaticAssets::select(*asset, "gzip;q=0").encoding, Encoding::Identity);
+    EXPECT_EQ(StaticAssets::select(*asset, "identity").body, js);
+    EXPECT_EQ(StaticAssets::select(*asset, "*").encoding,
+              StaticAssets::compressionAvailable(Encoding::Brotli) ? Encoding::Brotli : Encoding::Gzip);
+    if (StaticAssets::compressionAvailable(Encoding::Brotli)) {
+        const auto& br = StaticAssets::select(*asset, "gzip, deflate, br");
+        EXPECT_EQ(br.encoding, Encoding::Brotli);
+        EXPECT_EQ(StaticAssets::select(*asset, "br;q=0, gzip").encoding, Encoding::Gzip);
+    }
+
+    // Binary formats are stored once
+    const auto* png = assets.find("/logo.png");
+    ASSERT_NE(png, nullptr);
+    EXPECT_EQ(png->variants.size(), 1u);
+    EXPECT_EQ(StaticAssets::select(*png, "gzip, br").encoding, Encoding::Identity);
+}
+
+TEST(StaticAssetsTest, StrongEtagsPerEncoding) {
+    StaticAssets assets(StaticAssets::Options{});
+    assets.add("/main-5KPILS5H.js", bundle());
+    const auto* asset = assets.find("/main-5KPILS5H.js");
+    ASSERT_NE(asset, nullptr);
+
+    const auto& identity = StaticAssets::select(*asset, "");
+    const auto& gzip = StaticAssets::select(*asset, "gzip");
+    EXPECT_EQ(identity.etag.front(), '"');
+    EXPECT_NE(identity.etag, gzip.etag);
+    EXPECT_NE(identity.id, gzip.id);
+
+    EXPECT_TRUE(StaticAssets::notModified(gzip, gzip.etag));
+    EXPECT_TRUE(StaticAssets::notModified(gzip, "\"other\", W/" + gzip.etag));
+    EXPECT_TRUE(StaticAssets::notModified(gzip, "*"));
+    EXPECT_FALSE(StaticAssets::notModified(gzip, identity.etag));
+    EXPECT_FALSE(StaticAssets::notModified(gzip, ""));
+
+    // Same content, same tag (stable across restarts and replicas)
+    StaticAssets again(StaticAssets::Options{});
+    again.add("/main-5KPILS5H.js", bundle());
+    EXPECT_EQ(StaticAssets::select(*again.find("/main-5KPILS5H.js"), "").etag, identity.etag);
+}
+
+TEST(StaticAssetsTest, LoadsDirectoryWithinSizeLimit) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / ("hms_static_" + std::to_string(::getpid()));
+    fs::create_directories(dir / "media");
+    std::ofstream(dir / "index.html") << "<!doctype html><app-root></app-root>";
+    std::ofstream(dir / "media" / "icon.svg") << "<svg/>";
+    std::ofstream(dir / "huge.js") << std::string(2048, 'a');
+
+    StaticAssets::Options options;
+    options.max_file_bytes = 1024;
+    StaticAssets assets(options);
+    EXPECT_EQ(assets.loadDirectory(dir.string()), 2u);
+    fs::remove_all(dir);
+
+    ASSERT_NE(assets.index(), nullptr);
+    EXPECT_EQ(assets.find("/"), assets.index());
+    EXPECT_EQ(assets.index()->cache_control, "no-cache");
+    EXPECT_NE(assets.find("/media/icon.svg"), nullptr);
+    EXPECT_EQ(assets.find("/huge.js"), nullptr);
+    EXPECT_EQ(assets.fileCount(), 2u);
+    EXPECT_EQ(assets.variantCount(), 2u);   // Both below min_compress_bytes
+    EXPECT_EQ(assets.loadDirectory((dir / "missing").string()), 0u);
+}
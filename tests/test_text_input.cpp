@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "services/TextInputService.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hms_firetv;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * Records sends; completes them at once, or holds them until release()
+ */
+struct FakeKeyboard {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> sent;
+    std::vector<TextInputService::SendCallback> held;
+    bool hold = false;
+
+    TextInputService::Sender sender() {
+        return [this](const std::string&, const std::string& text, TextInputService::SendCallback done) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                sent.push_back(text);
+                if (hold) {
+                    held.push_back(std::move(done));
+                    cv.notify_all();
+                    return;
+                }
+            }
+            cv.notify_all();
+            done(true, "");
+        };
+    }
+
+    bool waitForSends(size_t count, std::chrono::milliseconds timeout = 1s) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, timeout, [&] { return sent.size() >= count; });
+    }
+
+    void release() {
+        std::vector<TextInputService::SendCallback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            callbacks.swap(held);
+            hold = false;
+        }
+        for (auto& done : callbacks) {
+            done(true, "");
+        }
+    }
+
+    std::vector<std::string> snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sent;
+    }
+};
+
+TextInputService::Options options(std::chrono::milliseconds debounce) {
+    TextInputService::Options opts;
+    opts.debounce = debounce;
+    return opts;
+}
+
+} // namespace
+
+TEST(TextEditTest, ClassifiesEdits) {
+    EXPECT_EQ(TextEdit::diff("net", "netf").kind, TextEdit::Kind::Append);
+    EXPECT_EQ(TextEdit::diff("net", "netfli").count, 3u);
+    EXPECT_EQ(TextEdit::diff("netf", "ne").kind, TextEdit::Kind::Backspace);
+    EXPECT_EQ(TextEdit::diff("netf", "ne").count, 2u);
+    EXPECT_EQ(TextEdit::diff("net", "nut").kind, TextEdit::Kind::Replace);
+    EXPECT_EQ(TextEdit::diff("net", "net").kind, TextEdit::Kind::Unchanged);
+}
+
+TEST(TextInputServiceTest, RapidTypingIsCoalescedIntoOneSendOfTheLatestText) {
+    FakeKeyboard keyboard;
+    TextInputService service(keyboard.sender(), options(50ms));
+
+    auto first = service.submit("tv1", "n");
+    EXPECT_EQ(first.edit.kind, TextEdit::Kind::Replace);
+    EXPECT_FALSE(first.coalesced);
+    for (const char* text : {"ne", "net", "netf"}) {
+        auto next = service.submit("tv1", text);
+        EXPECT_EQ(next.edit.kind, TextEdit::Kind::Append);
+        EXPECT_TRUE(next.coalesced);
+    }
+
+    ASSERT_TRUE(keyboard.waitForSends(1));
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(keyboard.snapshot(), std::vector<std::string>{"netf"});
+    EXPECT_EQ(service.stats()["coalesced"].asUInt64(), 3u);
+}
+
+TEST(TextInputServiceTest, UnchangedTextIsNotResent) {
+    FakeKeyboard keyboard;
+    TextInputService service(keyboard.sender(), options(20ms));
+
+    service.submit("tv1", "net");
+    ASSERT_TRUE(keyboard.waitForSends(1));
+
+    // Typed and erased within one window: the TV already shows "net"
+    service.submit("tv1", "netf");
+    service.submit("tv1", "net");
+    std::this_thread::sleep_for(80ms);
+
+    EXPECT_EQ(keyboard.snapshot().size(), 1u);
+    EXPECT_EQ(service.stats()["skipped"].asUInt64(), 1u);
+}
+
+TEST(TextInputServiceTest, OneSendInFlightPerDeviceThenTheLatestText) {
+    FakeKeyboard keyboard;
+    keyboard.hold = true;
+    TextInputService service(keyboard.sender(), options(10ms));
+
+    service.submit("tv1", "n");
+    ASSERT_TRUE(keyboard.waitForSends(1));
+
+    // Slow TV: typing continues while the first send is outstanding
+    service.submit("tv1", "ne");
+    service.submit("tv1", "net");
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(keyboard.snapshot().size(), 1u);
+
+    keyboard.release();
+    ASSERT_TRUE(keyboard.waitForSends(2));
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(keyboard.snapshot(), (std::vector<std::string>{"n", "net"}));
+}
+
+TEST(TextInputServiceTest, DevicesAreDebouncedIndependently) {
+    FakeKeyboard keyboard;
+    TextInputService service(keyboard.sender(), options(20ms));
+
+    service.submit("tv1", "abc");
+    service.submit("tv2", "xyz");
+    ASSERT_TRUE(keyboard.waitForSends(2));
+
+    auto sent = keyboard.snapshot();
+    std::sort(sent.begin(), sent.end());
+    EXPECT_EQ(sent, (std::vector<std::string>{"abc", "xyz"}));
+}
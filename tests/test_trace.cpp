@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "clients/LightningClient.h"
+#include "utils/Trace.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace hms_firetv;
+
+namespace {
+
+Tracer::Options keepNothing() {
+    Tracer::Options options;
+    options.sample_rate = 0.0;
+    options.slow = std::chrono::milliseconds(1000);
+    options.capacity = 4;
+    return options;
+}
+
+} // namespace
+
+TEST(TraceTest, ContinuesW3CTraceparent) {
+    Tracer tracer(keepNothing());
+    auto trace = tracer.start("rest", "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+    ASSERT_NE(trace, nullptr);
+    EXPECT_EQ(trace->id(), "4bf92f3577b34da6a3ce929d0e0e4736");
+    EXPECT_TRUE(trace->forced());
+
+    auto otlp = trace->toOtlp();
+    const auto& root = otlp["resourceSpans"][0]["scopeSpans"][0]["spans"][0];
+    EXPECT_EQ(root["parentSpanId"].asString(), "00f067aa0ba902b7");
+
+    // Malformed headers leave the generated ID in place
+    auto fresh = tracer.start("rest", "00-not-a-trace-01");
+    EXPECT_TRUE(Trace::isValidId(fresh->id()));
+    EXPECT_FALSE(fresh->forced());
+}
+
+TEST(TraceTest, KeepsFailedSlowAndForcedTracesOnly) {
+    Tracer tracer(keepNothing());
+
+    auto fast = tracer.start("mqtt");
+    tracer.finish(fast);
+
+    auto failed = tracer.start("mqtt");
+    failed->setResult(false, "boom");
+    tracer.finish(failed);
+
+    auto forced = tracer.start("mqtt");
+    forced->forceSample();
+    tracer.finish(forced);
+
+    auto slow = std::make_shared<Trace>(Tracer::newTraceId(), "mqtt");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1010));
+    tracer.finish(slow);
+
+    auto kept = tracer.recent(10);
+    ASSERT_EQ(kept.size(), 3u);
+    EXPECT_EQ(kept[0]->id(), slow->id());
+    EXPECT_EQ(kept[1]->id(), forced->id());
+    EXPECT_EQ(kept[2]->id(), failed->id());
+    EXPECT_EQ(tracer.find(fast->id()), nullptr);
+
+    auto stats = tracer.stats();
+    EXPECT_EQ(stats["kept"]["error"].asUInt64(), 1u);
+    EXPECT_EQ(stats["kept"]["slow"].asUInt64(), 1u);
+    EXPECT_EQ(stats["kept"]["forced"].asUInt64(), 1u);
+}
+
+TEST(TraceTest, RingKeepsNewestAndFiltersByDevice) {
+    Tracer::Options options;
+    options.sample_rate = 1.0;
+    options.capacity = 3;
+    Tracer tracer(options);
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < 5; i++) {
+        auto trace = tracer.start("rest");
+        trace->setCommand(i % 2 == 0 ? "living_room" : "bedroom", "navigation");
+        ids.push_back(trace->id());
+        tracer.finish(trace);
+    }
+
+    auto all = tracer.recent(10);
+    ASSERT_EQ(all.size(), 3u);
+    EXPECT_EQ(all[0]->id(), ids[4]);
+    EXPECT_EQ(all[2]->id(), ids[2]);
+    EXPECT_EQ(tracer.find(ids[0]), nullptr);
+
+    auto bedroom = tracer.recent(10, "bedroom");
+    ASSERT_EQ(bedroom.size(), 1u);
+    EXPECT_EQ(bedroom[0]->id(), ids[3]);
+}
+
+TEST(TraceTest, ScopedSpansAttachToCurrentTrace) {
+    Tracer::Options options;
+    options.sample_rate = 1.0;
+    Tracer tracer(options);
+
+    { TraceSpan orphan("db.get_device"); }  // No current trace: nothing to record
+
+    auto trace = tracer.start("mqtt");
+    trace->setCommand("living_room", "navigate");
+    {
+        TraceContext context(trace);
+        EXPECT_EQ(Trace::current(), trace.get());
+        { TraceSpan span("queue_wait"); }
+        {
+            TraceSpan span("wake");
+            span.fail("Device did not wake up");
+        }
+    }
+    EXPECT_EQ(Trace::current(), nullptr);
+    tracer.finish(trace);
+
+    auto json = trace->toJson();
+    ASSERT_EQ(json["spans"].size(), 2u);
+    EXPECT_EQ(json["spans"][0]["name"].asString(), "queue_wait");
+    EXPECT_EQ(json["spans"][1]["name"].asString(), "wake");
+    EXPECT_TRUE(json["spans"][1]["error"].asBool());
+    EXPECT_EQ(json["device_id"].asString(), "living_room");
+
+    auto spans = trace->toOtlp()["resourceSpans"][0]["scopeSpans"][0]["spans"];
+    ASSERT_EQ(spans.size(), 3u);
+    EXPECT_EQ(spans[0]["name"].asString(), "mqtt navigate");
+    for (Json::ArrayIndex i = 1; i < spans.size(); i++) {
+        EXPECT_EQ(spans[i]["traceId"].asString(), trace->id());
+        EXPECT_EQ(spans[i]["parentSpanId"].asString(), spans[0]["spanId"].asString());
+        EXPECT_LE(std::stoull(spans[i]["startTimeUnixNano"].asString()),
+                  std::stoull(spans[i]["endTimeUnixNano"].asString()));
+    }
+    EXPECT_EQ(spans[2]["status"]["code"].asInt(), 2);
+}
+
+TEST(TraceTest, LightningClientRecordsTransferSpans) {
+    Tracer::Options options;
+    options.sample_rate = 1.0;
+    Tracer tracer(options);
+
+    // Nothing listens on port 8080 here: the request fails before it is sent
+    LightningClient client("127.0.0.1");
+    auto trace = tracer.start("mqtt");
+    {
+        TraceContext context(trace);
+        client.sendNavigationCommand("home");
+    }
+    tracer.finish(trace);
+
+    auto json = trace->toJson();
+    ASSERT_GE(json["spans"].size(), 1u);
+    const auto& request = json["spans"][json["spans"].size() - 1];
+    EXPECT_EQ(request["name"].asString(), "request");
+    EXPECT_TRUE(request["error"].asBool());
+    EXPECT_NE(request["detail"].asString().find("/v1/FireTV"), std::string::npos);
+}
+
+TEST(TraceTest, ExportsOtlpJsonLines) {
+    std::string path = "/tmp/hms_firetv_test_traces_" + std::to_string(::getpid()) + ".jsonl";
+    std::remove(path.c_str());
+    {
+        Tracer::Options options;
+        options.sample_rate = 1.0;
+        options.export_file = path;
+        Tracer tracer(options);
+        for (int i = 0; i < 3; i++) {
+            auto trace = tracer.start("rest");
+            trace->setCommand("living_room", "media");
+            tracer.finish(trace);
+        }
+        tracer.stop();
+        EXPECT_EQ(tracer.stats()["exported"].asUInt64(), 3u);
+    }
+
+    std::ifstream in(path);
+    std::string line;
+    int lines = 0;
+    while (std::getline(in, line)) {
+        Json::Value request;
+        Json::CharReaderBuilder reader;
+        std::string errors;
+        std::istringstream stream(line);
+        ASSERT_TRUE(Json::parseFromStream(reader, stream, &request, &errors)) << errors;
+        EXPECT_EQ(request["resourceSpans"][0]["resource"]["attributes"][0]["value"]["stringValue"].asString(),
+                  "hms-firetv");
+        lines++;
+    }
+    EXPECT_EQ(lines, 3);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,95 @@
+#include "LatencyModel.h"
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace hms_firetv::simulator {
+
+std::optional<LatencyModel> LatencyModel::parse(const std::string& spec, std::string& error) {
+    std::vector<std::string> parts;
+    std::istringstream stream(spec);
+    std::string part;
+    while (std::getline(stream, part, ':')) {
+        parts.push_back(part);
+    }
+    if (parts.empty()) {
+        error = "empty latency spec";
+        return std::nullopt;
+    }
+
+    // A bare number is a fixed delay
+    if (parts.size() == 1) {
+        parts.insert(parts.begin(), "fixed");
+    }
+
+    LatencyModel model;
+    const std::string& kind = parts[0];
+    size_t expected = 3;
+    if (kind == "fixed") {
+        model.kind_ = Kind::Fixed;
+        expected = 2;
+    } else if (kind == "uniform") {
+        model.kind_ = Kind::Uniform;
+    } else if (kind == "normal") {
+        model.kind_ = Kind::Normal;
+    } else if (kind == "lognormal") {
+        model.kind_ = Kind::LogNormal;
+    } else {
+        error = "unknown latency distribution '" + kind + "'";
+        return std::nullopt;
+    }
+
+    if (parts.size() != expected) {
+        error = "'" + spec + "': " + kind + " takes " + std::to_string(expected - 1) + " value(s)";
+        return std::nullopt;
+    }
+
+    try {
+        model.a_ = std::stod(parts[1]);
+        model.b_ = expected == 3 ? std::stod(parts[2]) : 0.0;
+    } catch (const std::exception&) {
+        error = "'" + spec + "': values must be numbers";
+        return std::nullopt;
+    }
+
+    if (model.a_ < 0 || model.b_ < 0 ||
+        (model.kind_ == Kind::Uniform && model.b_ < model.a_) ||
+        (model.kind_ == Kind::LogNormal && model.a_ <= 0)) {
+        error = "'" + spec + "': values out of range";
+        return std::nullopt;
+    }
+    return model;
+}
+
+std::chrono::microseconds LatencyModel::sample(std::mt19937_64& rng) const {
+    double ms = 0.0;
+    switch (kind_) {
+        case Kind::Fixed:
+            ms = a_;
+            break;
+        case Kind::Uniform:
+            ms = std::uniform_real_distribution<double>(a_, b_)(rng);
+            break;
+        case Kind::Normal:
+            ms = std::normal_distribution<double>(a_, b_)(rng);
+            break;
+        case Kind::LogNormal:
+            // Median of a lognormal is exp(mu)
+            ms = std::lognormal_distribution<double>(std::log(a_), b_)(rng);
+            break;
+    }
+    return std::chrono::microseconds(static_cast<int64_t>(std::max(0.0, ms) * 1000.0));
+}
+
+std::string LatencyModel::describe() const {
+    std::ostringstream out;
+    switch (kind_) {
+        case Kind::Fixed:     out << "fixed " << a_ << "ms"; break;
+        case Kind::Uniform:   out << "uniform " << a_ << "-" << b_ << "ms"; break;
+        case Kind::Normal:    out << "normal mean " << a_ << "ms sd " << b_ << "ms"; break;
+        case Kind::LogNormal: out << "lognormal median " << a_ << "ms sigma " << b_; break;
+    }
+    return out.str();
+}
+
+} // namespace hms_firetv::simulator
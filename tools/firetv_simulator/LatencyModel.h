@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <random>
+#include <string>
+
+namespace hms_firetv::simulator {
+
+/**
+ * LatencyModel - Response delay distribution for simulated TVs
+ *
+ * Spec strings (milliseconds):
+ * - "25" or "fixed:25"          - always 25ms
+ * - "uniform:10:50"             - uniform between 10 and 50ms
+ * - "normal:40:10"              - mean 40, stddev 10 (clamped at 0)
+ * - "lognormal:25:0.4"          - median 25, sigma 0.4 (long right tail, like real TVs)
+ */
+class LatencyModel {
+public:
+    enum class Kind { Fixed, Uniform, Normal, LogNormal };
+
+    LatencyModel() = default;
+
+    /**
+     * @param error Set when the result is nullopt
+     */
+    static std::optional<LatencyModel> parse(const std::string& spec, std::string& error);
+
+    std::chrono::microseconds sample(std::mt19937_64& rng) const;
+
+    std::string describe() const;
+
+private:
+    Kind kind_ = Kind::Fixed;
+    double a_ = 0.0;
+    double b_ = 0.0;
+};
+
+} // namespace hms_firetv::simulator
@@ -0,0 +1,75 @@
+#include "SelfSignedCert.h"
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <cstdio>
+#include <memory>
+
+namespace hms_firetv::simulator {
+
+namespace {
+
+std::string opensslError(const char* what) {
+    char buffer[256];
+    ERR_error_string_n(ERR_get_error(), buffer, sizeof(buffer));
+    return std::string(what) + ": " + buffer;
+}
+
+struct FileCloser {
+    void operator()(FILE* file) const { std::fclose(file); }
+};
+
+} // namespace
+
+bool writeSelfSignedCert(const std::string& cert_path, const std::string& key_path, std::string& error) {
+    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(
+        EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), EVP_PKEY_CTX_free);
+    EVP_PKEY* raw_key = nullptr;
+    if (!ctx || EVP_PKEY_keygen_init(ctx.get()) <= 0 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx.get(), NID_X9_62_prime256v1) <= 0 ||
+        EVP_PKEY_keygen(ctx.get(), &raw_key) <= 0) {
+        error = opensslError("key generation failed");
+        return false;
+    }
+    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(raw_key, EVP_PKEY_free);
+
+    std::unique_ptr<X509, decltype(&X509_free)> cert(X509_new(), X509_free);
+    if (!cert) {
+        error = opensslError("X509_new failed");
+        return false;
+    }
+    X509_set_version(cert.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 365L * 24 * 3600);
+    X509_set_pubkey(cert.get(), key.get());
+
+    X509_NAME* name = X509_get_subject_name(cert.get());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("hms-firetv-simulator"),
+                               -1, -1, 0);
+    X509_set_issuer_name(cert.get(), name);
+
+    if (X509_sign(cert.get(), key.get(), EVP_sha256()) <= 0) {
+        error = opensslError("signing failed");
+        return false;
+    }
+
+    std::unique_ptr<FILE, FileCloser> key_file(std::fopen(key_path.c_str(), "wb"));
+    if (!key_file || !PEM_write_PrivateKey(key_file.get(), key.get(), nullptr, nullptr, 0, nullptr, nullptr)) {
+        error = "cannot write " + key_path;
+        return false;
+    }
+
+    std::unique_ptr<FILE, FileCloser> cert_file(std::fopen(cert_path.c_str(), "wb"));
+    if (!cert_file || !PEM_write_X509(cert_file.get(), cert.get())) {
+        error = "cannot write " + cert_path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace hms_firetv::simulator
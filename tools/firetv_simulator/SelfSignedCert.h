@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+namespace hms_firetv::simulator {
+
+/**
+ * Write a self-signed certificate and its private key as PEM files
+ *
+ * Fire TVs serve the Lightning API over HTTPS with a self-signed
+ * certificate, and the service does not verify it, so one throwaway
+ * P-256 certificate (CN=hms-firetv-simulator, valid one year) serves the
+ * whole simulated fleet.
+ *
+ * @param error Set on failure
+ * @return true if both files were written
+ */
+bool writeSelfSignedCert(const std::string& cert_path, const std::string& key_path, std::string& error);
+
+} // namespace hms_firetv::simulator
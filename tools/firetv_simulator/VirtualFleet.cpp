@@ -0,0 +1,343 @@
+#include "VirtualFleet.h"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <stdexcept>
+
+namespace hms_firetv::simulator {
+
+VirtualFleet::VirtualFleet(Options options, const std::vector<std::string>& ips)
+    : options_(std::move(options)) {
+    auto now = Clock::now();
+    size_t asleep = static_cast<size_t>(options_.asleep_fraction * static_cast<double>(ips.size()) + 0.5);
+
+    tvs_.reserve(ips.size());
+    for (size_t i = 0; i < ips.size(); i++) {
+        auto tv = std::make_unique<TV>();
+        tv->ip = ips[i];
+        tv->rng.seed(options_.seed * 1000003ULL + i);
+        tv->awake = i >= asleep;
+        tv->last_activity = now;
+        index_[tv->ip] = tv.get();
+        tvs_.push_back(std::move(tv));
+    }
+}
+
+std::vector<std::string> VirtualFleet::ipRange(const std::string& first, size_t count) {
+    in_addr addr{};
+    if (inet_pton(AF_INET, first.c_str(), &addr) != 1) {
+        throw std::invalid_argument("not an IPv4 address: " + first);
+    }
+    uint64_t start = ntohl(addr.s_addr);
+    if (start + count > 0x100000000ULL) {
+        throw std::invalid_argument("address range overflows starting at " + first);
+    }
+
+    std::vector<std::string> ips;
+    ips.reserve(count);
+    char buffer[INET_ADDRSTRLEN];
+    for (uint64_t i = 0; i < count; i++) {
+        in_addr next{};
+        next.s_addr = htonl(static_cast<uint32_t>(start + i));
+        inet_ntop(AF_INET, &next, buffer, sizeof(buffer));
+        ips.emplace_back(buffer);
+    }
+    return ips;
+}
+
+// ============================================================================
+// REQUESTS
+// ============================================================================
+
+bool VirtualFleet::acceptsConnection(const std::string& ip, Clock::time_point now) {
+    TV* tv = find(ip);
+    if (!tv) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(tv->mutex);
+    refresh(*tv, now);
+    if (!tv->awake) {
+        tv->refused++;
+    }
+    return tv->awake;
+}
+
+VirtualFleet::Reply VirtualFleet::lightning(const std::string& ip, const Request& request,
+                                            Clock::time_point now) {
+    TV* tv = find(ip);
+    if (!tv) {
+        return json(404, "Unknown TV");
+    }
+
+    std::lock_guard<std::mutex> lock(tv->mutex);
+    refresh(*tv, now);
+    tv->requests++;
+
+    Reply reply;
+    if (!tv->awake) {
+        // Request on a connection opened before the TV fell asleep
+        reply.hang = true;
+        tv->hangs++;
+        return reply;
+    }
+
+    if (auto fault = injectFault(*tv)) {
+        return *fault;
+    }
+
+    auto delay = options_.latency.sample(tv->rng);
+    tv->last_activity = now;
+
+    if (request.api_key != options_.api_key) {
+        reply = json(401, "Invalid API key");
+    } else if (options_.require_token && request.endpoint != Endpoint::Status &&
+               request.endpoint != Endpoint::PinDisplay && request.endpoint != Endpoint::PinVerify &&
+               (tv->client_token.empty() || request.client_token != tv->client_token)) {
+        reply = json(401, "Client not paired");
+    } else {
+        switch (request.endpoint) {
+            case Endpoint::Status:
+                reply = json(200, "OK");
+                break;
+
+            case Endpoint::Navigate:
+            case Endpoint::Media:
+                if (request.argument.empty()) {
+                    reply = json(400, "Missing action");
+                    break;
+                }
+                tv->commands++;
+                reply = json(200, "OK");
+                if (request.endpoint == Endpoint::Navigate && request.argument == "sleep") {
+                    tv->awake = false;
+                    tv->sleeps++;
+                }
+                break;
+
+            case Endpoint::App:
+                tv->commands++;
+                tv->foreground_app = request.argument;
+                reply = json(200, "OK");
+                break;
+
+            case Endpoint::Keyboard:
+                tv->commands++;
+                tv->last_text = request.argument;
+                reply = json(200, "OK");
+                break;
+
+            case Endpoint::PinDisplay:
+                if (!options_.pin.empty()) {
+                    tv->pin = options_.pin;
+                } else {
+                    char digits[8];
+                    std::snprintf(digits, sizeof(digits), "%04u",
+                                  static_cast<unsigned>(tv->rng() % 10000));
+                    tv->pin = digits;
+                }
+                reply = json(200, "OK");
+                break;
+
+            case Endpoint::PinVerify:
+                if (tv->pin.empty() || request.argument != tv->pin) {
+                    reply = json(400, "Invalid PIN");
+                    break;
+                }
+                if (tv->client_token.empty()) {
+                    char token[24];
+                    std::snprintf(token, sizeof(token), "sim%016llx",
+                                  static_cast<unsigned long long>(tv->rng()));
+                    tv->client_token = token;
+                }
+                tv->pin.clear();
+                reply = json(200, tv->client_token);
+                break;
+        }
+    }
+
+    reply.delay = delay;
+    return reply;
+}
+
+VirtualFleet::Reply VirtualFleet::wake(const std::string& ip, Clock::time_point now) {
+    TV* tv = find(ip);
+    if (!tv) {
+        return json(404, "Unknown TV");
+    }
+
+    std::lock_guard<std::mutex> lock(tv->mutex);
+    refresh(*tv, now);
+    if (auto fault = injectFault(*tv)) {
+        return *fault;
+    }
+
+    if (!tv->awake && !tv->waking_until) {
+        tv->waking_until = now + options_.wake_latency.sample(tv->rng);
+        tv->wakes++;
+    }
+
+    // DIAL answers 201 Created for a launch
+    Reply reply;
+    reply.status = 201;
+    return reply;
+}
+
+VirtualFleet::Reply VirtualFleet::dialStatus(const std::string& ip, Clock::time_point now) {
+    TV* tv = find(ip);
+    if (!tv) {
+        return json(404, "Unknown TV");
+    }
+
+    std::lock_guard<std::mutex> lock(tv->mutex);
+    refresh(*tv, now);
+
+    Reply reply;
+    reply.xml = true;
+    reply.body = std::string("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                             "<service xmlns=\"urn:dial-multiscreen-org:schemas:dial\">\n"
+                             "  <name>FireTVRemote</name>\n"
+                             "  <state>") + (tv->awake ? "running" : "stopped") + "</state>\n"
+                             "</service>\n";
+    return reply;
+}
+
+// ============================================================================
+// ADMIN
+// ============================================================================
+
+bool VirtualFleet::setAwake(const std::string& ip, bool awake, Clock::time_point now) {
+    TV* tv = find(ip);
+    if (!tv) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(tv->mutex);
+    tv->awake = awake;
+    tv->waking_until.reset();
+    tv->last_activity = now;
+    return true;
+}
+
+void VirtualFleet::setAllAwake(bool awake, Clock::time_point now) {
+    for (auto& tv : tvs_) {
+        setAwake(tv->ip, awake, now);
+    }
+}
+
+std::optional<std::string> VirtualFleet::pin(const std::string& ip) {
+    TV* tv = find(ip);
+    if (!tv) {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(tv->mutex);
+    return tv->pin;
+}
+
+Json::Value VirtualFleet::toJson(Clock::time_point now) {
+    Json::Value list(Json::arrayValue);
+    for (auto& tv : tvs_) {
+        std::lock_guard<std::mutex> lock(tv->mutex);
+        refresh(*tv, now);
+
+        Json::Value json;
+        json["ip"] = tv->ip;
+        json["awake"] = tv->awake;
+        json["waking"] = tv->waking_until.has_value();
+        json["api_key"] = options_.api_key;
+        json["client_token"] = tv->client_token;
+        json["foreground_app"] = tv->foreground_app;
+        json["last_text"] = tv->last_text;
+        json["requests"] = static_cast<Json::UInt64>(tv->requests);
+        json["commands"] = static_cast<Json::UInt64>(tv->commands);
+        json["errors"] = static_cast<Json::UInt64>(tv->errors);
+        json["hangs"] = static_cast<Json::UInt64>(tv->hangs);
+        json["wakes"] = static_cast<Json::UInt64>(tv->wakes);
+        json["refused_connections"] = static_cast<Json::UInt64>(tv->refused);
+        list.append(json);
+    }
+    return list;
+}
+
+Json::Value VirtualFleet::stats(Clock::time_point now) {
+    uint64_t awake = 0, requests = 0, commands = 0, errors = 0, hangs = 0, wakes = 0, refused = 0,
+             sleeps = 0;
+    for (auto& tv : tvs_) {
+        std::lock_guard<std::mutex> lock(tv->mutex);
+        refresh(*tv, now);
+        awake += tv->awake ? 1 : 0;
+        requests += tv->requests;
+        commands += tv->commands;
+        errors += tv->errors;
+        hangs += tv->hangs;
+        wakes += tv->wakes;
+        refused += tv->refused;
+        sleeps += tv->sleeps;
+    }
+
+    Json::Value json;
+    json["tvs"] = static_cast<Json::UInt64>(tvs_.size());
+    json["awake"] = static_cast<Json::UInt64>(awake);
+    json["requests"] = static_cast<Json::UInt64>(requests);
+    json["commands"] = static_cast<Json::UInt64>(commands);
+    json["injected_errors"] = static_cast<Json::UInt64>(errors);
+    json["hangs"] = static_cast<Json::UInt64>(hangs);
+    json["wakes"] = static_cast<Json::UInt64>(wakes);
+    json["sleeps"] = static_cast<Json::UInt64>(sleeps);
+    json["refused_connections"] = static_cast<Json::UInt64>(refused);
+    return json;
+}
+
+// ============================================================================
+// PRIVATE HELPERS
+// ============================================================================
+
+VirtualFleet::TV* VirtualFleet::find(const std::string& ip) {
+    auto it = index_.find(ip);
+    return it == index_.end() ? nullptr : it->second;
+}
+
+void VirtualFleet::refresh(TV& tv, Clock::time_point now) {
+    if (tv.waking_until && now >= *tv.waking_until) {
+        tv.awake = true;
+        tv.last_activity = *tv.waking_until;
+        tv.waking_until.reset();
+    }
+    if (tv.awake && options_.sleep_after.count() > 0 && now - tv.last_activity >= options_.sleep_after) {
+        tv.awake = false;
+        tv.sleeps++;
+    }
+}
+
+std::optional<VirtualFleet::Reply> VirtualFleet::injectFault(TV& tv) {
+    if (options_.error_rate <= 0.0 && options_.hang_rate <= 0.0) {
+        return std::nullopt;
+    }
+
+    double roll = std::uniform_real_distribution<double>(0.0, 1.0)(tv.rng);
+    if (roll < options_.hang_rate) {
+        tv.hangs++;
+        Reply reply;
+        reply.hang = true;
+        return reply;
+    }
+    if (roll < options_.hang_rate + options_.error_rate) {
+        tv.errors++;
+        Reply reply = json(500, "Injected failure");
+        reply.delay = options_.latency.sample(tv.rng);
+        return reply;
+    }
+    return std::nullopt;
+}
+
+VirtualFleet::Reply VirtualFleet::json(int status, const std::string& description) {
+    // Lightning wraps every answer as {"description": "..."}
+    Json::Value body;
+    body["description"] = description;
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+
+    Reply reply;
+    reply.status = status;
+    reply.body = Json::writeString(writer, body);
+    return reply;
+}
+
+} // namespace hms_firetv::simulator
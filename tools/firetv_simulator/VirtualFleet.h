@@ -0,0 +1,157 @@
+#pragma once
+
+#include "LatencyModel.h"
+#include <json/json.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hms_firetv::simulator {
+
+/**
+ * VirtualFleet - State and behavior of the simulated Fire TVs
+ *
+ * Each TV is identified by the local IP address a request arrived on, so
+ * one listener serves the whole fleet. Everything here is independent of
+ * the HTTP server: the simulator's handlers translate requests into calls
+ * on this class and send back the Reply it returns, after its delay.
+ *
+ * Behavior per TV:
+ * - Asleep TVs refuse new Lightning connections and never answer requests
+ *   on connections opened before they fell asleep (like a TV whose network
+ *   stack is suspended); the DIAL endpoint stays up
+ * - POST /apps/FireTVRemote starts waking; the Lightning API comes up after
+ *   a delay drawn from the wake latency model
+ * - Idle TVs fall asleep after `sleep_after`; the "sleep" action puts a TV
+ *   to sleep immediately
+ * - Lightning requests need the API key, and with `require_token` a client
+ *   token from the PIN pairing flow
+ * - A fraction of requests fail with HTTP 500 or hang (no answer within
+ *   `hang`), drawn independently per request
+ */
+class VirtualFleet {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string api_key = "0987654321";
+        bool require_token = false;          // Commands need a paired client token
+        std::string pin;                     // Fixed pairing PIN (empty = random 4 digits)
+        LatencyModel latency;                // Lightning response delay
+        LatencyModel wake_latency;           // Wake request to Lightning API up
+        std::chrono::milliseconds sleep_after{0};  // Idle time before sleeping; 0 = never
+        double asleep_fraction = 0.0;        // TVs asleep at start
+        double error_rate = 0.0;             // Requests answered with HTTP 500
+        double hang_rate = 0.0;              // Requests answered only after `hang`
+        std::chrono::milliseconds hang{30000};
+        uint64_t seed = 1;
+    };
+
+    enum class Endpoint { Status, Navigate, Media, App, Keyboard, PinDisplay, PinVerify };
+
+    struct Request {
+        Endpoint endpoint = Endpoint::Status;
+        std::string api_key;
+        std::string client_token;
+        std::string argument;   // Action, package, text, friendly name or PIN
+    };
+
+    struct Reply {
+        int status = 200;
+        std::string body;
+        bool xml = false;
+        std::chrono::microseconds delay{0};
+        bool hang = false;      // Answer only after Options::hang
+    };
+
+    VirtualFleet(Options options, const std::vector<std::string>& ips);
+
+    /**
+     * `count` consecutive IPv4 addresses starting at `first`
+     *
+     * @throws std::invalid_argument if `first` is not an IPv4 address or the range overflows
+     */
+    static std::vector<std::string> ipRange(const std::string& first, size_t count);
+
+    size_t size() const { return tvs_.size(); }
+    bool contains(const std::string& ip) const { return index_.count(ip) > 0; }
+
+    /**
+     * Whether a new Lightning connection to `ip` is accepted (TV exists and is awake)
+     */
+    bool acceptsConnection(const std::string& ip, Clock::time_point now = Clock::now());
+
+    Reply lightning(const std::string& ip, const Request& request, Clock::time_point now = Clock::now());
+
+    /**
+     * DIAL POST /apps/FireTVRemote
+     */
+    Reply wake(const std::string& ip, Clock::time_point now = Clock::now());
+
+    /**
+     * DIAL GET /apps/FireTVRemote
+     */
+    Reply dialStatus(const std::string& ip, Clock::time_point now = Clock::now());
+
+    /**
+     * Put a TV to sleep or wake it instantly (admin API)
+     *
+     * @return false if there is no such TV
+     */
+    bool setAwake(const std::string& ip, bool awake, Clock::time_point now = Clock::now());
+    void setAllAwake(bool awake, Clock::time_point now = Clock::now());
+
+    std::optional<std::string> pin(const std::string& ip);
+
+    /**
+     * Per-TV state: ip, awake, api_key, client_token, foreground_app, last_text, counters
+     */
+    Json::Value toJson(Clock::time_point now = Clock::now());
+
+    /**
+     * Fleet-wide counters
+     */
+    Json::Value stats(Clock::time_point now = Clock::now());
+
+    const Options& options() const { return options_; }
+
+private:
+    struct TV {
+        std::string ip;
+        std::mutex mutex;
+        std::mt19937_64 rng;
+        bool awake = true;
+        Clock::time_point last_activity;
+        std::optional<Clock::time_point> waking_until;
+        std::string pin;
+        std::string client_token;
+        std::string foreground_app;
+        std::string last_text;
+
+        uint64_t requests = 0;
+        uint64_t commands = 0;
+        uint64_t errors = 0;
+        uint64_t hangs = 0;
+        uint64_t wakes = 0;
+        uint64_t refused = 0;
+        uint64_t sleeps = 0;
+    };
+
+    TV* find(const std::string& ip);
+    void refresh(TV& tv, Clock::time_point now);
+    std::optional<Reply> injectFault(TV& tv);
+
+    static Reply json(int status, const std::string& description);
+
+    Options options_;
+    std::vector<std::unique_ptr<TV>> tvs_;
+    std::unordered_map<std::string, TV*> index_;   // Immutable after construction
+};
+
+} // namespace hms_firetv::simulator
@@ -0,0 +1,411 @@
+/**
+ * firetv_simulator - Local Fire TV fleet for load and latency testing
+ *
+ * Serves the Lightning API (HTTPS, self-signed, port 8080) and the DIAL
+ * wake endpoint (HTTP, port 8009) for any number of virtual TVs. Each TV is
+ * one local IP address: every 127.0.0.0/8 address reaches the loopback
+ * interface on Linux, so `--first-ip 127.0.1.1 --count 500` needs no setup.
+ * Register the TVs with the service by IP and drive it as usual.
+ *
+ * A plain-HTTP admin API (127.0.0.1:9080 by default) lists the TVs with
+ * their tokens and counters and can put them to sleep or wake them:
+ *   GET  /sim/tvs                  GET  /sim/stats
+ *   POST /sim/tvs/{ip}/sleep       POST /sim/tvs/{ip}/wake
+ *   POST /sim/sleep-all            POST /sim/wake-all
+ *
+ * See docs/FIRETV_SIMULATOR.md.
+ */
+#include <drogon/drogon.h>
+#include <getopt.h>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include "LatencyModel.h"
+#include "SelfSignedCert.h"
+#include "VirtualFleet.h"
+
+using namespace drogon;
+using namespace hms_firetv::simulator;
+
+namespace {
+
+struct Config {
+    std::string first_ip = "127.0.1.1";
+    size_t count = 1;
+    std::string bind = "0.0.0.0";
+    uint16_t lightning_port = 8080;
+    uint16_t dial_port = 8009;
+    uint16_t admin_port = 9080;           // 0 = no admin API
+    std::string cert;
+    std::string key;
+    std::string cert_dir = "/tmp/hms-firetv-simulator";
+    size_t threads = 0;                   // 0 = one per core
+    VirtualFleet::Options fleet;
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "\n"
+        "Fleet:\n"
+        "  --first-ip IP          First TV address (default 127.0.1.1)\n"
+        "  --count N              Number of TVs on consecutive addresses (default 1)\n"
+        "  --bind IP              Listen address (default 0.0.0.0)\n"
+        "  --lightning-port N     Lightning HTTPS port (default 8080)\n"
+        "  --dial-port N          DIAL wake port (default 8009)\n"
+        "  --admin-port N         Admin API port on 127.0.0.1, 0 = off (default 9080)\n"
+        "  --threads N            IO threads, 0 = one per core (default 0)\n"
+        "\n"
+        "Behavior:\n"
+        "  --latency SPEC         Lightning response delay (default lognormal:25:0.4)\n"
+        "  --wake-latency SPEC    Wake request to API up (default uniform:2000:4000)\n"
+        "  --sleep-after-ms N     Idle time before a TV sleeps, 0 = never (default 0)\n"
+        "  --asleep-fraction F    Fraction of TVs asleep at start (default 0)\n"
+        "  --error-rate F         Fraction of requests answered with HTTP 500 (default 0)\n"
+        "  --hang-rate F          Fraction of requests never answered in time (default 0)\n"
+        "  --hang-ms N            How long a hung request is held (default 30000)\n"
+        "  --seed N               Random seed (default 1)\n"
+        "\n"
+        "Pairing:\n"
+        "  --api-key KEY          Expected X-Api-Key (default 0987654321)\n"
+        "  --require-token        Reject commands without the paired X-Client-Token\n"
+        "  --pin NNNN             Fixed pairing PIN (default: random, printed)\n"
+        "\n"
+        "TLS:\n"
+        "  --cert FILE --key FILE Certificate to serve (default: generated)\n"
+        "  --cert-dir DIR         Where the generated one is written\n"
+        "                         (default /tmp/hms-firetv-simulator)\n"
+        "\n"
+        "SPEC: N | fixed:N | uniform:MIN:MAX | normal:MEAN:SD | lognormal:MEDIAN:SIGMA (ms)\n";
+}
+
+LatencyModel parseLatency(const std::string& spec, const char* option) {
+    std::string error;
+    auto model = LatencyModel::parse(spec, error);
+    if (!model) {
+        throw std::invalid_argument(std::string(option) + ": " + error);
+    }
+    return *model;
+}
+
+double parseRate(const std::string& value, const char* option) {
+    double rate = std::stod(value);
+    if (rate < 0.0 || rate > 1.0) {
+        throw std::invalid_argument(std::string(option) + " must be between 0 and 1");
+    }
+    return rate;
+}
+
+Config parseArgs(int argc, char* argv[]) {
+    enum {
+        FIRST_IP = 1000, COUNT, BIND, LIGHTNING_PORT, DIAL_PORT, ADMIN_PORT, THREADS,
+        LATENCY, WAKE_LATENCY, SLEEP_AFTER, ASLEEP_FRACTION, ERROR_RATE, HANG_RATE, HANG_MS,
+        SEED, API_KEY, REQUIRE_TOKEN, PIN, CERT, KEY, CERT_DIR, HELP
+    };
+    static const option options[] = {
+        {"first-ip", required_argument, nullptr, FIRST_IP},
+        {"count", required_argument, nullptr, COUNT},
+        {"bind", required_argument, nullptr, BIND},
+        {"lightning-port", required_argument, nullptr, LIGHTNING_PORT},
+        {"dial-port", required_argument, nullptr, DIAL_PORT},
+        {"admin-port", required_argument, nullptr, ADMIN_PORT},
+        {"threads", required_argument, nullptr, THREADS},
+        {"latency", required_argument, nullptr, LATENCY},
+        {"wake-latency", required_argument, nullptr, WAKE_LATENCY},
+        {"sleep-after-ms", required_argument, nullptr, SLEEP_AFTER},
+        {"asleep-fraction", required_argument, nullptr, ASLEEP_FRACTION},
+        {"error-rate", required_argument, nullptr, ERROR_RATE},
+        {"hang-rate", required_argument, nullptr, HANG_RATE},
+        {"hang-ms", required_argument, nullptr, HANG_MS},
+        {"seed", required_argument, nullptr, SEED},
+        {"api-key", required_argument, nullptr, API_KEY},
+        {"require-token", no_argument, nullptr, REQUIRE_TOKEN},
+        {"pin", required_argument, nullptr, PIN},
+        {"cert", required_argument, nullptr, CERT},
+        {"key", required_argument, nullptr, KEY},
+        {"cert-dir", required_argument, nullptr, CERT_DIR},
+        {"help", no_argument, nullptr, HELP},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    Config config;
+    config.fleet.latency = parseLatency("lognormal:25:0.4", "--latency");
+    config.fleet.wake_latency = parseLatency("uniform:2000:4000", "--wake-latency");
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", options, nullptr)) != -1) {
+        std::string value = optarg ? optarg : "";
+        switch (opt) {
+            case FIRST_IP:        config.first_ip = value; break;
+            case COUNT:           config.count = std::stoul(value); break;
+            case BIND:            config.bind = value; break;
+            case LIGHTNING_PORT:  config.lightning_port = static_cast<uint16_t>(std::stoul(value)); break;
+            case DIAL_PORT:       config.dial_port = static_cast<uint16_t>(std::stoul(value)); break;
+            case ADMIN_PORT:      config.admin_port = static_cast<uint16_t>(std::stoul(value)); break;
+            case THREADS:         config.threads = std::stoul(value); break;
+            case LATENCY:         config.fleet.latency = parseLatency(value, "--latency"); break;
+            case WAKE_LATENCY:    config.fleet.wake_latency = parseLatency(value, "--wake-latency"); break;
+            case SLEEP_AFTER:     config.fleet.sleep_after = std::chrono::milliseconds(std::stol(value)); break;
+            case ASLEEP_FRACTION: config.fleet.asleep_fraction = parseRate(value, "--asleep-fraction"); break;
+            case ERROR_RATE:      config.fleet.error_rate = parseRate(value, "--error-rate"); break;
+            case HANG_RATE:       config.fleet.hang_rate = parseRate(value, "--hang-rate"); break;
+            case HANG_MS:         config.fleet.hang = std::chrono::milliseconds(std::stol(value)); break;
+            case SEED:            config.fleet.seed = std::stoull(value); break;
+            case API_KEY:         config.fleet.api_key = value; break;
+            case REQUIRE_TOKEN:   config.fleet.require_token = true; break;
+            case PIN:             config.fleet.pin = value; break;
+            case CERT:            config.cert = value; break;
+            case KEY:             config.key = value; break;
+            case CERT_DIR:        config.cert_dir = value; break;
+            case HELP:            usage(argv[0]); std::exit(0);
+            default:              usage(argv[0]); std::exit(2);
+        }
+    }
+
+    if (config.count == 0) {
+        throw std::invalid_argument("--count must be at least 1");
+    }
+    if (config.fleet.error_rate + config.fleet.hang_rate > 1.0) {
+        throw std::invalid_argument("--error-rate plus --hang-rate must not exceed 1");
+    }
+    if (config.cert.empty() != config.key.empty()) {
+        throw std::invalid_argument("--cert and --key go together");
+    }
+    return config;
+}
+
+void respond(const VirtualFleet::Reply& reply, std::chrono::milliseconds hang,
+             std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setStatusCode(static_cast<HttpStatusCode>(reply.status));
+    resp->setContentTypeCode(reply.xml ? CT_TEXT_XML : CT_APPLICATION_JSON);
+    resp->setBody(reply.body);
+
+    auto delay = reply.hang ? std::chrono::duration_cast<std::chrono::microseconds>(hang) : reply.delay;
+    if (delay.count() <= 0) {
+        callback(resp);
+        return;
+    }
+
+    // Handlers run on the connection's IO loop; answer from the same loop later
+    trantor::EventLoop::getEventLoopOfCurrentThread()->runAfter(
+        std::chrono::duration<double>(delay).count(),
+        [resp, callback = std::move(callback)]() { callback(resp); });
+}
+
+HttpResponsePtr notFound() {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setStatusCode(k404NotFound);
+    return resp;
+}
+
+HttpResponsePtr adminJson(const Json::Value& body, HttpStatusCode code = k200OK) {
+    auto resp = HttpResponse::newHttpJsonResponse(body);
+    resp->setStatusCode(code);
+    return resp;
+}
+
+void signalHandler(int signal) {
+    std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
+    app().quit();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    std::vector<std::string> ips;
+    try {
+        config = parseArgs(argc, argv);
+        ips = VirtualFleet::ipRange(config.first_ip, config.count);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (config.cert.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(config.cert_dir, ec);
+        config.cert = config.cert_dir + "/cert.pem";
+        config.key = config.cert_dir + "/key.pem";
+        std::string error;
+        if (!writeSelfSignedCert(config.cert, config.key, error)) {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+    }
+
+    auto fleet = std::make_shared<VirtualFleet>(config.fleet, ips);
+    const auto hang = config.fleet.hang;
+    const uint16_t lightning_port = config.lightning_port;
+    const uint16_t dial_port = config.dial_port;
+    const uint16_t admin_port = config.admin_port;
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    app().setLogLevel(trantor::Logger::kWarn)
+        .addListener(config.bind, lightning_port, true, config.cert, config.key)
+        .addListener(config.bind, dial_port)
+        .setThreadNum(config.threads)
+        .setMaxConnectionNum(1000000)
+        .setMaxConnectionNumPerIP(0)
+        .setIdleConnectionTimeout(120);
+    if (admin_port != 0) {
+        app().addListener("127.0.0.1", admin_port);
+    }
+
+    // Asleep TVs (and addresses that are not TVs) refuse Lightning connections
+    app().registerNewConnectionAdvice(
+        [fleet, lightning_port, dial_port](const trantor::InetAddress&, const trantor::InetAddress& local) {
+            if (local.toPort() == lightning_port) {
+                return fleet->acceptsConnection(local.toIp());
+            }
+            if (local.toPort() == dial_port) {
+                return fleet->contains(local.toIp());
+            }
+            return true;
+        });
+
+    // ------------------------------------------------------------------------
+    // Lightning API (port 8080)
+    // ------------------------------------------------------------------------
+
+    auto lightning = [fleet, hang, lightning_port](const HttpRequestPtr& req,
+                                                   VirtualFleet::Endpoint endpoint,
+                                                   std::string argument,
+                                                   std::function<void(const HttpResponsePtr&)>&& callback) {
+        if (req->localAddr().toPort() != lightning_port) {
+            callback(notFound());
+            return;
+        }
+        VirtualFleet::Request request;
+        request.endpoint = endpoint;
+        request.api_key = req->getHeader("X-Api-Key");
+        request.client_token = req->getHeader("X-Client-Token");
+        request.argument = std::move(argument);
+
+        const std::string ip = req->localAddr().toIp();
+        auto reply = fleet->lightning(ip, request);
+        if (endpoint == VirtualFleet::Endpoint::PinDisplay && reply.status == 200) {
+            std::cout << "PIN for " << ip << ": " << fleet->pin(ip).value_or("") << std::endl;
+        }
+        respond(reply, hang, std::move(callback));
+    };
+
+    auto bodyField = [](const HttpRequestPtr& req, const char* field) {
+        auto json = req->getJsonObject();
+        return json && (*json)[field].isString() ? (*json)[field].asString() : std::string();
+    };
+
+    app().registerHandler("/v1/FireTV",
+        [lightning](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            if (req->method() == Get) {
+                lightning(req, VirtualFleet::Endpoint::Status, "", std::move(callback));
+            } else {
+                lightning(req, VirtualFleet::Endpoint::Navigate, req->getParameter("action"), std::move(callback));
+            }
+        }, {Get, Post});
+
+    app().registerHandler("/v1/media",
+        [lightning](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            lightning(req, VirtualFleet::Endpoint::Media, req->getParameter("action"), std::move(callback));
+        }, {Post});
+
+    app().registerHandler("/v1/FireTV/app/{1}",
+        [lightning](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback,
+                    const std::string& package) {
+            lightning(req, VirtualFleet::Endpoint::App, package, std::move(callback));
+        }, {Post});
+
+    app().registerHandler("/v1/FireTV/keyboard",
+        [lightning, bodyField](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            lightning(req, VirtualFleet::Endpoint::Keyboard, bodyField(req, "text"), std::move(callback));
+        }, {Post});
+
+    app().registerHandler("/v1/FireTV/pin/display",
+        [lightning, bodyField](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            lightning(req, VirtualFleet::Endpoint::PinDisplay, bodyField(req, "friendlyName"), std::move(callback));
+        }, {Post});
+
+    app().registerHandler("/v1/FireTV/pin/verify",
+        [lightning, bodyField](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            lightning(req, VirtualFleet::Endpoint::PinVerify, bodyField(req, "pin"), std::move(callback));
+        }, {Post});
+
+    // ------------------------------------------------------------------------
+    // DIAL (port 8009)
+    // ------------------------------------------------------------------------
+
+    app().registerHandler("/apps/FireTVRemote",
+        [fleet, hang, dial_port](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            if (req->localAddr().toPort() != dial_port) {
+                callback(notFound());
+                return;
+            }
+            const std::string ip = req->localAddr().toIp();
+            auto reply = req->method() == Post ? fleet->wake(ip) : fleet->dialStatus(ip);
+            respond(reply, hang, std::move(callback));
+        }, {Get, Post});
+
+    // ------------------------------------------------------------------------
+    // Admin API
+    // ------------------------------------------------------------------------
+
+    auto isAdmin = [admin_port](const HttpRequestPtr& req) {
+        return admin_port != 0 && req->localAddr().toPort() == admin_port;
+    };
+
+    app().registerHandler("/sim/tvs",
+        [fleet, isAdmin](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            callback(isAdmin(req) ? adminJson(fleet->toJson()) : notFound());
+        }, {Get});
+
+    app().registerHandler("/sim/stats",
+        [fleet, isAdmin](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+            callback(isAdmin(req) ? adminJson(fleet->stats()) : notFound());
+        }, {Get});
+
+    app().registerHandler("/sim/tvs/{1}/{2}",
+        [fleet, isAdmin](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback,
+                         const std::string& ip, const std::string& action) {
+            if (!isAdmin(req) || (action != "sleep" && action != "wake")) {
+                callback(notFound());
+                return;
+            }
+            Json::Value body;
+            body["success"] = fleet->setAwake(ip, action == "wake");
+            callback(adminJson(body, body["success"].asBool() ? k200OK : k404NotFound));
+        }, {Post});
+
+    for (const char* action : {"sleep-all", "wake-all"}) {
+        const bool awake = std::string(action) == "wake-all";
+        app().registerHandler(std::string("/sim/") + action,
+            [fleet, isAdmin, awake](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback) {
+                if (!isAdmin(req)) {
+                    callback(notFound());
+                    return;
+                }
+                fleet->setAllAwake(awake);
+                callback(adminJson(fleet->stats()));
+            }, {Post});
+    }
+
+    std::cout << "================================================================================\n"
+              << "Fire TV simulator: " << ips.size() << " TV(s) " << ips.front() << " - " << ips.back() << "\n"
+              << "  Lightning https://" << config.bind << ":" << lightning_port
+              << "  DIAL http://" << config.bind << ":" << dial_port << "\n"
+              << "  Latency " << config.fleet.latency.describe()
+              << ", wake " << config.fleet.wake_latency.describe() << "\n";
+    if (admin_port != 0) {
+        std::cout << "  Admin http://127.0.0.1:" << admin_port << "/sim/tvs\n";
+    }
+    std::cout << "================================================================================" << std::endl;
+
+    app().run();
+    return 0;
+}
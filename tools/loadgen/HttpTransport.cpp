@@ -0,0 +1,115 @@
+#include "HttpTransport.h"
+
+namespace hms_firetv::loadgen {
+
+namespace {
+
+size_t discardBody(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+} // namespace
+
+HttpTransport::HttpTransport(std::string base_url, size_t max_connections, std::chrono::milliseconds timeout)
+    : base_url_(std::move(base_url)), timeout_(timeout), multi_(curl_multi_init()) {
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(max_connections));
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(max_connections));
+    thread_ = std::thread(&HttpTransport::loop, this);
+}
+
+HttpTransport::~HttpTransport() {
+    stop_ = true;
+    curl_multi_wakeup(multi_);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    curl_multi_cleanup(multi_);
+}
+
+void HttpTransport::send(const LoadRequest& request, Done done) {
+    auto pending = std::make_unique<Pending>();
+    pending->url = base_url_ + "/api/devices/" + request.device_id + "/" + request.command;
+    pending->body = "{\"action\":\"" + request.action + "\"}";
+    pending->done = std::move(done);
+
+    CURL* easy = curl_easy_init();
+    pending->easy = easy;
+    pending->headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    curl_easy_setopt(easy, CURLOPT_URL, pending->url.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, pending->body.c_str());
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, pending->headers);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, discardBody);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout_.count()));
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, pending->error);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, pending.get());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(pending));
+    }
+    curl_multi_wakeup(multi_);
+}
+
+void HttpTransport::loop() {
+    while (!stop_) {
+        std::vector<std::unique_ptr<Pending>> added;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            added.swap(queue_);
+        }
+        for (auto& pending : added) {
+            curl_multi_add_handle(multi_, pending->easy);
+            active_.insert(pending.release());
+        }
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+
+        int left = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &left)) {
+            if (msg->msg == CURLMSG_DONE) {
+                Pending* pending = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &pending);
+                finish(pending, msg->data.result);
+            }
+        }
+
+        curl_multi_poll(multi_, nullptr, 0, 100, nullptr);
+    }
+
+    // Fail whatever is still queued or in flight
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& pending : queue_) {
+            curl_multi_add_handle(multi_, pending->easy);
+            active_.insert(pending.release());
+        }
+        queue_.clear();
+    }
+    while (!active_.empty()) {
+        finish(*active_.begin(), CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+void HttpTransport::finish(Pending* pending, CURLcode code) {
+    long status = 0;
+    curl_easy_getinfo(pending->easy, CURLINFO_RESPONSE_CODE, &status);
+    curl_multi_remove_handle(multi_, pending->easy);
+    curl_easy_cleanup(pending->easy);
+    curl_slist_free_all(pending->headers);
+
+    active_.erase(pending);
+    std::unique_ptr<Pending> owned(pending);
+    if (code == CURLE_OPERATION_TIMEDOUT) {
+        owned->done(false, "timeout");
+    } else if (code != CURLE_OK) {
+        owned->done(false, owned->error[0] ? owned->error : curl_easy_strerror(code));
+    } else if (status < 200 || status >= 300) {
+        owned->done(false, "http_" + std::to_string(status));
+    } else {
+        owned->done(true, "");
+    }
+}
+
+} // namespace hms_firetv::loadgen
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "LoadRunner.h"
+#include <curl/curl.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace hms_firetv::loadgen {
+
+/**
+ * HttpTransport - Sends commands to the REST API
+ *
+ * POST {base_url}/api/devices/{id}/{navigate|media|volume} with
+ * {"action": ...}. One curl multi handle on a dedicated thread drives
+ * every request, reusing keep-alive connections (up to `max_connections`
+ * to the service). A 2xx answer is success; curl timeouts are reported as
+ * "timeout", anything else as "http_<status>" or the curl error.
+ */
+class HttpTransport : public Transport {
+public:
+    HttpTransport(std::string base_url, size_t max_connections, std::chrono::milliseconds timeout);
+    ~HttpTransport() override;
+
+    HttpTransport(const HttpTransport&) = delete;
+    HttpTransport& operator=(const HttpTransport&) = delete;
+
+    const char* name() const override { return "rest"; }
+    void send(const LoadRequest& request, Done done) override;
+
+private:
+    struct Pending {
+        CURL* easy = nullptr;
+        curl_slist* headers = nullptr;
+        std::string url;
+        std::string body;
+        Done done;
+        char error[CURL_ERROR_SIZE] = {0};
+    };
+
+    void loop();
+    void finish(Pending* pending, CURLcode code);
+
+    const std::string base_url_;
+    const std::chrono::milliseconds timeout_;
+
+    CURLM* multi_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Pending>> queue_;   // Waiting to be added to multi_
+    std::unordered_set<Pending*> active_;           // In multi_ (loop thread only)
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace hms_firetv::loadgen
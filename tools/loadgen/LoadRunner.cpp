@@ -0,0 +1,170 @@
+#include "LoadRunner.h"
+#include <algorithm>
+#include <cmath>
+
+namespace hms_firetv::loadgen {
+
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// RESULTS
+// ============================================================================
+
+double StepResult::errorRate() const {
+    uint64_t finished = ok + errors + timeouts;
+    return finished > 0 ? static_cast<double>(errors + timeouts) / static_cast<double>(finished) : 0.0;
+}
+
+uint64_t StepResult::percentile(const std::vector<uint64_t>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+Json::Value StepResult::toJson() const {
+    auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+
+    Json::Value json;
+    json["target_rate"] = target_rate;
+    json["connections"] = static_cast<Json::UInt64>(connections);
+    json["duration_s"] = duration_s;
+    json["sent"] = static_cast<Json::UInt64>(sent);
+    json["ok"] = static_cast<Json::UInt64>(ok);
+    json["errors"] = static_cast<Json::UInt64>(errors);
+    json["timeouts"] = static_cast<Json::UInt64>(timeouts);
+    json["throughput"] = throughput();
+    json["error_rate"] = errorRate();
+
+    static const std::pair<const char*, double> QUANTILES[] = {
+        {"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}, {"p999", 0.999}, {"max", 1.0}
+    };
+    for (const auto& [name, q] : QUANTILES) {
+        json["latency_ms"][name] = ms(percentile(corrected_us, q));
+        json["uncorrected_latency_ms"][name] = ms(percentile(uncorrected_us, q));
+    }
+    return json;
+}
+
+// ============================================================================
+// RUNNER
+// ============================================================================
+
+LoadRunner::LoadRunner(Transport& transport, RequestFactory factory, Options options)
+    : transport_(transport), factory_(std::move(factory)), options_(options) {}
+
+StepResult LoadRunner::run(double rate) {
+    StepResult result;
+    result.target_rate = rate;
+    result.connections = options_.connections;
+
+    // Per-client interval; zero means send as soon as the client is free
+    const auto interval = rate > 0
+        ? std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(static_cast<double>(options_.connections) / rate))
+        : Clock::duration::zero();
+
+    const auto start = Clock::now();
+    const auto window_start = start + options_.warmup;
+    const auto window_end = window_start + options_.duration;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    clients_.assign(options_.connections, Client{});
+    for (size_t i = 0; i < clients_.size(); i++) {
+        // Stagger the schedules so clients don't fire in lockstep
+        clients_[i].intended = start + interval * static_cast<int64_t>(i) / static_cast<int64_t>(clients_.size());
+    }
+    in_flight_ = 0;
+    result_ = &result;
+    const uint64_t generation = ++generation_;
+
+    uint64_t sequence = 0;
+    while (true) {
+        auto now = Clock::now();
+        if (now >= window_end) {
+            break;
+        }
+
+        // Earliest free client; send everything that is due
+        Clock::time_point next = window_end;
+        for (size_t i = 0; i < clients_.size(); i++) {
+            Client& client = clients_[i];
+            if (client.busy) {
+                continue;
+            }
+            if (interval == Clock::duration::zero()) {
+                client.intended = now;
+            }
+            if (client.intended > now) {
+                next = std::min(next, client.intended);
+                continue;
+            }
+
+            client.busy = true;
+            in_flight_++;
+            const auto intended = client.intended;
+            const bool record = intended >= window_start && intended < window_end;
+            if (record) {
+                result.sent++;
+            }
+            client.intended += interval;
+
+            LoadRequest request = factory_(sequence++);
+            lock.unlock();
+            const auto sent = Clock::now();
+            transport_.send(request, [this, generation, i, intended, sent, record](bool ok, const std::string& error) {
+                complete(generation, i, intended, sent, record, ok, error);
+            });
+            lock.lock();
+            now = Clock::now();
+        }
+
+        cv_.wait_until(lock, next);
+    }
+
+    // Let in-flight requests finish (they count if intended inside the window)
+    cv_.wait_until(lock, window_end + options_.drain, [this] { return in_flight_ == 0; });
+    result_ = nullptr;
+    result.duration_s = std::chrono::duration<double>(options_.duration).count();
+    lock.unlock();
+
+    std::sort(result.corrected_us.begin(), result.corrected_us.end());
+    std::sort(result.uncorrected_us.begin(), result.uncorrected_us.end());
+
+    // Requests still outstanding after the drain never answered in time
+    uint64_t finished = result.ok + result.errors + result.timeouts;
+    if (result.sent > finished) {
+        result.timeouts += result.sent - finished;
+    }
+    return result;
+}
+
+void LoadRunner::complete(uint64_t generation, size_t client, Clock::time_point intended,
+                          Clock::time_point sent, bool record, bool ok, const std::string& error) {
+    const auto done = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (generation != generation_ || !result_) {
+        return;
+    }
+    clients_[client].busy = false;
+    in_flight_--;
+
+    if (record) {
+        if (ok) {
+            result_->ok++;
+            result_->corrected_us.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(done - intended).count()));
+            result_->uncorrected_us.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(done - sent).count()));
+        } else if (error == "timeout") {
+            result_->timeouts++;
+        } else {
+            result_->errors++;
+        }
+    }
+    cv_.notify_all();
+}
+
+} // namespace hms_firetv::loadgen
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <json/json.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hms_firetv::loadgen {
+
+/**
+ * One command the generator sends
+ */
+struct LoadRequest {
+    std::string device_id;
+    std::string command;          // "navigate", "media" or "volume"
+    std::string action;           // e.g. "select", "play", "volume_up"
+    std::string request_id;       // Unique per request (MQTT completion matching)
+};
+
+/**
+ * Transport - Sends a request and reports when the service has finished it
+ *
+ * `done` may be called from any thread, exactly once per send, with
+ * ok = false for errors and timeouts (`error` names which).
+ */
+class Transport {
+public:
+    using Done = std::function<void(bool ok, const std::string& error)>;
+
+    virtual ~Transport() = default;
+    virtual const char* name() const = 0;
+    virtual void send(const LoadRequest& request, Done done) = 0;
+};
+
+/**
+ * Results of one step (one target rate) of a run
+ */
+struct StepResult {
+    double target_rate = 0.0;         // Requests/s asked for (0 = as fast as possible)
+    size_t connections = 0;
+    double duration_s = 0.0;          // Measured window
+    uint64_t sent = 0;
+    uint64_t ok = 0;
+    uint64_t errors = 0;
+    uint64_t timeouts = 0;
+    std::vector<uint64_t> corrected_us;     // From intended send time, sorted
+    std::vector<uint64_t> uncorrected_us;   // From actual send time, sorted
+
+    double throughput() const { return duration_s > 0 ? static_cast<double>(ok) / duration_s : 0.0; }
+    double errorRate() const;
+
+    /**
+     * q-quantile (0..1) of a sorted sample vector, in microseconds
+     */
+    static uint64_t percentile(const std::vector<uint64_t>& sorted, double q);
+
+    Json::Value toJson() const;
+};
+
+/**
+ * LoadRunner - Closed-loop, rate-paced load with coordinated-omission correction
+ *
+ * `connections` virtual clients each keep at most one request in flight.
+ * With a target rate, each client follows a fixed schedule (rate /
+ * connections requests per second): request N is *intended* at
+ * start + N * interval. When the service falls behind, a client sends its
+ * next request as soon as the previous one completes, but that request's
+ * latency is still measured from its intended time. The time a request
+ * spent waiting for its client to free up is what a real caller with that
+ * schedule would have waited too, so the service's stalls are not hidden
+ * by the generator backing off (coordinated omission). Uncorrected
+ * latencies, measured from the actual send, are kept for comparison.
+ *
+ * Without a target rate, clients send back-to-back and the two agree.
+ *
+ * Devices are used round-robin, so load spreads evenly across the fleet.
+ */
+class LoadRunner {
+public:
+    struct Options {
+        size_t connections = 16;
+        std::chrono::milliseconds warmup{2000};    // Run but not recorded
+        std::chrono::milliseconds duration{10000};
+        std::chrono::milliseconds drain{5000};     // Max wait for in-flight requests after the window
+    };
+
+    using RequestFactory = std::function<LoadRequest(uint64_t sequence)>;
+
+    LoadRunner(Transport& transport, RequestFactory factory, Options options);
+
+    /**
+     * Run one step at `rate` requests/s (0 = unthrottled) and wait for it
+     */
+    StepResult run(double rate);
+
+private:
+    struct Client {
+        bool busy = false;
+        std::chrono::steady_clock::time_point intended;
+    };
+
+    void complete(uint64_t generation, size_t client, std::chrono::steady_clock::time_point intended,
+                  std::chrono::steady_clock::time_point sent, bool record, bool ok,
+                  const std::string& error);
+
+    Transport& transport_;
+    RequestFactory factory_;
+    Options options_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Client> clients_;
+    size_t in_flight_ = 0;
+    StepResult* result_ = nullptr;
+    uint64_t generation_ = 0;      // Completions from an earlier step (after its drain) are ignored
+};
+
+} // namespace hms_firetv::loadgen
@@ -0,0 +1,149 @@
+#include "MqttTransport.h"
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+namespace hms_firetv::loadgen {
+
+MqttTransport::MqttTransport(Options options) : options_(std::move(options)) {
+    sweeper_ = std::thread(&MqttTransport::sweep, this);
+}
+
+MqttTransport::~MqttTransport() {
+    stop_ = true;
+    sweeper_cv_.notify_all();
+    if (sweeper_.joinable()) {
+        sweeper_.join();
+    }
+    if (client_ && client_->is_connected()) {
+        try {
+            client_->disconnect()->wait();
+        } catch (const mqtt::exception&) {
+        }
+    }
+
+    // Nothing will answer now
+    std::unordered_map<std::string, Pending> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(pending_);
+    }
+    for (auto& [id, entry] : pending) {
+        entry.done(false, "stopped");
+    }
+}
+
+bool MqttTransport::connect(std::string& error) {
+    try {
+        client_ = std::make_unique<mqtt::async_client>(
+            options_.broker, "hms_firetv_loadgen_" + std::to_string(::getpid()));
+        client_->set_message_callback([this](mqtt::const_message_ptr msg) {
+            onResult(msg->to_string());
+        });
+
+        mqtt::connect_options connect_options;
+        connect_options.set_clean_session(true);
+        connect_options.set_keep_alive_interval(20);
+        connect_options.set_max_inflight(65535);
+        if (!options_.username.empty()) {
+            connect_options.set_user_name(options_.username);
+            connect_options.set_password(options_.password);
+        }
+        client_->connect(connect_options)->wait();
+        client_->subscribe("maestro_hub/firetv/+/result", options_.qos)->wait();
+        return true;
+    } catch (const mqtt::exception& e) {
+        error = e.what();
+        return false;
+    }
+}
+
+std::string MqttTransport::payload(const LoadRequest& request) {
+    Json::Value json;
+    if (request.command == "navigate") {
+        json["command"] = "navigate";
+        if (request.action.rfind("dpad_", 0) == 0) {
+            json["direction"] = request.action.substr(5);
+        } else {
+            json["action"] = request.action;
+        }
+    } else if (request.command == "media") {
+        json["command"] = "media_" + request.action;
+    } else {
+        json["command"] = request.action;      // volume_up, volume_down, volume_mute
+    }
+    json["request_id"] = request.request_id;
+
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, json);
+}
+
+void MqttTransport::send(const LoadRequest& request, Done done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_[request.request_id] = {std::move(done), std::chrono::steady_clock::now() + options_.timeout};
+    }
+
+    try {
+        std::string body = payload(request);
+        client_->publish("maestro_hub/colada/" + request.device_id + "/" + request.action,
+                         body.data(), body.size(), options_.qos, false);
+    } catch (const mqtt::exception& e) {
+        complete(request.request_id, false, e.what());
+    }
+}
+
+void MqttTransport::onResult(const std::string& payload) {
+    Json::Value json;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    std::istringstream stream(payload);
+    if (!Json::parseFromStream(reader, stream, &json, &errors) || !json["request_id"].isString()) {
+        return;
+    }
+    bool ok = json.get("success", false).asBool();
+    complete(json["request_id"].asString(), ok, ok ? "" : json.get("error", "failed").asString());
+}
+
+void MqttTransport::complete(const std::string& request_id, bool ok, const std::string& error) {
+    Done done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(request_id);
+        if (it == pending_.end()) {
+            return;     // Already timed out, or another generator's request
+        }
+        done = std::move(it->second.done);
+        pending_.erase(it);
+    }
+    done(ok, error);
+}
+
+void MqttTransport::sweep() {
+    while (!stop_) {
+        {
+            std::unique_lock<std::mutex> lock(sweeper_mutex_);
+            sweeper_cv_.wait_for(lock, std::chrono::milliseconds(50), [this] { return stop_.load(); });
+        }
+
+        std::vector<Done> expired;
+        auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = pending_.begin(); it != pending_.end();) {
+                if (it->second.expires <= now) {
+                    expired.push_back(std::move(it->second.done));
+                    it = pending_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        for (auto& done : expired) {
+            done(false, "timeout");
+        }
+    }
+}
+
+} // namespace hms_firetv::loadgen
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "LoadRunner.h"
+#include <mqtt/async_client.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace hms_firetv::loadgen {
+
+/**
+ * MqttTransport - Sends commands the way Home Assistant does
+ *
+ * Publishes {"command": ..., "request_id": ...} to
+ * maestro_hub/colada/{device_id}/{action} and waits for the service's
+ * completion notice on maestro_hub/firetv/{device_id}/result, which it
+ * publishes for commands that carry a request_id. Requests without a
+ * notice within `timeout` are reported as "timeout".
+ */
+class MqttTransport : public Transport {
+public:
+    struct Options {
+        std::string broker = "tcp://localhost:1883";
+        std::string username;
+        std::string password;
+        int qos = 1;
+        std::chrono::milliseconds timeout{10000};
+    };
+
+    explicit MqttTransport(Options options);
+    ~MqttTransport() override;
+
+    MqttTransport(const MqttTransport&) = delete;
+    MqttTransport& operator=(const MqttTransport&) = delete;
+
+    /**
+     * Connect and subscribe to the result topics
+     *
+     * @param error Set on failure
+     */
+    bool connect(std::string& error);
+
+    const char* name() const override { return "mqtt"; }
+    void send(const LoadRequest& request, Done done) override;
+
+    /**
+     * Payload CommandHandler expects for a load request
+     */
+    static std::string payload(const LoadRequest& request);
+
+private:
+    struct Pending {
+        Done done;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    void onResult(const std::string& payload);
+    void sweep();
+    void complete(const std::string& request_id, bool ok, const std::string& error);
+
+    Options options_;
+    std::unique_ptr<mqtt::async_client> client_;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Pending> pending_;   // By request_id
+
+    std::mutex sweeper_mutex_;
+    std::condition_variable sweeper_cv_;
+    std::atomic<bool> stop_{false};
+    std::thread sweeper_;
+};
+
+} // namespace hms_firetv::loadgen
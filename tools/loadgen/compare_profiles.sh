@@ -0,0 +1,206 @@
+#!/bin/bash
+# ==============================================================================
+# HMS FireTV HTTP Server Profile Comparison
+# ==============================================================================
+#
+# Runs the same REST load against the old fixed server settings (baseline)
+# and the current defaults (tuned), with the Fire TV simulator as backend,
+# and writes to OUT_DIR:
+#
+#   host.txt                      CPU, cores, memory, kernel, commit
+#   <profile>-max-<run>.json      Back-to-back (rate 0) step
+#   <profile>-<run>.json / .csv   Rate sweep
+#   summary.md                    Medians over the runs, baseline vs tuned
+#
+# Usage (from the repository root): tools/loadgen/compare_profiles.sh [BUILD_DIR] [OUT_DIR]
+#   BUILD_DIR  Build directory configured with -DBUILD_TOOLS=ON (default: build)
+#   OUT_DIR    Results directory (default: docs/server_tuning/<hostname>)
+#
+# Environment: DEVICES (50), CONNECTIONS (64), RATES (200,400,800,1600),
+#              DURATION_MS (20000), REPEAT (3), API_PORT (8888)
+#
+# Ports 8080, 8009 and 9080 (simulator) and API_PORT must be free. The
+# service runs on a throwaway SQLite database; MQTT is not needed.
+#
+
+set -euo pipefail
+
+BUILD_DIR="${1:-build}"
+OUT_DIR="${2:-docs/server_tuning/$(hostname -s)}"
+DEVICES="${DEVICES:-50}"
+CONNECTIONS="${CONNECTIONS:-64}"
+RATES="${RATES:-200,400,800,1600}"
+DURATION_MS="${DURATION_MS:-20000}"
+REPEAT="${REPEAT:-3}"
+API_PORT="${API_PORT:-8888}"
+API_URL="http://localhost:${API_PORT}"
+
+SERVICE="${BUILD_DIR}/hms_firetv"
+SIMULATOR="${BUILD_DIR}/tools/firetv_simulator/firetv_simulator"
+LOADGEN="${BUILD_DIR}/tools/loadgen/hms_firetv_loadgen"
+
+# Settings main.cpp hardcoded before the server profile
+BASELINE_ENV=(THREAD_NUM=4 HTTP_REUSE_PORT=false HTTP_TCP_NODELAY=false
+              HTTP_PIPELINING_REQUESTS=0 HTTP_MAX_BODY_KB=10240)
+PROFILE_VARS=(THREAD_NUM HTTP_REUSE_PORT HTTP_TCP_NODELAY IDLE_CONNECTION_TIMEOUT
+              HTTP_KEEPALIVE_REQUESTS HTTP_PIPELINING_REQUESTS HTTP_MAX_CONNECTIONS
+              HTTP_MAX_CONNECTIONS_PER_IP HTTP_MAX_BODY_KB HTTP_COMMAND_BODY_KB HTTP_BATCH_BODY_KB)
+
+for binary in "$SERVICE" "$SIMULATOR" "$LOADGEN"; do
+    if [ ! -x "$binary" ]; then
+        echo "Missing $binary (build with -DCMAKE_BUILD_TYPE=Release -DBUILD_TOOLS=ON)" >&2
+        exit 1
+    fi
+done
+
+mkdir -p "$OUT_DIR"
+WORK_DIR="$(mktemp -d)"
+SIM_PID=""
+SERVICE_PID=""
+
+cleanup() {
+    [ -n "$SERVICE_PID" ] && kill "$SERVICE_PID" 2>/dev/null && wait "$SERVICE_PID" 2>/dev/null
+    [ -n "$SIM_PID" ] && kill "$SIM_PID" 2>/dev/null && wait "$SIM_PID" 2>/dev/null
+    rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+# ------------------------------------------------------------------------------
+# Host details
+# ------------------------------------------------------------------------------
+
+{
+    echo "date:      $(date -u +%Y-%m-%dT%H:%M:%SZ)"
+    echo "host:      $(hostname -s)"
+    echo "cpu:       $(lscpu 2>/dev/null | sed -n 's/^Model name: *//p' | head -1)"
+    echo "cores:     $(nproc)"
+    echo "memory:    $(free -h 2>/dev/null | awk '/^Mem:/ {print $2}')"
+    echo "kernel:    $(uname -sr)"
+    echo "commit:    $(git rev-parse --short HEAD 2>/dev/null || echo unknown)"
+    echo "devices:   $DEVICES"
+    echo "conns:     $CONNECTIONS"
+    echo "rates:     $RATES"
+    echo "duration:  ${DURATION_MS}ms x $REPEAT runs"
+    echo "baseline:  ${BASELINE_ENV[*]}"
+    echo "tuned:     defaults"
+} > "$OUT_DIR/host.txt"
+cat "$OUT_DIR/host.txt"
+
+# ------------------------------------------------------------------------------
+# Simulator and service
+# ------------------------------------------------------------------------------
+
+"$SIMULATOR" --count "$DEVICES" > "$WORK_DIR/simulator.log" 2>&1 &
+SIM_PID=$!
+
+start_service() {
+    local profile="$1"
+    local -a env_args=(-u DB_HOST -u DB_NAME HOME="$WORK_DIR" DB_TYPE=sqlite
+                       API_PORT="$API_PORT" MQTT_BROKER_HOST=127.0.0.1 LOG_LEVEL=warn)
+    for var in "${PROFILE_VARS[@]}"; do
+        env_args=(-u "$var" "${env_args[@]}")
+    done
+    if [ "$profile" = "baseline" ]; then
+        env_args+=("${BASELINE_ENV[@]}")
+    fi
+
+    env "${env_args[@]}" "$SERVICE" > "$WORK_DIR/service-$profile.log" 2>&1 &
+    SERVICE_PID=$!
+
+    for _ in $(seq 1 60); do
+        if curl -sf "$API_URL/health/live" > /dev/null; then
+            return 0
+        fi
+        sleep 0.5
+    done
+    echo "Service did not start, see $WORK_DIR/service-$profile.log" >&2
+    cat "$WORK_DIR/service-$profile.log" >&2
+    exit 1
+}
+
+stop_service() {
+    kill "$SERVICE_PID" 2>/dev/null || true
+    wait "$SERVICE_PID" 2>/dev/null || true
+    SERVICE_PID=""
+}
+
+register_fleet() {
+    for i in $(seq 1 "$DEVICES"); do
+        curl -s -X POST "$API_URL/api/devices" -H 'Content-Type: application/json' \
+            -d "{\"device_id\":\"sim_$i\",\"name\":\"Sim $i\",\"ip_address\":\"127.0.1.$i\"}" > /dev/null
+        curl -s -X PUT "$API_URL/api/devices/sim_$i" -H 'Content-Type: application/json' \
+            -d '{"client_token":"simulated"}' > /dev/null
+    done
+}
+
+# ------------------------------------------------------------------------------
+# Runs (profiles interleaved so drift on the host hits both alike)
+# ------------------------------------------------------------------------------
+
+LOADGEN_ARGS=(--transport rest --api-url "$API_URL" --device-count "$DEVICES"
+              --connections "$CONNECTIONS" --duration-ms "$DURATION_MS")
+
+for run in $(seq 1 "$REPEAT"); do
+    for profile in baseline tuned; do
+        echo "=== $profile, run $run/$REPEAT ==="
+        start_service "$profile"
+        register_fleet
+
+        "$LOADGEN" "${LOADGEN_ARGS[@]}" --rates 0 \
+            --json "$OUT_DIR/$profile-max-$run.json"
+        "$LOADGEN" "${LOADGEN_ARGS[@]}" --rates "$RATES" \
+            --json "$OUT_DIR/$profile-$run.json" --csv "$OUT_DIR/$profile-$run.csv"
+
+        stop_service
+    done
+done
+
+# ------------------------------------------------------------------------------
+# Summary
+# ------------------------------------------------------------------------------
+
+python3 - "$OUT_DIR" "$REPEAT" > "$OUT_DIR/summary.md" <<'EOF'
+import json, statistics, sys
+
+out_dir, repeat = sys.argv[1], int(sys.argv[2])
+
+def steps(name):
+    runs = []
+    for run in range(1, repeat + 1):
+        with open(f"{out_dir}/{name}-{run}.json") as f:
+            runs.append(json.load(f)["steps"])
+    return runs
+
+def median(values):
+    return statistics.median(values) if values else float("nan")
+
+def change(before, after):
+    return f"{(after - before) / before * 100:+.1f}%" if before else "n/a"
+
+with open(f"{out_dir}/host.txt") as f:
+    print("```\n" + f.read().rstrip() + "\n```\n")
+
+print(f"Medians over {repeat} runs. Latencies are corrected for coordinated omission.\n")
+
+base_max = median([r[0]["throughput"] for r in steps("baseline-max")])
+tuned_max = median([r[0]["throughput"] for r in steps("tuned-max")])
+print("| | Baseline | Tuned | Change |")
+print("|---|---|---|---|")
+print(f"| Saturation throughput (req/s) | {base_max:.0f} | {tuned_max:.0f} | {change(base_max, tuned_max)} |\n")
+
+base, tuned = steps("baseline"), steps("tuned")
+print("| Target req/s | Baseline req/s | Tuned req/s | Baseline p99 ms | Tuned p99 ms | Baseline errors | Tuned errors |")
+print("|---|---|---|---|---|---|---|")
+for i, step in enumerate(base[0]):
+    def col(runs, get):
+        return median([get(r[i]) for r in runs])
+    print(f"| {step['target_rate']:.0f}"
+          f" | {col(base, lambda s: s['throughput']):.0f} | {col(tuned, lambda s: s['throughput']):.0f}"
+          f" | {col(base, lambda s: s['latency_ms']['p99']):.1f} | {col(tuned, lambda s: s['latency_ms']['p99']):.1f}"
+          f" | {col(base, lambda s: s['error_rate']) * 100:.2f}% | {col(tuned, lambda s: s['error_rate']) * 100:.2f}% |")
+EOF
+
+echo ""
+cat "$OUT_DIR/summary.md"
+echo ""
+echo "Results in $OUT_DIR"
@@ -0,0 +1,329 @@
+/**
+ * hms_firetv_loadgen - Closed-loop load generator for the command paths
+ *
+ * Drives the service the way Home Assistant does, over REST
+ * (POST /api/devices/{id}/{navigate,media,volume}) or MQTT
+ * (maestro_hub/colada/{id}/{action}), at one or more target rates, and
+ * reports coordinated-omission-corrected latency percentiles, error and
+ * timeout counts and achieved throughput per rate: a throughput-vs-latency
+ * curve. Point the service at firetv_simulator TVs so the backend is the
+ * only variable you did not choose.
+ *
+ * See docs/LOAD_TESTING.md.
+ */
+#include <getopt.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include "HttpTransport.h"
+#include "LoadRunner.h"
+#include "MqttTransport.h"
+
+using namespace hms_firetv::loadgen;
+
+namespace {
+
+struct Config {
+    std::string transport = "rest";
+    std::string api_url = "http://localhost:8888";
+    std::string broker = "tcp://localhost:1883";
+    std::string mqtt_username;
+    std::string mqtt_password;
+    std::vector<std::string> devices;
+    std::string device_prefix = "sim_";
+    size_t device_count = 1;
+    std::string command = "navigate";
+    std::vector<double> rates{0.0};
+    std::chrono::milliseconds timeout{10000};
+    LoadRunner::Options runner;
+    std::string json_file;
+    std::string csv_file;
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "\n"
+        "Target:\n"
+        "  --transport rest|mqtt  Command path to drive (default rest)\n"
+        "  --api-url URL          Service REST API (default http://localhost:8888)\n"
+        "  --broker URI           MQTT broker (default tcp://localhost:1883)\n"
+        "  --mqtt-username USER   MQTT credentials (default: none)\n"
+        "  --mqtt-password PASS\n"
+        "\n"
+        "Fleet:\n"
+        "  --devices ID,ID,...    Device IDs to command\n"
+        "  --device-prefix P      Otherwise P1..PN (default sim_)\n"
+        "  --device-count N       (default 1)\n"
+        "\n"
+        "Load:\n"
+        "  --command C            navigate | media | volume | mixed (default navigate)\n"
+        "  --rates R,R,...        Target requests/s per step, 0 = unthrottled (default 0)\n"
+        "  --connections N        Concurrent clients, one request each (default 16)\n"
+        "  --warmup-ms N          Unrecorded time before each step (default 2000)\n"
+        "  --duration-ms N        Recorded time per step (default 10000)\n"
+        "  --timeout-ms N         Per-request timeout (default 10000)\n"
+        "\n"
+        "Output:\n"
+        "  --json FILE            Write all steps as JSON\n"
+        "  --csv FILE             Write the curve as CSV\n";
+}
+
+std::vector<std::string> split(const std::string& value) {
+    std::vector<std::string> parts;
+    std::stringstream stream(value);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+Config parseArgs(int argc, char* argv[]) {
+    enum {
+        TRANSPORT = 1000, API_URL, BROKER, MQTT_USERNAME, MQTT_PASSWORD, DEVICES, DEVICE_PREFIX,
+        DEVICE_COUNT, COMMAND, RATES, CONNECTIONS, WARMUP, DURATION, TIMEOUT, JSON_FILE, CSV_FILE, HELP
+    };
+    static const option options[] = {
+        {"transport", required_argument, nullptr, TRANSPORT},
+        {"api-url", required_argument, nullptr, API_URL},
+        {"broker", required_argument, nullptr, BROKER},
+        {"mqtt-username", required_argument, nullptr, MQTT_USERNAME},
+        {"mqtt-password", required_argument, nullptr, MQTT_PASSWORD},
+        {"devices", required_argument, nullptr, DEVICES},
+        {"device-prefix", required_argument, nullptr, DEVICE_PREFIX},
+        {"device-count", required_argument, nullptr, DEVICE_COUNT},
+        {"command", required_argument, nullptr, COMMAND},
+        {"rates", required_argument, nullptr, RATES},
+        {"connections", required_argument, nullptr, CONNECTIONS},
+        {"warmup-ms", required_argument, nullptr, WARMUP},
+        {"duration-ms", required_argument, nullptr, DURATION},
+        {"timeout-ms", required_argument, nullptr, TIMEOUT},
+        {"json", required_argument, nullptr, JSON_FILE},
+        {"csv", required_argument, nullptr, CSV_FILE},
+        {"help", no_argument, nullptr, HELP},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    Config config;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", options, nullptr)) != -1) {
+        std::string value = optarg ? optarg : "";
+        switch (opt) {
+            case TRANSPORT:     config.transport = value; break;
+            case API_URL:       config.api_url = value; break;
+            case BROKER:        config.broker = value; break;
+            case MQTT_USERNAME: config.mqtt_username = value; break;
+            case MQTT_PASSWORD: config.mqtt_password = value; break;
+            case DEVICES:       config.devices = split(value); break;
+            case DEVICE_PREFIX: config.device_prefix = value; break;
+            case DEVICE_COUNT:  config.device_count = std::stoul(value); break;
+            case COMMAND:       config.command = value; break;
+            case RATES:
+                config.rates.clear();
+                for (const auto& rate : split(value)) {
+                    config.rates.push_back(std::stod(rate));
+                }
+                break;
+            case CONNECTIONS:   config.runner.connections = std::stoul(value); break;
+            case WARMUP:        config.runner.warmup = std::chrono::milliseconds(std::stol(value)); break;
+            case DURATION:      config.runner.duration = std::chrono::milliseconds(std::stol(value)); break;
+            case TIMEOUT:       config.timeout = std::chrono::milliseconds(std::stol(value)); break;
+            case JSON_FILE:     config.json_file = value; break;
+            case CSV_FILE:      config.csv_file = value; break;
+            case HELP:          usage(argv[0]); std::exit(0);
+            default:            usage(argv[0]); std::exit(2);
+        }
+    }
+
+    if (config.transport != "rest" && config.transport != "mqtt") {
+        throw std::invalid_argument("--transport must be rest or mqtt");
+    }
+    if (config.command != "navigate" && config.command != "media" &&
+        config.command != "volume" && config.command != "mixed") {
+        throw std::invalid_argument("--command must be navigate, media, volume or mixed");
+    }
+    if (config.devices.empty()) {
+        if (config.device_count == 0) {
+            throw std::invalid_argument("--device-count must be at least 1");
+        }
+        for (size_t i = 1; i <= config.device_count; i++) {
+            config.devices.push_back(config.device_prefix + std::to_string(i));
+        }
+    }
+    if (config.runner.connections == 0) {
+        throw std::invalid_argument("--connections must be at least 1");
+    }
+    if (config.rates.empty()) {
+        throw std::invalid_argument("--rates needs at least one rate");
+    }
+    for (double rate : config.rates) {
+        if (rate < 0.0) {
+            throw std::invalid_argument("--rates must not be negative");
+        }
+    }
+    // In-flight requests get a full timeout to finish before a step is closed
+    config.runner.drain = config.timeout + std::chrono::milliseconds(500);
+    return config;
+}
+
+/**
+ * Commands that are harmless to repeat thousands of times on a real TV
+ */
+LoadRunner::RequestFactory requestFactory(const Config& config) {
+    static const std::vector<std::pair<std::string, std::string>> NAVIGATE = {
+        {"navigate", "dpad_up"}, {"navigate", "dpad_down"}};
+    static const std::vector<std::pair<std::string, std::string>> MEDIA = {
+        {"media", "play"}, {"media", "pause"}};
+    static const std::vector<std::pair<std::string, std::string>> VOLUME = {
+        {"volume", "volume_up"}, {"volume", "volume_down"}};
+    static const std::vector<std::pair<std::string, std::string>> MIXED = {
+        NAVIGATE[0], MEDIA[0], VOLUME[0], NAVIGATE[1], MEDIA[1], VOLUME[1]};
+
+    const auto* commands = config.command == "navigate" ? &NAVIGATE
+                         : config.command == "media"    ? &MEDIA
+                         : config.command == "volume"   ? &VOLUME
+                                                        : &MIXED;
+    std::string run_id = std::to_string(::getpid());
+    std::vector<std::string> devices = config.devices;
+
+    return [commands, devices, run_id](uint64_t sequence) {
+        // Consecutive requests go to different devices; each device cycles through the commands
+        const auto& [command, action] = (*commands)[(sequence / devices.size()) % commands->size()];
+        LoadRequest request;
+        request.device_id = devices[sequence % devices.size()];
+        request.command = command;
+        request.action = action;
+        request.request_id = run_id + "-" + std::to_string(sequence);
+        return request;
+    };
+}
+
+double ms(uint64_t us) {
+    return static_cast<double>(us) / 1000.0;
+}
+
+void printHeader() {
+    std::cout << std::right
+              << std::setw(10) << "target/s" << std::setw(10) << "actual/s"
+              << std::setw(9) << "errors" << std::setw(9) << "timeout"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+              << std::setw(10) << "p99 ms" << std::setw(10) << "p99.9 ms"
+              << std::setw(10) << "max ms" << std::setw(14) << "p99 uncorr" << "\n";
+}
+
+void printStep(const StepResult& step) {
+    const auto& corrected = step.corrected_us;
+    std::ostringstream target;
+    if (step.target_rate > 0) {
+        target << std::fixed << std::setprecision(0) << step.target_rate;
+    } else {
+        target << "max";
+    }
+    std::cout << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << target.str() << std::setw(10) << step.throughput()
+              << std::setw(9) << step.errors << std::setw(9) << step.timeouts
+              << std::setw(10) << ms(StepResult::percentile(corrected, 0.50))
+              << std::setw(10) << ms(StepResult::percentile(corrected, 0.90))
+              << std::setw(10) << ms(StepResult::percentile(corrected, 0.99))
+              << std::setw(10) << ms(StepResult::percentile(corrected, 0.999))
+              << std::setw(10) << ms(corrected.empty() ? 0 : corrected.back())
+              << std::setw(14) << ms(StepResult::percentile(step.uncorrected_us, 0.99)) << std::endl;
+}
+
+void writeCsv(const std::string& path, const std::vector<StepResult>& steps) {
+    std::ofstream out(path);
+    out << "target_rate,throughput,sent,ok,errors,timeouts,p50_ms,p90_ms,p99_ms,p999_ms,max_ms,"
+           "uncorrected_p99_ms\n";
+    for (const auto& step : steps) {
+        const auto& corrected = step.corrected_us;
+        out << step.target_rate << ',' << step.throughput() << ',' << step.sent << ',' << step.ok << ','
+            << step.errors << ',' << step.timeouts << ','
+            << ms(StepResult::percentile(corrected, 0.50)) << ','
+            << ms(StepResult::percentile(corrected, 0.90)) << ','
+            << ms(StepResult::percentile(corrected, 0.99)) << ','
+            << ms(StepResult::percentile(corrected, 0.999)) << ','
+            << ms(corrected.empty() ? 0 : corrected.back()) << ','
+            << ms(StepResult::percentile(step.uncorrected_us, 0.99)) << '\n';
+    }
+}
+
+void writeJson(const std::string& path, const Config& config, const char* transport,
+               const std::vector<StepResult>& steps) {
+    Json::Value root;
+    root["transport"] = transport;
+    root["command"] = config.command;
+    root["devices"] = static_cast<Json::UInt64>(config.devices.size());
+    root["connections"] = static_cast<Json::UInt64>(config.runner.connections);
+    root["timeout_ms"] = static_cast<Json::Int64>(config.timeout.count());
+    root["steps"] = Json::arrayValue;
+    for (const auto& step : steps) {
+        root["steps"].append(step.toJson());
+    }
+
+    std::ofstream out(path);
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root) << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    try {
+        config = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+
+    std::unique_ptr<Transport> transport;
+    if (config.transport == "rest") {
+        transport = std::make_unique<HttpTransport>(config.api_url, config.runner.connections, config.timeout);
+    } else {
+        MqttTransport::Options options;
+        options.broker = config.broker;
+        options.username = config.mqtt_username;
+        options.password = config.mqtt_password;
+        options.timeout = config.timeout;
+        auto mqtt = std::make_unique<MqttTransport>(options);
+        std::string error;
+        if (!mqtt->connect(error)) {
+            std::cerr << "Error: cannot connect to " << config.broker << ": " << error << "\n";
+            return 1;
+        }
+        transport = std::move(mqtt);
+    }
+
+    std::cout << "Load: " << transport->name() << ", " << config.command << " commands to "
+              << config.devices.size() << " device(s), " << config.runner.connections
+              << " connection(s), " << config.runner.duration.count() << "ms per step"
+              << " (latencies corrected for coordinated omission)\n\n";
+    printHeader();
+
+    LoadRunner runner(*transport, requestFactory(config), config.runner);
+    std::vector<StepResult> steps;
+    for (double rate : config.rates) {
+        steps.push_back(runner.run(rate));
+        printStep(steps.back());
+    }
+
+    if (!config.json_file.empty()) {
+        writeJson(config.json_file, config, transport->name(), steps);
+        std::cout << "\nWrote " << config.json_file << "\n";
+    }
+    if (!config.csv_file.empty()) {
+        writeCsv(config.csv_file, steps);
+        std::cout << "Wrote " << config.csv_file << "\n";
+    }
+    return 0;
+}